@@ -0,0 +1,98 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+import 'dart:isolate';
+import 'dart:typed_data';
+
+// Measures the latency of HTTP requests served by an isolate whose request
+// handler allocates enough to cause regular garbage collections.
+//
+// Requests are sent from a helper isolate at a fixed arrival rate (open
+// loop): every request is due at a fixed point in time, regardless of
+// whether earlier requests have been answered, and its latency is measured
+// from that point. Stalls of the server therefore show up in the latency of
+// every request that arrived during the stall instead of only slowing down
+// the client.
+
+const int requestsPerSecond = 500;
+const int numberOfRequests = 8 * requestsPerSecond; // 8 seconds.
+
+main() async {
+  final server = await HttpServer.bind(InternetAddress.loopbackIPv4, 0);
+  server.listen((HttpRequest request) {
+    request.response
+      ..headers.contentType = ContentType.json
+      ..write(makeResponse())
+      ..close();
+  });
+
+  final resultPort = ReceivePort();
+  await Isolate.spawn(runClient, [resultPort.sendPort, server.port],
+      onError: resultPort.sendPort);
+  final result = await resultPort.first;
+  await server.close(force: true);
+  if (result is! Uint64List) {
+    throw 'Client isolate failed: $result';
+  }
+
+  report('EventLoopLatencyHttp', result);
+}
+
+String makeResponse() {
+  final items = List.generate(
+      1000, (int i) => <String, dynamic>{'id': i, 'name': 'item-$i'});
+  return json.encode(items);
+}
+
+void runClient(List args) async {
+  final SendPort resultPort = args[0];
+  final int port = args[1];
+
+  final client = HttpClient();
+  final intervalInUs = 1000000 ~/ requestsPerSecond;
+  final latencies = Uint64List(numberOfRequests);
+  final allDone = Completer<void>();
+  int completed = 0;
+
+  final sw = Stopwatch()..start();
+  for (int i = 0; i < numberOfRequests; i++) {
+    final int dueInUs = i * intervalInUs;
+    final int waitInUs = dueInUs - sw.elapsedMicroseconds;
+    if (waitInUs > 0) {
+      await Future.delayed(Duration(microseconds: waitInUs));
+    }
+    sendRequest(client, port).then((_) {
+      latencies[i] = sw.elapsedMicroseconds - dueInUs;
+      if (++completed == numberOfRequests) {
+        allDone.complete();
+      }
+    });
+  }
+  await allDone.future;
+  client.close(force: true);
+
+  resultPort.send(latencies);
+}
+
+Future<void> sendRequest(HttpClient client, int port) async {
+  final request = await client.get('127.0.0.1', port, '/');
+  final response = await request.close();
+  await response.drain();
+}
+
+void report(String name, Uint64List latencies) {
+  latencies.sort();
+  final length = latencies.length;
+  double percentile(int perMille) =>
+      latencies[perMille * length ~/ 1000] / 1000;
+
+  print('$name.Percentile50(RunTime): ${percentile(500)} ms.');
+  print('$name.Percentile99(RunTime): ${percentile(990)} ms.');
+  print('$name.Percentile999(RunTime): ${percentile(999)} ms.');
+  print('$name.Max(RunTime): ${latencies[length - 1] / 1000} ms.');
+  print('$name.MaxRss(MemoryUse): ${ProcessInfo.maxRss}');
+}
@@ -0,0 +1,381 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// These micro benchmarks measure the fixed costs of FFI operations: the
+// transition of each kind of call, callback round trips, passing structs of
+// increasing size, and pointer arithmetic. Each reports nanoseconds per
+// operation, so results can be compared across architectures.
+
+import 'dart:ffi';
+import 'dart:io';
+
+import 'dlopen_helper.dart';
+
+DynamicLibrary ffiTestFunctions = dlopenPlatformSpecific('native_functions',
+    path: Platform.script.resolve('../native/out/').path);
+
+typedef NativeIdentity = Int64 Function(Int64);
+typedef Identity = int Function(int);
+
+final identity =
+    ffiTestFunctions.lookupFunction<NativeIdentity, Identity>('Identity');
+
+final identityLeaf = ffiTestFunctions
+    .lookupFunction<NativeIdentity, Identity>('Identity', isLeaf: true);
+
+final identityLazy = ffiTestFunctions
+    .lookupFunction<NativeIdentity, Identity>('Identity', isLazy: true);
+
+typedef NativeIdentityDouble = Double Function(Double);
+typedef IdentityDouble = double Function(double);
+
+final identityDouble = ffiTestFunctions
+    .lookupFunction<NativeIdentityDouble, IdentityDouble>('IdentityDouble');
+
+final identityDoubleLeaf =
+    ffiTestFunctions.lookupFunction<NativeIdentityDouble, IdentityDouble>(
+        'IdentityDouble',
+        isLeaf: true);
+
+typedef NativeCallCallback = Int64 Function(
+    Pointer<NativeFunction<NativeIdentity>>, Int64);
+typedef CallCallback = int Function(
+    Pointer<NativeFunction<NativeIdentity>>, int);
+
+final callCallback = ffiTestFunctions
+    .lookupFunction<NativeCallCallback, CallCallback>('CallCallback');
+
+int dartIdentity(int x) => x;
+
+final dartIdentityPointer =
+    Pointer.fromFunction<NativeIdentity>(dartIdentity, 0);
+
+class Struct2Int64 extends Struct {
+  @Int64()
+  int a0;
+  @Int64()
+  int a1;
+}
+
+class Struct4Int64 extends Struct {
+  @Int64()
+  int a0;
+  @Int64()
+  int a1;
+  @Int64()
+  int a2;
+  @Int64()
+  int a3;
+}
+
+class Struct8Int64 extends Struct {
+  @Int64()
+  int a0;
+  @Int64()
+  int a1;
+  @Int64()
+  int a2;
+  @Int64()
+  int a3;
+  @Int64()
+  int a4;
+  @Int64()
+  int a5;
+  @Int64()
+  int a6;
+  @Int64()
+  int a7;
+}
+
+final sumStruct2Int64 = ffiTestFunctions.lookupFunction<
+    Int64 Function(Pointer<Struct2Int64>),
+    int Function(Pointer<Struct2Int64>)>('SumStruct2Int64', isLeaf: true);
+
+final sumStruct4Int64 = ffiTestFunctions.lookupFunction<
+    Int64 Function(Pointer<Struct4Int64>),
+    int Function(Pointer<Struct4Int64>)>('SumStruct4Int64', isLeaf: true);
+
+final sumStruct8Int64 = ffiTestFunctions.lookupFunction<
+    Int64 Function(Pointer<Struct8Int64>),
+    int Function(Pointer<Struct8Int64>)>('SumStruct8Int64', isLeaf: true);
+
+//
+// Benchmark fixture.
+//
+
+// Operations per call of [FfiOverheadBenchmark.run].
+const N = 1000;
+
+abstract class FfiOverheadBenchmark {
+  final String name;
+
+  FfiOverheadBenchmark(String name) : name = 'FfiOverhead.$name';
+
+  // Performs N operations, returns a value depending on their results.
+  int run();
+
+  // Returns the number of nanoseconds per operation.
+  double measureFor(Duration duration) {
+    final sw = Stopwatch()..start();
+    final durationInMicroseconds = duration.inMicroseconds;
+
+    int numberOfOperations = 0;
+    int totalMicroseconds = 0;
+    int result = 0;
+    do {
+      result ^= run();
+      numberOfOperations += N;
+      totalMicroseconds = sw.elapsedMicroseconds;
+    } while (totalMicroseconds < durationInMicroseconds);
+    if (result == -1) {
+      throw 'Unexpected result';
+    }
+
+    final int totalNanoseconds = sw.elapsed.inMicroseconds * 1000;
+    return totalNanoseconds / numberOfOperations;
+  }
+
+  // Runs warmup phase, runs benchmark and reports result.
+  void report() {
+    // Warmup for 100 ms.
+    measureFor(const Duration(milliseconds: 100));
+
+    // Run benchmark for 2 seconds.
+    final double nsPerOperation = measureFor(const Duration(seconds: 2));
+
+    // Report result.
+    print('$name(RunTimeRaw): $nsPerOperation ns.');
+  }
+}
+
+//
+// Transitions.
+//
+
+class CallInt64 extends FfiOverheadBenchmark {
+  CallInt64() : super('Call.Int64');
+
+  int run() {
+    int x = 0;
+    for (int i = 0; i < N; i++) {
+      x += identity(i);
+    }
+    return x;
+  }
+}
+
+class CallInt64Leaf extends FfiOverheadBenchmark {
+  CallInt64Leaf() : super('CallLeaf.Int64');
+
+  int run() {
+    int x = 0;
+    for (int i = 0; i < N; i++) {
+      x += identityLeaf(i);
+    }
+    return x;
+  }
+}
+
+class CallInt64Lazy extends FfiOverheadBenchmark {
+  CallInt64Lazy() : super('CallLazy.Int64');
+
+  int run() {
+    int x = 0;
+    for (int i = 0; i < N; i++) {
+      x += identityLazy(i);
+    }
+    return x;
+  }
+}
+
+class CallDouble extends FfiOverheadBenchmark {
+  CallDouble() : super('Call.Double');
+
+  int run() {
+    double x = 0.0;
+    for (int i = 0; i < N; i++) {
+      x += identityDouble(1.0);
+    }
+    return x.toInt();
+  }
+}
+
+class CallDoubleLeaf extends FfiOverheadBenchmark {
+  CallDoubleLeaf() : super('CallLeaf.Double');
+
+  int run() {
+    double x = 0.0;
+    for (int i = 0; i < N; i++) {
+      x += identityDoubleLeaf(1.0);
+    }
+    return x.toInt();
+  }
+}
+
+//
+// Callbacks.
+//
+
+class CallbackRoundTrip extends FfiOverheadBenchmark {
+  CallbackRoundTrip() : super('Callback.RoundTrip');
+
+  int run() {
+    int x = 0;
+    for (int i = 0; i < N; i++) {
+      x += callCallback(dartIdentityPointer, i);
+    }
+    return x;
+  }
+}
+
+//
+// Structs passed by pointer.
+//
+
+class StructPointer2Int64 extends FfiOverheadBenchmark {
+  final Pointer<Struct2Int64> pointer;
+
+  StructPointer2Int64(Arena arena)
+      : pointer = arena.allocate(sizeOf<Struct2Int64>()),
+        super('StructPointer.2Int64');
+
+  int run() {
+    int x = 0;
+    final Struct2Int64 s = pointer.ref;
+    for (int i = 0; i < N; i++) {
+      s.a0 = i;
+      s.a1 = i;
+      x += sumStruct2Int64(pointer);
+    }
+    return x;
+  }
+}
+
+class StructPointer4Int64 extends FfiOverheadBenchmark {
+  final Pointer<Struct4Int64> pointer;
+
+  StructPointer4Int64(Arena arena)
+      : pointer = arena.allocate(sizeOf<Struct4Int64>()),
+        super('StructPointer.4Int64');
+
+  int run() {
+    int x = 0;
+    final Struct4Int64 s = pointer.ref;
+    for (int i = 0; i < N; i++) {
+      s.a0 = i;
+      s.a1 = i;
+      s.a2 = i;
+      s.a3 = i;
+      x += sumStruct4Int64(pointer);
+    }
+    return x;
+  }
+}
+
+class StructPointer8Int64 extends FfiOverheadBenchmark {
+  final Pointer<Struct8Int64> pointer;
+
+  StructPointer8Int64(Arena arena)
+      : pointer = arena.allocate(sizeOf<Struct8Int64>()),
+        super('StructPointer.8Int64');
+
+  int run() {
+    int x = 0;
+    final Struct8Int64 s = pointer.ref;
+    for (int i = 0; i < N; i++) {
+      s.a0 = i;
+      s.a1 = i;
+      s.a2 = i;
+      s.a3 = i;
+      s.a4 = i;
+      s.a5 = i;
+      s.a6 = i;
+      s.a7 = i;
+      x += sumStruct8Int64(pointer);
+    }
+    return x;
+  }
+}
+
+//
+// Pointer arithmetic.
+//
+
+class PointerIndex extends FfiOverheadBenchmark {
+  final Pointer<Int64> pointer;
+
+  PointerIndex(Arena arena)
+      : pointer = arena.allocate(N * sizeOf<Int64>()),
+        super('Pointer.Index');
+
+  int run() {
+    for (int i = 0; i < N; i++) {
+      pointer[i] = i;
+    }
+    int x = 0;
+    for (int i = 0; i < N; i++) {
+      x += pointer[i];
+    }
+    return x;
+  }
+}
+
+class PointerElementAt extends FfiOverheadBenchmark {
+  final Pointer<Int64> pointer;
+
+  PointerElementAt(Arena arena)
+      : pointer = arena.allocate(N * sizeOf<Int64>()),
+        super('Pointer.ElementAt');
+
+  int run() {
+    Pointer<Int64> p = pointer;
+    for (int i = 0; i < N; i++) {
+      p.value = i;
+      p = p.elementAt(1);
+    }
+    int x = 0;
+    p = pointer;
+    for (int i = 0; i < N; i++) {
+      x += p.value;
+      p = p.elementAt(1);
+    }
+    return x;
+  }
+}
+
+class ArenaAllocate extends FfiOverheadBenchmark {
+  ArenaAllocate() : super('Arena.Allocate');
+
+  int run() {
+    final arena = Arena();
+    int x = 0;
+    for (int i = 0; i < N; i++) {
+      x ^= arena.allocate<Int64>(sizeOf<Int64>()).address;
+    }
+    arena.releaseAll();
+    return x & 0xFF;
+  }
+}
+
+void main() {
+  final arena = Arena();
+  final benchmarks = [
+    () => CallInt64(),
+    () => CallInt64Leaf(),
+    () => CallInt64Lazy(),
+    () => CallDouble(),
+    () => CallDoubleLeaf(),
+    () => CallbackRoundTrip(),
+    () => StructPointer2Int64(arena),
+    () => StructPointer4Int64(arena),
+    () => StructPointer8Int64(arena),
+    () => PointerIndex(arena),
+    () => PointerElementAt(arena),
+    () => ArenaAllocate(),
+  ];
+  for (final benchmark in benchmarks) {
+    benchmark().report();
+  }
+  arena.releaseAll();
+}
@@ -0,0 +1,52 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include <stdint.h>
+
+int64_t Identity(int64_t x) {
+  return x;
+}
+
+double IdentityDouble(double x) {
+  return x;
+}
+
+int64_t CallCallback(int64_t (*callback)(int64_t), int64_t x) {
+  return callback(x);
+}
+
+typedef struct {
+  int64_t a0;
+  int64_t a1;
+} Struct2Int64;
+
+typedef struct {
+  int64_t a0;
+  int64_t a1;
+  int64_t a2;
+  int64_t a3;
+} Struct4Int64;
+
+typedef struct {
+  int64_t a0;
+  int64_t a1;
+  int64_t a2;
+  int64_t a3;
+  int64_t a4;
+  int64_t a5;
+  int64_t a6;
+  int64_t a7;
+} Struct8Int64;
+
+int64_t SumStruct2Int64(Struct2Int64* s) {
+  return s->a0 + s->a1;
+}
+
+int64_t SumStruct4Int64(Struct4Int64* s) {
+  return s->a0 + s->a1 + s->a2 + s->a3;
+}
+
+int64_t SumStruct8Int64(Struct8Int64* s) {
+  return s->a0 + s->a1 + s->a2 + s->a3 + s->a4 + s->a5 + s->a6 + s->a7;
+}
@@ -46,8 +46,11 @@ export '../fasta/fasta_codes.dart'
         messageBytecodeLimitExceededTooManyArguments,
         messageFfiExceptionalReturnNull,
         messageFfiExpectedConstant,
+        messageFfiLeafCallMustNotReturnHandle,
+        messageFfiLeafCallMustNotTakeHandle,
         noLength,
         templateFfiDartTypeMismatch,
+        templateFfiExpectedConstantArg,
         templateFfiExpectedExceptionalReturn,
         templateFfiExpectedNoExceptionalReturn,
         templateFfiExtendsOrImplementsSealedClass,
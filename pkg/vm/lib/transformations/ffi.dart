@@ -197,12 +197,19 @@ class FfiTransformer extends Transformer {
   final Class nativeFunctionClass;
   final Class pointerClass;
   final Class structClass;
+  final Class ffiNativeClass;
+  final Field ffiNativeNameField;
+  final Field ffiNativeIsLeafField;
+  final Class typedDataClass;
   final Procedure castMethod;
   final Procedure offsetByMethod;
   final Procedure elementAtMethod;
   final Procedure addressGetter;
   final Procedure asFunctionMethod;
   final Procedure asFunctionInternal;
+  final Procedure asLeafFunctionInternal;
+  final Procedure asLazyFunctionInternal;
+  final Procedure asLazyLeafFunctionInternal;
   final Procedure lookupFunctionMethod;
   final Procedure fromFunctionMethod;
   final Field addressOfField;
@@ -216,6 +223,10 @@ class FfiTransformer extends Transformer {
   final Map<NativeType, Procedure> storeMethods;
   final Map<NativeType, Procedure> elementAtMethods;
   final Procedure loadStructMethod;
+  final Procedure structPointerRef;
+  final Procedure structPointerElementAt;
+  final Procedure numAddition;
+  final Procedure numMultiplication;
   final Procedure asFunctionTearoff;
   final Procedure lookupFunctionTearoff;
 
@@ -237,6 +248,13 @@ class FfiTransformer extends Transformer {
         nativeFunctionClass = index.getClass('dart:ffi', 'NativeFunction'),
         pointerClass = index.getClass('dart:ffi', 'Pointer'),
         structClass = index.getClass('dart:ffi', 'Struct'),
+        ffiNativeClass = index.getClass('dart:ffi', 'FfiNative'),
+        ffiNativeNameField =
+            index.getMember('dart:ffi', 'FfiNative', 'nativeName'),
+        ffiNativeIsLeafField =
+            index.getMember('dart:ffi', 'FfiNative', 'isLeaf'),
+        typedDataClass =
+            coreTypes.index.getClass('dart:typed_data', 'TypedData'),
         castMethod = index.getMember('dart:ffi', 'Pointer', 'cast'),
         offsetByMethod = index.getMember('dart:ffi', 'Pointer', '_offsetBy'),
         elementAtMethod = index.getMember('dart:ffi', 'Pointer', 'elementAt'),
@@ -250,6 +268,12 @@ class FfiTransformer extends Transformer {
             index.getMember('dart:ffi', 'NativeFunctionPointer', 'asFunction'),
         asFunctionInternal =
             index.getTopLevelMember('dart:ffi', '_asFunctionInternal'),
+        asLeafFunctionInternal =
+            index.getTopLevelMember('dart:ffi', '_asLeafFunctionInternal'),
+        asLazyFunctionInternal =
+            index.getTopLevelMember('dart:ffi', '_asLazyFunctionInternal'),
+        asLazyLeafFunctionInternal =
+            index.getTopLevelMember('dart:ffi', '_asLazyLeafFunctionInternal'),
         lookupFunctionMethod = index.getMember(
             'dart:ffi', 'DynamicLibraryExtension', 'lookupFunction'),
         fromFunctionMethod =
@@ -277,6 +301,12 @@ class FfiTransformer extends Transformer {
           return index.getTopLevelMember('dart:ffi', "_elementAt$name");
         }),
         loadStructMethod = index.getTopLevelMember('dart:ffi', '_loadStruct'),
+        structPointerRef =
+            index.getMember('dart:ffi', 'StructPointer', 'get:ref'),
+        structPointerElementAt =
+            index.getMember('dart:ffi', 'StructPointer', '[]'),
+        numAddition = coreTypes.index.getMember('dart:core', 'num', '+'),
+        numMultiplication = coreTypes.index.getMember('dart:core', 'num', '*'),
         asFunctionTearoff = index.getMember('dart:ffi', 'NativeFunctionPointer',
             LibraryIndex.tearoffPrefix + 'asFunction'),
         lookupFunctionTearoff = index.getMember(
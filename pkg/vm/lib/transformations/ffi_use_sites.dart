@@ -8,7 +8,10 @@ import 'package:front_end/src/api_unstable/vm.dart'
     show
         messageFfiExceptionalReturnNull,
         messageFfiExpectedConstant,
+        messageFfiLeafCallMustNotReturnHandle,
+        messageFfiLeafCallMustNotTakeHandle,
         templateFfiDartTypeMismatch,
+        templateFfiExpectedConstantArg,
         templateFfiExpectedExceptionalReturn,
         templateFfiExpectedNoExceptionalReturn,
         templateFfiExtendsOrImplementsSealedClass,
@@ -132,9 +135,90 @@ class _FfiUseSiteTransformer extends FfiTransformer {
     _staticTypeContext = new StaticTypeContext(node, env);
     final result = super.visitProcedure(node);
     _staticTypeContext = null;
+    if (node.isExternal && node.isStatic) {
+      try {
+        _replaceFfiNative(node);
+      } on _FfiStaticTypeError {
+        // It's OK to swallow the exception because the diagnostics issued will
+        // cause compilation to fail. By continuing, we can report more
+        // diagnostics before compilation ends.
+      }
+    }
     return result;
   }
 
+  // Gives external static functions annotated with `@FfiNative` a body which
+  // calls a lazily bound FFI trampoline:
+  //
+  // final DS _#ffiNative0 =
+  //     _asLazyFunctionInternal<DS, NS>('library uri', 'nativeName');
+  //
+  // R f(a, b) => _#ffiNative0(a, b);
+  //
+  // or calls _asLazyLeafFunctionInternal for `isLeaf: true`. On the first call
+  // the VM resolves 'nativeName' with the FFI native resolver of the library.
+  void _replaceFfiNative(Procedure node) {
+    final ConstantExpression annotation = node.annotations
+        .whereType<ConstantExpression>()
+        .firstWhere(
+            (expr) =>
+                expr.constant is InstanceConstant &&
+                (expr.constant as InstanceConstant).classNode ==
+                    ffiNativeClass,
+            orElse: () => null);
+    if (annotation == null) return;
+
+    final InstanceConstant constant = annotation.constant;
+    final DartType nativeSignature = constant.typeArguments[0];
+    final StringConstant nativeName =
+        constant.fieldValues[ffiNativeNameField.reference];
+    final BoolConstant isLeafConstant =
+        constant.fieldValues[ffiNativeIsLeafField.reference];
+    final bool isLeaf = isLeafConstant.value;
+
+    final FunctionType dartSignature =
+        node.function.computeThisFunctionType(currentLibrary.nonNullable);
+    final DartType nativeType = InterfaceType(
+        nativeFunctionClass, Nullability.legacy, [nativeSignature]);
+    _ensureNativeTypeValid(nativeType, annotation);
+    _ensureNativeTypeToDartType(
+        nativeType,
+        isLeaf
+            ? _withTypedDataArgumentsAsPointers(nativeType, dartSignature)
+            : dartSignature,
+        annotation);
+    if (isLeaf) {
+      _ensureLeafCallDoesNotUseHandles(nativeType, annotation);
+    }
+
+    final Name name = Name("_#ffiNative${callbackCount++}", currentLibrary);
+    final Field field = Field(name,
+        type: dartSignature,
+        initializer: StaticInvocation(
+            isLeaf ? asLazyLeafFunctionInternal : asLazyFunctionInternal,
+            Arguments([
+              StringLiteral(currentLibrary.importUri.toString()),
+              StringLiteral(nativeName.value)
+            ], types: [
+              dartSignature,
+              nativeSignature
+            ])),
+        isStatic: true,
+        isFinal: true,
+        fileUri: currentLibrary.fileUri,
+        reference: currentLibraryIndex?.lookupField(name.name)?.reference)
+      ..fileOffset = node.fileOffset;
+    currentLibrary.addMember(field);
+
+    final Arguments arguments = Arguments(node.function.positionalParameters
+        .map<Expression>((parameter) => VariableGet(parameter))
+        .toList());
+    node.function.body = ReturnStatement(
+        MethodInvocation(StaticGet(field), Name("call"), arguments))
+      ..parent = node.function;
+    node.isExternal = false;
+  }
+
   @override
   visitPropertyGet(PropertyGet node) {
     super.visitPropertyGet(node);
@@ -171,23 +255,46 @@ class _FfiUseSiteTransformer extends FfiTransformer {
             nativeFunctionClass, Nullability.legacy, [node.arguments.types[0]]);
         final DartType dartType = node.arguments.types[1];
 
+        final bool isLeaf = _isLeafCall(node);
+        final bool isLazy = _isLazyLookup(node);
+
         _ensureNativeTypeValid(nativeType, node);
-        _ensureNativeTypeToDartType(nativeType, dartType, node);
+        _ensureNativeTypeToDartType(
+            nativeType,
+            isLeaf
+                ? _withTypedDataArgumentsAsPointers(nativeType, dartType)
+                : dartType,
+            node);
+
+        if (isLeaf) {
+          _ensureLeafCallDoesNotUseHandles(nativeType, node);
+        }
 
-        return _replaceLookupFunction(node);
+        return _replaceLookupFunction(node, isLeaf, isLazy);
       } else if (target == asFunctionMethod) {
         final DartType dartType = node.arguments.types[1];
         final DartType nativeType = InterfaceType(
             nativeFunctionClass, Nullability.legacy, [node.arguments.types[0]]);
 
+        final bool isLeaf = _isLeafCall(node);
+
         _ensureNativeTypeValid(nativeType, node);
-        _ensureNativeTypeToDartType(nativeType, dartType, node);
+        _ensureNativeTypeToDartType(
+            nativeType,
+            isLeaf
+                ? _withTypedDataArgumentsAsPointers(nativeType, dartType)
+                : dartType,
+            node);
+
+        if (isLeaf) {
+          _ensureLeafCallDoesNotUseHandles(nativeType, node);
+        }
 
         final DartType nativeSignature =
             (nativeType as InterfaceType).typeArguments[0];
         // Inline function body to make all type arguments instatiated.
         return StaticInvocation(
-            asFunctionInternal,
+            isLeaf ? asLeafFunctionInternal : asFunctionInternal,
             Arguments([node.arguments.positional[0]],
                 types: [dartType, nativeSignature]));
       } else if (target == fromFunctionMethod) {
@@ -271,6 +378,9 @@ class _FfiUseSiteTransformer extends FfiTransformer {
           }
         }
         return _replaceFromFunction(node);
+      } else if (target == structPointerRef ||
+          target == structPointerElementAt) {
+        return _replaceStructPointerLoad(node);
       }
     } on _FfiStaticTypeError {
       // It's OK to swallow the exception because the diagnostics issued will
@@ -287,14 +397,30 @@ class _FfiUseSiteTransformer extends FfiTransformer {
   // Above, in 'visitStaticInvocation', we ensure that the type arguments to
   // 'lookupFunction' are constants, so by inlining the call to 'asFunction' at
   // the call-site, we ensure that there are no generic calls to 'asFunction'.
-  Expression _replaceLookupFunction(StaticInvocation node) {
+  Expression _replaceLookupFunction(
+      StaticInvocation node, bool isLeaf, bool isLazy) {
     // The generated code looks like:
     //
     // _asFunctionInternal<DS, NS>(lookup<NativeFunction<NS>>(symbolName))
+    //
+    // or calls _asLeafFunctionInternal for `isLeaf: true`. For `isLazy: true`
+    // it looks like:
+    //
+    // _asLazyFunctionInternal<DS, NS>(library, symbolName)
+    //
+    // or calls _asLazyLeafFunctionInternal for `isLeaf: true`.
 
     final DartType nativeSignature = node.arguments.types[0];
     final DartType dartSignature = node.arguments.types[1];
 
+    if (isLazy) {
+      return StaticInvocation(
+          isLeaf ? asLazyLeafFunctionInternal : asLazyFunctionInternal,
+          Arguments(
+              [node.arguments.positional[0], node.arguments.positional[1]],
+              types: [dartSignature, nativeSignature]));
+    }
+
     final Arguments args = Arguments([
       node.arguments.positional[1]
     ], types: [
@@ -307,7 +433,8 @@ class _FfiUseSiteTransformer extends FfiTransformer {
         args,
         libraryLookupMethod);
 
-    return StaticInvocation(asFunctionInternal,
+    return StaticInvocation(
+        isLeaf ? asLeafFunctionInternal : asFunctionInternal,
         Arguments([lookupResult], types: [dartSignature, nativeSignature]));
   }
 
@@ -348,6 +475,50 @@ class _FfiUseSiteTransformer extends FfiTransformer {
     return StaticGet(field);
   }
 
+  // Where the struct type is known, 'ref' and '[]' on a Pointer construct the
+  // struct directly instead of calling the '_loadStruct' runtime entry:
+  //
+  // S.#fromPointer(pointer)
+  // S.#fromPointer(_fromAddress<S>(pointer.address + index * S.#sizeOf))
+  //
+  // Optimized code which only accesses fields of the struct can then inline
+  // the constructor and the field getters. The struct doesn't escape, so
+  // allocation sinking removes it and only loads from native memory remain.
+  Expression _replaceStructPointerLoad(StaticInvocation node) {
+    final DartType structType = node.arguments.types[0];
+    if (structType is! InterfaceType) {
+      // Do not rewire generic invocations.
+      return node;
+    }
+    final Class structClass = (structType as InterfaceType).classNode;
+    final Constructor fromPointer = structClass.constructors.firstWhere(
+        (c) => c.name.name == '#fromPointer',
+        orElse: () => null);
+    final Field sizeOf = structClass.fields
+        .firstWhere((f) => f.name.name == '#sizeOf', orElse: () => null);
+    if (fromPointer == null || sizeOf == null) {
+      return node;
+    }
+
+    Expression pointer = node.arguments.positional[0];
+    if (node.target == structPointerElementAt) {
+      final Expression offset = MethodInvocation(
+          node.arguments.positional[1],
+          numMultiplication.name,
+          Arguments([StaticGet(sizeOf)]),
+          numMultiplication);
+      final Expression address = MethodInvocation(
+          DirectPropertyGet(pointer, addressGetter),
+          numAddition.name,
+          Arguments([offset]),
+          numAddition);
+      pointer = StaticInvocation(
+          fromAddressInternal, Arguments([address], types: [structType]));
+    }
+    return ConstructorInvocation(fromPointer, Arguments([pointer]))
+      ..fileOffset = node.fileOffset;
+  }
+
   @override
   visitMethodInvocation(MethodInvocation node) {
     super.visitMethodInvocation(node);
@@ -383,6 +554,92 @@ class _FfiUseSiteTransformer extends FfiTransformer {
     return node;
   }
 
+  // The `isLeaf` argument of 'asFunction' and 'lookupFunction' selects the
+  // trampoline at compile time, so it must be a constant.
+  bool _isLeafCall(StaticInvocation node) =>
+      _constantBoolArgument(node, 'isLeaf');
+
+  // The `isLazy` argument of 'lookupFunction' selects the internal function
+  // it is replaced with, so it must be a constant.
+  bool _isLazyLookup(StaticInvocation node) =>
+      _constantBoolArgument(node, 'isLazy');
+
+  bool _constantBoolArgument(StaticInvocation node, String name) {
+    for (final NamedExpression argument in node.arguments.named) {
+      if (argument.name != name) continue;
+      final Expression value = argument.value;
+      if (value is BoolLiteral) return value.value;
+      if (value is ConstantExpression && value.constant is BoolConstant) {
+        return (value.constant as BoolConstant).value;
+      }
+      diagnosticReporter.report(
+          templateFfiExpectedConstantArg.withArguments(name),
+          argument.fileOffset,
+          1,
+          node.location.file);
+      throw _FfiStaticTypeError();
+    }
+    return false;
+  }
+
+  // Leaf calls don't enter an API scope for the native code, so handles
+  // can't be passed in or out.
+  void _ensureLeafCallDoesNotUseHandles(DartType nativeType, Expression node) {
+    final FunctionType signature =
+        (nativeType as InterfaceType).typeArguments[0];
+    if (_isHandleType(signature.returnType)) {
+      diagnosticReporter.report(messageFfiLeafCallMustNotReturnHandle,
+          node.fileOffset, 1, node.location.file);
+      throw _FfiStaticTypeError();
+    }
+    for (final DartType parameter in signature.positionalParameters) {
+      if (_isHandleType(parameter)) {
+        diagnosticReporter.report(messageFfiLeafCallMustNotTakeHandle,
+            node.fileOffset, 1, node.location.file);
+        throw _FfiStaticTypeError();
+      }
+    }
+  }
+
+  // Leaf calls can pass a TypedData for a Pointer argument, the native
+  // function gets a pointer to its contents. The GC can't move the TypedData
+  // during a leaf call. Returns [dartType] with these arguments replaced by the
+  // Pointer type, to check it against [nativeType].
+  DartType _withTypedDataArgumentsAsPointers(
+      DartType nativeType, DartType dartType) {
+    final FunctionType signature =
+        (nativeType as InterfaceType).typeArguments[0];
+    if (dartType is! FunctionType) return dartType;
+    final FunctionType dartSignature = dartType;
+    final int count = signature.positionalParameters.length;
+    if (dartSignature.positionalParameters.length != count) return dartType;
+
+    final DartType typedDataType =
+        InterfaceType(typedDataClass, Nullability.legacy);
+    bool changed = false;
+    final List<DartType> parameters = <DartType>[];
+    for (int i = 0; i < count; i++) {
+      final DartType nativeParameter = signature.positionalParameters[i];
+      DartType parameter = dartSignature.positionalParameters[i];
+      if (nativeParameter is InterfaceType &&
+          getType(nativeParameter.classNode) == NativeType.kPointer &&
+          parameter is InterfaceType &&
+          env.isSubtypeOf(parameter, typedDataType,
+              SubtypeCheckMode.ignoringNullabilities)) {
+        parameter = nativeParameter;
+        changed = true;
+      }
+      parameters.add(parameter);
+    }
+    if (!changed) return dartType;
+    return FunctionType(parameters, dartSignature.returnType,
+        dartSignature.declaredNullability,
+        requiredParameterCount: dartSignature.requiredParameterCount);
+  }
+
+  bool _isHandleType(DartType type) =>
+      type is InterfaceType && getType(type.classNode) == NativeType.kHandle;
+
   DartType _pointerTypeGetTypeArg(DartType pointerType) {
     return pointerType is InterfaceType ? pointerType.typeArguments[0] : null;
   }
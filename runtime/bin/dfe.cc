@@ -10,8 +10,10 @@
 #include "bin/exe_utils.h"
 #include "bin/file.h"
 #include "bin/platform.h"
+#include "bin/process.h"
 #include "bin/utils.h"
 #include "include/dart_tools_api.h"
+#include "platform/text_buffer.h"
 #include "platform/utils.h"
 
 extern "C" {
@@ -65,7 +67,9 @@ DFE::DFE()
       use_incremental_compiler_(false),
       frontend_filename_(nullptr),
       application_kernel_buffer_(nullptr),
-      application_kernel_buffer_size_(0) {
+      application_kernel_buffer_size_(0),
+      kernel_cache_directory_(nullptr),
+      kernel_cache_seed_(0) {
 }
 
 DFE::~DFE() {
@@ -77,6 +81,9 @@ DFE::~DFE() {
   free(application_kernel_buffer_);
   application_kernel_buffer_ = nullptr;
   application_kernel_buffer_size_ = 0;
+
+  free(kernel_cache_directory_);
+  kernel_cache_directory_ = nullptr;
 }
 
 void DFE::Init() {
@@ -193,12 +200,241 @@ Dart_KernelCompilationResult DFE::CompileScript(const char* script_uri,
                               package_config);
 }
 
+// 64-bit FNV-1a.
+static const uint64_t kHashSeed = 0xcbf29ce484222325ULL;
+
+static uint64_t HashBytes(uint64_t hash, const uint8_t* data, intptr_t size) {
+  for (intptr_t i = 0; i < size; i++) {
+    hash = (hash ^ data[i]) * 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+static uint64_t HashString(uint64_t hash, const char* str) {
+  // Include the terminator, so that consecutive strings can't run together.
+  return HashBytes(hash, reinterpret_cast<const uint8_t*>(str),
+                   strlen(str) + 1);
+}
+
+static bool ReadWholeFile(const char* path, uint8_t** buffer, intptr_t* size) {
+  void* file = DartUtils::OpenFile(path, false);
+  if (file == nullptr) {
+    return false;
+  }
+  DartUtils::ReadFile(buffer, size, file);
+  DartUtils::CloseFile(file);
+  return *buffer != nullptr;
+}
+
+static bool HashFile(const char* path, uint64_t* hash) {
+  uint8_t* buffer = nullptr;
+  intptr_t size = 0;
+  if (!ReadWholeFile(path, &buffer, &size)) {
+    return false;
+  }
+  *hash = HashBytes(kHashSeed, buffer, size);
+  free(buffer);
+  return true;
+}
+
+void DFE::set_kernel_cache(const char* directory,
+                           intptr_t flag_count,
+                           const char** flags,
+                           dart::SimpleHashMap* environment) {
+  free(kernel_cache_directory_);
+  kernel_cache_directory_ = Utils::StrDup(directory);
+  uint64_t hash = HashString(kHashSeed, Dart_VersionString());
+  // The flags include those the kernel service compiles with, such as
+  // --enable-experiment and the null safety mode.
+  for (intptr_t i = 0; i < flag_count; i++) {
+    hash = HashString(hash, flags[i]);
+  }
+  // The kernel service evaluates constants against the -D environment. The
+  // entries are combined by addition, as the iteration order of the map
+  // depends on the order the options were given in.
+  uint64_t environment_hash = 0;
+  if (environment != nullptr) {
+    for (dart::SimpleHashMap::Entry* entry = environment->Start();
+         entry != nullptr; entry = environment->Next(entry)) {
+      uint64_t entry_hash =
+          HashString(kHashSeed, reinterpret_cast<const char*>(entry->key));
+      entry_hash =
+          HashString(entry_hash, reinterpret_cast<const char*>(entry->value));
+      environment_hash += entry_hash;
+    }
+  }
+  hash = HashBytes(hash, reinterpret_cast<const uint8_t*>(&environment_hash),
+                   sizeof(environment_hash));
+  // Relative script and package config paths depend on the working directory.
+  char* current = Directory::CurrentNoScope();
+  if (current != nullptr) {
+    hash = HashString(hash, current);
+    free(current);
+  }
+  kernel_cache_seed_ = hash;
+}
+
+char* DFE::KernelCachePath(const char* script_uri, const char* package_config) {
+  // The incremental compiler has to see the initial compilation of the
+  // script to support reloading it.
+  if ((kernel_cache_directory_ == nullptr) || use_incremental_compiler()) {
+    return nullptr;
+  }
+  uint64_t hash = HashString(kernel_cache_seed_, script_uri);
+  hash = HashString(hash, package_config != nullptr ? package_config : "");
+  return Utils::SCreate("%s%s%016" Px64, kernel_cache_directory_,
+                        File::PathSeparator(), hash);
+}
+
+// A cache entry consists of [cache_path].dill with the kernel and
+// [cache_path].deps listing the hash of the kernel followed by the hash and
+// path of each source it was compiled from, one per line.
+bool DFE::ReadCachedKernel(const char* cache_path,
+                           uint8_t** kernel_buffer,
+                           intptr_t* kernel_buffer_size) {
+  char* deps_path = Utils::SCreate("%s.deps", cache_path);
+  uint8_t* deps = nullptr;
+  intptr_t deps_size = 0;
+  bool success = ReadWholeFile(deps_path, &deps, &deps_size);
+  free(deps_path);
+  if (!success) {
+    return false;
+  }
+  char* contents = reinterpret_cast<char*>(realloc(deps, deps_size + 1));
+  if (contents == nullptr) {
+    free(deps);
+    return false;
+  }
+  contents[deps_size] = '\0';
+
+  // Check that none of the sources changed.
+  uint64_t kernel_hash = 0;
+  char* line = contents;
+  char* end = nullptr;
+  kernel_hash = strtoull(line, &end, 16);
+  success = (end != line) && (*end == '\n');
+  line = end + 1;
+  while (success && (*line != '\0')) {
+    const uint64_t expected = strtoull(line, &end, 16);
+    char* newline = strchr(end, '\n');
+    if ((end == line) || (*end != ' ') || (newline == nullptr)) {
+      success = false;
+      break;
+    }
+    *newline = '\0';
+    uint64_t actual = 0;
+    success = HashFile(end + 1, &actual) && (actual == expected);
+    line = newline + 1;
+  }
+  free(contents);
+  if (!success) {
+    return false;
+  }
+
+  char* dill_path = Utils::SCreate("%s.dill", cache_path);
+  uint8_t* kernel = nullptr;
+  intptr_t kernel_size = 0;
+  success = ReadWholeFile(dill_path, &kernel, &kernel_size);
+  free(dill_path);
+  if (!success) {
+    return false;
+  }
+  // The hash guards against a .dill replaced by a concurrent run.
+  if ((HashBytes(kHashSeed, kernel, kernel_size) != kernel_hash) ||
+      !Dart_IsKernel(kernel, kernel_size)) {
+    free(kernel);
+    return false;
+  }
+  *kernel_buffer = kernel;
+  *kernel_buffer_size = kernel_size;
+  return true;
+}
+
+// Writes [contents] to [path] through a temporary file, so that concurrent
+// runs never see a partially written file.
+static bool WriteFileAtomically(const char* path,
+                                const void* contents,
+                                intptr_t size) {
+  char* temp_path =
+      Utils::SCreate("%s.%" Pd, path, Process::CurrentProcessId());
+  File* file = File::Open(nullptr, temp_path, File::kWriteTruncate);
+  bool success = (file != nullptr);
+  if (success) {
+    success = file->WriteFully(contents, size);
+    file->Release();
+    success = success && File::Rename(nullptr, temp_path, path);
+    if (!success) {
+      File::Delete(nullptr, temp_path);
+    }
+  }
+  free(temp_path);
+  return success;
+}
+
+void DFE::WriteCachedKernel(const char* cache_path,
+                            const uint8_t* kernel_buffer,
+                            intptr_t kernel_buffer_size) {
+  Dart_KernelCompilationResult result = Dart_KernelListDependencies();
+  if (result.status != Dart_KernelCompilationStatus_Ok) {
+    free(result.kernel);
+    free(result.error);
+    return;
+  }
+
+  // The dependencies are separated by spaces, with spaces and backslashes
+  // in paths escaped by a backslash.
+  TextBuffer deps(1024);
+  deps.Printf("%016" Px64 "\n",
+              HashBytes(kHashSeed, kernel_buffer, kernel_buffer_size));
+  TextBuffer path(256);
+  bool success = true;
+  const char* list = reinterpret_cast<const char*>(result.kernel);
+  for (intptr_t i = 0; success && (i <= result.kernel_size); i++) {
+    const char c = (i < result.kernel_size) ? list[i] : ' ';
+    if ((c == '\\') && (i + 1 < result.kernel_size)) {
+      path.AddChar(list[++i]);
+    } else if (c == '\n') {
+      success = false;
+    } else if (c != ' ') {
+      path.AddChar(c);
+    } else if (path.length() > 0) {
+      uint64_t hash = 0;
+      success = HashFile(path.buffer(), &hash);
+      deps.Printf("%016" Px64 " %s\n", hash, path.buffer());
+      path.Clear();
+    }
+  }
+  free(result.kernel);
+  if (!success) {
+    return;
+  }
+
+  // Write the kernel first, the cache entry is only used once its
+  // dependencies are there too.
+  char* dill_path = Utils::SCreate("%s.dill", cache_path);
+  success = WriteFileAtomically(dill_path, kernel_buffer, kernel_buffer_size);
+  free(dill_path);
+  if (success) {
+    char* deps_path = Utils::SCreate("%s.deps", cache_path);
+    WriteFileAtomically(deps_path, deps.buffer(), deps.length());
+    free(deps_path);
+  }
+}
+
 void DFE::CompileAndReadScript(const char* script_uri,
                                uint8_t** kernel_buffer,
                                intptr_t* kernel_buffer_size,
                                char** error,
                                int* exit_code,
                                const char* package_config) {
+  char* cache_path = KernelCachePath(script_uri, package_config);
+  if ((cache_path != nullptr) &&
+      ReadCachedKernel(cache_path, kernel_buffer, kernel_buffer_size)) {
+    free(cache_path);
+    *error = nullptr;
+    *exit_code = 0;
+    return;
+  }
   Dart_KernelCompilationResult result =
       CompileScript(script_uri, use_incremental_compiler(), package_config);
   switch (result.status) {
@@ -207,6 +443,9 @@ void DFE::CompileAndReadScript(const char* script_uri,
       *kernel_buffer_size = result.kernel_size;
       *error = nullptr;
       *exit_code = 0;
+      if (cache_path != nullptr) {
+        WriteCachedKernel(cache_path, result.kernel, result.kernel_size);
+      }
       break;
     case Dart_KernelCompilationStatus_Error:
       free(result.kernel);
@@ -224,6 +463,7 @@ void DFE::CompileAndReadScript(const char* script_uri,
       *exit_code = kErrorExitCode;
       break;
   }
+  free(cache_path);
 }
 
 void DFE::ReadScript(const char* script_uri,
@@ -11,6 +11,7 @@
 #include "include/dart_native_api.h"
 #include "platform/assert.h"
 #include "platform/globals.h"
+#include "platform/hashmap.h"
 #include "platform/utils.h"
 
 namespace dart {
@@ -42,6 +43,14 @@ class DFE {
   }
   bool use_incremental_compiler() const { return use_incremental_compiler_; }
 
+  // Keeps the compiled kernel of scripts in [directory], keyed by the given
+  // VM flags, the -D [environment] and the VM version, and reuses it as long
+  // as none of the sources it was compiled from changed.
+  void set_kernel_cache(const char* directory,
+                        intptr_t flag_count,
+                        const char** flags,
+                        dart::SimpleHashMap* environment);
+
   // Returns the platform binary file name if the path to
   // kernel binaries was set using SetKernelBinaries.
   const char* GetPlatformBinaryFilename();
@@ -112,8 +121,23 @@ class DFE {
   uint8_t* application_kernel_buffer_;
   intptr_t application_kernel_buffer_size_;
 
+  // Directory of the compiled kernel cache, or nullptr if disabled.
+  char* kernel_cache_directory_;
+  // Hash of everything besides the script that affects its compilation.
+  uint64_t kernel_cache_seed_;
+
   void InitKernelServiceAndPlatformDills();
 
+  // Returns the malloc'ed path prefix of the cache entries for the script,
+  // or nullptr if the compiled kernel should not be cached.
+  char* KernelCachePath(const char* script_uri, const char* package_config);
+  bool ReadCachedKernel(const char* cache_path,
+                        uint8_t** kernel_buffer,
+                        intptr_t* kernel_buffer_size);
+  void WriteCachedKernel(const char* cache_path,
+                         const uint8_t* kernel_buffer,
+                         intptr_t kernel_buffer_size);
+
   DISALLOW_COPY_AND_ASSIGN(DFE);
 };
 
@@ -396,7 +396,9 @@ CObject* Directory::ListNextRequest(const CObjectArray& request) {
   if (dir_listing->IsEmpty()) {
     return new CObjectArray(CObject::NewArray(0));
   }
-  const int kArraySize = 128;
+  // Each entry takes two slots. Larger batches mean fewer round trips to
+  // the IO service when listing big trees.
+  const int kArraySize = 1024;
   CObjectArray* response = new CObjectArray(CObject::NewArray(kArraySize));
   dir_listing->SetArray(response, kArraySize);
   Directory::List(dir_listing);
@@ -448,14 +450,13 @@ bool AsyncDirectoryListing::AddFileSystemEntityToResponse(Response type,
                                                           const char* arg) {
   array_->SetAt(index_++, new CObjectInt32(CObject::NewInt32(type)));
   if (arg != NULL) {
+    // The path is copied out of the scope allocated array when the response
+    // is posted, so no separately malloc'ed and finalized buffer is needed.
     size_t len = strlen(arg);
-    Dart_CObject* io_buffer = CObject::NewIOBuffer(len);
-    uint8_t* data = io_buffer->value.as_external_typed_data.data;
-    memmove(reinterpret_cast<char*>(data), arg, len);
-
-    CObjectExternalUint8Array* external_array =
-        new CObjectExternalUint8Array(io_buffer);
-    array_->SetAt(index_++, external_array);
+    CObjectUint8Array* path =
+        new CObjectUint8Array(CObject::NewUint8Array(len));
+    memmove(path->Buffer(), arg, len);
+    array_->SetAt(index_++, path);
   } else {
     array_->SetAt(index_++, CObject::Null());
   }
@@ -10,7 +10,8 @@
 #include <vm/cpu.h>
 #include <vm/virtual_memory.h>
 
-#if defined(HOST_OS_FUCHSIA)
+#if defined(HOST_OS_FUCHSIA) || defined(HOST_OS_LINUX) ||                     \
+    defined(HOST_OS_ANDROID) || defined(HOST_OS_MACOS)
 #include <sys/mman.h>
 #endif
 
@@ -450,6 +451,16 @@ bool LoadedElf::LoadSegments() {
     CHECK_ERROR(memory != nullptr, "Could not map segment.");
     CHECK_ERROR(memory->address() == memory_start,
                 "Mapping not at requested address.");
+
+#if defined(HOST_OS_LINUX) || defined(HOST_OS_ANDROID) || defined(HOST_OS_MACOS)
+    // The deserializer reads the snapshot data from start to end right after
+    // loading, so ask the kernel to start reading the read-only segment in
+    // the background instead of faulting it in page by page. Instructions are
+    // left to be paged in on demand, as most of them are never run.
+    if (map_type == File::kReadOnly) {
+      madvise(memory_start, length, MADV_WILLNEED);
+    }
+#endif
   }
 
   return true;
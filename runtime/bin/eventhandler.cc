@@ -16,42 +16,79 @@ namespace dart {
 namespace bin {
 
 void TimeoutQueue::UpdateTimeout(Dart_Port port, int64_t timeout) {
-  // Find port if present.
-  Timeout* last = NULL;
-  Timeout* current = timeouts_;
-  while (current != NULL) {
-    if (current->port() == port) {
-      // Found.
-      if (timeout < 0) {
-        // Remove from list and delete existing.
-        if (last != NULL) {
-          last->set_next(current->next());
-        } else {
-          timeouts_ = current->next();
-        }
-        delete current;
-      } else {
-        // Update timeout.
-        current->set_timeout(timeout);
-      }
-      break;
-    }
-    last = current;
-    current = current->next();
+  Timeout key(port, 0);
+  const uint32_t hash = GetHashmapHashFromPort(port);
+  SimpleHashMap::Entry* entry = ports_.Lookup(&key, hash, timeout >= 0);
+  if (entry == NULL) {
+    // No timeout to remove.
+    return;
   }
-  if (current == NULL && timeout >= 0) {
+  Timeout* current = reinterpret_cast<Timeout*>(entry->value);
+  if (current == NULL) {
     // Not found, create a new.
-    timeouts_ = new Timeout(port, timeout, timeouts_);
+    current = new Timeout(port, timeout);
+    entry->key = current;
+    entry->value = current;
+    timeouts_.Add(current);
+    SiftUp(timeouts_.length() - 1);
+  } else if (timeout < 0) {
+    // Remove existing.
+    ports_.Remove(&key, hash);
+    RemoveAt(current->heap_index());
+    delete current;
+  } else {
+    // Update timeout.
+    const int64_t old_timeout = current->timeout();
+    current->set_timeout(timeout);
+    if (timeout < old_timeout) {
+      SiftUp(current->heap_index());
+    } else {
+      SiftDown(current->heap_index());
+    }
   }
-  // Clear and find next timeout.
-  next_timeout_ = NULL;
-  current = timeouts_;
-  while (current != NULL) {
-    if ((next_timeout_ == NULL) ||
-        (current->timeout() < next_timeout_->timeout())) {
-      next_timeout_ = current;
+}
+
+void TimeoutQueue::SiftUp(intptr_t index) {
+  Timeout* timeout = timeouts_[index];
+  while (index > 0) {
+    const intptr_t parent = (index - 1) / 2;
+    if (timeouts_[parent]->timeout() <= timeout->timeout()) {
+      break;
     }
-    current = current->next();
+    SetAt(index, timeouts_[parent]);
+    index = parent;
+  }
+  SetAt(index, timeout);
+}
+
+void TimeoutQueue::SiftDown(intptr_t index) {
+  Timeout* timeout = timeouts_[index];
+  const intptr_t length = timeouts_.length();
+  while (true) {
+    intptr_t child = 2 * index + 1;
+    if (child >= length) {
+      break;
+    }
+    if ((child + 1 < length) &&
+        (timeouts_[child + 1]->timeout() < timeouts_[child]->timeout())) {
+      child++;
+    }
+    if (timeout->timeout() <= timeouts_[child]->timeout()) {
+      break;
+    }
+    SetAt(index, timeouts_[child]);
+    index = child;
+  }
+  SetAt(index, timeout);
+}
+
+void TimeoutQueue::RemoveAt(intptr_t index) {
+  Timeout* last = timeouts_.RemoveLast();
+  if (index < timeouts_.length()) {
+    // Move the last timeout into the hole and restore the heap order.
+    SetAt(index, last);
+    SiftUp(index);
+    SiftDown(last->heap_index());
   }
 }
 
@@ -61,6 +98,7 @@ static Monitor* shutdown_monitor = NULL;
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
+  HostLookupCache::Initialize();
 
   ASSERT(event_handler == NULL);
   shutdown_monitor = new Monitor();
@@ -99,6 +137,7 @@ void EventHandler::Stop() {
 
   // Destroy the global socket registry.
   ListeningSocketRegistry::Cleanup();
+  HostLookupCache::Cleanup();
 }
 
 EventHandlerImplementation* EventHandler::delegate() {
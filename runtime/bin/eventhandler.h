@@ -9,6 +9,7 @@
 #include "bin/dartutils.h"
 #include "bin/isolate_data.h"
 
+#include "platform/growable_array.h"
 #include "platform/hashmap.h"
 
 namespace dart {
@@ -56,12 +57,16 @@ enum MessageFlags {
 #define TOKEN_COUNT(data) (data & ((1 << kCloseCommand) - 1))
 // clang-format on
 
+// The pending timeouts of the event handler, at most one per port. They are
+// kept in a binary min-heap ordered by time and indexed by port, so adding,
+// updating and removing a timeout takes O(log n) time in the number of
+// ports, and the next timeout is found in constant time.
 class TimeoutQueue {
  private:
   class Timeout {
    public:
-    Timeout(Dart_Port port, int64_t timeout, Timeout* next)
-        : port_(port), timeout_(timeout), next_(next) {}
+    Timeout(Dart_Port port, int64_t timeout)
+        : port_(port), timeout_(timeout), heap_index_(-1) {}
 
     Dart_Port port() const { return port_; }
 
@@ -71,33 +76,33 @@ class TimeoutQueue {
       timeout_ = timeout;
     }
 
-    Timeout* next() const { return next_; }
-    void set_next(Timeout* next) { next_ = next; }
+    intptr_t heap_index() const { return heap_index_; }
+    void set_heap_index(intptr_t heap_index) { heap_index_ = heap_index; }
 
    private:
     Dart_Port port_;
     int64_t timeout_;
-    Timeout* next_;
+    intptr_t heap_index_;
   };
 
  public:
-  TimeoutQueue() : next_timeout_(NULL), timeouts_(NULL) {}
+  TimeoutQueue() : timeouts_(), ports_(&SameTimeoutPort, kInitialCapacity) {}
 
   ~TimeoutQueue() {
     while (HasTimeout())
       RemoveCurrent();
   }
 
-  bool HasTimeout() const { return next_timeout_ != NULL; }
+  bool HasTimeout() const { return !timeouts_.is_empty(); }
 
   int64_t CurrentTimeout() const {
-    ASSERT(next_timeout_ != NULL);
-    return next_timeout_->timeout();
+    ASSERT(HasTimeout());
+    return timeouts_[0]->timeout();
   }
 
   Dart_Port CurrentPort() const {
-    ASSERT(next_timeout_ != NULL);
-    return next_timeout_->port();
+    ASSERT(HasTimeout());
+    return timeouts_[0]->port();
   }
 
   void RemoveCurrent() { UpdateTimeout(CurrentPort(), -1); }
@@ -105,8 +110,29 @@ class TimeoutQueue {
   void UpdateTimeout(Dart_Port port, int64_t timeout);
 
  private:
-  Timeout* next_timeout_;
-  Timeout* timeouts_;
+  static const int kInitialCapacity = 16;
+
+  // The keys of [ports_] are the [Timeout]s themselves, so ports are compared
+  // in full also where a pointer is narrower than a port.
+  static bool SameTimeoutPort(void* key1, void* key2) {
+    return reinterpret_cast<Timeout*>(key1)->port() ==
+           reinterpret_cast<Timeout*>(key2)->port();
+  }
+
+  static uint32_t GetHashmapHashFromPort(Dart_Port port) {
+    return static_cast<uint32_t>(port & 0xFFFFFFFF);
+  }
+
+  void SetAt(intptr_t index, Timeout* timeout) {
+    timeouts_[index] = timeout;
+    timeout->set_heap_index(index);
+  }
+  void SiftUp(intptr_t index);
+  void SiftDown(intptr_t index);
+  void RemoveAt(intptr_t index);
+
+  MallocGrowableArray<Timeout*> timeouts_;
+  SimpleHashMap ports_;
 
   DISALLOW_COPY_AND_ASSIGN(TimeoutQueue);
 };
@@ -23,6 +23,7 @@
 #include "bin/lockers.h"
 #include "bin/socket.h"
 #include "bin/thread.h"
+#include "bin/utils.h"
 #include "platform/syslog.h"
 #include "platform/utils.h"
 
@@ -352,10 +353,18 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
       int64_t val;
       VOID_TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
           read(timer_fd_, &val, sizeof(val)));
+      // Notify every port whose timeout has passed in one go, instead of
+      // rearming the timer for each of them.
+      const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
       if (timeout_queue_.HasTimeout()) {
         DartUtils::PostNull(timeout_queue_.CurrentPort());
         timeout_queue_.RemoveCurrent();
       }
+      while (timeout_queue_.HasTimeout() &&
+             (timeout_queue_.CurrentTimeout() <= now)) {
+        DartUtils::PostNull(timeout_queue_.CurrentPort());
+        timeout_queue_.RemoveCurrent();
+      }
       UpdateTimerFd();
     } else {
       DescriptorInfo* di =
@@ -412,13 +412,12 @@ int64_t EventHandlerImplementation::GetTimeout() {
 }
 
 void EventHandlerImplementation::HandleTimeout() {
-  if (timeout_queue_.HasTimeout()) {
-    int64_t millis = timeout_queue_.CurrentTimeout() -
-                     TimerUtils::GetCurrentMonotonicMillis();
-    if (millis <= 0) {
-      DartUtils::PostNull(timeout_queue_.CurrentPort());
-      timeout_queue_.RemoveCurrent();
-    }
+  // Notify every port whose timeout has passed, not only the first one.
+  const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  while (timeout_queue_.HasTimeout() &&
+         (timeout_queue_.CurrentTimeout() <= now)) {
+    DartUtils::PostNull(timeout_queue_.CurrentPort());
+    timeout_queue_.RemoveCurrent();
   }
 }
 
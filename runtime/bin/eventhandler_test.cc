@@ -79,5 +79,48 @@ VM_UNIT_TEST_CASE(CircularLinkedList) {
   list.Remove(4242);
 }
 
+VM_UNIT_TEST_CASE(TimeoutQueue) {
+  TimeoutQueue queue;
+  EXPECT(!queue.HasTimeout());
+
+  // Test: The earliest timeout is current, whatever the insertion order.
+  for (int i = 1; i <= 100; i++) {
+    queue.UpdateTimeout(i, ((i * 37) % 101) + 1000);
+  }
+  EXPECT(queue.HasTimeout());
+  EXPECT_EQ(1001, queue.CurrentTimeout());
+  EXPECT_EQ(71, queue.CurrentPort());
+
+  // Test: Updating a timeout moves it in both directions.
+  queue.UpdateTimeout(50, 10);
+  EXPECT_EQ(10, queue.CurrentTimeout());
+  EXPECT_EQ(50, queue.CurrentPort());
+  queue.UpdateTimeout(50, 5000);
+  EXPECT_EQ(1001, queue.CurrentTimeout());
+  EXPECT_EQ(71, queue.CurrentPort());
+
+  // Test: Removing a port which has no timeout is a no-op.
+  queue.UpdateTimeout(4242, -1);
+  EXPECT_EQ(71, queue.CurrentPort());
+
+  // Test: Ports which differ only in their upper bits are distinct.
+  const Dart_Port high_port = (static_cast<Dart_Port>(1) << 40) | 71;
+  queue.UpdateTimeout(high_port, 1);
+  EXPECT_EQ(high_port, queue.CurrentPort());
+  queue.UpdateTimeout(high_port, -1);
+  EXPECT_EQ(71, queue.CurrentPort());
+
+  // Test: Removing the current timeouts yields them in order.
+  int64_t last = 0;
+  for (int i = 1; i <= 100; i++) {
+    EXPECT(queue.HasTimeout());
+    EXPECT_LE(last, queue.CurrentTimeout());
+    last = queue.CurrentTimeout();
+    queue.RemoveCurrent();
+  }
+  EXPECT_EQ(5000, last);
+  EXPECT(!queue.HasTimeout());
+}
+
 }  // namespace bin
 }  // namespace dart
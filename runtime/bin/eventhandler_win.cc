@@ -1283,6 +1283,13 @@ void EventHandlerImplementation::HandleTimeout() {
   }
   DartUtils::PostNull(timeout_queue_.CurrentPort());
   timeout_queue_.RemoveCurrent();
+  // Also notify the other ports whose timeout has passed.
+  const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  while (timeout_queue_.HasTimeout() &&
+         (timeout_queue_.CurrentTimeout() <= now)) {
+    DartUtils::PostNull(timeout_queue_.CurrentPort());
+    timeout_queue_.RemoveCurrent();
+  }
 }
 
 void EventHandlerImplementation::HandleIOCompletion(DWORD bytes,
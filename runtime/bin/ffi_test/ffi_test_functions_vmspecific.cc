@@ -770,6 +770,28 @@ DART_EXPORT void ThreadPoolTest_BarrierSync(
   dart_enter_isolate(isolate);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Functions for asynchronous callback tests.
+//
+// vmspecific_async_callbacks_test.dart
+
+// Calls |callback| |calls_per_thread| times from each of |num_threads| new
+// threads. Doesn't wait for them, since they block while the queue of the
+// callback is full.
+DART_EXPORT void CallAsyncCallbackFromThreads(
+    void (*callback)(int32_t, int64_t, double, uint8_t*),
+    intptr_t num_threads,
+    intptr_t calls_per_thread) {
+  for (intptr_t t = 0; t < num_threads; t++) {
+    std::thread([=]() {
+      for (intptr_t i = 0; i < calls_per_thread; i++) {
+        callback(static_cast<int32_t>(t), i, 0.5 * i,
+                 reinterpret_cast<uint8_t*>(i));
+      }
+    }).detach();
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Functions for handle tests.
 //
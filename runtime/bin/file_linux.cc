@@ -13,6 +13,7 @@
 #include <sys/mman.h>      // NOLINT
 #include <sys/sendfile.h>  // NOLINT
 #include <sys/stat.h>      // NOLINT
+#include <sys/syscall.h>   // NOLINT
 #include <sys/types.h>     // NOLINT
 #include <unistd.h>        // NOLINT
 #include <utime.h>         // NOLINT
@@ -400,6 +401,36 @@ bool File::RenameLink(Namespace* namespc,
                                      newns.path())) == 0);
 }
 
+// Copies all of [old_fd] to [new_fd] with copy_file_range, which lets the
+// file system share extents or copy without a round trip through user space.
+// Returns false without having copied anything if the kernel or the file
+// systems involved do not support it, or if nothing was copied. Otherwise
+// sets [result] like the sendfile loop in File::Copy.
+static bool CopyFileRange(int old_fd, int new_fd, intptr_t* result) {
+#if defined(SYS_copy_file_range)
+  loff_t in_offset = 0;
+  loff_t out_offset = 0;
+  do {
+    *result = NO_RETRY_EXPECTED(syscall(SYS_copy_file_range, old_fd,
+                                        &in_offset, new_fd, &out_offset,
+                                        kMaxUint32, 0));
+  } while (*result > 0);
+  if (in_offset != 0) {
+    return true;
+  }
+  // Kernels 5.3 to 5.18 report 0 bytes copied at offset 0 for procfs, sysfs
+  // and other special files. Let the caller copy those (and empty files) by
+  // other means.
+  if (*result == 0) {
+    return false;
+  }
+  return (errno != ENOSYS) && (errno != EXDEV) && (errno != EINVAL) &&
+         (errno != EOPNOTSUPP);
+#else
+  return false;
+#endif
+}
+
 bool File::Copy(Namespace* namespc,
                 const char* old_path,
                 const char* new_path) {
@@ -424,27 +455,31 @@ bool File::Copy(Namespace* namespc,
     close(old_fd);
     return false;
   }
-  int64_t offset = 0;
   intptr_t result = 1;
-  while (result > 0) {
-    // Loop to ensure we copy everything, and not only up to 2GB.
-    result = NO_RETRY_EXPECTED(sendfile64(new_fd, old_fd, &offset, kMaxUint32));
-  }
-  // From sendfile man pages:
-  //   Applications may wish to fall back to read(2)/write(2) in the case
-  //   where sendfile() fails with EINVAL or ENOSYS.
-  if ((result < 0) && ((errno == EINVAL) || (errno == ENOSYS))) {
-    const intptr_t kBufferSize = 8 * KB;
-    uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(kBufferSize));
-    while ((result = TEMP_FAILURE_RETRY(read(old_fd, buffer, kBufferSize))) >
-           0) {
-      int wrote = TEMP_FAILURE_RETRY(write(new_fd, buffer, result));
-      if (wrote != result) {
-        result = -1;
-        break;
+  if (!CopyFileRange(old_fd, new_fd, &result)) {
+    int64_t offset = 0;
+    result = 1;
+    while (result > 0) {
+      // Loop to ensure we copy everything, and not only up to 2GB.
+      result =
+          NO_RETRY_EXPECTED(sendfile64(new_fd, old_fd, &offset, kMaxUint32));
+    }
+    // From sendfile man pages:
+    //   Applications may wish to fall back to read(2)/write(2) in the case
+    //   where sendfile() fails with EINVAL or ENOSYS.
+    if ((result < 0) && ((errno == EINVAL) || (errno == ENOSYS))) {
+      const intptr_t kBufferSize = 8 * KB;
+      uint8_t* buffer = reinterpret_cast<uint8_t*>(malloc(kBufferSize));
+      while ((result = TEMP_FAILURE_RETRY(
+                  read(old_fd, buffer, kBufferSize))) > 0) {
+        int wrote = TEMP_FAILURE_RETRY(write(new_fd, buffer, result));
+        if (wrote != result) {
+          result = -1;
+          break;
+        }
       }
+      free(buffer);
     }
-    free(buffer);
   }
   int e = errno;
   close(old_fd);
@@ -100,10 +100,24 @@ static int InotifyEventToMask(struct inotify_event* e) {
   return mask;
 }
 
+// Whether [e] repeats [previous] exactly, such as the stream of IN_MODIFY
+// events produced by a large write. Move events are never dropped, as they
+// are paired up by their cookie.
+static bool IsRepeatedEvent(struct inotify_event* previous,
+                            struct inotify_event* e) {
+  return (previous != NULL) && (previous->wd == e->wd) &&
+         (previous->mask == e->mask) && (e->cookie == 0) &&
+         (previous->cookie == 0) && (previous->len == e->len) &&
+         (strncmp(previous->name, e->name, e->len) == 0);
+}
+
 Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   USE(path_id);
   const intptr_t kEventSize = sizeof(struct inotify_event);
-  const intptr_t kBufferSize = kEventSize + NAME_MAX + 1;
+  // Read many events at once. Event storms would otherwise take one call
+  // from Dart per event.
+  const intptr_t kBufferSize = 16 * KB;
+  COMPILE_ASSERT(kBufferSize >= kEventSize + NAME_MAX + 1);
   uint8_t buffer[kBufferSize];
   intptr_t bytes =
       SocketBase::Read(id, buffer, kBufferSize, SocketBase::kAsync);
@@ -114,10 +128,12 @@ Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   Dart_Handle events = Dart_NewList(kMaxCount);
   intptr_t offset = 0;
   intptr_t i = 0;
+  struct inotify_event* previous = NULL;
   while (offset < bytes) {
     struct inotify_event* e =
         reinterpret_cast<struct inotify_event*>(buffer + offset);
-    if ((e->mask & IN_IGNORED) == 0) {
+    if (((e->mask & IN_IGNORED) == 0) && !IsRepeatedEvent(previous, e)) {
+      previous = e;
       Dart_Handle event = Dart_NewList(5);
       int mask = InotifyEventToMask(e);
       Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
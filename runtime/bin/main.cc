@@ -32,6 +32,7 @@
 #include "include/dart_api.h"
 #include "include/dart_embedder_api.h"
 #include "include/dart_tools_api.h"
+#include "platform/atomic.h"
 #include "platform/globals.h"
 #include "platform/growable_array.h"
 #include "platform/hashmap.h"
@@ -74,6 +75,7 @@ static bool kernel_isolate_is_running = false;
 static Dart_Isolate main_isolate = NULL;
 
 static void ReadFile(const char* filename, uint8_t** buffer, intptr_t* size);
+static void SaveWarmStartFeedback();
 
 #define SAVE_ERROR_AND_EXIT(result)                                            \
   *error = Utils::StrDup(Dart_GetError(result));                               \
@@ -99,6 +101,93 @@ static void ReadFile(const char* filename, uint8_t** buffer, intptr_t* size);
     SAVE_ERROR_AND_EXIT(result);                                               \
   }
 
+// Phases of starting up the main isolate reported by --print-startup-phases,
+// as V(enumerator, JSON name).
+#define STARTUP_PHASE_LIST(V)                                                  \
+  V(VMInitialize, "vmInitialize")                                              \
+  V(KernelIsolate, "kernelIsolate")                                            \
+  V(ServiceIsolate, "serviceIsolate")                                          \
+  V(MainIsolateGroup, "mainIsolateGroup")                                      \
+  V(MainKernel, "mainKernel")                                                  \
+  V(MainLoad, "mainLoad")                                                      \
+  V(StartMainIsolate, "startMainIsolate")                                      \
+  V(RunLoop, "runLoop")
+
+enum StartupPhase {
+#define DECLARE_STARTUP_PHASE(name, json_name) k##name,
+  STARTUP_PHASE_LIST(DECLARE_STARTUP_PHASE)
+#undef DECLARE_STARTUP_PHASE
+  kNumStartupPhases
+};
+
+// Phases may be recorded from the threads the VM creates isolates on. Only
+// the first occurrence of a phase is kept.
+static int64_t process_start_micros = 0;
+static RelaxedAtomic<int64_t> startup_phase_start[kNumStartupPhases];
+static RelaxedAtomic<int64_t> startup_phase_end[kNumStartupPhases];
+
+class StartupPhaseScope {
+ public:
+  explicit StartupPhaseScope(StartupPhase phase, bool enabled = true)
+      : phase_(phase), start_(enabled ? Dart_TimelineGetMicros() : 0) {}
+
+  ~StartupPhaseScope() {
+    if ((start_ == 0) || !Options::print_startup_phases()) {
+      return;
+    }
+    int64_t expected = 0;
+    if (startup_phase_start[phase_].compare_exchange_strong(expected,
+                                                            start_)) {
+      startup_phase_end[phase_] = Dart_TimelineGetMicros();
+    }
+  }
+
+ private:
+  const StartupPhase phase_;
+  const int64_t start_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupPhaseScope);
+};
+
+// Prints the recorded phases in microseconds relative to the start of main,
+// e.g. {"type":"StartupPhases","phases":[{"name":"vmInitialize","start":52,
+// "duration":4211},...]}.
+static void PrintStartupPhases() {
+  static RelaxedAtomic<bool> printed = false;
+  bool expected = false;
+  if (!Options::print_startup_phases() ||
+      !printed.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  static const char* const kNames[] = {
+#define STARTUP_PHASE_NAME(name, json_name) json_name,
+      STARTUP_PHASE_LIST(STARTUP_PHASE_NAME)
+#undef STARTUP_PHASE_NAME
+  };
+  TextBuffer buffer(512);
+  buffer.AddString("{\"type\":\"StartupPhases\",\"phases\":[");
+  const char* separator = "";
+  for (intptr_t i = 0; i < kNumStartupPhases; i++) {
+    const int64_t start = startup_phase_start[i];
+    if (start == 0) {
+      continue;
+    }
+    // A phase that is still running, like the run loop on a hard exit,
+    // ends now.
+    int64_t end = startup_phase_end[i];
+    if (end == 0) {
+      end = Dart_TimelineGetMicros();
+    }
+    buffer.Printf("%s{\"name\":\"%s\",\"start\":%" Pd64
+                  ",\"duration\":%" Pd64 "}",
+                  separator, kNames[i], start - process_start_micros,
+                  end - start);
+    separator = ",";
+  }
+  buffer.AddString("]}");
+  Syslog::PrintErr("%s\n", buffer.buffer());
+}
+
 static void WriteDepsFile(Dart_Isolate isolate) {
   if (Options::depfile() == NULL) {
     return;
@@ -134,6 +223,14 @@ static void WriteDepsFile(Dart_Isolate isolate) {
 }
 
 static void OnExitHook(int64_t exit_code) {
+  PrintStartupPhases();
+  if (Dart_CurrentIsolate() == main_isolate) {
+    SaveWarmStartFeedback();
+  }
+  if ((Options::gen_snapshot_kind() != kAppJIT) &&
+      (Options::depfile() == NULL)) {
+    return;
+  }
   if (Dart_CurrentIsolate() != main_isolate) {
     Syslog::PrintErr(
         "A snapshot was requested, but a secondary isolate "
@@ -302,9 +399,12 @@ static Dart_Isolate IsolateSetupHelper(Dart_Isolate isolate,
     }
     uint8_t* application_kernel_buffer = NULL;
     intptr_t application_kernel_buffer_size = 0;
-    dfe.CompileAndReadScript(script_uri, &application_kernel_buffer,
-                             &application_kernel_buffer_size, error, exit_code,
-                             resolved_packages_config);
+    {
+      StartupPhaseScope phase(kMainKernel, is_main_isolate);
+      dfe.CompileAndReadScript(script_uri, &application_kernel_buffer,
+                               &application_kernel_buffer_size, error,
+                               exit_code, resolved_packages_config);
+    }
     if (application_kernel_buffer == NULL) {
       Dart_ExitScope();
       Dart_ShutdownIsolate();
@@ -320,7 +420,10 @@ static Dart_Isolate IsolateSetupHelper(Dart_Isolate isolate,
     CHECK_RESULT(uri);
     Dart_Handle resolved_script_uri = DartUtils::ResolveScript(uri);
     CHECK_RESULT(resolved_script_uri);
-    result = Dart_LoadScriptFromKernel(kernel_buffer, kernel_buffer_size);
+    {
+      StartupPhaseScope phase(kMainLoad, is_main_isolate);
+      result = Dart_LoadScriptFromKernel(kernel_buffer, kernel_buffer_size);
+    }
     CHECK_RESULT(result);
   }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -788,6 +891,7 @@ static Dart_Isolate CreateIsolateGroupAndSetup(const char* script_uri,
   int exit_code = 0;
 #if !defined(EXCLUDE_CFE_AND_KERNEL_PLATFORM)
   if (strcmp(script_uri, DART_KERNEL_ISOLATE_NAME) == 0) {
+    StartupPhaseScope phase(kKernelIsolate);
     return CreateAndSetupKernelIsolate(script_uri, package_config, flags, error,
                                        &exit_code);
   }
@@ -801,6 +905,7 @@ static Dart_Isolate CreateIsolateGroupAndSetup(const char* script_uri,
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
   if (strcmp(script_uri, DART_VM_SERVICE_ISOLATE_NAME) == 0) {
+    StartupPhaseScope phase(kServiceIsolate);
     return CreateAndSetupServiceIsolate(script_uri, package_config, flags,
                                         error, &exit_code);
   }
@@ -907,6 +1012,50 @@ static void ReadFile(const char* filename, uint8_t** buffer, intptr_t* size) {
   file->Release();
 }
 
+// The feedback of a previous run is only an optimization, so a missing or
+// stale file is not an error.
+static void LoadWarmStartFeedback() {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  const char* filename = Options::warm_start_filename();
+  if ((filename == nullptr) || !File::Exists(nullptr, filename)) {
+    return;
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t size = 0;
+  ReadFile(filename, &buffer, &size);
+  Dart_Handle result = Dart_LoadTypeFeedback(buffer, size);
+  free(buffer);
+  if (Dart_IsError(result)) {
+    Syslog::PrintErr("Ignoring warm start feedback in %s: %s\n", filename,
+                     Dart_GetError(result));
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+}
+
+static void SaveWarmStartFeedback() {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  const char* filename = Options::warm_start_filename();
+  if (filename == nullptr) {
+    return;
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t size = 0;
+  Dart_Handle result = Dart_SaveTypeFeedback(&buffer, &size);
+  if (Dart_IsError(result)) {
+    Syslog::PrintErr("Unable to save warm start feedback: %s\n",
+                     Dart_GetError(result));
+    return;
+  }
+  File* file = File::Open(nullptr, filename, File::kWriteTruncate);
+  if ((file == nullptr) || !file->WriteFully(buffer, size)) {
+    Syslog::PrintErr("Unable to write warm start feedback to %s\n", filename);
+  }
+  if (file != nullptr) {
+    file->Release();
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+}
+
 bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
   // Call CreateIsolateGroupAndSetup which creates an isolate and loads up
   // the specified application script.
@@ -915,9 +1064,14 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
   Dart_IsolateFlags flags;
   Dart_IsolateFlagsInitialize(&flags);
 
-  Dart_Isolate isolate = CreateIsolateGroupAndSetupHelper(
-      /* is_main_isolate */ true, script_name, "main", Options::packages_file(),
-      &flags, NULL /* callback_data */, &error, &exit_code);
+  Dart_Isolate isolate = NULL;
+  {
+    StartupPhaseScope phase(kMainIsolateGroup);
+    isolate = CreateIsolateGroupAndSetupHelper(
+        /* is_main_isolate */ true, script_name, "main",
+        Options::packages_file(), &flags, NULL /* callback_data */, &error,
+        &exit_code);
+  }
 
   if (isolate == NULL) {
     Syslog::PrintErr("%s\n", error);
@@ -985,6 +1139,7 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
       free(buffer);
       CHECK_RESULT(result);
     }
+    LoadWarmStartFeedback();
 
     // Create a closure for the main entry point which is in the exported
     // namespace of the root library or invoke a getter of the same name
@@ -1006,13 +1161,19 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
 
     Dart_Handle isolate_lib =
         Dart_LookupLibrary(Dart_NewStringFromCString("dart:isolate"));
-    result =
-        Dart_Invoke(isolate_lib, Dart_NewStringFromCString("_startMainIsolate"),
-                    kNumIsolateArgs, isolate_args);
+    {
+      StartupPhaseScope phase(kStartMainIsolate);
+      result = Dart_Invoke(isolate_lib,
+                           Dart_NewStringFromCString("_startMainIsolate"),
+                           kNumIsolateArgs, isolate_args);
+    }
     CHECK_RESULT(result);
 
     // Keep handling messages until the last active receive port is closed.
-    result = Dart_RunLoop();
+    {
+      StartupPhaseScope phase(kRunLoop);
+      result = Dart_RunLoop();
+    }
     // Generate an app snapshot after execution if specified.
     if (Options::gen_snapshot_kind() == kAppJIT) {
       if (!Dart_IsCompilationError(result)) {
@@ -1035,6 +1196,7 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
       CHECK_RESULT(result);
       WriteFile(Options::save_type_feedback_filename(), buffer, size);
     }
+    SaveWarmStartFeedback();
   }
 
   WriteDepsFile(isolate);
@@ -1083,6 +1245,7 @@ static Dart_GetVMServiceAssetsArchive GetVMServiceAssetsArchiveCallback = NULL;
 #endif  // !defined(PRODUCT)
 
 void main(int argc, char** argv) {
+  process_start_micros = Dart_TimelineGetMicros();
   char* script_name = nullptr;
   const int EXTRA_VM_ARGUMENTS = 10;
   CommandLineOptions vm_options(argc + EXTRA_VM_ARGUMENTS);
@@ -1213,13 +1376,19 @@ void main(int argc, char** argv) {
   if (Options::gen_snapshot_kind() == kAppJIT) {
     vm_options.AddArgument("--fields_may_be_reset");
   }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  if (Options::warm_start_filename() != nullptr) {
+    vm_options.AddArgument("--optimize_type_feedback_in_background");
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
 #if defined(DART_PRECOMPILED_RUNTIME)
   vm_options.AddArgument("--precompilation");
 #endif
-  // If we need to write an app-jit snapshot or a depfile, then add an exit
-  // hook that writes the snapshot and/or depfile as appropriate.
+  // If we need to write an app-jit snapshot, a depfile or the warm start
+  // feedback, then add an exit hook that writes them as appropriate.
   if ((Options::gen_snapshot_kind() == kAppJIT) ||
-      (Options::depfile() != NULL)) {
+      (Options::depfile() != NULL) || Options::print_startup_phases() ||
+      (Options::warm_start_filename() != NULL)) {
     Process::SetExitHook(OnExitHook);
   }
 
@@ -1242,6 +1411,14 @@ void main(int argc, char** argv) {
 #if !defined(DART_PRECOMPILED_RUNTIME)
   // Load vm_platform_strong.dill for dart:* source support.
   dfe.Init();
+  // Snapshot generation and depfiles need the kernel service to have
+  // compiled the script.
+  if ((Options::kernel_cache_directory() != nullptr) &&
+      (Options::gen_snapshot_kind() == kNone) &&
+      (Options::depfile() == nullptr)) {
+    dfe.set_kernel_cache(Options::kernel_cache_directory(), vm_options.count(),
+                         vm_options.arguments(), Options::environment());
+  }
   if (script_name != nullptr) {
     uint8_t* application_kernel_buffer = NULL;
     intptr_t application_kernel_buffer_size = 0;
@@ -1280,7 +1457,10 @@ void main(int argc, char** argv) {
   init_params.start_kernel_isolate = false;
 #endif
 
-  error = Dart_Initialize(&init_params);
+  {
+    StartupPhaseScope phase(kVMInitialize);
+    error = Dart_Initialize(&init_params);
+  }
   if (error != NULL) {
     dart::embedder::Cleanup();
     Syslog::PrintErr("VM initialization failed: %s\n", error);
@@ -1351,6 +1531,7 @@ void main(int argc, char** argv) {
   // Free environment if any.
   Options::DestroyEnvironment();
 
+  PrintStartupPhases();
   Platform::Exit(global_exit_code);
 }
 
@@ -192,6 +192,10 @@ void Options::PrintUsage() {
 "--trace-loading\n"
 "  enables tracing of library and script loading\n"
 "\n"
+"--print-startup-phases\n"
+"  Prints a JSON summary of how long each phase of startup took to stderr\n"
+"  when the process exits.\n"
+"\n"
 "--enable-vm-service[=<port>[/<bind-address>]]\n"
 "  Enables the VM service and listens on specified port for connections\n"
 "  (default port number is 8181, default bind address is localhost).\n"
@@ -212,6 +216,14 @@ void Options::PrintUsage() {
 "--root-certs-cache=<path>\n"
 "  The path to a cache directory containing the trusted root certificates to\n"
 "  use for secure socket connections.\n"
+"--kernel-cache=<path>\n"
+"  The path to a directory where the compiled kernel of scripts is kept, so\n"
+"  that later runs of an unchanged script can skip compiling it.\n"
+"--warm-start=<path>\n"
+"  The path to a file keeping the type feedback of the previous run. The\n"
+"  functions it records as hot are optimized by the background compiler at\n"
+"  startup, and the file is rewritten when the script finishes or calls\n"
+"  exit(), for example from a ProcessSignal.sigterm handler.\n"
 #if defined(HOST_OS_LINUX) || \
     defined(HOST_OS_ANDROID) || \
     defined(HOST_OS_FUCHSIA)
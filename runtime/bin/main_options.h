@@ -30,6 +30,8 @@ namespace bin {
   V(root_certs_file, root_certs_file)                                          \
   V(root_certs_cache, root_certs_cache)                                        \
   V(namespace, namespc)                                                        \
+  V(kernel_cache, kernel_cache_directory)                                      \
+  V(warm_start, warm_start_filename)                                           \
   V(write_service_info, vm_write_service_info_filename)
 
 // As STRING_OPTIONS_LIST but for boolean valued options. The default value is
@@ -47,7 +49,8 @@ namespace bin {
   V(preview_dart_2, nop_option)                                                \
   V(suppress_core_dump, suppress_core_dump)                                    \
   V(enable_service_port_fallback, enable_service_port_fallback)                \
-  V(disable_dart_dev, disable_dart_dev)
+  V(disable_dart_dev, disable_dart_dev)                                        \
+  V(print_startup_phases, print_startup_phases)
 
 // Boolean flags that have a short form.
 #define SHORT_BOOL_OPTIONS_LIST(V)                                             \
@@ -342,40 +342,110 @@ class BufferListBase {
 
 #if defined(HOST_OS_ANDROID) || defined(HOST_OS_FUCHSIA) ||                    \
     defined(HOST_OS_LINUX) || defined(HOST_OS_MACOS)
-class BufferList : public BufferListBase {
+// Collects the output of a process in a single buffer which grows as data
+// arrives and is handed over to Dart as an external Uint8List, so the data is
+// not copied again once the process is done.
+class BufferList {
  public:
-  BufferList() {}
+  BufferList() : data_(NULL), data_size_(0), capacity_(0) {}
+  ~BufferList() { Free(); }
 
   bool Read(int fd, intptr_t available) {
+    if (!Reserve(available)) {
+      errno = ENOMEM;
+      return false;
+    }
     // Read all available bytes.
     while (available > 0) {
-      if (free_size() == 0) {
-        if (!Allocate()) {
-          errno = ENOMEM;
-          return false;
-        }
-      }
-      ASSERT(free_size() > 0);
-      ASSERT(free_size() <= kBufferSize);
-      intptr_t block_size = dart::Utils::Minimum(free_size(), available);
 #if defined(HOST_OS_FUCHSIA)
       intptr_t bytes = NO_RETRY_EXPECTED(
-          read(fd, reinterpret_cast<void*>(FreeSpaceAddress()), block_size));
+          read(fd, reinterpret_cast<void*>(data_ + data_size_), available));
 #else
       intptr_t bytes = TEMP_FAILURE_RETRY(
-          read(fd, reinterpret_cast<void*>(FreeSpaceAddress()), block_size));
+          read(fd, reinterpret_cast<void*>(data_ + data_size_), available));
 #endif  // defined(HOST_OS_FUCHSIA)
       if (bytes < 0) {
         return false;
       }
-      set_data_size(data_size() + bytes);
-      set_free_size(free_size() - bytes);
+      if (bytes == 0) {
+        break;
+      }
+      data_size_ += bytes;
       available -= bytes;
     }
     return true;
   }
 
+  // Returns the collected data as a Uint8List. If an error occours an
+  // error handle is returned.
+  Dart_Handle GetData() {
+    if (data_size_ == 0) {
+      Free();
+      Dart_Handle result = IOBuffer::Allocate(0, NULL);
+      if (Dart_IsNull(result)) {
+        return DartUtils::NewDartOSError();
+      }
+      return result;
+    }
+    // Give back the unused tail of the buffer. Shrinking does not move the
+    // data with any reasonable malloc.
+    uint8_t* data = IOBuffer::Reallocate(data_, data_size_);
+    if (data == NULL) {
+      data = data_;
+    }
+    Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
+        Dart_TypedData_kUint8, data, data_size_, data, data_size_,
+        IOBuffer::Finalizer);
+    if (Dart_IsError(result)) {
+      data_ = data;
+      Free();
+      return result;
+    }
+    // The buffer is now owned by the Dart object.
+    data_ = NULL;
+    data_size_ = 0;
+    capacity_ = 0;
+    return result;
+  }
+
+#if defined(DEBUG)
+  bool IsEmpty() const { return data_ == NULL; }
+#endif
+
  private:
+  static const intptr_t kInitialCapacity = 16 * 1024;
+
+  // Makes room for [size] more bytes, at least doubling the capacity when
+  // the buffer has to grow.
+  bool Reserve(intptr_t size) {
+    if (capacity_ - data_size_ >= size) {
+      return true;
+    }
+    intptr_t new_capacity =
+        dart::Utils::Maximum(capacity_ * 2, kInitialCapacity);
+    while (new_capacity - data_size_ < size) {
+      new_capacity *= 2;
+    }
+    uint8_t* data = IOBuffer::Reallocate(data_, new_capacity);
+    if (data == NULL) {
+      return false;
+    }
+    data_ = data;
+    capacity_ = new_capacity;
+    return true;
+  }
+
+  void Free() {
+    IOBuffer::Free(data_);
+    data_ = NULL;
+    data_size_ = 0;
+    capacity_ = 0;
+  }
+
+  uint8_t* data_;
+  intptr_t data_size_;
+  intptr_t capacity_;
+
   DISALLOW_COPY_AND_ASSIGN(BufferList);
 };
 #endif  // defined(HOST_OS_ANDROID) ...
@@ -17,6 +17,18 @@
 #include <sys/wait.h>      // NOLINT
 #include <unistd.h>        // NOLINT
 
+// glibc reports exec failures from posix_spawn since 2.24, and can change the
+// working directory of the new process since 2.29.
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 24)
+#include <spawn.h>  // NOLINT
+#define USE_POSIX_SPAWN 1
+#endif
+#if __GLIBC_PREREQ(2, 29)
+#define USE_POSIX_SPAWN_CHDIR 1
+#endif
+#endif  // defined(__GLIBC__)
+
 #include "bin/dartutils.h"
 #include "bin/directory.h"
 #include "bin/fdutils.h"
@@ -73,6 +85,11 @@ class ProcessInfoList {
 
   static void AddProcess(pid_t pid, intptr_t fd) {
     MutexLocker locker(mutex_);
+    AddProcessLocked(pid, fd);
+  }
+
+  // Must be called with mutex() held.
+  static void AddProcessLocked(pid_t pid, intptr_t fd) {
     ProcessInfo* info = new ProcessInfo(pid, fd);
     info->set_next(active_processes_);
     active_processes_ = info;
@@ -90,6 +107,8 @@ class ProcessInfoList {
     return 0;
   }
 
+  static Mutex* mutex() { return mutex_; }
+
   static void RemoveProcess(pid_t pid) {
     MutexLocker locker(mutex_);
     ProcessInfo* prev = NULL;
@@ -312,6 +331,13 @@ class ProcessStarter {
       return err;
     }
 
+#if defined(USE_POSIX_SPAWN)
+    int spawn_result;
+    if (CanSpawn() && Spawn(&spawn_result)) {
+      return spawn_result;
+    }
+#endif  // defined(USE_POSIX_SPAWN)
+
     // Fork to create the new process.
     pid_t pid = TEMP_FAILURE_RETRY(fork());
     if (pid < 0) {
@@ -371,6 +397,16 @@ class ProcessStarter {
       return err;
     }
 
+    ConnectStdio();
+    ASSERT(exec_control_[0] == -1);
+    ASSERT(exec_control_[1] == -1);
+
+    *id_ = pid;
+    return 0;
+  }
+
+ private:
+  void ConnectStdio() {
     if (Process::ModeHasStdio(mode_)) {
       // Connect stdio, stdout and stderr.
       FDUtils::SetNonBlocking(read_in_[0]);
@@ -391,14 +427,121 @@ class ProcessStarter {
       ASSERT(read_err_[0] == -1);
       ASSERT(read_err_[1] == -1);
     }
-    ASSERT(exec_control_[0] == -1);
-    ASSERT(exec_control_[1] == -1);
+  }
 
+#if defined(USE_POSIX_SPAWN)
+  // Whether the process can be started with posix_spawn instead of fork.
+  // posix_spawn does not copy the page tables of this process, which gets
+  // expensive with a large heap. Detached processes still need the double
+  // fork to start a new session.
+  bool CanSpawn() {
+    if ((mode_ != kNormal) && (mode_ != kInheritStdio)) {
+      return false;
+    }
+    const bool search_path = (strchr(path_, '/') == NULL);
+    // execvp in the child searches the PATH of the new environment, while
+    // posix_spawnp searches the PATH of this process.
+    if (search_path && (program_environment_ != NULL)) {
+      return false;
+    }
+    if (working_directory_ != NULL) {
+#if defined(USE_POSIX_SPAWN_CHDIR)
+      // A relative path to the executable is resolved against the new
+      // working directory, which only the child process has.
+      return Namespace::IsDefault(namespc_) &&
+             (search_path || (path_[0] == '/'));
+#else
+      return false;
+#endif  // defined(USE_POSIX_SPAWN_CHDIR)
+    }
+    return true;
+  }
+
+  // Starts the process with posix_spawn and sets [start_result] like Start.
+  // Returns false without having started a process if the executable has to
+  // be started by the fork path instead.
+  bool Spawn(int* start_result) {
+    char realpath[PATH_MAX];
+    if (!FindPathInNamespace(realpath, PATH_MAX)) {
+      *start_result = CleanupAndReturnError();
+      return true;
+    }
+
+    posix_spawn_file_actions_t actions;
+    int result = posix_spawn_file_actions_init(&actions);
+    if (result != 0) {
+      errno = result;
+      *start_result = CleanupAndReturnError();
+      return true;
+    }
+    if (mode_ == kNormal) {
+      result = posix_spawn_file_actions_adddup2(&actions, write_out_[0],
+                                                STDIN_FILENO);
+      if (result == 0) {
+        result = posix_spawn_file_actions_adddup2(&actions, read_in_[1],
+                                                  STDOUT_FILENO);
+      }
+      if (result == 0) {
+        result = posix_spawn_file_actions_adddup2(&actions, read_err_[1],
+                                                  STDERR_FILENO);
+      }
+    } else {
+      ASSERT(mode_ == kInheritStdio);
+    }
+#if defined(USE_POSIX_SPAWN_CHDIR)
+    if ((result == 0) && (working_directory_ != NULL)) {
+      result =
+          posix_spawn_file_actions_addchdir_np(&actions, working_directory_);
+    }
+#endif  // defined(USE_POSIX_SPAWN_CHDIR)
+
+    int event_fds[2] = {-1, -1};
+    if ((result == 0) &&
+        (TEMP_FAILURE_RETRY(pipe2(event_fds, O_CLOEXEC)) < 0)) {
+      result = errno;
+    }
+
+    pid_t pid = -1;
+    if (result == 0) {
+      char** environment =
+          (program_environment_ != NULL) ? program_environment_ : environ;
+      // Hold the lock on the process list until the new process is in it,
+      // so the exit code handler cannot miss its exit.
+      MutexLocker locker(ProcessInfoList::mutex());
+      result = posix_spawnp(&pid, realpath, &actions, NULL, program_arguments_,
+                            environment);
+      if (result == 0) {
+        ProcessInfoList::AddProcessLocked(pid, event_fds[1]);
+        ExitCodeHandler::ProcessStarted();
+      }
+    }
+    posix_spawn_file_actions_destroy(&actions);
+
+    if (result == ENOEXEC) {
+      // Since glibc 2.27 posix_spawnp no longer runs files without a "#!" line
+      // through /bin/sh, but execvp in the forked child still does.
+      ClosePipe(event_fds);
+      return false;
+    }
+    if (result != 0) {
+      ClosePipe(event_fds);
+      errno = result;
+      *start_result = CleanupAndReturnError();
+      return true;
+    }
+
+    // Exec errors are returned by posix_spawn, so the exec control pipe is
+    // not needed.
+    ClosePipe(exec_control_);
+    *exit_event_ = event_fds[0];
+    FDUtils::SetNonBlocking(event_fds[0]);
+    ConnectStdio();
     *id_ = pid;
-    return 0;
+    *start_result = 0;
+    return true;
   }
+#endif  // defined(USE_POSIX_SPAWN)
 
- private:
   int CreatePipes() {
     int result;
     result = TEMP_FAILURE_RETRY(pipe2(exec_control_, O_CLOEXEC));
@@ -100,13 +100,14 @@ void FUNCTION_NAME(SecureSocket_Init)(Dart_NativeArguments args) {
 
 void FUNCTION_NAME(SecureSocket_Connect)(Dart_NativeArguments args) {
   Dart_Handle host_name_object = ThrowIfError(Dart_GetNativeArgument(args, 1));
-  Dart_Handle context_object = ThrowIfError(Dart_GetNativeArgument(args, 2));
-  bool is_server = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 3));
+  int64_t port = DartUtils::GetIntegerValue(Dart_GetNativeArgument(args, 2));
+  Dart_Handle context_object = ThrowIfError(Dart_GetNativeArgument(args, 3));
+  bool is_server = DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 4));
   bool request_client_certificate =
-      DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 4));
-  bool require_client_certificate =
       DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 5));
-  Dart_Handle protocols_handle = ThrowIfError(Dart_GetNativeArgument(args, 6));
+  bool require_client_certificate =
+      DartUtils::GetBooleanValue(Dart_GetNativeArgument(args, 6));
+  Dart_Handle protocols_handle = ThrowIfError(Dart_GetNativeArgument(args, 7));
 
   const char* host_name = NULL;
   // TODO(whesse): Is truncating a Dart string containing \0 what we want?
@@ -122,7 +123,7 @@ void FUNCTION_NAME(SecureSocket_Connect)(Dart_NativeArguments args) {
   // The protocols_handle is guaranteed to be a valid Uint8List.
   // It will have the correct length encoding of the protocols array.
   ASSERT(!Dart_IsNull(protocols_handle));
-  GetFilter(args)->Connect(host_name, context, is_server,
+  GetFilter(args)->Connect(host_name, port, context, is_server,
                            request_client_certificate,
                            require_client_certificate, protocols_handle);
 }
@@ -162,6 +163,14 @@ void FUNCTION_NAME(SecureSocket_Renegotiate)(Dart_NativeArguments args) {
                                require_client_certificate);
 }
 
+void FUNCTION_NAME(SecureSocket_ResumedHandshakes)(Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, ClientSessionCache::resumed_handshakes());
+}
+
+void FUNCTION_NAME(SecureSocket_FullHandshakes)(Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, ClientSessionCache::full_handshakes());
+}
+
 void FUNCTION_NAME(SecureSocket_RegisterHandshakeCompleteCallback)(
     Dart_NativeArguments args) {
   Dart_Handle handshake_complete =
@@ -447,11 +456,13 @@ void SSLFilter::InitializeLibrary() {
     SSL_library_init();
     filter_ssl_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
     ASSERT(filter_ssl_index >= 0);
+    ClientSessionCache::InitializeIndex();
     library_initialized_ = true;
   }
 }
 
 void SSLFilter::Connect(const char* hostname,
+                        intptr_t port,
                         SSLCertContext* context,
                         bool is_server,
                         bool request_client_certificate,
@@ -502,6 +513,8 @@ void SSLFilter::Connect(const char* hostname,
                                          hostname_, strlen(hostname_));
     SecureSocketUtils::CheckStatusSSL(
         status, "TlsException", "Set hostname for certificate checking", ssl_);
+    port_ = port;
+    ClientSessionCache::ResumeSession(ssl_, hostname_, port_);
   }
   // Make the connection:
   if (is_server_) {
@@ -568,6 +581,9 @@ void SSLFilter::Handshake() {
         printf("\n");
       }
     }
+    if (!is_server_) {
+      ClientSessionCache::CountHandshake(SSL_session_reused(ssl_) != 0);
+    }
     ThrowIfError(Dart_InvokeClosure(
         Dart_HandleFromPersistent(handshake_complete_), 0, NULL));
     in_handshake_ = false;
@@ -48,16 +48,20 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
         handshake_complete_(NULL),
         bad_certificate_callback_(NULL),
         in_handshake_(false),
-        hostname_(NULL) {}
+        bad_certificate_accepted_(false),
+        hostname_(NULL),
+        port_(0) {}
 
   ~SSLFilter();
 
   char* hostname() const { return hostname_; }
+  intptr_t port() const { return port_; }
   bool is_server() const { return is_server_; }
   bool is_client() const { return !is_server_; }
 
   Dart_Handle Init(Dart_Handle dart_this);
   void Connect(const char* hostname,
+               intptr_t port,
                SSLCertContext* context,
                bool is_server,
                bool request_client_certificate,
@@ -75,6 +79,10 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   Dart_Handle bad_certificate_callback() {
     return Dart_HandleFromPersistent(bad_certificate_callback_);
   }
+  // Whether the bad certificate callback accepted a certificate that failed
+  // verification.
+  bool bad_certificate_accepted() const { return bad_certificate_accepted_; }
+  void set_bad_certificate_accepted() { bad_certificate_accepted_ = true; }
   int ProcessReadPlaintextBuffer(int start, int end);
   int ProcessWritePlaintextBuffer(int start, int end);
   int ProcessReadEncryptedBuffer(int start, int end);
@@ -108,8 +116,10 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   Dart_PersistentHandle handshake_complete_;
   Dart_PersistentHandle bad_certificate_callback_;
   bool in_handshake_;
+  bool bad_certificate_accepted_;
   bool is_server_;
   char* hostname_;
+  intptr_t port_;
 
   static bool IsBufferEncrypted(int i) {
     return static_cast<BufferIndex>(i) >= kFirstEncrypted;
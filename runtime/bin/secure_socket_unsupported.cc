@@ -48,6 +48,14 @@ void FUNCTION_NAME(SecureSocket_RegisterHandshakeCompleteCallback)(
       "Secure Sockets unsupported on this platform"));
 }
 
+void FUNCTION_NAME(SecureSocket_ResumedHandshakes)(Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, 0);
+}
+
+void FUNCTION_NAME(SecureSocket_FullHandshakes)(Dart_NativeArguments args) {
+  Dart_SetIntegerReturnValue(args, 0);
+}
+
 void FUNCTION_NAME(SecureSocket_RegisterBadCertificateCallback)(
     Dart_NativeArguments args) {
   Dart_ThrowException(DartUtils::NewDartArgumentError(
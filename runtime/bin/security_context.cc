@@ -76,7 +76,11 @@ int SSLCertContext::CertificateCallback(int preverify_ok,
     filter->callback_error = result;
     return 0;
   }
-  return static_cast<int>(DartUtils::GetBooleanValue(result));
+  const bool accepted = DartUtils::GetBooleanValue(result);
+  if (accepted) {
+    filter->set_bad_certificate_accepted();
+  }
+  return static_cast<int>(accepted);
 }
 
 SSLCertContext* SSLCertContext::GetSecurityContext(Dart_NativeArguments args) {
@@ -612,6 +616,111 @@ int SSLCertContext::UseCertificateChainBytes(Dart_Handle cert_chain_bytes,
   return UseChainBytes(context(), &bio, password);
 }
 
+int ClientSessionCache::index_ = -1;
+RelaxedAtomic<intptr_t> ClientSessionCache::resumed_handshakes_ = 0;
+RelaxedAtomic<intptr_t> ClientSessionCache::full_handshakes_ = 0;
+
+ClientSessionCache::ClientSessionCache() : next_(0) {
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    hostnames_[i] = NULL;
+    ports_[i] = 0;
+    sessions_[i] = NULL;
+  }
+}
+
+ClientSessionCache::~ClientSessionCache() {
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    free(hostnames_[i]);
+    if (sessions_[i] != NULL) {
+      SSL_SESSION_free(sessions_[i]);
+    }
+  }
+}
+
+void ClientSessionCache::InitializeIndex() {
+  index_ = SSL_CTX_get_ex_new_index(0, NULL, NULL, NULL, Free);
+  ASSERT(index_ >= 0);
+}
+
+void ClientSessionCache::Attach(SSL_CTX* context) {
+  SSL_CTX_set_ex_data(context, index_, new ClientSessionCache());
+  SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_BOTH);
+  SSL_CTX_sess_set_new_cb(context, NewSessionCallback);
+}
+
+intptr_t ClientSessionCache::FindLocked(const char* hostname,
+                                        intptr_t port) const {
+  for (intptr_t i = 0; i < kMaxEntries; i++) {
+    if ((hostnames_[i] != NULL) && (ports_[i] == port) &&
+        (strcmp(hostnames_[i], hostname) == 0)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void ClientSessionCache::ResumeSession(SSL* ssl,
+                                       const char* hostname,
+                                       intptr_t port) {
+  ClientSessionCache* cache = static_cast<ClientSessionCache*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), index_));
+  if ((cache == NULL) || (hostname == NULL)) {
+    return;
+  }
+  MutexLocker ml(&cache->mutex_);
+  const intptr_t slot = cache->FindLocked(hostname, port);
+  if (slot != -1) {
+    // SSL_set_session takes its own reference to the session.
+    SSL_set_session(ssl, cache->sessions_[slot]);
+  }
+}
+
+int ClientSessionCache::NewSessionCallback(SSL* ssl, SSL_SESSION* session) {
+  if (SSL_is_server(ssl)) {
+    return 0;
+  }
+  SSLFilter* filter = static_cast<SSLFilter*>(
+      SSL_get_ex_data(ssl, SSLFilter::filter_ssl_index));
+  ClientSessionCache* cache = static_cast<ClientSessionCache*>(
+      SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), index_));
+  if ((cache == NULL) || (filter == NULL) || (filter->hostname() == NULL)) {
+    return 0;
+  }
+  // Do not let later connections skip the verification of a certificate that
+  // failed it, even if this connection's onBadCertificate accepted it.
+  if ((SSL_get_verify_result(ssl) != X509_V_OK) ||
+      filter->bad_certificate_accepted()) {
+    return 0;
+  }
+  const char* hostname = filter->hostname();
+  const intptr_t port = filter->port();
+  MutexLocker ml(&cache->mutex_);
+  intptr_t slot = cache->FindLocked(hostname, port);
+  if (slot == -1) {
+    // Evict the oldest entry.
+    slot = cache->next_;
+    cache->next_ = (cache->next_ + 1) % kMaxEntries;
+    free(cache->hostnames_[slot]);
+    cache->hostnames_[slot] = Utils::StrDup(hostname);
+    cache->ports_[slot] = port;
+  }
+  if (cache->sessions_[slot] != NULL) {
+    SSL_SESSION_free(cache->sessions_[slot]);
+  }
+  cache->sessions_[slot] = session;
+  // Returning 1 takes ownership of the reference to [session].
+  return 1;
+}
+
+void ClientSessionCache::Free(void* parent,
+                              void* ptr,
+                              CRYPTO_EX_DATA* ad,
+                              int index,
+                              long argl,  // NOLINT
+                              void* argp) {
+  delete static_cast<ClientSessionCache*>(ptr);
+}
+
 static X509* GetX509Certificate(Dart_NativeArguments args) {
   X509* certificate = NULL;
   Dart_Handle dart_this = ThrowIfError(Dart_GetNativeArgument(args, 0));
@@ -803,6 +912,7 @@ void FUNCTION_NAME(SecurityContext_Allocate)(Dart_NativeArguments args) {
   SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, SSLCertContext::CertificateCallback);
   SSL_CTX_set_min_proto_version(ctx, TLS1_VERSION);
   SSL_CTX_set_cipher_list(ctx, "HIGH:MEDIUM");
+  ClientSessionCache::Attach(ctx);
   SSLCertContext* context = new SSLCertContext(ctx);
   Dart_Handle err = SetSecurityContext(args, context);
   if (Dart_IsError(err)) {
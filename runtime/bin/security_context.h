@@ -11,6 +11,7 @@
 #include "bin/lockers.h"
 #include "bin/reference_counting.h"
 #include "bin/socket.h"
+#include "platform/atomic.h"
 
 namespace dart {
 namespace bin {
@@ -100,6 +101,67 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
   DISALLOW_COPY_AND_ASSIGN(SSLCertContext);
 };
 
+// Remembers the latest TLS session negotiated with each server, keyed by
+// host and port, so that later client connections made with the same SSL_CTX
+// can resume it instead of doing a full handshake. The cache is stored as
+// ex_data on the SSL_CTX and freed with it, since SSL objects keep the
+// SSL_CTX alive after the owning SSLCertContext is gone.
+//
+// Only sessions whose server certificate passed verification on its own are
+// cached. A resumed session skips verification and the onBadCertificate
+// callback, so a certificate accepted by one connection's callback must not
+// be trusted by later connections.
+class ClientSessionCache {
+ public:
+  static void InitializeIndex();
+
+  // Enables client session caching on [context].
+  static void Attach(SSL_CTX* context);
+
+  // Offers the cached session for [hostname] and [port], if any, to [ssl].
+  static void ResumeSession(SSL* ssl, const char* hostname, intptr_t port);
+
+  // Counts a completed client handshake for the resumed versus full
+  // handshake counters.
+  static void CountHandshake(bool resumed) {
+    if (resumed) {
+      resumed_handshakes_.fetch_add(1);
+    } else {
+      full_handshakes_.fetch_add(1);
+    }
+  }
+  static intptr_t resumed_handshakes() { return resumed_handshakes_.load(); }
+  static intptr_t full_handshakes() { return full_handshakes_.load(); }
+
+ private:
+  static const intptr_t kMaxEntries = 32;
+
+  ClientSessionCache();
+  ~ClientSessionCache();
+
+  static int NewSessionCallback(SSL* ssl, SSL_SESSION* session);
+  static void Free(void* parent,
+                   void* ptr,
+                   CRYPTO_EX_DATA* ad,
+                   int index,
+                   long argl,  // NOLINT
+                   void* argp);
+
+  intptr_t FindLocked(const char* hostname, intptr_t port) const;
+
+  static int index_;
+  static RelaxedAtomic<intptr_t> resumed_handshakes_;
+  static RelaxedAtomic<intptr_t> full_handshakes_;
+
+  Mutex mutex_;
+  char* hostnames_[kMaxEntries];
+  intptr_t ports_[kMaxEntries];
+  SSL_SESSION* sessions_[kMaxEntries];
+  intptr_t next_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClientSessionCache);
+};
+
 class X509Helper : public AllStatic {
  public:
   static Dart_Handle GetDer(Dart_NativeArguments args);
@@ -43,6 +43,94 @@ void ListeningSocketRegistry::Cleanup() {
   globalTcpListeningSocketRegistry = nullptr;
 }
 
+static HostLookupCache* global_host_lookup_cache = nullptr;
+
+void HostLookupCache::Initialize() {
+  ASSERT(global_host_lookup_cache == nullptr);
+  global_host_lookup_cache = new HostLookupCache();
+}
+
+HostLookupCache* HostLookupCache::Instance() {
+  return global_host_lookup_cache;
+}
+
+void HostLookupCache::Cleanup() {
+  delete global_host_lookup_cache;
+  global_host_lookup_cache = nullptr;
+}
+
+HostLookupCache::~HostLookupCache() {
+  for (intptr_t i = 0; i < kCapacity; i++) {
+    Clear(&entries_[i]);
+  }
+}
+
+void HostLookupCache::Clear(Entry* entry) {
+  free(entry->host);
+  delete[] entry->addresses;
+  entry->host = nullptr;
+  entry->addresses = nullptr;
+  entry->count = 0;
+}
+
+AddressList<SocketAddress>* HostLookupCache::Lookup(const char* host,
+                                                    int type) {
+  MutexLocker ml(&mutex_);
+  const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  for (intptr_t i = 0; i < kCapacity; i++) {
+    Entry* entry = &entries_[i];
+    if ((entry->host == nullptr) || (entry->type != type) ||
+        (strcmp(entry->host, host) != 0)) {
+      continue;
+    }
+    if (entry->expiry <= now) {
+      Clear(entry);
+      return nullptr;
+    }
+    AddressList<SocketAddress>* addresses =
+        new AddressList<SocketAddress>(entry->count);
+    for (intptr_t j = 0; j < entry->count; j++) {
+      addresses->SetAt(j, new SocketAddress(&entry->addresses[j].addr));
+    }
+    return addresses;
+  }
+  return nullptr;
+}
+
+void HostLookupCache::Insert(const char* host,
+                             int type,
+                             const AddressList<SocketAddress>& addresses) {
+  MutexLocker ml(&mutex_);
+  const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+  // Reuse the entry for the same key, or else an empty or expired one, or
+  // else evict entries round-robin.
+  Entry* slot = nullptr;
+  for (intptr_t i = 0; i < kCapacity; i++) {
+    Entry* entry = &entries_[i];
+    if (entry->host == nullptr || entry->expiry <= now) {
+      if (slot == nullptr) {
+        slot = entry;
+      }
+    } else if ((entry->type == type) && (strcmp(entry->host, host) == 0)) {
+      slot = entry;
+      break;
+    }
+  }
+  if (slot == nullptr) {
+    slot = &entries_[next_victim_];
+    next_victim_ = (next_victim_ + 1) % kCapacity;
+  }
+  Clear(slot);
+  slot->host = Utils::StrDup(host);
+  slot->type = type;
+  slot->expiry = now + kTimeToLiveMillis;
+  slot->count = addresses.count();
+  slot->addresses = new RawAddr[slot->count];
+  for (intptr_t i = 0; i < slot->count; i++) {
+    slot->addresses[i] = addresses.GetAt(i)->addr();
+  }
+}
+
 ListeningSocketRegistry::OSSocket* ListeningSocketRegistry::LookupByPort(
     intptr_t port) {
   SimpleHashMap::Entry* entry = sockets_by_port_.Lookup(
@@ -525,6 +613,28 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
     if (Socket::short_socket_read()) {
       length = (length + 1) / 2;
     }
+    // Small reads go through a stack buffer into an ordinary Uint8List of
+    // the exact size. Unlike external typed data, that needs no finalizer
+    // and can be freed by the scavenger right away.
+    const intptr_t kSmallReadLength = 16 * KB;
+    if ((length > 0) && (length <= kSmallReadLength)) {
+      uint8_t small_buffer[kSmallReadLength];
+      intptr_t bytes_read = SocketBase::Read(socket->fd(), small_buffer,
+                                             length, SocketBase::kAsync);
+      if (bytes_read > 0) {
+        Dart_Handle result =
+            Dart_NewTypedData(Dart_TypedData_kUint8, bytes_read);
+        ThrowIfError(result);
+        ThrowIfError(Dart_ListSetAsBytes(result, 0, small_buffer, bytes_read));
+        Dart_SetReturnValue(args, result);
+      } else if (bytes_read == 0) {
+        Dart_SetReturnValue(args, Dart_Null());
+      } else {
+        ASSERT(bytes_read == -1);
+        Dart_ThrowException(DartUtils::NewDartOSError());
+      }
+      return;
+    }
     uint8_t* buffer = nullptr;
     Dart_Handle result = IOBuffer::Allocate(length, &buffer);
     if (Dart_IsNull(result)) {
@@ -897,8 +1007,17 @@ CObject* Socket::LookupRequest(const CObjectArray& request) {
     CObjectInt32 type(request[1]);
     CObject* result = nullptr;
     OSError* os_error = nullptr;
+    HostLookupCache* cache = HostLookupCache::Instance();
     AddressList<SocketAddress>* addresses =
-        SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+        (cache != nullptr) ? cache->Lookup(host.CString(), type.Value())
+                           : nullptr;
+    if (addresses == nullptr) {
+      addresses =
+          SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+      if ((addresses != nullptr) && (cache != nullptr)) {
+        cache->Insert(host.CString(), type.Value(), *addresses);
+      }
+    }
     if (addresses != nullptr) {
       CObjectArray* array =
           new CObjectArray(CObject::NewArray(addresses->count() + 1));
@@ -319,6 +319,51 @@ class ListeningSocketRegistry {
   DISALLOW_COPY_AND_ASSIGN(ListeningSocketRegistry);
 };
 
+// A process-wide cache of recent host name lookups, shared by all isolates so
+// that bursts of connections to the same host do not each block an IO thread
+// on the resolver. getaddrinfo does not report record TTLs, so entries expire
+// after a short fixed time. Failed lookups are not cached.
+class HostLookupCache {
+ public:
+  HostLookupCache() : entries_(), next_victim_(0), mutex_() {}
+
+  ~HostLookupCache();
+
+  static void Initialize();
+
+  static HostLookupCache* Instance();
+
+  static void Cleanup();
+
+  // Returns a new copy of the cached addresses for `host` and `type`, or
+  // nullptr if there is no live entry.
+  AddressList<SocketAddress>* Lookup(const char* host, int type);
+
+  void Insert(const char* host,
+              int type,
+              const AddressList<SocketAddress>& addresses);
+
+ private:
+  static const intptr_t kCapacity = 64;
+  static const int64_t kTimeToLiveMillis = 5000;
+
+  struct Entry {
+    char* host;
+    int type;
+    int64_t expiry;
+    intptr_t count;
+    RawAddr* addresses;
+  };
+
+  static void Clear(Entry* entry);
+
+  Entry entries_[kCapacity];
+  intptr_t next_victim_;
+  Mutex mutex_;
+
+  DISALLOW_COPY_AND_ASSIGN(HostLookupCache);
+};
+
 }  // namespace bin
 }  // namespace dart
 
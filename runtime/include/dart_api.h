@@ -2293,6 +2293,28 @@ DART_EXPORT Dart_Handle Dart_ListSetAt(Dart_Handle list,
                                        intptr_t index,
                                        Dart_Handle value);
 
+/**
+ * Sets a range of Objects in a List.
+ *
+ * This is equivalent to calling Dart_ListSetAt for each element, but only
+ * enters the VM once for the whole range.
+ *
+ * If any of the requested index values are out of bounds, an error occurs.
+ *
+ * May generate an unhandled exception error.
+ *
+ * \param list A List.
+ * \param offset The offset of the first item to set.
+ * \param length The number of items to set.
+ * \param values The Objects to put in the List.
+ *
+ * \return Success if no error occurs during the operation.
+ */
+DART_EXPORT Dart_Handle Dart_ListSetRange(Dart_Handle list,
+                                          intptr_t offset,
+                                          intptr_t length,
+                                          const Dart_Handle* values);
+
 /**
  * May generate an unhandled exception error.
  */
@@ -2996,6 +3018,30 @@ typedef Dart_NativeFunction (*Dart_NativeEntryResolver)(Dart_Handle name,
  */
 typedef const uint8_t* (*Dart_NativeEntrySymbol)(Dart_NativeFunction nf);
 
+/**
+ * FFI native resolution callback.
+ *
+ * Unlike native functions resolved with Dart_NativeEntryResolver, functions
+ * declared with the @FfiNative annotation of dart:ffi are called like
+ * functions bound with DynamicLibrary.lookupFunction: integers and doubles
+ * are passed unboxed as C arguments and results, and leaf calls receive
+ * TypedData arguments as pointers to their elements. No Dart_NativeArguments,
+ * handles or API scope are involved, so the native function may not call
+ * back into the VM through the Dart API unless it takes or returns Handle.
+ *
+ * The callback is called on the first call of such a function and its result
+ * is cached.
+ *
+ * \param name the name of the native function, as given to @FfiNative.
+ * \param num_of_arguments the number of arguments of the native function.
+ *
+ * \return The address of the native function, or NULL if it is not found.
+ *
+ * See Dart_SetFfiNativeResolver.
+ */
+typedef void* (*Dart_FfiNativeResolver)(const char* name,
+                                        uintptr_t num_of_arguments);
+
 /*
  * ===========
  * Environment
@@ -3058,6 +3104,17 @@ Dart_GetNativeResolver(Dart_Handle library, Dart_NativeEntryResolver* resolver);
 DART_EXPORT Dart_Handle Dart_GetNativeSymbol(Dart_Handle library,
                                              Dart_NativeEntrySymbol* resolver);
 
+/**
+ * Sets the callback used to resolve the @FfiNative functions of a library.
+ *
+ * \param library A library.
+ * \param resolver An FFI native resolver.
+ *
+ * \return A valid handle if the resolver was set successfully.
+ */
+DART_EXPORT Dart_Handle
+Dart_SetFfiNativeResolver(Dart_Handle library, Dart_FfiNativeResolver resolver);
+
 /*
  * =====================
  * Scripts and Libraries
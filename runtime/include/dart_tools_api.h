@@ -268,6 +268,66 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
                                                   const uint8_t* bytes,
                                                   intptr_t bytes_length);
 
+/**
+ * Writes a heap snapshot of the current isolate, in the format of the
+ * HeapSnapshot service stream, to a callback.
+ *
+ * The snapshot is handed to |write_callback| in chunks as it is produced, so
+ * only one chunk is held in native memory. The callback may, for example,
+ * compress the data or write it to a file descriptor. It is invoked while the
+ * heap is being iterated and must not call back into the VM.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \param write_callback Receives every chunk of the snapshot in order.
+ * \param callback_data Passed to |write_callback|.
+ * \param error An optional error, must be free()ed by caller.
+ *
+ * \return Returns true if the snapshot was written and false otherwise.
+ */
+DART_EXPORT bool Dart_WriteHeapSnapshot(
+    Dart_StreamingWriteCallback write_callback,
+    void* callback_data,
+    char** error);
+
+/**
+ * A callback invoked once for each class reported by
+ * Dart_GetTopRetainersByClass.
+ *
+ * \param data The data passed to Dart_GetTopRetainersByClass.
+ * \param library_uri The URI of the class's library, or "" for VM-internal
+ *   classes. Only valid for the duration of the callback.
+ * \param class_name The name of the class. Only valid for the duration of the
+ *   callback.
+ * \param instance_count The number of reachable instances of the class.
+ * \param retained_size The number of bytes that would be freed if all of
+ *   those instances became unreachable.
+ */
+typedef void (*Dart_ClassRetainedSizeCallback)(void* data,
+                                               const char* library_uri,
+                                               const char* class_name,
+                                               intptr_t instance_count,
+                                               intptr_t retained_size);
+
+/**
+ * Computes the dominator tree of the current isolate's heap and reports the
+ * classes whose instances retain the most memory, largest first.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \param limit The maximum number of classes to report.
+ * \param callback Invoked once per reported class.
+ * \param data Passed to |callback|.
+ * \param error An optional error, must be free()ed by caller.
+ *
+ * \return Returns true if the analysis succeeded and false otherwise.
+ */
+DART_EXPORT bool Dart_GetTopRetainersByClass(
+    intptr_t limit,
+    Dart_ClassRetainedSizeCallback callback,
+    void* data,
+    char** error);
+
 /**
  * Usage statistics for a space/generation at a particular moment in time.
  *
@@ -495,5 +555,42 @@ DART_EXPORT int64_t
 Dart_IsolateRunnableLatencyMetric(Dart_Isolate isolate);  // Microsecond
 DART_EXPORT int64_t
 Dart_IsolateRunnableHeapSizeMetric(Dart_Isolate isolate);  // Byte
+DART_EXPORT int64_t
+Dart_IsolateCpuDartMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateCpuVMMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateCpuGCMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateCpuNativeMetric(Dart_Isolate isolate);  // Microsecond
+DART_EXPORT int64_t
+Dart_IsolateAllocatedMetric(Dart_Isolate isolate);  // Byte
+
+/**
+ * The CPU time and allocation of an isolate's mutator since it was created.
+ *
+ * CPU time is only accounted with --isolate-cpu-accounting, and is otherwise
+ * 0. It is split by the execution state of the mutator: running Dart code,
+ * running the VM runtime, collecting garbage, or running native code, which
+ * includes the embedder's native extensions. Time spent blocked is not
+ * counted.
+ */
+typedef struct {
+  int64_t dart_cpu_micros;
+  int64_t vm_cpu_micros;
+  int64_t gc_cpu_micros;
+  int64_t native_cpu_micros;
+  int64_t allocated_bytes;
+} Dart_IsolateUsage;
+
+/**
+ * Reads the usage counters of |isolate|. Available in all builds.
+ *
+ * This does not require a current isolate and may be called from any thread
+ * while |isolate| is alive. The counters are read without synchronizing with
+ * the isolate's mutator, so they may be slightly stale.
+ */
+DART_EXPORT void Dart_GetIsolateUsage(Dart_Isolate isolate,
+                                      Dart_IsolateUsage* usage);
 
 #endif  // RUNTIME_INCLUDE_DART_TOOLS_API_H_
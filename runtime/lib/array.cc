@@ -69,6 +69,40 @@ DEFINE_NATIVE_ENTRY(List_slice, 0, 4) {
   return src.Slice(istart, icount, needs_type_arg.value());
 }
 
+static ArrayPtr ListData(const Instance& list, intptr_t* length) {
+  if (list.IsGrowableObjectArray()) {
+    const GrowableObjectArray& growable = GrowableObjectArray::Cast(list);
+    *length = growable.Length();
+    return growable.data();
+  }
+  *length = Array::Cast(list).Length();
+  return Array::Cast(list).raw();
+}
+
+// Copies a range between arrays or growable lists, which may be the same.
+DEFINE_NATIVE_ENTRY(List_copyRange, 0, 5) {
+  const Instance& dst = Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, dst_start, arguments->NativeArgAt(1));
+  const Instance& src = Instance::CheckedHandle(zone, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, src_start, arguments->NativeArgAt(3));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, count, arguments->NativeArgAt(4));
+  intptr_t dst_length;
+  intptr_t src_length;
+  const Array& dst_array = Array::Handle(zone, ListData(dst, &dst_length));
+  const Array& src_array = Array::Handle(zone, ListData(src, &src_length));
+  if (!Utils::RangeCheck(dst_start.Value(), count.Value(), dst_length)) {
+    Exceptions::ThrowRangeError("start", dst_start, 0,
+                                dst_length - count.Value());
+  }
+  if (!Utils::RangeCheck(src_start.Value(), count.Value(), src_length)) {
+    Exceptions::ThrowRangeError("skipCount", src_start, 0,
+                                src_length - count.Value());
+  }
+  dst_array.CopyRange(dst_start.Value(), src_array, src_start.Value(),
+                      count.Value());
+  return Object::null();
+}
+
 // Private factory, expects correct arguments.
 DEFINE_NATIVE_ENTRY(ImmutableList_from, 0, 4) {
   // Ignore first argument of a thsi factory (type argument).
@@ -0,0 +1,707 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/bootstrap_natives.h"
+
+#include "platform/unicode.h"
+#include "vm/dart_entry.h"
+#include "vm/double_conversion.h"
+#include "vm/exceptions.h"
+#include "vm/growable_array.h"
+#include "vm/native_entry.h"
+#include "vm/object.h"
+#include "vm/object_store.h"
+#include "vm/symbols.h"
+
+namespace dart {
+
+// Nesting deeper than this is left to the Dart implementation, which doesn't
+// recurse. The encoder also relies on it to give up on cyclic structures, the
+// Dart implementation then reports them.
+static const intptr_t kMaxJsonDepth = 512;
+
+// Parses JSON text into the same objects as _BuildJsonListener: Map<String,
+// dynamic> maps, growable lists, strings, ints, doubles, bools and null. The
+// input is either UTF-8 or the code units of a one-byte string.
+//
+// Anything the parser doesn't accept, including all invalid input, makes
+// Parse return false and is left to the Dart implementation, which reports
+// errors with their position.
+class JsonParser : public ValueObject {
+ public:
+  JsonParser(Thread* thread,
+             const uint8_t* input,
+             intptr_t length,
+             bool is_utf8)
+      : thread_(thread),
+        zone_(thread->zone()),
+        input_(input),
+        length_(length),
+        is_utf8_(is_utf8),
+        position_(0),
+        map_type_arguments_(TypeArguments::Handle(zone_)),
+        maps_(GrowableObjectArray::Handle(zone_, GrowableObjectArray::New())),
+        buffer_(zone_, 0) {
+    map_type_arguments_ = TypeArguments::New(2);
+    map_type_arguments_.SetTypeAt(0, Type::Handle(zone_, Type::StringType()));
+    map_type_arguments_.SetTypeAt(1, Object::dynamic_type());
+    map_type_arguments_ = map_type_arguments_.Canonicalize();
+  }
+
+  // Returns a copy of the text of |input| which stays valid while parsing
+  // allocates, or NULL if |input| is not a one-byte string or byte list.
+  static uint8_t* CopyInput(Zone* zone,
+                            const Instance& input,
+                            intptr_t* length,
+                            bool* is_utf8) {
+    if (input.IsString() && String::Cast(input).IsOneByteString()) {
+      *length = String::Cast(input).Length();
+      *is_utf8 = false;
+      uint8_t* copy = zone->Alloc<uint8_t>(*length);
+      NoSafepointScope no_safepoint;
+      memmove(copy, OneByteString::DataStart(String::Cast(input)), *length);
+      return copy;
+    }
+    if (IsTypedDataBaseClassId(input.GetClassId()) &&
+        (TypedDataBase::Cast(input).ElementSizeInBytes() == 1)) {
+      const TypedDataBase& bytes = TypedDataBase::Cast(input);
+      *length = bytes.LengthInBytes();
+      *is_utf8 = true;
+      uint8_t* copy = zone->Alloc<uint8_t>(*length);
+      NoSafepointScope no_safepoint;
+      if (*length > 0) {
+        memmove(copy, bytes.DataAddr(0), *length);
+      }
+      return copy;
+    }
+    return NULL;
+  }
+
+  bool Parse(Object* result) {
+    if (!ParseValue(0, result)) {
+      return false;
+    }
+    SkipWhitespace();
+    if (position_ != length_) {
+      return false;
+    }
+    return RehashMaps();
+  }
+
+ private:
+  bool AtEnd() const { return position_ >= length_; }
+  uint8_t Peek() const { return input_[position_]; }
+
+  void SkipWhitespace() {
+    while (!AtEnd()) {
+      const uint8_t c = Peek();
+      if ((c != ' ') && (c != '\t') && (c != '\n') && (c != '\r')) {
+        return;
+      }
+      position_++;
+    }
+  }
+
+  bool Expect(const char* literal) {
+    for (intptr_t i = 0; literal[i] != '\0'; i++) {
+      if (AtEnd() || (Peek() != static_cast<uint8_t>(literal[i]))) {
+        return false;
+      }
+      position_++;
+    }
+    return true;
+  }
+
+  bool ParseValue(intptr_t depth, Object* result) {
+    SkipWhitespace();
+    if (AtEnd()) {
+      return false;
+    }
+    switch (Peek()) {
+      case '{':
+        return ParseObject(depth + 1, result);
+      case '[':
+        return ParseArray(depth + 1, result);
+      case '"':
+        return ParseString(result);
+      case 't':
+        *result = Bool::True().raw();
+        return Expect("true");
+      case 'f':
+        *result = Bool::False().raw();
+        return Expect("false");
+      case 'n':
+        *result = Object::null();
+        return Expect("null");
+      default:
+        return ParseNumber(result);
+    }
+  }
+
+  bool ParseObject(intptr_t depth, Object* result) {
+    if (depth > kMaxJsonDepth) {
+      return false;
+    }
+    HANDLESCOPE(thread_);
+    Array& data =
+        Array::Handle(zone_, Array::New(LinkedHashMap::kInitialIndexSize));
+    Object& key = Object::Handle(zone_);
+    Object& value = Object::Handle(zone_);
+    intptr_t used_data = 0;
+    position_++;  // Skip '{'.
+    SkipWhitespace();
+    if (!AtEnd() && (Peek() == '}')) {
+      position_++;
+    } else {
+      while (true) {
+        SkipWhitespace();
+        if (AtEnd() || (Peek() != '"') || !ParseString(&key)) {
+          return false;
+        }
+        SkipWhitespace();
+        if (!Expect(":") || !ParseValue(depth, &value)) {
+          return false;
+        }
+        if (used_data == data.Length()) {
+          data = Array::Grow(data, 2 * data.Length());
+        }
+        data.SetAt(used_data++, key);
+        data.SetAt(used_data++, value);
+        SkipWhitespace();
+        if (AtEnd()) {
+          return false;
+        }
+        const uint8_t c = Peek();
+        position_++;
+        if (c == '}') {
+          break;
+        }
+        if (c != ',') {
+          return false;
+        }
+      }
+    }
+    // Like maps read from a message snapshot, the index is regenerated by the
+    // maps themselves once the whole input is parsed.
+    const LinkedHashMap& map =
+        LinkedHashMap::Handle(zone_, LinkedHashMap::NewUninitialized());
+    map.SetTypeArguments(map_type_arguments_);
+    map.SetData(data);
+    map.SetUsedData(used_data);
+    map.SetDeletedKeys(0);
+    map.SetHashMask(0);
+    maps_.Add(map);
+    *result = map.raw();
+    return true;
+  }
+
+  bool ParseArray(intptr_t depth, Object* result) {
+    if (depth > kMaxJsonDepth) {
+      return false;
+    }
+    HANDLESCOPE(thread_);
+    const GrowableObjectArray& list =
+        GrowableObjectArray::Handle(zone_, GrowableObjectArray::New());
+    Object& value = Object::Handle(zone_);
+    position_++;  // Skip '['.
+    SkipWhitespace();
+    if (!AtEnd() && (Peek() == ']')) {
+      position_++;
+    } else {
+      while (true) {
+        if (!ParseValue(depth, &value)) {
+          return false;
+        }
+        list.Add(value);
+        SkipWhitespace();
+        if (AtEnd()) {
+          return false;
+        }
+        const uint8_t c = Peek();
+        position_++;
+        if (c == ']') {
+          break;
+        }
+        if (c != ',') {
+          return false;
+        }
+      }
+    }
+    *result = list.raw();
+    return true;
+  }
+
+  static intptr_t HexDigitValue(uint8_t c) {
+    if ((c >= '0') && (c <= '9')) return c - '0';
+    if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+    if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+    return -1;
+  }
+
+  bool ParseString(Object* result) {
+    position_++;  // Skip '"'.
+    const intptr_t start = position_;
+    // Plain ASCII strings, the common case, are copied directly.
+    while (!AtEnd()) {
+      const uint8_t c = Peek();
+      if (c == '"') {
+        *result = String::FromLatin1(&input_[start], position_ - start);
+        position_++;
+        return true;
+      }
+      if ((c == '\\') || (c < 0x20) || (c > Utf8::kMaxOneByteChar)) {
+        break;
+      }
+      position_++;
+    }
+    if (AtEnd()) {
+      return false;
+    }
+    // Otherwise the code units are collected.
+    buffer_.Clear();
+    for (intptr_t i = start; i < position_; i++) {
+      buffer_.Add(input_[i]);
+    }
+    while (!AtEnd()) {
+      const uint8_t c = Peek();
+      if (c == '"') {
+        position_++;
+        *result = String::FromUTF16(buffer_.data(), buffer_.length());
+        return true;
+      }
+      if (c < 0x20) {
+        return false;
+      }
+      if (c == '\\') {
+        if (!ParseEscape()) {
+          return false;
+        }
+      } else if ((c <= Utf8::kMaxOneByteChar) || !is_utf8_) {
+        buffer_.Add(c);
+        position_++;
+      } else {
+        int32_t ch;
+        const intptr_t consumed =
+            Utf8::Decode(&input_[position_], length_ - position_, &ch);
+        // Encoded surrogates are left to the Dart decoder.
+        if ((ch == -1) || Utf16::IsSurrogate(ch)) {
+          return false;
+        }
+        if (Utf::IsSupplementary(ch)) {
+          uint16_t pair[2];
+          Utf16::Encode(ch, pair);
+          buffer_.Add(pair[0]);
+          buffer_.Add(pair[1]);
+        } else {
+          buffer_.Add(ch);
+        }
+        position_ += consumed;
+      }
+    }
+    return false;
+  }
+
+  bool ParseEscape() {
+    position_++;  // Skip '\'.
+    if (AtEnd()) {
+      return false;
+    }
+    const uint8_t c = Peek();
+    position_++;
+    switch (c) {
+      case '"':
+      case '\\':
+      case '/':
+        buffer_.Add(c);
+        return true;
+      case 'b':
+        buffer_.Add('\b');
+        return true;
+      case 'f':
+        buffer_.Add('\f');
+        return true;
+      case 'n':
+        buffer_.Add('\n');
+        return true;
+      case 'r':
+        buffer_.Add('\r');
+        return true;
+      case 't':
+        buffer_.Add('\t');
+        return true;
+      case 'u': {
+        if ((position_ + 4) > length_) {
+          return false;
+        }
+        intptr_t code_unit = 0;
+        for (intptr_t i = 0; i < 4; i++) {
+          const intptr_t digit = HexDigitValue(input_[position_++]);
+          if (digit < 0) {
+            return false;
+          }
+          code_unit = (code_unit << 4) | digit;
+        }
+        // Like in the Dart implementation, surrogates are kept as they are.
+        buffer_.Add(code_unit);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  static bool IsDigit(uint8_t c) { return (c >= '0') && (c <= '9'); }
+
+  bool ParseNumber(Object* result) {
+    const intptr_t start = position_;
+    bool is_negative = false;
+    if (Peek() == '-') {
+      is_negative = true;
+      position_++;
+    }
+    const intptr_t digits_start = position_;
+    if (AtEnd() || !IsDigit(Peek())) {
+      return false;
+    }
+    if (Peek() == '0') {
+      position_++;
+    } else {
+      while (!AtEnd() && IsDigit(Peek())) {
+        position_++;
+      }
+    }
+    const intptr_t digit_count = position_ - digits_start;
+    bool is_double = false;
+    if (!AtEnd() && (Peek() == '.')) {
+      is_double = true;
+      position_++;
+      if (AtEnd() || !IsDigit(Peek())) {
+        return false;
+      }
+      while (!AtEnd() && IsDigit(Peek())) {
+        position_++;
+      }
+    }
+    if (!AtEnd() && ((Peek() == 'e') || (Peek() == 'E'))) {
+      is_double = true;
+      position_++;
+      if (!AtEnd() && ((Peek() == '+') || (Peek() == '-'))) {
+        position_++;
+      }
+      if (AtEnd() || !IsDigit(Peek())) {
+        return false;
+      }
+      while (!AtEnd() && IsDigit(Peek())) {
+        position_++;
+      }
+    }
+    if (!is_double) {
+      // Integers which may not fit in 64 bits are left to the Dart
+      // implementation, which turns them into doubles.
+      if (digit_count > 18) {
+        return false;
+      }
+      uint64_t value = 0;
+      ParseDecimalDigits(reinterpret_cast<const char*>(&input_[digits_start]),
+                         digit_count, digit_count, &value);
+      *result = Integer::New(is_negative ? -static_cast<int64_t>(value)
+                                         : static_cast<int64_t>(value));
+      return true;
+    }
+    double value;
+    if (!CStringToDouble(reinterpret_cast<const char*>(&input_[start]),
+                         position_ - start, &value)) {
+      return false;
+    }
+    *result = Double::New(value);
+    return true;
+  }
+
+  bool RehashMaps() {
+    if (maps_.Length() == 0) {
+      return true;
+    }
+    const Library& collections_lib =
+        Library::Handle(zone_, Library::CollectionLibrary());
+    const Function& rehashing_function = Function::Handle(
+        zone_,
+        collections_lib.LookupFunctionAllowPrivate(Symbols::_rehashObjects()));
+    ASSERT(!rehashing_function.IsNull());
+    const Array& arguments = Array::Handle(zone_, Array::New(1));
+    arguments.SetAt(0, maps_);
+    const Object& result = Object::Handle(
+        zone_, DartEntry::InvokeFunction(rehashing_function, arguments));
+    if (result.IsError()) {
+      Exceptions::PropagateError(Error::Cast(result));
+    }
+    return true;
+  }
+
+  Thread* thread_;
+  Zone* zone_;
+  const uint8_t* input_;
+  const intptr_t length_;
+  const bool is_utf8_;
+  intptr_t position_;
+  TypeArguments& map_type_arguments_;
+  const GrowableObjectArray& maps_;
+  GrowableArray<uint16_t> buffer_;  // Code units of the current string.
+
+  DISALLOW_COPY_AND_ASSIGN(JsonParser);
+};
+
+// Writes the UTF-8 encoding of the JSON text of values with the same output
+// as _JsonUtf8Stringifier without indentation.
+//
+// Only null, bools, numbers, strings, the VM implementations of lists,
+// Float32List, Float64List and default maps with string keys are encoded.
+// Encode returns false for anything else, including values which would call
+// toEncodable or toJson, non-finite doubles and cyclic structures, which are
+// left to the Dart implementation.
+class JsonEncoder : public ValueObject {
+ public:
+  explicit JsonEncoder(Thread* thread)
+      : thread_(thread), zone_(thread->zone()), output_(zone_, 1 * KB) {}
+
+  bool Encode(const Object& value) { return EncodeValue(0, value); }
+
+  const uint8_t* data() const { return output_.data(); }
+  intptr_t length() const { return output_.length(); }
+
+ private:
+  void Write(const char* text) {
+    for (intptr_t i = 0; text[i] != '\0'; i++) {
+      output_.Add(text[i]);
+    }
+  }
+
+  bool EncodeValue(intptr_t depth, const Object& value) {
+    if (value.IsNull()) {
+      Write("null");
+      return true;
+    }
+    if (value.IsBool()) {
+      Write(Bool::Cast(value).value() ? "true" : "false");
+      return true;
+    }
+    if (value.IsInteger()) {
+      char buffer[32];
+      Utils::SNPrint(buffer, sizeof(buffer), "%" Pd64,
+                     Integer::Cast(value).AsInt64Value());
+      Write(buffer);
+      return true;
+    }
+    if (value.IsDouble()) {
+      return EncodeDouble(Double::Cast(value).value());
+    }
+    if (value.IsString()) {
+      EncodeString(String::Cast(value));
+      return true;
+    }
+    if (depth >= kMaxJsonDepth) {
+      return false;
+    }
+    HANDLESCOPE(thread_);
+    if (value.IsArray() || value.IsGrowableObjectArray()) {
+      const Array& elements = Array::Handle(
+          zone_, value.IsArray() ? Array::Cast(value).raw()
+                                 : GrowableObjectArray::Cast(value).data());
+      const intptr_t length = value.IsArray()
+                                  ? elements.Length()
+                                  : GrowableObjectArray::Cast(value).Length();
+      Object& element = Object::Handle(zone_);
+      output_.Add('[');
+      for (intptr_t i = 0; i < length; i++) {
+        if (i > 0) {
+          output_.Add(',');
+        }
+        element = elements.At(i);
+        if (!EncodeValue(depth + 1, element)) {
+          return false;
+        }
+      }
+      output_.Add(']');
+      return true;
+    }
+    if ((value.GetClassId() == kTypedDataFloat64ArrayCid) ||
+        (value.GetClassId() == kTypedDataFloat32ArrayCid)) {
+      // Encoded without a handle per element.
+      const TypedData& elements = TypedData::Cast(value);
+      const bool is_float64 = value.GetClassId() == kTypedDataFloat64ArrayCid;
+      const intptr_t element_size = elements.ElementSizeInBytes();
+      const intptr_t length = elements.Length();
+      output_.Add('[');
+      for (intptr_t i = 0; i < length; i++) {
+        if (i > 0) {
+          output_.Add(',');
+        }
+        const intptr_t offset = i * element_size;
+        if (!EncodeDouble(is_float64 ? elements.GetFloat64(offset)
+                                     : elements.GetFloat32(offset))) {
+          return false;
+        }
+      }
+      output_.Add(']');
+      return true;
+    }
+    if (value.IsLinkedHashMap()) {
+      LinkedHashMap::Iterator it(LinkedHashMap::Cast(value));
+      Object& key = Object::Handle(zone_);
+      Object& element = Object::Handle(zone_);
+      bool first = true;
+      output_.Add('{');
+      while (it.MoveNext()) {
+        key = it.CurrentKey();
+        if (!key.IsString()) {
+          return false;
+        }
+        if (!first) {
+          output_.Add(',');
+        }
+        first = false;
+        EncodeString(String::Cast(key));
+        output_.Add(':');
+        element = it.CurrentValue();
+        if (!EncodeValue(depth + 1, element)) {
+          return false;
+        }
+      }
+      output_.Add('}');
+      return true;
+    }
+    return false;
+  }
+
+  bool EncodeDouble(double d) {
+    if (isnan(d) || isinf(d)) {
+      return false;
+    }
+    const int kBufferSize = 128;
+    char buffer[kBufferSize];
+    const intptr_t length = DoubleToCString(d, buffer, kBufferSize);
+    for (intptr_t i = 0; i < length; i++) {
+      output_.Add(buffer[i]);
+    }
+    return true;
+  }
+
+  void WriteHexEscape(int32_t code_unit) {
+    static const char kHexDigits[] = "0123456789abcdef";
+    output_.Add('\\');
+    output_.Add('u');
+    output_.Add(kHexDigits[(code_unit >> 12) & 0xF]);
+    output_.Add(kHexDigits[(code_unit >> 8) & 0xF]);
+    output_.Add(kHexDigits[(code_unit >> 4) & 0xF]);
+    output_.Add(kHexDigits[code_unit & 0xF]);
+  }
+
+  void EncodeString(const String& str) {
+    output_.Add('"');
+    const intptr_t length = str.Length();
+    for (intptr_t i = 0; i < length; i++) {
+      int32_t ch = str.CharAt(i);
+      if (ch < 0x20) {
+        switch (ch) {
+          case '\b':
+            Write("\\b");
+            break;
+          case '\t':
+            Write("\\t");
+            break;
+          case '\n':
+            Write("\\n");
+            break;
+          case '\f':
+            Write("\\f");
+            break;
+          case '\r':
+            Write("\\r");
+            break;
+          default:
+            WriteHexEscape(ch);
+            break;
+        }
+      } else if ((ch == '"') || (ch == '\\')) {
+        output_.Add('\\');
+        output_.Add(ch);
+      } else if (ch <= Utf8::kMaxOneByteChar) {
+        output_.Add(ch);
+      } else {
+        if (Utf16::IsLeadSurrogate(ch) && ((i + 1) < length) &&
+            Utf16::IsTrailSurrogate(str.CharAt(i + 1))) {
+          ch = Utf16::Decode(ch, str.CharAt(++i));
+        } else if (Utf16::IsSurrogate(ch)) {
+          // Lone surrogates are escaped.
+          WriteHexEscape(ch);
+          continue;
+        }
+        char buffer[4];
+        const intptr_t bytes = Utf8::Encode(ch, buffer);
+        for (intptr_t j = 0; j < bytes; j++) {
+          output_.Add(buffer[j]);
+        }
+      }
+    }
+    output_.Add('"');
+  }
+
+  Thread* thread_;
+  Zone* zone_;
+  GrowableArray<uint8_t> output_;
+
+  DISALLOW_COPY_AND_ASSIGN(JsonEncoder);
+};
+
+// Returns the parsed value, or |input| itself if it is to be parsed by the
+// Dart implementation. |input| is a Uint8List of UTF-8 or a one-byte string.
+DEFINE_NATIVE_ENTRY(Json_parse, 0, 1) {
+  const Instance& input =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  intptr_t length;
+  bool is_utf8;
+  const uint8_t* text =
+      JsonParser::CopyInput(zone, input, &length, &is_utf8);
+  if (text == NULL) {
+    return input.raw();
+  }
+
+  JsonParser parser(thread, text, length, is_utf8);
+  Object& result = Object::Handle(zone);
+  if (!parser.Parse(&result)) {
+    return input.raw();
+  }
+  return result.raw();
+}
+
+// Returns the UTF-8 encoding of the JSON text of |value| as a Uint8List, or
+// null if it is to be encoded by the Dart implementation.
+DEFINE_NATIVE_ENTRY(Json_encodeUtf8, 0, 1) {
+  const Object& value = Object::Handle(zone, arguments->NativeArgAt(0));
+  JsonEncoder encoder(thread);
+  if (!encoder.Encode(value)) {
+    return Object::null();
+  }
+  const intptr_t length = encoder.length();
+  const TypedData& result = TypedData::Handle(
+      zone, TypedData::New(kTypedDataUint8ArrayCid, length));
+  if (length > 0) {
+    NoSafepointScope no_safepoint;
+    memmove(result.DataAddr(0), encoder.data(), length);
+  }
+  return result.raw();
+}
+
+// Returns the UTF-8 encoding of |string| as a Uint8List. Unpaired surrogates
+// are encoded as U+FFFD.
+DEFINE_NATIVE_ENTRY(Utf8Encoder_convert, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(String, str, arguments->NativeArgAt(0));
+  const intptr_t length = Utf8::Length(str);
+  const TypedData& result = TypedData::Handle(
+      zone, TypedData::New(kTypedDataUint8ArrayCid, length));
+  NoSafepointScope no_safepoint;
+  str.ToUTF8(reinterpret_cast<uint8_t*>(result.DataAddr(0)), length);
+  return result.raw();
+}
+
+}  // namespace dart
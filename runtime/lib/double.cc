@@ -209,8 +209,41 @@ DEFINE_NATIVE_ENTRY(Double_parse, 0, 3) {
   return Object::null();
 }
 
+// Parses the bytes of a Uint8List without creating a String first. Returns
+// null if they are not a valid double.
+DEFINE_NATIVE_ENTRY(Double_parseBytes, 0, 3) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, bytes, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, startValue, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, endValue, arguments->NativeArgAt(2));
+
+  const intptr_t cid = bytes.GetClassId();
+  if ((cid != kTypedDataUint8ArrayCid) &&
+      (cid != kExternalTypedDataUint8ArrayCid)) {
+    return Object::null();
+  }
+  const TypedDataBase& data = TypedDataBase::Cast(bytes);
+  const intptr_t start = startValue.Value();
+  const intptr_t end = endValue.Value();
+  if ((0 <= start) && (start < end) && (end <= data.Length())) {
+    double double_value;
+    bool ok;
+    {
+      NoSafepointScope no_safepoint;
+      ok = CStringToDouble(reinterpret_cast<const char*>(data.DataAddr(start)),
+                           end - start, &double_value);
+    }
+    if (ok) {
+      return Double::New(double_value);
+    }
+  }
+  return Object::null();
+}
+
 DEFINE_NATIVE_ENTRY(Double_toString, 0, 1) {
   const Number& number = Number::CheckedHandle(zone, arguments->NativeArgAt(0));
+  if (number.IsDouble()) {
+    return DoubleToString(Double::Cast(number).value(), Heap::kNew);
+  }
   return number.ToString(Heap::kNew);
 }
 
@@ -13,6 +13,7 @@
 #include "vm/class_id.h"
 #include "vm/compiler/ffi/native_type.h"
 #include "vm/exceptions.h"
+#include "vm/ffi_async_callbacks.h"
 #include "vm/flags.h"
 #include "vm/log.h"
 #include "vm/native_arguments.h"
@@ -306,16 +307,11 @@ DEFINE_NATIVE_ENTRY(Ffi_sizeOf, 1, 0) {
   return Integer::New(SizeOf(type_arg, zone));
 }
 
-// Static invocations to this method are translated directly in streaming FGB
-// and bytecode FGB. However, we can still reach this entrypoint in the bytecode
-// interpreter.
-DEFINE_NATIVE_ENTRY(Ffi_asFunctionInternal, 2, 1) {
-#if defined(DART_PRECOMPILED_RUNTIME) || defined(DART_PRECOMPILER)
-  UNREACHABLE();
-#else
-  ASSERT(FLAG_enable_interpreter);
-
-  GET_NON_NULL_NATIVE_ARGUMENT(Pointer, pointer, arguments->NativeArgAt(0));
+#if !defined(DART_PRECOMPILED_RUNTIME) && !defined(DART_PRECOMPILER)
+static ObjectPtr AsFunctionInternal(Zone* zone,
+                                    NativeArguments* arguments,
+                                    bool is_leaf,
+                                    bool is_lazy) {
   GET_NATIVE_TYPE_ARGUMENT(dart_type, arguments->NativeTypeArgAt(0));
   GET_NATIVE_TYPE_ARGUMENT(native_type, arguments->NativeTypeArgAt(1));
 
@@ -323,18 +319,75 @@ DEFINE_NATIVE_ENTRY(Ffi_asFunctionInternal, 2, 1) {
       Function::Handle(zone, Type::Cast(dart_type).signature());
   const Function& native_signature =
       Function::Handle(zone, Type::Cast(native_type).signature());
-  const Function& function = Function::Handle(
-      compiler::ffi::TrampolineFunction(dart_signature, native_signature));
+  const Function& function =
+      Function::Handle(compiler::ffi::TrampolineFunction(
+          dart_signature, native_signature, is_leaf, is_lazy));
 
   // Set the c function pointer in the context of the closure rather than in
   // the function so that we can reuse the function for each c function with
-  // the same signature.
-  const Context& context = Context::Handle(Context::New(1));
-  context.SetAt(0, pointer);
+  // the same signature. Lazily bound functions store the library and symbol
+  // instead, the trampoline resolves the pointer on its first call.
+  Context& context = Context::Handle(zone);
+  if (is_lazy) {
+    // A DynamicLibrary, or the URI of the library declaring an @FfiNative.
+    GET_NON_NULL_NATIVE_ARGUMENT(Instance, library, arguments->NativeArgAt(0));
+    GET_NON_NULL_NATIVE_ARGUMENT(String, symbol, arguments->NativeArgAt(1));
+    context = Context::New(3);
+    context.SetAt(1, library);
+    context.SetAt(2, symbol);
+  } else {
+    ASSERT(FLAG_enable_interpreter);
+    GET_NON_NULL_NATIVE_ARGUMENT(Pointer, pointer, arguments->NativeArgAt(0));
+    context = Context::New(1);
+    context.SetAt(0, pointer);
+  }
 
   return Closure::New(Object::null_type_arguments(),
                       Object::null_type_arguments(), function, context,
                       Heap::kOld);
+}
+#endif
+
+// Static invocations to these methods are translated directly in streaming FGB
+// and bytecode FGB. However, we can still reach these entrypoints in the
+// bytecode interpreter.
+DEFINE_NATIVE_ENTRY(Ffi_asFunctionInternal, 2, 1) {
+#if defined(DART_PRECOMPILED_RUNTIME) || defined(DART_PRECOMPILER)
+  UNREACHABLE();
+#else
+  return AsFunctionInternal(zone, arguments, /*is_leaf=*/false,
+                            /*is_lazy=*/false);
+#endif
+}
+
+// The trampoline must be a leaf call even when called from the interpreter,
+// because it may pass pointers into typed data.
+DEFINE_NATIVE_ENTRY(Ffi_asLeafFunctionInternal, 2, 1) {
+#if defined(DART_PRECOMPILED_RUNTIME) || defined(DART_PRECOMPILER)
+  UNREACHABLE();
+#else
+  return AsFunctionInternal(zone, arguments, /*is_leaf=*/true,
+                            /*is_lazy=*/false);
+#endif
+}
+
+// Only the streaming FGB translates these directly, they are also reached from
+// the bytecode interpreter and from code compiled by the bytecode FGB.
+DEFINE_NATIVE_ENTRY(Ffi_asLazyFunctionInternal, 2, 2) {
+#if defined(DART_PRECOMPILED_RUNTIME) || defined(DART_PRECOMPILER)
+  UNREACHABLE();
+#else
+  return AsFunctionInternal(zone, arguments, /*is_leaf=*/false,
+                            /*is_lazy=*/true);
+#endif
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asLazyLeafFunctionInternal, 2, 2) {
+#if defined(DART_PRECOMPILED_RUNTIME) || defined(DART_PRECOMPILER)
+  UNREACHABLE();
+#else
+  return AsFunctionInternal(zone, arguments, /*is_leaf=*/true,
+                            /*is_lazy=*/true);
 #endif
 }
 
@@ -498,6 +551,107 @@ DEFINE_NATIVE_ENTRY(Ffi_pointerFromFunction, 1, 1) {
   return Pointer::New(type_arg, entry_point);
 }
 
+static const Function& AsyncCallbackSignature(Zone* zone,
+                                              const AbstractType& type_arg) {
+  if (!type_arg.IsInstantiated() || !type_arg.IsFunctionType()) {
+    const String& error = String::Handle(String::NewFormatted(
+        "Expected a native function signature but found %s",
+        String::Handle(type_arg.UserVisibleName()).ToCString()));
+    Exceptions::ThrowArgumentError(error);
+  }
+  return Function::Handle(zone, Type::Cast(type_arg).signature());
+}
+
+static void ThrowUnknownAsyncCallback(const Integer& id) {
+  const String& error = String::Handle(String::NewFormatted(
+      "Unknown asynchronous callback %" Pd64, id.AsInt64Value()));
+  Exceptions::ThrowArgumentError(error);
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asyncCallbackCreate, 1, 1) {
+  GET_NATIVE_TYPE_ARGUMENT(type_arg, arguments->NativeTypeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(0));
+  const Function& signature = AsyncCallbackSignature(zone, type_arg);
+  const char* error = nullptr;
+  const intptr_t id =
+      FfiAsyncCallbacks::Create(isolate, port.Id(), signature, &error);
+  if (id < 0) {
+    Exceptions::ThrowArgumentError(String::Handle(String::New(error)));
+  }
+  return Smi::New(id);
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asyncCallbackAddress, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, id, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(1));
+  uword address = 0;
+  if (!FfiAsyncCallbacks::Address(isolate, port.Id(), id.AsInt64Value(),
+                                  &address)) {
+    ThrowUnknownAsyncCallback(id);
+  }
+  return Integer::NewFromUint64(address);
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asyncCallbackDequeue, 1, 2) {
+  GET_NATIVE_TYPE_ARGUMENT(type_arg, arguments->NativeTypeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, id, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(1));
+  const Function& signature = AsyncCallbackSignature(zone, type_arg);
+  ObjectPtr result = Object::null();
+  if (!FfiAsyncCallbacks::Dequeue(zone, isolate, port.Id(), id.AsInt64Value(),
+                                  signature, &result)) {
+    ThrowUnknownAsyncCallback(id);
+  }
+  return result;
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_asyncCallbackDelete, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, id, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(1));
+  if (!FfiAsyncCallbacks::Delete(isolate, port.Id(), id.AsInt64Value())) {
+    ThrowUnknownAsyncCallback(id);
+  }
+  return Object::null();
+}
+
+// The segments of the Arenas of dart:ffi start with this header. The Dart side
+// bump-allocates from the rest of the segment.
+struct FfiArenaSegment {
+  FfiArenaSegment* previous;
+  intptr_t size;
+};
+static constexpr intptr_t kFfiArenaSegmentHeaderSize = 16;
+COMPILE_ASSERT(sizeof(FfiArenaSegment) <= kFfiArenaSegmentHeaderSize);
+
+DEFINE_NATIVE_ENTRY(Ffi_arenaNewSegment, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, previous, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, size, arguments->NativeArgAt(1));
+  const int64_t bytes = size.AsInt64Value();
+  if ((bytes < kFfiArenaSegmentHeaderSize) || (bytes > kMaxInt32)) {
+    Exceptions::ThrowRangeError("size", size, kFfiArenaSegmentHeaderSize,
+                                kMaxInt32);
+  }
+  auto segment = reinterpret_cast<FfiArenaSegment*>(malloc(bytes));
+  if (segment == nullptr) {
+    Exceptions::ThrowOOM();
+  }
+  segment->previous =
+      reinterpret_cast<FfiArenaSegment*>(previous.AsInt64Value());
+  segment->size = bytes;
+  return Integer::NewFromUint64(reinterpret_cast<uword>(segment));
+}
+
+DEFINE_NATIVE_ENTRY(Ffi_arenaDeleteSegments, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Integer, segment, arguments->NativeArgAt(0));
+  auto current = reinterpret_cast<FfiArenaSegment*>(segment.AsInt64Value());
+  while (current != nullptr) {
+    FfiArenaSegment* previous = current->previous;
+    free(current);
+    current = previous;
+  }
+  return Object::null();
+}
+
 DEFINE_NATIVE_ENTRY(DartNativeApiFunctionPointer, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(String, name_dart, arguments->NativeArgAt(0));
   const char* name = name_dart.ToCString();
@@ -5,6 +5,7 @@
 #include "include/dart_api.h"
 #include "vm/bootstrap_natives.h"
 #include "vm/exceptions.h"
+#include "vm/ffi_symbol_cache.h"
 #include "vm/globals.h"
 #include "vm/native_entry.h"
 
@@ -123,6 +124,17 @@ static void* ResolveSymbol(void* handle, const char* symbol) {
 #endif
 }
 
+// Bindings look up the same symbols in every isolate, so the results are
+// shared through the FfiSymbolCache.
+static uword CachedResolveSymbol(void* handle, const char* symbol) {
+  uword pointer = 0;
+  if (!FfiSymbolCache::Lookup(handle, symbol, &pointer)) {
+    pointer = reinterpret_cast<uword>(ResolveSymbol(handle, symbol));
+    FfiSymbolCache::Insert(handle, symbol, pointer);
+  }
+  return pointer;
+}
+
 DEFINE_NATIVE_ENTRY(Ffi_dl_lookup, 1, 2) {
   GET_NATIVE_TYPE_ARGUMENT(type_arg, arguments->NativeTypeArgAt(0));
 
@@ -132,11 +144,70 @@ DEFINE_NATIVE_ENTRY(Ffi_dl_lookup, 1, 2) {
 
   void* handle = dlib.GetHandle();
 
-  const uword pointer =
-      reinterpret_cast<uword>(ResolveSymbol(handle, argSymbolName.ToCString()));
+  const uword pointer = CachedResolveSymbol(handle, argSymbolName.ToCString());
   return Pointer::New(type_arg, pointer);
 }
 
+// Resolves an @FfiNative function with the resolver of the library declaring
+// it. The trampoline takes the closure followed by the native arguments.
+static uword ResolveFfiNative(Thread* thread,
+                              const String& library_uri,
+                              const String& name,
+                              const Function& trampoline) {
+  Zone* zone = thread->zone();
+  const Library& library =
+      Library::Handle(zone, Library::LookupLibrary(thread, library_uri));
+  if (library.IsNull()) {
+    const String& msg = String::Handle(String::NewFormatted(
+        "Library '%s' not found.", library_uri.ToCString()));
+    Exceptions::ThrowArgumentError(msg);
+  }
+  Dart_FfiNativeResolver resolver = library.ffi_native_resolver();
+  if (resolver == NULL) {
+    const String& msg = String::Handle(String::NewFormatted(
+        "Library '%s' has no FFI native resolver.", library_uri.ToCString()));
+    Exceptions::ThrowArgumentError(msg);
+  }
+  const intptr_t num_arguments = trampoline.num_fixed_parameters() - 1;
+  void* address = resolver(name.ToCString(), num_arguments);
+  if (address == NULL) {
+    const String& msg = String::Handle(String::NewFormatted(
+        "Couldn't resolve FFI native '%s' in '%s'.", name.ToCString(),
+        library_uri.ToCString()));
+    Exceptions::ThrowArgumentError(msg);
+  }
+  return reinterpret_cast<uword>(address);
+}
+
+// Called by the trampoline of a lazily bound function on its first call. The
+// context of the closure holds null in place of the Pointer, followed by the
+// library and the name of the symbol. The library is the URI of the declaring
+// library for functions annotated with @FfiNative.
+DEFINE_NATIVE_ENTRY(Ffi_resolveLazyFunction, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Closure, closure, arguments->NativeArgAt(0));
+
+  const Context& context = Context::Handle(zone, closure.context());
+  ASSERT(context.num_variables() == 3);
+  if (context.At(0) != Object::null()) {
+    return Object::null();
+  }
+  const Object& library = Object::Handle(zone, context.At(1));
+  const String& symbol = String::CheckedHandle(zone, context.At(2));
+
+  uword pointer;
+  if (library.IsString()) {
+    pointer = ResolveFfiNative(thread, String::Cast(library), symbol,
+                               Function::Handle(zone, closure.function()));
+  } else {
+    pointer = CachedResolveSymbol(DynamicLibrary::Cast(library).GetHandle(),
+                                  symbol.ToCString());
+  }
+  // The trampoline only loads the address, the type argument is not used.
+  context.SetAt(0, Pointer::Handle(zone, Pointer::New(Object::dynamic_type(),
+                                                      pointer)));
+  return Object::null();
+}
+
 DEFINE_NATIVE_ENTRY(Ffi_dl_getHandle, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(DynamicLibrary, dlib, arguments->NativeArgAt(0));
 
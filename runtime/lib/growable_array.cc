@@ -80,6 +80,56 @@ DEFINE_NATIVE_ENTRY(GrowableList_setData, 0, 2) {
   return Object::null();
 }
 
+DEFINE_NATIVE_ENTRY(GrowableList_tryGrowInPlace, 0, 2) {
+  const GrowableObjectArray& array =
+      GrowableObjectArray::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, capacity, arguments->NativeArgAt(1));
+  const Array& data = Array::Handle(zone, array.data());
+  ASSERT(capacity.Value() > data.Length());
+  // Empty backing arrays may be shared.
+  return Bool::Get((data.Length() > 0) && data.TryGrowInPlace(capacity.Value()))
+      .raw();
+}
+
+DEFINE_NATIVE_ENTRY(Internal_reserveListCapacity, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, list, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, capacity, arguments->NativeArgAt(1));
+  if (!list.IsGrowableObjectArray()) {
+    return Object::null();
+  }
+  if ((capacity.Value() < 0) || (capacity.Value() > Array::kMaxElements)) {
+    Exceptions::ThrowRangeError("capacity", capacity, 0, Array::kMaxElements);
+  }
+  const GrowableObjectArray& array = GrowableObjectArray::Cast(list);
+  const Array& data = Array::Handle(zone, array.data());
+  if ((capacity.Value() <= data.Length()) ||
+      ((data.Length() > 0) && data.TryGrowInPlace(capacity.Value()))) {
+    return Object::null();
+  }
+  const Array& new_data = Array::Handle(zone, Array::New(capacity.Value()));
+  new_data.CopyRange(0, data, 0, array.Length());
+  array.SetData(new_data);
+  return Object::null();
+}
+
+DEFINE_NATIVE_ENTRY(Internal_shrinkListToFit, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, list, arguments->NativeArgAt(0));
+  if (!list.IsGrowableObjectArray()) {
+    return Object::null();
+  }
+  const GrowableObjectArray& array = GrowableObjectArray::Cast(list);
+  if (array.Length() == array.Capacity()) {
+    return Object::null();
+  }
+  if (array.Length() == 0) {
+    array.SetData(Object::empty_array());
+    return Object::null();
+  }
+  // The released tail becomes a filler object, the elements don't move.
+  Array::Handle(zone, array.data()).Truncate(array.Length());
+  return Object::null();
+}
+
 DEFINE_NATIVE_ENTRY(Internal_makeListFixedLength, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(GrowableObjectArray, array,
                                arguments->NativeArgAt(0));
@@ -7,6 +7,7 @@
 #include "include/dart_api.h"
 #include "vm/dart_api_impl.h"
 #include "vm/dart_entry.h"
+#include "vm/double_conversion.h"
 #include "vm/exceptions.h"
 #include "vm/isolate.h"
 #include "vm/native_entry.h"
@@ -161,17 +162,23 @@ DEFINE_NATIVE_ENTRY(Integer_equalToInteger, 0, 2) {
 static IntegerPtr ParseInteger(const String& value) {
   // Used by both Integer_parse and Integer_fromEnvironment.
   if (value.IsOneByteString()) {
-    // Quick conversion for unpadded integers in strings.
+    // Quick conversion for unpadded integers of at most 18 digits, which
+    // always fit in 64 bits.
+    static const intptr_t kMaxDigits = 18;
     const intptr_t len = value.Length();
-    if (len > 0) {
-      const char* cstr = value.ToCString();
-      ASSERT(cstr != NULL);
-      char* p_end = NULL;
-      const int64_t int_value = strtoll(cstr, &p_end, 10);
-      if (p_end == (cstr + len)) {
-        if ((int_value != LLONG_MIN) && (int_value != LLONG_MAX)) {
-          return Integer::New(int_value);
-        }
+    if ((len > 0) && (len <= kMaxDigits + 1)) {
+      char chars[kMaxDigits + 1];
+      for (intptr_t i = 0; i < len; i++) {
+        chars[i] = value.CharAt(i);
+      }
+      const intptr_t sign_length =
+          ((chars[0] == '-') || (chars[0] == '+')) ? 1 : 0;
+      uint64_t int_value = 0;
+      const intptr_t digit_count = ParseDecimalDigits(
+          chars + sign_length, len - sign_length, kMaxDigits, &int_value);
+      if ((digit_count > 0) && (sign_length + digit_count == len)) {
+        return Integer::New(chars[0] == '-' ? -static_cast<int64_t>(int_value)
+                                            : static_cast<int64_t>(int_value));
       }
     }
   }
@@ -89,6 +89,15 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_get_hashcode, 0, 1) {
   return Smi::New(hash);
 }
 
+// Isolates of the same group share one heap, so objects that neither side can
+// change are passed to the receiver by reference instead of being copied.
+// Constants are deeply immutable, and strings and boxed numbers have no
+// mutable state.
+static bool CanShareWithinGroup(const Instance& obj) {
+  return obj.IsCanonical() || obj.IsString() || obj.IsMint() ||
+         obj.IsDouble();
+}
+
 DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(SendPort, port, arguments->NativeArgAt(0));
   // TODO(iposva): Allow for arbitrary messages to be sent.
@@ -100,6 +109,15 @@ DEFINE_NATIVE_ENTRY(SendPortImpl_sendInternal_, 0, 2) {
   if (ApiObjectConverter::CanConvert(obj.raw())) {
     PortMap::PostMessage(
         Message::New(destination_port_id, obj.raw(), Message::kNormalPriority));
+  } else if (CanShareWithinGroup(obj) &&
+             PortMap::IsReceiverInThisIsolateGroup(destination_port_id,
+                                                   isolate->group())) {
+    PersistentHandle* handle =
+        isolate->group()->api_state()->AllocatePersistentHandle();
+    handle->set_raw(obj);
+    PortMap::PostMessage(Message::New(
+        destination_port_id, new Bequest(handle, destination_port_id),
+        Message::kNormalPriority));
   } else {
     MessageWriter writer(can_send_any_object);
     // TODO(turnidge): Throw an exception when the return value is false?
@@ -46,15 +46,17 @@ DEFINE_NATIVE_ENTRY(Object_getHash, 0, 1) {
 #endif
 }
 
+// Leaves the hash alone if another isolate of the group has set one already,
+// like the Object_setHash intrinsics.
 DEFINE_NATIVE_ENTRY(Object_setHash, 0, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, hash, arguments->NativeArgAt(1));
 #if defined(HASH_IN_OBJECT_HEADER)
-  Object::SetCachedHash(arguments->NativeArgAt(0), hash.Value());
+  Object::SetCachedHashIfNotSet(arguments->NativeArgAt(0), hash.Value());
 #else
   const Instance& instance =
       Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
   Heap* heap = isolate->heap();
-  heap->SetHash(instance.raw(), hash.Value());
+  heap->SetHashIfNotSet(instance.raw(), hash.Value());
 #endif
   return Object::null();
 }
@@ -8,6 +8,7 @@
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/regexp_assembler_bytecode.h"
+#include "vm/regexp_linear.h"
 #include "vm/regexp_parser.h"
 #include "vm/thread.h"
 
@@ -48,7 +49,21 @@ DEFINE_NATIVE_ENTRY(RegExp_factory, 0, 6) {
   RegExpParser::ParseRegExp(pattern, flags, &compileData);
 
   // Create a RegExp object containing only the initial parameters.
-  return RegExpEngine::CreateRegExp(thread, pattern, flags);
+  const RegExp& regexp =
+      RegExp::Handle(zone, RegExpEngine::CreateRegExp(thread, pattern, flags));
+  regexp.set_required_literal(
+      String::Handle(zone, RegExpEngine::RequiredLiteral(compileData.tree)));
+  const TypedData& linear_program = TypedData::Handle(
+      zone, RegExpLinearMatcher::Compile(compileData.tree, flags,
+                                         compileData.capture_count,
+                                         FLAG_linear_regexp));
+  if (!linear_program.IsNull()) {
+    // The backtracking engines are never compiled for this regexp.
+    regexp.set_num_bracket_expressions(compileData.capture_count);
+    regexp.set_capture_name_map(compileData.capture_name_map);
+    regexp.set_linear_program(linear_program);
+  }
+  return regexp.raw();
 }
 
 DEFINE_NATIVE_ENTRY(RegExp_getPattern, 0, 1) {
@@ -121,6 +136,22 @@ static ObjectPtr ExecuteMatch(Zone* zone,
   GET_NON_NULL_NATIVE_ARGUMENT(String, subject, arguments->NativeArgAt(1));
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_index, arguments->NativeArgAt(2));
 
+  // Subjects which don't contain the required literal can't match. The
+  // intrinsics leave patterns which have one, or a linear program, to this
+  // native.
+  const String& literal = String::Handle(zone, regexp.required_literal());
+  if (!literal.IsNull() &&
+      (subject.IndexOf(literal, start_index.Value()) < 0)) {
+    return Object::null();
+  }
+
+  const TypedData& linear_program =
+      TypedData::Handle(zone, regexp.linear_program());
+  if (!linear_program.IsNull()) {
+    return RegExpLinearMatcher::Match(linear_program, subject,
+                                      start_index.Value(), sticky, zone);
+  }
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (!FLAG_interpret_irregexp) {
     return IRRegExpMacroAssembler::Execute(regexp, subject, start_index,
@@ -265,22 +265,34 @@ DEFINE_NATIVE_ENTRY(OneByteString_splitWithCharCode, 0, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, smi_split_code, arguments->NativeArgAt(1));
   const intptr_t len = receiver.Length();
   const intptr_t split_code = smi_split_code.Value();
+  // Count the pieces first, so that the result doesn't have to grow.
+  intptr_t num_pieces = 1;
+  for (intptr_t i = 0; i < len; i++) {
+    if (split_code == OneByteString::CharAt(receiver, i)) {
+      num_pieces++;
+    }
+  }
   const GrowableObjectArray& result = GrowableObjectArray::Handle(
-      zone, GrowableObjectArray::New(16, Heap::kNew));
+      zone, GrowableObjectArray::New(num_pieces, Heap::kNew));
   String& str = String::Handle(zone);
   intptr_t start = 0;
   intptr_t i = 0;
-  for (; i < len; i++) {
-    if (split_code == OneByteString::CharAt(receiver, i)) {
+  for (; i <= len; i++) {
+    if ((i < len) && (split_code != OneByteString::CharAt(receiver, i))) {
+      continue;
+    }
+    // Empty and single character pieces, e.g. the fields of a CSV line, are
+    // shared symbols rather than new strings.
+    if ((i - start) == 1) {
+      str = Symbols::FromCharCode(thread,
+                                  OneByteString::CharAt(receiver, start));
+    } else {
       str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
                                               Heap::kNew);
-      result.Add(str);
-      start = i + 1;
     }
+    result.Add(str);
+    start = i + 1;
   }
-  str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
-                                          Heap::kNew);
-  result.Add(str);
   result.SetTypeArguments(TypeArguments::Handle(
       zone, isolate->object_store()->type_argument_string()));
   return result.raw();
@@ -550,6 +562,14 @@ DEFINE_NATIVE_ENTRY(String_concat, 0, 2) {
   const String& receiver =
       String::CheckedHandle(zone, arguments->NativeArgAt(0));
   GET_NON_NULL_NATIVE_ARGUMENT(String, b, arguments->NativeArgAt(1));
+  // Strings are immutable, so concatenating with the empty string, e.g. the
+  // first step of building a string with +=, can return the other operand.
+  if (b.Length() == 0) {
+    return receiver.raw();
+  }
+  if (receiver.Length() == 0) {
+    return b.raw();
+  }
   return String::Concat(receiver, b);
 }
 
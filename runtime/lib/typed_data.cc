@@ -5,6 +5,7 @@
 #include "vm/bootstrap_natives.h"
 
 #include "include/dart_api.h"
+#include "platform/unaligned.h"
 
 #include "vm/exceptions.h"
 #include "vm/native_entry.h"
@@ -177,6 +178,139 @@ DEFINE_NATIVE_ENTRY(TypedData_setRange, 0, 7) {
   return Bool::False().raw();
 }
 
+// Fills the range with copies of its first element, which the caller has
+// already stored. The copied prefix doubles with every memcpy.
+DEFINE_NATIVE_ENTRY(TypedData_fillRange, 0, 4) {
+  const Instance& array =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  const Smi& start = Smi::CheckedHandle(zone, arguments->NativeArgAt(1));
+  const Smi& length = Smi::CheckedHandle(zone, arguments->NativeArgAt(2));
+  const Smi& element_size = Smi::CheckedHandle(zone, arguments->NativeArgAt(3));
+
+  const TypedDataBase& data = TypedDataBase::Cast(array);
+  const intptr_t length_in_bytes = length.Value();
+  const intptr_t element_size_in_bytes = element_size.Value();
+  ASSERT(Utils::RangeCheck(start.Value(), length_in_bytes,
+                           data.LengthInBytes()));
+  ASSERT(length_in_bytes >= element_size_in_bytes);
+  ASSERT((length_in_bytes % element_size_in_bytes) == 0);
+  NoSafepointScope no_safepoint;
+  uint8_t* bytes =
+      reinterpret_cast<uint8_t*>(data.DataAddr(0)) + start.Value();
+  if (element_size_in_bytes == 1) {
+    memset(bytes + 1, bytes[0], length_in_bytes - 1);
+    return Object::null();
+  }
+  intptr_t filled = element_size_in_bytes;
+  while (filled < length_in_bytes) {
+    const intptr_t count = Utils::Minimum(filled, length_in_bytes - filled);
+    memcpy(bytes + filled, bytes, count);
+    filled += count;
+  }
+  return Object::null();
+}
+
+template <typename T>
+static intptr_t IndexOfElement(const uint8_t* bytes,
+                               intptr_t length,
+                               T element,
+                               bool is_last) {
+  const T* elements = reinterpret_cast<const T*>(bytes);
+  if (is_last) {
+    for (intptr_t i = length - 1; i >= 0; i--) {
+      if (LoadUnaligned(&elements[i]) == element) {
+        return i;
+      }
+    }
+  } else {
+    for (intptr_t i = 0; i < length; i++) {
+      if (LoadUnaligned(&elements[i]) == element) {
+        return i;
+      }
+    }
+  }
+  return -1;
+}
+
+// Returns the index of the first or last of |length| integer elements equal to
+// the given one, relative to the start of the range, or -1. Values outside
+// the range of the element type never match.
+DEFINE_NATIVE_ENTRY(TypedData_indexOf, 0, 6) {
+  const Instance& array =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  const Smi& start = Smi::CheckedHandle(zone, arguments->NativeArgAt(1));
+  const Smi& length = Smi::CheckedHandle(zone, arguments->NativeArgAt(2));
+  const Object& element = Object::Handle(zone, arguments->NativeArgAt(3));
+  const Smi& cid = Smi::CheckedHandle(zone, arguments->NativeArgAt(4));
+  const Bool& is_last = Bool::CheckedHandle(zone, arguments->NativeArgAt(5));
+
+  if (!element.IsInteger()) {
+    return Smi::New(-1);
+  }
+  const int64_t value = Integer::Cast(element).AsInt64Value();
+  const TypedDataBase& data = TypedDataBase::Cast(array);
+  const TypedDataElementType element_type =
+      TypedDataBase::ElementType(cid.Value());
+  ASSERT(Utils::RangeCheck(
+      start.Value(),
+      length.Value() * TypedDataBase::ElementSizeInBytes(cid.Value()),
+      data.LengthInBytes()));
+  NoSafepointScope no_safepoint;
+  const uint8_t* bytes =
+      reinterpret_cast<const uint8_t*>(data.DataAddr(0)) + start.Value();
+  const intptr_t n = length.Value();
+  const bool last = is_last.value();
+  intptr_t index = -1;
+  switch (element_type) {
+    case kInt8ArrayElement:
+      if (Utils::IsInt(8, value)) {
+        index = IndexOfElement<int8_t>(bytes, n, value, last);
+      }
+      break;
+    case kUint8ArrayElement:
+    case kUint8ClampedArrayElement:
+      if (Utils::IsUint(8, value)) {
+        if (last) {
+          index = IndexOfElement<uint8_t>(bytes, n, value, last);
+        } else {
+          const void* found = memchr(bytes, static_cast<int>(value), n);
+          if (found != nullptr) {
+            index = reinterpret_cast<const uint8_t*>(found) - bytes;
+          }
+        }
+      }
+      break;
+    case kInt16ArrayElement:
+      if (Utils::IsInt(16, value)) {
+        index = IndexOfElement<int16_t>(bytes, n, value, last);
+      }
+      break;
+    case kUint16ArrayElement:
+      if (Utils::IsUint(16, value)) {
+        index = IndexOfElement<uint16_t>(bytes, n, value, last);
+      }
+      break;
+    case kInt32ArrayElement:
+      if (Utils::IsInt(32, value)) {
+        index = IndexOfElement<int32_t>(bytes, n, value, last);
+      }
+      break;
+    case kUint32ArrayElement:
+      if (Utils::IsUint(32, value)) {
+        index = IndexOfElement<uint32_t>(bytes, n, value, last);
+      }
+      break;
+    case kInt64ArrayElement:
+    case kUint64ArrayElement:
+      // Elements of Uint64List read back as the int with the same bits.
+      index = IndexOfElement<int64_t>(bytes, n, value, last);
+      break;
+    default:
+      UNREACHABLE();
+  }
+  return Smi::New(index);
+}
+
 // We check the length parameter against a possible maximum length for the
 // array based on available physical addressable memory on the system.
 //
@@ -10,12 +10,21 @@
 #include "platform/unicode.h"
 #include "third_party/wasmer/wasmer.hh"
 #include "vm/bootstrap_natives.h"
+#include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
+#include "vm/flags.h"
+#include "vm/hash.h"
+#include "vm/os.h"
 
 namespace dart {
 
+DEFINE_FLAG(charp,
+            wasm_module_cache,
+            nullptr,
+            "Directory in which compiled WASM modules are cached.");
+
 static void ThrowWasmerError() {
   String& error = String::Handle();
   {
@@ -619,27 +628,131 @@ class WasmInstance {
   DISALLOW_COPY_AND_ASSIGN(WasmInstance);
 };
 
+static std::unique_ptr<uint8_t[]> CopyBytes(Thread* thread,
+                                            const TypedDataBase& data,
+                                            intptr_t* len) {
+  NoSafepointScope scope(thread);
+  *len = data.LengthInBytes();
+  auto copy = std::unique_ptr<uint8_t[]>(new uint8_t[*len]);
+  // The memory does not overlap.
+  memcpy(copy.get(), data.DataAddr(0), *len);  // NOLINT
+  return copy;
+}
+
+static bool DeserializeModule(const uint8_t* bytes,
+                              intptr_t len,
+                              wasmer_module_t** module) {
+  wasmer_serialized_module_t* serialized;
+  if (wasmer_serialized_module_from_bytes(&serialized, bytes, len) !=
+      wasmer_result_t::WASMER_OK) {
+    return false;
+  }
+  const wasmer_result_t result = wasmer_module_deserialize(module, serialized);
+  wasmer_serialized_module_destroy(serialized);
+  return result == wasmer_result_t::WASMER_OK;
+}
+
+// Files in the --wasm_module_cache directory are named after the hash and
+// length of the module's bytes. They contain the bytes of the module, which
+// are compared to rule out collisions, followed by the serialized module.
+static char* ModuleCachePath(const uint8_t* data, intptr_t len) {
+  return OS::SCreate(nullptr, "%s/%08" Px32 "-%" Pd ".wasmcache",
+                     FLAG_wasm_module_cache, HashBytes(data, len), len);
+}
+
+static bool LoadCachedModule(const char* path,
+                             const uint8_t* data,
+                             intptr_t len,
+                             wasmer_module_t** module) {
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    return false;
+  }
+  void* file = file_open(path, /*write=*/false);
+  if (file == nullptr) {
+    return false;
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t size = -1;
+  file_read(&buffer, &size, file);
+  file_close(file);
+  const bool loaded = (size > len) && (memcmp(buffer, data, len) == 0) &&
+                      DeserializeModule(buffer + len, size - len, module);
+  free(buffer);
+  return loaded;
+}
+
+static void StoreCachedModule(const char* path,
+                              const uint8_t* data,
+                              intptr_t len,
+                              const wasmer_module_t* module) {
+  auto file_open = Dart::file_open_callback();
+  auto file_write = Dart::file_write_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_write == nullptr) ||
+      (file_close == nullptr)) {
+    return;
+  }
+  wasmer_serialized_module_t* serialized;
+  if (wasmer_module_serialize(&serialized, module) !=
+      wasmer_result_t::WASMER_OK) {
+    return;
+  }
+  // A cache that can't be written only costs the compilation next time.
+  void* file = file_open(path, /*write=*/true);
+  if (file != nullptr) {
+    const wasmer_byte_array bytes = wasmer_serialized_module_bytes(serialized);
+    file_write(data, len, file);
+    file_write(bytes.bytes, bytes.bytes_len, file);
+    file_close(file);
+  }
+  wasmer_serialized_module_destroy(serialized);
+}
+
+static wasmer_result_t CompileModule(const uint8_t* data,
+                                     intptr_t len,
+                                     wasmer_module_t** module) {
+  if (FLAG_wasm_module_cache == nullptr) {
+    return wasmer_compile(module, const_cast<uint8_t*>(data), len);
+  }
+  char* path = ModuleCachePath(data, len);
+  wasmer_result_t result = wasmer_result_t::WASMER_OK;
+  if (!LoadCachedModule(path, data, len, module)) {
+    result = wasmer_compile(module, const_cast<uint8_t*>(data), len);
+    if (result == wasmer_result_t::WASMER_OK) {
+      StoreCachedModule(path, data, len, *module);
+    }
+  }
+  free(path);
+  return result;
+}
+
+static void SetModule(Thread* thread,
+                      const Instance& mod_wrap,
+                      wasmer_module_t* module,
+                      intptr_t external_size) {
+  mod_wrap.SetNativeField(0, reinterpret_cast<intptr_t>(module));
+  FinalizablePersistentHandle::New(thread->isolate(), mod_wrap, module,
+                                   FinalizeWasmModule, external_size);
+}
+
 DEFINE_NATIVE_ENTRY(Wasm_initModule, 0, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(Instance, mod_wrap, arguments->NativeArgAt(0));
   GET_NON_NULL_NATIVE_ARGUMENT(TypedDataBase, data, arguments->NativeArgAt(1));
 
   ASSERT(mod_wrap.NumNativeFields() == 1);
 
-  std::unique_ptr<uint8_t[]> data_copy;
   intptr_t len;
-  {
-    NoSafepointScope scope(thread);
-    len = data.LengthInBytes();
-    data_copy = std::unique_ptr<uint8_t[]>(new uint8_t[len]);
-    // The memory does not overlap.
-    memcpy(data_copy.get(), data.DataAddr(0), len);  // NOLINT
-  }
+  std::unique_ptr<uint8_t[]> data_copy = CopyBytes(thread, data, &len);
 
   wasmer_module_t* module;
   wasmer_result_t result;
   {
     TransitionVMToNative transition(thread);
-    result = wasmer_compile(&module, data_copy.get(), len);
+    result = CompileModule(data_copy.get(), len, &module);
   }
   if (result != wasmer_result_t::WASMER_OK) {
     data_copy.reset();
@@ -647,13 +760,60 @@ DEFINE_NATIVE_ENTRY(Wasm_initModule, 0, 2) {
     UNREACHABLE();
   }
 
-  mod_wrap.SetNativeField(0, reinterpret_cast<intptr_t>(module));
-  FinalizablePersistentHandle::New(thread->isolate(), mod_wrap, module,
-                                   FinalizeWasmModule, len);
+  SetModule(thread, mod_wrap, module, len);
+  return Object::null();
+}
 
+DEFINE_NATIVE_ENTRY(Wasm_deserializeModule, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, mod_wrap, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(TypedDataBase, data, arguments->NativeArgAt(1));
+
+  ASSERT(mod_wrap.NumNativeFields() == 1);
+
+  intptr_t len;
+  std::unique_ptr<uint8_t[]> data_copy = CopyBytes(thread, data, &len);
+
+  wasmer_module_t* module;
+  bool deserialized;
+  {
+    TransitionVMToNative transition(thread);
+    deserialized = DeserializeModule(data_copy.get(), len, &module);
+  }
+  if (!deserialized) {
+    data_copy.reset();
+    ThrowWasmerError();
+    UNREACHABLE();
+  }
+
+  SetModule(thread, mod_wrap, module, len);
   return Object::null();
 }
 
+DEFINE_NATIVE_ENTRY(Wasm_serializeModule, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, mod_wrap, arguments->NativeArgAt(0));
+
+  ASSERT(mod_wrap.NumNativeFields() == 1);
+
+  wasmer_module_t* module =
+      reinterpret_cast<wasmer_module_t*>(mod_wrap.GetNativeField(0));
+
+  wasmer_serialized_module_t* serialized;
+  if (wasmer_module_serialize(&serialized, module) !=
+      wasmer_result_t::WASMER_OK) {
+    ThrowWasmerError();
+    UNREACHABLE();
+  }
+  const wasmer_byte_array bytes = wasmer_serialized_module_bytes(serialized);
+  const TypedData& result = TypedData::Handle(
+      zone, TypedData::New(kTypedDataUint8ArrayCid, bytes.bytes_len));
+  {
+    NoSafepointScope scope(thread);
+    memcpy(result.DataAddr(0), bytes.bytes, bytes.bytes_len);  // NOLINT
+  }
+  wasmer_serialized_module_destroy(serialized);
+  return result.raw();
+}
+
 DEFINE_NATIVE_ENTRY(Wasm_describeModule, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(Instance, mod_wrap, arguments->NativeArgAt(0));
 
@@ -924,47 +1084,113 @@ DEFINE_NATIVE_ENTRY(Wasm_initFunction, 0, 4) {
   return Object::null();
 }
 
-DEFINE_NATIVE_ENTRY(Wasm_callFunction, 0, 2) {
-  GET_NON_NULL_NATIVE_ARGUMENT(Instance, fn_wrap, arguments->NativeArgAt(0));
-  GET_NON_NULL_NATIVE_ARGUMENT(Array, args, arguments->NativeArgAt(1));
-
+static WasmFunction* CheckArgCount(Zone* zone,
+                                   const Instance& fn_wrap,
+                                   intptr_t num_args) {
   ASSERT(fn_wrap.NumNativeFields() == 1);
   WasmFunction* fn = reinterpret_cast<WasmFunction*>(fn_wrap.GetNativeField(0));
 
-  if (args.Length() != fn->args().length()) {
+  if (num_args != fn->args().length()) {
     Exceptions::ThrowArgumentError(String::Handle(
         zone, String::NewFormatted("Wrong number of args. Expected %" Pu
                                    " but found %" Pd ".",
-                                   fn->args().length(), args.Length())));
+                                   fn->args().length(), num_args)));
     UNREACHABLE();
   }
-  auto params = std::unique_ptr<wasmer_value_t[]>(
-      new wasmer_value_t[fn->args().length()]);
-  Number& arg_num = Number::Handle(zone);
-  for (intptr_t i = 0; i < args.Length(); ++i) {
-    arg_num ^= args.At(i);
-    if (!ToWasmValue(arg_num, fn->args()[i], &params[i])) {
-      params.reset();
-      Exceptions::ThrowArgumentError(String::Handle(
-          zone, String::NewFormatted("Arg %" Pd " is the wrong type.", i)));
-      UNREACHABLE();
-    }
+  return fn;
+}
+
+static void ToWasmArg(Zone* zone,
+                      WasmFunction* fn,
+                      intptr_t i,
+                      const Number& arg_num,
+                      wasmer_value_t* param) {
+  if (!ToWasmValue(arg_num, fn->args()[i], param)) {
+    Exceptions::ThrowArgumentError(String::Handle(
+        zone, String::NewFormatted("Arg %" Pd " is the wrong type.", i)));
+    UNREACHABLE();
   }
+}
 
+static ObjectPtr CallFunction(Thread* thread,
+                              WasmFunction* fn,
+                              const wasmer_value_t* params) {
   wasmer_value_t ret;
   wasmer_result_t result;
   {
     TransitionVMToNative transition(thread);
-    result = fn->Call(params.get(), &ret);
+    result = fn->Call(params, &ret);
   }
   if (result != wasmer_result_t::WASMER_OK) {
-    params.reset();
     ThrowWasmerError();
     UNREACHABLE();
   }
   return fn->IsVoid() ? Object::null() : ToDartObject(ret);
 }
 
+DEFINE_NATIVE_ENTRY(Wasm_callFunction, 0, 2) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, fn_wrap, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Array, args, arguments->NativeArgAt(1));
+
+  WasmFunction* fn = CheckArgCount(zone, fn_wrap, args.Length());
+
+  auto params = std::unique_ptr<wasmer_value_t[]>(
+      new wasmer_value_t[fn->args().length()]);
+  Number& arg_num = Number::Handle(zone);
+  for (intptr_t i = 0; i < args.Length(); ++i) {
+    arg_num ^= args.At(i);
+    ToWasmArg(zone, fn, i, arg_num, &params[i]);
+  }
+  return CallFunction(thread, fn, params.get());
+}
+
+// Calls with up to kMaxDirectArgs arguments pass them as native arguments,
+// instead of copying them into a List first, and convert them on the stack.
+static constexpr intptr_t kMaxDirectArgs = 4;
+
+static ObjectPtr CallFunctionDirect(Thread* thread,
+                                    Zone* zone,
+                                    NativeArguments* arguments,
+                                    intptr_t num_args) {
+  ASSERT(num_args <= kMaxDirectArgs);
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, fn_wrap, arguments->NativeArgAt(0));
+
+  WasmFunction* fn = CheckArgCount(zone, fn_wrap, num_args);
+
+  wasmer_value_t params[kMaxDirectArgs];
+  Number& arg_num = Number::Handle(zone);
+  for (intptr_t i = 0; i < num_args; ++i) {
+    const Instance& arg =
+        Instance::CheckedHandle(zone, arguments->NativeArgAt(i + 1));
+    if (!arg.IsNumber()) {
+      DartNativeThrowArgumentException(arg);
+    }
+    arg_num ^= arg.raw();
+    ToWasmArg(zone, fn, i, arg_num, &params[i]);
+  }
+  return CallFunction(thread, fn, params);
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction0, 0, 1) {
+  return CallFunctionDirect(thread, zone, arguments, 0);
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction1, 0, 2) {
+  return CallFunctionDirect(thread, zone, arguments, 1);
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction2, 0, 3) {
+  return CallFunctionDirect(thread, zone, arguments, 2);
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction3, 0, 4) {
+  return CallFunctionDirect(thread, zone, arguments, 3);
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction4, 0, 5) {
+  return CallFunctionDirect(thread, zone, arguments, 4);
+}
+
 }  // namespace dart
 
 #else  // DART_ENABLE_WASM
@@ -980,6 +1206,16 @@ DEFINE_NATIVE_ENTRY(Wasm_initModule, 0, 2) {
   return nullptr;
 }
 
+DEFINE_NATIVE_ENTRY(Wasm_deserializeModule, 0, 2) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_serializeModule, 0, 1) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
 DEFINE_NATIVE_ENTRY(Wasm_describeModule, 0, 1) {
   Exceptions::ThrowUnsupportedError("WASM is disabled");
   return nullptr;
@@ -1040,6 +1276,31 @@ DEFINE_NATIVE_ENTRY(Wasm_callFunction, 0, 2) {
   return nullptr;
 }
 
+DEFINE_NATIVE_ENTRY(Wasm_callFunction0, 0, 1) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction1, 0, 2) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction2, 0, 3) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction3, 0, 4) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
+DEFINE_NATIVE_ENTRY(Wasm_callFunction4, 0, 5) {
+  Exceptions::ThrowUnsupportedError("WASM is disabled");
+  return nullptr;
+}
+
 }  // namespace dart
 
 #endif  // DART_ENABLE_WASM
@@ -7,6 +7,7 @@
 #include "platform/allocation.h"
 #include "platform/globals.h"
 #include "platform/syslog.h"
+#include "platform/utils.h"
 
 namespace dart {
 
@@ -40,6 +41,32 @@ const uint32_t Utf8::kOverlongMinimum[7] = {0,  // Padding.
                                             0x0,     0x80,       0x800,
                                             0x10000, 0xFFFFFFFF, 0xFFFFFFFF};
 
+// A constant mask that can be 'and'ed with a word of data to determine if it
+// is all ASCII.
+#if defined(ARCH_IS_64_BIT)
+static const uintptr_t kAsciiWordMask = DART_UINT64_C(0x8080808080808080);
+#else
+static const uintptr_t kAsciiWordMask = 0x80808080u;
+#endif
+
+// Returns the number of leading ASCII characters in 'utf8_array', checking a
+// word at a time. Most text, and JSON in particular, is mostly ASCII.
+static intptr_t AsciiPrefixLength(const uint8_t* utf8_array,
+                                  intptr_t array_len) {
+  intptr_t i = 0;
+  for (; (i + kWordSize) <= array_len; i += kWordSize) {
+    const uintptr_t chunk =
+        LoadUnaligned(reinterpret_cast<const uintptr_t*>(&utf8_array[i]));
+    if ((chunk & kAsciiWordMask) != 0) {
+      break;
+    }
+  }
+  while ((i < array_len) && (utf8_array[i] <= Utf8::kMaxOneByteChar)) {
+    i++;
+  }
+  return i;
+}
+
 // Returns the most restricted coding form in which the sequence of utf8
 // characters in 'utf8_array' can be represented in, and the number of
 // code units needed in that form.
@@ -50,6 +77,13 @@ intptr_t Utf8::CodeUnitCount(const uint8_t* utf8_array,
   Type char_type = kLatin1;
   for (intptr_t i = 0; i < array_len; i++) {
     uint8_t code_unit = utf8_array[i];
+    if (code_unit <= kMaxOneByteChar) {
+      // Each ASCII character is one code unit.
+      const intptr_t count = AsciiPrefixLength(&utf8_array[i], array_len - i);
+      len += count;
+      i += count - 1;
+      continue;
+    }
     if (!IsTrailByte(code_unit)) {
       ++len;
       if (!IsLatin1SequenceStart(code_unit)) {          // > U+00FF
@@ -71,25 +105,27 @@ bool Utf8::IsValid(const uint8_t* utf8_array, intptr_t array_len) {
   intptr_t i = 0;
   while (i < array_len) {
     uint32_t ch = utf8_array[i] & 0xFF;
+    if (ch <= kMaxOneByteChar) {
+      i += AsciiPrefixLength(&utf8_array[i], array_len - i);
+      continue;
+    }
     intptr_t j = 1;
-    if (ch >= 0x80) {
-      int8_t num_trail_bytes = kTrailBytes[ch];
-      bool is_malformed = false;
-      for (; j < num_trail_bytes; ++j) {
-        if ((i + j) < array_len) {
-          uint8_t code_unit = utf8_array[i + j];
-          is_malformed |= !IsTrailByte(code_unit);
-          ch = (ch << 6) + code_unit;
-        } else {
-          return false;
-        }
-      }
-      ch -= kMagicBits[num_trail_bytes];
-      if (!((is_malformed == false) && (j == num_trail_bytes) &&
-            !Utf::IsOutOfRange(ch) && !IsNonShortestForm(ch, j))) {
+    int8_t num_trail_bytes = kTrailBytes[ch];
+    bool is_malformed = false;
+    for (; j < num_trail_bytes; ++j) {
+      if ((i + j) < array_len) {
+        uint8_t code_unit = utf8_array[i + j];
+        is_malformed |= !IsTrailByte(code_unit);
+        ch = (ch << 6) + code_unit;
+      } else {
         return false;
       }
     }
+    ch -= kMagicBits[num_trail_bytes];
+    if (!((is_malformed == false) && (j == num_trail_bytes) &&
+          !Utf::IsOutOfRange(ch) && !IsNonShortestForm(ch, j))) {
+      return false;
+    }
     i += j;
   }
   return true;
@@ -197,16 +233,24 @@ bool Utf8::DecodeToLatin1(const uint8_t* utf8_array,
                           intptr_t len) {
   intptr_t i = 0;
   intptr_t j = 0;
-  intptr_t num_bytes;
-  for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+  while ((i < array_len) && (j < len)) {
+    if (utf8_array[i] <= kMaxOneByteChar) {
+      // Copy a run of ASCII characters at once.
+      const intptr_t count = AsciiPrefixLength(
+          &utf8_array[i], Utils::Minimum(array_len - i, len - j));
+      memmove(&dst[j], &utf8_array[i], count);
+      i += count;
+      j += count;
+      continue;
+    }
     int32_t ch;
     ASSERT(IsLatin1SequenceStart(utf8_array[i]));
-    num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
+    i += Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
     if (ch == -1) {
       return false;  // Invalid input.
     }
     ASSERT(Utf::IsLatin1(ch));
-    dst[j] = ch;
+    dst[j++] = ch;
   }
   if ((i < array_len) && (j == len)) {
     return false;  // Output overflow.
@@ -220,20 +264,30 @@ bool Utf8::DecodeToUTF16(const uint8_t* utf8_array,
                          intptr_t len) {
   intptr_t i = 0;
   intptr_t j = 0;
-  intptr_t num_bytes;
-  for (; (i < array_len) && (j < len); i += num_bytes, ++j) {
+  while ((i < array_len) && (j < len)) {
+    if (utf8_array[i] <= kMaxOneByteChar) {
+      // Widen a run of ASCII characters at once.
+      const intptr_t count = AsciiPrefixLength(
+          &utf8_array[i], Utils::Minimum(array_len - i, len - j));
+      for (intptr_t k = 0; k < count; k++) {
+        dst[j + k] = utf8_array[i + k];
+      }
+      i += count;
+      j += count;
+      continue;
+    }
     int32_t ch;
     bool is_supplementary = IsSupplementarySequenceStart(utf8_array[i]);
-    num_bytes = Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
+    i += Utf8::Decode(&utf8_array[i], (array_len - i), &ch);
     if (ch == -1) {
       return false;  // Invalid input.
     }
     if (is_supplementary) {
       if (j == (len - 1)) return false;  // Output overflow.
       Utf16::Encode(ch, &dst[j]);
-      j = j + 1;
+      j = j + 2;
     } else {
-      dst[j] = ch;
+      dst[j++] = ch;
     }
   }
   if ((i < array_len) && (j == len)) {
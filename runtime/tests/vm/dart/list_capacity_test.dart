@@ -0,0 +1,86 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests reserving and releasing the capacity of growable lists, and growing
+// them in place.
+
+import 'dart:_internal' show reserveListCapacity, shrinkListToFit;
+
+import "package:expect/expect.dart";
+
+void testReserve() {
+  final list = <int>[1, 2, 3];
+  reserveListCapacity(list, 1000);
+  Expect.listEquals([1, 2, 3], list);
+  for (var i = 4; i <= 1000; i++) {
+    list.add(i);
+  }
+  Expect.equals(1000, list.length);
+  for (var i = 0; i < 1000; i++) {
+    Expect.equals(i + 1, list[i]);
+  }
+  // Smaller capacities and other lists are left alone.
+  reserveListCapacity(list, 10);
+  Expect.equals(1000, list.length);
+  final fixed = new List<int>.filled(3, 0);
+  reserveListCapacity(fixed, 100);
+  Expect.equals(3, fixed.length);
+  Expect.throwsRangeError(() => reserveListCapacity(<int>[], -1));
+}
+
+void testShrink() {
+  final list = <Object>[];
+  for (var i = 0; i < 1000; i++) {
+    list.add("$i");
+  }
+  list.length = 600;
+  shrinkListToFit(list);
+  Expect.equals(600, list.length);
+  for (var i = 0; i < 600; i++) {
+    Expect.equals("$i", list[i]);
+  }
+  list.add("600");
+  Expect.equals("600", list[600]);
+
+  list.clear();
+  shrinkListToFit(list);
+  Expect.isTrue(list.isEmpty);
+  list.add("x");
+  Expect.listEquals(["x"], list);
+}
+
+void testGrowInPlace() {
+  // Nothing else is allocated between the growth steps, so the backing store
+  // can be extended where it is.
+  final list = <int>[];
+  for (var i = 0; i < 100000; i++) {
+    list.add(i);
+  }
+  var sum = 0;
+  for (var i = 0; i < list.length; i++) {
+    Expect.equals(i, list[i]);
+    sum += list[i];
+  }
+  Expect.equals(99999 * 100000 ~/ 2, sum);
+
+  // Lists growing alternately must not share storage.
+  final a = <int>[];
+  final b = <int>[];
+  for (var i = 0; i < 1000; i++) {
+    a.add(i);
+    b.add(-i);
+  }
+  for (var i = 0; i < 1000; i++) {
+    Expect.equals(i, a[i]);
+    Expect.equals(-i, b[i]);
+  }
+}
+
+main() {
+  for (var i = 0; i < 20; i++) {
+    testReserve();
+    testShrink();
+    testGrowInPlace();
+  }
+}
@@ -16,8 +16,12 @@
 #include "platform/utils.h"
 
 #include "vm/clustered_snapshot.h"
+#include "vm/code_descriptors.h"
 #include "vm/dart_api_impl.h"
+#include "vm/heap/freelist.h"
+#include "vm/heap/heap.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_pool.h"
 #include "vm/timer.h"
 
 using dart::bin::File;
@@ -500,6 +504,39 @@ BENCHMARK(FrameLookup) {
   benchmark->set_score(elapsed_time);
 }
 
+// Measure pc to token position lookups in a large PcDescriptors table, as
+// done when symbolizing stack traces and finding exception handlers.
+BENCHMARK(PcDescriptorsLookup) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kNumDescriptors = 1000;
+  DescriptorList* list = new DescriptorList(kNumDescriptors * 4);
+  for (intptr_t i = 0; i < kNumDescriptors; i++) {
+    list->AddDescriptor(PcDescriptorsLayout::kOther, i * 12, i,
+                        TokenPosition(i * 7), i % 3 - 1,
+                        PcDescriptorsLayout::kInvalidYieldIndex);
+  }
+  const PcDescriptors& descriptors =
+      PcDescriptors::Handle(list->FinalizePcDescriptors(0));
+  Timer timer(true, "PcDescriptors lookup benchmark");
+  timer.Start();
+  intptr_t found = 0;
+  for (intptr_t i = 0; i < kNumDescriptors; i++) {
+    PcDescriptors::Iterator iter(descriptors, PcDescriptorsLayout::kAnyKind);
+    while (iter.MoveNext()) {
+      if (iter.PcOffset() == static_cast<uword>(i * 12)) {
+        found++;
+        break;
+      }
+    }
+  }
+  timer.Stop();
+  EXPECT_EQ(kNumDescriptors, found);
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 static uint8_t* malloc_allocator(uint8_t* ptr,
                                  intptr_t old_size,
                                  intptr_t new_size) {
@@ -734,6 +771,142 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure free list allocation of medium-sized objects from a heap
+// fragmented into many free elements of varying size.
+//
+BENCHMARK(FreeListFragmented) {
+  const intptr_t kNumElements = 4096;
+  const intptr_t kMaxElementSize = 4 * KB;
+  const intptr_t kLoopCount = 100;
+  std::unique_ptr<VirtualMemory> region(
+      VirtualMemory::Allocate(kNumElements * kMaxElementSize,
+                              /*is_executable=*/false, "benchmark"));
+  FreeList free_list;
+  Timer timer(true, "FreeList Fragmented");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    free_list.Reset();
+    for (intptr_t j = 0; j < kNumElements; j++) {
+      intptr_t size = ((j * 13) % kMaxElementSize) + kObjectAlignment;
+      size = Utils::RoundDown(size, kObjectAlignment);
+      free_list.Free(region->start() + j * kMaxElementSize, size);
+    }
+    while (free_list.TryAllocate(2 * KB, /*is_protected=*/false) != 0) {
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+//
+// Measure scavenges of a new space in which a given percentage of the
+// allocated objects is still reachable.
+//
+static void ScavengeBenchmark(Benchmark* benchmark,
+                              Thread* thread,
+                              intptr_t survival_percentage) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kNumObjects = 20000;
+  const intptr_t kLoopCount = 50;
+  const Array& survivors = Array::Handle(Array::New(kNumObjects, Heap::kOld));
+  Array& element = Array::Handle();
+  int64_t elapsed_time = 0;
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    for (intptr_t j = 0; j < kNumObjects; j++) {
+      element = Array::New(4);
+      if ((j % 100) < survival_percentage) {
+        survivors.SetAt(j, element);
+      }
+    }
+    Timer timer(true, "Scavenge");
+    timer.Start();
+    GCTestHelper::CollectNewSpace();
+    timer.Stop();
+    elapsed_time += timer.TotalElapsedTime();
+    for (intptr_t j = 0; j < kNumObjects; j++) {
+      survivors.SetAt(j, Object::null_object());
+    }
+  }
+  benchmark->set_score(elapsed_time);
+}
+
+BENCHMARK(ScavengeLowSurvival) {
+  ScavengeBenchmark(benchmark, thread, 5);
+}
+
+BENCHMARK(ScavengeHighSurvival) {
+  ScavengeBenchmark(benchmark, thread, 50);
+}
+
+//
+// Measure full mark-sweep collections of an old space holding many small
+// live objects.
+//
+BENCHMARK(MarkSweepLiveArrays) {
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const intptr_t kNumObjects = 200000;
+  const intptr_t kLoopCount = 10;
+  const Array& roots = Array::Handle(Array::New(kNumObjects, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumObjects; i++) {
+    element = Array::New(2, Heap::kOld);
+    element.SetAt(0, roots);
+    roots.SetAt(i, element);
+  }
+  Timer timer(true, "Mark Sweep");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    GCTestHelper::CollectOldSpace();
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+class PingTask : public ThreadPool::Task {
+ public:
+  PingTask(Monitor* monitor, bool* done) : monitor_(monitor), done_(done) {}
+
+  virtual void Run() {
+    MonitorLocker ml(monitor_);
+    *done_ = true;
+    ml.Notify();
+  }
+
+ private:
+  Monitor* monitor_;
+  bool* done_;
+};
+
+//
+// Measure the round trip of handing a task to a thread pool and waiting
+// for it to run.
+//
+BENCHMARK(ThreadPoolTaskLatency) {
+  const intptr_t kLoopCount = 10000;
+  ThreadPool thread_pool;
+  Monitor monitor;
+  Timer timer(true, "ThreadPool Task Latency");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    bool done = false;
+    thread_pool.Run<PingTask>(&monitor, &done);
+    MonitorLocker ml(&monitor);
+    while (!done) {
+      ml.Wait();
+    }
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
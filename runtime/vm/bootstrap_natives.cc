@@ -31,6 +31,36 @@ static struct NativeEntries {
 #endif  // !DART_PRECOMPILED_RUNTIME
 };
 
+static const intptr_t kNumBootStrapEntries =
+    sizeof(BootStrapEntries) / sizeof(struct NativeEntries);
+
+// Open addressing hash table from native names to their index in
+// BootStrapEntries plus one, with zero marking an empty slot. Kept at most
+// half full so that probe sequences stay short.
+static const intptr_t kLookupTableSize = 2048;
+COMPILE_ASSERT((kLookupTableSize & (kLookupTableSize - 1)) == 0);
+COMPILE_ASSERT(2 * kNumBootStrapEntries <= kLookupTableSize);
+COMPILE_ASSERT(kNumBootStrapEntries < kMaxUint16);
+static uint16_t lookup_table[kLookupTableSize];
+
+static intptr_t LookupTableStart(const char* name) {
+  return Utils::StringHash(name, strlen(name)) & (kLookupTableSize - 1);
+}
+
+void BootstrapNatives::Init() {
+  if (lookup_table[LookupTableStart(BootStrapEntries[0].name_)] != 0) {
+    // Already built by an earlier Dart_Initialize.
+    return;
+  }
+  for (intptr_t i = 0; i < kNumBootStrapEntries; i++) {
+    intptr_t slot = LookupTableStart(BootStrapEntries[i].name_);
+    while (lookup_table[slot] != 0) {
+      slot = (slot + 1) & (kLookupTableSize - 1);
+    }
+    lookup_table[slot] = i + 1;
+  }
+}
+
 Dart_NativeFunction BootstrapNatives::Lookup(Dart_Handle name,
                                              int argument_count,
                                              bool* auto_setup_scope) {
@@ -44,9 +74,9 @@ Dart_NativeFunction BootstrapNatives::Lookup(Dart_Handle name,
   *auto_setup_scope = false;
   const char* function_name = obj.ToCString();
   ASSERT(function_name != NULL);
-  int num_entries = sizeof(BootStrapEntries) / sizeof(struct NativeEntries);
-  for (int i = 0; i < num_entries; i++) {
-    struct NativeEntries* entry = &(BootStrapEntries[i]);
+  for (intptr_t slot = LookupTableStart(function_name);
+       lookup_table[slot] != 0; slot = (slot + 1) & (kLookupTableSize - 1)) {
+    struct NativeEntries* entry = &(BootStrapEntries[lookup_table[slot] - 1]);
     if ((strcmp(function_name, entry->name_) == 0) &&
         (entry->argument_count_ == argument_count)) {
       return reinterpret_cast<Dart_NativeFunction>(entry->function_);
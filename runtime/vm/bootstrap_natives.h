@@ -101,6 +101,10 @@ namespace dart {
   V(Double_truncate, 1)                                                        \
   V(Double_toInt, 1)                                                           \
   V(Double_parse, 3)                                                           \
+  V(Double_parseBytes, 3)                                                      \
+  V(Json_parse, 1)                                                             \
+  V(Json_encodeUtf8, 1)                                                        \
+  V(Utf8Encoder_convert, 1)                                                    \
   V(Double_toString, 1)                                                        \
   V(Double_toStringAsFixed, 2)                                                 \
   V(Double_toStringAsExponential, 2)                                           \
@@ -122,6 +126,7 @@ namespace dart {
   V(List_setIndexed, 3)                                                        \
   V(List_getLength, 1)                                                         \
   V(List_slice, 4)                                                             \
+  V(List_copyRange, 5)                                                         \
   V(ImmutableList_from, 4)                                                     \
   V(StringBase_createFromCodePoints, 3)                                        \
   V(StringBase_substringUnchecked, 3)                                          \
@@ -193,6 +198,8 @@ namespace dart {
   V(TypedData_Float64x2Array_new, 2)                                           \
   V(TypedData_length, 1)                                                       \
   V(TypedData_setRange, 7)                                                     \
+  V(TypedData_fillRange, 4)                                                    \
+  V(TypedData_indexOf, 6)                                                      \
   V(TypedData_GetInt8, 2)                                                      \
   V(TypedData_SetInt8, 3)                                                      \
   V(TypedData_GetUint8, 2)                                                     \
@@ -333,10 +340,13 @@ namespace dart {
   V(GrowableList_getCapacity, 1)                                               \
   V(GrowableList_setLength, 2)                                                 \
   V(GrowableList_setData, 2)                                                   \
+  V(GrowableList_tryGrowInPlace, 2)                                            \
   V(Internal_unsafeCast, 1)                                                    \
   V(Internal_reachabilityFence, 1)                                             \
   V(Internal_collectAllGarbage, 0)                                             \
   V(Internal_makeListFixedLength, 1)                                           \
+  V(Internal_reserveListCapacity, 2)                                           \
+  V(Internal_shrinkListToFit, 1)                                               \
   V(Internal_makeFixedListUnmodifiable, 1)                                     \
   V(Internal_inquireIs64Bit, 0)                                                \
   V(Internal_extractTypeArguments, 2)                                          \
@@ -408,8 +418,18 @@ namespace dart {
   V(Ffi_fromAddress, 1)                                                        \
   V(Ffi_sizeOf, 0)                                                             \
   V(Ffi_asFunctionInternal, 1)                                                 \
+  V(Ffi_asLeafFunctionInternal, 1)                                             \
+  V(Ffi_asLazyFunctionInternal, 2)                                             \
+  V(Ffi_asLazyLeafFunctionInternal, 2)                                         \
+  V(Ffi_resolveLazyFunction, 1)                                                \
   V(Ffi_nativeCallbackFunction, 2)                                             \
   V(Ffi_pointerFromFunction, 1)                                                \
+  V(Ffi_asyncCallbackCreate, 1)                                                \
+  V(Ffi_asyncCallbackAddress, 2)                                               \
+  V(Ffi_asyncCallbackDequeue, 2)                                               \
+  V(Ffi_asyncCallbackDelete, 2)                                                \
+  V(Ffi_arenaNewSegment, 2)                                                    \
+  V(Ffi_arenaDeleteSegments, 1)                                                \
   V(Ffi_dl_open, 1)                                                            \
   V(Ffi_dl_lookup, 2)                                                          \
   V(Ffi_dl_getHandle, 1)                                                       \
@@ -423,6 +443,8 @@ namespace dart {
   V(TransferableTypedData_factory, 2)                                          \
   V(TransferableTypedData_materialize, 1)                                      \
   V(Wasm_initModule, 2)                                                        \
+  V(Wasm_deserializeModule, 2)                                                 \
+  V(Wasm_serializeModule, 1)                                                   \
   V(Wasm_describeModule, 1)                                                    \
   V(Wasm_initImports, 1)                                                       \
   V(Wasm_addMemoryImport, 4)                                                   \
@@ -434,7 +456,12 @@ namespace dart {
   V(Wasm_initMemoryFromInstance, 2)                                            \
   V(Wasm_getMemoryPages, 1)                                                    \
   V(Wasm_initFunction, 4)                                                      \
-  V(Wasm_callFunction, 2)
+  V(Wasm_callFunction, 2)                                                      \
+  V(Wasm_callFunction0, 1)                                                     \
+  V(Wasm_callFunction1, 2)                                                     \
+  V(Wasm_callFunction2, 3)                                                     \
+  V(Wasm_callFunction3, 4)                                                     \
+  V(Wasm_callFunction4, 5)
 
 // List of bootstrap native entry points used in the dart:mirror library.
 #define MIRRORS_BOOTSTRAP_NATIVE_LIST(V)                                       \
@@ -491,6 +518,9 @@ namespace dart {
 
 class BootstrapNatives : public AllStatic {
  public:
+  // Builds the name index used by Lookup.
+  static void Init();
+
   static Dart_NativeFunction Lookup(Dart_Handle name,
                                     int argument_count,
                                     bool* auto_setup_scope);
@@ -35,6 +35,10 @@
 #include "vm/compiler/relocation.h"
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+#if defined(DART_PRECOMPILER)
+#include "vm/compiler/aot/call_profile.h"
+#endif  // defined(DART_PRECOMPILER)
+
 namespace dart {
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -49,10 +53,27 @@ DEFINE_FLAG(charp,
             write_v8_snapshot_profile_to,
             NULL,
             "Write a snapshot profile in V8 format to a file.");
+DEFINE_FLAG(charp,
+            code_order_profile,
+            NULL,
+            "Place the code of functions that call each other most often in "
+            "the given call profile (written with --pprof-dir) next to each "
+            "other in AOT snapshots.");
 #endif  // defined(DART_PRECOMPILER)
 
 #if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
 
+static void OrderCodeObjects(GrowableArray<CodePtr>* code_objects) {
+  std::unique_ptr<CallProfile> profile(
+      CallProfile::ReadFrom(FLAG_code_order_profile));
+  if (profile == nullptr) {
+    OS::PrintErr("Could not read code order profile '%s'\n",
+                 FLAG_code_order_profile);
+    return;
+  }
+  profile->OrderCode(code_objects);
+}
+
 static void RelocateCodeObjects(
     bool is_vm,
     GrowableArray<CodePtr>* code_objects,
@@ -713,6 +734,7 @@ class FunctionDeserializationCluster : public DeserializationCluster {
         func->ptr()->deoptimization_counter_ = 0;
         func->ptr()->state_bits_ = 0;
         func->ptr()->inlining_depth_ = 0;
+        func->ptr()->non_escaping_parameters_ = 0;
 #endif
       }
     }
@@ -933,6 +955,8 @@ class FfiTrampolineDataSerializationCluster : public SerializationCluster {
         // FFI callbacks can only be written to AOT snapshots.
         ASSERT(data->ptr()->callback_target_ == Object::null());
       }
+      s->Write<bool>(data->ptr()->is_leaf_);
+      s->Write<bool>(data->ptr()->is_lazy_);
     }
   }
 
@@ -965,6 +989,8 @@ class FfiTrampolineDataDeserializationCluster : public DeserializationCluster {
       ReadFromTo(data);
       data->ptr()->callback_id_ =
           d->kind() == Snapshot::kFullAOT ? d->ReadUnsigned() : 0;
+      data->ptr()->is_leaf_ = d->Read<bool>();
+      data->ptr()->is_lazy_ = d->Read<bool>();
     }
   }
 };
@@ -1360,6 +1386,7 @@ class LibraryDeserializationCluster : public DeserializationCluster {
       ReadFromTo(lib);
       lib->ptr()->native_entry_resolver_ = NULL;
       lib->ptr()->native_entry_symbol_resolver_ = NULL;
+      lib->ptr()->ffi_native_resolver_ = NULL;
       lib->ptr()->index_ = d->Read<int32_t>();
       lib->ptr()->num_imports_ = d->Read<uint16_t>();
       lib->ptr()->load_state_ = d->Read<int8_t>();
@@ -5656,6 +5683,11 @@ SerializationCluster* Serializer::NewClusterForClass(intptr_t cid) {
       return new (Z) RODataSerializationCluster(Z, type, cid);
     }
   }
+  // Boxes of unboxed fields are updated in place in JIT mode, so doubles can
+  // only be shared from the read-only image in AOT snapshots.
+  if ((kind_ == Snapshot::kFullAOT) && (cid == kDoubleCid)) {
+    return new (Z) RODataSerializationCluster(Z, "double", cid);
+  }
 
   switch (cid) {
     case kClassCid:
@@ -5784,6 +5816,12 @@ bool Serializer::InCurrentLoadingUnit(ObjectPtr obj, bool record) {
 void Serializer::PrepareInstructions(GrowableArray<CodePtr>* code_objects) {
 #if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
   if ((kind() == Snapshot::kFullAOT) && FLAG_use_bare_instructions) {
+    // The code of a deferred unit is written in the order of the unit's
+    // deferred objects, which the text offsets have to follow.
+    if (!vm_ && (FLAG_code_order_profile != NULL) &&
+        (current_loading_unit_id_ <= LoadingUnit::kRootId)) {
+      OrderCodeObjects(code_objects);
+    }
     GrowableArray<ImageWriterCommand> writer_commands;
     RelocateCodeObjects(vm_, code_objects, &writer_commands);
     image_writer_->PrepareForSerialization(&writer_commands);
@@ -6357,6 +6395,9 @@ DeserializationCluster* Deserializer::ReadCluster() {
         return new (Z) RODataDeserializationCluster();
     }
   }
+  if ((kind_ == Snapshot::kFullAOT) && (cid == kDoubleCid)) {
+    return new (Z) RODataDeserializationCluster();
+  }
 
   switch (cid) {
     case kClassCid:
@@ -6788,24 +6829,30 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
              num_base_objects_, next_ref_index_ - kFirstReference);
     }
 
-    for (intptr_t i = 0; i < num_clusters_; i++) {
-      clusters_[i] = ReadCluster();
-      clusters_[i]->ReadAlloc(this);
+    {
+      TIMELINE_DURATION(thread(), Isolate, "ReadAlloc");
+      for (intptr_t i = 0; i < num_clusters_; i++) {
+        clusters_[i] = ReadCluster();
+        clusters_[i]->ReadAlloc(this);
 #if defined(DEBUG)
-      intptr_t serializers_next_ref_index_ = Read<int32_t>();
-      ASSERT_EQUAL(serializers_next_ref_index_, next_ref_index_);
+        intptr_t serializers_next_ref_index_ = Read<int32_t>();
+        ASSERT_EQUAL(serializers_next_ref_index_, next_ref_index_);
 #endif
+      }
     }
 
     // We should have completely filled the ref array.
     ASSERT_EQUAL(next_ref_index_ - kFirstReference, num_objects_);
 
-    for (intptr_t i = 0; i < num_clusters_; i++) {
-      clusters_[i]->ReadFill(this);
+    {
+      TIMELINE_DURATION(thread(), Isolate, "ReadFill");
+      for (intptr_t i = 0; i < num_clusters_; i++) {
+        clusters_[i]->ReadFill(this);
 #if defined(DEBUG)
-    int32_t section_marker = Read<int32_t>();
-    ASSERT(section_marker == kSectionMarker);
+        int32_t section_marker = Read<int32_t>();
+        ASSERT(section_marker == kSectionMarker);
 #endif
+      }
     }
 
     roots->ReadRoots(this);
@@ -657,6 +657,65 @@ void CodeSourceMapReader::GetInlinedFunctionsAt(
   }
 }
 
+void CodeSourceMapReader::GetSourcePositions(
+    GrowableArray<intptr_t>* pc_offsets,
+    GrowableArray<const Function*>* functions,
+    GrowableArray<TokenPosition>* positions) {
+  GrowableArray<const Function*> function_stack;
+  GrowableArray<TokenPosition> token_positions;
+  NoSafepointScope no_safepoint;
+  ReadStream stream(map_.Data(), map_.Length());
+
+  int32_t current_pc_offset = 0;
+  function_stack.Add(&root_);
+  token_positions.Add(CodeSourceMapBuilder::kInitialPosition);
+
+  while (stream.PendingBytes() > 0) {
+    uint8_t opcode = stream.Read<uint8_t>();
+    switch (opcode) {
+      case CodeSourceMapBuilder::kChangePosition: {
+        token_positions[token_positions.length() - 1] = ReadPosition(&stream);
+        break;
+      }
+      case CodeSourceMapBuilder::kAdvancePC: {
+        int32_t delta = stream.Read<int32_t>();
+        const Function* function = function_stack.Last();
+        const TokenPosition position = token_positions.Last();
+        // Only record where the innermost position changes.
+        if (functions->is_empty() || (functions->Last() != function) ||
+            (positions->Last() != position)) {
+          pc_offsets->Add(current_pc_offset);
+          functions->Add(function);
+          positions->Add(position);
+        }
+        current_pc_offset += delta;
+        break;
+      }
+      case CodeSourceMapBuilder::kPushFunction: {
+        int32_t func = stream.Read<int32_t>();
+        function_stack.Add(
+            &Function::Handle(Function::RawCast(functions_.At(func))));
+        token_positions.Add(CodeSourceMapBuilder::kInitialPosition);
+        break;
+      }
+      case CodeSourceMapBuilder::kPopFunction: {
+        // We never pop the root function.
+        ASSERT(function_stack.length() > 1);
+        ASSERT(token_positions.length() > 1);
+        function_stack.RemoveLast();
+        token_positions.RemoveLast();
+        break;
+      }
+      case CodeSourceMapBuilder::kNullCheck: {
+        stream.Read<int32_t>();
+        break;
+      }
+      default:
+        UNREACHABLE();
+    }
+  }
+}
+
 #ifndef PRODUCT
 void CodeSourceMapReader::PrintJSONInlineIntervals(JSONObject* jsobj) {
   {
@@ -874,6 +933,58 @@ intptr_t CodeSourceMapReader::GetNullCheckNameIndexAt(int32_t pc_offset) {
   return -1;
 }
 
+CodeSourceMapPtr CodeSourceMapReader::WithoutPositions() {
+  uint8_t* buffer = nullptr;
+  WriteStream new_stream(&buffer, ZoneAllocator, 64);
+  {
+    NoSafepointScope no_safepoint;
+    ReadStream stream(map_.Data(), map_.Length());
+
+    // Advances which are only separated by position changes are merged.
+    int32_t pending_pc_delta = 0;
+    while (stream.PendingBytes() > 0) {
+      uint8_t opcode = stream.Read<uint8_t>();
+      if (opcode == CodeSourceMapBuilder::kChangePosition) {
+        ReadPosition(&stream);
+        continue;
+      }
+      if (opcode == CodeSourceMapBuilder::kAdvancePC) {
+        pending_pc_delta += stream.Read<int32_t>();
+        continue;
+      }
+      if (pending_pc_delta != 0) {
+        new_stream.Write<uint8_t>(CodeSourceMapBuilder::kAdvancePC);
+        new_stream.Write<int32_t>(pending_pc_delta);
+        pending_pc_delta = 0;
+      }
+      switch (opcode) {
+        case CodeSourceMapBuilder::kPushFunction:
+        case CodeSourceMapBuilder::kNullCheck: {
+          new_stream.Write<uint8_t>(opcode);
+          new_stream.Write<int32_t>(stream.Read<int32_t>());
+          break;
+        }
+        case CodeSourceMapBuilder::kPopFunction: {
+          new_stream.Write<uint8_t>(opcode);
+          break;
+        }
+        default:
+          UNREACHABLE();
+      }
+    }
+    if (pending_pc_delta != 0) {
+      new_stream.Write<uint8_t>(CodeSourceMapBuilder::kAdvancePC);
+      new_stream.Write<int32_t>(pending_pc_delta);
+    }
+  }
+
+  const intptr_t length = new_stream.bytes_written();
+  const auto& map = CodeSourceMap::Handle(CodeSourceMap::New(length));
+  NoSafepointScope no_safepoint;
+  memmove(map.Data(), buffer, length);
+  return map.raw();
+}
+
 TokenPosition CodeSourceMapReader::ReadPosition(ReadStream* stream) {
   const intptr_t line = stream->Read<int32_t>();
 #if defined(DART_PRECOMPILER)
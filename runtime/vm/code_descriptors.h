@@ -354,12 +354,22 @@ class CodeSourceMapReader : public ValueObject {
   void GetInlinedFunctionsAt(int32_t pc_offset,
                              GrowableArray<const Function*>* function_stack,
                              GrowableArray<TokenPosition>* token_positions);
+  // Returns the innermost function and position at the start of each range
+  // of pc offsets, so that inlined code is attributed to its own source.
+  void GetSourcePositions(GrowableArray<intptr_t>* pc_offsets,
+                          GrowableArray<const Function*>* functions,
+                          GrowableArray<TokenPosition>* positions);
   NOT_IN_PRODUCT(void PrintJSONInlineIntervals(JSONObject* jsobj));
   void DumpInlineIntervals(uword start);
   void DumpSourcePositions(uword start);
 
   intptr_t GetNullCheckNameIndexAt(int32_t pc_offset);
 
+  // Returns a copy of the map without its source positions. It still records
+  // the inlined functions and null checks at each pc offset, so stack traces
+  // through the code show all frames, only without line numbers.
+  CodeSourceMapPtr WithoutPositions();
+
  private:
   // Reads a TokenPosition value from a CSM, handling the different encoding for
   // when non-symbolic stack traces are enabled.
@@ -167,4 +167,51 @@ ISOLATE_UNIT_TEST_CASE(DescriptorList_TokenPositions) {
   }
 }
 
+static uint8_t* ZoneAllocator(uint8_t* ptr,
+                              intptr_t old_size,
+                              intptr_t new_size) {
+  Zone* zone = Thread::Current()->zone();
+  return zone->Realloc<uint8_t>(ptr, old_size, new_size);
+}
+
+ISOLATE_UNIT_TEST_CASE(CodeSourceMap_WithoutPositions) {
+  uint8_t* buffer = nullptr;
+  WriteStream stream(&buffer, ZoneAllocator, 64);
+  stream.Write<uint8_t>(CodeSourceMapBuilder::kChangePosition);
+  stream.Write<int32_t>(5);
+  stream.Write<uint8_t>(CodeSourceMapBuilder::kAdvancePC);
+  stream.Write<int32_t>(4);
+  stream.Write<uint8_t>(CodeSourceMapBuilder::kChangePosition);
+  stream.Write<int32_t>(7);
+  stream.Write<uint8_t>(CodeSourceMapBuilder::kAdvancePC);
+  stream.Write<int32_t>(4);
+  stream.Write<uint8_t>(CodeSourceMapBuilder::kNullCheck);
+  stream.Write<int32_t>(3);
+  stream.Write<uint8_t>(CodeSourceMapBuilder::kAdvancePC);
+  stream.Write<int32_t>(8);
+  const intptr_t length = stream.bytes_written();
+  const auto& map = CodeSourceMap::Handle(CodeSourceMap::New(length));
+  {
+    NoSafepointScope no_safepoint;
+    memmove(map.Data(), buffer, length);
+  }
+
+  CodeSourceMapReader reader(map, Object::null_array(),
+                             Function::null_function());
+  const auto& stripped = CodeSourceMap::Handle(reader.WithoutPositions());
+  // Both position changes are dropped and the advances around the second one
+  // are merged, leaving three entries of two bytes each.
+  EXPECT_EQ(12, length);
+  EXPECT_EQ(6, stripped.Length());
+
+  CodeSourceMapReader stripped_reader(stripped, Object::null_array(),
+                                      Function::null_function());
+  EXPECT_EQ(3, stripped_reader.GetNullCheckNameIndexAt(8));
+  GrowableArray<const Function*> functions;
+  GrowableArray<TokenPosition> positions;
+  stripped_reader.GetInlinedFunctionsAt(6, &functions, &positions);
+  EXPECT_EQ(1, functions.length());
+  EXPECT(positions[0] == CodeSourceMapBuilder::kInitialPosition);
+}
+
 }  // namespace dart
@@ -30,6 +30,22 @@ class CodeComments : public ValueObject {
 
 #if !defined(PRODUCT)
 
+// An abstract representation of the source positions of the given code
+// object, including those of inlined functions. We assume that positions are
+// sorted by PCOffset and that each one holds until the next.
+class CodeSourcePositions : public ValueObject {
+ public:
+  CodeSourcePositions() = default;
+  virtual ~CodeSourcePositions() = default;
+
+  virtual intptr_t Length() const = 0;
+  virtual intptr_t PCOffsetAt(intptr_t index) const = 0;
+  // The path or URL of the script.
+  virtual const char* FileAt(intptr_t index) const = 0;
+  virtual intptr_t LineAt(intptr_t index) const = 0;
+  virtual intptr_t ColumnAt(intptr_t index) const = 0;
+};
+
 // Object observing code creation events. Used by external profilers and
 // debuggers to map address ranges to function names.
 class CodeObserver {
@@ -43,13 +59,14 @@ class CodeObserver {
   virtual bool IsActive() const = 0;
 
   // Notify code observer about a newly created code object with the
-  // given properties.
+  // given properties. |positions| is NULL for stubs.
   virtual void Notify(const char* name,
                       uword base,
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) = 0;
+                      const CodeComments* comments,
+                      const CodeSourcePositions* positions) = 0;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeObserver);
@@ -71,7 +88,8 @@ class CodeObservers : public AllStatic {
                         uword prologue_offset,
                         uword size,
                         bool optimized,
-                        const CodeComments* comments);
+                        const CodeComments* comments,
+                        const CodeSourcePositions* positions);
 
   // Returns true if there is at least one active code observer.
   static bool AreActive();
@@ -18,6 +18,11 @@ namespace dart {
 #if !defined(DART_PRECOMPILED_RUNTIME)
 
 DEFINE_FLAG(bool, trace_compilation_trace, false, "Trace compilation trace.");
+DEFINE_FLAG(bool,
+            optimize_type_feedback_in_background,
+            false,
+            "Queue the functions made hot by loaded type feedback for the "
+            "background compiler instead of optimizing them before returning.");
 
 CompilationTraceSaver::CompilationTraceSaver(Zone* zone)
     : buf_(zone, 1 * MB),
@@ -438,7 +443,8 @@ TypeFeedbackSaver::TypeFeedbackSaver(WriteStream* stream)
       field_(Field::Handle()),
       code_(Code::Handle()),
       call_sites_(Array::Handle()),
-      call_site_(ICData::Handle()) {}
+      call_site_(ICData::Handle()),
+      edge_counters_(Array::Handle()) {}
 
 // These flags affect deopt ids.
 static char* CompilerFlags() {
@@ -564,6 +570,18 @@ void TypeFeedbackSaver::VisitFunction(const Function& function) {
       }
     }
   }
+
+  if (call_sites_.Length() > 0) {
+    edge_counters_ ^= call_sites_.At(0);
+  } else {
+    edge_counters_ = Array::null();
+  }
+  const intptr_t num_edge_counters =
+      edge_counters_.IsNull() ? 0 : edge_counters_.Length();
+  WriteInt(num_edge_counters);
+  for (intptr_t i = 0; i < num_edge_counters; i++) {
+    WriteInt(Smi::Value(Smi::RawCast(edge_counters_.At(i))));
+  }
 }
 
 void TypeFeedbackSaver::WriteClassByName(const Class& cls) {
@@ -603,8 +621,10 @@ TypeFeedbackLoader::TypeFeedbackLoader(Thread* thread)
       target_name_(String::Handle(zone_)),
       target_(Function::Handle(zone_)),
       args_desc_(Array::Handle(zone_)),
+      counters_(Array::Handle(zone_)),
       functions_to_compile_(
           GrowableObjectArray::Handle(zone_, GrowableObjectArray::New())),
+      edge_counters_(nullptr),
       error_(Error::Handle(zone_)) {}
 
 TypeFeedbackLoader::~TypeFeedbackLoader() {
@@ -636,11 +656,25 @@ ObjectPtr TypeFeedbackLoader::LoadFeedback(ReadStream* stream) {
     }
   }
 
+  Isolate* isolate = thread_->isolate();
+  const bool in_background =
+      FLAG_optimize_type_feedback_in_background &&
+      FLAG_background_compilation &&
+      !BackgroundCompiler::IsDisabled(isolate,
+                                      /* optimizing_compiler = */ true);
   while (functions_to_compile_.Length() > 0) {
     func_ ^= functions_to_compile_.RemoveLast();
 
     if (Compiler::CanOptimizeFunction(thread_, func_) &&
         (func_.usage_counter() >= FLAG_optimization_counter_threshold)) {
+      if (in_background && func_.is_background_optimizable()) {
+        // The usage counter is left as it is, so that the feedback saved by
+        // this run still marks the function as hot. The background
+        // compilation queue rejects duplicate entries.
+        BackgroundCompiler::Start(isolate);
+        isolate->optimizing_background_compiler()->Compile(func_);
+        continue;
+      }
       error_ = Compiler::CompileOptimizedFunction(thread_, func_);
       if (error_.IsError()) {
         return error_.raw();
@@ -655,6 +689,42 @@ ObjectPtr TypeFeedbackLoader::LoadFeedback(ReadStream* stream) {
   return Error::null();
 }
 
+ObjectPtr TypeFeedbackLoader::LoadEdgeCounters(
+    ReadStream* stream,
+    const GrowableObjectArray& edge_counters) {
+  stream_ = stream;
+  edge_counters_ = &edge_counters;
+
+  error_ = CheckHeader();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  error_ = LoadClasses();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  error_ = LoadFields();
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+
+  while (stream_->PendingBytes() > 0) {
+    error_ = LoadFunction();
+    if (error_.IsError()) {
+      return error_.raw();
+    }
+  }
+
+  if (FLAG_trace_compilation_trace) {
+    THR_Print("Done loading edge counters for %" Pd " functions\n",
+              edge_counters.Length() / 2);
+  }
+
+  return Error::null();
+}
+
 ObjectPtr TypeFeedbackLoader::CheckHeader() {
   const char* expected_version = Version::SnapshotString();
   ASSERT(expected_version != NULL);
@@ -693,6 +763,13 @@ ObjectPtr TypeFeedbackLoader::CheckHeader() {
       reinterpret_cast<const char*>(stream_->AddressOfCurrentPosition());
   ASSERT(features != NULL);
   intptr_t buffer_len = Utils::StrNLen(features, stream_->PendingBytes());
+  if (edge_counters_ != nullptr) {
+    // Edge counters are indexed by block and do not depend on deopt ids, so
+    // feedback recorded by a JIT can be used by the precompiler.
+    free(expected_features);
+    stream_->Advance(buffer_len + 1);
+    return Error::null();
+  }
   if ((buffer_len != expected_len) ||
       (strncmp(features, expected_features, expected_len) != 0)) {
     const String& msg = String::Handle(String::NewFormatted(
@@ -735,6 +812,9 @@ ObjectPtr TypeFeedbackLoader::LoadFields() {
     cls_ = ReadClassByName();
     bool skip = cls_.IsNull();
 
+    // Field guards are not used by the precompiler.
+    skip = skip || (edge_counters_ != nullptr);
+
     intptr_t num_fields = ReadInt();
     if (!skip && (num_fields > 0)) {
       error_ = cls_.EnsureIsFinalized(thread_);
@@ -829,7 +909,9 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     }
   }
 
-  if (!skip) {
+  // Only the edge counters are used by the precompiler.
+  bool skip_call_sites = skip || (edge_counters_ != nullptr);
+  if (!skip_call_sites) {
     error_ = Compiler::CompileFunction(thread_, func_);
     if (error_.IsError()) {
       return error_.raw();
@@ -839,7 +921,7 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
       call_sites_ = Object::empty_array().raw();  // Remove edge case.
     }
     if (call_sites_.Length() != num_call_sites + 1) {
-      skip = true;
+      skip = skip_call_sites = true;
       if (FLAG_trace_compilation_trace) {
         THR_Print("Mismatched call site count %s %" Pd " %" Pd "\n",
                   func_name_.ToCString(), call_sites_.Length(), num_call_sites);
@@ -855,12 +937,12 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     intptr_t num_checked_arguments = ReadInt();
     intptr_t num_entries = ReadInt();
 
-    if (!skip) {
+    if (!skip_call_sites) {
       call_site_ ^= call_sites_.At(i);
       if ((call_site_.deopt_id() != deopt_id) ||
           (call_site_.rebind_rule() != rebind_rule) ||
           (call_site_.NumArgsTested() != num_checked_arguments)) {
-        skip = true;
+        skip = skip_call_sites = true;
         if (FLAG_trace_compilation_trace) {
           THR_Print("Mismatched call site %s\n", call_site_.ToCString());
         }
@@ -869,7 +951,7 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
 
     for (intptr_t entry_index = 0; entry_index < num_entries; entry_index++) {
       intptr_t entry_usage = ReadInt();
-      bool skip_entry = skip;
+      bool skip_entry = skip_call_sites;
       GrowableArray<intptr_t> cids(num_checked_arguments);
 
       for (intptr_t argument_index = 0; argument_index < num_checked_arguments;
@@ -912,6 +994,34 @@ ObjectPtr TypeFeedbackLoader::LoadFunction() {
     }
   }
 
+  const intptr_t num_edge_counters = ReadInt();
+  if (!skip && (edge_counters_ != nullptr)) {
+    counters_ = Array::New(num_edge_counters, Heap::kOld);
+    for (intptr_t i = 0; i < num_edge_counters; i++) {
+      counters_.SetAt(i, Smi::Handle(zone_, Smi::New(ReadInt())));
+    }
+    edge_counters_->Add(func_);
+    edge_counters_->Add(counters_);
+    return Error::null();
+  }
+  if (!skip) {
+    counters_ ^= call_sites_.At(0);
+    if (counters_.IsNull() || (counters_.Length() != num_edge_counters)) {
+      if (FLAG_trace_compilation_trace) {
+        THR_Print("Mismatched edge counter count %s %" Pd "\n",
+                  func_name_.ToCString(), num_edge_counters);
+      }
+      counters_ = Array::null();
+    }
+  }
+  for (intptr_t i = 0; i < num_edge_counters; i++) {
+    const intptr_t count = ReadInt();
+    if (!skip && !counters_.IsNull()) {
+      const intptr_t current = Smi::Value(Smi::RawCast(counters_.At(i)));
+      counters_.SetAt(i, Smi::Handle(zone_, Smi::New(current + count)));
+    }
+  }
+
   if (!skip) {
     func_.set_usage_counter(usage);
     func_.set_inlining_depth(inlining_depth);
@@ -88,6 +88,7 @@ class TypeFeedbackSaver : public FunctionVisitor {
   Code& code_;
   Array& call_sites_;
   ICData& call_site_;
+  Array& edge_counters_;
 };
 
 class TypeFeedbackLoader : public ValueObject {
@@ -97,6 +98,13 @@ class TypeFeedbackLoader : public ValueObject {
 
   ObjectPtr LoadFeedback(ReadStream* stream);
 
+  // Reads only the edge counters from the feedback and appends pairs of a
+  // function and its counters to [edge_counters]. Nothing is compiled and
+  // the feedback may come from a VM with different flags, so that the
+  // precompiler can use a profile recorded by a JIT to lay out blocks.
+  ObjectPtr LoadEdgeCounters(ReadStream* stream,
+                             const GrowableObjectArray& edge_counters);
+
  private:
   ObjectPtr CheckHeader();
   ObjectPtr LoadClasses();
@@ -127,7 +135,9 @@ class TypeFeedbackLoader : public ValueObject {
   String& target_name_;
   Function& target_;
   Array& args_desc_;
+  Array& counters_;
   GrowableObjectArray& functions_to_compile_;
+  const GrowableObjectArray* edge_counters_;
   Object& error_;
 };
 
@@ -0,0 +1,287 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if defined(DART_PRECOMPILER)
+
+#include "vm/compiler/aot/call_profile.h"
+
+#include "vm/dart.h"
+#include "vm/hash.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/zone_text_buffer.h"
+
+namespace dart {
+
+// Clusters of code are not grown beyond a page (Ottoni and Maher, "Optimizing
+// Function Placement for Large-Scale Data-Center Applications", CGO 2017).
+static const intptr_t kMaxClusterSize = 4 * KB;
+
+CallProfile* CallProfile::ReadFrom(const char* path) {
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    return nullptr;
+  }
+  void* file = file_open(path, /*write=*/false);
+  if (file == nullptr) {
+    return nullptr;
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t size = -1;
+  file_read(&buffer, &size, file);
+  file_close(file);
+  if (size < 0) {
+    return nullptr;
+  }
+
+  char* text = reinterpret_cast<char*>(malloc(size + 1));
+  memmove(text, buffer, size);
+  text[size] = '\0';
+  free(buffer);
+  CallProfile* profile = new CallProfile(text);
+  profile->Parse();
+  return profile;
+}
+
+CallProfile* CallProfile::FromString(const char* contents) {
+  CallProfile* profile = new CallProfile(Utils::StrDup(contents));
+  profile->Parse();
+  return profile;
+}
+
+CallProfile::~CallProfile() {
+  free(text_);
+}
+
+intptr_t CallProfile::CallTrait::Hashcode(Key key) {
+  return CombineHashes(CStringKeyValueTrait<int64_t>::Hashcode(key.caller),
+                       CStringKeyValueTrait<int64_t>::Hashcode(key.callee));
+}
+
+// Each line is "<samples>\t<caller>\t<callee>". Lines which don't have this
+// form are skipped.
+void CallProfile::Parse() {
+  char* line = text_;
+  while (*line != '\0') {
+    char* line_end = strchr(line, '\n');
+    if (line_end != nullptr) {
+      *line_end = '\0';
+    }
+    char* caller = strchr(line, '\t');
+    char* callee = (caller == nullptr) ? nullptr : strchr(caller + 1, '\t');
+    if (callee != nullptr) {
+      *caller++ = '\0';
+      *callee++ = '\0';
+      int64_t samples = 0;
+      if (OS::StringToInt64(line, &samples) && (samples > 0)) {
+        Call call = {caller, callee, samples};
+        Call* pair = calls_.Lookup(call);
+        if (pair != nullptr) {
+          pair->samples += samples;
+        } else {
+          calls_.Insert(call);
+        }
+        AddSamples(caller, samples);
+        if (strcmp(caller, callee) != 0) {
+          AddSamples(callee, samples);
+        }
+      }
+    }
+    if (line_end == nullptr) {
+      break;
+    }
+    line = line_end + 1;
+  }
+}
+
+void CallProfile::AddSamples(const char* function, int64_t samples) {
+  auto pair = functions_.Lookup(function);
+  if (pair != nullptr) {
+    pair->value += samples;
+  } else {
+    functions_.Insert({function, samples});
+  }
+}
+
+int64_t CallProfile::SamplesOf(const char* function) const {
+  auto pair = functions_.Lookup(function);
+  return (pair != nullptr) ? pair->value : 0;
+}
+
+void CallProfile::PrintName(const Function& function, BaseTextBuffer* buffer) {
+  function.PrintName(NameFormattingParams(Object::kUserVisibleName), buffer);
+}
+
+int64_t CallProfile::SamplesOf(const Function& function) const {
+  ZoneTextBuffer buffer(Thread::Current()->zone());
+  PrintName(function, &buffer);
+  return SamplesOf(buffer.buffer());
+}
+
+int64_t CallProfile::CallSamplesOf(const Function& caller,
+                                   const Function& callee) const {
+  Zone* zone = Thread::Current()->zone();
+  ZoneTextBuffer caller_name(zone);
+  PrintName(caller, &caller_name);
+  ZoneTextBuffer callee_name(zone);
+  PrintName(callee, &callee_name);
+  Call call = {caller_name.buffer(), callee_name.buffer(), 0};
+  Call* pair = calls_.Lookup(call);
+  return (pair != nullptr) ? pair->samples : 0;
+}
+
+// A run of code objects sharing their instructions.
+struct CodeNode {
+  intptr_t first;
+  intptr_t length;
+  intptr_t size;
+  int64_t samples;
+  // The node of the most frequent caller and its samples.
+  intptr_t caller;
+  int64_t caller_samples;
+  // The first node of the cluster this node belongs to, and the next node
+  // in it.
+  intptr_t cluster;
+  intptr_t next;
+};
+
+// Nodes or clusters, sorted hottest first.
+struct CodeCluster {
+  intptr_t node;
+  double weight;
+};
+
+static int CompareCodeClusters(const CodeCluster* a, const CodeCluster* b) {
+  if (a->weight != b->weight) {
+    return (a->weight > b->weight) ? -1 : 1;
+  }
+  return (a->node < b->node) ? -1 : ((a->node > b->node) ? 1 : 0);
+}
+
+// Call-chain clustering (C3): in order of decreasing samples, the cluster of
+// each function is appended to the cluster of its most frequent caller, and
+// the clusters are finally sorted by their density of samples.
+void CallProfile::OrderCode(GrowableArray<CodePtr>* code_objects) const {
+  Zone* zone = Thread::Current()->zone();
+  GrowableArray<CodeNode> nodes;
+  CStringMap<intptr_t> node_of_function(zone);
+  auto& code = Code::Handle(zone);
+  auto& owner = Object::Handle(zone);
+  for (intptr_t i = 0; i < code_objects->length(); i++) {
+    code = code_objects->At(i);
+    if (nodes.is_empty() ||
+        (code.instructions() !=
+         Code::InstructionsOf(code_objects->At(nodes.Last().first)))) {
+      const intptr_t index = nodes.length();
+      CodeNode node = {i, 0, Instructions::Size(code.instructions()), 0,
+                       -1, 0, index, -1};
+      nodes.Add(node);
+    }
+    nodes.Last().length++;
+    owner = WeakSerializationReference::UnwrapIfTarget(code.owner());
+    if (!owner.IsFunction()) {
+      continue;
+    }
+    ZoneTextBuffer name(zone);
+    PrintName(Function::Cast(owner), &name);
+    const int64_t samples = SamplesOf(name.buffer());
+    if ((samples > 0) && (node_of_function.Lookup(name.buffer()) == nullptr)) {
+      nodes.Last().samples += samples;
+      node_of_function.Insert({name.buffer(), nodes.length() - 1});
+    }
+  }
+
+  auto it = calls_.GetIterator();
+  for (const Call* call = it.Next(); call != nullptr; call = it.Next()) {
+    auto caller = node_of_function.Lookup(call->caller);
+    auto callee = node_of_function.Lookup(call->callee);
+    if ((caller == nullptr) || (callee == nullptr) ||
+        (caller->value == callee->value)) {
+      continue;
+    }
+    CodeNode& node = nodes[callee->value];
+    if (call->samples > node.caller_samples) {
+      node.caller = caller->value;
+      node.caller_samples = call->samples;
+    }
+  }
+
+  GrowableArray<CodeCluster> hot_nodes;
+  for (intptr_t i = 0; i < nodes.length(); i++) {
+    if (nodes[i].samples > 0) {
+      hot_nodes.Add({i, static_cast<double>(nodes[i].samples)});
+    }
+  }
+  if (hot_nodes.is_empty()) {
+    return;
+  }
+  hot_nodes.Sort(CompareCodeClusters);
+
+  // Every node starts out as a cluster of its own, of which it is the first
+  // node. The last node of each cluster is kept in [last].
+  GrowableArray<intptr_t> last(nodes.length());
+  for (intptr_t i = 0; i < nodes.length(); i++) {
+    last.Add(i);
+  }
+  for (intptr_t i = 0; i < hot_nodes.length(); i++) {
+    const CodeNode& node = nodes[hot_nodes[i].node];
+    if (node.caller < 0) {
+      continue;
+    }
+    const intptr_t callee_cluster = node.cluster;
+    const intptr_t caller_cluster = nodes[node.caller].cluster;
+    if ((callee_cluster == caller_cluster) ||
+        (nodes[caller_cluster].size + nodes[callee_cluster].size >
+         kMaxClusterSize)) {
+      continue;
+    }
+    for (intptr_t n = callee_cluster; n >= 0; n = nodes[n].next) {
+      nodes[n].cluster = caller_cluster;
+    }
+    nodes[last[caller_cluster]].next = callee_cluster;
+    last[caller_cluster] = last[callee_cluster];
+    // The totals of a cluster are kept in its first node.
+    nodes[caller_cluster].size += nodes[callee_cluster].size;
+    nodes[caller_cluster].samples += nodes[callee_cluster].samples;
+  }
+
+  GrowableArray<CodeCluster> clusters;
+  for (intptr_t i = 0; i < hot_nodes.length(); i++) {
+    const intptr_t n = hot_nodes[i].node;
+    if (nodes[n].cluster == n) {
+      const double size = Utils::Maximum<intptr_t>(nodes[n].size, 1);
+      clusters.Add({n, nodes[n].samples / size});
+    }
+  }
+  clusters.Sort(CompareCodeClusters);
+
+  GrowableArray<CodePtr> ordered(code_objects->length());
+  GrowableArray<bool> placed(nodes.length());
+  placed.FillWith(false, 0, nodes.length());
+  for (intptr_t i = 0; i < clusters.length(); i++) {
+    for (intptr_t n = clusters[i].node; n >= 0; n = nodes[n].next) {
+      for (intptr_t j = 0; j < nodes[n].length; j++) {
+        ordered.Add(code_objects->At(nodes[n].first + j));
+      }
+      placed[n] = true;
+    }
+  }
+  for (intptr_t n = 0; n < nodes.length(); n++) {
+    if (placed[n]) continue;
+    for (intptr_t j = 0; j < nodes[n].length; j++) {
+      ordered.Add(code_objects->At(nodes[n].first + j));
+    }
+  }
+  ASSERT(ordered.length() == code_objects->length());
+  for (intptr_t i = 0; i < ordered.length(); i++) {
+    (*code_objects)[i] = ordered[i];
+  }
+}
+
+}  // namespace dart
+
+#endif  // defined(DART_PRECOMPILER)
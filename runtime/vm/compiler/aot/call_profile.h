@@ -0,0 +1,95 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_AOT_CALL_PROFILE_H_
+#define RUNTIME_VM_COMPILER_AOT_CALL_PROFILE_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/tagged_pointer.h"
+
+namespace dart {
+
+class BaseTextBuffer;
+class Function;
+
+#if defined(DART_PRECOMPILER)
+
+// The number of CPU samples in which Dart functions were calling each other,
+// as written by the VM to <dir>/dart-calls-<pid>.txt with --pprof-dir (see
+// PprofProfiler). Functions are identified by their qualified user visible
+// names.
+class CallProfile {
+ public:
+  // Returns null if the file at [path] cannot be read.
+  static CallProfile* ReadFrom(const char* path);
+
+  // Parses a profile from the [contents] of such a file.
+  static CallProfile* FromString(const char* contents);
+
+  ~CallProfile();
+
+  // The number of samples in which [function] was running.
+  int64_t SamplesOf(const Function& function) const;
+
+  // The number of samples in which [caller] was calling [callee].
+  int64_t CallSamplesOf(const Function& caller, const Function& callee) const;
+
+  // Reorders [code_objects] so that functions calling each other a lot are
+  // placed next to each other, and all sampled code before the code which
+  // was never sampled. Code objects sharing their instructions stay adjacent.
+  void OrderCode(GrowableArray<CodePtr>* code_objects) const;
+
+ private:
+  struct Call {
+    const char* caller;
+    const char* callee;
+    int64_t samples;
+  };
+
+  class CallTrait {
+   public:
+    typedef Call Key;
+    typedef int64_t Value;
+    typedef Call Pair;
+
+    static Key KeyOf(Pair kv) { return kv; }
+    static Value ValueOf(Pair kv) { return kv.samples; }
+    static intptr_t Hashcode(Key key);
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return (strcmp(kv.caller, key.caller) == 0) &&
+             (strcmp(kv.callee, key.callee) == 0);
+    }
+  };
+
+  typedef MallocDirectChainedHashMap<CStringKeyValueTrait<int64_t>>
+      FunctionMap;
+  typedef MallocDirectChainedHashMap<CallTrait> CallMap;
+
+  explicit CallProfile(char* text) : text_(text) {}
+
+  void Parse();
+  void AddSamples(const char* function, int64_t samples);
+  int64_t SamplesOf(const char* function) const;
+
+  static void PrintName(const Function& function, BaseTextBuffer* buffer);
+
+  // The contents of the file, split into strings in place.
+  char* text_;
+  FunctionMap functions_;
+  CallMap calls_;
+
+  DISALLOW_COPY_AND_ASSIGN(CallProfile);
+};
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_AOT_CALL_PROFILE_H_
@@ -0,0 +1,94 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/aot/call_profile.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+#include "vm/zone_text_buffer.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+
+static CodePtr CompiledCodeOf(const Library& root_library, const char* name) {
+  const auto& function = Function::Handle(GetFunction(root_library, name));
+  return function.EnsureHasCode();
+}
+
+static const char* ProfileNameOf(const Library& root_library,
+                                 const char* name) {
+  const auto& function = Function::Handle(GetFunction(root_library, name));
+  ZoneTextBuffer buffer(Thread::Current()->zone());
+  function.PrintName(NameFormattingParams(Object::kUserVisibleName), &buffer);
+  return buffer.buffer();
+}
+
+ISOLATE_UNIT_TEST_CASE(CallProfile_OrderCode) {
+  const char* kScript = R"(
+    cold() => 1;
+    callee() => 2;
+    warm() => 3;
+    caller() => callee();
+  )";
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& cold = Code::Handle(CompiledCodeOf(root_library, "cold"));
+  const auto& callee = Code::Handle(CompiledCodeOf(root_library, "callee"));
+  const auto& warm = Code::Handle(CompiledCodeOf(root_library, "warm"));
+  const auto& caller = Code::Handle(CompiledCodeOf(root_library, "caller"));
+
+  const char* profile_text = OS::SCreate(
+      thread->zone(), "100\t%s\t%s\n1\t%s\t%s\nnot a sample\n",
+      ProfileNameOf(root_library, "caller"),
+      ProfileNameOf(root_library, "callee"),
+      ProfileNameOf(root_library, "warm"), ProfileNameOf(root_library, "warm"));
+  CallProfile* profile = CallProfile::FromString(profile_text);
+
+  const auto& function = Function::Handle(GetFunction(root_library, "caller"));
+  EXPECT_EQ(100, profile->SamplesOf(function));
+  EXPECT_EQ(100, profile->CallSamplesOf(
+                     function, Function::Handle(
+                                   GetFunction(root_library, "callee"))));
+
+  GrowableArray<CodePtr> code_objects;
+  code_objects.Add(cold.raw());
+  code_objects.Add(callee.raw());
+  code_objects.Add(warm.raw());
+  code_objects.Add(caller.raw());
+  profile->OrderCode(&code_objects);
+  delete profile;
+
+  // The callee follows its caller in the hottest cluster, and code which was
+  // never sampled comes last.
+  EXPECT_EQ(4, code_objects.length());
+  EXPECT(code_objects[0] == caller.raw());
+  EXPECT(code_objects[1] == callee.raw());
+  EXPECT(code_objects[2] == warm.raw());
+  EXPECT(code_objects[3] == cold.raw());
+}
+
+ISOLATE_UNIT_TEST_CASE(CallProfile_OrderCodeWithoutSamples) {
+  const char* kScript = R"(
+    first() => 1;
+    second() => 2;
+  )";
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& first = Code::Handle(CompiledCodeOf(root_library, "first"));
+  const auto& second = Code::Handle(CompiledCodeOf(root_library, "second"));
+
+  CallProfile* profile = CallProfile::FromString("10\tunknown\tother\n");
+  GrowableArray<CodePtr> code_objects;
+  code_objects.Add(first.raw());
+  code_objects.Add(second.raw());
+  profile->OrderCode(&code_objects);
+  delete profile;
+
+  // Code of functions missing from the profile keeps its order.
+  EXPECT(code_objects[0] == first.raw());
+  EXPECT(code_objects[1] == second.raw());
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
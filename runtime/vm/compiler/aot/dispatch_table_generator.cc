@@ -10,6 +10,8 @@
 
 #include "vm/compiler/frontend/kernel_translation_helper.h"
 #include "vm/dispatch_table.h"
+#include "vm/flags.h"
+#include "vm/os.h"
 #include "vm/stub_code.h"
 #include "vm/thread.h"
 
@@ -96,8 +98,10 @@ class SelectorRow {
  public:
   SelectorRow(Zone* zone, TableSelector* selector)
       : selector_(selector),
+        call_count_(selector->call_count),
         class_ranges_(zone, 0),
         ranges_(zone, 0),
+        merged_rows_(zone, 0),
         code_(Code::Handle(zone)) {}
 
   TableSelector* selector() const { return selector_; }
@@ -116,7 +120,7 @@ class SelectorRow {
                                                const Function* function);
   bool Finalize();
 
-  int32_t CallCount() const { return selector_->call_count; }
+  int32_t CallCount() const { return call_count_; }
 
   bool IsAllocated() const {
     return selector_->offset != SelectorMap::kInvalidSelectorOffset;
@@ -125,16 +129,38 @@ class SelectorRow {
   void AllocateAt(int32_t offset) {
     ASSERT(!IsAllocated());
     selector_->offset = offset;
+    for (intptr_t i = 0; i < merged_rows_.length(); i++) {
+      merged_rows_[i]->AllocateAt(offset);
+    }
+  }
+
+  // Whether this row defines the same entries as [other], so that both
+  // selectors can share an offset.
+  bool HasSameEntriesAs(const SelectorRow& other) const;
+  // Compares rows such that rows with the same entries are adjacent.
+  static int CompareEntries(SelectorRow* const* a, SelectorRow* const* b);
+
+  // Let [other] share the offset of this row. Its call sites count towards
+  // the popularity of this row.
+  void Merge(SelectorRow* other) {
+    ASSERT(!IsAllocated() && !other->IsAllocated());
+    ASSERT(other->merged_rows_.is_empty());
+    merged_rows_.Add(other);
+    call_count_ += other->CallCount();
   }
 
   void FillTable(ClassTable* class_table, const Array& entries);
 
  private:
+  static int CompareEntriesOf(const SelectorRow& a, const SelectorRow& b);
+
   TableSelector* selector_;
   int32_t total_size_ = 0;
+  int32_t call_count_;
 
   GrowableArray<CidInterval> class_ranges_;
   GrowableArray<Interval> ranges_;
+  GrowableArray<SelectorRow*> merged_rows_;
   Code& code_;
 };
 
@@ -183,6 +209,18 @@ bool SelectorRow::Finalize() {
     return false;
   }
 
+  // Put the implementation intervals in a canonical order, so that rows with
+  // the same entries can be found by CompareEntries.
+  struct CidIntervalSorter {
+    static int Compare(const CidInterval* a, const CidInterval* b) {
+      if (a->depth() != b->depth()) {
+        return a->depth() - b->depth();
+      }
+      return a->range().begin() - b->range().begin();
+    }
+  };
+  class_ranges_.Sort(CidIntervalSorter::Compare);
+
   // Make a list of [begin, end) ranges which are disjunct and cover all
   // areas that [class_ranges_] cover (i.e. there can be holes, but no overlap).
   for (intptr_t i = 0; i < class_ranges_.length(); i++) {
@@ -236,6 +274,48 @@ bool SelectorRow::Finalize() {
   return true;
 }
 
+int SelectorRow::CompareEntries(SelectorRow* const* a, SelectorRow* const* b) {
+  return CompareEntriesOf(**a, **b);
+}
+
+int SelectorRow::CompareEntriesOf(const SelectorRow& row_a,
+                                  const SelectorRow& row_b) {
+  if (row_a.total_size() != row_b.total_size()) {
+    return row_a.total_size() - row_b.total_size();
+  }
+  const intptr_t length = row_a.class_ranges_.length();
+  if (length != row_b.class_ranges_.length()) {
+    return length < row_b.class_ranges_.length() ? -1 : 1;
+  }
+  for (intptr_t i = 0; i < length; i++) {
+    const CidInterval& x = row_a.class_ranges_[i];
+    const CidInterval& y = row_b.class_ranges_[i];
+    if (x.depth() != y.depth()) {
+      return x.depth() - y.depth();
+    }
+    if (x.range().begin() != y.range().begin()) {
+      return x.range().begin() - y.range().begin();
+    }
+    if (x.range().end() != y.range().end()) {
+      return x.range().end() - y.range().end();
+    }
+    const uword x_function = x.function() == nullptr
+                                 ? 0
+                                 : static_cast<uword>(x.function()->raw());
+    const uword y_function = y.function() == nullptr
+                                 ? 0
+                                 : static_cast<uword>(y.function()->raw());
+    if (x_function != y_function) {
+      return x_function < y_function ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+bool SelectorRow::HasSameEntriesAs(const SelectorRow& other) const {
+  return CompareEntriesOf(*this, other) == 0;
+}
+
 void SelectorRow::FillTable(ClassTable* class_table, const Array& entries) {
   // Define the entries in the table by going top-down, which means more
   // specific ones will override more general ones.
@@ -403,6 +483,7 @@ DispatchTableGenerator::DispatchTableGenerator(Zone* zone)
       classes_(nullptr),
       num_selectors_(-1),
       num_classes_(-1),
+      num_merged_rows_(0),
       selector_map_(zone) {}
 
 void DispatchTableGenerator::Initialize(ClassTable* table) {
@@ -610,9 +691,30 @@ void DispatchTableGenerator::SetupSelectorRows() {
   }
 }
 
+void DispatchTableGenerator::MergeSelectorRows() {
+  // Rows with the same entries for all classes, e.g. rows which only contain
+  // the entry for null receivers, are allocated at the same offset.
+  table_rows_.Sort(SelectorRow::CompareEntries);
+  intptr_t write_index = 0;
+  for (intptr_t read_index = 0; read_index < table_rows_.length();
+       read_index++) {
+    SelectorRow* row = table_rows_[read_index];
+    if (write_index > 0 &&
+        table_rows_[write_index - 1]->HasSameEntriesAs(*row)) {
+      table_rows_[write_index - 1]->Merge(row);
+      num_merged_rows_++;
+    } else {
+      table_rows_[write_index++] = row;
+    }
+  }
+  table_rows_.TruncateTo(write_index);
+}
+
 void DispatchTableGenerator::ComputeSelectorOffsets() {
   ASSERT(table_rows_.length() > 0);
 
+  MergeSelectorRows();
+
   RowFitter fitter;
 
   // Sort the table rows according to popularity, descending.
@@ -667,9 +769,34 @@ ArrayPtr DispatchTableGenerator::BuildCodeArray() {
     table_rows_[i]->FillTable(classes_, entries);
   }
   entries.MakeImmutable();
+  if (FLAG_print_snapshot_sizes) {
+    PrintStatistics(entries);
+  }
   return entries.raw();
 }
 
+void DispatchTableGenerator::PrintStatistics(const Array& entries) const {
+  intptr_t filled = 0;
+  for (intptr_t i = 0; i < entries.Length(); i++) {
+    if (entries.At(i) != Object::null()) filled++;
+  }
+  const int32_t small_offset_limit = DispatchTable::LargestSmallOffset();
+  intptr_t small_offset_rows = 0;
+  for (intptr_t i = 0; i < table_rows_.length(); i++) {
+    if (table_rows_[i]->selector()->offset <= small_offset_limit) {
+      small_offset_rows++;
+    }
+  }
+  OS::Print("DispatchTable(Rows): %" Pd " (%" Pd " at small offsets)\n",
+            table_rows_.length(), small_offset_rows);
+  OS::Print("DispatchTable(MergedRows): %" Pd "\n", num_merged_rows_);
+  OS::Print("DispatchTable(Entries): %" Pd "\n", entries.Length());
+  OS::Print("DispatchTable(FilledEntries): %" Pd " (%.1f%%)\n", filled,
+            entries.Length() == 0
+                ? 0.0
+                : 100.0 * filled / static_cast<double>(entries.Length()));
+}
+
 }  // namespace compiler
 }  // namespace dart
 
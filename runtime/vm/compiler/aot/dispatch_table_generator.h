@@ -101,13 +101,16 @@ class DispatchTableGenerator {
   void ReadTableSelectorInfo();
   void NumberSelectors();
   void SetupSelectorRows();
+  void MergeSelectorRows();
   void ComputeSelectorOffsets();
+  void PrintStatistics(const Array& entries) const;
 
   Zone* const zone_;
   ClassTable* classes_;
   int32_t num_selectors_;
   int32_t num_classes_;
   int32_t table_size_;
+  intptr_t num_merged_rows_;
 
   GrowableArray<SelectorRow*> table_rows_;
 
@@ -6,11 +6,15 @@
 
 #include "platform/unicode.h"
 #include "vm/class_finalizer.h"
+#include "vm/code_descriptors.h"
 #include "vm/code_patcher.h"
+#include "vm/compilation_trace.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
+#include "vm/compiler/aot/call_profile.h"
 #include "vm/compiler/aot/precompiler_tracer.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
+#include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
 #include "vm/compiler/backend/flow_graph.h"
@@ -97,6 +101,24 @@ DEFINE_FLAG(bool,
             "Add constant pool entries from flow graphs to a special pool "
             "serialized in AOT snapshots (with --serialize_flow_graphs_to)");
 
+DEFINE_FLAG(charp,
+            block_profile,
+            nullptr,
+            "Lay out blocks using the edge counters in the given type feedback "
+            "file (see Dart_SaveTypeFeedback)");
+
+DEFINE_FLAG(charp,
+            inlining_profile,
+            nullptr,
+            "Inline the calls sampled most often in the given call profile "
+            "(written with --pprof-dir)");
+
+DEFINE_FLAG(bool,
+            drop_unsampled_source_positions,
+            false,
+            "Drop the source positions of code which has no samples in the "
+            "--inlining_profile, keeping only its inlined frames");
+
 Precompiler* Precompiler::singleton_ = nullptr;
 
 #if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
@@ -180,7 +202,8 @@ Precompiler::Precompiler(Thread* thread)
       seen_table_selectors_(),
       error_(Error::Handle()),
       get_runtime_type_is_unique_(false),
-      il_serialization_stream_(nullptr) {
+      il_serialization_stream_(nullptr),
+      block_profile_(Array::Handle()) {
   ASSERT(Precompiler::singleton_ == NULL);
   Precompiler::singleton_ = this;
 }
@@ -190,6 +213,7 @@ Precompiler::~Precompiler() {
   seen_functions_.Release();
   possibly_retained_functions_.Release();
   functions_to_retain_.Release();
+  delete inlining_profile_;
 
   ASSERT(Precompiler::singleton_ == this);
   Precompiler::singleton_ = NULL;
@@ -270,6 +294,9 @@ void Precompiler::DoCompileAll() {
         }
       }
 
+      LoadBlockProfile();
+      LoadInliningProfile();
+
       tracer_ = PrecompilerTracer::StartTracingIfRequested(this);
 
       // All stubs have already been generated, all of them share the same pool.
@@ -437,6 +464,7 @@ void Precompiler::DoCompileAll() {
              non_visited.ToFullyQualifiedCString());
     }
 #endif
+    DropUnsampledSourcePositions();
     ProgramVisitor::Dedup(T);
 
     zone_ = NULL;
@@ -647,6 +675,83 @@ void Precompiler::ProcessFunction(const Function& function) {
   AddCalleesOf(function, gop_offset);
 }
 
+void Precompiler::LoadBlockProfile() {
+  if (FLAG_block_profile == nullptr) {
+    return;
+  }
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    return;
+  }
+
+  void* file = file_open(FLAG_block_profile, /*write=*/false);
+  if (file == nullptr) {
+    const String& msg = String::Handle(
+        Z, String::NewFormatted("Could not open block profile '%s'",
+                                FLAG_block_profile));
+    Jump(Error::Handle(Z, ApiError::New(msg)));
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t size = -1;
+  file_read(&buffer, &size, file);
+  file_close(file);
+  if (size < 0) {
+    const String& msg = String::Handle(
+        Z, String::NewFormatted("Could not read block profile '%s'",
+                                FLAG_block_profile));
+    Jump(Error::Handle(Z, ApiError::New(msg)));
+  }
+
+  const auto& edge_counters =
+      GrowableObjectArray::Handle(Z, GrowableObjectArray::New());
+  {
+    ReadStream stream(buffer, size);
+    TypeFeedbackLoader loader(T);
+    error_ ^= loader.LoadEdgeCounters(&stream, edge_counters);
+  }
+  free(buffer);
+  if (!error_.IsNull()) {
+    Jump(error_);
+  }
+
+  FunctionMap map(HashTables::New<FunctionMap>(
+      edge_counters.Length() / 2 + 1, Heap::kOld));
+  auto& function = Function::Handle(Z);
+  auto& counters = Array::Handle(Z);
+  for (intptr_t i = 0; i < edge_counters.Length(); i += 2) {
+    function ^= edge_counters.At(i);
+    counters ^= edge_counters.At(i + 1);
+    map.UpdateOrInsert(function, counters);
+  }
+  block_profile_ = map.Release().raw();
+}
+
+void Precompiler::LoadInliningProfile() {
+  if (FLAG_inlining_profile == nullptr) {
+    return;
+  }
+  inlining_profile_ = CallProfile::ReadFrom(FLAG_inlining_profile);
+  if (inlining_profile_ == nullptr) {
+    const String& msg = String::Handle(
+        Z, String::NewFormatted("Could not read inlining profile '%s'",
+                                FLAG_inlining_profile));
+    Jump(Error::Handle(Z, ApiError::New(msg)));
+  }
+}
+
+ArrayPtr Precompiler::EdgeCountersOf(const Function& function) const {
+  if (block_profile_.IsNull()) {
+    return Array::null();
+  }
+  FunctionMap map(block_profile_.raw());
+  const ArrayPtr result = Array::RawCast(map.GetOrNull(function));
+  map.Release();
+  return result;
+}
+
 void Precompiler::AddCalleesOf(const Function& function, intptr_t gop_offset) {
   ASSERT(function.HasCode());
 
@@ -1699,6 +1804,52 @@ void Precompiler::ReplaceFunctionStaticCallEntries() {
   ProgramVisitor::WalkProgram(Z, I, &visitor);
 }
 
+void Precompiler::DropUnsampledSourcePositions() {
+  if (!FLAG_drop_unsampled_source_positions || (inlining_profile_ == nullptr) ||
+      FLAG_dwarf_stack_traces_mode) {
+    return;
+  }
+
+  class SourcePositionsDropper : public CodeVisitor {
+   public:
+    SourcePositionsDropper(Zone* zone, const CallProfile* profile)
+        : profile_(profile),
+          function_(Function::Handle(zone)),
+          map_(CodeSourceMap::Handle(zone)),
+          inlined_functions_(Array::Handle(zone)) {}
+
+    void VisitCode(const Code& code) {
+      if (!code.IsFunctionCode()) return;
+      map_ = code.code_source_map();
+      if (map_.IsNull()) return;
+      function_ = code.function();
+      if (profile_->SamplesOf(function_) > 0) return;
+      inlined_functions_ = code.inlined_id_to_function();
+      CodeSourceMapReader reader(map_, inlined_functions_, function_);
+      map_ = reader.WithoutPositions();
+      code.set_code_source_map(map_);
+      dropped_++;
+    }
+
+    intptr_t dropped() const { return dropped_; }
+
+   private:
+    const CallProfile* const profile_;
+    Function& function_;
+    CodeSourceMap& map_;
+    Array& inlined_functions_;
+    intptr_t dropped_ = 0;
+  };
+
+  HANDLESCOPE(T);
+  SourcePositionsDropper visitor(Z, inlining_profile_);
+  ProgramVisitor::WalkProgram(Z, I, &visitor);
+  if (FLAG_trace_precompiler) {
+    THR_Print("Dropped the source positions of %" Pd " unsampled functions\n",
+              visitor.dropped());
+  }
+}
+
 void Precompiler::DropFunctions() {
   Library& lib = Library::Handle(Z);
   Class& cls = Class::Handle(Z);
@@ -2588,10 +2739,17 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
         FlowGraphPrinter::PrintGraph("Unoptimized Compilation", flow_graph);
       }
 
+      const bool reorder_blocks =
+          FlowGraph::ShouldReorderBlocks(function, optimized());
+      if (reorder_blocks) {
+        TIMELINE_DURATION(thread(), CompilerVerbose,
+                          "BlockScheduler::AssignEdgeWeights");
+        BlockScheduler::AssignEdgeWeights(flow_graph);
+      }
+
       CompilerPassState pass_state(thread(), flow_graph, &speculative_policy,
                                    precompiler_);
-      pass_state.reorder_blocks =
-          FlowGraph::ShouldReorderBlocks(function, optimized());
+      pass_state.reorder_blocks = reorder_blocks;
 
       if (function.ForceOptimize()) {
         ASSERT(optimized());
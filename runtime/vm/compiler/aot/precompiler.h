@@ -20,6 +20,7 @@
 namespace dart {
 
 // Forward declarations.
+class CallProfile;
 class Class;
 class Error;
 class Field;
@@ -79,6 +80,7 @@ struct FunctionKeyTraits {
 };
 
 typedef UnorderedHashSet<FunctionKeyTraits> FunctionSet;
+typedef UnorderedHashMap<FunctionKeyTraits> FunctionMap;
 
 class FieldKeyValueTrait {
  public:
@@ -232,6 +234,13 @@ class Precompiler : public ValueObject {
 
   void* il_serialization_stream() const { return il_serialization_stream_; }
 
+  // Returns the edge counters recorded for [function] in the profile given
+  // with --block_profile, or null if there are none.
+  ArrayPtr EdgeCountersOf(const Function& function) const;
+
+  // The profile given with --inlining_profile, or null.
+  const CallProfile* inlining_profile() const { return inlining_profile_; }
+
   static Precompiler* Instance() { return singleton_; }
 
   void AddField(const Field& field);
@@ -302,6 +311,7 @@ class Precompiler : public ValueObject {
   void TraceForRetainedFunctions();
   void FinalizeDispatchTable();
   void ReplaceFunctionStaticCallEntries();
+  void DropUnsampledSourcePositions();
   void DropFunctions();
   void DropFields();
   void TraceTypesFromRetainedClasses();
@@ -323,6 +333,8 @@ class Precompiler : public ValueObject {
   void PrecompileConstructors();
 
   void FinalizeAllClasses();
+  void LoadBlockProfile();
+  void LoadInliningProfile();
 
   void set_il_serialization_stream(void* file) {
     il_serialization_stream_ = file;
@@ -369,6 +381,8 @@ class Precompiler : public ValueObject {
 
   bool get_runtime_type_is_unique_;
   void* il_serialization_stream_;
+  Array& block_profile_;
+  CallProfile* inlining_profile_ = nullptr;
 
   Phase phase_ = Phase::kPreparation;
   PrecompilerTracer* tracer_ = nullptr;
@@ -2294,6 +2294,16 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into R0. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ ldr(R2, Address(SP, kRegExpParamOffset));
+
+  // Patterns with a required literal are prefiltered by the native, which
+  // also runs linear programs.
+  __ ldr(R1, FieldAddress(R2, target::RegExp::required_literal_offset()));
+  __ CompareObject(R1, NullObject());
+  __ b(normal_ir_body, NE);
+  __ ldr(R1, FieldAddress(R2, target::RegExp::linear_program_offset()));
+  __ CompareObject(R1, NullObject());
+  __ b(normal_ir_body, NE);
+
   __ ldr(R1, Address(SP, kStringParamOffset));
   __ LoadClassId(R1, R1);
   __ AddImmediate(R1, -kOneByteStringCid);
@@ -2308,6 +2318,8 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Tail-call the function.
   __ ldr(CODE_REG, FieldAddress(R0, target::Function::code_offset()));
   __ Branch(FieldAddress(R0, target::Function::entry_point_offset()));
+
+  __ Bind(normal_ir_body);
 }
 
 // On stack: user tag (+0).
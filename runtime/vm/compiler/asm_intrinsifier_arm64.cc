@@ -1850,7 +1850,18 @@ void AsmIntrinsifier::Object_setHash(Assembler* assembler,
   __ ldr(R0, Address(SP, 1 * target::kWordSize));  // Object.
   __ ldr(R1, Address(SP, 0 * target::kWordSize));  // Value.
   __ SmiUntag(R1);
-  __ str(R1, FieldAddress(R0, target::String::hash_offset()), kUnsignedWord);
+  // Only store the hash if no other thread has stored one yet.
+  // R2: Untagged address of the hash (ldxr/stxr do not support offsets).
+  __ AddImmediate(R2, R0, target::String::hash_offset() - kHeapObjectTag);
+  Label retry, done;
+  __ Bind(&retry);
+  __ ldxr(R3, R2, kWord);
+  __ cbnz(&done, R3);
+  __ stxr(R3, R1, R2, kWord);
+  __ cbnz(&retry, R3);
+  __ Bind(&done);
+  __ clrex();
+  __ LoadObject(R0, NullObject());
   __ ret();
 }
 
@@ -2364,6 +2375,16 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into R0. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ ldr(R2, Address(SP, kRegExpParamOffset));
+
+  // Patterns with a required literal are prefiltered by the native, which
+  // also runs linear programs.
+  __ ldr(R1, FieldAddress(R2, target::RegExp::required_literal_offset()));
+  __ CompareObject(R1, NullObject());
+  __ b(normal_ir_body, NE);
+  __ ldr(R1, FieldAddress(R2, target::RegExp::linear_program_offset()));
+  __ CompareObject(R1, NullObject());
+  __ b(normal_ir_body, NE);
+
   __ ldr(R1, Address(SP, kStringParamOffset));
   __ LoadClassId(R1, R1);
   __ AddImmediate(R1, -kOneByteStringCid);
@@ -2379,6 +2400,8 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   __ ldr(CODE_REG, FieldAddress(R0, target::Function::code_offset()));
   __ ldr(R1, FieldAddress(R0, target::Function::entry_point_offset()));
   __ br(R1);
+
+  __ Bind(normal_ir_body);
 }
 
 // On stack: user tag (+0).
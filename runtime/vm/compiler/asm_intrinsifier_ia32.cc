@@ -2295,6 +2295,16 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into EAX. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ movl(EBX, Address(ESP, kRegExpParamOffset));
+
+  // Patterns with a required literal are prefiltered by the native, which
+  // also runs linear programs.
+  __ movl(EDI, FieldAddress(EBX, target::RegExp::required_literal_offset()));
+  __ CompareObject(EDI, NullObject());
+  __ j(NOT_EQUAL, normal_ir_body);
+  __ movl(EDI, FieldAddress(EBX, target::RegExp::linear_program_offset()));
+  __ CompareObject(EDI, NullObject());
+  __ j(NOT_EQUAL, normal_ir_body);
+
   __ movl(EDI, Address(ESP, kStringParamOffset));
   __ LoadClassId(EDI, EDI);
   __ SubImmediate(EDI, Immediate(kOneByteStringCid));
@@ -2308,6 +2318,8 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
 
   // Tail-call the function.
   __ jmp(FieldAddress(EAX, target::Function::entry_point_offset()));
+
+  __ Bind(normal_ir_body);
 }
 
 // On stack: user tag (+1), return-address (+0).
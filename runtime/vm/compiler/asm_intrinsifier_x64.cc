@@ -1804,10 +1804,13 @@ void AsmIntrinsifier::Object_getHash(Assembler* assembler,
 
 void AsmIntrinsifier::Object_setHash(Assembler* assembler,
                                      Label* normal_ir_body) {
-  __ movq(RAX, Address(RSP, +2 * target::kWordSize));  // Object.
+  __ movq(RCX, Address(RSP, +2 * target::kWordSize));  // Object.
   __ movq(RDX, Address(RSP, +1 * target::kWordSize));  // Value.
   __ SmiUntag(RDX);
-  __ movl(FieldAddress(RAX, target::String::hash_offset()), RDX);
+  // Only store the hash if no other thread has stored one yet.
+  __ xorl(RAX, RAX);  // RAX is the fixed implicit operand of CAS.
+  __ LockCmpxchgl(FieldAddress(RCX, target::String::hash_offset()), RDX);
+  __ LoadObject(RAX, NullObject());
   __ ret();
 }
 
@@ -2327,6 +2330,16 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   // Load the specialized function pointer into RAX. Leverage the fact the
   // string CIDs as well as stored function pointers are in sequence.
   __ movq(RBX, Address(RSP, kRegExpParamOffset));
+
+  // Patterns with a required literal are prefiltered by the native, which
+  // also runs linear programs.
+  __ movq(RDI, FieldAddress(RBX, target::RegExp::required_literal_offset()));
+  __ CompareObject(RDI, NullObject());
+  __ j(NOT_EQUAL, normal_ir_body);
+  __ movq(RDI, FieldAddress(RBX, target::RegExp::linear_program_offset()));
+  __ CompareObject(RDI, NullObject());
+  __ j(NOT_EQUAL, normal_ir_body);
+
   __ movq(RDI, Address(RSP, kStringParamOffset));
   __ LoadClassId(RDI, RDI);
   __ SubImmediate(RDI, Immediate(kOneByteStringCid));
@@ -2342,6 +2355,8 @@ void AsmIntrinsifier::IntrinsifyRegExpExecuteMatch(Assembler* assembler,
   __ movq(CODE_REG, FieldAddress(RAX, target::Function::code_offset()));
   __ movq(RDI, FieldAddress(RAX, target::Function::entry_point_offset()));
   __ jmp(RDI);
+
+  __ Bind(normal_ir_body);
 }
 
 // On stack: user tag (+1), return-address (+0).
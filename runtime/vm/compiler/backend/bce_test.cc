@@ -31,10 +31,30 @@ static intptr_t CountBoundChecks(FlowGraph* flow_graph) {
   return count;
 }
 
+// Helper method to count number of bounds checks inside loops.
+static intptr_t CountBoundChecksInLoops(FlowGraph* flow_graph) {
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    if (block_it.Current()->loop_info() == nullptr) {
+      continue;
+    }
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (it.Current()->IsCheckBoundBase()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
 // Helper method to build CFG, run BCE, and count number of
 // before/after bounds checks.
-static std::pair<intptr_t, intptr_t> ApplyBCE(const char* script_chars,
-                                              CompilerPass::PipelineMode mode) {
+static std::pair<intptr_t, intptr_t> ApplyBCE(
+    const char* script_chars,
+    CompilerPass::PipelineMode mode,
+    intptr_t (*count)(FlowGraph*) = CountBoundChecks) {
   // Load the script and exercise the code once
   // while exercising the given compiler passes.
   const auto& root_library = Library::Handle(LoadTestScript(script_chars));
@@ -56,10 +76,10 @@ static std::pair<intptr_t, intptr_t> ApplyBCE(const char* script_chars,
   TestPipeline pipeline(function, mode);
   FlowGraph* flow_graph = pipeline.RunPasses(passes);
   // Count the number of before/after bounds checks.
-  const intptr_t num_bc_before = CountBoundChecks(flow_graph);
+  const intptr_t num_bc_before = count(flow_graph);
   RangeAnalysis range_analysis(flow_graph);
   range_analysis.Analyze();
-  const intptr_t num_bc_after = CountBoundChecks(flow_graph);
+  const intptr_t num_bc_after = count(flow_graph);
   return {num_bc_before, num_bc_after};
 }
 
@@ -71,6 +91,15 @@ static void TestScriptJIT(const char* script_chars,
   EXPECT_EQ(expected_after, jit_result.second);
 }
 
+static void TestLoopScriptJIT(const char* script_chars,
+                              intptr_t expected_before,
+                              intptr_t expected_after) {
+  auto jit_result =
+      ApplyBCE(script_chars, CompilerPass::kJIT, CountBoundChecksInLoops);
+  EXPECT_EQ(expected_before, jit_result.first);
+  EXPECT_EQ(expected_after, jit_result.second);
+}
+
 //
 // BCE (bounds-check-elimination) tests.
 //
@@ -294,4 +323,39 @@ ISOLATE_UNIT_TEST_CASE(BCEListNamedAndPlainLength) {
   TestScriptJIT(kScriptChars, 2, 0);
 }
 
+// Checks that can't be removed statically are hoisted out of the loop nest.
+ISOLATE_UNIT_TEST_CASE(BCEFlattenedMatrix) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      foo(Float64List a, int h, int w) {
+        for (int i = 0; i < h; i++) {
+          for (int j = 0; j < w; j++) {
+            a[i * w + j] = 1.0;
+          }
+        }
+      }
+      main() {
+        foo(new Float64List(100), 10, 10);
+      }
+    )";
+  TestLoopScriptJIT(kScriptChars, 1, 0);
+}
+
+ISOLATE_UNIT_TEST_CASE(BCESymbolicStart) {
+  const char* kScriptChars =
+      R"(
+      import 'dart:typed_data';
+      foo(Float64List a, int k) {
+        for (int i = a.length - k; i < a.length; i++) {
+          a[i] = 1.0;
+        }
+      }
+      main() {
+        foo(new Float64List(100), 10);
+      }
+    )";
+  TestLoopScriptJIT(kScriptChars, 1, 0);
+}
+
 }  // namespace dart
@@ -6,6 +6,7 @@
 
 #include "vm/allocation.h"
 #include "vm/code_patcher.h"
+#include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/flow_graph.h"
 #include "vm/compiler/jit/compiler.h"
 
@@ -50,25 +51,43 @@ void BlockScheduler::AssignEdgeWeights(FlowGraph* flow_graph) {
   if (!FLAG_reorder_basic_blocks) {
     return;
   }
-  if (CompilerState::Current().is_aot()) {
-    return;
-  }
 
   const Function& function = flow_graph->parsed_function().function();
-  const Array& ic_data_array =
-      Array::Handle(flow_graph->zone(), function.ic_data_array());
-  if (Compiler::IsBackgroundCompilation() && ic_data_array.IsNull()) {
-    // Deferred loading cleared ic_data_array.
-    Compiler::AbortBackgroundCompilation(
-        DeoptId::kNone, "BlockScheduler: ICData array cleared");
-  }
-  if (ic_data_array.IsNull()) {
-    DEBUG_ASSERT(Isolate::Current()->HasAttemptedReload() ||
-                 function.ForceOptimize());
-    return;
-  }
   Array& edge_counters = Array::Handle();
-  edge_counters ^= ic_data_array.At(0);
+  if (CompilerState::Current().is_aot()) {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+    // Use the counters recorded by the JIT if a profile was given to the
+    // precompiler and the function's graph has the same shape.
+    Precompiler* precompiler = Precompiler::Instance();
+    if (precompiler != nullptr) {
+      edge_counters = precompiler->EdgeCountersOf(function);
+    }
+#endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+    if (edge_counters.IsNull() ||
+        (edge_counters.Length() != flow_graph->preorder().length())) {
+      return;
+    }
+  } else {
+    const Array& ic_data_array =
+        Array::Handle(flow_graph->zone(), function.ic_data_array());
+    if (Compiler::IsBackgroundCompilation() && ic_data_array.IsNull()) {
+      // Deferred loading cleared ic_data_array.
+      Compiler::AbortBackgroundCompilation(
+          DeoptId::kNone, "BlockScheduler: ICData array cleared");
+    }
+    if (ic_data_array.IsNull()) {
+      DEBUG_ASSERT(Isolate::Current()->HasAttemptedReload() ||
+                   function.ForceOptimize());
+      return;
+    }
+    edge_counters ^= ic_data_array.At(0);
+    // Counters not covering every block were not created for this graph,
+    // the blocks are then laid out without weights.
+    if (edge_counters.IsNull() ||
+        (edge_counters.Length() < flow_graph->preorder().length())) {
+      return;
+    }
+  }
 
   auto graph_entry = flow_graph->graph_entry();
   BlockEntryInstr* entry = graph_entry->normal_entry();
@@ -239,8 +258,46 @@ void BlockScheduler::ReorderBlocksJIT(FlowGraph* flow_graph) {
   }
 }
 
+// Whether [block] is never reached according to the profile: either the
+// other successor of its branch was taken but it was not, or all of its
+// predecessors are cold. Blocks created after the edge weights were assigned
+// have no weight, so a branch whose successors both have no weight is not
+// taken as evidence of anything.
+static bool IsCold(BlockEntryInstr* block, const GrowableArray<bool>& is_cold) {
+  if (block->IsFunctionEntry() || block->IsGraphEntry() ||
+      block->IsCatchBlockEntry() || block->IsOsrEntry()) {
+    return false;
+  }
+  if (auto target = block->AsTargetEntry()) {
+    auto branch = block->PredecessorAt(0)->last_instruction()->AsBranch();
+    if ((branch != nullptr) && (target->edge_weight() == 0.0)) {
+      TargetEntryInstr* other = (branch->true_successor() == target)
+                                    ? branch->false_successor()
+                                    : branch->true_successor();
+      if (other->edge_weight() > 0.0) {
+        return true;
+      }
+    }
+  }
+  if (block->PredecessorCount() == 0) {
+    return false;
+  }
+  for (intptr_t i = 0; i < block->PredecessorCount(); ++i) {
+    // Predecessors along back edges have not been visited yet and are
+    // treated as hot.
+    if (!is_cold[block->PredecessorAt(i)->preorder_number()]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Moves blocks ending in a throw/rethrow, as well as any block post-dominated
 // by such a throwing block, to the end.
+//
+// If a profile was given to the precompiler, the blocks are first laid out in
+// chains along the hottest edges as in JIT mode, and blocks which were never
+// reached in the profile are moved to the end as well.
 void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
   if (!FLAG_reorder_basic_blocks) {
     return;
@@ -282,18 +339,39 @@ void BlockScheduler::ReorderBlocksAOT(FlowGraph* flow_graph) {
     }
   }
 
-  // Emit code in reverse postorder but move any throwing blocks (except the
-  // function entry, which needs to come first) to the very end.
   auto codegen_order = flow_graph->CodegenBlockOrder(true);
+  GrowableArray<BlockEntryInstr*> order(block_count);
+  if (flow_graph->graph_entry()->entry_count() > 0) {
+    GrowableArray<bool> is_cold(block_count);
+    is_cold.FillWith(false, 0, block_count);
+    for (intptr_t i = 0; i < block_count; ++i) {
+      auto block = reverse_postorder[i];
+      is_cold[block->preorder_number()] = IsCold(block, is_cold);
+    }
+    for (intptr_t i = 0; i < block_count; ++i) {
+      const intptr_t preorder_nr = reverse_postorder[i]->preorder_number();
+      is_terminating[preorder_nr] =
+          is_terminating[preorder_nr] || is_cold[preorder_nr];
+    }
+
+    ReorderBlocksJIT(flow_graph);
+    order.AddArray(*codegen_order);
+    codegen_order->Clear();
+  } else {
+    order.AddArray(reverse_postorder);
+  }
+
+  // Emit code in the chosen order but move any throwing blocks (except the
+  // function entry, which needs to come first) to the very end.
   for (intptr_t i = 0; i < block_count; ++i) {
-    auto block = reverse_postorder[i];
+    auto block = order[i];
     const intptr_t preorder_nr = block->preorder_number();
     if (!is_terminating[preorder_nr] || block->IsFunctionEntry()) {
       codegen_order->Add(block);
     }
   }
   for (intptr_t i = 0; i < block_count; ++i) {
-    auto block = reverse_postorder[i];
+    auto block = order[i];
     const intptr_t preorder_nr = block->preorder_number();
     if (is_terminating[preorder_nr] && !block->IsFunctionEntry()) {
       codegen_order->Add(block);
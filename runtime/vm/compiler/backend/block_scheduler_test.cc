@@ -0,0 +1,71 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/block_scheduler.h"
+
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+static const char* kBranchyScript =
+    R"(
+      int foo(int x) {
+        int result = 0;
+        for (int i = 0; i < x; i++) {
+          if (i % 3 == 0) {
+            result += i;
+          } else {
+            result -= 1;
+          }
+        }
+        return result;
+      }
+
+      main() {
+        for (int i = 0; i < 10; i++) {
+          foo(i);
+        }
+      }
+    )";
+
+ISOLATE_UNIT_TEST_CASE(BlockScheduler_AssignEdgeWeights) {
+  SetFlagScope<bool> sfs(&FLAG_reorder_basic_blocks, true);
+  const auto& root_library = Library::Handle(LoadTestScript(kBranchyScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  Invoke(root_library, "main");
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  EXPECT(flow_graph->graph_entry()->entry_count() > 0);
+}
+
+// Edge counters which don't cover every block of the graph are ignored.
+ISOLATE_UNIT_TEST_CASE(BlockScheduler_AssignEdgeWeightsShortCounters) {
+  SetFlagScope<bool> sfs(&FLAG_reorder_basic_blocks, true);
+  const auto& root_library = Library::Handle(LoadTestScript(kBranchyScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  Invoke(root_library, "main");
+
+  const auto& ic_data_array = Array::Handle(function.ic_data_array());
+  EXPECT(!ic_data_array.IsNull());
+  const auto& edge_counters = Array::Handle(Array::New(1));
+  edge_counters.SetAt(0, Smi::Handle(Smi::New(10)));
+  ic_data_array.SetAt(0, edge_counters);
+
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  EXPECT_EQ(0, flow_graph->graph_entry()->entry_count());
+  for (BlockIterator it = flow_graph->reverse_postorder_iterator(); !it.Done();
+       it.Advance()) {
+    if (auto target = it.Current()->AsTargetEntry()) {
+      EXPECT_EQ(0.0, target->edge_weight());
+    }
+  }
+}
+
+}  // namespace dart
@@ -12,6 +12,8 @@ CombinedCodeStatistics::CombinedCodeStatistics() {
   object_header_bytes_ = 0;
   return_const_count_ = 0;
   return_const_with_load_field_count_ = 0;
+  spill_count_ = 0;
+  reload_count_ = 0;
   intptr_t i = 0;
 
 #define DO(type, attrs)                                                        \
@@ -105,6 +107,9 @@ void CombinedCodeStatistics::DumpStatistics() {
   OS::PrintErr("% 8" Pd " return-constant-with-load-field functions\n",
                return_const_with_load_field_count_);
   OS::PrintErr("--------------------\n");
+  OS::PrintErr("% 8" Pd " spills\n", spill_count_);
+  OS::PrintErr("% 8" Pd " reloads\n", reload_count_);
+  OS::PrintErr("--------------------\n");
 }
 
 int CombinedCodeStatistics::CompareEntries(const void* a, const void* b) {
@@ -125,6 +130,8 @@ CodeStatistics::CodeStatistics(compiler::Assembler* assembler)
   instruction_bytes_ = 0;
   unaccounted_bytes_ = 0;
   alignment_bytes_ = 0;
+  spill_count_ = 0;
+  reload_count_ = 0;
 
   stack_index_ = -1;
   for (intptr_t i = 0; i < kStackSize; i++)
@@ -132,6 +139,18 @@ CodeStatistics::CodeStatistics(compiler::Assembler* assembler)
 }
 
 void CodeStatistics::Begin(Instruction* instruction) {
+  if (ParallelMoveInstr* parallel_move = instruction->AsParallelMove()) {
+    for (intptr_t i = 0; i < parallel_move->NumMoves(); i++) {
+      MoveOperands* move = parallel_move->MoveOperandsAt(i);
+      if (move->IsRedundant()) continue;
+      if (move->src().IsMachineRegister() && move->dest().HasStackIndex()) {
+        spill_count_++;
+      } else if (move->src().HasStackIndex() &&
+                 move->dest().IsMachineRegister()) {
+        reload_count_++;
+      }
+    }
+  }
   SpecialBegin(static_cast<intptr_t>(instruction->statistics_tag()));
 }
 
@@ -202,6 +221,8 @@ void CodeStatistics::AppendTo(CombinedCodeStatistics* stat) {
   ASSERT(stat->unaccounted_bytes_ >= 0);
   stat->alignment_bytes_ += alignment_bytes_;
   stat->object_header_bytes_ += Instructions::HeaderSize();
+  stat->spill_count_ += spill_count_;
+  stat->reload_count_ += reload_count_;
 
   if (returns_constant) stat->return_const_count_++;
   if (returns_const_with_load_field_) {
@@ -67,6 +67,8 @@ class CombinedCodeStatistics {
   intptr_t object_header_bytes_;
   intptr_t return_const_count_;
   intptr_t return_const_with_load_field_count_;
+  intptr_t spill_count_;
+  intptr_t reload_count_;
 };
 
 class CodeStatistics {
@@ -98,6 +100,11 @@ class CodeStatistics {
   intptr_t unaccounted_bytes_;
   intptr_t alignment_bytes_;
 
+  // Moves inserted by the register allocator from a register to a stack slot
+  // and back.
+  intptr_t spill_count_;
+  intptr_t reload_count_;
+
   intptr_t stack_[kStackSize];
   intptr_t stack_index_;
 };
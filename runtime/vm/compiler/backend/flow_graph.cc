@@ -25,6 +25,11 @@ DEFINE_FLAG(bool, use_smi_widening, false, "Enable Smi->Int32 widening pass.");
 DEFINE_FLAG(bool, trace_smi_widening, false, "Trace Smi->Int32 widening pass.");
 #endif
 DEFINE_FLAG(bool, prune_dead_locals, true, "optimize dead locals away");
+DEFINE_FLAG(bool,
+            guard_late_extended_classes,
+            true,
+            "Guard calls on classes which were extended after CHA based "
+            "optimizations with class id checks instead of using CHA.");
 
 // Quick access to the current zone.
 #define Z (zone())
@@ -465,6 +470,43 @@ bool FlowGraph::IsReceiver(Definition* def) const {
   return (phi->is_receiver() == PhiInstr::kReceiver);
 }
 
+ClassPtr FlowGraph::ReceiverClassForCHA(InstanceCallInstr* call,
+                                        bool* receiver_maybe_null) const {
+  // Best effort to get the receiver class.
+  Value* receiver = call->Receiver();
+  *receiver_maybe_null = false;
+  if (function().IsDynamicFunction() && IsReceiver(receiver->definition())) {
+    // Call receiver is callee receiver: calling "this.g()" in f().
+    return function().Owner();
+  }
+  // Get the receiver's compile type. Note that
+  // we allow nullable types, which may result in just generating
+  // a null check rather than the more elaborate class check
+  CompileType* type = receiver->Type();
+  const AbstractType* atype = type->ToAbstractType();
+  if (atype->IsInstantiated() && atype->HasTypeClass() &&
+      !atype->IsDynamicType()) {
+    if (type->is_nullable()) {
+      *receiver_maybe_null = true;
+    }
+    const Class& receiver_class = Class::Handle(zone(), atype->type_class());
+    if (!receiver_class.is_implemented()) {
+      return receiver_class.raw();
+    }
+  }
+  return Class::null();
+}
+
+bool FlowGraph::IsReceiverClassExtendedLate(InstanceCallInstr* call) const {
+  if (!FLAG_guard_late_extended_classes) {
+    return false;
+  }
+  bool receiver_maybe_null = false;
+  const Class& receiver_class =
+      Class::Handle(zone(), ReceiverClassForCHA(call, &receiver_maybe_null));
+  return !receiver_class.IsNull() && receiver_class.is_cha_deoptimized();
+}
+
 FlowGraph::ToCheck FlowGraph::CheckForInstanceCall(
     InstanceCallInstr* call,
     FunctionLayout::Kind kind) const {
@@ -474,34 +516,23 @@ FlowGraph::ToCheck FlowGraph::CheckForInstanceCall(
     return ToCheck::kCheckCid;
   }
 
-  // Best effort to get the receiver class.
-  Value* receiver = call->Receiver();
-  Class& receiver_class = Class::Handle(zone());
   bool receiver_maybe_null = false;
-  if (function().IsDynamicFunction() && IsReceiver(receiver->definition())) {
-    // Call receiver is callee receiver: calling "this.g()" in f().
-    receiver_class = function().Owner();
-  } else {
-    // Get the receiver's compile type. Note that
-    // we allow nullable types, which may result in just generating
-    // a null check rather than the more elaborate class check
-    CompileType* type = receiver->Type();
-    const AbstractType* atype = type->ToAbstractType();
-    if (atype->IsInstantiated() && atype->HasTypeClass() &&
-        !atype->IsDynamicType()) {
-      if (type->is_nullable()) {
-        receiver_maybe_null = true;
-      }
-      receiver_class = atype->type_class();
-      if (receiver_class.is_implemented()) {
-        receiver_class = Class::null();
-      }
-    }
-  }
+  const Class& receiver_class =
+      Class::Handle(zone(), ReceiverClassForCHA(call, &receiver_maybe_null));
 
   // Useful receiver class information?
   if (receiver_class.IsNull()) {
     return ToCheck::kCheckCid;
+  } else if (FLAG_guard_late_extended_classes &&
+             receiver_class.is_cha_deoptimized()) {
+    // Code relying on CHA for this class was already deoptimized once when
+    // it got extended, so it is likely to get extended again. Check the
+    // receiver's class id instead of registering another CHA dependency.
+    if (FLAG_trace_cha) {
+      THR_Print("  **(CHA) Not using CHA for '%s' which was extended late\n",
+                receiver_class.ToCString());
+    }
+    return ToCheck::kCheckCid;
   } else if (call->HasICData()) {
     // If the static class type does not match information found in ICData
     // (which may be "guessed"), then bail, since subsequent code generation
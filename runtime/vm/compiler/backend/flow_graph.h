@@ -238,6 +238,11 @@ class FlowGraph : public ZoneAllocated {
   ToCheck CheckForInstanceCall(InstanceCallInstr* call,
                                FunctionLayout::Kind kind) const;
 
+  // Returns true if the receiver class of [call] got extended after code
+  // relying on CHA for it was compiled. Calls on such receivers should use
+  // non-deoptimizing class id checks.
+  bool IsReceiverClassExtendedLate(InstanceCallInstr* call) const;
+
   Thread* thread() const { return thread_; }
   Zone* zone() const { return thread()->zone(); }
   Isolate* isolate() const { return thread()->isolate(); }
@@ -466,6 +471,10 @@ class FlowGraph : public ZoneAllocated {
   friend class DeadCodeElimination;
   friend class compiler::GraphIntrinsifier;
 
+  // Returns the class CHA can use for the receiver of [call], or null.
+  ClassPtr ReceiverClassForCHA(InstanceCallInstr* call,
+                               bool* receiver_maybe_null) const;
+
   void CompressPath(intptr_t start_index,
                     intptr_t current_index,
                     GrowableArray<intptr_t>* parent,
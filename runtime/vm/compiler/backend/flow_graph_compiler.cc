@@ -57,6 +57,11 @@ DEFINE_FLAG(int,
             2000,
             "The scale of invocation count, by size of the function.");
 DEFINE_FLAG(bool, source_lines, false, "Emit source line as assembly comment.");
+DEFINE_FLAG(int,
+            polymorphic_binary_search_threshold,
+            8,
+            "Dispatch polymorphic calls with at least this many receiver class "
+            "ranges by a binary search over the class ids.");
 
 DECLARE_FLAG(charp, deoptimize_filter);
 DECLARE_FLAG(bool, intrinsify);
@@ -2172,12 +2177,19 @@ void FlowGraphCompiler::EmitTestAndCall(const CallTargets& targets,
     return;
   }
 
-  bool add_megamorphic_call = false;
-  int bias = 0;
-
   // Value is not Smi.
   EmitTestAndCallLoadCid(EmitTestCidRegister());
 
+  if (non_smi_length >= FLAG_polymorphic_binary_search_threshold) {
+    EmitTestAndCallBinarySearch(targets, which_case_to_skip, failed,
+                                match_found, deopt_id, token_index, locs,
+                                complete, args_info, entry_kind);
+    return;
+  }
+
+  bool add_megamorphic_call = false;
+  int bias = 0;
+
   int last_check = which_case_to_skip == length - 1 ? length - 2 : length - 1;
 
   for (intptr_t i = 0; i < length; i++) {
@@ -2217,6 +2229,97 @@ void FlowGraphCompiler::EmitTestAndCall(const CallTargets& targets,
   }
 }
 
+// Dispatches on the receiver's class id by a binary search over the cid
+// ranges of the targets, so that every target is reached with a logarithmic
+// number of comparisons instead of testing the cases one by one in order of
+// their frequency. As for the last case of the linear search, classes which
+// are not among the targets of an incomplete call go to [failed].
+void FlowGraphCompiler::EmitTestAndCallBinarySearch(
+    const CallTargets& targets,
+    intptr_t case_to_skip,
+    compiler::Label* failed,
+    compiler::Label* match_found,
+    intptr_t deopt_id,
+    TokenPosition token_index,
+    LocationSummary* locs,
+    bool complete,
+    ArgumentsInfo args_info,
+    Code::EntryKind entry_kind) {
+  GrowableArray<intptr_t> cases(targets.length());
+  for (intptr_t i = 0; i < targets.length(); i++) {
+    if (i == case_to_skip) continue;
+    intptr_t j = cases.length();
+    cases.Add(i);
+    // Insertion sort by cid, the ranges of the targets are disjoint.
+    while ((j > 0) &&
+           (targets[cases[j - 1]].cid_start > targets[cases[j]].cid_start)) {
+      cases.Swap(j - 1, j);
+      j--;
+    }
+  }
+  EmitTestAndCallBinarySearchRange(targets, cases, 0, cases.length() - 1,
+                                   /*lower_bound_known=*/false, failed,
+                                   match_found, deopt_id, token_index, locs,
+                                   complete, args_info, entry_kind);
+}
+
+void FlowGraphCompiler::EmitTestAndCallBinarySearchRange(
+    const CallTargets& targets,
+    const GrowableArray<intptr_t>& cases,
+    intptr_t low,
+    intptr_t high,
+    bool lower_bound_known,
+    compiler::Label* failed,
+    compiler::Label* match_found,
+    intptr_t deopt_id,
+    TokenPosition token_index,
+    LocationSummary* locs,
+    bool complete,
+    ArgumentsInfo args_info,
+    Code::EntryKind entry_kind) {
+  const Register cid_reg = EmitTestCidRegister();
+  if (low == high) {
+    const CidRange& range = targets[cases[low]];
+    if (!complete) {
+      // The search only established cid_start <= cid (if at all), check that
+      // the class id is really in this case's range.
+      if (range.IsSingleCid() && !lower_bound_known) {
+        __ CompareImmediate(cid_reg, range.cid_start);
+        __ BranchIf(NOT_EQUAL, failed);
+      } else {
+        if (!lower_bound_known) {
+          __ CompareImmediate(cid_reg, range.cid_start);
+          __ BranchIf(LESS, failed);
+        }
+        __ CompareImmediate(cid_reg, range.cid_end);
+        __ BranchIf(GREATER, failed);
+      }
+    }
+    // Do not use the code from the function, but let the code be patched so
+    // that we can record the outgoing edges to other code.
+    const Function& function = *targets.TargetAt(cases[low])->target;
+    GenerateStaticDartCall(deopt_id, token_index, PcDescriptorsLayout::kOther,
+                           locs, function, entry_kind);
+    __ Drop(args_info.size_with_type_args);
+    __ Jump(match_found);
+    return;
+  }
+
+  const intptr_t middle = (low + high + 1) / 2;
+  compiler::Label below_middle;
+  __ CompareImmediate(cid_reg, targets[cases[middle]].cid_start);
+  __ BranchIf(LESS, &below_middle);
+  EmitTestAndCallBinarySearchRange(targets, cases, middle, high,
+                                   /*lower_bound_known=*/true, failed,
+                                   match_found, deopt_id, token_index, locs,
+                                   complete, args_info, entry_kind);
+  __ Bind(&below_middle);
+  EmitTestAndCallBinarySearchRange(targets, cases, low, middle - 1,
+                                   lower_bound_known, failed, match_found,
+                                   deopt_id, token_index, locs, complete,
+                                   args_info, entry_kind);
+}
+
 bool FlowGraphCompiler::GenerateSubtypeRangeCheck(Register class_id_reg,
                                                   const Class& type_class,
                                                   compiler::Label* is_subtype) {
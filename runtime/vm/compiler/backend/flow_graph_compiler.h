@@ -1008,6 +1008,31 @@ class FlowGraphCompiler : public ValueObject {
 
   void EmitTestAndCallSmiBranch(compiler::Label* label, bool jump_if_smi);
 
+  void EmitTestAndCallBinarySearch(const CallTargets& targets,
+                                   intptr_t case_to_skip,
+                                   compiler::Label* failed,
+                                   compiler::Label* match_found,
+                                   intptr_t deopt_id,
+                                   TokenPosition token_index,
+                                   LocationSummary* locs,
+                                   bool complete,
+                                   ArgumentsInfo args_info,
+                                   Code::EntryKind entry_kind);
+
+  void EmitTestAndCallBinarySearchRange(const CallTargets& targets,
+                                        const GrowableArray<intptr_t>& cases,
+                                        intptr_t low,
+                                        intptr_t high,
+                                        bool lower_bound_known,
+                                        compiler::Label* failed,
+                                        compiler::Label* match_found,
+                                        intptr_t deopt_id,
+                                        TokenPosition token_index,
+                                        LocationSummary* locs,
+                                        bool complete,
+                                        ArgumentsInfo args_info,
+                                        Code::EntryKind entry_kind);
+
   void EmitTestAndCallLoadCid(Register class_id_reg);
 
   // Type checking helper methods.
@@ -421,15 +421,11 @@ bool HierarchyInfo::CanUseGenericSubtypeRangeCheckFor(
          type.arguments() != TypeArguments::null());
 
   // If the type class is implemented the different implementations might have
-  // their type argument vector stored at different offsets and we can therefore
-  // not perform our optimized [CidRange]-based implementation.
-  //
-  // TODO(kustermann): If the class is implemented but all implementations
-  // store the instantator type argument vector at the same offset we can
-  // still do it!
-  if (type_class.is_implemented()) {
-    return false;
-  }
+  // their type argument vector stored at different offsets or might pass
+  // other type arguments to the type class. The type testing stub then only
+  // performs the [CidRange]-based checks for the implementations which store
+  // the type arguments of the type class at the same indices and offset, and
+  // leaves the others to the slow path.
 
   const TypeArguments& ta =
       TypeArguments::Handle(zone, Type::Cast(type).arguments());
@@ -270,8 +270,10 @@ class HierarchyInfo : public ThreadStackResource {
   // determine if a given instance's type is a subtype of [type].
   //
   // This is the case for [type]s with type arguments where we are able to do a
-  // [CidRange]-based subclass-check against the class and [CidRange]-based
-  // subtype-checks against the type arguments.
+  // [CidRange]-based subclass-check (or a check against the implementors
+  // sharing the layout of the type arguments, if the class is implemented)
+  // against the class and [CidRange]-based subtype-checks against the type
+  // arguments.
   //
   // This method should only be called if [CanUseSubtypeRangecheckFor] returned
   // false.
@@ -1140,6 +1142,7 @@ class Instruction : public ZoneAllocated {
   // GetDeoptId and/or CopyDeoptIdFrom.
   friend class CallSiteInliner;
   friend class LICM;
+  friend class GuardedLoop;
   friend class ComparisonInstr;
   friend class Scheduler;
   friend class BlockEntryInstr;
@@ -5025,10 +5028,12 @@ class FfiCallInstr : public Definition {
  public:
   FfiCallInstr(Zone* zone,
                intptr_t deopt_id,
-               const compiler::ffi::CallMarshaller& marshaller)
+               const compiler::ffi::CallMarshaller& marshaller,
+               bool is_leaf)
       : Definition(deopt_id),
         zone_(zone),
         marshaller_(marshaller),
+        is_leaf_(is_leaf),
         inputs_(marshaller.num_args() + 1) {
     inputs_.FillWith(nullptr, 0, marshaller.num_args() + 1);
   }
@@ -5041,16 +5046,21 @@ class FfiCallInstr : public Definition {
   // Input index of the function pointer to invoke.
   intptr_t TargetAddressIndex() const { return NativeArgCount(); }
 
+  // Leaf calls stay in generated code: they don't set up an exit frame or
+  // transition to native code, so the native function must not call back into
+  // Dart, use the Dart API or block.
+  bool is_leaf() const { return is_leaf_; }
+
   virtual intptr_t InputCount() const { return inputs_.length(); }
   virtual Value* InputAt(intptr_t i) const { return inputs_[i]; }
   virtual bool MayThrow() const {
     // By Dart_PropagateError.
-    return true;
+    return !is_leaf_;
   }
 
   // FfiCallInstr calls C code, which can call back into Dart.
   virtual bool ComputeCanDeoptimize() const {
-    return !CompilerState::Current().is_aot();
+    return !is_leaf_ && !CompilerState::Current().is_aot();
   }
 
   virtual bool HasUnknownSideEffects() const { return true; }
@@ -5077,9 +5087,11 @@ class FfiCallInstr : public Definition {
 
   void EmitParamMoves(FlowGraphCompiler* compiler);
   void EmitReturnMoves(FlowGraphCompiler* compiler);
+  void EmitLeafCall(FlowGraphCompiler* compiler);
 
   Zone* const zone_;
   const compiler::ffi::CallMarshaller& marshaller_;
+  const bool is_leaf_;
 
   GrowableArray<Value*> inputs_;
 
@@ -5550,9 +5562,12 @@ class LoadIndexedInstr : public TemplateDefinition<2, NoThrow> {
 
   Value* array() const { return inputs_[0]; }
   Value* index() const { return inputs_[1]; }
+  bool index_unboxed() const { return index_unboxed_; }
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
+  AlignmentType alignment() const { return alignment_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
+  CompileType* result_type() const { return result_type_; }
 
   virtual bool ComputeCanDeoptimize() const {
     return GetDeoptId() != DeoptId::kNone;
@@ -5821,9 +5836,12 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
   Value* index() const { return inputs_[kIndexPos]; }
   Value* value() const { return inputs_[kValuePos]; }
 
+  bool index_unboxed() const { return index_unboxed_; }
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
+  AlignmentType alignment() const { return alignment_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
+  StoreBarrierType emit_store_barrier() const { return emit_store_barrier_; }
 
   bool ShouldEmitStoreBarrier() const {
     if (array()->definition() == value()->definition()) {
@@ -7986,6 +8004,7 @@ class CheckStackOverflowInstr : public TemplateInstruction<0, NoThrow> {
   bool in_loop() const { return loop_depth_ > 0; }
   intptr_t stack_depth() const { return stack_depth_; }
   intptr_t loop_depth() const { return loop_depth_; }
+  Kind kind() const { return kind_; }
 
   DECLARE_INSTRUCTION(CheckStackOverflow)
 
@@ -1278,7 +1278,33 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// Leaf calls don't need an exit frame nor a dummy return address, because the
+// stack is never walked while the native function runs.
+void FfiCallInstr::EmitLeafCall(FlowGraphCompiler* compiler) {
+  const Register saved_fp = locs()->temp(0).reg();
+  const Register branch = locs()->in(TargetAddressIndex()).reg();
+
+  // Stack arguments are moved relative to the frame pointer saved here.
+  __ mov(saved_fp, compiler::Operand(FPREG));
+
+  // Reserve space for arguments and align frame before entering C++ world.
+  __ EnterCFrame(marshaller_.StackTopInBytes());
+
+  EmitParamMoves(compiler);
+
+  __ blx(branch);
+
+  EmitReturnMoves(compiler);
+
+  __ LeaveCFrame();
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (is_leaf_) {
+    EmitLeafCall(compiler);
+    return;
+  }
+
   const Register saved_fp = locs()->temp(0).reg();
   const Register temp = locs()->temp(1).reg();
   const Register branch = locs()->in(TargetAddressIndex()).reg();
@@ -1110,7 +1110,43 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// Leaf calls don't need an exit frame nor a dummy return address, because the
+// stack is never walked while the native function runs.
+void FfiCallInstr::EmitLeafCall(FlowGraphCompiler* compiler) {
+  const Register saved_fp = locs()->temp(0).reg();
+  const Register temp = locs()->temp(1).reg();
+  const Register branch = locs()->in(TargetAddressIndex()).reg();
+
+  // Stack arguments are moved relative to the frame pointer saved here.
+  __ mov(saved_fp, FPREG);
+
+  // Make space for arguments and align the frame.
+  __ EnterCFrame(marshaller_.StackTopInBytes());
+
+  EmitParamMoves(compiler);
+
+  // The C stack pointer must be restored from the stack limit to the top of
+  // the stack. |temp| is callee-saved.
+  __ mov(temp, CSP);
+  __ mov(CSP, SP);
+
+  __ blr(branch);
+
+  // Restore the Dart stack pointer.
+  __ mov(SP, CSP);
+  __ mov(CSP, temp);
+
+  EmitReturnMoves(compiler);
+
+  __ LeaveCFrame();
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (is_leaf_) {
+    EmitLeafCall(compiler);
+    return;
+  }
+
   const Register saved_fp = locs()->temp(0).reg();
   const Register temp = locs()->temp(1).reg();
   const Register branch = locs()->in(TargetAddressIndex()).reg();
@@ -984,7 +984,43 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// Leaf calls don't need an exit frame nor a dummy return address, because the
+// stack is never walked while the native function runs.
+void FfiCallInstr::EmitLeafCall(FlowGraphCompiler* compiler) {
+  const Register saved_fp = locs()->temp(0).reg();
+  const Register branch = locs()->in(TargetAddressIndex()).reg();
+
+  // Stack arguments are moved relative to the frame pointer saved here.
+  __ movl(saved_fp, FPREG);
+
+  // Make space for arguments and align the frame.
+  __ EnterCFrame(marshaller_.StackTopInBytes());
+
+  EmitParamMoves(compiler);
+
+  __ call(branch);
+
+  // Move a floating point return value from ST0 into XMM0, see
+  // EmitNativeCode.
+  if (representation() == kUnboxedDouble) {
+    __ fstpl(compiler::Address(SPREG, -kDoubleSize));
+    __ movsd(XMM0, compiler::Address(SPREG, -kDoubleSize));
+  } else if (representation() == kUnboxedFloat) {
+    __ fstps(compiler::Address(SPREG, -kFloatSize));
+    __ movss(XMM0, compiler::Address(SPREG, -kFloatSize));
+  }
+
+  EmitReturnMoves(compiler);
+
+  __ LeaveCFrame();
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (is_leaf_) {
+    EmitLeafCall(compiler);
+    return;
+  }
+
   const Register saved_fp = locs()->temp(0).reg();
   const Register temp = locs()->temp(1).reg();
   const Register branch = locs()->in(TargetAddressIndex()).reg();
@@ -1071,6 +1071,9 @@ void FfiCallInstr::PrintOperandsTo(BaseTextBuffer* f) const {
     marshaller_.Location(i).PrintTo(f);
     f->AddString(")");
   }
+  if (is_leaf_) {
+    f->AddString(", leaf");
+  }
 }
 
 void EnterHandleScopeInstr::PrintOperandsTo(BaseTextBuffer* f) const {
@@ -204,4 +204,81 @@ ISOLATE_UNIT_TEST_CASE(IRTest_InitializingStores) {
                             expected_stores_aot);
 }
 
+// Returns whether [flow_graph] divides by an int64 constant, i.e. whether the
+// division or modulo was lowered to a multiplication by a magic reciprocal.
+static bool HasInt64Division(FlowGraph* flow_graph) {
+  for (auto block : flow_graph->reverse_postorder()) {
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      if (auto op = it.Current()->AsBinaryInt64Op()) {
+        if ((op->op_kind() == Token::kTRUNCDIV) ||
+            (op->op_kind() == Token::kMOD)) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+ISOLATE_UNIT_TEST_CASE(IRTest_MagicDivision) {
+  const char* kScript = R"(
+    @pragma('vm:never-inline')
+    int div7(int x) => x ~/ 7;
+    @pragma('vm:never-inline')
+    int mod7(int x) => x % 7;
+    @pragma('vm:never-inline')
+    int div8(int x) => x ~/ 8;
+    @pragma('vm:never-inline')
+    int divBy(int x, int y) => x ~/ y;
+
+    main() {
+      for (int i = -50; i < 50; i++) {
+        div7(i);
+        mod7(i);
+        div8(i);
+        divBy(i, 7);
+      }
+    }
+
+    bool check() {
+      for (int i = -1000; i < 1000; i++) {
+        final int quotient = (i / 7).truncate();
+        final int remainder = i - 7 * quotient;
+        if (div7(i) != quotient) return false;
+        if (mod7(i) != (remainder < 0 ? remainder + 7 : remainder)) {
+          return false;
+        }
+      }
+      return true;
+    }
+  )";
+
+#if defined(TARGET_ARCH_X64)
+  const bool expect_magic = true;
+#elif defined(TARGET_ARCH_ARM64)
+  const bool expect_magic = FLAG_optimization_level > 2;
+#else
+  const bool expect_magic = false;
+#endif
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  // Divisors which are not powers of two take the magic division path.
+  for (const char* name : {"div7", "mod7"}) {
+    const auto& function = Function::Handle(GetFunction(root_library, name));
+    TestPipeline pipeline(function, CompilerPass::kJIT);
+    EXPECT_EQ(expect_magic, HasInt64Division(pipeline.RunPasses({})));
+    pipeline.CompileGraphAndAttachFunction();
+  }
+  EXPECT(Invoke(root_library, "check") == Bool::True().raw());
+
+  // Powers of two and non-constant divisors keep the plain Smi division.
+  for (const char* name : {"div8", "divBy"}) {
+    const auto& function = Function::Handle(GetFunction(root_library, name));
+    TestPipeline pipeline(function, CompilerPass::kJIT);
+    EXPECT(!HasInt64Division(pipeline.RunPasses({})));
+  }
+}
+
 }  // namespace dart
@@ -1041,7 +1041,33 @@ void NativeCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ Drop(ArgumentCount());  // Drop the arguments.
 }
 
+// Leaf calls don't need an exit frame nor a dummy return address, because the
+// stack is never walked while the native function runs.
+void FfiCallInstr::EmitLeafCall(FlowGraphCompiler* compiler) {
+  const Register saved_fp = locs()->temp(0).reg();
+  const Register target_address = locs()->in(TargetAddressIndex()).reg();
+
+  // Stack arguments are moved relative to the frame pointer saved here.
+  __ movq(saved_fp, FPREG);
+
+  // Make space for arguments and align the frame.
+  __ EnterCFrame(marshaller_.StackTopInBytes());
+
+  EmitParamMoves(compiler);
+
+  __ CallCFunction(target_address);
+
+  EmitReturnMoves(compiler);
+
+  __ LeaveCFrame();
+}
+
 void FfiCallInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (is_leaf_) {
+    EmitLeafCall(compiler);
+    return;
+  }
+
   const Register saved_fp = locs()->temp(0).reg();
   const Register target_address = locs()->in(TargetAddressIndex()).reg();
 
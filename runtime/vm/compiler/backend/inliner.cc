@@ -5,6 +5,7 @@
 #include "vm/compiler/backend/inliner.h"
 
 #include "vm/compiler/aot/aot_call_specializer.h"
+#include "vm/compiler/aot/call_profile.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
@@ -50,6 +51,11 @@ DEFINE_FLAG(int,
             inlining_callee_call_sites_threshold,
             1,
             "Always inline functions containing threshold or fewer calls.");
+DEFINE_FLAG(int,
+            inlining_non_escaping_size_threshold,
+            75,
+            "Inline functions up to threshold size if an allocation passed to "
+            "them does not escape.");
 DEFINE_FLAG(int,
             inlining_callee_size_threshold,
             160,
@@ -98,6 +104,40 @@ DECLARE_FLAG(bool, print_flow_graph_optimized);
     }                                                                          \
   } while (false)
 
+// Under AOT, returns the profile given with --inlining_profile, or null.
+static const CallProfile* InliningProfile() {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+  Precompiler* precompiler = Precompiler::Instance();
+  if (CompilerState::Current().is_aot() && (precompiler != nullptr)) {
+    return precompiler->inlining_profile();
+  }
+#endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+  return nullptr;
+}
+
+// The samples of [profile] in which [function] was running, or in which
+// [caller] was calling [callee], respectively.
+static int64_t ProfiledSamplesOf(const CallProfile* profile,
+                                 const Function& function) {
+#if defined(DART_PRECOMPILER)
+  return profile->SamplesOf(function);
+#else
+  UNREACHABLE();
+  return 0;
+#endif  // defined(DART_PRECOMPILER)
+}
+
+static int64_t ProfiledCallSamplesOf(const CallProfile* profile,
+                                     const Function& caller,
+                                     const Function& callee) {
+#if defined(DART_PRECOMPILER)
+  return profile->CallSamplesOf(caller, callee);
+#else
+  UNREACHABLE();
+  return 0;
+#endif  // defined(DART_PRECOMPILER)
+}
+
 // Test and obtain Smi value.
 static bool IsSmiValue(Value* val, intptr_t* int_val) {
   if (val->BindsToConstant() && val->BoundConstant().IsSmi()) {
@@ -241,6 +281,110 @@ class GraphInfoCollector : public ValueObject {
   intptr_t instruction_count_;
 };
 
+// Helper to compute the parameters of a function which do not escape it and
+// whose allocation can therefore be sunk once the function is inlined. To
+// match what allocation sinking supports, the only non-escaping uses are as
+// the instance of field loads and stores and, through summaries computed
+// earlier, as an argument to a static call which does not let it escape.
+class EscapeInfoCollector : public ValueObject {
+ public:
+  // Bit i of the summary is set if parameter i does not escape. The top bit
+  // is set once the summary has been computed.
+  static const intptr_t kMaxParameters = kBitsPerByte - 1;
+  static const uint8_t kComputedBit = 1 << kMaxParameters;
+
+  explicit EscapeInfoCollector(Zone* zone) : aliases_(zone, 4) {}
+
+  uint8_t Collect(const FlowGraph& graph,
+                  const ZoneGrowableArray<Definition*>* parameters) {
+    // Optional parameters are copied into locals by the prologue and are
+    // not worth tracking.
+    if (graph.function().HasOptionalParameters()) {
+      return kComputedBit;
+    }
+    uint8_t summary = kComputedBit;
+    if (parameters != NULL) {
+      for (intptr_t i = 0; i < parameters->length(); ++i) {
+        summary |= NonEscapingBit((*parameters)[i]);
+      }
+      return summary;
+    }
+    // Parameters are defined separately in each entry, and escape if they
+    // escape in one of them.
+    uint8_t escaping = 0;
+    FunctionEntryInstr* entries[] = {graph.graph_entry()->normal_entry(),
+                                     graph.graph_entry()->unchecked_entry()};
+    for (FunctionEntryInstr* entry : entries) {
+      if (entry == NULL) continue;
+      for (Definition* def : *entry->initial_definitions()) {
+        ParameterInstr* param = def->AsParameter();
+        if (param == NULL || param->index() < 0 ||
+            param->index() >= kMaxParameters) {
+          continue;
+        }
+        const uint8_t bit = 1 << param->index();
+        if (NonEscapingBit(param) != 0) {
+          summary |= bit;
+        } else {
+          escaping |= bit;
+        }
+      }
+    }
+    return summary & ~escaping;
+  }
+
+ private:
+  uint8_t NonEscapingBit(Definition* def) {
+    ParameterInstr* param = def->AsParameter();
+    if (param == NULL || param->index() < 0 ||
+        param->index() >= kMaxParameters || Escapes(param)) {
+      return 0;
+    }
+    return 1 << param->index();
+  }
+
+  bool Escapes(Definition* param) {
+    aliases_.Clear();
+    aliases_.Add(param);
+    for (intptr_t i = 0; i < aliases_.length(); ++i) {
+      for (Value* use = aliases_[i]->input_use_list(); use != NULL;
+           use = use->next_use()) {
+        if (!IsNonEscapingUse(use)) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  bool IsNonEscapingUse(Value* use) {
+    Instruction* instr = use->instruction();
+    if (instr->IsLoadField() || instr->IsMaterializeObject()) {
+      return true;
+    }
+    if (StoreInstanceFieldInstr* store = instr->AsStoreInstanceField()) {
+      return use == store->instance();
+    }
+    if (instr->IsRedefinition() || instr->IsCheckNull() || instr->IsPhi()) {
+      // The value may be used under a different name.
+      Definition* alias = instr->AsDefinition();
+      for (intptr_t i = 0; i < aliases_.length(); ++i) {
+        if (aliases_[i] == alias) return true;
+      }
+      aliases_.Add(alias);
+      return true;
+    }
+    if (StaticCallInstr* call = instr->AsStaticCall()) {
+      const intptr_t index = use->use_index() - call->FirstArgIndex();
+      return (use->use_index() < call->ArgumentCount()) && (index >= 0) &&
+             FlowGraphInliner::IsNonEscapingParameter(call->function(), index);
+    }
+    return false;
+  }
+
+  GrowableArray<Definition*> aliases_;
+};
+
 // Structure for collecting inline data needed to print inlining tree.
 struct InlinedInfo {
   const Function* caller;
@@ -248,23 +392,51 @@ struct InlinedInfo {
   intptr_t inlined_depth;
   const Definition* call_instr;
   const char* bailout_reason;
+  const char* inlining_reason;
   InlinedInfo(const Function* caller_function,
               const Function* inlined_function,
               const intptr_t depth,
               const Definition* call,
-              const char* reason)
+              const char* reason,
+              const char* inlined_reason = NULL)
       : caller(caller_function),
         inlined(inlined_function),
         inlined_depth(depth),
         call_instr(call),
-        bailout_reason(reason) {}
+        bailout_reason(reason),
+        inlining_reason(inlined_reason) {}
 };
 
 // A collection of call sites to consider for inlining.
 class CallSites : public ValueObject {
  public:
-  explicit CallSites(intptr_t threshold)
+  // Where the call counts behind the ratios of call sites come from.
+  enum class CountSource {
+    // JIT call counts, or the AOT estimate based on nesting depth.
+    kCallCounts,
+    // AOT, the samples of --inlining_profile in which the caller (or the
+    // function it is inlined into) was calling the callee.
+    kProfile,
+    // AOT, the estimate for callers which --inlining_profile never sampled.
+    kUnsampledCaller,
+  };
+
+  static const char* CountSourceToCString(CountSource source) {
+    switch (source) {
+      case CountSource::kCallCounts:
+        return "call counts";
+      case CountSource::kProfile:
+        return "profile";
+      case CountSource::kUnsampledCaller:
+        return "caller not in profile";
+    }
+    UNREACHABLE();
+    return NULL;
+  }
+
+  CallSites(intptr_t threshold, const Function& top)
       : inlining_depth_threshold_(threshold),
+        top_(top),
         static_calls_(),
         closure_calls_(),
         instance_calls_() {}
@@ -287,6 +459,7 @@ class CallSites : public ValueObject {
   struct StaticCallInfo {
     StaticCallInstr* call;
     double ratio;
+    CountSource count_source;
     FlowGraph* caller_graph;
     intptr_t nesting_depth;
     StaticCallInfo(StaticCallInstr* value,
@@ -294,6 +467,7 @@ class CallSites : public ValueObject {
                    intptr_t depth)
         : call(value),
           ratio(0.0),
+          count_source(CountSource::kCallCounts),
           caller_graph(flow_graph),
           nesting_depth(depth) {}
     const Function& caller() const { return caller_graph->function(); }
@@ -354,37 +528,76 @@ class CallSites : public ValueObject {
     }
   }
 
+  // Samples in which the code of [caller] called [callee]. Calls which the
+  // JIT had inlined into the top-level function were sampled in its frame.
+  intptr_t ProfiledCallCount(const Function& caller, const Function& callee) {
+    const CallProfile* profile = InliningProfile();
+    int64_t count = ProfiledCallSamplesOf(profile, caller, callee);
+    if (caller.raw() != top_.raw()) {
+      count += ProfiledCallSamplesOf(profile, top_, callee);
+    }
+    return static_cast<intptr_t>(count);
+  }
+
+  CountSource CountSourceOf(const Function& caller) {
+    const CallProfile* profile = InliningProfile();
+    if (profile == nullptr) {
+      return CountSource::kCallCounts;
+    }
+    if ((ProfiledSamplesOf(profile, caller) > 0) ||
+        (ProfiledSamplesOf(profile, top_) > 0)) {
+      return CountSource::kProfile;
+    }
+    return CountSource::kUnsampledCaller;
+  }
+
   // Computes the ratio for each call site in a method, defined as the
   // number of times a call site is executed over the maximum number of
   // times any call site is executed in the method. JIT uses actual call
-  // counts whereas AOT uses a static estimate based on nesting depth.
-  void ComputeCallSiteRatio(intptr_t static_call_start_ix,
+  // counts whereas AOT uses the samples of --inlining_profile if it has any
+  // of the method, and a static estimate based on nesting depth otherwise.
+  void ComputeCallSiteRatio(const Function& caller,
+                            intptr_t static_call_start_ix,
                             intptr_t instance_call_start_ix) {
     const intptr_t num_static_calls =
         static_calls_.length() - static_call_start_ix;
     const intptr_t num_instance_calls =
         instance_calls_.length() - instance_call_start_ix;
+    const CountSource source = CountSourceOf(caller);
 
     intptr_t max_count = 0;
     GrowableArray<intptr_t> instance_call_counts(num_instance_calls);
     for (intptr_t i = 0; i < num_instance_calls; ++i) {
       const InstanceCallInfo& info =
           instance_calls_[i + instance_call_start_ix];
-      intptr_t aggregate_count =
-          CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
-              : info.call->CallCount();
+      intptr_t aggregate_count = 0;
+      if (source == CountSource::kProfile) {
+        const CallTargets& targets = info.call->targets();
+        for (intptr_t j = 0; j < targets.length(); ++j) {
+          aggregate_count +=
+              ProfiledCallCount(caller, *targets.TargetAt(j)->target);
+        }
+      } else if (CompilerState::Current().is_aot()) {
+        aggregate_count = AotCallCountApproximation(info.nesting_depth);
+      } else {
+        aggregate_count = info.call->CallCount();
+      }
       instance_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
 
     GrowableArray<intptr_t> static_call_counts(num_static_calls);
     for (intptr_t i = 0; i < num_static_calls; ++i) {
-      const StaticCallInfo& info = static_calls_[i + static_call_start_ix];
-      intptr_t aggregate_count =
-          CompilerState::Current().is_aot()
-              ? AotCallCountApproximation(info.nesting_depth)
-              : info.call->CallCount();
+      StaticCallInfo& info = static_calls_[i + static_call_start_ix];
+      info.count_source = source;
+      intptr_t aggregate_count = 0;
+      if (source == CountSource::kProfile) {
+        aggregate_count = ProfiledCallCount(caller, info.call->function());
+      } else if (CompilerState::Current().is_aot()) {
+        aggregate_count = AotCallCountApproximation(info.nesting_depth);
+      } else {
+        aggregate_count = info.call->CallCount();
+      }
       static_call_counts.Add(aggregate_count);
       if (aggregate_count > max_count) max_count = aggregate_count;
     }
@@ -517,11 +730,13 @@ class CallSites : public ValueObject {
         }
       }
     }
-    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix);
+    ComputeCallSiteRatio(graph->function(), static_call_start_ix,
+                         instance_call_start_ix);
   }
 
  private:
   intptr_t inlining_depth_threshold_;
+  const Function& top_;
   GrowableArray<StaticCallInfo> static_calls_;
   GrowableArray<ClosureCallInfo> closure_calls_;
   GrowableArray<InstanceCallInfo> instance_calls_;
@@ -579,7 +794,8 @@ struct InlinedCallData {
         parameter_stubs(NULL),
         exit_collector(NULL),
         caller(caller),
-        caller_inlining_id(caller_inlining_id) {}
+        caller_inlining_id(caller_inlining_id),
+        hot_in_profile(false) {}
 
   Definition* call;
   const Array& arguments_descriptor;
@@ -590,6 +806,8 @@ struct InlinedCallData {
   InlineExitCollector* exit_collector;
   const Function& caller;
   const intptr_t caller_inlining_id;
+  // Whether --inlining_profile shows this call to be hot in its caller.
+  bool hot_in_profile;
 };
 
 class CallSiteInliner;
@@ -789,7 +1007,9 @@ class CallSiteInliner : public ValueObject {
   // Inlining heuristics based on Cooper et al. 2008.
   InliningDecision ShouldWeInline(const Function& callee,
                                   intptr_t instr_count,
-                                  intptr_t call_site_count) {
+                                  intptr_t call_site_count,
+                                  intptr_t non_escaping_allocation_count,
+                                  bool hot_in_profile) {
     // Pragma or size heuristics.
     if (inliner_->AlwaysInline(callee)) {
       return InliningDecision::Yes("AlwaysInline");
@@ -814,8 +1034,16 @@ class CallSiteInliner : public ValueObject {
       return InliningDecision::Yes("need to count first");
     } else if (instr_count <= FLAG_inlining_size_threshold) {
       return InliningDecision::Yes("--inlining-size-threshold");
+    } else if (non_escaping_allocation_count > 0 &&
+               instr_count <= FLAG_inlining_non_escaping_size_threshold) {
+      // Inlining lets allocation sinking remove the allocations.
+      return InliningDecision::Yes("--inlining-non-escaping-size-threshold");
     } else if (call_site_count <= FLAG_inlining_callee_call_sites_threshold) {
       return InliningDecision::Yes("--inlining-callee-call-sites-threshold");
+    } else if (hot_in_profile) {
+      // The profile shows the call is worth the size of any callee that
+      // passed the size threshold above.
+      return InliningDecision::Yes("--inlining-profile");
     }
     return InliningDecision::No("default");
   }
@@ -828,8 +1056,9 @@ class CallSiteInliner : public ValueObject {
       return;
     }
     // Create two call site collections to swap between.
-    CallSites sites1(inlining_depth_threshold_);
-    CallSites sites2(inlining_depth_threshold_);
+    const Function& top = caller_graph_->function();
+    CallSites sites1(inlining_depth_threshold_, top);
+    CallSites sites2(inlining_depth_threshold_, top);
     CallSites* call_sites_temp = NULL;
     collected_call_sites_ = &sites1;
     inlining_call_sites_ = &sites2;
@@ -967,8 +1196,12 @@ class CallSiteInliner : public ValueObject {
         constant_arg_count == 0 ? function.optimized_instruction_count() : 0;
     const intptr_t call_site_count =
         constant_arg_count == 0 ? function.optimized_call_site_count() : 0;
+    const intptr_t non_escaping_allocation_count =
+        CountNonEscapingAllocations(function, *call_data);
     InliningDecision decision =
-        ShouldWeInline(function, instruction_count, call_site_count);
+        ShouldWeInline(function, instruction_count, call_site_count,
+                       non_escaping_allocation_count,
+                       call_data->hot_in_profile);
     if (!decision.value) {
       TRACE_INLINING(
           THR_Print("     Bailout: early heuristics (%s) with "
@@ -1194,14 +1427,24 @@ class CallSiteInliner : public ValueObject {
         FlowGraphInliner::CollectGraphInfo(callee_graph, constants_count,
                                            /*force*/ false, &instruction_count,
                                            &call_site_count);
+        if (constants_count == 0) {
+          FlowGraphInliner::CollectEscapeInfo(callee_graph, param_stubs,
+                                              /*force*/ false);
+        }
 
         // Use heuristics do decide if this call should be inlined.
         InliningDecision decision =
-            ShouldWeInline(function, instruction_count, call_site_count);
+            ShouldWeInline(function, instruction_count, call_site_count,
+                           CountNonEscapingAllocations(function, *call_data),
+                           call_data->hot_in_profile);
         if (!decision.value) {
           // If size is larger than all thresholds, don't consider it again.
-          if ((instruction_count > FLAG_inlining_size_threshold) &&
-              (call_site_count > FLAG_inlining_callee_call_sites_threshold)) {
+          // A profile may still find it worth inlining at another call site.
+          if ((InliningProfile() == nullptr) &&
+              (instruction_count > FLAG_inlining_size_threshold) &&
+              (call_site_count > FLAG_inlining_callee_call_sites_threshold) &&
+              (instruction_count > FLAG_inlining_non_escaping_size_threshold ||
+               !HasNonEscapingParameters(function))) {
             function.set_is_inlinable(false);
           }
           TRACE_INLINING(
@@ -1271,7 +1514,11 @@ class CallSiteInliner : public ValueObject {
         TRACE_INLINING(THR_Print(
             "       with reason %s, code size %" Pd ", call sites: %" Pd "\n",
             decision.reason, instruction_count, call_site_count));
-        PRINT_INLINING_TREE(NULL, &call_data->caller, &function, call);
+        if (FLAG_print_inlining_tree) {
+          inlined_info_.Add(InlinedInfo(&call_data->caller, &function,
+                                        inlining_depth_, call, NULL,
+                                        decision.reason));
+        }
         return true;
       } else {
         error = thread()->StealStickyError();
@@ -1340,8 +1587,8 @@ class CallSiteInliner : public ValueObject {
         for (int t = 0; t < depth; t++) {
           THR_Print("  ");
         }
-        THR_Print("%" Pd " %s\n", info.call_instr->GetDeoptId(),
-                  info.inlined->ToQualifiedCString());
+        THR_Print("%" Pd " %s - %s\n", info.call_instr->GetDeoptId(),
+                  info.inlined->ToQualifiedCString(), info.inlining_reason);
         PrintInlinedInfoFor(*info.inlined, depth + 1);
         call_instructions_printed.Add(info.call_instr->GetDeoptId());
       }
@@ -1388,6 +1635,33 @@ class CallSiteInliner : public ValueObject {
     return count;
   }
 
+  // Counts the arguments which are allocations allocation sinking could
+  // remove once the call is inlined, because the callee does not let them
+  // escape.
+  static intptr_t CountNonEscapingAllocations(const Function& callee,
+                                              const InlinedCallData& data) {
+    intptr_t count = 0;
+    const GrowableArray<Value*>& arguments = *data.arguments;
+    for (intptr_t i = data.first_arg_index; i < arguments.length(); i++) {
+      if (arguments[i] == NULL) continue;
+      Definition* argument = arguments[i]->definition();
+      if ((argument->IsAllocateObject() ||
+           argument->IsAllocateUninitializedContext()) &&
+          FlowGraphInliner::IsNonEscapingParameter(
+              callee, i - data.first_arg_index)) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  static bool HasNonEscapingParameters(const Function& function) {
+    for (intptr_t i = 0; i < function.NumParameters(); i++) {
+      if (FlowGraphInliner::IsNonEscapingParameter(function, i)) return true;
+    }
+    return false;
+  }
+
   // Parse a function reusing the cache if possible.
   ParsedFunction* GetParsedFunction(const Function& function, bool* in_cache) {
     // TODO(zerny): Use a hash map for the cache.
@@ -1420,16 +1694,22 @@ class CallSiteInliner : public ValueObject {
       }
 
       const Function& target = call->function();
+      const CallSites::CountSource count_source =
+          call_info[call_idx].count_source;
       if (!inliner_->AlwaysInline(target) &&
           (call_info[call_idx].ratio * 100) < FLAG_inlining_hotness) {
         if (trace_inlining()) {
           String& name = String::Handle(target.QualifiedUserVisibleName());
-          THR_Print("  => %s (deopt count %d)\n     Bailout: cold %f\n",
+          THR_Print("  => %s (deopt count %d)\n     Bailout: cold %f (%s)\n",
                     name.ToCString(), target.deoptimization_counter(),
-                    call_info[call_idx].ratio);
+                    call_info[call_idx].ratio,
+                    CallSites::CountSourceToCString(count_source));
         }
-        PRINT_INLINING_TREE("Too cold", &call_info[call_idx].caller(),
-                            &call->function(), call);
+        PRINT_INLINING_TREE(
+            Z->PrintToString("Too cold (%.0f%% of hottest call by %s)",
+                             call_info[call_idx].ratio * 100,
+                             CallSites::CountSourceToCString(count_source)),
+            &call_info[call_idx].caller(), &call->function(), call);
         continue;
       }
 
@@ -1441,15 +1721,22 @@ class CallSiteInliner : public ValueObject {
           call, Array::ZoneHandle(Z, call->GetArgumentsDescriptor()),
           call->FirstArgIndex(), &arguments, call_info[call_idx].caller(),
           call_info[call_idx].caller_graph->inlining_id());
+      call_data.hot_in_profile =
+          (count_source == CallSites::CountSource::kProfile);
 
       // Under AOT, calls outside loops may pass our regular heuristics due
       // to a relatively high ratio. So, unless we are optimizing solely for
       // speed, such call sites are subject to subsequent stricter heuristic
-      // to limit code size increase.
-      bool stricter_heuristic = CompilerState::Current().is_aot() &&
-                                FLAG_optimization_level <= 2 &&
-                                !inliner_->AlwaysInline(target) &&
-                                call_info[call_idx].nesting_depth == 0;
+      // to limit code size increase. That heuristic also applies to all calls
+      // of functions which a given profile never sampled, while calls a
+      // profile found hot are exempt.
+      bool stricter_heuristic =
+          CompilerState::Current().is_aot() &&
+          !inliner_->AlwaysInline(target) &&
+          ((count_source == CallSites::CountSource::kUnsampledCaller) ||
+           ((count_source == CallSites::CountSource::kCallCounts) &&
+            FLAG_optimization_level <= 2 &&
+            call_info[call_idx].nesting_depth == 0));
       if (TryInlining(call->function(), call->argument_names(), &call_data,
                       stricter_heuristic)) {
         InlineCall(&call_data);
@@ -2240,6 +2527,28 @@ void FlowGraphInliner::CollectGraphInfo(FlowGraph* flow_graph,
   *call_site_count = function.optimized_call_site_count();
 }
 
+void FlowGraphInliner::CollectEscapeInfo(
+    FlowGraph* flow_graph,
+    const ZoneGrowableArray<Definition*>* parameters,
+    bool force) {
+  const Function& function = flow_graph->function();
+  if (flow_graph->IsCompiledForOsr()) {
+    return;
+  }
+  if (force || ((function.non_escaping_parameters() &
+                 EscapeInfoCollector::kComputedBit) == 0)) {
+    EscapeInfoCollector collector(flow_graph->zone());
+    function.set_non_escaping_parameters(
+        collector.Collect(*flow_graph, parameters));
+  }
+}
+
+bool FlowGraphInliner::IsNonEscapingParameter(const Function& function,
+                                              intptr_t index) {
+  return (index < EscapeInfoCollector::kMaxParameters) &&
+         ((function.non_escaping_parameters() & (1 << index)) != 0);
+}
+
 // TODO(srdjan): This is only needed when disassembling and/or profiling.
 // Sets inlining id for all instructions of this flow-graph, as well for the
 // FlowGraph itself.
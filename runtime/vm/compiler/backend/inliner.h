@@ -116,6 +116,24 @@ class FlowGraphInliner : ValueObject {
                                intptr_t* instruction_count,
                                intptr_t* call_site_count);
 
+  // Computes which parameters of the function are only used as the instance
+  // of field loads and stores, directly or by passing them on to static calls
+  // that do the same, and caches the result on the function. Allocations
+  // passed to such parameters can be removed by allocation sinking once the
+  // call is inlined.
+  //
+  // 'parameters' are the definitions standing in for the parameters of the
+  // function, or NULL to use the Parameter instructions of the graph. Like
+  // for CollectGraphInfo, 'force' recomputes a cached value.
+  static void CollectEscapeInfo(
+      FlowGraph* flow_graph,
+      const ZoneGrowableArray<Definition*>* parameters,
+      bool force);
+
+  // Returns true if the cached escape information says that the 'index'-th
+  // parameter of the function (not counting type arguments) does not escape.
+  static bool IsNonEscapingParameter(const Function& function, intptr_t index);
+
   static void SetInliningId(FlowGraph* flow_graph, intptr_t inlining_id);
 
   bool AlwaysInline(const Function& function);
@@ -286,6 +286,42 @@ ISOLATE_UNIT_TEST_CASE(Inliner_List_generate) {
   }
 }
 
+// Test that parameters only used to access fields are summarized as not
+// escaping, unlike parameters stored elsewhere.
+ISOLATE_UNIT_TEST_CASE(Inliner_NonEscapingParameters) {
+  const char* kScript = R"(
+    class A {
+      int x;
+      int y;
+      A(this.x, this.y);
+    }
+
+    A global;
+
+    int sum(A a) => a.x + a.y;
+
+    int keep(A a) {
+      global = a;
+      return a.x;
+    }
+
+    main() {
+      sum(A(1, 2));
+      keep(A(3, 4));
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& sum = Function::Handle(GetFunction(root_library, "sum"));
+  const auto& keep = Function::Handle(GetFunction(root_library, "keep"));
+
+  TestPipeline(sum, CompilerPass::kAOT).RunPasses({});
+  TestPipeline(keep, CompilerPass::kAOT).RunPasses({});
+
+  EXPECT(FlowGraphInliner::IsNonEscapingParameter(sum, 0));
+  EXPECT(!FlowGraphInliner::IsNonEscapingParameter(keep, 0));
+}
+
 #endif  // defined(DART_PRECOMPILER)
 
 }  // namespace dart
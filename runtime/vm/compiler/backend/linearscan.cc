@@ -16,6 +16,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            spill_cost_register_allocation,
+            true,
+            "Evict registers by the cost of spilling their live ranges when "
+            "compiling AOT or functions annotated with vm:minimize-spills.");
+
 #if !defined(PRODUCT)
 #define INCLUDE_LINEAR_SCAN_TRACING_CODE
 #endif
@@ -119,7 +125,16 @@ FlowGraphAllocator::FlowGraphAllocator(const FlowGraph& flow_graph,
       quad_spill_slots_(),
       untagged_spill_slots_(),
       cpu_spill_slot_count_(0),
-      intrinsic_mode_(intrinsic_mode) {
+      intrinsic_mode_(intrinsic_mode),
+      use_spill_costs_(false) {
+  if (FLAG_spill_cost_register_allocation && !intrinsic_mode) {
+    Object& options = Object::Handle(flow_graph.zone());
+    use_spill_costs_ =
+        CompilerState::Current().is_aot() ||
+        Library::FindPragma(Thread::Current(), /*only_core=*/false,
+                            flow_graph.function(),
+                            Symbols::vm_minimize_spills(), &options);
+  }
   for (intptr_t i = 0; i < vreg_count_; i++) {
     live_ranges_.Add(NULL);
   }
@@ -2341,19 +2356,41 @@ void FlowGraphAllocator::AllocateAnyRegister(LiveRange* unallocated) {
     return;
   }
 
+  const intptr_t register_use_pos =
+      (register_use != NULL) ? register_use->pos() : unallocated->Start();
+
   intptr_t candidate = kNoRegister;
   intptr_t free_until = 0;
   intptr_t blocked_at = kMaxPosition;
+  intptr_t candidate_cost = 0;
 
   for (int reg = 0; reg < NumberOfRegisters(); ++reg) {
     if (blocked_registers_[reg]) continue;
-    if (UpdateFreeUntil(reg, unallocated, &free_until, &blocked_at)) {
+    if (!use_spill_costs_) {
+      if (UpdateFreeUntil(reg, unallocated, &free_until, &blocked_at)) {
+        candidate = reg;
+      }
+      continue;
+    }
+
+    // Among the registers that are free until the first register use,
+    // choose the one whose interfering ranges are the cheapest to evict.
+    intptr_t reg_free_until = 0;
+    intptr_t reg_blocked_at = kMaxPosition;
+    if (!UpdateFreeUntil(reg, unallocated, &reg_free_until, &reg_blocked_at) ||
+        (reg_free_until < register_use_pos)) {
+      continue;
+    }
+    const intptr_t cost = EvictionCost(reg, unallocated);
+    if ((candidate == kNoRegister) || (cost < candidate_cost) ||
+        ((cost == candidate_cost) && (reg_free_until > free_until))) {
       candidate = reg;
+      free_until = reg_free_until;
+      blocked_at = reg_blocked_at;
+      candidate_cost = cost;
     }
   }
 
-  const intptr_t register_use_pos =
-      (register_use != NULL) ? register_use->pos() : unallocated->Start();
   if (free_until < register_use_pos) {
     // Can't acquire free register. Spill until we really need one.
     ASSERT(unallocated->Start() < ToInstructionStart(register_use_pos));
@@ -2432,6 +2469,45 @@ bool FlowGraphAllocator::UpdateFreeUntil(intptr_t reg,
   return true;
 }
 
+intptr_t FlowGraphAllocator::SpillWeightAt(intptr_t pos) const {
+  // Assume each loop runs ten times, up to a depth where the weight would
+  // not matter anymore.
+  static const intptr_t kMaxDepth = 5;
+  LoopInfo* loop_info = BlockEntryAt(pos)->loop_info();
+  const intptr_t depth =
+      (loop_info != NULL) ? Utils::Minimum(loop_info->NestingDepth(), kMaxDepth)
+                          : 0;
+  intptr_t weight = 1;
+  for (intptr_t i = 0; i < depth; i++) {
+    weight *= 10;
+  }
+  return weight;
+}
+
+intptr_t FlowGraphAllocator::EvictionCost(intptr_t reg,
+                                          LiveRange* unallocated) {
+  const intptr_t start = unallocated->Start();
+  const intptr_t end = unallocated->End();
+  intptr_t cost = 0;
+  for (intptr_t i = 0; i < registers_[reg]->length(); i++) {
+    LiveRange* allocated = (*registers_[reg])[i];
+    if (allocated->vreg() < 0) continue;  // Can't be evicted.
+    const intptr_t intersection =
+        FirstIntersection(allocated->finger()->first_pending_use_interval(),
+                          unallocated->first_use_interval());
+    if (intersection == kMaxPosition) continue;
+
+    cost += SpillWeightAt(start);
+    for (UsePosition* use = allocated->first_use(); use != NULL;
+         use = use->next()) {
+      if (use->pos() < start) continue;
+      if (use->pos() >= end) break;
+      cost += SpillWeightAt(use->pos());
+    }
+  }
+  return cost;
+}
+
 void FlowGraphAllocator::RemoveEvicted(intptr_t reg, intptr_t first_evicted) {
   intptr_t to = first_evicted;
   intptr_t from = first_evicted + 1;
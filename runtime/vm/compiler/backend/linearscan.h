@@ -230,6 +230,13 @@ class FlowGraphAllocator : public ValueObject {
                        intptr_t* cur_free_until,
                        intptr_t* cur_blocked_at);
 
+  // Estimate the cost of evicting the live ranges allocated to the given
+  // register which interfere with the unallocated live range: a spill for
+  // each of them and a reload for each of their later uses, weighted by the
+  // loop nesting depth at which they happen.
+  intptr_t EvictionCost(intptr_t reg, LiveRange* unallocated);
+  intptr_t SpillWeightAt(intptr_t pos) const;
+
   // Split given live range in an optimal position between given positions.
   LiveRange* SplitBetween(LiveRange* range, intptr_t from, intptr_t to);
 
@@ -342,6 +349,12 @@ class FlowGraphAllocator : public ValueObject {
 
   const bool intrinsic_mode_;
 
+  // Whether to evict the register that is cheapest to spill rather than the
+  // one that is free for the longest. This takes more compile time and is
+  // used when compiling AOT or when the function asks for it with the
+  // vm:minimize-spills pragma.
+  bool use_spill_costs_;
+
   DISALLOW_COPY_AND_ASSIGN(FlowGraphAllocator);
 };
 
@@ -0,0 +1,104 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/linearscan.h"
+
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+
+DECLARE_FLAG(bool, spill_cost_register_allocation);
+
+// The cold values are loaded before the loop and only used after it, so
+// they are the ranges the allocator should spill to free registers for the
+// loop body.
+static const char* kSpillScript =
+    R"(
+      import 'dart:typed_data';
+
+      @pragma('vm:never-inline')
+      int foo(Int64List a, int n) {
+        final c0 = a[0], c1 = a[1], c2 = a[2], c3 = a[3];
+        final c4 = a[4], c5 = a[5], c6 = a[6], c7 = a[7];
+        final c8 = a[8], c9 = a[9], c10 = a[10], c11 = a[11];
+        final c12 = a[12], c13 = a[13], c14 = a[14], c15 = a[15];
+        int sum = 0;
+        for (int i = 16; i < n; i++) {
+          sum += a[i] * i;
+        }
+        return sum + c0 + c1 + c2 + c3 + c4 + c5 + c6 + c7 + c8 + c9 + c10 +
+            c11 + c12 + c13 + c14 + c15;
+      }
+
+      main() {
+        foo(new Int64List(32), 32);
+      }
+    )";
+
+struct MoveCounts {
+  intptr_t spills = 0;
+  intptr_t reloads_in_loop = 0;
+};
+
+static void CountMoves(ParallelMoveInstr* parallel_move,
+                       bool in_loop,
+                       MoveCounts* counts) {
+  if (parallel_move == nullptr) return;
+  for (intptr_t i = 0; i < parallel_move->NumMoves(); i++) {
+    MoveOperands* move = parallel_move->MoveOperandsAt(i);
+    if (move->IsRedundant()) continue;
+    if (move->src().IsStackSlot() && move->dest().IsRegister()) {
+      if (in_loop) counts->reloads_in_loop++;
+    } else if (move->src().IsRegister() && move->dest().IsStackSlot()) {
+      counts->spills++;
+    }
+  }
+}
+
+static MoveCounts AllocateAndCountMoves(const Function& function) {
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+  flow_graph->GetLoopHierarchy();
+
+  MoveCounts counts;
+  for (auto block : flow_graph->reverse_postorder()) {
+    const bool in_loop = block->loop_info() != nullptr;
+    CountMoves(block->parallel_move(), in_loop, &counts);
+    for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (auto parallel_move = current->AsParallelMove()) {
+        CountMoves(parallel_move, in_loop, &counts);
+      } else if (auto goto_instr = current->AsGoto()) {
+        CountMoves(goto_instr->parallel_move(), in_loop, &counts);
+      }
+    }
+  }
+  return counts;
+}
+
+ISOLATE_UNIT_TEST_CASE(LinearScan_SpillColdRangesAroundLoop) {
+  const auto& root_library = Library::Handle(LoadTestScript(kSpillScript));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  Invoke(root_library, "main");
+
+  SetFlagScope<bool> sfs(&FLAG_spill_cost_register_allocation, true);
+  const MoveCounts counts = AllocateAndCountMoves(function);
+
+  // There are more live values than registers, so something is spilled, but
+  // the spilled ranges are the cold ones: the loop never reloads from the
+  // stack.
+  EXPECT(counts.spills > 0);
+  EXPECT_EQ(0, counts.reloads_in_loop);
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
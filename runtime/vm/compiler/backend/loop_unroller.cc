@@ -0,0 +1,1168 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+#include "vm/compiler/compiler_state.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool, trace_loop_unrolling, false, "Trace loop unrolling.");
+DEFINE_FLAG(bool,
+            trace_loop_vectorization,
+            false,
+            "Trace loop vectorization.");
+
+// Bodies with more instructions than this are not unrolled.
+static const intptr_t kMaxUnrolledBodySize = 32;
+
+// Bodies with at most this many instructions are unrolled four times, larger
+// ones twice.
+static const intptr_t kMaxUnrolledBodySizeForFactor4 = 16;
+
+// Bodies with more instructions than this are not vectorized.
+static const intptr_t kMaxVectorizedBodySize = 32;
+
+// Largest nesting of integer operations in a vectorized value.
+static const intptr_t kMaxVectorizedValueDepth = 4;
+
+// Largest constant initial value of the loop control variable. Together with
+// the array length limit this keeps all arithmetic on the control variable
+// and the adjusted limit well within the Smi range.
+static const int64_t kMaxInitialValue = static_cast<int64_t>(1) << 30;
+
+typedef DirectChainedHashMap<RawPointerKeyValueTrait<Definition, Definition*>>
+    DefinitionMap;
+typedef DirectChainedHashMap<
+    RawPointerKeyValueTrait<Instruction, Instruction*>>
+    InstructionSet;
+
+static Definition* MapDefinition(Definition* def, DefinitionMap* map) {
+  Definition* mapped = map->LookupValue(def);
+  return (mapped != nullptr) ? mapped : def;
+}
+
+static Value* MapValue(Zone* zone, Value* value, DefinitionMap* map) {
+  return new (zone) Value(MapDefinition(value->definition(), map));
+}
+
+static bool IsConstantValue(Definition* def, intptr_t value) {
+  ConstantInstr* constant = def->AsConstant();
+  return constant != nullptr && constant->value().IsSmi() &&
+         Smi::Cast(constant->value()).Value() == value;
+}
+
+// Returns true if the instruction is one of the straight-line instructions
+// CloneInstruction knows how to copy.
+static bool CanClone(Instruction* instr) {
+  return instr->IsBinaryIntegerOp() || instr->IsGenericCheckBound() ||
+         instr->IsCheckNull() || instr->IsLoadIndexed() ||
+         instr->IsStoreIndexed() || instr->IsLoadUntagged() ||
+         instr->IsBoxInt32() || instr->IsBoxUint32() || instr->IsBoxInt64() ||
+         instr->IsUnboxUint32() || instr->IsUnboxInt64() ||
+         instr->IsIntConverter();
+}
+
+// Returns a copy of the given instruction whose inputs are mapped through
+// 'map'. The copy is not yet linked into the graph.
+static Instruction* CloneInstruction(Zone* zone,
+                                     Instruction* instr,
+                                     DefinitionMap* map) {
+  if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+    return BinaryIntegerOpInstr::Make(
+        op->representation(), op->op_kind(), MapValue(zone, op->left(), map),
+        MapValue(zone, op->right(), map), DeoptId::kNone, op->can_overflow(),
+        op->is_truncating(), nullptr, op->SpeculativeModeOfInputs());
+  }
+  if (GenericCheckBoundInstr* check = instr->AsGenericCheckBound()) {
+    return new (zone) GenericCheckBoundInstr(
+        MapValue(zone, check->length(), map),
+        MapValue(zone, check->index(), map), DeoptId::kNone);
+  }
+  if (CheckNullInstr* check = instr->AsCheckNull()) {
+    return new (zone)
+        CheckNullInstr(MapValue(zone, check->value(), map),
+                       check->function_name(), DeoptId::kNone,
+                       check->token_pos(), check->exception_type());
+  }
+  if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    return new (zone) LoadIndexedInstr(
+        MapValue(zone, load->array(), map), MapValue(zone, load->index(), map),
+        load->index_unboxed(), load->index_scale(), load->class_id(),
+        load->alignment(), DeoptId::kNone, load->token_pos(),
+        load->result_type());
+  }
+  if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    return new (zone) StoreIndexedInstr(
+        MapValue(zone, store->array(), map),
+        MapValue(zone, store->index(), map),
+        MapValue(zone, store->value(), map), store->emit_store_barrier(),
+        store->index_unboxed(), store->index_scale(), store->class_id(),
+        store->alignment(), DeoptId::kNone, store->token_pos(),
+        store->SpeculativeModeOfInputs());
+  }
+  if (LoadUntaggedInstr* load = instr->AsLoadUntagged()) {
+    return new (zone)
+        LoadUntaggedInstr(MapValue(zone, load->object(), map), load->offset());
+  }
+  if (BoxInstr* box = instr->AsBox()) {
+    return BoxInstr::Create(box->from_representation(),
+                            MapValue(zone, box->value(), map));
+  }
+  if (UnboxIntegerInstr* unbox = instr->AsUnboxInteger()) {
+    UnboxInstr* copy = UnboxInstr::Create(
+        unbox->representation(), MapValue(zone, unbox->value(), map),
+        DeoptId::kNone, unbox->SpeculativeModeOfInputs());
+    if (unbox->is_truncating()) {
+      copy->AsUnboxInteger()->mark_truncating();
+    }
+    return copy;
+  }
+  if (IntConverterInstr* conv = instr->AsIntConverter()) {
+    IntConverterInstr* copy = new (zone)
+        IntConverterInstr(conv->from(), conv->to(),
+                          MapValue(zone, conv->value(), map), DeoptId::kNone);
+    if (conv->is_truncating()) {
+      copy->mark_truncating();
+    }
+    return copy;
+  }
+  UNREACHABLE();
+  return nullptr;
+}
+
+// Copies the environment of 'from' to 'to', mapping its values through 'map'.
+static void CopyEnvironment(Zone* zone,
+                            Instruction* from,
+                            Instruction* to,
+                            DefinitionMap* map) {
+  if (from->env() == nullptr) {
+    return;
+  }
+  Environment* env = from->env()->DeepCopy(zone);
+  for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+    Value* value = it.CurrentValue();
+    value->set_definition(MapDefinition(value->definition(), map));
+  }
+  to->SetEnvironment(env);
+  for (Environment::DeepIterator it(env); !it.Done(); it.Advance()) {
+    Value* value = it.CurrentValue();
+    value->definition()->AddEnvUse(value);
+  }
+}
+
+// Inserts an unboxed 64-bit integer operation before 'next'.
+static Definition* InsertInt64Op(FlowGraph* flow_graph,
+                                 Instruction* next,
+                                 Token::Kind op_kind,
+                                 Definition* left,
+                                 Definition* right) {
+  Zone* zone = flow_graph->zone();
+  BinaryIntegerOpInstr* op = BinaryIntegerOpInstr::Make(
+      kUnboxedInt64, op_kind, new (zone) Value(left), new (zone) Value(right),
+      DeoptId::kNone, /*can_overflow=*/false, /*is_truncating=*/true, nullptr,
+      Instruction::kNotSpeculative);
+  flow_graph->InsertBefore(next, op, nullptr, FlowGraph::kValue);
+  return op;
+}
+
+// Inserts an unboxed 64-bit integer constant before 'next'.
+static Definition* InsertInt64Constant(FlowGraph* flow_graph,
+                                       Instruction* next,
+                                       int64_t value) {
+  Zone* zone = flow_graph->zone();
+  UnboxedConstantInstr* constant = new (zone) UnboxedConstantInstr(
+      Integer::ZoneHandle(zone, Integer::NewCanonical(value)), kUnboxedInt64);
+  flow_graph->InsertBefore(next, constant, nullptr, FlowGraph::kValue);
+  return constant;
+}
+
+static bool MatchCountedLoop(LoopInfo* loop, CountedLoop* counted) {
+  if (loop->inner() != nullptr || loop->back_edges().length() != 1) {
+    return false;
+  }
+
+  // The header is entered from a preheader which ends in a goto, and from
+  // the single back edge.
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if (header == nullptr || header->PredecessorCount() != 2 ||
+      header->try_index() != kInvalidTryIndex) {
+    return false;
+  }
+  BlockEntryInstr* preheader = header->PredecessorAt(0);
+  if (preheader != header->dominator() || loop->Contains(preheader) ||
+      !preheader->last_instruction()->IsGoto() ||
+      header->PredecessorAt(1) != loop->back_edges()[0]) {
+    return false;
+  }
+
+  // The header holds nothing but phis, an optional stack overflow check and
+  // the loop condition.
+  Instruction* current = header->next();
+  if (current->IsCheckStackOverflow()) {
+    current = current->next();
+  }
+  BranchInstr* branch = current->AsBranch();
+  if (branch == nullptr) {
+    return false;
+  }
+
+  // The condition is i < n with a unit stride induction i starting at a
+  // small non-negative constant, and an invariant array length n.
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if (compare == nullptr || compare->kind() != Token::kLT ||
+      (compare->operation_cid() != kSmiCid &&
+       compare->operation_cid() != kMintCid)) {
+    return false;
+  }
+  PhiInstr* control = compare->left()->definition()->AsPhi();
+  if (control == nullptr || control->block() != header) {
+    return false;
+  }
+  InductionVar* induction = loop->LookupInduction(control);
+  int64_t stride = 0;
+  int64_t initial = 0;
+  if (!InductionVar::IsLinear(induction, &stride) || stride != 1 ||
+      !InductionVar::IsConstant(induction->initial(), &initial) ||
+      initial < 0 || initial > kMaxInitialValue) {
+    return false;
+  }
+  Definition* limit = compare->right()->definition();
+  if (loop->Contains(limit->GetBlock()) ||
+      !Definition::IsArrayLength(
+          limit->OriginalDefinitionIgnoreBoxingAndConstraints()) ||
+      limit->representation() != control->representation()) {
+    return false;
+  }
+
+  // The loop is taken into a single body block which jumps back to the
+  // header.
+  TargetEntryInstr* body = branch->true_successor();
+  if (body != loop->back_edges()[0] ||
+      loop->Contains(branch->false_successor())) {
+    return false;
+  }
+  GotoInstr* back_edge = body->last_instruction()->AsGoto();
+  if (back_edge == nullptr || back_edge->successor() != header) {
+    return false;
+  }
+
+  counted->loop = loop;
+  counted->preheader = preheader;
+  counted->header = header;
+  counted->body = body;
+  counted->compare = compare;
+  counted->control = control;
+  return true;
+}
+
+// Collects the counted loops of the flow graph. All loops are matched before
+// any of them is changed, since the transformations invalidate the loop
+// hierarchy and the induction information.
+static void FindCountedLoops(FlowGraph* flow_graph,
+                             GrowableArray<CountedLoop>* loops) {
+  const LoopHierarchy& loop_hierarchy = flow_graph->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& headers =
+      loop_hierarchy.headers();
+  if (headers.is_empty()) {
+    return;
+  }
+  loop_hierarchy.ComputeInduction();
+  for (intptr_t i = 0; i < headers.length(); ++i) {
+    CountedLoop loop;
+    if (MatchCountedLoop(headers[i]->loop_info(), &loop)) {
+      loops->Add(loop);
+    }
+  }
+}
+
+// A copy H' of the header of a counted loop, which runs ahead of the
+// original loop while its control variable is below a given limit:
+//
+//   P:  goto H'
+//   H': i' = phi(i0, ...)
+//       if (i' < limit) goto B' else goto T'
+//   B': ...
+//       goto H'
+//   T': goto H
+//   H:  i = phi(i', i + 1)
+//       ...
+//
+// The original loop runs the remaining iterations.
+class GuardedLoop : public ValueObject {
+ public:
+  GuardedLoop(FlowGraph* flow_graph, const CountedLoop& loop)
+      : flow_graph_(flow_graph), loop_(loop) {}
+
+  // Creates H', B' and T' and maps the phis of H to the phis of H' in 'map'.
+  // Returns B', to be filled in by the caller.
+  TargetEntryInstr* Open(Definition* limit, DefinitionMap* map);
+
+  // Ends B' at 'cursor' with a jump back to H'. The caller must have mapped
+  // the phis of H to their values for the next iteration of H'.
+  void Close(Instruction* cursor, DefinitionMap* map);
+
+  // Appends a copy of 'instr' after 'cursor', with its inputs and environment
+  // mapped through 'map', and maps 'instr' to the copy. Returns the copy.
+  static Instruction* AppendClone(FlowGraph* flow_graph,
+                                  Instruction* cursor,
+                                  Instruction* instr,
+                                  DefinitionMap* map);
+
+ private:
+  FlowGraph* flow_graph_;
+  const CountedLoop& loop_;
+  JoinEntryInstr* header_ = nullptr;
+  GrowableArray<PhiInstr*> phis_;
+  GrowableArray<PhiInstr*> new_phis_;
+
+  DISALLOW_COPY_AND_ASSIGN(GuardedLoop);
+};
+
+TargetEntryInstr* GuardedLoop::Open(Definition* limit, DefinitionMap* map) {
+  Zone* zone = flow_graph_->zone();
+  header_ = new (zone) JoinEntryInstr(flow_graph_->allocate_block_id(),
+                                      kInvalidTryIndex, DeoptId::kNone);
+  TargetEntryInstr* body = new (zone) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), kInvalidTryIndex, DeoptId::kNone);
+  TargetEntryInstr* exit = new (zone) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), kInvalidTryIndex, DeoptId::kNone);
+
+  // Mirror the header phis. The original loop is now entered from the new
+  // loop, with the values it left off with.
+  for (PhiIterator it(loop_.header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    PhiInstr* new_phi = new (zone) PhiInstr(header_, 2);
+    new_phi->set_representation(phi->representation());
+    new_phi->mark_alive();
+    flow_graph_->AllocateSSAIndexes(new_phi);
+    header_->InsertPhi(new_phi);
+
+    Value* entry_value = phi->InputAt(0)->CopyWithType(zone);
+    new_phi->SetInputAt(0, entry_value);
+    entry_value->definition()->AddInputUse(entry_value);
+    phi->InputAt(0)->BindTo(new_phi);
+
+    phis_.Add(phi);
+    new_phis_.Add(new_phi);
+    map->Insert({phi, new_phi});
+  }
+
+  Instruction* cursor = header_;
+  CheckStackOverflowInstr* stack_check =
+      loop_.header->next()->AsCheckStackOverflow();
+  if (stack_check != nullptr) {
+    CheckStackOverflowInstr* copy = new (zone) CheckStackOverflowInstr(
+        stack_check->token_pos(), stack_check->stack_depth(),
+        stack_check->loop_depth(), DeoptId::kNone, stack_check->kind());
+    copy->CopyDeoptIdFrom(*stack_check);
+    copy->set_inlining_id(stack_check->inlining_id());
+    cursor = flow_graph_->AppendTo(cursor, copy, nullptr, FlowGraph::kEffect);
+    CopyEnvironment(zone, stack_check, copy, map);
+  }
+  ComparisonInstr* guard = loop_.compare->CopyWithNewOperands(
+      MapValue(zone, loop_.compare->left(), map), new (zone) Value(limit));
+  BranchInstr* branch = new (zone) BranchInstr(guard, DeoptId::kNone);
+  branch->set_inlining_id(loop_.compare->inlining_id());
+  flow_graph_->AppendTo(cursor, branch, nullptr, FlowGraph::kEffect);
+  *branch->true_successor_address() = body;
+  *branch->false_successor_address() = exit;
+  header_->set_last_instruction(branch);
+
+  GotoInstr* exit_goto = new (zone) GotoInstr(loop_.header, DeoptId::kNone);
+  flow_graph_->AppendTo(exit, exit_goto, nullptr, FlowGraph::kEffect);
+  exit->set_last_instruction(exit_goto);
+
+  loop_.preheader->last_instruction()->AsGoto()->set_successor(header_);
+  return body;
+}
+
+void GuardedLoop::Close(Instruction* cursor, DefinitionMap* map) {
+  Zone* zone = flow_graph_->zone();
+  GotoInstr* back_edge = new (zone) GotoInstr(header_, DeoptId::kNone);
+  flow_graph_->AppendTo(cursor, back_edge, nullptr, FlowGraph::kEffect);
+  cursor->GetBlock()->set_last_instruction(back_edge);
+
+  for (intptr_t i = 0; i < phis_.length(); ++i) {
+    Value* back_edge_value = new (zone) Value(MapDefinition(phis_[i], map));
+    new_phis_[i]->SetInputAt(1, back_edge_value);
+    back_edge_value->definition()->AddInputUse(back_edge_value);
+  }
+}
+
+// Appends a copy of 'instr' after 'cursor', with its inputs and environment
+// mapped through 'map', and maps 'instr' to the copy. Returns the copy.
+Instruction* GuardedLoop::AppendClone(FlowGraph* flow_graph,
+                                      Instruction* cursor,
+                                      Instruction* instr,
+                                      DefinitionMap* map) {
+  Zone* zone = flow_graph->zone();
+  Instruction* copy = CloneInstruction(zone, instr, map);
+  copy->CopyDeoptIdFrom(*instr);
+  if (instr->has_inlining_id()) {
+    copy->set_inlining_id(instr->inlining_id());
+  }
+  Definition* def = instr->AsDefinition();
+  if (def != nullptr && def->HasSSATemp()) {
+    flow_graph->AppendTo(cursor, copy, nullptr, FlowGraph::kValue);
+    map->Update({def, copy->AsDefinition()});
+  } else {
+    flow_graph->AppendTo(cursor, copy, nullptr, FlowGraph::kEffect);
+  }
+  CopyEnvironment(zone, instr, copy, map);
+  return copy;
+}
+
+LoopUnroller::LoopUnroller(FlowGraph* flow_graph) : flow_graph_(flow_graph) {}
+
+void LoopUnroller::Optimize() {
+  // Copies of an instruction share its deoptimization id, which is only
+  // sound when the code is never deoptimized.
+  if (!CompilerState::Current().is_aot()) {
+    return;
+  }
+
+  GrowableArray<CountedLoop> loops;
+  FindCountedLoops(flow_graph_, &loops);
+
+  bool changed = false;
+  for (intptr_t i = 0; i < loops.length(); ++i) {
+    const CountedLoop& loop = loops[i];
+    StrengthReduce(loop);
+    const intptr_t factor = UnrollFactor(loop);
+    if (factor > 1) {
+      if (FLAG_trace_loop_unrolling) {
+        THR_Print("Unrolling loop B%" Pd " of %s by %" Pd "\n",
+                  loop.header->block_id(),
+                  flow_graph_->function().ToFullyQualifiedCString(), factor);
+      }
+      Unroll(loop, factor);
+      changed = true;
+    }
+  }
+
+  if (changed) {
+    flow_graph_->DiscoverBlocks();
+    GrowableArray<BitVector*> dominance_frontier;
+    flow_graph_->ComputeDominators(&dominance_frontier);
+  }
+}
+
+// Replaces i * c for a linear induction i = a + s * k with constant a and s
+// by a new induction j = a * c + (s * c) * k.
+void LoopUnroller::StrengthReduce(const CountedLoop& loop) {
+  Zone* zone = flow_graph_->zone();
+  Instruction* preheader_goto = loop.preheader->last_instruction();
+  for (ForwardInstructionIterator it(loop.body); !it.Done(); it.Advance()) {
+    BinaryInt64OpInstr* mul = it.Current()->AsBinaryInt64Op();
+    if (mul == nullptr || mul->op_kind() != Token::kMUL) {
+      continue;
+    }
+    PhiInstr* phi = mul->left()->definition()->AsPhi();
+    UnboxedConstantInstr* factor =
+        mul->right()->definition()->AsUnboxedConstant();
+    if (phi == nullptr || phi->block() != loop.header ||
+        phi->representation() != kUnboxedInt64 || factor == nullptr ||
+        !factor->value().IsInteger()) {
+      continue;
+    }
+    InductionVar* induction = loop.loop->LookupInduction(phi);
+    int64_t stride = 0;
+    int64_t initial = 0;
+    if (!InductionVar::IsLinear(induction, &stride) ||
+        !InductionVar::IsConstant(induction->initial(), &initial)) {
+      continue;
+    }
+    const int64_t c = Integer::Cast(factor->value()).AsInt64Value();
+
+    Definition* start = InsertInt64Constant(
+        flow_graph_, preheader_goto, Utils::MulWithWrapAround(initial, c));
+    Definition* step = InsertInt64Constant(flow_graph_, preheader_goto,
+                                           Utils::MulWithWrapAround(stride, c));
+
+    PhiInstr* reduced = new (zone) PhiInstr(loop.header, 2);
+    reduced->set_representation(kUnboxedInt64);
+    reduced->mark_alive();
+    flow_graph_->AllocateSSAIndexes(reduced);
+    loop.header->InsertPhi(reduced);
+
+    Definition* add = InsertInt64Op(flow_graph_, loop.body->last_instruction(),
+                                    Token::kADD, reduced, step);
+
+    Value* entry_value = new (zone) Value(start);
+    reduced->SetInputAt(0, entry_value);
+    start->AddInputUse(entry_value);
+    Value* back_edge_value = new (zone) Value(add);
+    reduced->SetInputAt(1, back_edge_value);
+    add->AddInputUse(back_edge_value);
+
+    mul->ReplaceUsesWith(reduced);
+    it.RemoveCurrentFromGraph();
+  }
+}
+
+intptr_t LoopUnroller::UnrollFactor(const CountedLoop& loop) {
+  intptr_t size = 0;
+  for (ForwardInstructionIterator it(loop.body); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) {
+      break;
+    }
+    if (!CanClone(current)) {
+      return 0;
+    }
+    ++size;
+  }
+  if (size > kMaxUnrolledBodySize) {
+    return 0;
+  }
+  return (size <= kMaxUnrolledBodySizeForFactor4) ? 4 : 2;
+}
+
+// Runs the loop 'factor' iterations at a time while i < n - (factor - 1),
+// with 'factor' copies of the body in the guarded loop.
+//
+// In the k-th copy of the body the control variable is i' + k < n, so the
+// bounds checks of the control variable against n are redundant there.
+void LoopUnroller::Unroll(const CountedLoop& loop, intptr_t factor) {
+  Zone* zone = flow_graph_->zone();
+  RelationalOpInstr* compare = loop.compare;
+  GotoInstr* preheader_goto = loop.preheader->last_instruction()->AsGoto();
+  Definition* limit = compare->right()->definition();
+  Definition* length = limit->OriginalDefinitionIgnoreBoxingAndConstraints();
+
+  // Compute the limit of the unrolled loop in the preheader.
+  Definition* adjustment = nullptr;
+  const Smi& adjustment_value = Smi::ZoneHandle(zone, Smi::New(factor - 1));
+  if (limit->representation() == kTagged) {
+    adjustment = flow_graph_->GetConstant(adjustment_value);
+  } else {
+    adjustment = InsertInt64Constant(flow_graph_, preheader_goto, factor - 1);
+  }
+  BinaryIntegerOpInstr* unrolled_limit = BinaryIntegerOpInstr::Make(
+      limit->representation(), Token::kSUB, new (zone) Value(limit),
+      new (zone) Value(adjustment), DeoptId::kNone, /*can_overflow=*/false,
+      /*is_truncating=*/false, nullptr, compare->SpeculativeModeOfInputs());
+  flow_graph_->InsertBefore(preheader_goto, unrolled_limit, nullptr,
+                            FlowGraph::kValue);
+
+  DefinitionMap map;
+  GuardedLoop unrolled(flow_graph_, loop);
+  Instruction* cursor = unrolled.Open(unrolled_limit, &map);
+
+  GrowableArray<PhiInstr*> phis;
+  for (PhiIterator it(loop.header); !it.Done(); it.Advance()) {
+    phis.Add(it.Current());
+  }
+
+  for (intptr_t k = 0; k < factor; ++k) {
+    Definition* control = MapDefinition(loop.control, &map);
+    for (ForwardInstructionIterator it(loop.body); !it.Done(); it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsGoto()) {
+        break;
+      }
+
+      // The k-th copy runs with control + k < n, which makes checks of the
+      // control variable against the array length redundant.
+      if (GenericCheckBoundInstr* check = current->AsGenericCheckBound()) {
+        Definition* index = MapDefinition(check->index()->definition(), &map);
+        Definition* check_length =
+            check->length()
+                ->definition()
+                ->OriginalDefinitionIgnoreBoxingAndConstraints();
+        if (index->OriginalDefinitionIgnoreBoxingAndConstraints() ==
+                control->OriginalDefinitionIgnoreBoxingAndConstraints() &&
+            check_length == length) {
+          map.Update({check, index});
+          continue;
+        }
+      }
+
+      cursor = GuardedLoop::AppendClone(flow_graph_, cursor, current, &map);
+    }
+
+    // Advance the header phis to the values of the next iteration, all at
+    // once.
+    GrowableArray<Definition*> next_values(phis.length());
+    for (intptr_t i = 0; i < phis.length(); ++i) {
+      next_values.Add(MapDefinition(phis[i]->InputAt(1)->definition(), &map));
+    }
+    for (intptr_t i = 0; i < phis.length(); ++i) {
+      map.Update({phis[i], next_values[i]});
+    }
+  }
+
+  unrolled.Close(cursor, &map);
+}
+
+// The body of a counted loop which stores an element-wise function of
+// elements at the same index of other typed data arrays:
+//
+//   a[i] = f(b[i], c[i], ...)
+//
+// Instructions computing indices, data addresses and null checks are scalar
+// and are copied as is; the loads, the value and the store are vectorized.
+class ElementwiseLoop : public ValueObject {
+ public:
+  explicit ElementwiseLoop(const CountedLoop& loop) : loop_(loop) {}
+
+  bool Match();
+
+  intptr_t lanes() const { return kSimd128Size / element_size_; }
+  intptr_t vector_cid() const { return vector_cid_; }
+  intptr_t simd_cid() const { return simd_cid_; }
+  BinaryIntegerOpInstr* increment() const { return increment_; }
+  StoreIndexedInstr* store() const { return store_; }
+  Definition* target() const { return target_; }
+
+  // Loop invariant arrays loaded from, other than the target.
+  const GrowableArray<Definition*>& sources() const { return sources_; }
+
+  // Loop invariant lengths checked in the body, other than the loop limit.
+  const GrowableArray<Definition*>& lengths() const { return lengths_; }
+
+  bool IsScalar(Instruction* instr) const { return scalar_.HasKey(instr); }
+
+ private:
+  bool IsInvariant(Definition* def) const {
+    return !loop_.loop->Contains(def->GetBlock());
+  }
+  bool IsInBody(Instruction* instr) const {
+    return instr->GetBlock() == loop_.body;
+  }
+
+  void AddScalar(Instruction* instr) { scalar_.Update({instr, instr}); }
+  void AddVector(Instruction* instr) { vector_.Update({instr, instr}); }
+  void AddLength(Definition* length);
+
+  bool MatchElementType(intptr_t cid);
+  bool MatchIndex(Definition* def, GenericCheckBoundInstr** check);
+  bool MatchAccess(Value* array, Value* index, Definition** object);
+  bool MatchLoad(Definition* def);
+  bool MatchFloatValue(Definition* def);
+  bool MatchIntegerValue(Definition* def, intptr_t depth);
+  bool IsLengthOf(Definition* length, Definition* array) const;
+
+  const CountedLoop& loop_;
+  intptr_t element_cid_ = kIllegalCid;
+  intptr_t element_size_ = 0;
+  intptr_t vector_cid_ = kIllegalCid;
+  intptr_t simd_cid_ = kIllegalCid;
+  BinaryIntegerOpInstr* increment_ = nullptr;
+  StoreIndexedInstr* store_ = nullptr;
+  Definition* target_ = nullptr;
+  GrowableArray<Definition*> sources_;
+  GrowableArray<Definition*> lengths_;
+  InstructionSet scalar_;
+  InstructionSet vector_;
+
+  DISALLOW_COPY_AND_ASSIGN(ElementwiseLoop);
+};
+
+bool ElementwiseLoop::Match() {
+  // Loops computing anything but their control variable, like reductions,
+  // carry a dependence from one iteration to the next.
+  if (loop_.control->representation() != kUnboxedInt64 ||
+      loop_.compare->operation_cid() != kMintCid) {
+    return false;
+  }
+  for (PhiIterator it(loop_.header); !it.Done(); it.Advance()) {
+    if (it.Current() != loop_.control) {
+      return false;
+    }
+  }
+  increment_ = loop_.control->InputAt(1)->definition()->AsBinaryIntegerOp();
+  if (increment_ == nullptr || increment_->op_kind() != Token::kADD ||
+      !IsInBody(increment_) ||
+      increment_->left()->definition() != loop_.control ||
+      !IsConstantValue(increment_->right()->definition(), 1)) {
+    return false;
+  }
+  for (Value* use = increment_->input_use_list(); use != nullptr;
+       use = use->next_use()) {
+    if (use->instruction() != loop_.control) {
+      return false;
+    }
+  }
+
+  // The body contains a single store.
+  intptr_t size = 0;
+  for (ForwardInstructionIterator it(loop_.body); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) {
+      break;
+    }
+    if (StoreIndexedInstr* store = current->AsStoreIndexed()) {
+      if (store_ != nullptr) {
+        return false;
+      }
+      store_ = store;
+    }
+    ++size;
+  }
+  if (store_ == nullptr || size > kMaxVectorizedBodySize ||
+      !MatchElementType(store_->class_id()) ||
+      store_->index_scale() != element_size_ ||
+      !MatchAccess(store_->array(), store_->index(), &target_)) {
+    return false;
+  }
+  Definition* value = store_->value()->definition();
+  if (simd_cid_ == kFloat32x4Cid ? !MatchFloatValue(value)
+                                 : !MatchIntegerValue(value, 0)) {
+    return false;
+  }
+
+  // Everything else in the body is part of the above.
+  for (ForwardInstructionIterator it(loop_.body); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) {
+      break;
+    }
+    if (current != store_ && current != increment_ &&
+        !scalar_.HasKey(current) && !vector_.HasKey(current)) {
+      return false;
+    }
+  }
+
+  // Overlap of the target with a source is checked in the preheader, which
+  // reads their data addresses.
+  if (!sources_.is_empty() && target_->Type()->is_nullable()) {
+    return false;
+  }
+  for (intptr_t i = 0; i < sources_.length(); ++i) {
+    if (sources_[i]->Type()->is_nullable()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ElementwiseLoop::MatchElementType(intptr_t cid) {
+  switch (cid) {
+    case kTypedDataFloat32ArrayCid:
+      element_size_ = 4;
+      vector_cid_ = kTypedDataFloat32x4ArrayCid;
+      simd_cid_ = kFloat32x4Cid;
+      break;
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+      element_size_ = 4;
+      vector_cid_ = kTypedDataInt32x4ArrayCid;
+      simd_cid_ = kInt32x4Cid;
+      break;
+    case kTypedDataInt8ArrayCid:
+    case kTypedDataUint8ArrayCid:
+      element_size_ = 1;
+      vector_cid_ = kTypedDataInt32x4ArrayCid;
+      simd_cid_ = kInt32x4Cid;
+      break;
+    default:
+      return false;
+  }
+  element_cid_ = cid;
+  return true;
+}
+
+void ElementwiseLoop::AddLength(Definition* length) {
+  Definition* limit = loop_.compare->right()->definition();
+  if (length->OriginalDefinitionIgnoreBoxingAndConstraints() ==
+      limit->OriginalDefinitionIgnoreBoxingAndConstraints()) {
+    return;
+  }
+  for (intptr_t i = 0; i < lengths_.length(); ++i) {
+    if (lengths_[i] == length) {
+      return;
+    }
+  }
+  lengths_.Add(length);
+}
+
+// Matches an index which is the control variable, possibly converted and
+// bounds checked. Sets 'check' to the last bounds check on the way.
+bool ElementwiseLoop::MatchIndex(Definition* def,
+                                 GenericCheckBoundInstr** check) {
+  if (def == loop_.control) {
+    return true;
+  }
+  if (!IsInBody(def)) {
+    return false;
+  }
+  if (GenericCheckBoundInstr* bound = def->AsGenericCheckBound()) {
+    Definition* length = bound->length()->definition();
+    if (!IsInvariant(length) || length->representation() != kUnboxedInt64 ||
+        !MatchIndex(bound->index()->definition(), check)) {
+      return false;
+    }
+    AddLength(length);
+    *check = bound;
+  } else if (def->IsBox() || def->IsUnboxInteger() || def->IsIntConverter()) {
+    if (!MatchIndex(def->InputAt(0)->definition(), check)) {
+      return false;
+    }
+  } else {
+    return false;
+  }
+  AddScalar(def);
+  return true;
+}
+
+bool ElementwiseLoop::IsLengthOf(Definition* length, Definition* array) const {
+  if (!Definition::IsArrayLength(length)) {
+    return false;
+  }
+  LoadFieldInstr* load =
+      length->OriginalDefinitionIgnoreBoxingAndConstraints()->AsLoadField();
+  return load->instance()->definition()->OriginalDefinition() ==
+         array->OriginalDefinition();
+}
+
+// Matches an access to the data of a loop invariant array at the control
+// variable, which is known to be in bounds of the array. Sets 'object' to the
+// array.
+bool ElementwiseLoop::MatchAccess(Value* array,
+                                  Value* index,
+                                  Definition** object) {
+  LoadUntaggedInstr* data = array->definition()->AsLoadUntagged();
+  if (data == nullptr || !IsInBody(data) ||
+      data->offset() != compiler::target::TypedDataBase::data_field_offset()) {
+    return false;
+  }
+  Definition* base = data->object()->definition();
+  if (!IsInvariant(base)) {
+    CheckNullInstr* check_null = base->AsCheckNull();
+    if (check_null == nullptr || !IsInBody(check_null) ||
+        !IsInvariant(check_null->value()->definition())) {
+      return false;
+    }
+    AddScalar(check_null);
+    base = check_null->value()->definition();
+  }
+  AddScalar(data);
+
+  GenericCheckBoundInstr* check = nullptr;
+  if (!MatchIndex(index->definition(), &check)) {
+    return false;
+  }
+  Definition* limit = loop_.compare->right()->definition();
+  if (!IsLengthOf(limit, base) &&
+      (check == nullptr || !IsLengthOf(check->length()->definition(), base))) {
+    return false;
+  }
+  *object = base;
+  return true;
+}
+
+bool ElementwiseLoop::MatchLoad(Definition* def) {
+  LoadIndexedInstr* load = def->AsLoadIndexed();
+  Definition* object = nullptr;
+  if (load == nullptr || !IsInBody(load) ||
+      load->class_id() != element_cid_ ||
+      load->index_scale() != element_size_ ||
+      !MatchAccess(load->array(), load->index(), &object)) {
+    return false;
+  }
+  // Loads from the target itself read each element before it is written.
+  if (object->OriginalDefinition() != target_->OriginalDefinition()) {
+    bool found = false;
+    for (intptr_t i = 0; i < sources_.length(); ++i) {
+      found = found || (sources_[i] == object);
+    }
+    if (!found) {
+      sources_.Add(object);
+    }
+  }
+  AddVector(load);
+  return true;
+}
+
+// Float32 elements are converted to double, and back when stored. A single
+// arithmetic operation on two floats rounds to the same float in double and
+// in single precision, but longer computations may not.
+bool ElementwiseLoop::MatchFloatValue(Definition* def) {
+  DoubleToFloatInstr* to_float = def->AsDoubleToFloat();
+  if (to_float == nullptr || !IsInBody(to_float)) {
+    return false;
+  }
+  AddVector(to_float);
+  Definition* value = to_float->value()->definition();
+  if (BinaryDoubleOpInstr* op = value->AsBinaryDoubleOp()) {
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kMUL:
+      case Token::kDIV:
+        break;
+      default:
+        return false;
+    }
+    if (!IsInBody(op)) {
+      return false;
+    }
+    AddVector(op);
+    for (intptr_t i = 0; i < op->InputCount(); ++i) {
+      FloatToDoubleInstr* operand =
+          op->InputAt(i)->definition()->AsFloatToDouble();
+      if (operand == nullptr || !IsInBody(operand) ||
+          !MatchLoad(operand->value()->definition())) {
+        return false;
+      }
+      AddVector(operand);
+    }
+    return true;
+  }
+  FloatToDoubleInstr* to_double = value->AsFloatToDouble();
+  if (to_double == nullptr || !IsInBody(to_double) ||
+      !MatchLoad(to_double->value()->definition())) {
+    return false;
+  }
+  AddVector(to_double);
+  return true;
+}
+
+// Integer elements are widened when loaded and truncated when stored. Lanes
+// of at least the element width give the same truncated result for
+// operations where no bit depends on more significant bits: bitwise
+// operations for all elements, and addition and subtraction for 32-bit ones.
+bool ElementwiseLoop::MatchIntegerValue(Definition* def, intptr_t depth) {
+  if (!IsInBody(def) || depth > kMaxVectorizedValueDepth) {
+    return false;
+  }
+  if (def->IsBox() || def->IsUnboxInteger() || def->IsIntConverter()) {
+    AddVector(def);
+    return MatchIntegerValue(def->InputAt(0)->definition(), depth);
+  }
+  if (def->IsLoadIndexed()) {
+    return MatchLoad(def);
+  }
+  BinaryIntegerOpInstr* op = def->AsBinaryIntegerOp();
+  if (op == nullptr ||
+      !(op->IsBinaryInt64Op() || op->IsBinaryUint32Op() ||
+        (op->IsBinarySmiOp() && !op->can_overflow()))) {
+    return false;
+  }
+  switch (op->op_kind()) {
+    case Token::kBIT_AND:
+    case Token::kBIT_OR:
+    case Token::kBIT_XOR:
+      break;
+    case Token::kADD:
+    case Token::kSUB:
+      if (element_size_ != 4) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+  AddVector(op);
+  return MatchIntegerValue(op->left()->definition(), depth + 1) &&
+         MatchIntegerValue(op->right()->definition(), depth + 1);
+}
+
+LoopVectorizer::LoopVectorizer(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph) {}
+
+void LoopVectorizer::Optimize() {
+  // The vectorized loop reads data addresses as 64-bit integers, and copies
+  // instructions which share deoptimization ids.
+  if (!CompilerState::Current().is_aot() ||
+      compiler::target::kBitsPerWord != 64 ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return;
+  }
+
+  GrowableArray<CountedLoop> loops;
+  FindCountedLoops(flow_graph_, &loops);
+
+  bool changed = false;
+  for (intptr_t i = 0; i < loops.length(); ++i) {
+    changed = TryVectorize(loops[i]) || changed;
+  }
+
+  if (changed) {
+    flow_graph_->DiscoverBlocks();
+    GrowableArray<BitVector*> dominance_frontier;
+    flow_graph_->ComputeDominators(&dominance_frontier);
+  }
+}
+
+// Runs the loop 'lanes' iterations at a time while
+//
+//   i < min(n, lengths...) - (lanes - 1)
+//
+// and the target does not overlap a source less than 16 bytes behind it,
+// with a single vectorized copy of the body in the guarded loop.
+bool LoopVectorizer::TryVectorize(const CountedLoop& loop) {
+  ElementwiseLoop elementwise(loop);
+  if (!elementwise.Match()) {
+    return false;
+  }
+  if (FLAG_trace_loop_vectorization) {
+    THR_Print("Vectorizing loop B%" Pd " of %s by %" Pd "\n",
+              loop.header->block_id(),
+              flow_graph_->function().ToFullyQualifiedCString(),
+              elementwise.lanes());
+  }
+
+  Zone* zone = flow_graph_->zone();
+  Instruction* preheader_goto = loop.preheader->last_instruction();
+
+  // min(a, b) = b + ((a - b) & ((a - b) >> 63)), for non-negative a and b.
+  Definition* sign_shift = InsertInt64Constant(flow_graph_, preheader_goto, 63);
+  Definition* limit = loop.compare->right()->definition();
+  for (intptr_t i = 0; i < elementwise.lengths().length(); ++i) {
+    Definition* length = elementwise.lengths()[i];
+    Definition* diff =
+        InsertInt64Op(flow_graph_, preheader_goto, Token::kSUB, limit, length);
+    Definition* sign = InsertInt64Op(flow_graph_, preheader_goto, Token::kSHR,
+                                     diff, sign_shift);
+    Definition* masked = InsertInt64Op(flow_graph_, preheader_goto,
+                                       Token::kBIT_AND, diff, sign);
+    limit = InsertInt64Op(flow_graph_, preheader_goto, Token::kADD, length,
+                          masked);
+  }
+  Definition* adjustment =
+      InsertInt64Constant(flow_graph_, preheader_goto, elementwise.lanes() - 1);
+  limit = InsertInt64Op(flow_graph_, preheader_goto, Token::kSUB, limit,
+                        adjustment);
+
+  // The scalar loop reads elements of a source less than 16 bytes behind the
+  // target after they have been written, while the vectorized loop reads all
+  // lanes before writing any. In that case the limit is cleared, with
+  //
+  //   mask = ((m | -m) >> 63) where m = (d - 1) & ~15
+  //
+  // which is 0 if d is in [1, 16] and -1 otherwise.
+  if (!elementwise.sources().is_empty()) {
+    auto data_address = [&](Definition* array) -> Definition* {
+      const intptr_t offset =
+          compiler::target::TypedDataBase::data_field_offset();
+      LoadUntaggedInstr* data =
+          new (zone) LoadUntaggedInstr(new (zone) Value(array), offset);
+      flow_graph_->InsertBefore(preheader_goto, data, nullptr,
+                                FlowGraph::kValue);
+      IntConverterInstr* address = new (zone) IntConverterInstr(
+          kUntagged, kUnboxedIntPtr, new (zone) Value(data), DeoptId::kNone);
+      flow_graph_->InsertBefore(preheader_goto, address, nullptr,
+                                FlowGraph::kValue);
+      return address;
+    };
+    Definition* one = InsertInt64Constant(flow_graph_, preheader_goto, 1);
+    Definition* zero = InsertInt64Constant(flow_graph_, preheader_goto, 0);
+    Definition* alignment_mask =
+        InsertInt64Constant(flow_graph_, preheader_goto, -kSimd128Size);
+    Definition* target = data_address(elementwise.target());
+    for (intptr_t i = 0; i < elementwise.sources().length(); ++i) {
+      Definition* source = data_address(elementwise.sources()[i]);
+      Definition* distance = InsertInt64Op(flow_graph_, preheader_goto,
+                                           Token::kSUB, target, source);
+      Definition* m = InsertInt64Op(
+          flow_graph_, preheader_goto, Token::kBIT_AND,
+          InsertInt64Op(flow_graph_, preheader_goto, Token::kSUB, distance,
+                        one),
+          alignment_mask);
+      Definition* negated =
+          InsertInt64Op(flow_graph_, preheader_goto, Token::kSUB, zero, m);
+      Definition* mask = InsertInt64Op(
+          flow_graph_, preheader_goto, Token::kSHR,
+          InsertInt64Op(flow_graph_, preheader_goto, Token::kBIT_OR, m,
+                        negated),
+          sign_shift);
+      limit = InsertInt64Op(flow_graph_, preheader_goto, Token::kBIT_AND,
+                            limit, mask);
+    }
+  }
+
+  DefinitionMap map;
+  DefinitionMap vector_map;
+  GuardedLoop vectorized(flow_graph_, loop);
+  Instruction* cursor = vectorized.Open(limit, &map);
+
+  // Vector values are not available as scalars to environments, which is
+  // fine as the loop is not in a try block and code is never deoptimized.
+  Definition* dead = flow_graph_->constant_dead();
+  for (ForwardInstructionIterator it(loop.body); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsGoto()) {
+      break;
+    }
+    Instruction* copy = nullptr;
+    if (current == elementwise.increment()) {
+      Definition* stride =
+          InsertInt64Constant(flow_graph_, preheader_goto, elementwise.lanes());
+      copy = BinaryIntegerOpInstr::Make(
+          kUnboxedInt64, Token::kADD,
+          new (zone) Value(MapDefinition(loop.control, &map)),
+          new (zone) Value(stride), DeoptId::kNone, /*can_overflow=*/false,
+          /*is_truncating=*/true, nullptr, Instruction::kNotSpeculative);
+      flow_graph_->AppendTo(cursor, copy, nullptr, FlowGraph::kValue);
+      map.Update({current->AsDefinition(), copy->AsDefinition()});
+    } else if (GenericCheckBoundInstr* check = current->AsGenericCheckBound()) {
+      // Implied by the condition of the vectorized loop.
+      map.Update({check, MapDefinition(check->index()->definition(), &map)});
+      continue;
+    } else if (elementwise.IsScalar(current)) {
+      copy = GuardedLoop::AppendClone(flow_graph_, cursor, current, &map);
+    } else if (current == elementwise.store()) {
+      StoreIndexedInstr* store = elementwise.store();
+      copy = new (zone) StoreIndexedInstr(
+          MapValue(zone, store->array(), &map),
+          MapValue(zone, store->index(), &map),
+          new (zone)
+              Value(vector_map.LookupValue(store->value()->definition())),
+          kNoStoreBarrier, store->index_unboxed(), store->index_scale(),
+          elementwise.vector_cid(), kUnalignedAccess, DeoptId::kNone,
+          store->token_pos(), Instruction::kNotSpeculative);
+      flow_graph_->AppendTo(cursor, copy, nullptr, FlowGraph::kEffect);
+      CopyEnvironment(zone, current, copy, &map);
+    } else {
+      Definition* def = current->AsDefinition();
+      Definition* vector = nullptr;
+      if (LoadIndexedInstr* load = def->AsLoadIndexed()) {
+        vector = new (zone) LoadIndexedInstr(
+            MapValue(zone, load->array(), &map),
+            MapValue(zone, load->index(), &map), load->index_unboxed(),
+            load->index_scale(), elementwise.vector_cid(), kUnalignedAccess,
+            DeoptId::kNone, load->token_pos());
+      } else if (def->IsBinaryDoubleOp() || def->IsBinaryIntegerOp()) {
+        const Token::Kind op_kind = def->IsBinaryDoubleOp()
+                                        ? def->AsBinaryDoubleOp()->op_kind()
+                                        : def->AsBinaryIntegerOp()->op_kind();
+        vector = SimdOpInstr::Create(
+            SimdOpInstr::KindForOperator(elementwise.simd_cid(), op_kind),
+            new (zone)
+                Value(vector_map.LookupValue(def->InputAt(0)->definition())),
+            new (zone)
+                Value(vector_map.LookupValue(def->InputAt(1)->definition())),
+            DeoptId::kNone);
+      }
+      if (vector != nullptr) {
+        flow_graph_->AppendTo(cursor, vector, nullptr, FlowGraph::kValue);
+        CopyEnvironment(zone, current, vector, &map);
+        copy = vector;
+      } else {
+        // Conversions between element and scalar representations have no
+        // vector counterpart.
+        vector = vector_map.LookupValue(def->InputAt(0)->definition());
+      }
+      vector_map.Update({def, vector});
+      map.Update({def, dead});
+    }
+    if (copy != nullptr) {
+      cursor = copy;
+    }
+  }
+
+  map.Update({loop.control, MapDefinition(elementwise.increment(), &map)});
+  vectorized.Close(cursor, &map);
+  return true;
+}
+
+}  // namespace dart
@@ -0,0 +1,92 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+
+namespace dart {
+
+class BlockEntryInstr;
+class FlowGraph;
+class JoinEntryInstr;
+class LoopInfo;
+class PhiInstr;
+class RelationalOpInstr;
+class TargetEntryInstr;
+
+// A counted loop of the form
+//
+//   for (int i = c; i < a.length; i++) { <straight-line body> }
+//
+// with a preheader ending in a goto and a single body block. Both passes
+// below run the first iterations in a new copy of the loop that does several
+// iterations at once, and fall through to the original loop for the rest.
+struct CountedLoop {
+  LoopInfo* loop;
+  BlockEntryInstr* preheader;
+  JoinEntryInstr* header;
+  TargetEntryInstr* body;
+  RelationalOpInstr* compare;
+  PhiInstr* control;
+};
+
+// Unrolls small counted loops and strength-reduces multiplications of their
+// induction variables.
+//
+// Bounds checks in the unrolled body against the loop limit are implied by
+// the condition of the unrolled loop and are dropped.
+//
+// Cloned instructions share deoptimization ids with their originals, so the
+// transformation is only performed in AOT mode.
+class LoopUnroller : public ValueObject {
+ public:
+  explicit LoopUnroller(FlowGraph* flow_graph);
+
+  void Optimize();
+
+ private:
+  void StrengthReduce(const CountedLoop& loop);
+  intptr_t UnrollFactor(const CountedLoop& loop);
+  void Unroll(const CountedLoop& loop, intptr_t factor);
+
+  FlowGraph* flow_graph_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopUnroller);
+};
+
+// Rewrites counted loops over typed data without loop-carried dependences,
+// such as
+//
+//   for (int i = 0; i < a.length; i++) a[i] = b[i] * c[i];
+//
+// to process 16 bytes per iteration with Simd128 instructions.
+//
+// Only element-wise operations whose results are independent of the lane
+// width are vectorized: copies, bitwise operations, 32-bit integer addition
+// and subtraction, and a single Float32 arithmetic operation (which gives the
+// same result whether computed in single or in double precision).
+class LoopVectorizer : public ValueObject {
+ public:
+  explicit LoopVectorizer(FlowGraph* flow_graph);
+
+  void Optimize();
+
+ private:
+  bool TryVectorize(const CountedLoop& loop);
+
+  FlowGraph* flow_graph_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopVectorizer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
@@ -0,0 +1,240 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/dart_entry.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+
+struct InstructionCounts {
+  intptr_t loads;
+  intptr_t bounds_checks;
+  intptr_t multiplications;
+  intptr_t simd_ops;
+};
+
+// Compiles 'foo' from the given script in AOT mode at the given optimization
+// level and counts the interesting instructions.
+static InstructionCounts CompileAndCount(const char* script_chars,
+                                         int optimization_level) {
+  SetFlagScope<int> sfs(&FLAG_optimization_level, optimization_level);
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  InstructionCounts counts = {0, 0, 0, 0};
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      Instruction* current = it.Current();
+      if (current->IsLoadIndexed()) {
+        counts.loads++;
+      } else if (current->IsCheckBoundBase()) {
+        counts.bounds_checks++;
+      } else if (current->IsBinaryInt64Op() &&
+                 current->AsBinaryInt64Op()->op_kind() == Token::kMUL) {
+        counts.multiplications++;
+      } else if (current->IsSimdOp()) {
+        counts.simd_ops++;
+      }
+    }
+  }
+  return counts;
+}
+
+// Compiles 'foo' from the given script in AOT mode at optimization level 3
+// and installs the resulting code, so that invoking 'foo' runs it.
+static FunctionPtr CompileOptimizedAndAttach(const char* script_chars) {
+  SetFlagScope<int> sfs(&FLAG_optimization_level, 3);
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  pipeline.RunPasses({});
+  pipeline.CompileGraphAndAttachFunction();
+  return function.raw();
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_SumUint8List) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      int foo(Uint8List list) {
+        int sum = 0;
+        for (int i = 0; i < list.length; i++) {
+          sum += list[i];
+        }
+        return sum;
+      }
+
+      main() {
+        foo(new Uint8List(100));
+      }
+      )";
+
+  const InstructionCounts original = CompileAndCount(kScript, 2);
+  EXPECT_EQ(1, original.loads);
+
+  // Four copies of the body in the unrolled loop, and the original loop for
+  // the remaining iterations. The copies need no bounds checks of their own.
+  const InstructionCounts unrolled = CompileAndCount(kScript, 3);
+  EXPECT_EQ(5, unrolled.loads);
+  EXPECT_EQ(original.bounds_checks, unrolled.bounds_checks);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_StrengthReduce) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      int foo(Uint8List list) {
+        int sum = 0;
+        for (int i = 0; i < list.length; i++) {
+          sum += list[i] + i * 3;
+        }
+        return sum;
+      }
+
+      main() {
+        foo(new Uint8List(100));
+      }
+      )";
+
+  const InstructionCounts original = CompileAndCount(kScript, 2);
+  EXPECT_EQ(1, original.multiplications);
+
+  const InstructionCounts unrolled = CompileAndCount(kScript, 3);
+  EXPECT_EQ(0, unrolled.multiplications);
+}
+
+// Runs the unrolled loop for lengths which leave every possible number of
+// iterations to the remainder loop.
+ISOLATE_UNIT_TEST_CASE(LoopUnroller_RunUnrolledLoop) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      int foo(Uint8List list) {
+        int sum = 0;
+        for (int i = 0; i < list.length; i++) {
+          sum += list[i] + i * 3;
+        }
+        return sum;
+      }
+
+      main() {
+        foo(new Uint8List(100));
+      }
+      )";
+
+  const auto& function = Function::Handle(CompileOptimizedAndAttach(kScript));
+  auto& list = TypedData::Handle();
+  auto& arguments = Array::Handle(Array::New(1));
+  auto& result = Object::Handle();
+  for (intptr_t length = 0; length < 14; length++) {
+    list = TypedData::New(kTypedDataUint8ArrayCid, length);
+    int64_t expected = 0;
+    for (intptr_t i = 0; i < length; i++) {
+      list.SetUint8(i, static_cast<uint8_t>(i * 7 + 1));
+      expected += (i * 7 + 1) + i * 3;
+    }
+    arguments.SetAt(0, list);
+    result = DartEntry::InvokeFunction(function, arguments);
+    EXPECT(result.IsInteger());
+    if (result.IsInteger()) {
+      EXPECT_EQ(expected, Integer::Cast(result).AsInt64Value());
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_MultiplyFloat32List) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void foo(Float32List a, Float32List b, Float32List c) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = b[i] * c[i];
+        }
+      }
+
+      main() {
+        foo(new Float32List(100), new Float32List(100), new Float32List(100));
+      }
+      )";
+
+  const InstructionCounts original = CompileAndCount(kScript, 2);
+  EXPECT_EQ(0, original.simd_ops);
+
+  // One vector multiplication in the vectorized loop, which the unroller
+  // leaves alone, and the original loop for the remaining iterations.
+  const InstructionCounts vectorized = CompileAndCount(kScript, 3);
+  if (FlowGraphCompiler::SupportsUnboxedSimd128() &&
+      compiler::target::kBitsPerWord == 64) {
+    EXPECT_EQ(1, vectorized.simd_ops);
+    EXPECT_EQ(original.loads + 2, vectorized.loads);
+  } else {
+    EXPECT_EQ(0, vectorized.simd_ops);
+  }
+}
+
+// Runs the vectorized loop for lengths which leave every possible number of
+// iterations to the scalar loop.
+ISOLATE_UNIT_TEST_CASE(LoopVectorizer_RunVectorizedLoop) {
+  const char* kScript =
+      R"(
+      import 'dart:typed_data';
+
+      void foo(Float32List a, Float32List b, Float32List c) {
+        for (int i = 0; i < a.length; i++) {
+          a[i] = b[i] * c[i];
+        }
+      }
+
+      main() {
+        foo(new Float32List(100), new Float32List(100), new Float32List(100));
+      }
+      )";
+
+  const auto& function = Function::Handle(CompileOptimizedAndAttach(kScript));
+  auto& a = TypedData::Handle();
+  auto& b = TypedData::Handle();
+  auto& c = TypedData::Handle();
+  auto& arguments = Array::Handle(Array::New(3));
+  auto& result = Object::Handle();
+  for (intptr_t length = 0; length < 10; length++) {
+    a = TypedData::New(kTypedDataFloat32ArrayCid, length);
+    b = TypedData::New(kTypedDataFloat32ArrayCid, length);
+    c = TypedData::New(kTypedDataFloat32ArrayCid, length);
+    for (intptr_t i = 0; i < length; i++) {
+      b.SetFloat32(i * sizeof(float), 1.5f + i);
+      c.SetFloat32(i * sizeof(float), 0.25f * i - 1.0f);
+    }
+    arguments.SetAt(0, a);
+    arguments.SetAt(1, b);
+    arguments.SetAt(2, c);
+    result = DartEntry::InvokeFunction(function, arguments);
+    EXPECT(result.IsNull());
+    for (intptr_t i = 0; i < length; i++) {
+      const float expected = (1.5f + i) * (0.25f * i - 1.0f);
+      EXPECT_EQ(expected, a.GetFloat32(i * sizeof(float)));
+    }
+  }
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
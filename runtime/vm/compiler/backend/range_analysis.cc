@@ -808,6 +808,31 @@ class BoundsCheckGeneralizer {
     lower_bound = ApplyConstraints(lower_bound, check, &positive_constraints);
     range_analysis_->AssignRangesRecursively(lower_bound);
 
+    if (!RangeUtils::IsPositive(lower_bound->range())) {
+      // The lower bound can depend on symbols which do not occur in the
+      // upper bound, e.g. on the initial value a.length - k of an induction
+      // variable. Retry requiring those symbols to be positive as well.
+      GrowableArray<Definition*> lower_bound_symbols;
+      Definition* unconstrained_bound = ApplyConstraints(
+          ConstructLowerBound(check->index()->definition(), check), check);
+      range_analysis_->AssignRangesRecursively(unconstrained_bound);
+      if (FindNonPositiveSymbols(&lower_bound_symbols, unconstrained_bound) &&
+          AreAllScheduled(lower_bound_symbols)) {
+        for (intptr_t i = 0; i < lower_bound_symbols.length(); i++) {
+          Definition* symbol = lower_bound_symbols[i];
+          if (!Contains(non_positive_symbols, symbol)) {
+            non_positive_symbols.Add(symbol);
+            positive_constraints.Add(
+                new ConstraintInstr(new Value(symbol), positive_range));
+          }
+        }
+        lower_bound = ApplyConstraints(
+            ConstructLowerBound(check->index()->definition(), check), check,
+            &positive_constraints);
+        range_analysis_->AssignRangesRecursively(lower_bound);
+      }
+    }
+
     if (!RangeUtils::IsPositive(lower_bound->range())) {
 // Can't prove that lower bound is positive even with additional checks
 // against potentially non-positive symbols. Give up.
@@ -1235,7 +1260,7 @@ class BoundsCheckGeneralizer {
       const Object& value = defn->AsConstant()->value();
       return compiler::target::IsSmi(value) && (Smi::Cast(value).Value() >= 0);
     } else if (defn->HasSSATemp()) {
-      if (!RangeUtils::IsPositive(defn->range())) {
+      if (!RangeUtils::IsPositive(defn->range()) && !Contains(*symbols, defn)) {
         symbols->Add(defn);
       }
       return true;
@@ -1251,11 +1276,19 @@ class BoundsCheckGeneralizer {
         return true;
       }
 
-      if (binary_op->op_kind() == Token::kSUB) {
+      if ((binary_op->op_kind() == Token::kSUB) ||
+          IsNegativeConstant(binary_op->right()->definition())) {
         // For addition and multiplication it's enough to ensure that
         // lhs and rhs are positive to guarantee that defn as whole is
-        // positive. This does not work for substraction so just give up.
-        return false;
+        // positive. This does not work for substraction or for addition of
+        // a negative constant, such as the bound M - 1 of an induction
+        // variable of an outer loop, so require the whole subexpression to
+        // be positive instead.
+        if (!FindNonPositiveSymbols(symbols, binary_op->left()->definition())) {
+          return false;
+        }
+        symbols->Add(defn);
+        return true;
       }
 
       return FindNonPositiveSymbols(symbols, binary_op->left()->definition()) &&
@@ -1265,6 +1298,33 @@ class BoundsCheckGeneralizer {
     return false;
   }
 
+  static bool Contains(const GrowableArray<Definition*>& symbols,
+                       Definition* symbol) {
+    for (intptr_t i = 0; i < symbols.length(); i++) {
+      if (symbols[i] == symbol) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Constraints are only matched to symbols in the graph, so a subexpression
+  // of a lower bound can't be constrained separately from its uses.
+  static bool AreAllScheduled(const GrowableArray<Definition*>& symbols) {
+    for (intptr_t i = 0; i < symbols.length(); i++) {
+      if (!symbols[i]->HasSSATemp()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool IsNegativeConstant(Definition* defn) {
+    ConstantInstr* constant = defn->AsConstant();
+    return (constant != nullptr) && constant->IsSmi() &&
+           (Smi::Cast(constant->value()).Value() < 0);
+  }
+
   // Find innermost constraint for the given definition dominating given
   // instruction.
   static Definition* FindInnermostConstraint(Definition* defn,
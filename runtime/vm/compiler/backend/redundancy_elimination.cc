@@ -4064,7 +4064,28 @@ void DeadCodeElimination::EliminateDeadCode(FlowGraph* flow_graph) {
   }
 }
 
+// Returns true if [instr] is a call to an implicit accessor whose body can
+// not call back into Dart code, so that the call adds only a bounded amount
+// of stack. Only used in AOT, where static call targets can not be replaced
+// by hot reload.
+static bool IsCallToTrivialAccessor(Instruction* instr) {
+  StaticCallInstr* call = instr->AsStaticCall();
+  if (call == nullptr) {
+    return false;
+  }
+  const Function& target = call->function();
+  if (target.IsImplicitSetterFunction()) {
+    return true;
+  }
+  if (target.IsImplicitGetterFunction()) {
+    const Field& field = Field::Handle(target.accessor_field());
+    return !field.NeedsInitializationCheckOnLoad();
+  }
+  return false;
+}
+
 void CheckStackOverflowElimination::EliminateStackOverflow(FlowGraph* graph) {
+  const bool is_aot = CompilerState::Current().is_aot();
   CheckStackOverflowInstr* first_stack_overflow_instr = NULL;
   for (BlockIterator block_it = graph->reverse_postorder_iterator();
        !block_it.Done(); block_it.Advance()) {
@@ -4086,6 +4107,9 @@ void CheckStackOverflowElimination::EliminateStackOverflow(FlowGraph* graph) {
       }
 
       if (current->HasUnknownSideEffects()) {
+        if (is_aot && IsCallToTrivialAccessor(current)) {
+          continue;
+        }
         return;
       }
     }
@@ -158,6 +158,8 @@ class DelayAllocations : public AllStatic {
 class CheckStackOverflowElimination : public AllStatic {
  public:
   // For leaf functions with only a single [StackOverflowInstr] we remove it.
+  // In AOT calls to trivial implicit getters and setters do not prevent a
+  // function from being treated as a leaf.
   static void EliminateStackOverflow(FlowGraph* graph);
 };
 
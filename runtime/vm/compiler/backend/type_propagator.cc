@@ -1434,11 +1434,16 @@ CompileType StringInterpolateInstr::ComputeType() const {
 
 CompileType LoadStaticFieldInstr::ComputeType() const {
   const Field& field = this->field();
-  bool is_nullable = CompileType::kNullable;
   intptr_t cid = kIllegalCid;  // Abstract type is known, calculate cid lazily.
   AbstractType* abstract_type = &AbstractType::ZoneHandle(field.type());
   TraceStrongModeType(this, *abstract_type);
   ASSERT(field.is_static());
+  // With sound null safety a static field of a non-nullable type never holds
+  // null: uninitialized fields hold the sentinel instead. Should be kept in
+  // sync with Slot::Get.
+  bool is_nullable = abstract_type->IsStrictlyNonNullable()
+                         ? CompileType::kNonNullable
+                         : CompileType::kNullable;
   const bool is_initialized = IsFieldInitialized() && !FLAG_fields_may_be_reset;
   if (field.is_final() && is_initialized) {
     const Instance& obj = Instance::Handle(field.StaticValue());
@@ -1451,7 +1456,7 @@ CompileType LoadStaticFieldInstr::ComputeType() const {
   if ((field.guarded_cid() != kIllegalCid) &&
       (field.guarded_cid() != kDynamicCid)) {
     cid = field.guarded_cid();
-    is_nullable = field.is_nullable();
+    is_nullable = is_nullable && field.is_nullable();
     abstract_type = nullptr;  // Cid is known, calculate abstract type lazily.
   }
   if (field.needs_load_guard()) {
@@ -509,6 +509,28 @@ bool CallSpecializer::TryReplaceWithRelationalOp(InstanceCallInstr* call,
   return true;
 }
 
+// Returns true if a Smi division or modulo by [right] is better served by
+// the int64 code path, which lowers constant divisors to a multiplication
+// by a magic reciprocal instead of a hardware divide.
+static bool ShouldUseMagicDivision(Definition* right) {
+#if defined(TARGET_ARCH_X64) || defined(TARGET_ARCH_ARM64)
+#if defined(TARGET_ARCH_ARM64)
+  // ARM64 only emits magic operations under O3.
+  if (FLAG_optimization_level <= 2) return false;
+#endif
+  if (!FlowGraphCompiler::SupportsUnboxedInt64()) return false;
+  if (!right->IsConstant() || !right->AsConstant()->value().IsSmi()) {
+    return false;
+  }
+  const intptr_t divisor = Smi::Cast(right->AsConstant()->value()).Value();
+  // Powers of two (including 1 and -1) and zero are handled by the Smi
+  // code path already.
+  return (divisor != 0) && !Utils::IsPowerOfTwo(Utils::Abs(divisor));
+#else
+  return false;
+#endif
+}
+
 bool CallSpecializer::TryReplaceWithBinaryOp(InstanceCallInstr* call,
                                              Token::Kind op_kind) {
   intptr_t operands_type = kIllegalCid;
@@ -605,6 +627,10 @@ bool CallSpecializer::TryReplaceWithBinaryOp(InstanceCallInstr* call,
           return false;
         }
         operands_type = kSmiCid;
+        if (ShouldUseMagicDivision(call->ArgumentAt(1)) &&
+            !call->ic_data()->HasDeoptReason(ICData::kDeoptBinaryInt64Op)) {
+          operands_type = kMintCid;
+        }
       } else {
         return false;
       }
@@ -13,6 +13,7 @@
 #include "vm/compiler/backend/il_serializer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_unroller.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
@@ -328,6 +329,8 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(LICM);
   INVOKE_PASS(TryOptimizePatterns);
   INVOKE_PASS(DSE);
+  INVOKE_PASS_AOT(VectorizeLoops);
+  INVOKE_PASS_AOT(UnrollLoops);
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
@@ -459,6 +462,22 @@ COMPILER_PASS(LICM, {
 
 COMPILER_PASS(DSE, { DeadStoreElimination::Optimize(flow_graph); });
 
+COMPILER_PASS(UnrollLoops, {
+  // Code growth is only worth it when optimizing for speed.
+  if (FLAG_optimization_level >= 3) {
+    LoopUnroller unroller(flow_graph);
+    unroller.Optimize();
+  }
+});
+
+COMPILER_PASS(VectorizeLoops, {
+  // Code growth is only worth it when optimizing for speed.
+  if (FLAG_optimization_level >= 3) {
+    LoopVectorizer vectorizer(flow_graph);
+    vectorizer.Optimize();
+  }
+});
+
 COMPILER_PASS(RangeAnalysis, {
   // We have to perform range analysis after LICM because it
   // optimistically moves CheckSmi through phis into loop preheaders
@@ -536,14 +555,17 @@ COMPILER_PASS(EliminateWriteBarriers, { EliminateWriteBarriers(flow_graph); });
 
 COMPILER_PASS(FinalizeGraph, {
   // At the end of the pipeline, force recomputing and caching graph
-  // information (instruction and call site counts) for the (assumed)
-  // non-specialized case with better values, for future inlining.
+  // information (instruction and call site counts, non-escaping parameters)
+  // for the (assumed) non-specialized case with better values, for future
+  // inlining.
   intptr_t instruction_count = 0;
   intptr_t call_site_count = 0;
   FlowGraphInliner::CollectGraphInfo(flow_graph,
                                      /*constants_count*/ 0,
                                      /*force*/ true, &instruction_count,
                                      &call_site_count);
+  FlowGraphInliner::CollectEscapeInfo(flow_graph, /*parameters*/ nullptr,
+                                      /*force*/ true);
   flow_graph->function().set_inlining_depth(state->inlining_depth);
   // Remove redefinitions for the rest of the pipeline.
   flow_graph->RemoveRedefinitions();
@@ -15,7 +15,9 @@ namespace ffi {
 
 // TODO(dartbug.com/36607): Cache the trampolines.
 FunctionPtr TrampolineFunction(const Function& dart_signature,
-                               const Function& c_signature) {
+                               const Function& c_signature,
+                               bool is_leaf,
+                               bool is_lazy) {
   Thread* thread = Thread::Current();
   Zone* zone = thread->zone();
   String& name = String::Handle(zone, Symbols::New(thread, "FfiTrampoline"));
@@ -50,6 +52,8 @@ FunctionPtr TrampolineFunction(const Function& dart_signature,
   }
   function.TruncateUnusedParameterFlags();
   function.SetFfiCSignature(c_signature);
+  function.SetFfiIsLeaf(is_leaf);
+  function.SetFfiIsLazy(is_lazy);
 
   Type& type = Type::Handle(zone);
   type ^= function.SignatureType(Nullability::kLegacy);
@@ -61,6 +65,35 @@ FunctionPtr TrampolineFunction(const Function& dart_signature,
   return function.raw();
 }
 
+bool IsAsLeafFunctionInternal(const Function& function) {
+  if (!function.is_static() ||
+      Class::Handle(function.Owner()).library() != Library::FfiLibrary()) {
+    return false;
+  }
+  const String& name = String::Handle(function.name());
+  return String::EqualsIgnoringPrivateKey(name,
+                                          Symbols::AsLeafFunctionInternal());
+}
+
+bool IsAsLazyFunctionInternal(const Function& function, bool* is_leaf) {
+  if (!function.is_static() ||
+      Class::Handle(function.Owner()).library() != Library::FfiLibrary()) {
+    return false;
+  }
+  const String& name = String::Handle(function.name());
+  if (String::EqualsIgnoringPrivateKey(name,
+                                       Symbols::AsLazyFunctionInternal())) {
+    *is_leaf = false;
+    return true;
+  }
+  if (String::EqualsIgnoringPrivateKey(
+          name, Symbols::AsLazyLeafFunctionInternal())) {
+    *is_leaf = true;
+    return true;
+  }
+  return false;
+}
+
 }  // namespace ffi
 
 }  // namespace compiler
@@ -20,7 +20,18 @@ namespace compiler {
 namespace ffi {
 
 FunctionPtr TrampolineFunction(const Function& dart_signature,
-                               const Function& c_signature);
+                               const Function& c_signature,
+                               bool is_leaf,
+                               bool is_lazy);
+
+// Whether |function| is 'dart:ffi::_asLeafFunctionInternal', which the flow
+// graph builders translate like '_asFunctionInternal' with a leaf trampoline.
+bool IsAsLeafFunctionInternal(const Function& function);
+
+// Whether |function| is 'dart:ffi::_asLazyFunctionInternal' or
+// '_asLazyLeafFunctionInternal', which take the library and symbol name
+// instead of the pointer. Sets |is_leaf| for the latter.
+bool IsAsLazyFunctionInternal(const Function& function, bool* is_leaf);
 
 }  // namespace ffi
 
@@ -21,6 +21,24 @@ bool BaseMarshaller::ContainsHandles() const {
   return dart_signature_.FfiCSignatureContainsHandles();
 }
 
+bool BaseMarshaller::ContainsTypedData() const {
+  for (intptr_t i = 0; i < num_args(); i++) {
+    if (IsTypedData(i)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+AbstractTypePtr BaseMarshaller::DartType(intptr_t arg_index) const {
+  if (arg_index == kResultIndex) {
+    return dart_signature_.result_type();
+  }
+
+  // Skip #0 argument, the closure.
+  return dart_signature_.ParameterTypeAt(arg_index + 1);
+}
+
 Location CallMarshaller::LocInFfiCall(intptr_t arg_index) const {
   if (arg_index == kResultIndex) {
     return Location(arg_index).AsLocation();
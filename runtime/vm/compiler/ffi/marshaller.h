@@ -72,6 +72,14 @@ class BaseMarshaller : public NativeCallingConvention {
            kFfiHandleCid;
   }
 
+  // A Pointer argument passed as a TypedData in Dart, only allowed in leaf
+  // calls. The pointer to its contents is passed to C.
+  bool IsTypedData(intptr_t arg_index) const {
+    return IsPointer(arg_index) &&
+           AbstractType::Handle(zone_, DartType(arg_index)).type_class_id() !=
+               kFfiPointerCid;
+  }
+
   // Treated as a null constant in Dart.
   bool IsVoid(intptr_t arg_index) const {
     return AbstractType::Handle(zone_, CType(arg_index)).type_class_id() ==
@@ -79,6 +87,7 @@ class BaseMarshaller : public NativeCallingConvention {
   }
 
   bool ContainsHandles() const;
+  bool ContainsTypedData() const;
 
   StringPtr function_name() const { return dart_signature_.name(); }
 
@@ -91,6 +100,8 @@ class BaseMarshaller : public NativeCallingConvention {
     ASSERT(dart_signature_.IsZoneHandle());
   }
 
+  AbstractTypePtr DartType(intptr_t arg_index) const;
+
  private:
   // Contains the function pointer as argument #0.
   // The Dart signature is used for the function and argument names.
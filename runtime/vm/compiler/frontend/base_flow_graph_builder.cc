@@ -980,53 +980,91 @@ Fragment BaseFlowGraphBuilder::Box(Representation from) {
   return Fragment(box);
 }
 
-Fragment BaseFlowGraphBuilder::BuildFfiAsFunctionInternalCall(
-    const TypeArguments& signatures) {
+// Allocates the closure of an FFI trampoline. The context holds the pointer,
+// or for lazily bound functions null followed by the library and symbol name
+// the trampoline resolves the pointer from on its first call.
+static Fragment AllocateFfiTrampolineClosure(BaseFlowGraphBuilder* builder,
+                                             const TypeArguments& signatures,
+                                             bool is_leaf,
+                                             LocalVariable* pointer,
+                                             LocalVariable* library,
+                                             LocalVariable* symbol) {
   ASSERT(signatures.IsInstantiated());
   ASSERT(signatures.Length() == 2);
+  Zone* zone = Thread::Current()->zone();
 
   const AbstractType& dart_type = AbstractType::Handle(signatures.TypeAt(0));
   const AbstractType& native_type = AbstractType::Handle(signatures.TypeAt(1));
 
   ASSERT(dart_type.IsFunctionType() && native_type.IsFunctionType());
+  const bool is_lazy = pointer == nullptr;
   const Function& target =
       Function::ZoneHandle(compiler::ffi::TrampolineFunction(
-          Function::Handle(Z, Type::Cast(dart_type).signature()),
-          Function::Handle(Z, Type::Cast(native_type).signature())));
+          Function::Handle(zone, Type::Cast(dart_type).signature()),
+          Function::Handle(zone, Type::Cast(native_type).signature()), is_leaf,
+          is_lazy));
 
   Fragment code;
-  // Store the pointer in the context, we cannot load the untagged address
-  // here as these can be unoptimized call sites.
-  LocalVariable* pointer = MakeTemporary();
-
   auto& context_slots = CompilerState::Current().GetDummyContextSlots(
-      /*context_id=*/0, /*num_variables=*/1);
-  code += AllocateContext(context_slots);
-  LocalVariable* context = MakeTemporary();
-
-  code += LoadLocal(context);
-  code += LoadLocal(pointer);
-  code += StoreInstanceField(TokenPosition::kNoSource, *context_slots[0]);
+      /*context_id=*/0, /*num_variables=*/is_lazy ? 3 : 1);
+  code += builder->AllocateContext(context_slots);
+  LocalVariable* context = builder->MakeTemporary();
+
+  code += builder->LoadLocal(context);
+  code += is_lazy ? builder->NullConstant() : builder->LoadLocal(pointer);
+  code += builder->StoreInstanceField(TokenPosition::kNoSource,
+                                      *context_slots[0]);
+  if (is_lazy) {
+    code += builder->LoadLocal(context);
+    code += builder->LoadLocal(library);
+    code += builder->StoreInstanceField(TokenPosition::kNoSource,
+                                        *context_slots[1]);
+    code += builder->LoadLocal(context);
+    code += builder->LoadLocal(symbol);
+    code += builder->StoreInstanceField(TokenPosition::kNoSource,
+                                        *context_slots[2]);
+  }
 
-  code += AllocateClosure(TokenPosition::kNoSource, target);
-  LocalVariable* closure = MakeTemporary();
+  code += builder->AllocateClosure(TokenPosition::kNoSource, target);
+  LocalVariable* closure = builder->MakeTemporary();
 
-  code += LoadLocal(closure);
-  code += LoadLocal(context);
-  code += StoreInstanceField(TokenPosition::kNoSource, Slot::Closure_context(),
-                             StoreInstanceFieldInstr::Kind::kInitializing);
+  code += builder->LoadLocal(closure);
+  code += builder->LoadLocal(context);
+  code += builder->StoreInstanceField(
+      TokenPosition::kNoSource, Slot::Closure_context(),
+      StoreInstanceFieldInstr::Kind::kInitializing);
 
-  code += LoadLocal(closure);
-  code += Constant(target);
-  code += StoreInstanceField(TokenPosition::kNoSource, Slot::Closure_function(),
-                             StoreInstanceFieldInstr::Kind::kInitializing);
+  code += builder->LoadLocal(closure);
+  code += builder->Constant(target);
+  code += builder->StoreInstanceField(
+      TokenPosition::kNoSource, Slot::Closure_function(),
+      StoreInstanceFieldInstr::Kind::kInitializing);
 
-  // Drop address and context.
-  code += DropTempsPreserveTop(2);
+  // Drop the arguments and context.
+  code += builder->DropTempsPreserveTop(is_lazy ? 3 : 2);
 
   return code;
 }
 
+Fragment BaseFlowGraphBuilder::BuildFfiAsFunctionInternalCall(
+    const TypeArguments& signatures,
+    bool is_leaf) {
+  // Store the pointer in the context, we cannot load the untagged address
+  // here as these can be unoptimized call sites.
+  LocalVariable* pointer = MakeTemporary();
+  return AllocateFfiTrampolineClosure(this, signatures, is_leaf, pointer,
+                                      /*library=*/nullptr, /*symbol=*/nullptr);
+}
+
+Fragment BaseFlowGraphBuilder::BuildFfiAsLazyFunctionInternalCall(
+    const TypeArguments& signatures,
+    bool is_leaf,
+    LocalVariable* library,
+    LocalVariable* symbol) {
+  return AllocateFfiTrampolineClosure(this, signatures, is_leaf,
+                                      /*pointer=*/nullptr, library, symbol);
+}
+
 Fragment BaseFlowGraphBuilder::DebugStepCheck(TokenPosition position) {
 #ifdef PRODUCT
   return Fragment();
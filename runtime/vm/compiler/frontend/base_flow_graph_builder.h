@@ -352,7 +352,15 @@ class BaseFlowGraphBuilder {
   // Builds the graph for an invocation of '_asFunctionInternal'.
   //
   // 'signatures' contains the pair [<dart signature>, <native signature>].
-  Fragment BuildFfiAsFunctionInternalCall(const TypeArguments& signatures);
+  Fragment BuildFfiAsFunctionInternalCall(const TypeArguments& signatures,
+                                          bool is_leaf);
+
+  // Builds the graph for an invocation of '_asLazyFunctionInternal', whose
+  // arguments are the temporaries 'library' and 'symbol' on top of the stack.
+  Fragment BuildFfiAsLazyFunctionInternalCall(const TypeArguments& signatures,
+                                              bool is_leaf,
+                                              LocalVariable* library,
+                                              LocalVariable* symbol);
 
   Fragment AllocateObject(TokenPosition position,
                           const Class& klass,
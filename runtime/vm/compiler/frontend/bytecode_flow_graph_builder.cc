@@ -5,6 +5,7 @@
 #include "vm/compiler/frontend/bytecode_flow_graph_builder.h"
 
 #include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/ffi/call.h"
 #include "vm/compiler/ffi/callback.h"
 #include "vm/compiler/frontend/bytecode_reader.h"
 #include "vm/compiler/frontend/prologue_builder.h"
@@ -831,9 +832,14 @@ void BytecodeFlowGraphBuilder::BuildDirectCallCommon(bool is_unchecked_call) {
   const Function& target = Function::Cast(ConstantAt(DecodeOperandD()).value());
   const intptr_t argc = DecodeOperandF().value();
 
+  if (compiler::ffi::IsAsLeafFunctionInternal(target)) {
+    BuildFfiAsFunction(/*is_leaf=*/true);
+    return;
+  }
+
   switch (target.recognized_kind()) {
     case MethodRecognizer::kFfiAsFunctionInternal:
-      BuildFfiAsFunction();
+      BuildFfiAsFunction(/*is_leaf=*/false);
       return;
     case MethodRecognizer::kFfiNativeCallbackFunction:
       if (CompilerState::Current().is_aot()) {
@@ -1922,20 +1928,20 @@ void BytecodeFlowGraphBuilder::BuildAllocateClosure() {
   code_ += B->AllocateClosure(position_, target);
 }
 
-// Builds graph for a call to 'dart:ffi::_asFunctionInternal'. The stack must
-// look like:
+// Builds graph for a call to 'dart:ffi::_asFunctionInternal' or
+// 'dart:ffi::_asLeafFunctionInternal'. The stack must look like:
 //
 // <receiver> => pointer argument
 // <type arguments vector> => signatures
 // ...
-void BytecodeFlowGraphBuilder::BuildFfiAsFunction() {
+void BytecodeFlowGraphBuilder::BuildFfiAsFunction(bool is_leaf) {
   // The bytecode FGB doesn't eagerly insert PushArguments, so the type
   // arguments won't be wrapped in a PushArgumentsInstr.
   const TypeArguments& type_args =
       TypeArguments::Cast(B->Peek(/*depth=*/1)->AsConstant()->value());
   // Drop type arguments, preserving pointer.
   code_ += B->DropTempsPreserveTop(1);
-  code_ += B->BuildFfiAsFunctionInternalCall(type_args);
+  code_ += B->BuildFfiAsFunctionInternalCall(type_args, is_leaf);
 }
 
 // Builds graph for a call to 'dart:ffi::_nativeCallbackFunction'.
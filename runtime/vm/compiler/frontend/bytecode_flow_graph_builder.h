@@ -176,7 +176,7 @@ class BytecodeFlowGraphBuilder {
                                 bool is_instantiated_call);
 
   void BuildInstruction(KernelBytecode::Opcode opcode);
-  void BuildFfiAsFunction();
+  void BuildFfiAsFunction(bool is_leaf);
   void BuildFfiNativeCallbackFunction();
   void BuildDebugStepCheck();
 
@@ -4,6 +4,7 @@
 
 #include "vm/compiler/frontend/kernel_binary_flowgraph.h"
 
+#include "vm/compiler/ffi/call.h"
 #include "vm/compiler/ffi/callback.h"
 #include "vm/compiler/frontend/bytecode_flow_graph_builder.h"
 #include "vm/compiler/frontend/bytecode_reader.h"
@@ -3289,8 +3290,13 @@ Fragment StreamingFlowGraphBuilder::BuildStaticInvocation(TokenPosition* p) {
   }
 
   const auto recognized_kind = target.recognized_kind();
+  bool is_leaf = false;
   if (recognized_kind == MethodRecognizer::kFfiAsFunctionInternal) {
-    return BuildFfiAsFunctionInternal();
+    return BuildFfiAsFunctionInternal(/*is_leaf=*/false);
+  } else if (compiler::ffi::IsAsLeafFunctionInternal(target)) {
+    return BuildFfiAsFunctionInternal(/*is_leaf=*/true);
+  } else if (compiler::ffi::IsAsLazyFunctionInternal(target, &is_leaf)) {
+    return BuildFfiAsLazyFunctionInternal(is_leaf);
   } else if (CompilerState::Current().is_aot() &&
              recognized_kind == MethodRecognizer::kFfiNativeCallbackFunction) {
     return BuildFfiNativeCallbackFunction();
@@ -4848,11 +4854,13 @@ Fragment StreamingFlowGraphBuilder::BuildTryCatch() {
 
   // In case the last catch body was not handling the exception and branching to
   // after the try block, we will rethrow the exception (i.e. no default catch
-  // handler).
+  // handler). The rethrow does not mark the handler as needing a stacktrace:
+  // the runtime collects one whenever it cannot prove that one of the guarded
+  // types matches the thrown exception (see ExceptionHandlerFinder::Find).
   if (catch_body.is_open()) {
     catch_body += LoadLocal(CurrentException());
     catch_body += LoadLocal(CurrentStackTrace());
-    catch_body += RethrowException(TokenPosition::kNoSource, try_handler_index);
+    catch_body += RethrowException(TokenPosition::kNoSource, kInvalidTryIndex);
     Drop();
   }
   catch_depth_dec();
@@ -5224,7 +5232,7 @@ Fragment StreamingFlowGraphBuilder::BuildFunctionNode(
   return instructions;
 }
 
-Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal() {
+Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal(bool is_leaf) {
   const intptr_t argc = ReadUInt();               // read argument count.
   ASSERT(argc == 1);                              // pointer
   const intptr_t list_length = ReadListLength();  // read types list length.
@@ -5239,7 +5247,31 @@ Fragment StreamingFlowGraphBuilder::BuildFfiAsFunctionInternal() {
   const intptr_t named_args_len =
       ReadListLength();  // skip (empty) named arguments list
   ASSERT(named_args_len == 0);
-  code += B->BuildFfiAsFunctionInternalCall(type_arguments);
+  code += B->BuildFfiAsFunctionInternalCall(type_arguments, is_leaf);
+  return code;
+}
+
+Fragment StreamingFlowGraphBuilder::BuildFfiAsLazyFunctionInternal(
+    bool is_leaf) {
+  const intptr_t argc = ReadUInt();               // read argument count.
+  ASSERT(argc == 2);                              // library, symbol name
+  const intptr_t list_length = ReadListLength();  // read types list length.
+  ASSERT(list_length == 2);  // dart signature, then native signature
+  const TypeArguments& type_arguments =
+      T.BuildTypeArguments(list_length);  // read types.
+  Fragment code;
+  const intptr_t positional_count =
+      ReadListLength();  // read positional argument count
+  ASSERT(positional_count == 2);
+  code += BuildExpression();  // build first positional argument (library)
+  LocalVariable* library = MakeTemporary();
+  code += BuildExpression();  // build second positional argument (symbol)
+  LocalVariable* symbol = MakeTemporary();
+  const intptr_t named_args_len =
+      ReadListLength();  // skip (empty) named arguments list
+  ASSERT(named_args_len == 0);
+  code += B->BuildFfiAsLazyFunctionInternalCall(type_arguments, is_leaf,
+                                                library, symbol);
   return code;
 }
 
@@ -360,7 +360,8 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
 
   // Build build FG for '_asFunctionInternal'. Reads an Arguments from the
   // Kernel buffer and pushes the resulting closure.
-  Fragment BuildFfiAsFunctionInternal();
+  Fragment BuildFfiAsFunctionInternal(bool is_leaf);
+  Fragment BuildFfiAsLazyFunctionInternal(bool is_leaf);
 
   // Build build FG for '_nativeCallbackFunction'. Reads an Arguments from the
   // Kernel buffer and pushes the resulting Function object.
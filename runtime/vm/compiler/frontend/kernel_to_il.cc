@@ -373,11 +373,12 @@ Fragment FlowGraphBuilder::InstanceCall(
 }
 
 Fragment FlowGraphBuilder::FfiCall(
-    const compiler::ffi::CallMarshaller& marshaller) {
+    const compiler::ffi::CallMarshaller& marshaller,
+    bool is_leaf) {
   Fragment body;
 
   FfiCallInstr* const call =
-      new (Z) FfiCallInstr(Z, GetNextDeoptId(), marshaller);
+      new (Z) FfiCallInstr(Z, GetNextDeoptId(), marshaller, is_leaf);
 
   for (intptr_t i = call->InputCount() - 1; i >= 0; --i) {
     call->SetInputAt(i, Pop());
@@ -3338,7 +3339,12 @@ Fragment FlowGraphBuilder::FfiConvertArgumentToNative(
     LocalVariable* api_local_scope) {
   Fragment body;
 
-  if (marshaller.IsPointer(arg_index)) {
+  if (marshaller.IsTypedData(arg_index)) {
+    // Checked by FfiCheckTypedDataArgument. The inner pointer stays valid
+    // because nothing can trigger a GC until the leaf call returns.
+    body += LoadUntagged(compiler::target::PointerBase::data_field_offset());
+    body += ConvertUntaggedToUnboxed(kUnboxedFfiIntPtr);
+  } else if (marshaller.IsPointer(arg_index)) {
     // This can only be Pointer, so it is always safe to LoadUntagged.
     body += LoadUntagged(compiler::target::Pointer::data_field_offset());
     body += ConvertUntaggedToUnboxed(kUnboxedFfiIntPtr);
@@ -3356,6 +3362,72 @@ Fragment FlowGraphBuilder::FfiConvertArgumentToNative(
   return body;
 }
 
+Fragment FlowGraphBuilder::FfiCheckTypedDataArgument(LocalVariable* variable) {
+  // All VM typed data, including external typed data and views, have a class
+  // id in this range.
+  COMPILE_ASSERT(kTypedDataInt8ArrayCid < kByteDataViewCid);
+  Fragment check;
+  JoinEntryInstr* unsupported = BuildJoinEntry();
+
+  check += LoadLocal(variable);
+  check += LoadClassId();
+  check += IntConstant(kTypedDataInt8ArrayCid);
+  check += SmiRelationalOp(Token::kGTE);
+  TargetEntryInstr *above_first, *below_first;
+  check += BranchIfTrue(&above_first, &below_first);
+  Fragment(below_first) + Goto(unsupported);
+
+  check.current = above_first;
+  check += LoadLocal(variable);
+  check += LoadClassId();
+  check += IntConstant(kByteDataViewCid);
+  check += SmiRelationalOp(Token::kLTE);
+  TargetEntryInstr *supported, *above_last;
+  check += BranchIfTrue(&supported, &above_last);
+  Fragment(above_last) + Goto(unsupported);
+
+  const Function& throw_function = Function::ZoneHandle(
+      Z, Library::Handle(Z, Library::FfiLibrary())
+             .LookupFunctionAllowPrivate(Symbols::ThrowUnsupportedTypedData()));
+  ASSERT(!throw_function.IsNull());
+  Fragment throw_error(unsupported);
+  throw_error += LoadLocal(variable);
+  throw_error += StaticCall(TokenPosition::kNoSource, throw_function,
+                            /*argument_count=*/1, ICData::kStatic);
+  // Properly close graph with a ThrowInstr, although it is not executed.
+  throw_error += ThrowException(TokenPosition::kNoSource);
+  throw_error += Drop();
+
+  return Fragment(check.entry, supported);
+}
+
+Fragment FlowGraphBuilder::FfiResolveLazyFunction(LocalVariable* closure) {
+  Fragment check;
+  check += LoadLocal(closure);
+  check += LoadNativeField(Slot::Closure_context());
+  check += LoadNativeField(Slot::GetContextVariableSlotFor(
+      thread_, *MakeImplicitClosureScope(
+                    Z, Class::Handle(I->object_store()->ffi_pointer_class()))
+                    ->context_variables()[0]));
+  TargetEntryInstr *unresolved, *resolved;
+  check += BranchIfNull(&unresolved, &resolved);
+  JoinEntryInstr* join = BuildJoinEntry();
+
+  const Function& resolve_function = Function::ZoneHandle(
+      Z, Library::Handle(Z, Library::FfiLibrary())
+             .LookupFunctionAllowPrivate(Symbols::ResolveLazyFunction()));
+  ASSERT(!resolve_function.IsNull());
+  Fragment resolve(unresolved);
+  resolve += LoadLocal(closure);
+  resolve += StaticCall(TokenPosition::kNoSource, resolve_function,
+                        /*argument_count=*/1, ICData::kStatic);
+  resolve += Drop();
+  resolve += Goto(join);
+
+  Fragment(resolved) + Goto(join);
+  return Fragment(check.entry, join);
+}
+
 FlowGraph* FlowGraphBuilder::BuildGraphOfFfiTrampoline(
     const Function& function) {
   if (function.FfiCallbackTarget() != Function::null()) {
@@ -3386,6 +3458,11 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
   const auto& marshaller = *new (Z) compiler::ffi::CallMarshaller(Z, function);
 
   const bool signature_contains_handles = marshaller.ContainsHandles();
+  const bool is_leaf = function.FfiIsLeaf();
+  // Rejected by the front end, leaf calls don't enter an API scope and only
+  // leaf calls can be sure that typed data isn't moved during the call.
+  ASSERT(!is_leaf || !signature_contains_handles);
+  ASSERT(is_leaf || !marshaller.ContainsTypedData());
 
   BuildArgumentTypeChecks(TypeChecksToBuild::kCheckAllTypeParameterBounds,
                           &function_body, &function_body, &function_body);
@@ -3408,6 +3485,16 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
         TokenPosition::kNoSource,
         parsed_function_->ParameterVariable(kFirstArgumentParameterOffset + i));
     function_body += Drop();
+    if (marshaller.IsTypedData(i)) {
+      function_body += FfiCheckTypedDataArgument(
+          parsed_function_->ParameterVariable(kFirstArgumentParameterOffset +
+                                              i));
+    }
+  }
+
+  if (function.FfiIsLazy()) {
+    function_body += FfiResolveLazyFunction(
+        parsed_function_->ParameterVariable(kClosureParameterOffset));
   }
 
   Fragment body;
@@ -3444,7 +3531,7 @@ FlowGraph* FlowGraphBuilder::BuildGraphOfFfiNative(const Function& function) {
   // This can only be Pointer, so it is always safe to LoadUntagged.
   body += LoadUntagged(compiler::target::Pointer::data_field_offset());
   body += ConvertUntaggedToUnboxed(kUnboxedFfiIntPtr);
-  body += FfiCall(marshaller);
+  body += FfiCall(marshaller, is_leaf);
 
   for (intptr_t i = 0; i < marshaller.num_args(); i++) {
     if (marshaller.IsPointer(i)) {
@@ -159,7 +159,8 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
       const CallSiteAttributesMetadata* call_site_attrs = nullptr,
       bool receiver_is_not_smi = false);
 
-  Fragment FfiCall(const compiler::ffi::CallMarshaller& marshaller);
+  Fragment FfiCall(const compiler::ffi::CallMarshaller& marshaller,
+                   bool is_leaf);
 
   Fragment ThrowException(TokenPosition position);
   Fragment RethrowException(TokenPosition position, int catch_try_index);
@@ -236,6 +237,14 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
       intptr_t arg_index,
       LocalVariable* api_local_scope);
 
+  // Throws an ArgumentError if the TypedData argument in [variable] is not
+  // implemented by the VM, and therefore has no pointer to its contents.
+  Fragment FfiCheckTypedDataArgument(LocalVariable* variable);
+
+  // Looks up the native function of the lazily bound FFI trampoline closure in
+  // [closure] on its first call, storing it as Pointer in its context.
+  Fragment FfiResolveLazyFunction(LocalVariable* closure);
+
   // Reverse of 'FfiConvertArgumentToNative'.
   Fragment FfiConvertArgumentToDart(
       const compiler::ffi::BaseMarshaller& marshaller,
@@ -45,6 +45,7 @@
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/timer.h"
+#include "vm/usdt.h"
 #endif
 
 namespace dart {
@@ -69,6 +70,11 @@ DEFINE_FLAG(bool,
             stress_test_background_compilation,
             false,
             "Keep background compiler running all the time");
+DEFINE_FLAG(bool,
+            prioritize_background_compilation,
+            true,
+            "Optimize the queued function with the most calls per token first "
+            "instead of compiling the background queue in FIFO order.");
 DEFINE_FLAG(bool,
             stop_on_excessive_deoptimization,
             false,
@@ -942,8 +948,11 @@ ObjectPtr Compiler::CompileOptimizedFunction(Thread* thread,
 
   CompilationPipeline* pipeline =
       CompilationPipeline::New(thread->zone(), function);
-  return CompileFunctionHelper(pipeline, function, /* optimized = */ true,
-                               osr_id);
+  DART_USDT2(compile__start, osr_id, IsBackgroundCompilation());
+  ObjectPtr result = CompileFunctionHelper(pipeline, function,
+                                           /* optimized = */ true, osr_id);
+  DART_USDT2(compile__end, osr_id, IsBackgroundCompilation());
+  return result;
 }
 
 void Compiler::ComputeLocalVarDescriptors(const Code& code) {
@@ -1068,7 +1077,9 @@ void Compiler::AbortBackgroundCompilation(intptr_t deopt_id, const char* msg) {
 class QueueElement {
  public:
   explicit QueueElement(const Function& function)
-      : next_(NULL), function_(function.raw()) {}
+      : next_(NULL),
+        function_(function.raw()),
+        enqueued_micros_(OS::GetCurrentMonotonicMicros()) {}
 
   virtual ~QueueElement() {
     next_ = NULL;
@@ -1083,9 +1094,12 @@ class QueueElement {
   ObjectPtr function() const { return function_; }
   ObjectPtr* function_ptr() { return reinterpret_cast<ObjectPtr*>(&function_); }
 
+  int64_t enqueued_micros() const { return enqueued_micros_; }
+
  private:
   QueueElement* next_;
   FunctionPtr function_;
+  int64_t enqueued_micros_;
 
   DISALLOW_COPY_AND_ASSIGN(QueueElement);
 };
@@ -1143,6 +1157,36 @@ class BackgroundCompilationQueue {
     return result;
   }
 
+  // Moves the element with the highest priority to the front of the queue.
+  // Elements with equal priority keep their FIFO order.
+  void MoveHottestToFront() {
+    if ((first_ == NULL) || (first_->next() == NULL)) {
+      return;
+    }
+    Function& function = Function::Handle();
+    QueueElement* best = first_;
+    QueueElement* best_prev = NULL;
+    double best_priority = Priority(best, &function);
+    for (QueueElement *prev = first_, *p = first_->next(); p != NULL;
+         prev = p, p = p->next()) {
+      const double priority = Priority(p, &function);
+      if (priority > best_priority) {
+        best = p;
+        best_prev = prev;
+        best_priority = priority;
+      }
+    }
+    if (best == first_) {
+      return;
+    }
+    best_prev->set_next(best->next());
+    if (last_ == best) {
+      last_ = best_prev;
+    }
+    best->set_next(first_);
+    first_ = best;
+  }
+
   bool ContainsObj(const Object& obj) const {
     QueueElement* p = first_;
     while (p != NULL) {
@@ -1163,6 +1207,24 @@ class BackgroundCompilationQueue {
   }
 
  private:
+  // The usage counter of a function is reset to kMinInt32 when it is queued
+  // for optimization, so it counts the calls made while the function waits.
+  // Dividing by the length of the function favours small hot functions,
+  // which are cheap to compile and profit the most, over huge ones which are
+  // barely used and would block the queue. [function] is a handle reused
+  // across calls.
+  static double Priority(QueueElement* element, Function* function) {
+    *function = element->Function();
+    const int64_t usage = function->usage_counter();
+    const int64_t calls = (usage < 0) ? usage - kMinInt32 : usage;
+    const intptr_t length =
+        function->end_token_pos().Pos() - function->token_pos().Pos();
+    if (length >= FLAG_huge_method_cutoff_in_tokens) {
+      return 0.0;
+    }
+    return static_cast<double>(calls) / Utils::Maximum<intptr_t>(length, 1);
+  }
+
   QueueElement* first_;
   QueueElement* last_;
 
@@ -1184,6 +1246,41 @@ BackgroundCompiler::~BackgroundCompiler() {
   delete function_queue_;
 }
 
+#if !defined(PRODUCT)
+// Reports how long [function] waited in the queue before its compilation
+// started.
+static void ReportQueueWait(const Function& function,
+                            int64_t enqueued_micros) {
+  TimelineStream* compiler_stream = Timeline::GetCompilerStream();
+  if (!compiler_stream->enabled()) {
+    return;
+  }
+  const char* name = function.ToLibNamePrefixedQualifiedCString();
+  TimelineEvent* event = compiler_stream->StartEvent();
+  if (event != NULL) {
+    event->Duration("BackgroundCompilationQueueWait", enqueued_micros,
+                    OS::GetCurrentMonotonicMicros());
+    event->SetNumArguments(1);
+    event->CopyArgument(0, "function", name);
+    event->Complete();
+  }
+}
+#endif  // !defined(PRODUCT)
+
+// Returns the next function to compile, or null if the queue is empty.
+// Must be called with the queue monitor held.
+FunctionPtr BackgroundCompiler::NextFunction(int64_t* enqueued_micros) {
+  if (is_optimizing() && FLAG_prioritize_background_compilation) {
+    function_queue()->MoveHottestToFront();
+  }
+  QueueElement* element = function_queue()->Peek();
+  if (element == NULL) {
+    return Function::null();
+  }
+  *enqueued_micros = element->enqueued_micros();
+  return element->Function();
+}
+
 void BackgroundCompiler::Run() {
   while (running_) {
     // Maybe something is already in the queue, check first before waiting
@@ -1196,13 +1293,17 @@ void BackgroundCompiler::Run() {
       Zone* zone = stack_zone.GetZone();
       HANDLESCOPE(thread);
       Function& function = Function::Handle(zone);
+      int64_t enqueued_micros = 0;
       {
         MonitorLocker ml(&queue_monitor_);
         if (running_) {
-          function = function_queue()->PeekFunction();
+          function = NextFunction(&enqueued_micros);
         }
       }
       while (!function.IsNull()) {
+#if !defined(PRODUCT)
+        ReportQueueWait(function, enqueued_micros);
+#endif  // !defined(PRODUCT)
         if (is_optimizing()) {
           Compiler::CompileOptimizedFunction(thread, function,
                                              Compiler::kNoOSRDeoptId);
@@ -1231,7 +1332,7 @@ void BackgroundCompiler::Run() {
                 function_queue()->Add(repeat_qelem);
               }
             }
-            function = function_queue()->PeekFunction();
+            function = NextFunction(&enqueued_micros);
           }
         }
         if (qelem != NULL) {
@@ -196,6 +196,7 @@ class BackgroundCompiler {
   void Disable();
   bool IsDisabled();
   bool IsRunning() { return !done_; }
+  FunctionPtr NextFunction(int64_t* enqueued_micros);
 
   Isolate* isolate_;
 
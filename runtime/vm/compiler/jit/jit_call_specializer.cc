@@ -145,9 +145,13 @@ void JitCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
   // very polymorphic sites we don't make this optimization, keeping it as a
   // regular checked PolymorphicInstanceCall, which falls back to the slow but
   // non-deopting megamorphic call stub when it sees new receiver classes.
+  //
+  // Receivers whose class was extended late are likely to see new classes
+  // again, so they get the non-deoptimizing call as well.
   if (has_one_target && FLAG_polymorphic_with_deopt &&
       (!instr->ic_data()->HasDeoptReason(ICData::kDeoptCheckClass) ||
-       targets.length() <= FLAG_max_polymorphic_checks)) {
+       targets.length() <= FLAG_max_polymorphic_checks) &&
+      !flow_graph()->IsReceiverClassExtendedLate(instr)) {
     // Type propagation has not run yet, we cannot eliminate the check.
     AddReceiverCheck(instr);
 
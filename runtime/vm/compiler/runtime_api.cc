@@ -765,6 +765,14 @@ word RegExp::function_offset(classid_t cid, bool sticky) {
   return TranslateOffsetInWords(dart::RegExp::function_offset(cid, sticky));
 }
 
+word RegExp::required_literal_offset() {
+  return TranslateOffsetInWords(dart::RegExp::required_literal_offset());
+}
+
+word RegExp::linear_program_offset() {
+  return TranslateOffsetInWords(dart::RegExp::linear_program_offset());
+}
+
 const word Symbols::kNumberOfOneCharCodeSymbols =
     dart::Symbols::kNumberOfOneCharCodeSymbols;
 const word Symbols::kNullCharCodeSymbolOffset =
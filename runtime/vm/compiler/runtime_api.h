@@ -1268,6 +1268,8 @@ class NativeEntry {
 class RegExp : public AllStatic {
  public:
   static word function_offset(classid_t cid, bool sticky);
+  static word required_literal_offset();
+  static word linear_program_offset();
   static word InstanceSize();
   static word NextFieldOffset();
 };
@@ -65,8 +65,10 @@ typedef DirectChainedHashMap<DefinitionIndexPairTrait> DefinitionIndexMap;
 // across these instructions, the runtime ensures that any live temporaries
 // (except arrays) promoted during a scavenge caused by a non-Dart-call
 // instruction (see Instruction::CanCallDart()) will be added to the store
-// buffer. Additionally, if concurrent marking was initiated, the runtime
-// ensures that all live temporaries are also in the deferred marking stack.
+// buffer. Arrays longer than Array::kMaxLengthForWriteBarrierElimination are
+// not, to bound the work added to the remembered set. Additionally, if
+// concurrent marking was initiated, the runtime ensures that all live
+// temporaries are also in the deferred marking stack.
 //
 // See also Thread::RememberLiveTemporaries() and
 // Thread::DeferredMarkLiveTemporaries().
@@ -99,6 +101,21 @@ class WriteBarrierElimination : public ValueObject {
                             def->AsAllocation()->WillAllocateNewOrRemembered());
   }
 
+  // Large array allocations are not remembered by the runtime after a
+  // scavenge, see Thread::RememberLiveTemporaries().
+  static bool IsCreateLargeArray(Definition* def) {
+    if (CreateArrayInstr* create_array = def->AsCreateArray()) {
+      Value* num_elements = create_array->num_elements();
+      if (!num_elements->BindsToConstant() ||
+          !num_elements->BoundConstant().IsSmi()) {
+        return true;
+      }
+      return Smi::Cast(num_elements->BoundConstant()).Value() >
+             Array::kMaxLengthForWriteBarrierElimination;
+    }
+    return false;
+  }
+
 #if defined(DEBUG)
   static bool SlotEligibleForWBE(const Slot& slot);
 #endif
@@ -112,8 +129,8 @@ class WriteBarrierElimination : public ValueObject {
   // Maps each usable definition to its index in the bitvectors.
   DefinitionIndexMap definition_indices_;
 
-  // Bitvector with all non-Array-allocation instructions set. Used to
-  // un-mark Array allocations as usable.
+  // Bitvector with all non-large-Array-allocation instructions set. Used to
+  // un-mark large Array allocations as usable.
   BitVector* array_allocations_mask_;
 
   // Bitvectors for each block of which allocations are new or remembered
@@ -209,7 +226,8 @@ void WriteBarrierElimination::IndexDefinitions(Zone* zone) {
     for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
       if (Definition* current = it.Current()->AsDefinition()) {
         if (IsUsable(current)) {
-          array_allocations.Set(definition_count_, current->IsCreateArray());
+          array_allocations.Set(definition_count_,
+                                IsCreateLargeArray(current));
           definition_indices_.Insert({current, definition_count_++});
 #if defined(DEBUG)
           if (tracing_) {
@@ -367,8 +385,8 @@ void WriteBarrierElimination::UpdateVectorForBlock(BlockEntryInstr* entry,
     if (current->CanCallDart()) {
       vector_->Clear();
     } else if (current->CanTriggerGC()) {
-      // Clear array allocations. These are not added to the remembered set
-      // by Thread::RememberLiveTemporaries() after a scavenge.
+      // Clear large array allocations. These are not added to the remembered
+      // set by Thread::RememberLiveTemporaries() after a scavenge.
       vector_->Intersect(array_allocations_mask_);
     }
 
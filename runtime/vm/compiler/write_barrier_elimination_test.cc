@@ -140,7 +140,7 @@ ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Arrays) {
   DEBUG_ONLY(FLAG_trace_write_barrier_elimination = true);
   const char* nullable_tag = TestCase::NullableTag();
 
-  // Test that array allocations are not considered usable after a
+  // Test that large array allocations are not considered usable after a
   // may-trigger-GC instruction (in this case CheckStackOverflow), unlike
   // normal allocations, which are only interruped by a Dart call.
   // clang-format off
@@ -156,7 +156,7 @@ ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Arrays) {
       foo(int x) {
         C c = C();
         C n = C();
-        List<C%s> array = List<C%s>.filled(1, null);
+        List<C%s> array = List<C%s>.filled(100, null);
         while (x --> 0) {
           c.next = n;
           n = c;
@@ -204,4 +204,72 @@ ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_Arrays) {
   EXPECT(store_into_array->ShouldEmitStoreBarrier() == true);
 }
 
+ISOLATE_UNIT_TEST_CASE(IRTest_WriteBarrierElimination_SmallArrays) {
+  DEBUG_ONLY(FLAG_trace_write_barrier_elimination = true);
+  const char* nullable_tag = TestCase::NullableTag();
+
+  // Test that small array allocations stay usable after a may-trigger-GC
+  // instruction (in this case CheckStackOverflow), like normal allocations.
+  // The runtime remembers them in Thread::RememberLiveTemporaries.
+  // clang-format off
+  auto kScript =
+      Utils::CStringUniquePtr(OS::SCreate(nullptr, R"(
+      class C {
+        %s C next;
+      }
+
+      @pragma("vm:never-inline")
+      fn() {}
+
+      foo(int x) {
+        C c = C();
+        C n = C();
+        List<C%s> array = List<C%s>.filled(1, null);
+        while (x --> 0) {
+          c.next = n;
+          n = c;
+          c = C();
+        }
+        array[0] = c;
+        return c;
+      }
+
+      main() { foo(10); }
+      )", TestCase::LateTag(), nullable_tag, nullable_tag), std::free);
+  // clang-format on
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript.get()));
+
+  Invoke(root_library, "main");
+
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kJIT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  auto entry = flow_graph->graph_entry()->normal_entry();
+  EXPECT(entry != nullptr);
+
+  StoreInstanceFieldInstr* store_into_c = nullptr;
+  StoreIndexedInstr* store_into_array = nullptr;
+
+  ILMatcher cursor(flow_graph, entry);
+  RELEASE_ASSERT(cursor.TryMatch({
+      kMoveGlob,
+      kMatchAndMoveGoto,
+      kMoveGlob,
+      kMatchAndMoveBranchTrue,
+      kMoveGlob,
+      {kMatchAndMoveStoreInstanceField, &store_into_c},
+      kMoveGlob,
+      kMatchAndMoveGoto,
+      kMoveGlob,
+      kMatchAndMoveBranchFalse,
+      kMoveGlob,
+      {kMatchAndMoveStoreIndexed, &store_into_array},
+  }));
+
+  EXPECT(store_into_c->ShouldEmitStoreBarrier() == false);
+  EXPECT(store_into_array->ShouldEmitStoreBarrier() == false);
+}
+
 }  // namespace dart
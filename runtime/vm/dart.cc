@@ -7,6 +7,7 @@
 
 #include "vm/dart.h"
 
+#include "vm/bootstrap_natives.h"
 #include "vm/clustered_snapshot.h"
 #include "vm/code_observers.h"
 #include "vm/compiler/runtime_offsets_extracted.h"
@@ -15,6 +16,8 @@
 #include "vm/dart_api_state.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
+#include "vm/ffi_async_callbacks.h"
+#include "vm/ffi_symbol_cache.h"
 #include "vm/flags.h"
 #include "vm/handles.h"
 #include "vm/heap/become.h"
@@ -34,6 +37,7 @@
 #include "vm/port.h"
 #include "vm/profiler.h"
 #include "vm/reverse_pc_lookup_cache.h"
+#include "vm/runtime_counters.h"
 #include "vm/service_isolate.h"
 #include "vm/simulator.h"
 #include "vm/snapshot.h"
@@ -164,6 +168,25 @@ static void CheckOffsets() {
 #endif  // !defined(IS_SIMARM_X64)
 }
 
+// Scales down the default heap limit and GC task counts when the process runs
+// in a container with memory or CPU limits, so that isolates do not grow past
+// the container's limit and GC tasks do not compete for a CPU quota.
+void Dart::AdjustFlagsForContainerLimits() {
+  const uintptr_t memory_limit = OS::ContainerMemoryLimit();
+  if ((memory_limit != 0) &&
+      (FLAG_old_gen_heap_size == kDefaultMaxOldGenHeapSize)) {
+    // Leave a quarter of the limit for new space, code and native memory.
+    const intptr_t limit_in_mb = static_cast<intptr_t>(memory_limit / MB);
+    // Only ever lower the default cap.
+    FLAG_old_gen_heap_size = static_cast<int>(Utils::Maximum<intptr_t>(
+        Utils::Minimum(kDefaultMaxOldGenHeapSize, limit_in_mb / 4 * 3), 1));
+  }
+  const int processors = OS::NumberOfAvailableProcessors();
+  FLAG_marker_tasks = Utils::Minimum(FLAG_marker_tasks, processors);
+  FLAG_scavenger_tasks = Utils::Minimum(FLAG_scavenger_tasks, processors);
+  FLAG_compactor_tasks = Utils::Minimum(FLAG_compactor_tasks, processors);
+}
+
 char* Dart::Init(const uint8_t* vm_isolate_snapshot,
                  const uint8_t* instructions_snapshot,
                  Dart_IsolateGroupCreateCallback create_group,
@@ -216,6 +239,7 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   SetFileCallbacks(file_open, file_read, file_write, file_close);
   set_entropy_source_callback(entropy_source);
   OS::Init();
+  AdjustFlagsForContainerLimits();
   NOT_IN_PRODUCT(CodeObservers::Init());
   if (observer != nullptr) {
     NOT_IN_PRODUCT(CodeObservers::RegisterExternal(*observer));
@@ -235,7 +259,11 @@ char* Dart::Init(const uint8_t* vm_isolate_snapshot,
   ForwardingCorpse::Init();
   Api::Init();
   NativeSymbolResolver::Init();
+  BootstrapNatives::Init();
   NOT_IN_PRODUCT(Profiler::Init());
+  RuntimeCounters::Init();
+  FfiAsyncCallbacks::Init();
+  FfiSymbolCache::Init();
   SemiSpace::Init();
   NOT_IN_PRODUCT(Metric::Init());
   StoreBuffer::Init();
@@ -585,6 +613,9 @@ char* Dart::Cleanup() {
   delete thread_pool_;
   thread_pool_ = NULL;
 
+  RuntimeCounters::Cleanup();
+  FfiAsyncCallbacks::Cleanup();
+  FfiSymbolCache::Cleanup();
   Api::Cleanup();
   delete predefined_handles_;
   predefined_handles_ = NULL;
@@ -84,6 +84,10 @@ class Dart : public AllStatic {
   static bool VmIsolateNameEquals(const char* name);
 
   static int64_t UptimeMicros();
+
+  // Lowers the default heap size and GC task counts to fit the container
+  // limits reported by the OS.
+  static void AdjustFlagsForContainerLimits();
   static int64_t UptimeMillis() {
     return UptimeMicros() / kMicrosecondsPerMillisecond;
   }
@@ -36,6 +36,7 @@
 #include "vm/native_entry.h"
 #include "vm/native_symbol.h"
 #include "vm/object.h"
+#include "vm/object_graph.h"
 #include "vm/object_store.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
@@ -705,31 +706,21 @@ FinalizablePersistentHandle* FinalizablePersistentHandle::Cast(
   return reinterpret_cast<FinalizablePersistentHandle*>(handle);
 }
 
-void FinalizablePersistentHandle::Finalize(
-    IsolateGroup* isolate_group,
-    FinalizablePersistentHandle* handle) {
-  if (!handle->raw()->IsHeapObject()) {
-    return;  // Free handle.
-  }
-  void* peer = handle->peer();
-  ApiState* state = isolate_group->api_state();
-  ASSERT(state != NULL);
-
-  ASSERT(handle->auto_delete());
-
-  if (handle->callback_signature_ == CallbackSignature::kHandleFinalizer) {
-    Dart_HandleFinalizer callback = handle->callback();
+void FinalizablePersistentHandle::InvokeFinalizer(
+    IsolateGroup* isolate_group) {
+  ASSERT(finalization_pending_);
+  ASSERT(auto_delete());
+  void* peer = this->peer();
+  if (callback_signature_ == CallbackSignature::kHandleFinalizer) {
+    Dart_HandleFinalizer callback = this->callback();
     ASSERT(callback != NULL);
     (*callback)(isolate_group->embedder_data(), peer);
   } else {
-    Dart_WeakPersistentHandleFinalizer callback =
-        handle->CallbackWeakFinalizer();
+    Dart_WeakPersistentHandleFinalizer callback = CallbackWeakFinalizer();
     ASSERT(callback != NULL);
-    Dart_WeakPersistentHandle object = handle->ApiWeakPersistentHandle();
+    Dart_WeakPersistentHandle object = ApiWeakPersistentHandle();
     (*callback)(isolate_group->embedder_data(), object, peer);
   }
-
-  state->FreeWeakPersistentHandle(handle);
 }
 
 // --- Handles ---
@@ -1121,6 +1112,9 @@ DART_EXPORT void Dart_DeleteWeakPersistentHandle(
   ASSERT(state != NULL);
   ASSERT(state->IsActiveWeakPersistentHandle(object));
   auto weak_ref = FinalizablePersistentHandle::Cast(object);
+  if (weak_ref->finalization_pending() && !state->CancelFinalizer(weak_ref)) {
+    return;  // The running finalizer frees the handle.
+  }
   weak_ref->EnsureFreedExternal(isolate_group);
   state->FreeWeakPersistentHandle(weak_ref);
 }
@@ -1228,6 +1222,22 @@ ISOLATE_METRIC_LIST(ISOLATE_METRIC_API)
 #undef ISOLATE_METRIC_API
 #endif  // !defined(PRODUCT)
 
+DART_EXPORT void Dart_GetIsolateUsage(Dart_Isolate isolate,
+                                      Dart_IsolateUsage* usage) {
+  if (isolate == nullptr) {
+    FATAL1("%s expects argument 'isolate' to be non-null.", CURRENT_FUNC);
+  }
+  if (usage == nullptr) {
+    FATAL1("%s expects argument 'usage' to be non-null.", CURRENT_FUNC);
+  }
+  Isolate* iso = reinterpret_cast<Isolate*>(isolate);
+  usage->dart_cpu_micros = iso->cpu_micros(Isolate::kCpuDart);
+  usage->vm_cpu_micros = iso->cpu_micros(Isolate::kCpuVM);
+  usage->gc_cpu_micros = iso->cpu_micros(Isolate::kCpuGC);
+  usage->native_cpu_micros = iso->cpu_micros(Isolate::kCpuNative);
+  usage->allocated_bytes = iso->allocated_bytes();
+}
+
 // --- Isolates ---
 
 static Dart_Isolate CreateIsolate(IsolateGroup* group,
@@ -3447,6 +3457,81 @@ DART_EXPORT Dart_Handle Dart_ListSetAt(Dart_Handle list,
   }
 }
 
+#define SET_LIST_RANGE(type, obj, offset, length, values)                      \
+  const type& array = type::Cast(obj);                                         \
+  if ((offset < 0) || (length < 0) || (offset + length > array.Length())) {    \
+    return Api::NewError("Invalid offset/length passed in to set list range"); \
+  }                                                                            \
+  Object& value_obj = Object::Handle(Z);                                       \
+  for (intptr_t i = 0; i < length; ++i) {                                      \
+    value_obj = Api::UnwrapHandle(values[i]);                                  \
+    if (!value_obj.IsNull() && !value_obj.IsInstance()) {                      \
+      RETURN_TYPE_ERROR(Z, values[i], Instance);                               \
+    }                                                                          \
+  }                                                                            \
+  for (intptr_t i = 0; i < length; ++i) {                                      \
+    value_obj = Api::UnwrapHandle(values[i]);                                  \
+    array.SetAt(offset + i, value_obj);                                        \
+  }                                                                            \
+  return Api::Success();
+
+DART_EXPORT Dart_Handle Dart_ListSetRange(Dart_Handle list,
+                                          intptr_t offset,
+                                          intptr_t length,
+                                          const Dart_Handle* values) {
+  DARTSCOPE(Thread::Current());
+  if (values == NULL) {
+    RETURN_NULL_ERROR(values);
+  }
+  const Object& obj = Object::Handle(Z, Api::UnwrapHandle(list));
+  // If the list is immutable we call into Dart for the indexed setter to
+  // get the unsupported operation exception as the result.
+  if (obj.IsArray() && !Array::Cast(obj).IsImmutable()) {
+    SET_LIST_RANGE(Array, obj, offset, length, values);
+  } else if (obj.IsGrowableObjectArray()) {
+    SET_LIST_RANGE(GrowableObjectArray, obj, offset, length, values);
+  } else if (obj.IsError()) {
+    return list;
+  } else {
+    CHECK_CALLBACK_STATE(T);
+
+    // Check and handle a dart object that implements the List interface.
+    const Instance& instance = Instance::Handle(Z, GetListInstance(Z, obj));
+    if (!instance.IsNull()) {
+      const intptr_t kTypeArgsLen = 0;
+      const intptr_t kNumArgs = 3;
+      ArgumentsDescriptor args_desc(
+          Array::Handle(ArgumentsDescriptor::NewBoxed(kTypeArgsLen, kNumArgs)));
+      const Function& function = Function::Handle(
+          Z, Resolver::ResolveDynamic(instance, Symbols::AssignIndexToken(),
+                                      args_desc));
+      if (!function.IsNull()) {
+        const Array& args = Array::Handle(Z, Array::New(kNumArgs));
+        args.SetAt(0, instance);
+        Integer& index_obj = Integer::Handle(Z);
+        Object& value_obj = Object::Handle(Z);
+        Object& result = Object::Handle(Z);
+        for (intptr_t i = 0; i < length; ++i) {
+          value_obj = Api::UnwrapHandle(values[i]);
+          if (!value_obj.IsNull() && !value_obj.IsInstance()) {
+            RETURN_TYPE_ERROR(Z, values[i], Instance);
+          }
+          index_obj = Integer::New(offset + i);
+          args.SetAt(1, index_obj);
+          args.SetAt(2, value_obj);
+          result = DartEntry::InvokeFunction(function, args);
+          if (result.IsError()) {
+            return Api::NewHandle(T, result.raw());
+          }
+        }
+        return Api::Success();
+      }
+    }
+    return Api::NewArgumentError(
+        "Object does not implement the 'List' interface");
+  }
+}
+
 static ObjectPtr ResolveConstructor(const char* current_func,
                                     const Class& cls,
                                     const String& class_name,
@@ -6126,6 +6211,18 @@ DART_EXPORT Dart_Handle Dart_GetNativeSymbol(Dart_Handle library,
   return Api::Success();
 }
 
+DART_EXPORT Dart_Handle
+Dart_SetFfiNativeResolver(Dart_Handle library,
+                          Dart_FfiNativeResolver resolver) {
+  DARTSCOPE(Thread::Current());
+  const Library& lib = Api::UnwrapLibraryHandle(Z, library);
+  if (lib.IsNull()) {
+    RETURN_TYPE_ERROR(Z, library, Library);
+  }
+  lib.set_ffi_native_resolver(resolver);
+  return Api::Success();
+}
+
 // --- Peer support ---
 
 DART_EXPORT Dart_Handle Dart_GetPeer(Dart_Handle object, void** peer) {
@@ -6379,6 +6476,78 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
   return Api::Success();
 }
 
+DART_EXPORT bool Dart_WriteHeapSnapshot(
+    Dart_StreamingWriteCallback write_callback,
+    void* callback_data,
+    char** error) {
+#if defined(PRODUCT)
+  if (error != NULL) {
+    *error = Utils::StrDup("Heap snapshots are not supported in PRODUCT mode.");
+  }
+  return false;
+#else
+  Thread* thread = Thread::Current();
+  CHECK_ISOLATE(thread->isolate());
+  if (write_callback == NULL) {
+    if (error != NULL) {
+      *error = Utils::StrDup("write_callback must not be NULL.");
+    }
+    return false;
+  }
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HeapSnapshotWriter writer(thread, write_callback, callback_data);
+  writer.Write();
+  return true;
+#endif
+}
+
+DART_EXPORT bool Dart_GetTopRetainersByClass(
+    intptr_t limit,
+    Dart_ClassRetainedSizeCallback callback,
+    void* data,
+    char** error) {
+#if defined(PRODUCT)
+  if (error != NULL) {
+    *error = Utils::StrDup("Heap analysis is not supported in PRODUCT mode.");
+  }
+  return false;
+#else
+  Thread* thread = Thread::Current();
+  CHECK_ISOLATE(thread->isolate());
+  if (callback == NULL || limit < 0) {
+    if (error != NULL) {
+      *error = Utils::StrDup(callback == NULL ? "callback must not be NULL."
+                                              : "limit must not be negative.");
+    }
+    return false;
+  }
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  MallocGrowableArray<HeapDominatorAnalysis::ClassRetainedSize> retainers;
+  {
+    HeapDominatorAnalysis analysis(thread);
+    analysis.TopRetainersByClass(limit, &retainers);
+  }
+  ClassTable* class_table = thread->isolate()->class_table();
+  Class& cls = Class::Handle(zone.GetZone());
+  Library& lib = Library::Handle(zone.GetZone());
+  String& uri = String::Handle(zone.GetZone());
+  for (intptr_t i = 0; i < retainers.length(); i++) {
+    const HeapDominatorAnalysis::ClassRetainedSize& entry = retainers[i];
+    cls = class_table->At(entry.cid);
+    lib = cls.library();
+    uri = lib.IsNull() ? String::null() : lib.url();
+    const char* uri_cstr = uri.IsNull() ? "" : uri.ToCString();
+    const char* name_cstr = cls.ScrubbedNameCString();
+    TransitionVMToNative to_native(thread);
+    callback(data, uri_cstr, name_cstr, entry.instance_count,
+             entry.retained_size);
+  }
+  return true;
+#endif
+}
+
 DART_EXPORT void Dart_SetGCEventCallback(Dart_GCEventCallback callback) {
   Isolate::Current()->heap()->SetGCEventCallback(callback);
 }
@@ -16,6 +16,7 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/debugger_api_impl_test.h"
+#include "vm/heap/safepoint.h"
 #include "vm/heap/verifier.h"
 #include "vm/lockers.h"
 #include "vm/timeline.h"
@@ -23,6 +24,7 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, concurrent_finalizers);
 DECLARE_FLAG(bool, verify_acquired_data);
 
 #ifndef PRODUCT
@@ -1829,6 +1831,37 @@ TEST_CASE(DartAPI_ListAccess) {
   EXPECT_VALID(result);
   EXPECT_EQ(30, value);
 
+  // Check if we can set a range of values.
+  result = Dart_ListSetRange(list_access_test_obj, 0, 2, NULL);
+  EXPECT(Dart_IsError(result));
+
+  values[0] = Dart_NewInteger(100);
+  values[1] = Dart_NewInteger(200);
+  result = Dart_ListSetRange(list_access_test_obj, 2, 2, values);
+  EXPECT(Dart_IsError(result));
+
+  result = Dart_ListSetRange(list_access_test_obj, kRangeOffset, kRangeLength,
+                             values);
+  EXPECT_VALID(result);
+
+  result = Dart_ListGetAt(list_access_test_obj, 0);
+  EXPECT_VALID(result);
+  result = Dart_IntegerToInt64(result, &value);
+  EXPECT_VALID(result);
+  EXPECT_EQ(10, value);
+
+  result = Dart_ListGetAt(list_access_test_obj, 1);
+  EXPECT_VALID(result);
+  result = Dart_IntegerToInt64(result, &value);
+  EXPECT_VALID(result);
+  EXPECT_EQ(100, value);
+
+  result = Dart_ListGetAt(list_access_test_obj, 2);
+  EXPECT_VALID(result);
+  result = Dart_IntegerToInt64(result, &value);
+  EXPECT_VALID(result);
+  EXPECT_EQ(200, value);
+
   // Check that we get an exception (and not a fatal error) when
   // calling ListSetAt and ListSetAsBytes with an immutable list.
   list_access_test_obj = Dart_Invoke(lib, NewString("immutable"), 0, NULL);
@@ -1842,6 +1875,10 @@ TEST_CASE(DartAPI_ListAccess) {
   result = Dart_ListSetAt(list_access_test_obj, 0, Dart_NewInteger(42));
   EXPECT(Dart_IsError(result));
   EXPECT(Dart_IsUnhandledExceptionError(result));
+
+  result = Dart_ListSetRange(list_access_test_obj, 0, 2, values);
+  EXPECT(Dart_IsError(result));
+  EXPECT(Dart_IsUnhandledExceptionError(result));
 }
 
 TEST_CASE(DartAPI_MapAccess) {
@@ -3542,6 +3579,54 @@ TEST_CASE(DartAPI_FinalizableHandleCallback) {
   }
 }
 
+TEST_CASE(DartAPI_FinalizableHandleConcurrentFinalizer) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_finalizers, true);
+  int peer = 0;
+  {
+    Dart_EnterScope();
+    Dart_Handle obj = NewString("new string");
+    EXPECT_VALID(obj);
+    Dart_NewFinalizableHandle(obj, &peer, 0, FinalizableHandlePeerFinalizer);
+    Dart_ExitScope();
+  }
+  {
+    TransitionNativeToVM transition(thread);
+    GCTestHelper::CollectNewSpace();
+    // The finalizer runs on a helper thread after the scavenge.
+    ApiState* state = thread->isolate_group()->api_state();
+    state->WaitForFinalizerTask();
+    EXPECT_EQ(0, state->CountPendingFinalizers());
+    EXPECT_EQ(42, peer);
+  }
+}
+
+TEST_CASE(DartAPI_FinalizableHandleNestedGC) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_finalizers, true);
+  int peer = 0;
+  {
+    Dart_EnterScope();
+    Dart_Handle obj = NewString("new string");
+    EXPECT_VALID(obj);
+    Dart_NewFinalizableHandle(obj, &peer, 0, FinalizableHandlePeerFinalizer);
+    Dart_ExitScope();
+  }
+  {
+    TransitionNativeToVM transition(thread);
+    ApiState* state = thread->isolate_group()->api_state();
+    {
+      SafepointOperationScope safepoint_operation(thread);
+      GCTestHelper::CollectNewSpace();
+      // The scavenge is nested in another safepoint operation, so its
+      // finalizer waits for that operation to end.
+      EXPECT_EQ(1, state->CountPendingFinalizers());
+      EXPECT_EQ(0, peer);
+    }
+    state->WaitForFinalizerTask();
+    EXPECT_EQ(0, state->CountPendingFinalizers());
+    EXPECT_EQ(42, peer);
+  }
+}
+
 TEST_CASE(DartAPI_WeakPersistentHandleNoCallback) {
   Dart_WeakPersistentHandle weak_ref = NULL;
   int peer = 0;
@@ -7141,6 +7226,54 @@ TEST_CASE(DartAPI_SetNativeResolver) {
                "cannot be found");
 }
 
+static intptr_t FfiNativeSum(intptr_t a, intptr_t b) {
+  return a + b;
+}
+
+static void* FfiNativeResolver(const char* name, uintptr_t num_of_arguments) {
+  if ((strcmp(name, "Sum") == 0) && (num_of_arguments == 2)) {
+    return reinterpret_cast<void*>(&FfiNativeSum);
+  }
+  return NULL;
+}
+
+TEST_CASE(DartAPI_SetFfiNativeResolver) {
+  const char* kScriptChars =
+      "import 'dart:ffi';\n"
+      "@FfiNative<IntPtr Function(IntPtr, IntPtr)>('Sum')\n"
+      "external int sum(int a, int b);\n"
+      "@FfiNative<IntPtr Function(IntPtr, IntPtr)>('Sum', isLeaf: true)\n"
+      "external int leafSum(int a, int b);\n"
+      "@FfiNative<IntPtr Function()>('Missing')\n"
+      "external int missing();\n"
+      "testSum() => sum(40, 2);\n"
+      "testLeafSum() => leafSum(-3, 4);\n"
+      "testMissing() => missing();\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+
+  Dart_Handle result = Dart_SetFfiNativeResolver(Dart_True(), NULL);
+  EXPECT_ERROR(result,
+               "Dart_SetFfiNativeResolver expects argument 'library' to be of "
+               "type Library.");
+
+  EXPECT_VALID(Dart_SetFfiNativeResolver(lib, &FfiNativeResolver));
+
+  int64_t value = 0;
+  result = Dart_Invoke(lib, NewString("testSum"), 0, NULL);
+  EXPECT_VALID(result);
+  EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+  EXPECT_EQ(42, value);
+
+  result = Dart_Invoke(lib, NewString("testLeafSum"), 0, NULL);
+  EXPECT_VALID(result);
+  EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+  EXPECT_EQ(1, value);
+
+  EXPECT_ERROR(Dart_Invoke(lib, NewString("testMissing"), 0, NULL),
+               "Couldn't resolve FFI native 'Missing'");
+}
+
 // Test that an imported name does not clash with the same name defined
 // in the importing library.
 TEST_CASE(DartAPI_ImportLibrary2) {
@@ -8430,6 +8563,34 @@ TEST_CASE(DartAPI_CopyNewSpacePeers) {
   }
 }
 
+// Allocates objects in new space and assigns them peers.  Scavenges
+// forward the peer table in place, so the lookups after each scavenge
+// must rehash it first.
+TEST_CASE(DartAPI_NewSpacePeersRehashedAfterScavenge) {
+  const int kPeerCount = 100;
+  Isolate* isolate = Isolate::Current();
+  Dart_Handle s[kPeerCount];
+  int p[kPeerCount];
+  for (int i = 0; i < kPeerCount; ++i) {
+    s[i] = NewString("a string");
+    EXPECT_VALID(s[i]);
+    EXPECT_VALID(Dart_SetPeer(s[i], &p[i]));
+  }
+  EXPECT_EQ(kPeerCount, isolate->heap()->PeerCount());
+  for (int gc = 0; gc < 3; ++gc) {
+    {
+      TransitionNativeToVM transition(thread);
+      GCTestHelper::CollectNewSpace();
+      EXPECT_EQ(kPeerCount, isolate->heap()->PeerCount());
+    }
+    for (int i = 0; i < kPeerCount; ++i) {
+      void* o = &o;
+      EXPECT_VALID(Dart_GetPeer(s[i], &o));
+      EXPECT(o == reinterpret_cast<void*>(&p[i]));
+    }
+  }
+}
+
 // Allocates an object in new space and assigns it a peer.  Promotes
 // the peer to old space.  Removes the peer and check that the count
 // of peer objects is decremented by one.
@@ -9016,6 +9177,90 @@ TEST_CASE(DartAPI_InvokeVMServiceMethod) {
   EXPECT(result == Dart_True());
 }
 
+static void CollectHeapSnapshotChunk(void* callback_data,
+                                     const uint8_t* buffer,
+                                     intptr_t size) {
+  MallocGrowableArray<uint8_t>* snapshot =
+      reinterpret_cast<MallocGrowableArray<uint8_t>*>(callback_data);
+  for (intptr_t i = 0; i < size; i++) {
+    snapshot->Add(buffer[i]);
+  }
+}
+
+TEST_CASE(DartAPI_WriteHeapSnapshot) {
+  MallocGrowableArray<uint8_t> snapshot;
+  char* error = NULL;
+  EXPECT(Dart_WriteHeapSnapshot(CollectHeapSnapshotChunk, &snapshot, &error));
+  EXPECT(error == NULL);
+  EXPECT_GT(snapshot.length(), 8);
+  EXPECT_EQ(0, memcmp(snapshot.data(), "dartheap", 8));
+
+  EXPECT(!Dart_WriteHeapSnapshot(NULL, NULL, &error));
+  EXPECT_NOTNULL(error);
+  free(error);
+}
+
+struct TopRetainersResult {
+  intptr_t count;
+  intptr_t last_retained;
+  bool sorted;
+  intptr_t holder_instances;
+  intptr_t holder_retained;
+};
+
+static void CollectTopRetainer(void* data,
+                               const char* library_uri,
+                               const char* class_name,
+                               intptr_t instance_count,
+                               intptr_t retained_size) {
+  TopRetainersResult* result = reinterpret_cast<TopRetainersResult*>(data);
+  if (result->count > 0 && retained_size > result->last_retained) {
+    result->sorted = false;
+  }
+  result->count++;
+  result->last_retained = retained_size;
+  if (strcmp(class_name, "Holder") == 0) {
+    result->holder_instances = instance_count;
+    result->holder_retained = retained_size;
+  }
+}
+
+TEST_CASE(DartAPI_GetTopRetainersByClass) {
+  const char* kScriptChars =
+      "class Holder {\n"
+      "  Holder(this.next) : payload = List.filled(100000, null);\n"
+      "  final Holder next;\n"
+      "  final List payload;\n"
+      "}\n"
+      "var chain;\n"
+      "main() {\n"
+      "  chain = Holder(Holder(Holder(null)));\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+
+  TopRetainersResult result = {0, 0, true, 0, 0};
+  char* error = NULL;
+  EXPECT(Dart_GetTopRetainersByClass(1000, CollectTopRetainer, &result,
+                                     &error));
+  EXPECT(error == NULL);
+  EXPECT(result.sorted);
+  EXPECT_LE(result.count, 1000);
+  // The nested instances are dominated by the outermost one, so their
+  // payloads are only counted once.
+  EXPECT_EQ(3, result.holder_instances);
+  EXPECT_GE(result.holder_retained, 3 * 100000 * kWordSize);
+  EXPECT_LT(result.holder_retained, 4 * 100000 * kWordSize);
+
+  result = {0, 0, true, 0, 0};
+  EXPECT(Dart_GetTopRetainersByClass(2, CollectTopRetainer, &result, &error));
+  EXPECT_EQ(2, result.count);
+
+  EXPECT(!Dart_GetTopRetainersByClass(10, NULL, NULL, &error));
+  EXPECT_NOTNULL(error);
+  free(error);
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
@@ -6,6 +6,7 @@
 
 #include "platform/assert.h"
 #include "platform/utils.h"
+#include "vm/dart.h"
 #include "vm/heap/heap.h"
 #include "vm/isolate.h"
 #include "vm/lockers.h"
@@ -14,6 +15,111 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            concurrent_finalizers,
+            false,
+            "Run native finalizers on a helper thread after the GC pause "
+            "instead of during the GC.");
+
 RelaxedAtomic<intptr_t> ApiNativeScope::current_memory_usage_ = 0;
 
+// Drains the finalizer queue of an isolate group. Finalizers may not call into
+// the VM, so the task does not enter the isolate group.
+class FinalizerTask : public ThreadPool::Task {
+ public:
+  FinalizerTask(IsolateGroup* isolate_group, ApiState* state)
+      : isolate_group_(isolate_group), state_(state) {}
+
+  virtual void Run() {
+    state_->RunPendingFinalizers(isolate_group_);
+
+    MonitorLocker ml(&state_->finalizers_monitor_);
+    // Handles queued while the last batch ran would otherwise wait for the
+    // next GC.
+    while (!state_->pending_finalizers_.is_empty()) {
+      ml.Exit();
+      state_->RunPendingFinalizers(isolate_group_);
+      ml.Enter();
+    }
+    state_->finalizer_task_running_ = false;
+    ml.NotifyAll();
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  ApiState* state_;
+
+  DISALLOW_COPY_AND_ASSIGN(FinalizerTask);
+};
+
+void ApiState::EnqueueFinalizer(FinalizablePersistentHandle* handle) {
+  ASSERT(handle->finalization_pending());
+  MonitorLocker ml(&finalizers_monitor_);
+  pending_finalizers_.Add(handle);
+}
+
+void ApiState::ScheduleFinalizers(IsolateGroup* isolate_group) {
+  if (FLAG_concurrent_finalizers) {
+    {
+      MonitorLocker ml(&finalizers_monitor_);
+      if (pending_finalizers_.is_empty() || finalizer_task_running_) {
+        // A running task picks up the new handles before it finishes.
+        return;
+      }
+      finalizer_task_running_ = true;
+    }
+    if (Dart::thread_pool()->Run<FinalizerTask>(isolate_group, this)) {
+      return;
+    }
+    // The thread pool is shutting down.
+    MonitorLocker ml(&finalizers_monitor_);
+    finalizer_task_running_ = false;
+    ml.NotifyAll();
+  }
+  RunPendingFinalizers(isolate_group);
+}
+
+void ApiState::RunPendingFinalizers(IsolateGroup* isolate_group) {
+  FinalizablePersistentHandle* batch[kFinalizerBatchSize];
+  for (;;) {
+    intptr_t length = 0;
+    {
+      MonitorLocker ml(&finalizers_monitor_);
+      while (length < kFinalizerBatchSize &&
+             !pending_finalizers_.is_empty()) {
+        batch[length++] = pending_finalizers_.RemoveLast();
+      }
+    }
+    if (length == 0) {
+      return;
+    }
+    for (intptr_t i = 0; i < length; i++) {
+      batch[i]->InvokeFinalizer(isolate_group);
+    }
+    MutexLocker ml(&mutex_);
+    for (intptr_t i = 0; i < length; i++) {
+      weak_persistent_handles_.FreeHandle(batch[i]);
+    }
+  }
+}
+
+bool ApiState::CancelFinalizer(FinalizablePersistentHandle* handle) {
+  MonitorLocker ml(&finalizers_monitor_);
+  for (intptr_t i = 0; i < pending_finalizers_.length(); i++) {
+    if (pending_finalizers_[i] == handle) {
+      pending_finalizers_[i] = pending_finalizers_.Last();
+      pending_finalizers_.RemoveLast();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ApiState::WaitForFinalizerTask() {
+  MonitorLocker ml(&finalizers_monitor_);
+  while (finalizer_task_running_) {
+    ml.Wait();
+  }
+}
+
 }  // namespace dart
@@ -25,6 +25,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, concurrent_finalizers);
+
 // Implementation of Zone support for very fast allocation of small chunks
 // of memory. The chunks cannot be deallocated individually, but instead
 // zones support deallocating all chunks in one fast operation when the
@@ -267,11 +269,18 @@ class FinalizablePersistentHandle {
     }
   }
 
-  // Called when the referent becomes unreachable.
-  void UpdateUnreachable(IsolateGroup* isolate_group) {
-    EnsureFreedExternal(isolate_group);
-    Finalize(isolate_group, this);
-  }
+  // Called when the referent becomes unreachable. The finalizer runs right
+  // away, or with --concurrent_finalizers the referent is cleared and the
+  // finalizer is queued to run once the GC pause is over (see
+  // ApiState::ScheduleFinalizers).
+  inline void UpdateUnreachable(IsolateGroup* isolate_group);
+
+  // True from the GC that found the referent unreachable until the finalizer
+  // has run and the handle is freed.
+  bool finalization_pending() const { return finalization_pending_; }
+
+  // Runs the finalizer callback. The caller frees the handle afterwards.
+  void InvokeFinalizer(IsolateGroup* isolate_group);
 
   // Called when the referent has moved, potentially between generations.
   void UpdateRelocated(IsolateGroup* isolate_group) {
@@ -326,9 +335,6 @@ class FinalizablePersistentHandle {
         callback_(HandleFinalizer()) {}
   ~FinalizablePersistentHandle() {}
 
-  static void Finalize(IsolateGroup* isolate_group,
-                       FinalizablePersistentHandle* handle);
-
   // Overload the raw_ field as a next pointer when adding freed
   // handles to the free list.
   FinalizablePersistentHandle* Next() {
@@ -352,6 +358,7 @@ class FinalizablePersistentHandle {
     callback_ = HandleFinalizer();
     auto_delete_ = false;
     callback_signature_ = CallbackSignature::kWeakPersistentHandleFinalizer;
+    finalization_pending_ = false;
   }
 
   void set_raw(ObjectPtr raw) { raw_ = raw; }
@@ -399,6 +406,7 @@ class FinalizablePersistentHandle {
   HandleFinalizer callback_;
   bool auto_delete_;
   CallbackSignature callback_signature_;
+  bool finalization_pending_;
 
   DISALLOW_ALLOCATION();  // Allocated through AllocateHandle methods.
   DISALLOW_COPY_AND_ASSIGN(FinalizablePersistentHandle);
@@ -759,7 +767,8 @@ class ApiState {
         null_(NULL),
         true_(NULL),
         false_(NULL),
-        acquired_error_(NULL) {}
+        acquired_error_(NULL),
+        finalizer_task_running_(false) {}
   ~ApiState() {
     if (null_ != NULL) {
       persistent_handles_.FreeHandle(null_);
@@ -876,7 +885,34 @@ class ApiState {
 
   WeakTable* acquired_table() { return &acquired_table_; }
 
+  // Queues the finalizer of a handle whose referent the GC found unreachable.
+  // Only called while the GC holds the safepoint.
+  void EnqueueFinalizer(FinalizablePersistentHandle* handle);
+
+  // Runs the queued finalizers once the outermost safepoint operation is
+  // over: on a helper task, or on the calling thread if the handles were
+  // queued before --concurrent_finalizers was turned off.
+  void ScheduleFinalizers(IsolateGroup* isolate_group);
+
+  // Runs and frees the queued finalizers on the calling thread.
+  void RunPendingFinalizers(IsolateGroup* isolate_group);
+
+  // Waits until any helper task started by ScheduleFinalizers is done.
+  void WaitForFinalizerTask();
+
+  // Removes a handle deleted by the embedder from the finalizer queue.
+  // Returns false if its finalizer is already running and will free it.
+  bool CancelFinalizer(FinalizablePersistentHandle* handle);
+
+  intptr_t CountPendingFinalizers() {
+    MonitorLocker ml(&finalizers_monitor_);
+    return pending_finalizers_.length();
+  }
+
  private:
+  // Finalizers are run, and their handles freed, in batches of this size.
+  static const intptr_t kFinalizerBatchSize = 64;
+
   Mutex mutex_;
 
   PersistentHandles persistent_handles_;
@@ -889,9 +925,32 @@ class ApiState {
   PersistentHandle* false_;
   PersistentHandle* acquired_error_;
 
+  // Protects pending_finalizers_ and finalizer_task_running_.
+  Monitor finalizers_monitor_;
+  MallocGrowableArray<FinalizablePersistentHandle*> pending_finalizers_;
+  bool finalizer_task_running_;
+
+  friend class FinalizerTask;
+
   DISALLOW_COPY_AND_ASSIGN(ApiState);
 };
 
+inline void FinalizablePersistentHandle::UpdateUnreachable(
+    IsolateGroup* isolate_group) {
+  ASSERT(!finalization_pending_);
+  EnsureFreedExternal(isolate_group);
+  finalization_pending_ = true;
+  if (!FLAG_concurrent_finalizers) {
+    InvokeFinalizer(isolate_group);
+    isolate_group->api_state()->FreeWeakPersistentHandle(this);
+    return;
+  }
+  // The referent is about to be freed. Keep the handle pointing to null until
+  // the finalizer has run, so later GCs do not visit a dead object.
+  raw_ = Object::null();
+  isolate_group->api_state()->EnqueueFinalizer(this);
+}
+
 inline FinalizablePersistentHandle* FinalizablePersistentHandle::New(
     Isolate* isolate,
     const Object& object,
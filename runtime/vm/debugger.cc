@@ -1936,32 +1936,87 @@ bool Debugger::SetResumeAction(ResumeAction action,
   }
 }
 
-// Deoptimize all functions in the isolate.
-// TODO(hausner): Actually we only need to deoptimize those functions
-// that inline the function that contains the newly created breakpoint.
-// We currently don't have this info so we deoptimize all functions.
-void Debugger::DeoptimizeWorld() {
-#if defined(DART_PRECOMPILED_RUNTIME)
-  UNREACHABLE();
-#else
-  BackgroundCompiler::Stop(isolate_);
-  if (FLAG_trace_deoptimization) {
-    THR_Print("Deopt for debugger\n");
+#if !defined(DART_PRECOMPILED_RUNTIME)
+// Returns whether [code] was compiled from one of [functions] or has one of
+// them inlined. All code is affected if [functions] is null.
+static bool IsAffectedCode(const Code& code,
+                           const GrowableObjectArray* functions) {
+  if (functions == nullptr) {
+    return true;
   }
-  isolate_->set_has_attempted_stepping(true);
+  Zone* zone = Thread::Current()->zone();
+  const auto& owner = Object::Handle(zone, code.owner());
+  const auto& inlined =
+      Array::Handle(zone, code.is_optimized() ? code.inlined_id_to_function()
+                                              : Array::null());
+  for (intptr_t i = 0; i < functions->Length(); i++) {
+    const ObjectPtr function = functions->At(i);
+    if (owner.raw() == function) {
+      return true;
+    }
+    for (intptr_t j = 0; !inlined.IsNull() && (j < inlined.Length()); j++) {
+      if (inlined.At(j) == function) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
 
-  DeoptimizeFunctionsOnStack();
+// Switches [function] to its unoptimized code if its optimized code is
+// affected by [functions], and makes all calls in the unoptimized code go
+// through the stubs which check for breakpoints and stepping again.
+static void SwitchToUnoptimizedCode(const Function& function,
+                                    const GrowableObjectArray* functions,
+                                    CallSiteResetter* resetter) {
+  Zone* zone = Thread::Current()->zone();
+  auto& code = Code::Handle(zone);
+  if (function.HasOptimizedCode()) {
+    code = function.CurrentCode();
+    if (!IsAffectedCode(code, functions)) {
+      return;
+    }
+    function.SwitchToUnoptimizedCode();
+  }
+  code = function.unoptimized_code();
+  if (!code.IsNull() && IsAffectedCode(code, functions)) {
+    resetter->ResetSwitchableCalls(code);
+  }
+}
+
+static void DeoptimizeAffectedFunctions(Isolate* isolate,
+                                        const GrowableObjectArray* functions) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+
+  // Cached OSR code is not reachable from any function, so it is dropped
+  // rather than searched for affected inlined functions.
+  isolate->isolate_object_store()->set_osr_code_cache(Object::null_array());
+
+  // Deoptimize the affected frames on the stack.
+  DartFrameIterator iterator(thread,
+                             StackFrameIterator::kNoCrossThreadIteration);
+  auto& optimized_code = Code::Handle(zone);
+  for (StackFrame* frame = iterator.NextFrame(); frame != nullptr;
+       frame = iterator.NextFrame()) {
+    if (!frame->is_interpreted()) {
+      optimized_code = frame->LookupDartCode();
+      if (optimized_code.is_optimized() &&
+          !optimized_code.is_force_optimized() &&
+          IsAffectedCode(optimized_code, functions)) {
+        DeoptimizeAt(optimized_code, frame);
+      }
+    }
+  }
 
   // Iterate over all classes, deoptimize functions.
   // TODO(hausner): Could possibly be combined with RemoveOptimizedCode()
-  const ClassTable& class_table = *isolate_->class_table();
-  Zone* zone = Thread::Current()->zone();
+  const ClassTable& class_table = *isolate->class_table();
   CallSiteResetter resetter(zone);
   Class& cls = Class::Handle(zone);
-  Array& functions = Array::Handle(zone);
+  Array& class_functions = Array::Handle(zone);
   GrowableObjectArray& closures = GrowableObjectArray::Handle(zone);
   Function& function = Function::Handle(zone);
-  Code& code = Code::Handle(zone);
 
   const intptr_t num_classes = class_table.NumCids();
   const intptr_t num_tlc_classes = class_table.NumTopLevelCids();
@@ -1972,11 +2027,11 @@ void Debugger::DeoptimizeWorld() {
       cls = class_table.At(cid);
 
       // Disable optimized functions.
-      functions = cls.functions();
-      if (!functions.IsNull()) {
-        intptr_t num_functions = functions.Length();
+      class_functions = cls.functions();
+      if (!class_functions.IsNull()) {
+        intptr_t num_functions = class_functions.Length();
         for (intptr_t pos = 0; pos < num_functions; pos++) {
-          function ^= functions.At(pos);
+          function ^= class_functions.At(pos);
           ASSERT(!function.IsNull());
           // Force-optimized functions don't have unoptimized code and can't
           // deoptimize. Their optimized codes are still valid.
@@ -1984,23 +2039,11 @@ void Debugger::DeoptimizeWorld() {
             ASSERT(!function.HasImplicitClosureFunction());
             continue;
           }
-          if (function.HasOptimizedCode()) {
-            function.SwitchToUnoptimizedCode();
-          }
-          code = function.unoptimized_code();
-          if (!code.IsNull()) {
-            resetter.ResetSwitchableCalls(code);
-          }
+          SwitchToUnoptimizedCode(function, functions, &resetter);
           // Also disable any optimized implicit closure functions.
           if (function.HasImplicitClosureFunction()) {
             function = function.ImplicitClosureFunction();
-            if (function.HasOptimizedCode()) {
-              function.SwitchToUnoptimizedCode();
-            }
-            code = function.unoptimized_code();
-            if (!code.IsNull()) {
-              resetter.ResetSwitchableCalls(code);
-            }
+            SwitchToUnoptimizedCode(function, functions, &resetter);
           }
         }
       }
@@ -2008,19 +2051,47 @@ void Debugger::DeoptimizeWorld() {
   }
 
   // Disable optimized closure functions.
-  closures = isolate_->object_store()->closure_functions();
+  closures = isolate->object_store()->closure_functions();
   const intptr_t num_closures = closures.Length();
   for (intptr_t pos = 0; pos < num_closures; pos++) {
     function ^= closures.At(pos);
     ASSERT(!function.IsNull());
-    if (function.HasOptimizedCode()) {
-      function.SwitchToUnoptimizedCode();
-    }
-    code = function.unoptimized_code();
-    if (!code.IsNull()) {
-      resetter.ResetSwitchableCalls(code);
-    }
+    SwitchToUnoptimizedCode(function, functions, &resetter);
   }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+// Deoptimize all functions in the isolate.
+void Debugger::DeoptimizeWorld() {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  UNREACHABLE();
+#else
+  BackgroundCompiler::Stop(isolate_);
+  if (FLAG_trace_deoptimization) {
+    THR_Print("Deopt for debugger\n");
+  }
+  isolate_->set_has_attempted_stepping(true);
+  DeoptimizeAffectedFunctions(isolate_, /*functions=*/nullptr);
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
+// Deoptimize only the code which a breakpoint in one of [functions] can be
+// hit in: their own optimized code and the optimized code they are inlined
+// into. The functions are not optimized or inlined again while they have
+// breakpoints (see Debugger::IsDebugging and Function::CanBeInlined).
+void Debugger::DeoptimizeFunctionsWithBreakpoints(
+    const GrowableObjectArray& functions) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  UNREACHABLE();
+#else
+  BackgroundCompiler::Stop(isolate_);
+  if (FLAG_trace_deoptimization) {
+    THR_Print("Deopt for breakpoint\n");
+  }
+  // Unoptimized calls must not be switched to monomorphic calls, which would
+  // overwrite the patched breakpoint calls.
+  isolate_->set_has_attempted_stepping(true);
+  DeoptimizeAffectedFunctions(isolate_, &functions);
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 }
 
@@ -3259,6 +3330,21 @@ void Debugger::MakeCodeBreakpointAt(const Function& func,
   }
 }
 
+// The unoptimized code of a function that has not run for a while may have
+// been collected (see --collect_code), while the function is still inlined
+// into optimized code. Compile it again so that it is found like any other
+// compiled function and the code it is inlined into gets deoptimized.
+static void RestoreCollectedCode(const Function& function) {
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  if (function.WasCompiled() && !function.HasCode() &&
+      !function.HasBytecode()) {
+    // It compiled before, so an error here is not expected. If there is one,
+    // the function is left uncompiled and its breakpoint unresolved.
+    Compiler::EnsureUnoptimizedCode(Thread::Current(), function);
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+}
+
 void Debugger::FindCompiledFunctions(
     const Script& script,
     TokenPosition start_pos,
@@ -3280,6 +3366,7 @@ void Debugger::FindCompiledFunctions(
         (function.end_token_pos() == end_pos) &&
         (function.script() == script.raw())) {
       if (function.is_debuggable()) {
+        RestoreCollectedCode(function);
         if (FLAG_enable_interpreter && function.HasBytecode()) {
           bytecode_function_list->Add(function);
         }
@@ -3290,6 +3377,7 @@ void Debugger::FindCompiledFunctions(
       if (function.HasImplicitClosureFunction()) {
         function = function.ImplicitClosureFunction();
         if (function.is_debuggable()) {
+          RestoreCollectedCode(function);
           if (FLAG_enable_interpreter && function.HasBytecode()) {
             bytecode_function_list->Add(function);
           }
@@ -3326,23 +3414,23 @@ void Debugger::FindCompiledFunctions(
           function ^= functions.At(pos);
           ASSERT(!function.IsNull());
           bool function_added = false;
-          if (function.is_debuggable() &&
-              (function.HasCode() ||
-               (FLAG_enable_interpreter && function.HasBytecode())) &&
-              function.token_pos() == start_pos &&
+          if (function.is_debuggable() && function.token_pos() == start_pos &&
               function.end_token_pos() == end_pos &&
               function.script() == script.raw()) {
+            RestoreCollectedCode(function);
             if (FLAG_enable_interpreter && function.HasBytecode()) {
               bytecode_function_list->Add(function);
+              function_added = true;
             }
             if (function.HasCode()) {
               code_function_list->Add(function);
+              function_added = true;
             }
-            function_added = true;
           }
           if (function_added && function.HasImplicitClosureFunction()) {
             function = function.ImplicitClosureFunction();
             if (function.is_debuggable()) {
+              RestoreCollectedCode(function);
               if (FLAG_enable_interpreter && function.HasBytecode()) {
                 bytecode_function_list->Add(function);
               }
@@ -3622,7 +3710,7 @@ BreakpointLocation* Debugger::SetBreakpoint(const Script& script,
             FindExactTokenPosition(script, token_pos, requested_column);
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
       }
-      DeoptimizeWorld();
+      DeoptimizeFunctionsWithBreakpoints(code_functions);
       // Since source positions may differ in code and bytecode, process
       // breakpoints in bytecode and code separately.
       BreakpointLocation* loc = NULL;
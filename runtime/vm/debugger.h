@@ -673,6 +673,7 @@ class Debugger {
                                      intptr_t requested_column,
                                      TokenPosition exact_token_pos);
   void DeoptimizeWorld();
+  void DeoptimizeFunctionsWithBreakpoints(const GrowableObjectArray& functions);
   void NotifySingleStepping(bool value) const;
   BreakpointLocation* SetCodeBreakpoints(bool in_bytecode,
                                          BreakpointLocation* loc,
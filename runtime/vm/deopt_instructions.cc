@@ -13,6 +13,7 @@
 #include "vm/compiler/backend/locations.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/parser.h"
+#include "vm/runtime_counters.h"
 #include "vm/stack_frame.h"
 #include "vm/thread.h"
 #include "vm/timeline.h"
@@ -115,6 +116,9 @@ DeoptContext::DeoptContext(const StackFrame* frame,
     // kDestIsAllocated is used by the debugger to generate a stack trace
     // and does not signal a real deopt.
     deopt_start_micros_ = OS::GetCurrentMonotonicMicros();
+    if (UNLIKELY(FLAG_runtime_counters)) {
+      RuntimeCounters::RecordDeoptimization(function, deopt_reason());
+    }
   }
 
   if (FLAG_trace_deoptimization || FLAG_trace_deoptimization_verbose) {
@@ -6,6 +6,7 @@
 
 #include "third_party/double-conversion/src/double-conversion.h"
 
+#include "platform/unaligned.h"
 #include "vm/exceptions.h"
 #include "vm/globals.h"
 #include "vm/object.h"
@@ -16,7 +17,34 @@ char const DoubleToStringConstants::kExponentChar = 'e';
 const char* const DoubleToStringConstants::kInfinitySymbol = "Infinity";
 const char* const DoubleToStringConstants::kNaNSymbol = "NaN";
 
-void DoubleToCString(double d, char* buffer, int buffer_size) {
+// Integral doubles up to 2^53 are exactly their integer value, whose digits are
+// also the shortest ones identifying the double.
+static const double kMaxExactIntegralDouble = 9007199254740992.0;
+
+// Writes |d| like ToShortest would, without searching for the digits.
+static intptr_t IntegralDoubleToCString(double d, char* buffer) {
+  intptr_t length = 0;
+  if (signbit(d)) {
+    buffer[length++] = '-';
+    d = -d;
+  }
+  uint64_t value = static_cast<uint64_t>(d);
+  char digits[20];
+  intptr_t digit_count = 0;
+  do {
+    digits[digit_count++] = '0' + (value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (digit_count > 0) {
+    buffer[length++] = digits[--digit_count];
+  }
+  buffer[length++] = '.';
+  buffer[length++] = '0';
+  buffer[length] = '\0';
+  return length;
+}
+
+intptr_t DoubleToCString(double d, char* buffer, int buffer_size) {
   static const int kDecimalLow = -6;
   static const int kDecimalHigh = 21;
 
@@ -31,6 +59,11 @@ void DoubleToCString(double d, char* buffer, int buffer_size) {
   // sign, at most three exponent digits, plus the \0.
   ASSERT(buffer_size >= 1 + 17 + 1 + 1 + 1 + 3 + 1);
 
+  if ((d > -kMaxExactIntegralDouble) && (d < kMaxExactIntegralDouble) &&
+      (d == static_cast<double>(static_cast<int64_t>(d)))) {
+    return IntegralDoubleToCString(d, buffer);
+  }
+
   static const int kConversionFlags =
       double_conversion::DoubleToStringConverter::EMIT_POSITIVE_EXPONENT_SIGN |
       double_conversion::DoubleToStringConverter::EMIT_TRAILING_DECIMAL_POINT |
@@ -46,8 +79,18 @@ void DoubleToCString(double d, char* buffer, int buffer_size) {
   double_conversion::StringBuilder builder(buffer, buffer_size);
   bool status = converter.ToShortest(d, &builder);
   ASSERT(status);
+  const intptr_t length = builder.position();
   char* result = builder.Finalize();
   ASSERT(result == buffer);
+  return length;
+}
+
+StringPtr DoubleToString(double d, Heap::Space space) {
+  const int kBufferSize = 128;
+  char buffer[kBufferSize];
+  const intptr_t length = DoubleToCString(d, buffer, kBufferSize);
+  return OneByteString::New(reinterpret_cast<const uint8_t*>(buffer), length,
+                            space);
 }
 
 StringPtr DoubleToStringAsFixed(double d, int fraction_digits) {
@@ -159,10 +202,129 @@ StringPtr DoubleToStringAsPrecision(double d, int precision) {
   return String::New(builder.Finalize());
 }
 
+// Eight ASCII digits are converted at once by loading them into a word, least
+// significant byte first, which all hosts of the VM are.
+static bool IsEightDigits(uint64_t chars) {
+  return ((chars & 0xF0F0F0F0F0F0F0F0) |
+          (((chars + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+static uint64_t EightDigitsValue(uint64_t chars) {
+  chars -= 0x3030303030303030;
+  // Combine pairs of digits into bytes 0, 2, 4 and 6, then the pairs.
+  chars = (chars * 10) + (chars >> 8);
+  return (((chars & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+          (((chars >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >>
+         32;
+}
+
+intptr_t ParseDecimalDigits(const char* str,
+                            intptr_t length,
+                            intptr_t max_digits,
+                            uint64_t* value) {
+  uint64_t result = *value;
+  intptr_t count = 0;
+  while ((count + 8 <= length) && (count + 8 <= max_digits)) {
+    const uint64_t chars =
+        LoadUnaligned(reinterpret_cast<const uint64_t*>(str + count));
+    if (!IsEightDigits(chars)) {
+      break;
+    }
+    result = (result * 100000000) + EightDigitsValue(chars);
+    count += 8;
+  }
+  while ((count < length) && (count < max_digits) && (str[count] >= '0') &&
+         (str[count] <= '9')) {
+    result = (result * 10) + (str[count] - '0');
+    count++;
+  }
+  *value = result;
+  return count;
+}
+
+// Parses [+-]digits[.digits][(e|E)[+-]digits] numerals with at most 19
+// significant digits whose value n * 10^e has n < 2^53 and |e| <= 22. Both n
+// and 10^e are then exact doubles, and a single multiplication or division
+// rounds correctly (Clinger's fast path). Returns false for anything else,
+// which is left to the complete parser.
+static bool ParseSimpleDouble(const char* str,
+                              intptr_t length,
+                              double* result) {
+  static const intptr_t kMaxDigits = 19;
+  static const double kExactPowersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+  };
+  static const intptr_t kMaxExactPowerOfTen = 22;
+  static const uint64_t kMaxExactMantissa = static_cast<uint64_t>(1) << 53;
+
+  intptr_t position = 0;
+  bool is_negative = false;
+  if ((str[0] == '-') || (str[0] == '+')) {
+    is_negative = str[0] == '-';
+    position++;
+  }
+  uint64_t mantissa = 0;
+  const intptr_t integer_digits = ParseDecimalDigits(
+      str + position, length - position, kMaxDigits, &mantissa);
+  if (integer_digits == 0) {
+    return false;
+  }
+  position += integer_digits;
+  intptr_t exponent = 0;
+  if ((position < length) && (str[position] == '.')) {
+    position++;
+    const intptr_t fraction_digits =
+        ParseDecimalDigits(str + position, length - position,
+                           kMaxDigits - integer_digits, &mantissa);
+    if (fraction_digits == 0) {
+      return false;
+    }
+    position += fraction_digits;
+    exponent = -fraction_digits;
+  }
+  if ((position < length) && ((str[position] | 0x20) == 'e')) {
+    position++;
+    bool is_negative_exponent = false;
+    if ((position < length) &&
+        ((str[position] == '-') || (str[position] == '+'))) {
+      is_negative_exponent = str[position] == '-';
+      position++;
+    }
+    uint64_t explicit_exponent = 0;
+    const intptr_t exponent_digits =
+        ParseDecimalDigits(str + position, length - position, 3,
+                           &explicit_exponent);
+    if (exponent_digits == 0) {
+      return false;
+    }
+    position += exponent_digits;
+    exponent += is_negative_exponent
+                    ? -static_cast<intptr_t>(explicit_exponent)
+                    : static_cast<intptr_t>(explicit_exponent);
+  }
+  if ((position != length) || (mantissa > kMaxExactMantissa) ||
+      (exponent < -kMaxExactPowerOfTen) || (exponent > kMaxExactPowerOfTen)) {
+    return false;
+  }
+  double value = static_cast<double>(mantissa);
+  if (exponent < 0) {
+    value /= kExactPowersOfTen[-exponent];
+  } else {
+    value *= kExactPowersOfTen[exponent];
+  }
+  *result = is_negative ? -value : value;
+  return true;
+}
+
 bool CStringToDouble(const char* str, intptr_t length, double* result) {
   if (length == 0) {
     return false;
   }
+  if (ParseSimpleDouble(str, length, result)) {
+    return true;
+  }
 
   double_conversion::StringToDoubleConverter converter(
       double_conversion::StringToDoubleConverter::NO_FLAGS, 0.0, 0.0,
@@ -17,13 +17,25 @@ struct DoubleToStringConstants : AllStatic {
   static const char* const kNaNSymbol;
 };
 
-void DoubleToCString(double d, char* buffer, int buffer_size);
+// Writes the shortest representation of |d| which reads back as |d| and
+// returns its length, excluding the terminating \0.
+intptr_t DoubleToCString(double d, char* buffer, int buffer_size);
+// Returns the String of DoubleToCString without a zone allocated C string.
+StringPtr DoubleToString(double d, Heap::Space space);
 StringPtr DoubleToStringAsFixed(double d, int fraction_digits);
 StringPtr DoubleToStringAsExponential(double d, int fraction_digits);
 StringPtr DoubleToStringAsPrecision(double d, int precision);
 
 bool CStringToDouble(const char* str, intptr_t length, double* result);
 
+// Accumulates the leading decimal digits of the |length| characters at |str|
+// into |value|, at most |max_digits| of them, and returns how many there were.
+// |value| may overflow if it ends up with more than 19 digits.
+intptr_t ParseDecimalDigits(const char* str,
+                            intptr_t length,
+                            intptr_t max_digits,
+                            uint64_t* value);
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_DOUBLE_CONVERSION_H_
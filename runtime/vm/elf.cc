@@ -1062,6 +1062,13 @@ class DwarfElfStream : public DwarfWriteStream {
 };
 
 static constexpr intptr_t kInitialDwarfBufferSize = 64 * KB;
+
+// DWARF sections are written into malloc'ed buffers rather than the zone:
+// growing a zone buffer leaves every smaller copy behind in the zone, which
+// for large line number programs doubles the memory they take up.
+static uint8_t* MallocReallocate(uint8_t* ptr, intptr_t len, intptr_t new_len) {
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_len));
+}
 #endif
 
 static uint8_t* ZoneReallocate(uint8_t* ptr, intptr_t len, intptr_t new_len) {
@@ -1103,6 +1110,15 @@ void Elf::AddSectionSymbols() {
   }
 }
 
+uint8_t* Elf::TakeDwarfBuffer(uint8_t* buffer, intptr_t size) {
+  if (size > 0) {
+    // Return the unused tail of the buffer to the allocator.
+    buffer = reinterpret_cast<uint8_t*>(realloc(buffer, size));
+  }
+  dwarf_buffers_.Add(buffer);
+  return buffer;
+}
+
 void Elf::FinalizeDwarfSections() {
   if (dwarf_ == nullptr) return;
 #if defined(DART_PRECOMPILER)
@@ -1156,26 +1172,29 @@ void Elf::FinalizeDwarfSections() {
 
   {
     uint8_t* buffer = nullptr;
-    WriteStream stream(&buffer, ZoneReallocate, kInitialDwarfBufferSize);
+    WriteStream stream(&buffer, MallocReallocate, kInitialDwarfBufferSize);
     DwarfElfStream dwarf_stream(zone_, &stream, symbol_to_address_map);
     dwarf_->WriteAbbreviations(&dwarf_stream);
-    AddDebug(".debug_abbrev", buffer, stream.bytes_written());
+    AddDebug(".debug_abbrev", TakeDwarfBuffer(buffer, stream.bytes_written()),
+             stream.bytes_written());
   }
 
   {
     uint8_t* buffer = nullptr;
-    WriteStream stream(&buffer, ZoneReallocate, kInitialDwarfBufferSize);
+    WriteStream stream(&buffer, MallocReallocate, kInitialDwarfBufferSize);
     DwarfElfStream dwarf_stream(zone_, &stream, symbol_to_address_map);
     dwarf_->WriteDebugInfo(&dwarf_stream);
-    AddDebug(".debug_info", buffer, stream.bytes_written());
+    AddDebug(".debug_info", TakeDwarfBuffer(buffer, stream.bytes_written()),
+             stream.bytes_written());
   }
 
   {
     uint8_t* buffer = nullptr;
-    WriteStream stream(&buffer, ZoneReallocate, kInitialDwarfBufferSize);
+    WriteStream stream(&buffer, MallocReallocate, kInitialDwarfBufferSize);
     DwarfElfStream dwarf_stream(zone_, &stream, symbol_to_address_map);
     dwarf_->WriteLineNumberProgram(&dwarf_stream);
-    AddDebug(".debug_line", buffer, stream.bytes_written());
+    AddDebug(".debug_line", TakeDwarfBuffer(buffer, stream.bytes_written()),
+             stream.bytes_written());
   }
 #endif
 }
@@ -1241,6 +1260,12 @@ void Elf::Finalize() {
   WriteProgramTable(&wrapped);
   WriteSections(&wrapped);
   WriteSectionTable(&wrapped);
+
+  // The contents of the DWARF sections have been written out.
+  for (intptr_t i = 0; i < dwarf_buffers_.length(); i++) {
+    free(dwarf_buffers_[i]);
+  }
+  dwarf_buffers_.Clear();
 }
 
 // Need to include the final \0 terminator in both byte count and byte output.
@@ -87,6 +87,9 @@ class Elf : public ZoneAllocated {
   Section* GenerateBuildId();
 
   void AddSectionSymbols();
+  // Takes ownership of a malloc'ed buffer holding the contents of a DWARF
+  // section until the ELF file has been written.
+  uint8_t* TakeDwarfBuffer(uint8_t* buffer, intptr_t size);
   void FinalizeDwarfSections();
   void FinalizeProgramTable();
   void ComputeFileOffsets();
@@ -120,6 +123,7 @@ class Elf : public ZoneAllocated {
 
   GrowableArray<Section*> sections_;
   GrowableArray<Segment*> segments_;
+  GrowableArray<uint8_t*> dwarf_buffers_;
   intptr_t memory_offset_;
   intptr_t section_table_file_offset_ = -1;
   intptr_t section_table_file_size_ = -1;
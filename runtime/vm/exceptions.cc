@@ -160,8 +160,9 @@ class ExceptionHandlerFinder : public StackResource {
   // Iterate through the stack frames and try to find a frame with an
   // exception handler. Once found, set the pc, sp and fp so that execution
   // can continue in that frame. Sets 'needs_stacktrace' if there is no
-  // catch-all handler or if a stack-trace is specified in the catch.
-  bool Find() {
+  // catch-all handler or if a stack-trace is specified in the catch, unless
+  // the handler's guarded types are known to match 'exception'.
+  bool Find(const Instance& exception) {
     StackFrameIterator frames(ValidationPolicy::kDontValidateFrames,
                               Thread::Current(),
                               StackFrameIterator::kNoCrossThreadIteration);
@@ -215,6 +216,12 @@ class ExceptionHandlerFinder : public StackResource {
           if (needs_stacktrace || is_catch_all) {
             return true;
           }
+          // A typed catch that does not match falls through to a rethrow
+          // which needs the stack trace of the original throw. If one of
+          // the guarded types matches, the rethrow cannot be reached.
+          needs_stacktrace =
+              !frame->ExceptionHandlerCatches(thread_, exception);
+          return true;
         }
       }  // if frame->IsDartFrame
       frame = frames.NextFrame();
@@ -804,7 +811,7 @@ static void ThrowExceptionHelper(Thread* thread,
   // Find the exception handler and determine if the handler needs a
   // stacktrace.
   ExceptionHandlerFinder finder(thread);
-  bool handler_exists = finder.Find();
+  bool handler_exists = finder.Find(exception);
   uword handler_pc = finder.handler_pc;
   uword handler_sp = finder.handler_sp;
   uword handler_fp = finder.handler_fp;
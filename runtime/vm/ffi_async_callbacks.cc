@@ -0,0 +1,427 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/ffi_async_callbacks.h"
+
+#include "platform/atomic.h"
+#include "vm/class_id.h"
+#include "vm/lockers.h"
+#include "vm/message.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+#include "vm/port.h"
+
+namespace dart {
+
+// The trampolines are C++ functions taking as many integer and floating point
+// arguments as the native calling convention passes in registers. Where
+// integer and floating point arguments are assigned registers independently,
+// such a function can be called with any signature whose arguments all fit in
+// registers, and ignores the registers which aren't used by the caller.
+#if defined(HOST_ARCH_X64) && !defined(HOST_OS_WINDOWS)
+#define SUPPORTS_ASYNC_CALLBACKS
+static const intptr_t kNumIntegerRegisters = 6;
+static const intptr_t kNumFpuRegisters = 8;
+static const bool kPositionalRegisters = false;
+#define ASYNC_CALLBACK_PARAMETERS                                              \
+  int64_t r0, int64_t r1, int64_t r2, int64_t r3, int64_t r4, int64_t r5,      \
+      double f0, double f1, double f2, double f3, double f4, double f5,        \
+      double f6, double f7
+#define ASYNC_CALLBACK_REGISTERS                                               \
+  r0, r1, r2, r3, r4, r5, bit_cast<int64_t>(f0), bit_cast<int64_t>(f1),        \
+      bit_cast<int64_t>(f2), bit_cast<int64_t>(f3), bit_cast<int64_t>(f4),     \
+      bit_cast<int64_t>(f5), bit_cast<int64_t>(f6), bit_cast<int64_t>(f7)
+#elif defined(HOST_ARCH_ARM64)
+#define SUPPORTS_ASYNC_CALLBACKS
+static const intptr_t kNumIntegerRegisters = 8;
+static const intptr_t kNumFpuRegisters = 8;
+static const bool kPositionalRegisters = false;
+#define ASYNC_CALLBACK_PARAMETERS                                              \
+  int64_t r0, int64_t r1, int64_t r2, int64_t r3, int64_t r4, int64_t r5,      \
+      int64_t r6, int64_t r7, double f0, double f1, double f2, double f3,      \
+      double f4, double f5, double f6, double f7
+#define ASYNC_CALLBACK_REGISTERS                                               \
+  r0, r1, r2, r3, r4, r5, r6, r7, bit_cast<int64_t>(f0),                       \
+      bit_cast<int64_t>(f1), bit_cast<int64_t>(f2), bit_cast<int64_t>(f3),     \
+      bit_cast<int64_t>(f4), bit_cast<int64_t>(f5), bit_cast<int64_t>(f6),     \
+      bit_cast<int64_t>(f7)
+#elif defined(HOST_ARCH_X64) && defined(HOST_OS_WINDOWS)
+// The Windows calling convention assigns registers by position, so a floating
+// point argument can't be read by a function declared with an integer one.
+#define SUPPORTS_ASYNC_CALLBACKS
+static const intptr_t kNumIntegerRegisters = 4;
+static const intptr_t kNumFpuRegisters = 0;
+static const bool kPositionalRegisters = true;
+#define ASYNC_CALLBACK_PARAMETERS int64_t r0, int64_t r1, int64_t r2, int64_t r3
+#define ASYNC_CALLBACK_REGISTERS r0, r1, r2, r3
+#else
+// 32-bit calling conventions pass 64-bit integers in register pairs or on the
+// stack.
+static const intptr_t kNumIntegerRegisters = 1;
+static const intptr_t kNumFpuRegisters = 0;
+static const bool kPositionalRegisters = true;
+#endif
+
+static const intptr_t kNumArgumentRegisters =
+    kNumIntegerRegisters + kNumFpuRegisters;
+static const intptr_t kMaxCallbacks = 128;
+// Must be a power of two.
+static const intptr_t kQueueCapacity = 256;
+
+// A pending call. |sequence| tells whether the slot is free or filled for a
+// given position in the queue, see Enqueue.
+struct AsyncCallbackCall {
+  AcqRelAtomic<uint64_t> sequence;
+  int64_t values[kNumArgumentRegisters];
+};
+
+struct AsyncCallback {
+  Isolate* isolate;
+  Dart_Port port;
+  intptr_t num_arguments;
+  classid_t cids[kNumArgumentRegisters];
+  // The index of the register of each argument in the trampoline's registers.
+  intptr_t registers[kNumArgumentRegisters];
+
+  AcqRelAtomic<uint64_t> enqueue_position;
+  // Only accessed by the mutator of |isolate|.
+  uint64_t dequeue_position;
+  // Whether a wakeup message has been posted since the consumer last found
+  // the queue empty.
+  AcqRelAtomic<uintptr_t> notified;
+  AsyncCallbackCall calls[kQueueCapacity];
+};
+
+static Mutex* lock_ = nullptr;
+// Written while holding |lock_|.
+static AcqRelAtomic<AsyncCallback*> callbacks_[kMaxCallbacks];
+// The number of threads in the trampoline of each callback.
+static AcqRelAtomic<intptr_t> active_calls_[kMaxCallbacks];
+
+static void DeleteCallback(intptr_t id) {
+  AsyncCallback* callback = callbacks_[id].load();
+  callbacks_[id].store(nullptr, std::memory_order_seq_cst);
+  while (active_calls_[id].load(std::memory_order_seq_cst) != 0) {
+    OS::SleepMicros(10);
+  }
+  delete callback;
+}
+
+#if defined(SUPPORTS_ASYNC_CALLBACKS)
+template <intptr_t kId>
+static void AsyncCallbackTrampoline(ASYNC_CALLBACK_PARAMETERS) {
+  const int64_t registers[] = {ASYNC_CALLBACK_REGISTERS};
+  FfiAsyncCallbacks::Enqueue(kId, registers);
+}
+
+#define ASYNC_CALLBACK_TRAMPOLINES_16(base)                                    \
+  &AsyncCallbackTrampoline<base + 0>, &AsyncCallbackTrampoline<base + 1>,      \
+      &AsyncCallbackTrampoline<base + 2>, &AsyncCallbackTrampoline<base + 3>,  \
+      &AsyncCallbackTrampoline<base + 4>, &AsyncCallbackTrampoline<base + 5>,  \
+      &AsyncCallbackTrampoline<base + 6>, &AsyncCallbackTrampoline<base + 7>,  \
+      &AsyncCallbackTrampoline<base + 8>, &AsyncCallbackTrampoline<base + 9>,  \
+      &AsyncCallbackTrampoline<base + 10>,                                     \
+      &AsyncCallbackTrampoline<base + 11>,                                     \
+      &AsyncCallbackTrampoline<base + 12>,                                     \
+      &AsyncCallbackTrampoline<base + 13>,                                     \
+      &AsyncCallbackTrampoline<base + 14>, &AsyncCallbackTrampoline<base + 15>
+
+typedef void (*AsyncCallbackTrampolineType)(ASYNC_CALLBACK_PARAMETERS);
+
+static const AsyncCallbackTrampolineType kTrampolines[] = {
+    ASYNC_CALLBACK_TRAMPOLINES_16(0),  ASYNC_CALLBACK_TRAMPOLINES_16(16),
+    ASYNC_CALLBACK_TRAMPOLINES_16(32), ASYNC_CALLBACK_TRAMPOLINES_16(48),
+    ASYNC_CALLBACK_TRAMPOLINES_16(64), ASYNC_CALLBACK_TRAMPOLINES_16(80),
+    ASYNC_CALLBACK_TRAMPOLINES_16(96), ASYNC_CALLBACK_TRAMPOLINES_16(112),
+};
+COMPILE_ASSERT(ARRAY_SIZE(kTrampolines) == kMaxCallbacks);
+
+#undef ASYNC_CALLBACK_TRAMPOLINES_16
+#endif  // defined(SUPPORTS_ASYNC_CALLBACKS)
+
+void FfiAsyncCallbacks::Init() {
+  ASSERT(lock_ == nullptr);
+  lock_ = new Mutex();
+}
+
+void FfiAsyncCallbacks::Cleanup() {
+  for (intptr_t i = 0; i < kMaxCallbacks; i++) {
+    delete callbacks_[i].load();
+    callbacks_[i].store(nullptr);
+  }
+  delete lock_;
+  lock_ = nullptr;
+}
+
+// Sets |error| if the arguments of |signature| can't be passed to the
+// trampolines.
+static void ComputeArgumentRegisters(const Function& signature,
+                                     AsyncCallback* callback,
+                                     const char** error) {
+  if (AbstractType::Handle(signature.result_type()).type_class_id() !=
+      kFfiVoidCid) {
+    *error = "Asynchronous callbacks must return Void.";
+    return;
+  }
+  // The first parameter is the closure.
+  callback->num_arguments = signature.num_fixed_parameters() - 1;
+  intptr_t next_integer = 0;
+  intptr_t next_fpu = 0;
+  AbstractType& type = AbstractType::Handle();
+  for (intptr_t i = 0; i < callback->num_arguments; i++) {
+    type = signature.ParameterTypeAt(i + 1);
+    const classid_t cid = type.type_class_id();
+    if (kPositionalRegisters) {
+      next_integer = next_fpu = i;
+    }
+    if (IsFfiTypeIntClassId(cid) || IsFfiPointerClassId(cid)) {
+      if (next_integer >= kNumIntegerRegisters) {
+        *error = "Too many arguments for an asynchronous callback.";
+        return;
+      }
+      callback->registers[i] = next_integer++;
+    } else if (IsFfiTypeDoubleClassId(cid)) {
+      if (next_fpu >= kNumFpuRegisters) {
+        *error =
+            "Too many floating point arguments for an asynchronous callback.";
+        return;
+      }
+      callback->registers[i] = kNumIntegerRegisters + next_fpu++;
+    } else {
+      *error =
+          "Asynchronous callbacks only take integer, pointer and floating "
+          "point arguments.";
+      return;
+    }
+    callback->cids[i] = cid;
+  }
+}
+
+intptr_t FfiAsyncCallbacks::Create(Isolate* isolate,
+                                   Dart_Port port,
+                                   const Function& signature,
+                                   const char** error) {
+#if !defined(SUPPORTS_ASYNC_CALLBACKS)
+  *error = "Asynchronous callbacks are not supported on this architecture.";
+  return -1;
+#else
+  AsyncCallback* callback = new AsyncCallback();
+  ComputeArgumentRegisters(signature, callback, error);
+  if (*error != nullptr) {
+    delete callback;
+    return -1;
+  }
+  callback->isolate = isolate;
+  callback->port = port;
+  callback->enqueue_position.store(0);
+  callback->dequeue_position = 0;
+  callback->notified.store(0);
+  for (intptr_t i = 0; i < kQueueCapacity; i++) {
+    callback->calls[i].sequence.store(i);
+  }
+
+  MutexLocker ml(lock_);
+  for (intptr_t id = 0; id < kMaxCallbacks; id++) {
+    if (callbacks_[id].load() == nullptr) {
+      callbacks_[id].store(callback);
+      return id;
+    }
+  }
+  delete callback;
+  *error = "Too many asynchronous callbacks.";
+  return -1;
+#endif
+}
+
+static AsyncCallback* Lookup(Isolate* isolate, Dart_Port port, intptr_t id) {
+  if (id < 0 || id >= kMaxCallbacks) {
+    return nullptr;
+  }
+  AsyncCallback* callback = callbacks_[id].load();
+  if (callback == nullptr || callback->isolate != isolate ||
+      callback->port != port) {
+    return nullptr;
+  }
+  return callback;
+}
+
+bool FfiAsyncCallbacks::Address(Isolate* isolate,
+                                Dart_Port port,
+                                intptr_t id,
+                                uword* address) {
+#if defined(SUPPORTS_ASYNC_CALLBACKS)
+  if (Lookup(isolate, port, id) != nullptr) {
+    *address = reinterpret_cast<uword>(kTrampolines[id]);
+    return true;
+  }
+#endif
+  return false;
+}
+
+// A bounded multi-producer queue. The call at |position| goes to the slot
+// |position| modulo the capacity, which is free for it when its sequence is
+// |position|, and filled when it is |position| + 1. Producers claim a position
+// by incrementing |enqueue_position|, and the consumer frees the slot for the
+// next round by setting its sequence to |position| + capacity.
+static void EnqueueCall(intptr_t id,
+                        AsyncCallback* callback,
+                        const int64_t* registers) {
+  uint64_t position =
+      callback->enqueue_position.load(std::memory_order_relaxed);
+  AsyncCallbackCall* call;
+  while (true) {
+    call = &callback->calls[position & (kQueueCapacity - 1)];
+    const int64_t difference =
+        static_cast<int64_t>(call->sequence.load() - position);
+    if (difference == 0) {
+      if (callback->enqueue_position.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // Full, wait for the isolate to catch up.
+      if (callbacks_[id].load() != callback) {
+        return;
+      }
+      OS::SleepMicros(10);
+      position = callback->enqueue_position.load(std::memory_order_relaxed);
+    } else {
+      position = callback->enqueue_position.load(std::memory_order_relaxed);
+    }
+  }
+
+  for (intptr_t i = 0; i < callback->num_arguments; i++) {
+    call->values[i] = registers[callback->registers[i]];
+  }
+  // Sequentially consistent with the consumer's reset of |notified|, see
+  // Dequeue.
+  call->sequence.store(position + 1, std::memory_order_seq_cst);
+  if (callback->notified.fetch_or(1, std::memory_order_seq_cst) == 0) {
+    PortMap::PostMessage(
+        Message::New(callback->port, Smi::New(id), Message::kNormalPriority));
+  }
+}
+
+// Calls racing with the deletion of their callback are dropped.
+void FfiAsyncCallbacks::Enqueue(intptr_t id, const int64_t* registers) {
+  // Announces the call before looking up the callback, so Delete either sees
+  // it and waits, or has already removed the callback.
+  active_calls_[id].fetch_add(1, std::memory_order_seq_cst);
+  AsyncCallback* callback = callbacks_[id].load(std::memory_order_seq_cst);
+  if (callback != nullptr) {
+    EnqueueCall(id, callback, registers);
+  }
+  active_calls_[id].fetch_sub(1);
+}
+
+static bool TryDequeue(AsyncCallback* callback, int64_t* values) {
+  const uint64_t position = callback->dequeue_position;
+  AsyncCallbackCall* call = &callback->calls[position & (kQueueCapacity - 1)];
+  if (call->sequence.load(std::memory_order_seq_cst) != position + 1) {
+    return false;
+  }
+  for (intptr_t i = 0; i < callback->num_arguments; i++) {
+    values[i] = call->values[i];
+  }
+  callback->dequeue_position = position + 1;
+  call->sequence.store(position + kQueueCapacity);
+  return true;
+}
+
+bool FfiAsyncCallbacks::Dequeue(Zone* zone,
+                                Isolate* isolate,
+                                Dart_Port port,
+                                intptr_t id,
+                                const Function& signature,
+                                ObjectPtr* arguments) {
+  AsyncCallback* callback = Lookup(isolate, port, id);
+  if (callback == nullptr) {
+    return false;
+  }
+  int64_t values[kNumArgumentRegisters];
+  if (!TryDequeue(callback, values)) {
+    // A producer enqueuing after the reset posts a new wakeup; one which
+    // enqueued before it is seen by the second attempt.
+    callback->notified.store(0, std::memory_order_seq_cst);
+    if (!TryDequeue(callback, values)) {
+      *arguments = Object::null();
+      return true;
+    }
+  }
+
+  const Array& result =
+      Array::Handle(zone, Array::New(callback->num_arguments));
+  AbstractType& type = AbstractType::Handle(zone);
+  Object& value = Object::Handle(zone);
+  for (intptr_t i = 0; i < callback->num_arguments; i++) {
+    const int64_t bits = values[i];
+    switch (callback->cids[i]) {
+      case kFfiInt8Cid:
+        value = Integer::New(static_cast<int8_t>(bits));
+        break;
+      case kFfiInt16Cid:
+        value = Integer::New(static_cast<int16_t>(bits));
+        break;
+      case kFfiInt32Cid:
+        value = Integer::New(static_cast<int32_t>(bits));
+        break;
+      case kFfiUint8Cid:
+        value = Integer::New(static_cast<uint8_t>(bits));
+        break;
+      case kFfiUint16Cid:
+        value = Integer::New(static_cast<uint16_t>(bits));
+        break;
+      case kFfiUint32Cid:
+        value = Integer::New(static_cast<uint32_t>(bits));
+        break;
+      case kFfiInt64Cid:
+      case kFfiUint64Cid:
+      case kFfiIntPtrCid:
+        value = Integer::New(bits);
+        break;
+      case kFfiFloatCid:
+        value = Double::New(bit_cast<float>(static_cast<int32_t>(bits)));
+        break;
+      case kFfiDoubleCid:
+        value = Double::New(bit_cast<double>(bits));
+        break;
+      case kFfiPointerCid:
+        type = signature.ParameterTypeAt(i + 1);
+        type = TypeArguments::Handle(zone, type.arguments())
+                   .TypeAt(Pointer::kNativeTypeArgPos);
+        value = Pointer::New(type, static_cast<uword>(bits));
+        break;
+      default:
+        UNREACHABLE();
+    }
+    result.SetAt(i, value);
+  }
+  *arguments = result.raw();
+  return true;
+}
+
+bool FfiAsyncCallbacks::Delete(Isolate* isolate,
+                               Dart_Port port,
+                               intptr_t id) {
+  MutexLocker ml(lock_);
+  AsyncCallback* callback = Lookup(isolate, port, id);
+  if (callback == nullptr) {
+    return false;
+  }
+  DeleteCallback(id);
+  return true;
+}
+
+void FfiAsyncCallbacks::DeleteAll(Isolate* isolate) {
+  MutexLocker ml(lock_);
+  for (intptr_t id = 0; id < kMaxCallbacks; id++) {
+    AsyncCallback* callback = callbacks_[id].load();
+    if (callback != nullptr && callback->isolate == isolate) {
+      DeleteCallback(id);
+    }
+  }
+}
+
+}  // namespace dart
@@ -0,0 +1,72 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_FFI_ASYNC_CALLBACKS_H_
+#define RUNTIME_VM_FFI_ASYNC_CALLBACKS_H_
+
+#include "include/dart_api.h"
+#include "vm/allocation.h"
+#include "vm/globals.h"
+#include "vm/tagged_pointer.h"
+
+namespace dart {
+
+class Function;
+class Isolate;
+class Zone;
+
+// Native function pointers which may be called from any thread and run a Dart
+// closure asynchronously on the isolate which created them.
+//
+// Unlike the trampolines of Pointer.fromFunction, these don't enter the
+// isolate. Each one is a C++ function which copies its argument registers into
+// a preallocated slot of a bounded multi-producer queue, without locking or
+// allocating. Only when the queue goes from drained to non-empty a wakeup
+// message is posted to the port of the callback, whose handler then dequeues
+// and converts the arguments of all pending calls on the mutator.
+//
+// Calls return immediately, so only signatures returning void are supported,
+// and only with integer, pointer and floating point arguments which are all
+// passed in registers. A caller blocks while the queue of its callback is full.
+class FfiAsyncCallbacks : public AllStatic {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  // Returns the id of a new callback posting to |port|, or -1 with |error|
+  // set if |signature| is not supported or all callbacks are in use.
+  static intptr_t Create(Isolate* isolate,
+                         Dart_Port port,
+                         const Function& signature,
+                         const char** error);
+
+  // The following return false if |id| is not the callback |isolate| created
+  // for |port|. Ids are reused once their callback is deleted, so the port
+  // tells a stale id from the one of a newer callback.
+  static bool Address(Isolate* isolate,
+                      Dart_Port port,
+                      intptr_t id,
+                      uword* address);
+  // Sets |arguments| to an Array of the arguments of the next pending call,
+  // or to null if there is none. |signature| must be the one of Create.
+  static bool Dequeue(Zone* zone,
+                      Isolate* isolate,
+                      Dart_Port port,
+                      intptr_t id,
+                      const Function& signature,
+                      ObjectPtr* arguments);
+  // The native code must not call the callback anymore.
+  static bool Delete(Isolate* isolate, Dart_Port port, intptr_t id);
+
+  // Deletes the callbacks which |isolate| didn't delete before shutting down.
+  static void DeleteAll(Isolate* isolate);
+
+  // Used by the trampolines, |registers| contains all integer argument
+  // registers followed by all floating point ones.
+  static void Enqueue(intptr_t id, const int64_t* registers);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_FFI_ASYNC_CALLBACKS_H_
@@ -76,7 +76,7 @@ void NativeCallbackTrampolines::AllocateTrampoline() {
                                /*prologue_offset=*/0,
                                /*size=*/assembler.CodeSize(),
                                /*optimized=*/false,  // not really relevant
-                               &wrapper);
+                               &wrapper, /*positions=*/nullptr);
     }
 #endif
 #if !defined(PRODUCT) || defined(FORCE_INCLUDE_DISASSEMBLER)
@@ -0,0 +1,93 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/ffi_symbol_cache.h"
+
+#include "vm/hash.h"
+#include "vm/hash_map.h"
+#include "vm/lockers.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+struct CachedSymbol {
+  intptr_t hash;
+  void* handle;
+  char* symbol;
+  uword address;
+};
+
+class CachedSymbolTrait {
+ public:
+  typedef CachedSymbol* Key;
+  typedef CachedSymbol* Value;
+  typedef CachedSymbol* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+  static Value ValueOf(Pair kv) { return kv; }
+  static intptr_t Hashcode(Key key) { return key->hash; }
+  static bool IsKeyEqual(Pair kv, Key key) {
+    return (kv->hash == key->hash) && (kv->handle == key->handle) &&
+           (strcmp(kv->symbol, key->symbol) == 0);
+  }
+};
+
+typedef MallocDirectChainedHashMap<CachedSymbolTrait> SymbolMap;
+
+static Mutex* lock_ = NULL;
+// Guarded by |lock_|.
+static SymbolMap* symbols_ = NULL;
+
+void FfiSymbolCache::Init() {
+  ASSERT(lock_ == NULL);
+  lock_ = new Mutex();
+  symbols_ = new SymbolMap();
+}
+
+void FfiSymbolCache::Cleanup() {
+  auto it = symbols_->GetIterator();
+  for (CachedSymbol** entry = it.Next(); entry != NULL; entry = it.Next()) {
+    free((*entry)->symbol);
+    delete *entry;
+  }
+  delete symbols_;
+  symbols_ = NULL;
+  delete lock_;
+  lock_ = NULL;
+}
+
+static intptr_t HashSymbol(void* handle, const char* symbol) {
+  uint32_t hash = HashBytes(reinterpret_cast<const uint8_t*>(symbol),
+                            strlen(symbol));
+  hash = CombineHashes(hash, static_cast<uint32_t>(
+                                 reinterpret_cast<uword>(handle) >> 3));
+  return FinalizeHash(hash, kBitsPerWord - 1);
+}
+
+bool FfiSymbolCache::Lookup(void* handle, const char* symbol, uword* address) {
+  CachedSymbol key = {HashSymbol(handle, symbol), handle,
+                      const_cast<char*>(symbol), 0};
+  MutexLocker ml(lock_);
+  CachedSymbol* entry = symbols_->LookupValue(&key);
+  if (entry == NULL) {
+    return false;
+  }
+  *address = entry->address;
+  return true;
+}
+
+void FfiSymbolCache::Insert(void* handle, const char* symbol, uword address) {
+  CachedSymbol key = {HashSymbol(handle, symbol), handle,
+                      const_cast<char*>(symbol), address};
+  MutexLocker ml(lock_);
+  if (symbols_->LookupValue(&key) != NULL) {
+    // Another isolate resolved it first.
+    return;
+  }
+  CachedSymbol* entry = new CachedSymbol(key);
+  entry->symbol = Utils::StrDup(symbol);
+  symbols_->Insert(entry);
+}
+
+}  // namespace dart
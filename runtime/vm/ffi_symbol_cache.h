@@ -0,0 +1,31 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_FFI_SYMBOL_CACHE_H_
+#define RUNTIME_VM_FFI_SYMBOL_CACHE_H_
+
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// The addresses of the symbols looked up in dynamic libraries, shared by all
+// isolates.
+//
+// Dynamic libraries are never unloaded, so an address stays valid for the
+// lifetime of the process once the lookup of its symbol succeeded. Failed
+// lookups aren't cached and resolve the symbol again, to report their error.
+class FfiSymbolCache : public AllStatic {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  // Returns false if |symbol| wasn't found in the library with |handle| yet.
+  static bool Lookup(void* handle, const char* symbol, uword* address);
+  static void Insert(void* handle, const char* symbol, uword address);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_FFI_SYMBOL_CACHE_H_
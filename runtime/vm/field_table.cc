@@ -106,10 +106,16 @@ FieldTable* FieldTable::Clone() {
   auto new_table = static_cast<InstancePtr*>(
       malloc(capacity_ * sizeof(InstancePtr)));  // NOLINT
   memmove(new_table, table_, top_ * sizeof(InstancePtr));
+  for (intptr_t i = top_; i < capacity_; i++) {
+    new_table[i] = InstancePtr();
+  }
   ASSERT(clone->table_ == nullptr);
   clone->table_ = new_table;
   clone->capacity_ = capacity_;
   clone->top_ = top_;
+  // Free elements were copied along with the rest of the table, so the
+  // clone shares the shape of the free list.
+  clone->free_head_ = free_head_;
   return clone;
 }
 
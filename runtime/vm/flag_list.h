@@ -95,6 +95,8 @@ constexpr bool kDartUseBackgroundCompilation = true;
     "-1 means never.")                                                         \
   P(background_compilation, bool, kDartUseBackgroundCompilation,               \
     "Run optimizing compilation in background")                                \
+  P(become_tasks, int, 2,                                                      \
+    "The number of tasks to use for forwarding pointers in become.")           \
   R(code_comments, false, bool, false,                                         \
     "Include comments into code and disassembly.")                             \
   P(collect_code, bool, false, "Attempt to GC infrequently used code.")        \
@@ -106,6 +108,8 @@ constexpr bool kDartUseBackgroundCompilation = true;
     "Function's usage-counter value before interpreted function is compiled, " \
     "-1 means never")                                                          \
   P(concurrent_mark, bool, true, "Concurrent mark for old generation.")        \
+  P(concurrent_release_from_space, bool, false,                                \
+    "Release from-space concurrently with the mutator after scavenging.")      \
   P(concurrent_sweep, bool, true, "Concurrent sweep for old generation.")      \
   C(deoptimize_alot, false, false, bool, false,                                \
     "Deoptimizes we are about to return to Dart code from native entries.")    \
@@ -138,6 +142,8 @@ constexpr bool kDartUseBackgroundCompilation = true;
   P(idle_duration_micros, int, 500 * kMicrosecondsPerMillisecond,              \
     "Allow idle tasks to run for this long.")                                  \
   P(interpret_irregexp, bool, false, "Use irregexp bytecode interpreter")      \
+  P(linear_regexp, bool, false,                                                \
+    "Match all regexps without backreferences or lookarounds in linear time")  \
   P(link_natives_lazily, bool, false, "Link native calls lazily")              \
   R(log_marker_tasks, false, bool, false,                                      \
     "Log debugging information for old gen GC marking tasks.")                 \
@@ -178,6 +184,8 @@ constexpr bool kDartUseBackgroundCompilation = true;
     "Print cluster sizes of generated snapshots.")                             \
   P(print_benchmarking_metrics, bool, false,                                   \
     "Print additional memory and latency metrics for benchmarking.")           \
+  P(print_runtime_counters, bool, false,                                       \
+    "Print the --runtime-counters when the VM shuts down.")                    \
   R(print_ssa_liveranges, false, bool, false,                                  \
     "Print live ranges after allocation.")                                     \
   R(print_stacktrace_at_api_error, false, bool, false,                         \
@@ -188,6 +196,11 @@ constexpr bool kDartUseBackgroundCompilation = true;
   R(profiler_native_memory, false, bool, false,                                \
     "Enable native memory statistic collection.")                              \
   P(reorder_basic_blocks, bool, true, "Reorder basic blocks")                  \
+  P(runtime_counters, bool, false,                                             \
+    "Count runtime calls, IC misses, megamorphic transitions and "             \
+    "deoptimizations.")                                                        \
+  P(runtime_counters_sample_period, int, 16,                                   \
+    "Attribute one in this many IC misses to their call site.")                \
   C(stress_async_stacks, false, false, bool, false,                            \
     "Stress test async stack traces")                                          \
   P(use_table_dispatch, bool, true, "Enable dispatch table based calls.")      \
@@ -6,6 +6,8 @@
 #define RUNTIME_VM_HASH_H_
 
 #include "platform/globals.h"
+#include "platform/unaligned.h"
+#include "platform/utils.h"
 
 namespace dart {
 
@@ -27,14 +29,58 @@ inline uint32_t FinalizeHash(uint32_t hash, intptr_t hashbits) {
   return (hash == 0) ? 1 : hash;
 }
 
+// Inputs of at least this many bytes are hashed a word at a time.
+static constexpr intptr_t kHashBytesWordThreshold = 16;
+
+// The primes and round of xxHash64.
+static constexpr uint64_t kHashPrime1 = 0x9e3779b185ebca87ULL;
+static constexpr uint64_t kHashPrime2 = 0xc2b2ae3d27d4eb4fULL;
+static constexpr uint64_t kHashPrime3 = 0x165667b19e3779f9ULL;
+
+inline uint64_t HashWordRound(uint64_t lane, uint64_t word) {
+  lane += word * kHashPrime2;
+  lane = Utils::RotateLeft(lane, 31);
+  return lane * kHashPrime1;
+}
+
+inline uint64_t LoadHashWord(const uint8_t* bytes) {
+  return LoadUnaligned(reinterpret_cast<const uint64_t*>(bytes));
+}
+
+// Short inputs (e.g. names) are combined byte by byte. Longer ones take two
+// independent multiplicative lanes over 16 bytes per step, which hides the
+// latency of the multiplications. The result depends on the byte order of
+// the host, so it must not be persisted across hosts.
 inline uint32_t HashBytes(const uint8_t* bytes, intptr_t size) {
-  uint32_t hash = size;
-  while (size > 0) {
-    hash = CombineHashes(hash, *bytes);
-    bytes++;
-    size--;
+  if (size < kHashBytesWordThreshold) {
+    uint32_t hash = size;
+    while (size > 0) {
+      hash = CombineHashes(hash, *bytes);
+      bytes++;
+      size--;
+    }
+    return hash;
   }
-  return hash;
+  const uint8_t* const end = bytes + size;
+  uint64_t lane0 = kHashPrime1 + static_cast<uint64_t>(size);
+  uint64_t lane1 = kHashPrime2;
+  while (end - bytes >= kHashBytesWordThreshold) {
+    lane0 = HashWordRound(lane0, LoadHashWord(bytes));
+    lane1 = HashWordRound(lane1, LoadHashWord(bytes + sizeof(uint64_t)));
+    bytes += kHashBytesWordThreshold;
+  }
+  if (bytes != end) {
+    // The last 16 bytes, overlapping some which were hashed already.
+    lane0 = HashWordRound(lane0, LoadHashWord(end - kHashBytesWordThreshold));
+    lane1 = HashWordRound(lane1, LoadHashWord(end - sizeof(uint64_t)));
+  }
+  uint64_t hash = Utils::RotateLeft(lane0, 1) + Utils::RotateLeft(lane1, 7);
+  hash ^= hash >> 33;
+  hash *= kHashPrime2;
+  hash ^= hash >> 29;
+  hash *= kHashPrime3;
+  hash ^= hash >> 32;
+  return static_cast<uint32_t>(hash);
 }
 
 }  // namespace dart
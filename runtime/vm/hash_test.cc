@@ -0,0 +1,36 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/hash.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+VM_UNIT_TEST_CASE(HashBytes) {
+  uint8_t buffer[128 + 8];
+  for (intptr_t i = 0; i < 128; i++) {
+    buffer[i] = static_cast<uint8_t>(i * 7 + 1);
+  }
+  for (intptr_t size = 0; size <= 128; size++) {
+    const uint32_t hash = HashBytes(buffer, size);
+    // Doesn't depend on the alignment of the input.
+    for (intptr_t offset = 1; offset < 8; offset++) {
+      memmove(buffer + offset, buffer + offset - 1, 128);
+      EXPECT_EQ(hash, HashBytes(buffer + offset, size));
+    }
+    memmove(buffer, buffer + 7, 128);
+    // Depends on every byte, including the ones of a partial last word.
+    for (intptr_t i = 0; i < size; i++) {
+      buffer[i] ^= 0x10;
+      EXPECT_NE(hash, HashBytes(buffer, size));
+      buffer[i] ^= 0x10;
+    }
+    if (size > 0) {
+      EXPECT_NE(hash, HashBytes(buffer, size - 1));
+    }
+  }
+}
+
+}  // namespace dart
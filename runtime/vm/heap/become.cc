@@ -7,11 +7,15 @@
 #include "platform/assert.h"
 #include "platform/utils.h"
 
+#include "vm/dart.h"
 #include "vm/dart_api_state.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate_reload.h"
 #include "vm/object.h"
 #include "vm/raw_object.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
 
@@ -129,6 +133,55 @@ class ForwardHeapPointersVisitor : public ObjectVisitor {
   DISALLOW_COPY_AND_ASSIGN(ForwardHeapPointersVisitor);
 };
 
+// Visits the objects of the old-space pages which are handed out one at a
+// time through [next_page].
+static void ForwardPagePointers(const MallocGrowableArray<OldPage*>& pages,
+                                RelaxedAtomic<intptr_t>* next_page,
+                                ForwardHeapPointersVisitor* visitor) {
+  for (intptr_t i = next_page->fetch_add(1u); i < pages.length();
+       i = next_page->fetch_add(1u)) {
+    pages[i]->VisitObjects(visitor);
+  }
+}
+
+class ForwardHeapPointersTask : public ThreadPool::Task {
+ public:
+  ForwardHeapPointersTask(IsolateGroup* isolate_group,
+                          ThreadBarrier* barrier,
+                          const MallocGrowableArray<OldPage*>* pages,
+                          RelaxedAtomic<intptr_t>* next_page)
+      : isolate_group_(isolate_group),
+        barrier_(barrier),
+        pages_(pages),
+        next_page_(next_page) {}
+
+  virtual void Run() {
+    bool result = Thread::EnterIsolateGroupAsHelper(
+        isolate_group_, Thread::kCompactorTask, /*bypass_safepoint=*/true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardHeapPointers");
+      ForwardPointersVisitor pointer_visitor(thread);
+      ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
+      ForwardPagePointers(*pages_, next_page_, &object_visitor);
+      pointer_visitor.VisitingObject(nullptr);
+    }
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  ThreadBarrier* barrier_;
+  const MallocGrowableArray<OldPage*>* pages_;
+  RelaxedAtomic<intptr_t>* next_page_;
+
+  DISALLOW_COPY_AND_ASSIGN(ForwardHeapPointersTask);
+};
+
 class ForwardHeapPointersHandleVisitor : public HandleVisitor {
  public:
   explicit ForwardHeapPointersHandleVisitor(Thread* thread)
@@ -285,7 +338,24 @@ void Become::FollowForwardingPointers(Thread* thread) {
     // Heap pointers.
     WritableCodeLiteralsScope writable_code(heap);
     ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
-    heap->VisitObjects(&object_visitor);
+    heap->new_space()->VisitObjects(&object_visitor);
+
+    // The old-space pages are shared with helper tasks. Each task has its own
+    // store buffer block to which the remembered objects it visits are added.
+    MallocGrowableArray<OldPage*> pages;
+    heap->old_space()->AddPagesTo(&pages);
+    const intptr_t num_tasks = Utils::Maximum<intptr_t>(
+        1, Utils::Minimum<intptr_t>(FLAG_become_tasks, pages.length()));
+    ThreadBarrier barrier(num_tasks, heap->barrier(), heap->barrier_done());
+    RelaxedAtomic<intptr_t> next_page = {0};
+    for (intptr_t i = 0; i < num_tasks - 1; i++) {
+      bool result = Dart::thread_pool()->Run<ForwardHeapPointersTask>(
+          isolate_group, &barrier, &pages, &next_page);
+      ASSERT(result);
+    }
+    // The last worker is the current thread.
+    ForwardPagePointers(pages, &next_page, &object_visitor);
+    barrier.Exit();
     pointer_visitor.VisitingObject(NULL);
   }
 
@@ -168,9 +168,16 @@ class CompactorTask : public ThreadPool::Task {
 // Free space at the end of a page that is too small for the next block is
 // added to the freelist.
 void GCCompactor::Compact(OldPage* pages,
+                          OldPage* pinned_pages,
                           FreeList* freelist,
                           Mutex* pages_lock) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  // Cached Code objects are about to move.
+  thread()->isolate_group()->reverse_pc_lookup_cache()->Clear();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
   SetupImagePageBoundaries();
+  pinned_pages_ = pinned_pages;
+  PinPages();
 
   // Divide the heap.
   // TODO(30978): Try to divide based on live bytes or with work stealing.
@@ -296,6 +303,12 @@ void GCCompactor::Compact(OldPage* pages,
     ForwardStackPointers();
   }
 
+#if defined(DART_PRECOMPILED_RUNTIME)
+  // Code objects may have moved, drop entries populated before or during the
+  // compaction.
+  thread()->isolate_group()->reverse_pc_lookup_cache()->Clear();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
   {
     MutexLocker ml(pages_lock);
 
@@ -315,13 +328,57 @@ void GCCompactor::Compact(OldPage* pages,
     for (intptr_t task_index = 0; task_index < num_tasks - 1; task_index++) {
       tails[task_index]->set_next(heads[task_index + 1]);
     }
-    tails[num_tasks - 1]->set_next(NULL);
+    tails[num_tasks - 1]->set_next(pinned_pages_);
+    if (pinned_pages_ == NULL) {
+      heap_->old_space()->pages_tail_ = tails[num_tasks - 1];
+    } else {
+      // The pinned pages are still the old space's page list, so its tail is
+      // also the tail of the re-joined heap.
+      ASSERT(heap_->old_space()->pages_ == pinned_pages_);
+    }
     heap_->old_space()->pages_ = pages = heads[0];
-    heap_->old_space()->pages_tail_ = tails[num_tasks - 1];
 
     delete[] heads;
     delete[] tails;
   }
+
+  UnpinPages();
+}
+
+// Objects on pinned pages do not move. Hiding their forwarding pages makes
+// ForwardPointer leave references to them untouched.
+void GCCompactor::PinPages() {
+  for (OldPage* page = pinned_pages_; page != NULL; page = page->next()) {
+    ASSERT(page->forwarding_page_ ==
+           reinterpret_cast<ForwardingPage*>(page->object_end()));
+    page->forwarding_page_ = NULL;
+  }
+}
+
+// Pinned pages are not swept until after compaction. Their dead objects may
+// still refer to dead objects on evacuated pages, which have no forwarding
+// address, so only the marked (live) objects are visited.
+void GCCompactor::ForwardPinnedPage(OldPage* page) {
+  uword current = page->object_start();
+  uword end = page->object_end();
+  while (current < end) {
+    ObjectPtr obj = ObjectLayout::FromAddr(current);
+    if (obj->ptr()->IsMarked()) {
+      current += obj->ptr()->VisitPointers(this);
+    } else {
+      current += obj->ptr()->HeapSize();
+    }
+  }
+  ASSERT(current == end);
+}
+
+void GCCompactor::UnpinPages() {
+  for (OldPage* page = pinned_pages_; page != NULL; page = page->next()) {
+    ASSERT(page->forwarding_page_ == NULL);
+    page->forwarding_page_ =
+        reinterpret_cast<ForwardingPage*>(page->object_end());
+  }
+  pinned_pages_ = NULL;
 }
 
 void CompactorTask::Run() {
@@ -413,8 +470,16 @@ void CompactorTask::RunEnteredIsolateGroup() {
           isolate_group_->VisitWeakPersistentHandles(compactor_);
           break;
         }
-#ifndef PRODUCT
         case 5: {
+          TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardPinnedPages");
+          for (OldPage* pinned_page = compactor_->pinned_pages_;
+               pinned_page != NULL; pinned_page = pinned_page->next()) {
+            compactor_->ForwardPinnedPage(pinned_page);
+          }
+          break;
+        }
+#ifndef PRODUCT
+        case 6: {
           TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardObjectIdRing");
           isolate_group_->ForEachIsolate(
               [&](Isolate* isolate) {
@@ -30,7 +30,14 @@ class GCCompactor : public ValueObject,
         heap_(heap) {}
   ~GCCompactor() { free(image_page_ranges_); }
 
-  void Compact(OldPage* pages, FreeList* freelist, Mutex* mutex);
+  // Slides the live objects of 'pages' together. 'pinned_pages' are marked but
+  // not yet swept data pages whose live objects stay in place but whose
+  // pointers are forwarded; they are appended to the compacted pages when the
+  // heap is re-joined.
+  void Compact(OldPage* pages,
+               OldPage* pinned_pages,
+               FreeList* freelist,
+               Mutex* mutex);
 
  private:
   friend class CompactorTask;
@@ -44,7 +51,12 @@ class GCCompactor : public ValueObject,
   void VisitPointers(ObjectPtr* first, ObjectPtr* last);
   void VisitHandle(uword addr);
 
+  void PinPages();
+  void ForwardPinnedPage(OldPage* page);
+  void UnpinPages();
+
   Heap* heap_;
+  OldPage* pinned_pages_ = nullptr;
 
   struct ImagePageRange {
     uword start;
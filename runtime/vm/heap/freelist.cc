@@ -55,6 +55,8 @@ intptr_t FreeListElement::HeaderSizeFor(intptr_t size) {
 }
 
 FreeList::FreeList() : mutex_() {
+  COMPILE_ASSERT((1 << kNumListsLog2) == kNumLists);
+  COMPILE_ASSERT(kNumLargeLists <= kBitsPerWord);
   Reset();
 }
 
@@ -73,7 +75,7 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
 
   // Postcondition: if allocation succeeds, the allocated block is writable.
   int index = IndexForSize(size);
-  if ((index != kNumLists) && free_map_.Test(index)) {
+  if ((index < kNumLists) && free_map_.Test(index)) {
     FreeListElement* element = DequeueElement(index);
     if (is_protected) {
       VirtualMemory::Protect(reinterpret_cast<void*>(element), size,
@@ -85,42 +87,73 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
   if ((index + 1) < kNumLists) {
     intptr_t next_index = free_map_.Next(index + 1);
     if (next_index != -1) {
-      // Dequeue an element from the list, split and enqueue the remainder in
-      // the appropriate list.
-      FreeListElement* element = DequeueElement(next_index);
-      if (is_protected) {
-        // Make the allocated block and the header of the remainder element
-        // writable.  The remainder will be non-writable if necessary after
-        // the call to SplitElementAfterAndEnqueue.
-        // If the remainder size is zero, only the element itself needs to
-        // be made writable.
-        intptr_t remainder_size = element->HeapSize() - size;
-        intptr_t region_size =
-            size + FreeListElement::HeaderSizeFor(remainder_size);
-        VirtualMemory::Protect(reinterpret_cast<void*>(element), region_size,
-                               VirtualMemory::kReadWrite);
-      }
+      return reinterpret_cast<uword>(
+          DequeueAndSplitLocked(next_index, size, is_protected));
+    }
+  }
+
+  // Only elements of the request's own size class can be too small, every
+  // element of a larger size class fits.
+  intptr_t next_index;
+  if (index < kNumLists) {
+    next_index = NextLargeIndex(kNumLists);
+  } else {
+    FreeListElement* element = FindLargeLocked(index, size, is_protected);
+    if (element != NULL) {
       SplitElementAfterAndEnqueue(element, size, is_protected);
       return reinterpret_cast<uword>(element);
     }
+    next_index = NextLargeIndex(index + 1);
   }
+  if (next_index == -1) {
+    return 0;  // Trigger allocation of new page.
+  }
+  return reinterpret_cast<uword>(
+      DequeueAndSplitLocked(next_index, size, is_protected));
+}
 
+FreeListElement* FreeList::DequeueAndSplitLocked(intptr_t index,
+                                                 intptr_t size,
+                                                 bool is_protected) {
+  // Dequeue an element from the list, split and enqueue the remainder in
+  // the appropriate list.
+  FreeListElement* element = DequeueElement(index);
+  ASSERT(element->HeapSize() >= size);
+  if (is_protected) {
+    // Make the allocated block and the header of the remainder element
+    // writable.  The remainder will be non-writable if necessary after
+    // the call to SplitElementAfterAndEnqueue.
+    // If the remainder size is zero, only the element itself needs to
+    // be made writable.
+    intptr_t remainder_size = element->HeapSize() - size;
+    intptr_t region_size =
+        size + FreeListElement::HeaderSizeFor(remainder_size);
+    VirtualMemory::Protect(reinterpret_cast<void*>(element), region_size,
+                           VirtualMemory::kReadWrite);
+  }
+  SplitElementAfterAndEnqueue(element, size, is_protected);
+  return element;
+}
+
+FreeListElement* FreeList::FindLargeLocked(intptr_t index,
+                                           intptr_t size,
+                                           bool is_protected) {
+  ASSERT(index >= kNumLists);
   FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // We are willing to search the freelist further for a big block.
+  FreeListElement* current = free_lists_[index];
+  // We are willing to search the size class further for a big block.
   // For each successful free-list search we:
   //   * increase the search budget by #allocated-words
   //   * decrease the search budget by #free-list-entries-traversed
   //     which guarantees us to not waste more than around 1 search step per
   //     word of allocation
   //
-  // If we run out of search budget we fall back to allocating a new page and
-  // reset the search budget.
+  // If we run out of search budget we fall back to a larger size class or to
+  // allocating a new page, and reset the search budget.
   intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
   while (current != NULL) {
     if (current->HeapSize() >= size) {
-      // Found an element large enough to hold the requested size. Dequeue,
-      // split and enqueue the remainder.
+      // Found an element large enough to hold the requested size. Dequeue it.
       intptr_t remainder_size = current->HeapSize() - size;
       intptr_t region_size =
           size + FreeListElement::HeaderSizeFor(remainder_size);
@@ -133,7 +166,7 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
       }
 
       if (previous == NULL) {
-        free_lists_[kNumLists] = current->next();
+        DequeueElement(index);
       } else {
         // If the previous free list element's next field is protected, it
         // needs to be unprotected before storing to it and reprotected
@@ -158,18 +191,17 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
                                  kWordSize, VirtualMemory::kReadExecute);
         }
       }
-      SplitElementAfterAndEnqueue(current, size, is_protected);
       freelist_search_budget_ =
           Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return reinterpret_cast<uword>(current);
+      return current;
     } else if (tries_left-- < 0) {
       freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
+      return NULL;
     }
     previous = current;
     current = current->next();
   }
-  return 0;
+  return NULL;
 }
 
 void FreeList::Free(uword addr, intptr_t size) {
@@ -193,15 +225,18 @@ void FreeList::FreeLocked(uword addr, intptr_t size) {
 void FreeList::Reset() {
   MutexLocker ml(&mutex_);
   free_map_.Reset();
+  large_map_ = 0;
   last_free_small_size_ = -1;
-  for (int i = 0; i < (kNumLists + 1); i++) {
+  for (int i = 0; i < (kNumLists + kNumLargeLists); i++) {
     free_lists_[i] = NULL;
   }
 }
 
 void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
   FreeListElement* next = free_lists_[index];
-  if (next == NULL && index != kNumLists) {
+  if (next == NULL && index >= kNumLists) {
+    large_map_ |= static_cast<uword>(1) << (index - kNumLists);
+  } else if (next == NULL) {
     free_map_.Set(index, true);
     last_free_small_size_ =
         Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
@@ -273,16 +308,18 @@ void FreeList::PrintLarge() const {
   int large_objects = 0;
   intptr_t large_bytes = 0;
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> > map;
-  FreeListElement* node;
-  for (node = free_lists_[kNumLists]; node != NULL; node = node->next()) {
-    IntptrPair* pair = map.Lookup(node->HeapSize());
-    if (pair == NULL) {
-      large_sizes += 1;
-      map.Insert(IntptrPair(node->HeapSize(), 1));
-    } else {
-      pair->set_second(pair->second() + 1);
+  for (intptr_t i = kNumLists; i < (kNumLists + kNumLargeLists); ++i) {
+    FreeListElement* node;
+    for (node = free_lists_[i]; node != NULL; node = node->next()) {
+      IntptrPair* pair = map.Lookup(node->HeapSize());
+      if (pair == NULL) {
+        large_sizes += 1;
+        map.Insert(IntptrPair(node->HeapSize(), 1));
+      } else {
+        pair->set_second(pair->second() + 1);
+      }
+      large_objects += 1;
     }
-    large_objects += 1;
   }
 
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> >::Iterator it =
@@ -350,29 +387,19 @@ FreeListElement* FreeList::TryAllocateLarge(intptr_t minimum_size) {
 
 FreeListElement* FreeList::TryAllocateLargeLocked(intptr_t minimum_size) {
   DEBUG_ASSERT(mutex_.IsOwnedByCurrentThread());
-  FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // TODO(koda): Find largest.
-  // We are willing to search the freelist further for a big block.
-  intptr_t tries_left =
-      freelist_search_budget_ + (minimum_size >> kWordSizeLog2);
-  while (current != NULL) {
-    FreeListElement* next = current->next();
-    if (current->HeapSize() >= minimum_size) {
-      if (previous == NULL) {
-        free_lists_[kNumLists] = next;
-      } else {
-        previous->set_next(next);
-      }
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return current;
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
-    }
-    previous = current;
-    current = next;
+  if (large_map_ == 0) {
+    return NULL;
+  }
+  // Prefer an element from the largest size class so that bump allocation
+  // regions last as long as possible.
+  intptr_t index = LargeIndexForSize(minimum_size);
+  intptr_t last_index =
+      kNumLists + (kBitsPerWord - 1) - Utils::CountLeadingZerosWord(large_map_);
+  if (last_index > index) {
+    return DequeueElement(last_index);
+  }
+  if (last_index == index) {
+    return FindLargeLocked(index, minimum_size, false);
   }
   return NULL;
 }
@@ -381,13 +408,13 @@ void FreeList::MergeFrom(FreeList* donor, bool is_protected) {
   // The [other] free list is from a dying isolate. There are no other threads
   // accessing it, so there is no need to lock here.
   MutexLocker ml(&mutex_);
-  for (intptr_t i = 0; i < (kNumLists + 1); ++i) {
+  for (intptr_t i = 0; i < (kNumLists + kNumLargeLists); ++i) {
     FreeListElement* donor_head = donor->free_lists_[i];
     if (donor_head != nullptr) {
       // If we didn't have a freelist element before we have to set the bit now,
       // since we will get 1+ elements from [other].
       FreeListElement* old_head = free_lists_[i];
-      if (old_head == nullptr && i != kNumLists) {
+      if (old_head == nullptr && i < kNumLists) {
         free_map_.Set(i, true);
       }
 
@@ -410,6 +437,7 @@ void FreeList::MergeFrom(FreeList* donor, bool is_protected) {
     }
   }
 
+  large_map_ |= donor->large_map_;
   last_free_small_size_ =
       Utils::Maximum(last_free_small_size_, donor->last_free_small_size_);
 }
@@ -92,6 +92,7 @@ class FreeList {
   void FreeLocked(uword addr, intptr_t size);
 
   // Returns a large element, at least 'minimum_size', or NULL if none exists.
+  // Elements from the largest available size class are preferred.
   FreeListElement* TryAllocateLarge(intptr_t minimum_size);
   FreeListElement* TryAllocateLargeLocked(intptr_t minimum_size);
 
@@ -103,7 +104,7 @@ class FreeList {
       return 0;
     }
     int index = IndexForSize(size);
-    if (index != kNumLists && free_map_.Test(index)) {
+    if (index < kNumLists && free_map_.Test(index)) {
       return reinterpret_cast<uword>(DequeueElement(index));
     }
     if ((index + 1) < kNumLists) {
@@ -161,6 +162,13 @@ class FreeList {
 
  private:
   static const int kNumLists = 128;
+  static const intptr_t kNumListsLog2 = 7;
+  // Elements too big for the exact-size lists are segregated by powers of two:
+  // large list i holds elements of [kLargeSizeMin << i, kLargeSizeMin << i+1),
+  // and the last large list holds everything bigger.
+  static const int kNumLargeLists = 16;
+  static const intptr_t kLargeSizeMinLog2 =
+      kNumListsLog2 + kObjectAlignmentLog2;
   static const intptr_t kInitialFreeListSearchBudget = 1000;
 
   static intptr_t IndexForSize(intptr_t size) {
@@ -169,18 +177,52 @@ class FreeList {
 
     intptr_t index = size >> kObjectAlignmentLog2;
     if (index >= kNumLists) {
-      index = kNumLists;
+      index = LargeIndexForSize(size);
     }
     return index;
   }
 
+  // Returns the large list whose elements are closest to 'size', or the first
+  // large list if 'size' is small.
+  static intptr_t LargeIndexForSize(intptr_t size) {
+    intptr_t size_class = (kBitsPerWord - 1) -
+                          Utils::CountLeadingZerosWord(size) -
+                          kLargeSizeMinLog2;
+    if (size_class < 0) {
+      return kNumLists;
+    }
+    return kNumLists + Utils::Minimum<intptr_t>(size_class, kNumLargeLists - 1);
+  }
+
+  // Returns the first non-empty large list at or after 'index', or -1.
+  intptr_t NextLargeIndex(intptr_t index) const {
+    ASSERT(index >= kNumLists);
+    if (index >= kNumLists + kNumLargeLists) {
+      return -1;
+    }
+    uword map = large_map_ >> (index - kNumLists);
+    if (map == 0) {
+      return -1;
+    }
+    return index + Utils::CountTrailingZerosWord(map);
+  }
+
+  FreeListElement* FindLargeLocked(intptr_t index,
+                                   intptr_t size,
+                                   bool is_protected);
+  FreeListElement* DequeueAndSplitLocked(intptr_t index,
+                                         intptr_t size,
+                                         bool is_protected);
+
   intptr_t LengthLocked(int index) const;
 
   void EnqueueElement(FreeListElement* element, intptr_t index);
   FreeListElement* DequeueElement(intptr_t index) {
     FreeListElement* result = free_lists_[index];
     FreeListElement* next = result->next();
-    if (next == NULL && index != kNumLists) {
+    if (next == NULL && index >= kNumLists) {
+      large_map_ &= ~(static_cast<uword>(1) << (index - kNumLists));
+    } else if (next == NULL) {
       intptr_t size = index << kObjectAlignmentLog2;
       if (size == last_free_small_size_) {
         // Note: This is -1 * kObjectAlignment if no other small sizes remain.
@@ -215,7 +257,10 @@ class FreeList {
 
   BitSet<kNumLists> free_map_;
 
-  FreeListElement* free_lists_[kNumLists + 1];
+  // Bit i is set if large list i is non-empty.
+  uword large_map_;
+
+  FreeListElement* free_lists_[kNumLists + kNumLargeLists];
 
   intptr_t freelist_search_budget_ = kInitialFreeListSearchBudget;
 
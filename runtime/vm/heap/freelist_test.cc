@@ -185,6 +185,56 @@ TEST_CASE(FreeListProtectedVariableSizeObjects) {
   delete[] objects;
 }
 
+TEST_CASE(FreeListSizeClasses) {
+  std::unique_ptr<FreeList> free_list(new FreeList());
+  const intptr_t kBlobSize = 1 * MB;
+  std::unique_ptr<VirtualMemory> region(
+      VirtualMemory::Allocate(kBlobSize, /*is_executable=*/false, "test"));
+  const uword a = region->start();
+  const uword b = a + 3 * KB;
+  const uword c = b + 40 * KB;
+  free_list->Free(a, 3 * KB);
+  free_list->Free(b, 40 * KB);
+  free_list->Free(c, 5 * KB);
+
+  // Each request is served from the size class that fits it best.
+  EXPECT_EQ(b, free_list->TryAllocate(36 * KB, /*is_protected=*/false));
+  EXPECT_EQ(a, free_list->TryAllocate(5 * KB / 2, /*is_protected=*/false));
+  EXPECT_EQ(c, free_list->TryAllocate(5 * KB, /*is_protected=*/false));
+
+  // The remainders went back to their own size classes.
+  FreeListElement* element = free_list->TryAllocateLarge(kObjectAlignment);
+  EXPECT_EQ(b + 36 * KB, reinterpret_cast<uword>(element));
+  EXPECT_EQ(4 * KB, element->HeapSize());
+  EXPECT_EQ(a + 5 * KB / 2,
+            free_list->TryAllocate(KB / 2, /*is_protected=*/false));
+  EXPECT_EQ(0u, free_list->TryAllocate(kObjectAlignment, false));
+}
+
+TEST_CASE(FreeListManyMediumElements) {
+  std::unique_ptr<FreeList> free_list(new FreeList());
+  const intptr_t kNumElements = 1000;
+  const intptr_t kMediumSize = 3 * KB;
+  const intptr_t kLargeSize = 64 * KB;
+  std::unique_ptr<VirtualMemory> region(VirtualMemory::Allocate(
+      kNumElements * kMediumSize + kLargeSize, /*is_executable=*/false,
+      "test"));
+  const uword large = region->start() + kNumElements * kMediumSize;
+  free_list->Free(large, kLargeSize);
+  for (intptr_t i = 0; i < kNumElements; i++) {
+    free_list->Free(region->start() + i * kMediumSize, kMediumSize);
+  }
+
+  // The large element is found without walking past the medium ones.
+  EXPECT_EQ(large, free_list->TryAllocate(kLargeSize / 2, false));
+  EXPECT_EQ(large + kLargeSize / 2,
+            reinterpret_cast<uword>(free_list->TryAllocateLarge(KB)));
+  for (intptr_t i = 0; i < kNumElements; i++) {
+    EXPECT(free_list->TryAllocate(kMediumSize, false) != 0u);
+  }
+  EXPECT(free_list->TryAllocateLarge(KB) == NULL);
+}
+
 static void TestRegress38528(intptr_t header_overlap) {
   // Test the following scenario.
   //
@@ -10,6 +10,7 @@
 #include "platform/assert.h"
 #include "platform/utils.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/dart_api_state.h"
 #include "vm/flags.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
@@ -29,6 +30,7 @@
 #include "vm/tags.h"
 #include "vm/thread_pool.h"
 #include "vm/timeline.h"
+#include "vm/usdt.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -38,6 +40,10 @@ DEFINE_FLAG(bool,
             disable_heap_verification,
             false,
             "Explicitly disable heap verification.");
+DEFINE_FLAG(bool,
+            old_space_tlabs,
+            false,
+            "Serve small old-space data allocations from per-thread buffers.");
 
 // We ensure that the GC does not use the current isolate.
 class NoActiveIsolateScope {
@@ -56,6 +62,19 @@ class NoActiveIsolateScope {
   Isolate* saved_isolate_;
 };
 
+// Charges the CPU time of the current thread to GC, see
+// --isolate-cpu-accounting.
+class GCCpuAccountingScope : public ValueObject {
+ public:
+  explicit GCCpuAccountingScope(Thread* thread) : thread_(thread) {
+    thread_->EnterGCCpuAccounting();
+  }
+  ~GCCpuAccountingScope() { thread_->ExitGCCpuAccounting(); }
+
+ private:
+  Thread* thread_;
+};
+
 Heap::Heap(IsolateGroup* isolate_group,
            intptr_t max_new_gen_semi_words,
            intptr_t max_old_gen_words)
@@ -112,13 +131,20 @@ uword Heap::AllocateNew(intptr_t size) {
 uword Heap::AllocateOld(intptr_t size, OldPage::PageType type) {
   ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
   CollectForDebugging();
-  uword addr = old_space_.TryAllocate(size, type);
+  Thread* thread = Thread::Current();
+  uword addr = 0;
+  if (FLAG_old_space_tlabs && (type == OldPage::kData)) {
+    addr = old_space_.TryAllocateFromTLAB(thread, size);
+    if (addr != 0) {
+      return addr;
+    }
+  }
+  addr = old_space_.TryAllocate(size, type);
   if (addr != 0) {
     return addr;
   }
   // If we are in the process of running a sweep, wait for the sweeper to free
   // memory.
-  Thread* thread = Thread::Current();
   if (old_space_.GrowthControlState()) {
     // Wait for any GC tasks that are in progress.
     WaitForSweeperTasks(thread);
@@ -367,6 +393,15 @@ void Heap::HintFreed(intptr_t size) {
 
 void Heap::NotifyIdle(int64_t deadline) {
   Thread* thread = Thread::Current();
+  // If concurrent marking is in progress, spend the idle time letting it
+  // finish, as long as there is time left to finalize it afterwards. This
+  // happens before CollectIdleGarbage stops the other mutators, so they keep
+  // running while we wait.
+  old_space_.WaitForIdleMarking(thread, deadline);
+  CollectIdleGarbage(thread, deadline);
+}
+
+void Heap::CollectIdleGarbage(Thread* thread, int64_t deadline) {
   SafepointOperationScope safepoint_operation(thread);
 
   // Check if we want to collect new-space first, because if we want to collect
@@ -398,18 +433,26 @@ void Heap::NotifyIdle(int64_t deadline) {
     // Blocks for O(heap).
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);
-  } else if (old_space_.ShouldStartIdleMarkSweep(deadline) ||
-             old_space_.ReachedSoftThreshold()) {
-    // If we have both work to do and enough time, start or finish GC.
-    // If we have crossed the soft threshold, ignore time; the next old-space
-    // allocation will trigger this work anyway, so we try to pay at least some
-    // of that cost with idle time.
-    // Blocks for O(roots).
+  } else {
     PageSpace::Phase phase;
     {
       MonitorLocker ml(old_space_.tasks_lock());
       phase = old_space_.phase();
     }
+    if (phase == PageSpace::kMarking) {
+      // NotifyIdle already waited for marking as long as the deadline allows.
+      return;
+    }
+    if ((phase != PageSpace::kAwaitingFinalization) &&
+        !old_space_.ShouldStartIdleMarkSweep(deadline) &&
+        !old_space_.ReachedSoftThreshold()) {
+      return;
+    }
+    // If we have both work to do and enough time, start or finish GC.
+    // If we have crossed the soft threshold, ignore time; the next old-space
+    // allocation will trigger this work anyway, so we try to pay at least some
+    // of that cost with idle time.
+    // Blocks for O(roots).
     if (phase == PageSpace::kAwaitingFinalization) {
       TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
       CollectOldSpaceGarbage(thread, Heap::kMarkSweep, Heap::kFinalize);
@@ -435,6 +478,7 @@ void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
   }
   {
     SafepointOperationScope safepoint_operation(thread);
+    GCCpuAccountingScope gc_cpu_accounting(thread);
     RecordBeforeGC(kScavenge, reason);
     VMTagScope tagScope(thread, reason == kIdle ? VMTag::kGCIdleTagId
                                                 : VMTag::kGCNewSpaceTagId);
@@ -459,6 +503,7 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
   }
   {
     SafepointOperationScope safepoint_operation(thread);
+    GCCpuAccountingScope gc_cpu_accounting(thread);
     RecordBeforeGC(kScavenge, reason);
     {
       VMTagScope tagScope(thread, reason == kIdle ? VMTag::kGCIdleTagId
@@ -499,6 +544,7 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
   }
   {
     SafepointOperationScope safepoint_operation(thread);
+    GCCpuAccountingScope gc_cpu_accounting(thread);
     thread->isolate_group()->ForEachIsolate(
         [&](Isolate* isolate) {
           // Discard regexp backtracking stacks to further reduce memory usage.
@@ -527,6 +573,11 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
   }
 }
 
+void Heap::ScheduleFinalizers(Thread* thread) {
+  ASSERT(!isolate_group_->safepoint_handler()->IsOwnedByTheThread(thread));
+  isolate_group_->api_state()->ScheduleFinalizers(isolate_group_);
+}
+
 void Heap::CollectGarbage(GCType type, GCReason reason) {
   Thread* thread = Thread::Current();
   switch (type) {
@@ -604,6 +655,7 @@ void Heap::CheckStartConcurrentMarking(Thread* thread, GCReason reason) {
 
 void Heap::StartConcurrentMarking(Thread* thread) {
   TIMELINE_FUNCTION_GC_DURATION_BASIC(thread, "StartConcurrentMarking");
+  DART_USDT0(concurrent__mark__start);
   old_space_.CollectGarbage(/*compact=*/false, /*finalize=*/false);
 }
 
@@ -915,6 +967,16 @@ void Heap::SetWeakEntry(ObjectPtr raw_obj, WeakSelector sel, intptr_t val) {
   }
 }
 
+intptr_t Heap::SetWeakEntryIfNonExistent(ObjectPtr raw_obj,
+                                         WeakSelector sel,
+                                         intptr_t val) {
+  if (raw_obj->IsNewObject()) {
+    return new_weak_tables_[sel]->SetValueIfNonExistent(raw_obj, val);
+  }
+  ASSERT(raw_obj->IsOldObject());
+  return old_weak_tables_[sel]->SetValueIfNonExistent(raw_obj, val);
+}
+
 void Heap::ForwardWeakEntries(ObjectPtr before_object, ObjectPtr after_object) {
   const auto before_space =
       before_object->IsNewObject() ? Heap::kNew : Heap::kOld;
@@ -978,6 +1040,13 @@ void Heap::PrintMemoryUsageJSON(JSONObject* jsobj) const {
   jsobj->AddProperty64("heapUsage", TotalUsedInWords() * kWordSize);
   jsobj->AddProperty64("heapCapacity", TotalCapacityInWords() * kWordSize);
   jsobj->AddProperty64("externalUsage", TotalExternalInWords() * kWordSize);
+  {
+    JSONObject pauses(jsobj, "_gcPauses");
+    isolate_group_->GetHeapNewPauseMetric()->PrintHistogramJSON(&pauses,
+                                                                "new");
+    isolate_group_->GetHeapOldPauseMetric()->PrintHistogramJSON(&pauses,
+                                                                "old");
+  }
 }
 #endif  // PRODUCT
 
@@ -992,6 +1061,7 @@ void Heap::RecordBeforeGC(GCType type, GCReason reason) {
     stats_.times_[i] = 0;
   for (int i = 0; i < GCStats::kDataEntries; i++)
     stats_.data_[i] = 0;
+  DART_USDT2(gc__start, static_cast<int>(type), static_cast<int>(reason));
 }
 
 static double AvgCollectionPeriod(int64_t run_time, intptr_t collections) {
@@ -1005,12 +1075,15 @@ static double AvgCollectionPeriod(int64_t run_time, intptr_t collections) {
 void Heap::RecordAfterGC(GCType type) {
   stats_.after_.micros_ = OS::GetCurrentMonotonicMicros();
   int64_t delta = stats_.after_.micros_ - stats_.before_.micros_;
+  DART_USDT2(gc__end, static_cast<int>(type), delta);
   if (stats_.type_ == kScavenge) {
     new_space_.AddGCTime(delta);
     new_space_.IncrementCollections();
+    isolate_group_->GetHeapNewPauseMetric()->Add(delta);
   } else {
     old_space_.AddGCTime(delta);
     old_space_.IncrementCollections();
+    isolate_group_->GetHeapOldPauseMetric()->Add(delta);
   }
   stats_.after_.new_ = new_space_.GetCurrentUsage();
   stats_.after_.old_ = old_space_.GetCurrentUsage();
@@ -1181,6 +1254,61 @@ void Heap::PrintStatsToTimeline(TimelineEventScope* event, GCReason reason) {
                         RoundWordsToKB(stats_.before_.old_.external_in_words));
   event->FormatArgument(arguments + 12, "After.Old.External (kB)", "%" Pd "",
                         RoundWordsToKB(stats_.after_.old_.external_in_words));
+
+  // Per-phase times and counters. The names follow the Scavenger and
+  // PageSpace ids for GCStats entries; unused entries are nullptr.
+  static const char* const kScavengeTimeNames[GCStats::kTimeEntries] = {
+      nullptr,
+      "SafePoint (ms)",
+      "Roots (ms)",
+      "StoreBuffer (ms)",
+      "ToSpace (ms)",
+      "Weaks (ms)",
+  };
+  static const char* const kScavengeDataNames[GCStats::kDataEntries] = {
+      "StoreBufferEntries",
+      "RememberedCards",
+      "CardRememberedArrays",
+      nullptr,
+  };
+  static const char* const kMarkSweepTimeNames[GCStats::kTimeEntries] = {
+      "WaitForSweepers (ms)",
+      "SafePoint (ms)",
+      "Mark (ms)",
+      "ResetFreeLists (ms)",
+      "SweepExecutable (ms)",
+      "SweepOrCompact (ms)",
+  };
+  static const char* const kMarkSweepDataNames[GCStats::kDataEntries] = {
+      "GarbageRatio",
+      "GCTimeFraction",
+      "PageGrowth",
+      nullptr,
+  };
+  const bool is_scavenge = stats_.type_ == kScavenge;
+  const char* const* time_names =
+      is_scavenge ? kScavengeTimeNames : kMarkSweepTimeNames;
+  const char* const* data_names =
+      is_scavenge ? kScavengeDataNames : kMarkSweepDataNames;
+  intptr_t phase_arguments = 0;
+  for (intptr_t i = 0; i < GCStats::kTimeEntries; i++) {
+    if (time_names[i] != nullptr) phase_arguments++;
+  }
+  for (intptr_t i = 0; i < GCStats::kDataEntries; i++) {
+    if (data_names[i] != nullptr) phase_arguments++;
+  }
+  arguments = event->GetNumArguments();
+  event->SetNumArguments(arguments + phase_arguments);
+  for (intptr_t i = 0; i < GCStats::kTimeEntries; i++) {
+    if (time_names[i] == nullptr) continue;
+    event->FormatArgument(arguments++, time_names[i], "%.3f",
+                          MicrosecondsToMilliseconds(stats_.times_[i]));
+  }
+  for (intptr_t i = 0; i < GCStats::kDataEntries; i++) {
+    if (data_names[i] == nullptr) continue;
+    event->FormatArgument(arguments++, data_names[i], "%" Pd "",
+                          stats_.data_[i]);
+  }
 #endif  // !defined(PRODUCT)
 }
 
@@ -151,6 +151,11 @@ class Heap {
   void WaitForSweeperTasks(Thread* thread);
   void WaitForSweeperTasksAtSafepoint(Thread* thread);
 
+  // Runs the finalizers queued by --concurrent_finalizers collections. Called
+  // when the outermost safepoint operation ends, so that the finalizers of a
+  // collection nested in another safepoint operation never extend its pause.
+  void ScheduleFinalizers(Thread* thread);
+
   // Enables growth control on the page space heaps.  This should be
   // called before any user code is executed.
   void InitGrowthControl();
@@ -216,6 +221,11 @@ class Heap {
   intptr_t GetHash(ObjectPtr raw_obj) const {
     return GetWeakEntry(raw_obj, kIdentityHashes);
   }
+  // Returns the hashCode of |raw_obj|, associating |hash| with it first if it
+  // has none yet.
+  intptr_t SetHashIfNotSet(ObjectPtr raw_obj, intptr_t hash) {
+    return SetWeakEntryIfNonExistent(raw_obj, kIdentityHashes, hash);
+  }
 #endif
 
   void SetCanonicalHash(ObjectPtr raw_obj, intptr_t hash) {
@@ -250,6 +260,9 @@ class Heap {
   // Used by the GC algorithms to propagate weak entries.
   intptr_t GetWeakEntry(ObjectPtr raw_obj, WeakSelector sel) const;
   void SetWeakEntry(ObjectPtr raw_obj, WeakSelector sel, intptr_t val);
+  intptr_t SetWeakEntryIfNonExistent(ObjectPtr raw_obj,
+                                     WeakSelector sel,
+                                     intptr_t val);
 
   WeakTable* GetWeakTable(Space space, WeakSelector selector) const {
     if (space == kNew) {
@@ -379,6 +392,7 @@ class Heap {
   bool VerifyGC(MarkExpectation mark_expectation = kForbidMarked);
 
   // Helper functions for garbage collection.
+  void CollectIdleGarbage(Thread* thread, int64_t deadline);
   void CollectNewSpaceGarbage(Thread* thread, GCReason reason);
   void CollectOldSpaceGarbage(Thread* thread, GCType type, GCReason reason);
   void EvacuateNewSpace(Thread* thread, GCReason reason);
@@ -15,6 +15,7 @@
 #include "vm/globals.h"
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
+#include "vm/heap/work_stealing_deque.h"
 #include "vm/message_handler.h"
 #include "vm/object_graph.h"
 #include "vm/port.h"
@@ -23,6 +24,12 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, incremental_compaction);
+DECLARE_FLAG(bool, old_space_tlabs);
+DECLARE_FLAG(int, marker_tasks);
+DECLARE_FLAG(bool, card_mark_large_arrays);
+DECLARE_FLAG(bool, collect_code);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -89,6 +96,32 @@ TEST_CASE(LargeSweep) {
   }
 }
 
+static void TestLargePageRelease(Thread* thread) {
+  PageSpace* old_space = thread->heap()->old_space();
+  GCTestHelper::CollectOldSpace();
+  const intptr_t capacity_before = old_space->CapacityInWords();
+  {
+    HANDLESCOPE(thread);
+    Array& array = Array::Handle();
+    for (intptr_t i = 0; i < 8; i++) {
+      array = Array::New(MB, Heap::kOld);
+    }
+    EXPECT_LT(capacity_before + 8 * MBInWords, old_space->CapacityInWords());
+  }
+  GCTestHelper::CollectOldSpace();
+  EXPECT_LE(old_space->CapacityInWords(), capacity_before);
+}
+
+ISOLATE_UNIT_TEST_CASE(LargeSweep_ReleasePages) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_sweep, false);
+  TestLargePageRelease(thread);
+}
+
+ISOLATE_UNIT_TEST_CASE(LargeSweep_ReleasePagesConcurrently) {
+  SetFlagScope<bool> sfs(&FLAG_concurrent_sweep, true);
+  TestLargePageRelease(thread);
+}
+
 #ifndef PRODUCT
 static ClassPtr GetClass(const Library& lib, const char* name) {
   const Class& cls = Class::Handle(
@@ -358,6 +391,188 @@ ISOLATE_UNIT_TEST_CASE(BecomeForwardRememberedObject) {
   EXPECT(before_obj.raw() == after_obj.raw());
 }
 
+ISOLATE_UNIT_TEST_CASE(BecomeForwardParallel) {
+  SetFlagScope<int> sfs(&FLAG_become_tasks, 4);
+  const String& before_obj = String::Handle(String::New("old", Heap::kOld));
+  const String& after_obj = String::Handle(String::New("new", Heap::kNew));
+
+  // Spread the references to the forwarded object over many pages, so that
+  // they are visited by different tasks.
+  const intptr_t kNumArrays = 4 * KB;
+  const Array& referrers = Array::Handle(Array::New(kNumArrays, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(16, Heap::kOld);
+    element.SetAt(0, before_obj);
+    referrers.SetAt(i, element);
+  }
+
+  const Array& before = Array::Handle(Array::New(1, Heap::kOld));
+  before.SetAt(0, before_obj);
+  const Array& after = Array::Handle(Array::New(1, Heap::kOld));
+  after.SetAt(0, after_obj);
+
+  Become::ElementsForwardIdentity(before, after);
+
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element ^= referrers.At(i);
+    EXPECT(element.At(0) == after_obj.raw());
+    EXPECT(element.raw()->ptr()->IsRemembered());
+  }
+
+  GCTestHelper::CollectAllGarbage();
+
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element ^= referrers.At(i);
+    EXPECT(element.At(0) == after_obj.raw());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(IncrementalCompaction) {
+  SetFlagScope<bool> sfs(&FLAG_incremental_compaction, true);
+  Heap* heap = thread->heap();
+
+  // Fill several pages and keep only every 16th array alive so the next sweep
+  // records them as mostly empty.
+  const intptr_t kNumArrays = 16 * KB;
+  const intptr_t kStride = 16;
+  const Array& survivors =
+      Array::Handle(Array::New(kNumArrays / kStride, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumArrays; i++) {
+    element = Array::New(kStride, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    if ((i % kStride) == 0) {
+      survivors.SetAt(i / kStride, element);
+    }
+  }
+  element = Array::null();
+  GCTestHelper::CollectOldSpace();
+  intptr_t capacity_before = heap->old_space()->CapacityInWords();
+
+  // The fragmented pages are evacuated by the next full collection.
+  GCTestHelper::CollectOldSpace();
+  EXPECT_LT(heap->old_space()->CapacityInWords(), capacity_before);
+
+  Smi& value = Smi::Handle();
+  for (intptr_t i = 0; i < kNumArrays / kStride; i++) {
+    element ^= survivors.At(i);
+    value ^= element.At(0);
+    EXPECT_EQ(i * kStride, value.Value());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(OldSpaceTLAB) {
+  SetFlagScope<bool> sfs(&FLAG_old_space_tlabs, true);
+  Heap* heap = thread->heap();
+  PageSpace* old_space = heap->old_space();
+
+  // The buffer is only refilled from a free block of at least kTLABSize;
+  // allocate until the freelist or a fresh page provides one.
+  Array& first = Array::Handle();
+  for (intptr_t i = 0; (i < 1000) && (thread->old_top() == 0); i++) {
+    first = Array::New(4, Heap::kOld);
+  }
+  EXPECT(thread->old_top() != 0);
+  first = Array::New(4, Heap::kOld);
+  const Array& second = Array::Handle(Array::New(4, Heap::kOld));
+  const intptr_t size = first.raw()->ptr()->HeapSize();
+  // Both arrays come from the same buffer.
+  EXPECT_EQ(ObjectLayout::ToAddr(first.raw()) + size,
+            ObjectLayout::ToAddr(second.raw()));
+  EXPECT_EQ(ObjectLayout::ToAddr(second.raw()) + size, thread->old_top());
+
+  // A full collection returns the rest of the buffer to the freelist.
+  GCTestHelper::CollectOldSpace();
+  EXPECT_EQ(0, thread->old_top());
+  EXPECT_EQ(0, thread->old_end());
+  EXPECT_EQ(4, first.Length());
+  EXPECT_EQ(4, second.Length());
+
+  old_space->AbandonTLAB(thread);
+}
+
+TEST_CASE(WorkStealingDeque) {
+  WorkStealingDeque<intptr_t, 4> deque;
+  intptr_t value = 0;
+  EXPECT(deque.IsEmpty());
+  EXPECT(!deque.Pop(&value));
+  EXPECT(!deque.Steal(&value));
+
+  for (intptr_t i = 1; i <= 4; i++) {
+    EXPECT(deque.Push(i));
+  }
+  EXPECT(!deque.Push(5));  // Full.
+
+  // The owner works LIFO, thieves take the oldest values.
+  EXPECT(deque.Pop(&value));
+  EXPECT_EQ(4, value);
+  EXPECT(deque.Steal(&value));
+  EXPECT_EQ(1, value);
+  EXPECT(deque.Push(6));
+  EXPECT(deque.Steal(&value));
+  EXPECT_EQ(2, value);
+  EXPECT(deque.Pop(&value));
+  EXPECT_EQ(6, value);
+  EXPECT(deque.Pop(&value));
+  EXPECT_EQ(3, value);
+  EXPECT(!deque.Pop(&value));
+  EXPECT(deque.IsEmpty());
+}
+
+ISOLATE_UNIT_TEST_CASE(ParallelMarkLargeArray) {
+  SetFlagScope<int> sfs(&FLAG_marker_tasks, 4);
+
+  // Large enough to be split into slices that the other tasks steal.
+  const intptr_t kLength = 64 * KB;
+  const Array& array = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    element = Array::New(1, Heap::kOld);
+    element.SetAt(0, Smi::Handle(Smi::New(i)));
+    array.SetAt(i, element);
+  }
+  GCTestHelper::CollectOldSpace();
+  GCTestHelper::CollectOldSpace();
+
+  Smi& value = Smi::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    element ^= array.At(i);
+    value ^= element.At(0);
+    EXPECT_EQ(i, value.Value());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(CardRememberLargeArray) {
+  SetFlagScope<bool> sfs(&FLAG_card_mark_large_arrays, true);
+
+  // Too big for the freelists, but not big enough to start out card marked.
+  const intptr_t kLength = 16 * KB;
+  const Array& array = Array::Handle(Array::New(kLength, Heap::kOld));
+  EXPECT(!array.raw()->ptr()->IsCardRemembered());
+
+  String& str = String::Handle(String::New("first", Heap::kNew));
+  array.SetAt(kLength - 1, str);
+  EXPECT(array.raw()->ptr()->IsRemembered());
+
+  // The scavenge switches the array to card remembering.
+  GCTestHelper::CollectNewSpace();
+  EXPECT(array.raw()->ptr()->IsCardRemembered());
+  EXPECT(!array.raw()->ptr()->IsRemembered());
+
+  // Further stores of new objects only remember their card.
+  str = String::New("second", Heap::kNew);
+  array.SetAt(0, str);
+  EXPECT(!array.raw()->ptr()->IsRemembered());
+  GCTestHelper::CollectNewSpace();
+  GCTestHelper::CollectNewSpace();
+
+  str ^= array.At(0);
+  EXPECT(str.Equals("second"));
+  str ^= array.At(kLength - 1);
+  EXPECT(str.Equals("first"));
+}
+
 ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_DeadOldToNew) {
   Isolate* isolate = Isolate::Current();
   Heap* heap = isolate->heap();
@@ -819,4 +1034,168 @@ ISOLATE_UNIT_TEST_CASE(ArrayTruncationRaces) {
   }
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+ISOLATE_UNIT_TEST_CASE(CollectCode) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  static foo() { return 42; }\n"
+      "}\n";
+  Dart_Handle library;
+  {
+    TransitionVMToNative transition(thread);
+    library = TestCase::LoadTestScript(kScriptChars, NULL);
+  }
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(library)));
+  EXPECT(ClassFinalizer::ProcessPendingClasses());
+  const Class& cls =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  EXPECT(!cls.IsNull());
+  EXPECT(cls.EnsureIsFinalized(thread) == Error::null());
+  const Function& func = Function::Handle(
+      cls.LookupStaticFunction(String::Handle(String::New("foo"))));
+  {
+    // Do not keep the code alive through a handle.
+    HANDLESCOPE(thread);
+    EXPECT(CompilerTest::TestCompileFunction(func));
+  }
+  EXPECT(func.HasCode());
+
+  SetFlagScope<bool> sfs(&FLAG_collect_code, true);
+  Metric* metric = thread->isolate_group()->GetHeapCodeCollectedMetric();
+  const int64_t collected_before = metric->value();
+
+  // The code ages out once the usage counter has been halved to zero.
+  func.SetUsageCounter(1);
+  GCTestHelper::CollectOldSpace();
+  EXPECT(func.HasCode());
+  EXPECT_EQ(0, func.usage_counter());
+  GCTestHelper::CollectOldSpace();
+  EXPECT(!func.HasCode());
+  EXPECT(metric->value() > collected_before);
+
+  // The function is compiled again on demand.
+  {
+    HANDLESCOPE(thread);
+    EXPECT(CompilerTest::TestCompileFunction(func));
+  }
+  EXPECT(func.HasCode());
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+// Builds a chain of [length] weak properties in which the value of each one is
+// the key of the next one, stored in reverse order in the returned array.
+static ArrayPtr NewWeakPropertyChain(intptr_t length, Array* head_key) {
+  HANDLESCOPE(Thread::Current());
+  const auto& weak_properties = Array::Handle(Array::New(length, Heap::kOld));
+  auto& weak_property = WeakProperty::Handle();
+  auto& key = Array::Handle(Array::New(1, Heap::kOld));
+  auto& next_key = Array::Handle();
+  *head_key = key.raw();
+  for (intptr_t i = 0; i < length; i++) {
+    next_key = Array::New(1, Heap::kOld);
+    weak_property = WeakProperty::New(Heap::kOld);
+    weak_property.set_key(key);
+    weak_property.set_value(next_key);
+    weak_properties.SetAt(length - 1 - i, weak_property);
+    key = next_key.raw();
+  }
+  return weak_properties.raw();
+}
+
+ISOLATE_UNIT_TEST_CASE(WeakPropertyChain) {
+  const intptr_t kLength = 100;
+  auto& live_head = Array::Handle();
+  auto& dead_head = Array::Handle();
+  const auto& live = Array::Handle(NewWeakPropertyChain(kLength, &live_head));
+  const auto& dead = Array::Handle(NewWeakPropertyChain(kLength, &dead_head));
+  dead_head = Array::null();
+
+  GCTestHelper::CollectOldSpace();
+
+  // Marking the first key of the live chain made every value reachable, one
+  // weak property after the other.
+  auto& weak_property = WeakProperty::Handle();
+  auto& key = Object::Handle(live_head.raw());
+  for (intptr_t i = kLength - 1; i >= 0; i--) {
+    weak_property ^= live.At(i);
+    EXPECT(weak_property.key() == key.raw());
+    EXPECT(weak_property.value() != Object::null());
+    key = weak_property.value();
+  }
+  // The keys of the other chain were only reachable through its values.
+  for (intptr_t i = 0; i < kLength; i++) {
+    weak_property ^= dead.At(i);
+    EXPECT(weak_property.key() == Object::null());
+    EXPECT(weak_property.value() == Object::null());
+  }
+}
+
+// The idle deadline expires while concurrent marking is still running: the
+// idle notification must give up waiting and leave marking to finish later.
+ISOLATE_UNIT_TEST_CASE(IdleDeadlineExpiresDuringMarking) {
+  Heap* heap = thread->heap();
+  PageSpace* old_space = heap->old_space();
+  heap->WaitForMarkerTasks(thread);
+  heap->WaitForSweeperTasks(thread);
+
+  // Pretend a marker is running for longer than any deadline.
+  {
+    MonitorLocker ml(old_space->tasks_lock());
+    EXPECT_EQ(PageSpace::kDone, old_space->phase());
+    old_space->set_phase(PageSpace::kMarking);
+  }
+
+  const int64_t deadline =
+      OS::GetCurrentMonotonicMicros() + 10 * kMicrosecondsPerMillisecond;
+  EXPECT(!old_space->WaitForIdleMarking(thread, deadline));
+  EXPECT(OS::GetCurrentMonotonicMicros() < deadline + kMicrosecondsPerSecond);
+
+  // An expired deadline neither waits nor finalizes the marking.
+  heap->NotifyIdle(OS::GetCurrentMonotonicMicros());
+  {
+    MonitorLocker ml(old_space->tasks_lock());
+    EXPECT_EQ(PageSpace::kMarking, old_space->phase());
+    old_space->set_phase(PageSpace::kDone);
+  }
+}
+
+// Concurrent marking outlives an expired idle deadline and is finalized by a
+// later idle notification with enough time left.
+ISOLATE_UNIT_TEST_CASE(IdleMarkingFinishesAfterExpiredDeadline) {
+  Heap* heap = thread->heap();
+  PageSpace* old_space = heap->old_space();
+  heap->WaitForMarkerTasks(thread);
+  heap->WaitForSweeperTasks(thread);
+
+  const auto& array = Array::Handle(Array::New(100, Heap::kOld));
+  heap->StartConcurrentMarking(thread);
+  heap->NotifyIdle(OS::GetCurrentMonotonicMicros());
+
+  heap->NotifyIdle(OS::GetCurrentMonotonicMicros() +
+                   10 * kMicrosecondsPerSecond);
+  heap->WaitForSweeperTasks(thread);
+  {
+    MonitorLocker ml(old_space->tasks_lock());
+    EXPECT_EQ(PageSpace::kDone, old_space->phase());
+  }
+  EXPECT_EQ(100, array.Length());
+}
+
+ISOLATE_UNIT_TEST_CASE(SetHashIfNotSet) {
+  const Array& array = Array::Handle(Array::New(1));
+#if defined(HASH_IN_OBJECT_HEADER)
+  EXPECT_EQ(0U, Object::GetCachedHash(array.raw()));
+  EXPECT_EQ(42U, Object::SetCachedHashIfNotSet(array.raw(), 42));
+  EXPECT_EQ(42U, Object::SetCachedHashIfNotSet(array.raw(), 7));
+  EXPECT_EQ(42U, Object::GetCachedHash(array.raw()));
+#else
+  Heap* heap = thread->isolate()->heap();
+  EXPECT_EQ(0, heap->GetHash(array.raw()));
+  EXPECT_EQ(42, heap->SetHashIfNotSet(array.raw(), 42));
+  EXPECT_EQ(42, heap->SetHashIfNotSet(array.raw(), 7));
+  EXPECT_EQ(42, heap->GetHash(array.raw()));
+#endif
+}
+
 }  // namespace dart
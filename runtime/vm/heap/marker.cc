@@ -7,13 +7,16 @@
 #include "platform/atomic.h"
 #include "vm/allocation.h"
 #include "vm/dart_api_state.h"
+#include "vm/hash_map.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/pointer_block.h"
+#include "vm/heap/work_stealing_deque.h"
 #include "vm/isolate.h"
 #include "vm/log.h"
 #include "vm/object_id_ring.h"
 #include "vm/raw_object.h"
 #include "vm/stack_frame.h"
+#include "vm/stub_code.h"
 #include "vm/thread_barrier.h"
 #include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
@@ -22,21 +25,272 @@
 
 namespace dart {
 
+// A range [start, end) of the elements of a large array, split off so that
+// another marker task can visit it.
+class ArraySlice {
+ public:
+  ArraySlice() : array_(nullptr), start_(0), end_(0) {}
+  ArraySlice(ArrayPtr array, intptr_t start, intptr_t end)
+      : array_(array), start_(start), end_(end) {}
+
+  ArrayPtr array() const { return array_; }
+  intptr_t start() const { return start_; }
+  intptr_t end() const { return end_; }
+
+ private:
+  ArrayPtr array_;
+  intptr_t start_;
+  intptr_t end_;
+};
+
+// The work one marker task offers to the other marker tasks. Only the owning
+// task pushes and pops; the others steal.
+//
+// Slices are kept in a pool of slots owned by the queue, so offering one
+// allocates nothing. The deque holds slot indices. A slot is in use from the
+// push until the task which popped or stole it has copied the slice out.
+class MarkerTaskQueue {
+ public:
+  static const intptr_t kCapacity = 256;
+
+  typedef WorkStealingDeque<MarkingStackBlock*, kCapacity> BlockDeque;
+
+  MarkerTaskQueue() : blocks_(), slices_(), next_slot_(0) {
+    for (intptr_t i = 0; i < kCapacity; i++) {
+      slot_in_use_[i].store(false, std::memory_order_relaxed);
+    }
+  }
+
+  BlockDeque* blocks() { return &blocks_; }
+
+  bool IsEmpty() const { return blocks_.IsEmpty() && slices_.IsEmpty(); }
+
+  // Owner only. Returns false if no slot is free or the deque is full.
+  bool PushSlice(const ArraySlice& slice) {
+    for (intptr_t i = 0; i < kCapacity; i++) {
+      const intptr_t slot = (next_slot_ + i) & (kCapacity - 1);
+      if (slot_in_use_[slot].load(std::memory_order_acquire)) {
+        continue;
+      }
+      slots_[slot] = slice;
+      slot_in_use_[slot].store(true, std::memory_order_relaxed);
+      if (!slices_.Push(slot)) {
+        slot_in_use_[slot].store(false, std::memory_order_relaxed);
+        return false;
+      }
+      next_slot_ = slot + 1;
+      return true;
+    }
+    return false;
+  }
+
+  // Owner only.
+  bool PopSlice(ArraySlice* slice) {
+    intptr_t slot;
+    if (!slices_.Pop(&slot)) {
+      return false;
+    }
+    Release(slot, slice);
+    return true;
+  }
+
+  // Any task.
+  bool StealSlice(ArraySlice* slice) {
+    intptr_t slot;
+    if (!slices_.Steal(&slot)) {
+      return false;
+    }
+    Release(slot, slice);
+    return true;
+  }
+
+ private:
+  typedef WorkStealingDeque<intptr_t, kCapacity> SliceDeque;
+
+  void Release(intptr_t slot, ArraySlice* slice) {
+    *slice = slots_[slot];
+    slot_in_use_[slot].store(false, std::memory_order_release);
+  }
+
+  BlockDeque blocks_;
+  SliceDeque slices_;
+  ArraySlice slots_[kCapacity];
+  std::atomic<bool> slot_in_use_[kCapacity];
+  // Owner only, where to start looking for a free slot.
+  intptr_t next_slot_;
+
+  DISALLOW_COPY_AND_ASSIGN(MarkerTaskQueue);
+};
+
+// Like MarkerWorkList, but full blocks are published to the task's own queue
+// before falling back to the shared marking stack, so that pushing and popping
+// requires no lock in the common case. The shared stack still receives the
+// blocks of the write barrier. Without a queue (single-threaded marking) this
+// behaves exactly like MarkerWorkList.
+class MarkingWorkList : public ValueObject {
+ public:
+  typedef MarkingStack::Block Block;
+
+  MarkingWorkList(MarkingStack* stack,
+                  MarkerTaskQueue* queues,
+                  intptr_t num_queues,
+                  intptr_t index)
+      : stack_(stack),
+        queues_(queues),
+        num_queues_(num_queues),
+        index_(index),
+        queue_(queues == nullptr ? nullptr : &queues[index]),
+        blocks_stolen_(0) {
+    work_ = stack_->PopEmptyBlock();
+  }
+
+  ~MarkingWorkList() {
+    ASSERT(work_ == nullptr);
+    ASSERT(stack_ == nullptr);
+  }
+
+  intptr_t blocks_stolen() const { return blocks_stolen_; }
+
+  // Returns nullptr if neither this task's queue nor the shared marking stack
+  // have any more work. Does not steal.
+  ObjectPtr Pop() {
+    ASSERT(work_ != nullptr);
+    if (work_->IsEmpty()) {
+      Block* new_work = nullptr;
+      if ((queue_ == nullptr) || !queue_->blocks()->Pop(&new_work)) {
+        new_work = stack_->PopNonEmptyBlock();
+        if (new_work == nullptr) {
+          return nullptr;
+        }
+      }
+      SetWork(new_work);
+    }
+    return work_->Pop();
+  }
+
+  // Steals a block from another task's queue. Returns false if none was
+  // found, in which case Pop will keep returning nullptr.
+  bool Steal() {
+    ASSERT(work_->IsEmpty());
+    for (intptr_t i = 1; i < num_queues_; i++) {
+      MarkerTaskQueue* victim = &queues_[(index_ + i) % num_queues_];
+      Block* new_work = nullptr;
+      if (victim->blocks()->Steal(&new_work)) {
+        blocks_stolen_++;
+        SetWork(new_work);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Push(ObjectPtr raw_obj) {
+    if (work_->IsFull()) {
+      if ((queue_ == nullptr) || !queue_->blocks()->Push(work_)) {
+        stack_->PushBlock(work_);
+      }
+      work_ = stack_->PopEmptyBlock();
+    }
+    work_->Push(raw_obj);
+  }
+
+  void Finalize() {
+    ASSERT(work_->IsEmpty());
+    ASSERT((queue_ == nullptr) || queue_->blocks()->IsEmpty());
+    stack_->PushBlock(work_);
+    work_ = nullptr;
+    // Fail fast on attempts to mark after finalizing.
+    stack_ = nullptr;
+  }
+
+  void AbandonWork() {
+    stack_->PushBlock(work_);
+    work_ = nullptr;
+    if (queue_ != nullptr) {
+      Block* block = nullptr;
+      while (queue_->blocks()->Pop(&block)) {
+        stack_->PushBlock(block);
+      }
+    }
+    stack_ = nullptr;
+  }
+
+ private:
+  void SetWork(Block* new_work) {
+    stack_->PushBlock(work_);
+    work_ = new_work;
+    // Generated code appends to marking stacks; tell MemorySanitizer.
+    MSAN_UNPOISON(work_, sizeof(*work_));
+  }
+
+  Block* work_;
+  MarkingStack* stack_;
+  MarkerTaskQueue* const queues_;
+  const intptr_t num_queues_;
+  const intptr_t index_;
+  MarkerTaskQueue* const queue_;
+  intptr_t blocks_stolen_;
+
+  DISALLOW_COPY_AND_ASSIGN(MarkingWorkList);
+};
+
+// Maps a white key to the chain of pending weak properties with that key,
+// linked through their next_ fields.
+class PendingWeakPropertiesTrait {
+ public:
+  typedef ObjectPtr Key;
+  typedef WeakPropertyPtr Value;
+
+  struct Pair {
+    Key key;
+    Value value;
+    Pair() : key(nullptr), value(nullptr) {}
+    Pair(const Key key, const Value& value) : key(key), value(value) {}
+    Pair(const Pair& other) : key(other.key), value(other.value) {}
+    Pair& operator=(const Pair&) = default;
+  };
+
+  static Key KeyOf(Pair kv) { return kv.key; }
+  static Value ValueOf(Pair kv) { return kv.value; }
+  static intptr_t Hashcode(Key key) {
+    return static_cast<uword>(key) >> kObjectAlignmentLog2;
+  }
+  static bool IsKeyEqual(Pair kv, Key key) { return kv.key == key; }
+};
+
+typedef MallocDirectChainedHashMap<PendingWeakPropertiesTrait>
+    PendingWeakPropertiesMap;
+
 template <bool sync>
 class MarkingVisitorBase : public ObjectPointerVisitor {
  public:
+  // Arrays with more elements than this are visited in slices that idle
+  // marker tasks can steal.
+  static const intptr_t kArraySliceLength = 1024;
+
   MarkingVisitorBase(IsolateGroup* isolate_group,
                      PageSpace* page_space,
                      MarkingStack* marking_stack,
-                     MarkingStack* deferred_marking_stack)
+                     MarkingStack* deferred_marking_stack,
+                     MarkerTaskQueue* task_queues,
+                     intptr_t num_task_queues,
+                     intptr_t task_index)
       : ObjectPointerVisitor(isolate_group),
         thread_(Thread::Current()),
         page_space_(page_space),
-        work_list_(marking_stack),
+        work_list_(marking_stack, task_queues, num_task_queues, task_index),
         deferred_work_list_(deferred_marking_stack),
-        delayed_weak_properties_(nullptr),
+        task_queues_(task_queues),
+        num_task_queues_(num_task_queues),
+        task_index_(task_index),
+        task_queue_(task_queues == nullptr ? nullptr
+                                           : &task_queues[task_index]),
+        pending_weak_properties_(),
+        collect_code_(ShouldCollectCode(isolate_group)),
+        skipped_code_functions_(),
         marked_bytes_(0),
-        marked_micros_(0) {
+        marked_micros_(0),
+        slices_stolen_(0) {
     ASSERT(thread_->isolate_group() == isolate_group);
   }
   ~MarkingVisitorBase() {}
@@ -44,38 +298,67 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   uintptr_t marked_bytes() const { return marked_bytes_; }
   int64_t marked_micros() const { return marked_micros_; }
   void AddMicros(int64_t micros) { marked_micros_ += micros; }
+  intptr_t blocks_stolen() const { return work_list_.blocks_stolen(); }
+  intptr_t slices_stolen() const { return slices_stolen_; }
 
+  // Visits the pending weak properties whose keys have been marked since
+  // they were enqueued, e.g. by another marker task. Returns true if this
+  // marked any of their values.
   bool ProcessPendingWeakProperties() {
+    if (pending_weak_properties_.IsEmpty()) {
+      return false;
+    }
+    // Collect the keys first so that the map is not modified while it is
+    // being iterated.
+    MallocGrowableArray<ObjectPtr> marked_keys;
+    PendingWeakPropertiesMap::Iterator it =
+        pending_weak_properties_.GetIterator();
+    PendingWeakPropertiesTrait::Pair* pair;
+    while ((pair = it.Next()) != nullptr) {
+      if (pair->key->ptr()->IsMarked()) {
+        marked_keys.Add(pair->key);
+      }
+    }
+    bool marked = false;
+    for (intptr_t i = 0; i < marked_keys.length(); i++) {
+      marked = ProcessWeakPropertiesWithKey(marked_keys[i]) || marked;
+    }
+    return marked;
+  }
+
+  // Visits all pending weak properties with the (now marked) key [raw_key].
+  // Returns true if this marked any of their values.
+  bool ProcessWeakPropertiesWithKey(ObjectPtr raw_key) {
+    PendingWeakPropertiesTrait::Pair* pair =
+        pending_weak_properties_.Lookup(raw_key);
+    if (pair == nullptr) {
+      return false;
+    }
+    WeakPropertyPtr cur_weak = pair->value;
+    pending_weak_properties_.Remove(raw_key);
     bool marked = false;
-    WeakPropertyPtr cur_weak = delayed_weak_properties_;
-    delayed_weak_properties_ = nullptr;
     while (cur_weak != nullptr) {
       uword next_weak = cur_weak->ptr()->next_;
-      ObjectPtr raw_key = cur_weak->ptr()->key_;
+      ASSERT(cur_weak->ptr()->key_ == raw_key);
       // Reset the next pointer in the weak property.
       cur_weak->ptr()->next_ = 0;
-      if (raw_key->ptr()->IsMarked()) {
-        ObjectPtr raw_val = cur_weak->ptr()->value_;
-        marked =
-            marked || (raw_val->IsHeapObject() && !raw_val->ptr()->IsMarked());
-
-        // The key is marked so we make sure to properly visit all pointers
-        // originating from this weak property.
-        cur_weak->ptr()->VisitPointersNonvirtual(this);
-      } else {
-        // Requeue this weak property to be handled later.
-        EnqueueWeakProperty(cur_weak);
-      }
-      // Advance to next weak property in the queue.
+      ObjectPtr raw_val = cur_weak->ptr()->value_;
+      marked =
+          marked || (raw_val->IsHeapObject() && !raw_val->ptr()->IsMarked());
+
+      // The key is marked so we make sure to properly visit all pointers
+      // originating from this weak property.
+      cur_weak->ptr()->VisitPointersNonvirtual(this);
+      // Advance to next weak property with the same key.
       cur_weak = static_cast<WeakPropertyPtr>(next_weak);
     }
     return marked;
   }
 
   void DrainMarkingStack() {
-    ObjectPtr raw_obj = work_list_.Pop();
+    ObjectPtr raw_obj = PopWork();
     if ((raw_obj == nullptr) && ProcessPendingWeakProperties()) {
-      raw_obj = work_list_.Pop();
+      raw_obj = PopWork();
     }
 
     if (raw_obj == nullptr) {
@@ -88,7 +371,11 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         const intptr_t class_id = raw_obj->GetClassId();
 
         intptr_t size;
-        if (class_id != kWeakPropertyCid) {
+        if ((class_id == kArrayCid) || (class_id == kImmutableArrayCid)) {
+          size = VisitArray(static_cast<ArrayPtr>(raw_obj));
+        } else if (UNLIKELY(collect_code_) && (class_id == kFunctionCid)) {
+          size = VisitFunction(static_cast<FunctionPtr>(raw_obj));
+        } else if (class_id != kWeakPropertyCid) {
           size = raw_obj->ptr()->VisitPointersNonvirtual(this);
         } else {
           WeakPropertyPtr raw_weak = static_cast<WeakPropertyPtr>(raw_obj);
@@ -96,7 +383,14 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         }
         marked_bytes_ += size;
 
-        raw_obj = work_list_.Pop();
+        // If this object is the key of pending weak properties, their values
+        // are now reachable. Handling them here rather than rescanning all
+        // pending weak properties keeps chains of ephemerons linear.
+        if (UNLIKELY(!pending_weak_properties_.IsEmpty())) {
+          ProcessWeakPropertiesWithKey(raw_obj);
+        }
+
+        raw_obj = PopWork();
       } while (raw_obj != nullptr);
 
       // Marking stack is empty.
@@ -104,10 +398,75 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
       // Check whether any further work was pushed either by other markers or
       // by the handling of weak properties.
-      raw_obj = work_list_.Pop();
+      raw_obj = PopWork();
     } while (raw_obj != nullptr);
   }
 
+  // Returns the next object to visit, or nullptr if there is no more work.
+  // Local work comes first, then the shared marking stack, then slices of
+  // large arrays, and only then work stolen from other tasks.
+  ObjectPtr PopWork() {
+    for (;;) {
+      ObjectPtr raw_obj = work_list_.Pop();
+      if (raw_obj != nullptr) {
+        return raw_obj;
+      }
+      if (task_queue_ == nullptr) {
+        return nullptr;
+      }
+      ArraySlice slice;
+      if (task_queue_->PopSlice(&slice)) {
+        VisitArraySlice(slice);
+      } else if (work_list_.Steal()) {
+        // Got a block from another task.
+      } else if (StealSlice(&slice)) {
+        slices_stolen_++;
+        VisitArraySlice(slice);
+      } else {
+        return nullptr;
+      }
+    }
+  }
+
+  bool StealSlice(ArraySlice* slice) {
+    for (intptr_t i = 1; i < num_task_queues_; i++) {
+      MarkerTaskQueue* victim =
+          &task_queues_[(task_index_ + i) % num_task_queues_];
+      if (victim->StealSlice(slice)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  intptr_t VisitArray(ArrayPtr raw_array) {
+    ArrayLayout* array = raw_array->ptr();
+    const intptr_t length = Smi::Value(array->length_);
+    if ((task_queue_ == nullptr) || (length <= kArraySliceLength)) {
+      return array->VisitPointersNonvirtual(this);
+    }
+    VisitPointers(array->from(), reinterpret_cast<ObjectPtr*>(&array->length_));
+    VisitArrayElements(raw_array, 0, length);
+    return array->HeapSize();
+  }
+
+  void VisitArraySlice(const ArraySlice& slice) {
+    VisitArrayElements(slice.array(), slice.start(), slice.end());
+  }
+
+  void VisitArrayElements(ArrayPtr raw_array, intptr_t start, intptr_t end) {
+    // Keep halving the range, offering the upper half to other tasks.
+    while ((end - start) > kArraySliceLength) {
+      const intptr_t middle = start + (end - start) / 2;
+      if (!task_queue_->PushSlice(ArraySlice(raw_array, middle, end))) {
+        break;
+      }
+      end = middle;
+    }
+    ArrayLayout* array = raw_array->ptr();
+    VisitPointers(&array->data()[start], &array->data()[end - 1]);
+  }
+
   // Races: The concurrent marker is racing with the mutator, but this race is
   // harmless. The concurrent marker will only visit objects that were created
   // before the marker started. It will ignore all new-space objects based on
@@ -134,8 +493,16 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     ASSERT(raw_weak->IsWeakProperty());
     ASSERT(raw_weak->ptr()->IsMarked());
     ASSERT(raw_weak->ptr()->next_ == 0);
-    raw_weak->ptr()->next_ = static_cast<uword>(delayed_weak_properties_);
-    delayed_weak_properties_ = raw_weak;
+    ObjectPtr raw_key = raw_weak->ptr()->key_;
+    PendingWeakPropertiesTrait::Pair* pair =
+        pending_weak_properties_.Lookup(raw_key);
+    if (pair == nullptr) {
+      pending_weak_properties_.Insert(
+          PendingWeakPropertiesTrait::Pair(raw_key, raw_weak));
+    } else {
+      raw_weak->ptr()->next_ = static_cast<uword>(pair->value);
+      pair->value = raw_weak;
+    }
   }
 
   intptr_t ProcessWeakProperty(WeakPropertyPtr raw_weak, bool did_mark) {
@@ -180,30 +547,158 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     deferred_work_list_.Finalize();
   }
 
+  // Called when all marking is complete, with all mutators stopped. Resets
+  // the functions whose code was skipped and has not been marked through any
+  // other path (frames, object pools, ...) to lazy compilation. Deopt info
+  // refers to functions rather than code, so deoptimizing into such a
+  // function compiles it again (see Compiler::EnsureUnoptimizedCode). The
+  // function may also still be inlined into optimized code; the debugger
+  // compiles it again before setting a breakpoint in it.
+  // Returns the number of bytes of code that became garbage this way.
+  intptr_t DetachCode() {
+    intptr_t detached_bytes = 0;
+#if !defined(DART_PRECOMPILED_RUNTIME)
+    const Code& lazy_compile = StubCode::LazyCompile();
+    for (intptr_t i = 0; i < skipped_code_functions_.length(); i++) {
+      FunctionPtr raw_func = skipped_code_functions_[i];
+      FunctionLayout* func = raw_func->ptr();
+      CodePtr code = func->code_;
+      // Code installed after the function was visited was marked by the
+      // write barrier.
+      if (code->ptr()->IsMarked() || !IsCollectableCode(raw_func, code)) {
+        continue;
+      }
+      detached_bytes += code->ptr()->HeapSize();
+      InstructionsPtr instructions = code->ptr()->instructions_;
+      if (!instructions->ptr()->IsMarked()) {
+        detached_bytes += instructions->ptr()->HeapSize();
+      }
+      // The stub lives in the vm isolate, so no barrier is needed.
+      func->code_ = lazy_compile.raw();
+      func->unoptimized_code_ = Code::null();
+      func->entry_point_ = lazy_compile.EntryPoint();
+      func->unchecked_entry_point_ = lazy_compile.UncheckedEntryPoint();
+      // The type feedback is only useful together with the code.
+      func->ic_data_array_ = Array::null();
+    }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+    skipped_code_functions_.Clear();
+    return detached_bytes;
+  }
+
   // Called when all marking is complete.
   void Finalize() {
     work_list_.Finalize();
     // Clear pending weak properties.
-    WeakPropertyPtr cur_weak = delayed_weak_properties_;
-    delayed_weak_properties_ = nullptr;
-    intptr_t weak_properties_cleared = 0;
-    while (cur_weak != nullptr) {
-      uword next_weak = cur_weak->ptr()->next_;
-      cur_weak->ptr()->next_ = 0;
-      RELEASE_ASSERT(!cur_weak->ptr()->key_->ptr()->IsMarked());
-      WeakProperty::Clear(cur_weak);
-      weak_properties_cleared++;
-      // Advance to next weak property in the queue.
-      cur_weak = static_cast<WeakPropertyPtr>(next_weak);
+    PendingWeakPropertiesMap::Iterator it =
+        pending_weak_properties_.GetIterator();
+    PendingWeakPropertiesTrait::Pair* pair;
+    while ((pair = it.Next()) != nullptr) {
+      RELEASE_ASSERT(!pair->key->ptr()->IsMarked());
+      WeakPropertyPtr cur_weak = pair->value;
+      while (cur_weak != nullptr) {
+        uword next_weak = cur_weak->ptr()->next_;
+        cur_weak->ptr()->next_ = 0;
+        WeakProperty::Clear(cur_weak);
+        // Advance to next weak property with the same key.
+        cur_weak = static_cast<WeakPropertyPtr>(next_weak);
+      }
     }
+    pending_weak_properties_.Clear();
   }
 
   void AbandonWork() {
     work_list_.AbandonWork();
     deferred_work_list_.AbandonWork();
+    skipped_code_functions_.Clear();
+    if (task_queue_ != nullptr) {
+      ArraySlice slice;
+      while (task_queue_->PopSlice(&slice)) {
+        // The rest of the array is not marked.
+      }
+    }
   }
 
  private:
+  static bool ShouldCollectCode(IsolateGroup* isolate_group) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+    return false;
+#else
+    if (!FLAG_collect_code || FLAG_precompiled_mode) {
+      return false;
+    }
+#if !defined(PRODUCT)
+    // Reload keeps references to the old program that marking cannot see.
+    if (isolate_group->IsReloading()) {
+      return false;
+    }
+#endif  // !defined(PRODUCT)
+    return true;
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+  }
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+  intptr_t VisitFunction(FunctionPtr raw_func) {
+    return raw_func->ptr()->VisitPointersNonvirtual(this);
+  }
+#else
+  // Returns true if [code] is the unoptimized code [func] compiled for
+  // itself, which can be recreated by lazy compilation.
+  //
+  // The unoptimized code of a function running optimized code is never
+  // collected: its type feedback (ic_data_array_) is what the optimizing
+  // compiler and deoptimization rely on, and dropping it would make the
+  // next reoptimization start from scratch. Such functions are hot anyway.
+  //
+  // Only unoptimized code is collected, which is never registered with
+  // WeakCodeReferences (CHA, field guards, ...): those only hold optimized
+  // code to be deoptimized when its assumptions break, and treat entries
+  // which became garbage as already disabled.
+  static bool IsCollectableCode(FunctionPtr raw_func, CodePtr code) {
+    FunctionLayout* func = raw_func->ptr();
+    if ((code->ptr()->owner_ != raw_func) || Code::IsOptimized(code)) {
+      return false;
+    }
+    if ((func->unoptimized_code_ != Code::null()) &&
+        (func->unoptimized_code_ != code)) {
+      return false;
+    }
+    if (func->bytecode_ != Bytecode::null()) {
+      return false;
+    }
+    const FunctionLayout::Kind kind = Function::kind(raw_func);
+    return (kind != FunctionLayout::kIrregexpFunction) &&
+           (kind != FunctionLayout::kFfiTrampoline);
+  }
+
+  // Code ages with the usage counter of its function, which is halved every
+  // time the function is visited. Once it reaches zero, the function did not
+  // run since the previous marking, and its code is not marked through the
+  // function. Negative counters (functions queued for background compilation
+  // or not to be optimized) are left alone. Races with the mutator on the
+  // counter are harmless: a lost update only delays or hastens aging.
+  NO_SANITIZE_THREAD
+  intptr_t VisitFunction(FunctionPtr raw_func) {
+    FunctionLayout* func = raw_func->ptr();
+    CodePtr code = static_cast<CodePtr>(
+        LoadPointerIgnoreRace(reinterpret_cast<ObjectPtr*>(&func->code_)));
+    if (!IsCollectableCode(raw_func, code)) {
+      return func->VisitPointersNonvirtual(this);
+    }
+    const int32_t usage_counter = func->usage_counter_;
+    if (usage_counter != 0) {
+      if (usage_counter > 0) {
+        func->usage_counter_ = usage_counter / 2;
+      }
+      return func->VisitPointersNonvirtual(this);
+    }
+    // Visit everything but code_, bytecode_ (null) and unoptimized_code_.
+    VisitPointers(func->from(), func->to_no_code());
+    skipped_code_functions_.Add(raw_func);
+    return func->HeapSize();
+  }
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
   void PushMarked(ObjectPtr raw_obj) {
     ASSERT(raw_obj->IsHeapObject());
     ASSERT(raw_obj->IsOldObject());
@@ -264,11 +759,18 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   Thread* thread_;
   PageSpace* page_space_;
-  MarkerWorkList work_list_;
+  MarkingWorkList work_list_;
   MarkerWorkList deferred_work_list_;
-  WeakPropertyPtr delayed_weak_properties_;
+  MarkerTaskQueue* const task_queues_;
+  const intptr_t num_task_queues_;
+  const intptr_t task_index_;
+  MarkerTaskQueue* const task_queue_;
+  PendingWeakPropertiesMap pending_weak_properties_;
+  const bool collect_code_;
+  MallocGrowableArray<FunctionPtr> skipped_code_functions_;
   uintptr_t marked_bytes_;
   int64_t marked_micros_;
+  intptr_t slices_stolen_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkingVisitorBase);
 };
@@ -298,6 +800,9 @@ class MarkingWeakVisitor : public HandleVisitor {
   void VisitHandle(uword addr) {
     FinalizablePersistentHandle* handle =
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
+    if (handle->finalization_pending()) {
+      return;
+    }
     ObjectPtr raw_obj = handle->raw();
     if (IsUnreachable(raw_obj)) {
       handle->UpdateUnreachable(thread()->isolate_group());
@@ -551,7 +1056,8 @@ class ParallelMarkTask : public ThreadPool::Task {
           // Wait for some work to appear.
           // TODO(40695): Replace busy-waiting with a solution using Monitor,
           // and redraw the boundaries between stack/visitor/task as needed.
-          while (marking_stack_->IsEmpty() && num_busy_->load() > 0) {
+          while (marking_stack_->IsEmpty() && !marker_->HasStealableWork() &&
+                 num_busy_->load() > 0) {
           }
 
           // If no tasks are busy, there will never be more work.
@@ -603,8 +1109,10 @@ class ParallelMarkTask : public ThreadPool::Task {
       int64_t stop = OS::GetCurrentMonotonicMicros();
       visitor_->AddMicros(stop - start);
       if (FLAG_log_marker_tasks) {
-        THR_Print("Task marked %" Pd " bytes in %" Pd64 " micros.\n",
-                  visitor_->marked_bytes(), visitor_->marked_micros());
+        THR_Print("Task marked %" Pd " bytes in %" Pd64
+                  " micros, stole %" Pd " blocks and %" Pd " array slices.\n",
+                  visitor_->marked_bytes(), visitor_->marked_micros(),
+                  visitor_->blocks_stolen(), visitor_->slices_stolen());
       }
       marker_->FinalizeResultsFrom(visitor_);
 
@@ -653,8 +1161,10 @@ class ConcurrentMarkTask : public ThreadPool::Task {
       int64_t stop = OS::GetCurrentMonotonicMicros();
       visitor_->AddMicros(stop - start);
       if (FLAG_log_marker_tasks) {
-        THR_Print("Task marked %" Pd " bytes in %" Pd64 " micros.\n",
-                  visitor_->marked_bytes(), visitor_->marked_micros());
+        THR_Print("Task marked %" Pd " bytes in %" Pd64
+                  " micros, stole %" Pd " blocks and %" Pd " array slices.\n",
+                  visitor_->marked_bytes(), visitor_->marked_micros(),
+                  visitor_->blocks_stolen(), visitor_->slices_stolen());
       }
     }
 
@@ -690,6 +1200,12 @@ void GCMarker::FinalizeResultsFrom(MarkingVisitorType* visitor) {
     marked_bytes_ += visitor->marked_bytes();
     marked_micros_ += visitor->marked_micros();
   }
+  const intptr_t detached_bytes = visitor->DetachCode();
+  if (detached_bytes > 0) {
+    MutexLocker ml(&stats_mutex_);
+    Metric* metric = isolate_group_->GetHeapCodeCollectedMetric();
+    metric->set_value(metric->value() + detached_bytes);
+  }
   visitor->Finalize();
 }
 
@@ -715,12 +1231,14 @@ GCMarker::GCMarker(IsolateGroup* isolate_group, Heap* heap)
       heap_(heap),
       marking_stack_(),
       visitors_(),
+      task_queues_(),
       marked_bytes_(0),
       marked_micros_(0) {
   visitors_ = new SyncMarkingVisitor*[FLAG_marker_tasks];
   for (intptr_t i = 0; i < FLAG_marker_tasks; i++) {
     visitors_[i] = NULL;
   }
+  task_queues_ = new MarkerTaskQueue[FLAG_marker_tasks];
 }
 
 GCMarker::~GCMarker() {
@@ -734,6 +1252,16 @@ GCMarker::~GCMarker() {
     }
   }
   delete[] visitors_;
+  delete[] task_queues_;
+}
+
+bool GCMarker::HasStealableWork() const {
+  for (intptr_t i = 0; i < FLAG_marker_tasks; i++) {
+    if (!task_queues_[i].IsEmpty()) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void GCMarker::StartConcurrentMark(PageSpace* page_space) {
@@ -758,7 +1286,8 @@ void GCMarker::StartConcurrentMark(PageSpace* page_space) {
   for (intptr_t i = 0; i < num_tasks; i++) {
     ASSERT(visitors_[i] == NULL);
     visitors_[i] = new SyncMarkingVisitor(
-        isolate_group_, page_space, &marking_stack_, &deferred_marking_stack_);
+        isolate_group_, page_space, &marking_stack_, &deferred_marking_stack_,
+        task_queues_, num_tasks, i);
 
     // Begin marking on a helper thread.
     bool result = Dart::thread_pool()->Run<ConcurrentMarkTask>(
@@ -789,7 +1318,9 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
       int64_t start = OS::GetCurrentMonotonicMicros();
       // Mark everything on main thread.
       UnsyncMarkingVisitor mark(isolate_group_, page_space, &marking_stack_,
-                                &deferred_marking_stack_);
+                                &deferred_marking_stack_,
+                                /*task_queues=*/nullptr,
+                                /*num_task_queues=*/0, /*task_index=*/0);
       ResetSlices();
       IterateRoots(&mark);
       mark.ProcessDeferredMarking();
@@ -812,9 +1343,9 @@ void GCMarker::MarkObjects(PageSpace* page_space) {
           visitor = visitors_[i];
           visitors_[i] = NULL;
         } else {
-          visitor =
-              new SyncMarkingVisitor(isolate_group_, page_space,
-                                     &marking_stack_, &deferred_marking_stack_);
+          visitor = new SyncMarkingVisitor(
+              isolate_group_, page_space, &marking_stack_,
+              &deferred_marking_stack_, task_queues_, num_tasks, i);
         }
         if (i < (num_tasks - 1)) {
           // Begin marking on a helper thread.
@@ -15,6 +15,7 @@ namespace dart {
 class HandleVisitor;
 class Heap;
 class IsolateGroup;
+class MarkerTaskQueue;
 class ObjectPointerVisitor;
 class PageSpace;
 template <bool sync>
@@ -56,6 +57,9 @@ class GCMarker {
   void ProcessRememberedSet(Thread* thread);
   void ProcessObjectIdTable(Thread* thread);
 
+  // Whether any marker task has work in its queue that others could steal.
+  bool HasStealableWork() const;
+
   // Called by anyone: finalize and accumulate stats from 'visitor'.
   template <class MarkingVisitorType>
   void FinalizeResultsFrom(MarkingVisitorType* visitor);
@@ -65,6 +69,7 @@ class GCMarker {
   MarkingStack marking_stack_;
   MarkingStack deferred_marking_stack_;
   MarkingVisitorBase<true>** visitors_;
+  MarkerTaskQueue* task_queues_;
 
   NewPage* new_page_;
   Monitor root_slices_monitor_;
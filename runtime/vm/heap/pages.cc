@@ -17,6 +17,8 @@
 #include "vm/object.h"
 #include "vm/object_set.h"
 #include "vm/os_thread.h"
+#include "vm/thread_pool.h"
+#include "vm/thread_registry.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -42,6 +44,20 @@ DEFINE_FLAG(bool,
             false,
             "Print free list statistics after a GC");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(bool,
+            incremental_compaction,
+            false,
+            "Evacuate the most fragmented old-space pages during each full GC "
+            "instead of leaving them to the sweeper.");
+DEFINE_FLAG(int,
+            incremental_compaction_pages,
+            16,
+            "The maximum number of old-space pages evacuated by one full GC.");
+DEFINE_FLAG(int,
+            incremental_compaction_threshold,
+            50,
+            "Old-space pages that were less than this percent live when "
+            "last swept are candidates for evacuation.");
 
 OldPage* OldPage::Allocate(intptr_t size_in_words,
                            PageType type,
@@ -92,7 +108,8 @@ void OldPage::Deallocate() {
 }
 
 void OldPage::VisitObjects(ObjectVisitor* visitor) const {
-  ASSERT(Thread::Current()->IsAtSafepoint());
+  ASSERT(Thread::Current()->IsAtSafepoint() ||
+         (Thread::Current()->task_kind() == Thread::kCompactorTask));
   NoSafepointScope no_safepoint;
   uword obj_addr = object_start();
   uword end_addr = object_end();
@@ -117,16 +134,17 @@ void OldPage::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
   ASSERT(obj_addr == end_addr);
 }
 
-void OldPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
+intptr_t OldPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
   ASSERT(Thread::Current()->IsAtSafepoint() ||
          (Thread::Current()->task_kind() == Thread::kScavengerTask));
   NoSafepointScope no_safepoint;
 
   if (card_table_ == NULL) {
-    return;
+    return 0;
   }
 
   bool table_is_empty = false;
+  intptr_t visited = 0;
 
   ArrayPtr obj = static_cast<ArrayPtr>(ObjectLayout::FromAddr(object_start()));
   ASSERT(obj->IsArray());
@@ -154,6 +172,7 @@ void OldPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
       }
 
       visitor->VisitPointers(card_from, card_to);
+      visited++;
 
       bool has_new_target = false;
       for (ObjectPtr* slot = card_from; slot <= card_to; slot++) {
@@ -176,6 +195,33 @@ void OldPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
     free(card_table_);
     card_table_ = NULL;
   }
+  return visited;
+}
+
+bool OldPage::CanUseCardRemembering(ObjectPtr obj) {
+  // Only objects too big for the freelists get a page of their own.
+  return (obj->GetClassId() == kArrayCid) &&
+         !Heap::IsAllocatableViaFreeLists(obj->ptr()->HeapSize());
+}
+
+void OldPage::SwitchToCardRemembering() {
+  ASSERT(Thread::Current()->IsAtSafepoint() ||
+         (Thread::Current()->task_kind() == Thread::kScavengerTask));
+  NoSafepointScope no_safepoint;
+
+  ArrayPtr obj = static_cast<ArrayPtr>(ObjectLayout::FromAddr(object_start()));
+  ASSERT(CanUseCardRemembering(obj));
+  ASSERT(obj->ptr()->IsRemembered());
+  obj->ptr()->ClearRememberedBit();
+  obj->ptr()->SetCardRememberedBit();
+
+  ObjectPtr* obj_from = obj->ptr()->from();
+  ObjectPtr* obj_to = obj->ptr()->to(Smi::Value(obj->ptr()->length_));
+  for (ObjectPtr* slot = obj_from; slot <= obj_to; slot++) {
+    if ((*slot)->IsNewObjectMayBeSmi()) {
+      RememberCard(slot);
+    }
+  }
 }
 
 ObjectPtr OldPage::FindObject(FindObjectVisitor* visitor) const {
@@ -261,6 +307,7 @@ PageSpace::~PageSpace() {
   FreePages(pages_);
   FreePages(exec_pages_);
   FreePages(large_pages_);
+  FreePages(freed_large_pages_);
   FreePages(image_pages_);
   ASSERT(marker_ == NULL);
   delete[] freelists_;
@@ -438,7 +485,10 @@ void PageSpace::FreeLargePage(OldPage* page, OldPage* previous_page) {
   MutexLocker ml(&pages_lock_);
   IncreaseCapacityInWordsLocked(-(page->memory_->size() >> kWordSizeLog2));
   RemoveLargePageLocked(page, previous_page);
-  page->Deallocate();
+  // Unmapping multi-megabyte pages is expensive, so don't do it while holding
+  // the pages lock or during a pause.
+  page->set_next(freed_large_pages_);
+  freed_large_pages_ = page;
 }
 
 void PageSpace::FreePages(OldPage* pages) {
@@ -450,6 +500,54 @@ void PageSpace::FreePages(OldPage* pages) {
   }
 }
 
+void PageSpace::ReleaseFreedLargePages() {
+  OldPage* pages;
+  {
+    MutexLocker ml(&pages_lock_);
+    pages = freed_large_pages_;
+    freed_large_pages_ = nullptr;
+  }
+  FreePages(pages);
+}
+
+class LargePageReleaseTask : public ThreadPool::Task {
+ public:
+  explicit LargePageReleaseTask(PageSpace* old_space) : old_space_(old_space) {
+    MonitorLocker ml(old_space_->tasks_lock());
+    old_space_->set_tasks(old_space_->tasks() + 1);
+  }
+
+  virtual void Run() {
+    old_space_->ReleaseFreedLargePages();
+    MonitorLocker ml(old_space_->tasks_lock());
+    old_space_->set_tasks(old_space_->tasks() - 1);
+    ml.NotifyAll();
+  }
+
+ private:
+  PageSpace* old_space_;
+};
+
+void PageSpace::ScheduleReleaseFreedLargePages() {
+  {
+    MutexLocker ml(&pages_lock_);
+    if (freed_large_pages_ == nullptr) {
+      return;
+    }
+  }
+  if (FLAG_concurrent_sweep && (heap_ != nullptr)) {
+    if (Dart::thread_pool()->Run<LargePageReleaseTask>(this)) {
+      return;
+    }
+    // The task was not run, so undo the count taken by its constructor.
+    MonitorLocker ml(tasks_lock());
+    set_tasks(tasks() - 1);
+    ml.NotifyAll();
+  }
+  // Serial mode, or the thread pool is shutting down.
+  ReleaseFreedLargePages();
+}
+
 void PageSpace::EvaluateConcurrentMarking(GrowthPolicy growth_policy) {
   if (growth_policy != kForceGrowth) {
     if (heap_ != NULL) {  // Some unit tests.
@@ -784,13 +882,19 @@ void PageSpace::VisitObjectsImagePages(ObjectVisitor* visitor) const {
   }
 }
 
+void PageSpace::AddPagesTo(MallocGrowableArray<OldPage*>* pages) const {
+  for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
+    pages->Add(it.page());
+  }
+}
+
 void PageSpace::VisitObjectPointers(ObjectPointerVisitor* visitor) const {
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     it.page()->VisitObjectPointers(visitor);
   }
 }
 
-void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
+intptr_t PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
   ASSERT(Thread::Current()->IsAtSafepoint() ||
          (Thread::Current()->task_kind() == Thread::kScavengerTask));
 
@@ -811,11 +915,13 @@ void PageSpace::VisitRememberedCards(ObjectPointerVisitor* visitor) const {
     page = large_pages_;
     tail = large_pages_tail_;
   }
+  intptr_t visited = 0;
   while (page != nullptr) {
-    page->VisitRememberedCards(visitor);
+    visited += page->VisitRememberedCards(visitor);
     if (page == tail) break;
     page = page->next();
   }
+  return visited;
 }
 
 ObjectPtr PageSpace::FindObject(FindObjectVisitor* visitor,
@@ -846,6 +952,7 @@ void PageSpace::WriteProtect(bool read_only) {
   if (read_only) {
     // Avoid MakeIterable trying to write to the heap.
     AbandonBumpAllocation();
+    AbandonTLABs();
   }
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     if (!it.page()->is_image_page()) {
@@ -980,6 +1087,29 @@ bool PageSpace::ShouldStartIdleMarkSweep(int64_t deadline) {
   return estimated_mark_completion <= deadline;
 }
 
+bool PageSpace::WaitForIdleMarking(Thread* thread, int64_t deadline) {
+  // Finalizing marking re-marks the roots, which are mostly new-space. Compare
+  // ShouldStartIdleMarkSweep.
+  const int64_t estimated_finalization_micros =
+      heap_->new_space()->UsedInWords() / mark_words_per_micro_;
+  const int64_t wait_deadline = deadline - estimated_finalization_micros;
+
+  MonitorLocker ml(tasks_lock());
+  while (phase() == kMarking) {
+    const int64_t remaining = wait_deadline - OS::GetCurrentMonotonicMicros();
+    if (remaining <= 0) {
+      return false;
+    }
+    // Other mutators may need this thread to reach a safepoint, e.g. for a
+    // scavenge, so don't block in the VM. Compare Heap::WaitForMarkerTasks.
+    const int64_t remaining_millis =
+        (remaining + kMicrosecondsPerMillisecond - 1) /
+        kMicrosecondsPerMillisecond;
+    ml.WaitWithSafepointCheck(thread, remaining_millis);
+  }
+  return phase() == kAwaitingFinalization;
+}
+
 bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   // To make a consistent decision, we should not yield for a safepoint in the
   // middle of deciding whether to perform an idle GC.
@@ -1142,8 +1272,10 @@ void PageSpace::CollectGarbageHelper(bool compact,
 
   int64_t mid1 = OS::GetCurrentMonotonicMicros();
 
-  // Abandon the remainder of the bump allocation block.
+  // Abandon the remainder of the bump allocation block and of any thread's
+  // allocation buffer.
   AbandonBumpAllocation();
+  AbandonTLABs();
   // Reset the freelists and setup sweeping.
   for (intptr_t i = 0; i < num_freelists_; i++) {
     freelists_[i].Reset();
@@ -1187,12 +1319,19 @@ void PageSpace::CollectGarbageHelper(bool compact,
     SweepLarge();
     Compact(thread);
     set_phase(kDone);
+    ScheduleReleaseFreedLargePages();
+  } else if (FLAG_incremental_compaction && CompactIncrementally(thread)) {
+    // The phase is set by CompactIncrementally, which may leave the pages it
+    // did not evacuate to the concurrent sweeper.
+    ScheduleReleaseFreedLargePages();
   } else if (FLAG_concurrent_sweep) {
+    // The sweeper task releases the large pages it frees.
     ConcurrentSweep(isolate_group);
   } else {
     SweepLarge();
     Sweep();
     set_phase(kDone);
+    ScheduleReleaseFreedLargePages();
   }
 
   // Make code pages read-only.
@@ -1244,7 +1383,7 @@ void PageSpace::SweepLarge() {
   }
 }
 
-void PageSpace::Sweep() {
+void PageSpace::Sweep(OldPage* last) {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "Sweep");
 
   GCSweeper sweeper;
@@ -1258,7 +1397,7 @@ void PageSpace::Sweep() {
   OldPage* prev_page = nullptr;
   OldPage* page = pages_;
   while (page != nullptr) {
-    OldPage* next_page = page->next();
+    OldPage* next_page = (page == last) ? nullptr : page->next();
     ASSERT(page->type() == OldPage::kData);
     shard = (shard + 1) % num_shards;
     bool page_in_use =
@@ -1292,7 +1431,8 @@ void PageSpace::ConcurrentSweep(IsolateGroup* isolate_group) {
 void PageSpace::Compact(Thread* thread) {
   thread->isolate_group()->set_compaction_in_progress(true);
   GCCompactor compactor(thread, heap_);
-  compactor.Compact(pages_, &freelists_[OldPage::kData], &pages_lock_);
+  compactor.Compact(pages_, /*pinned_pages=*/nullptr,
+                    &freelists_[OldPage::kData], &pages_lock_);
   thread->isolate_group()->set_compaction_in_progress(false);
 
   if (FLAG_verify_after_gc) {
@@ -1302,6 +1442,136 @@ void PageSpace::Compact(Thread* thread) {
   }
 }
 
+// A page's liveness is only known once it has been swept. Pages allocated
+// since the last sweep report no used bytes and are never candidates.
+static bool IsEvacuationCandidate(OldPage* page) {
+  if (page->forwarding_page() == nullptr) return false;
+  const uword used = page->used_in_bytes();
+  const uword capacity = page->object_end() - page->object_start();
+  return (used != 0) &&
+         (used * 100 < capacity * FLAG_incremental_compaction_threshold);
+}
+
+static int CompareLiveBytes(const uword* a, const uword* b) {
+  if (*a < *b) {
+    return -1;
+  } else if (*a == *b) {
+    return 0;
+  } else {
+    return 1;
+  }
+}
+
+bool PageSpace::CompactIncrementally(Thread* thread) {
+  MallocGrowableArray<uword> live_bytes;
+  for (OldPage* page = pages_; page != nullptr; page = page->next()) {
+    if (IsEvacuationCandidate(page)) {
+      live_bytes.Add(page->used_in_bytes());
+    }
+  }
+  const intptr_t max_candidates =
+      Utils::Minimum(live_bytes.length(),
+                     static_cast<intptr_t>(FLAG_incremental_compaction_pages));
+  if (max_candidates < 2) {
+    // Sliding a single page onto itself cannot release it.
+    return false;
+  }
+  live_bytes.Sort(CompareLiveBytes);
+  const uword cutoff = live_bytes[max_candidates - 1];
+
+  TIMELINE_FUNCTION_GC_DURATION(thread, "CompactIncrementally");
+  SweepLarge();
+
+  // Move the least live candidates to their own list. The other pages keep
+  // their mark bits and are swept after compacting, concurrently if enabled,
+  // so the pause only grows by the evacuation itself.
+  OldPage* candidates = nullptr;
+  OldPage* candidates_tail = nullptr;
+  intptr_t num_candidates = 0;
+  OldPage* prev_page = nullptr;
+  OldPage* page = pages_;
+  while (page != nullptr) {
+    OldPage* next_page = page->next();
+    if ((num_candidates < max_candidates) && IsEvacuationCandidate(page) &&
+        (page->used_in_bytes() <= cutoff)) {
+      {
+        MutexLocker ml(&pages_lock_);
+        RemovePageLocked(page, prev_page);
+      }
+      page->set_next(nullptr);
+      if (candidates == nullptr) {
+        candidates = page;
+      } else {
+        candidates_tail->set_next(page);
+      }
+      candidates_tail = page;
+      num_candidates++;
+    } else {
+      prev_page = page;
+    }
+    page = next_page;
+  }
+  ASSERT(num_candidates == max_candidates);
+  OldPage* pinned_pages = pages_;
+  OldPage* pinned_tail = prev_page;
+
+  if (FLAG_log_growth) {
+    THR_Print("%s: evacuating %" Pd " pages, cutoff=%" Pd "kB\n",
+              heap_->isolate_group()->source()->name, num_candidates,
+              static_cast<intptr_t>(cutoff / KB));
+  }
+
+  thread->isolate_group()->set_compaction_in_progress(true);
+  GCCompactor compactor(thread, heap_);
+  compactor.Compact(candidates, pinned_pages, &freelists_[OldPage::kData],
+                    &pages_lock_);
+  thread->isolate_group()->set_compaction_in_progress(false);
+
+  // The surviving evacuated pages are now dense. Treat them as full until
+  // they are swept again so the next collection does not pick them again.
+  OldPage* compacted_tail = nullptr;
+  for (OldPage* compacted = pages_; compacted != pinned_pages;
+       compacted = compacted->next()) {
+    compacted->set_used_in_bytes(compacted->object_end() -
+                                 compacted->object_start());
+    compacted_tail = compacted;
+  }
+  ASSERT(compacted_tail != nullptr);
+
+  if (pinned_pages == nullptr) {
+    set_phase(kDone);
+    if (FLAG_verify_after_gc) {
+      OS::PrintErr("Verifying after incremental compaction...");
+      heap_->VerifyGC(kForbidMarked);
+      OS::PrintErr(" done.\n");
+    }
+    return true;
+  }
+
+  // Move the unswept pages to the front so the sweeper, which frees pages
+  // relative to the head of the list, can stop at the last of them.
+  {
+    MutexLocker ml(&pages_lock_);
+    OldPage* compacted = pages_;
+    pages_ = pinned_pages;
+    pinned_tail->set_next(compacted);
+    compacted_tail->set_next(nullptr);
+    pages_tail_ = compacted_tail;
+  }
+  // Until they are swept, dead objects on those pages may still refer to
+  // evacuated pages, which heap verification would reject.
+  if (FLAG_concurrent_sweep && !FLAG_verify_after_gc) {
+    GCSweeper::SweepConcurrent(thread->isolate_group(), pinned_pages,
+                               pinned_tail, /*large_first=*/nullptr,
+                               /*large_last=*/nullptr,
+                               &freelists_[OldPage::kData]);
+  } else {
+    Sweep(pinned_tail);
+    set_phase(kDone);
+  }
+  return true;
+}
+
 uword PageSpace::TryAllocateDataBumpLocked(FreeList* freelist, intptr_t size) {
   ASSERT(size >= kObjectAlignment);
   ASSERT(Utils::IsAligned(size, kObjectAlignment));
@@ -1346,6 +1616,52 @@ uword PageSpace::TryAllocateDataBumpLocked(FreeList* freelist, intptr_t size) {
   return result;
 }
 
+uword PageSpace::TryAllocateFromNewTLAB(Thread* thread, intptr_t size) {
+  if (size > (kTLABSize / 4)) {
+    return 0;  // Not worth a buffer; use the shared freelist.
+  }
+  FreeList* freelist = DataFreeList();
+  MutexLocker ml(freelist->mutex());
+  AbandonTLABLocked(thread, freelist);
+  FreeListElement* block = freelist->TryAllocateLargeLocked(kTLABSize);
+  if (block == nullptr) {
+    // Let the regular path grow the heap; its leftover will refill us later.
+    return 0;
+  }
+  const uword start = reinterpret_cast<uword>(block);
+  intptr_t block_size = block->HeapSize();
+  if (block_size > kTLABSize) {
+    freelist->FreeLocked(start + kTLABSize, block_size - kTLABSize);
+    block_size = kTLABSize;
+  }
+  usage_.used_in_words += (block_size >> kWordSizeLog2);
+  thread->set_old_top(start);
+  thread->set_old_end(start + block_size);
+  return TryAllocateFromTLAB(thread, size);
+}
+
+void PageSpace::AbandonTLABLocked(Thread* thread, FreeList* freelist) {
+  ASSERT(freelist->mutex()->IsOwnedByCurrentThread());
+  const intptr_t remaining = thread->old_end() - thread->old_top();
+  if (remaining > 0) {
+    freelist->FreeLocked(thread->old_top(), remaining);
+    usage_.used_in_words -= (remaining >> kWordSizeLog2);
+  }
+  thread->set_old_top(0);
+  thread->set_old_end(0);
+}
+
+void PageSpace::AbandonTLAB(Thread* thread) {
+  if (thread->old_top() == 0) return;
+  FreeList* freelist = DataFreeList();
+  MutexLocker ml(freelist->mutex());
+  AbandonTLABLocked(thread, freelist);
+}
+
+void PageSpace::AbandonTLABs() {
+  heap_->isolate_group()->thread_registry()->AbandonOldSpaceTLABs(this);
+}
+
 uword PageSpace::TryAllocatePromoLockedSlow(FreeList* freelist, intptr_t size) {
   uword result = freelist->TryAllocateSmallLocked(size);
   if (result != 0) {
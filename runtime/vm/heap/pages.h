@@ -7,6 +7,7 @@
 
 #include "platform/atomic.h"
 #include "vm/globals.h"
+#include "vm/growable_array.h"
 #include "vm/heap/freelist.h"
 #include "vm/heap/spaces.h"
 #include "vm/lockers.h"
@@ -145,7 +146,15 @@ class OldPage {
     ASSERT((index >= 0) && (index < card_table_size()));
     card_table_[index] = 1;
   }
-  void VisitRememberedCards(ObjectPointerVisitor* visitor);
+  // Returns the number of cards visited.
+  intptr_t VisitRememberedCards(ObjectPointerVisitor* visitor);
+
+  // Whether 'obj' is an array alone on a large page, so that its slots can be
+  // remembered by card instead of remembering the whole object.
+  static bool CanUseCardRemembering(ObjectPtr obj);
+  // Switches the remembered array on this page to card remembering, marking
+  // the cards that currently reference new objects.
+  void SwitchToCardRemembering();
 
  private:
   void set_object_end(uword value) {
@@ -307,6 +316,29 @@ class PageSpace {
                                is_protected, is_locked);
   }
 
+  // Allocation from the calling thread's old-space buffer. Only the refill
+  // takes the data freelist lock.
+  uword TryAllocateFromTLAB(Thread* thread, intptr_t size) {
+    ASSERT(Utils::IsAligned(size, kObjectAlignment));
+    uword result = thread->old_top();
+    intptr_t remaining = thread->old_end() - result;
+    if (UNLIKELY(remaining < size)) {
+      return TryAllocateFromNewTLAB(thread, size);
+    }
+    thread->set_old_top(result + size);
+    remaining -= size;
+    if (remaining > 0) {
+      // Keep the unused part of the buffer walkable.
+      FreeListElement::AsElement(result + size, remaining);
+    }
+    return result;
+  }
+  // Returns the unused part of the thread's buffer to the data freelist.
+  void AbandonTLAB(Thread* thread);
+  // Abandons the buffers of all threads in the isolate group. Must be called
+  // at a safepoint before sweeping or compacting.
+  void AbandonTLABs();
+
   bool ReachedHardThreshold() const {
     return page_space_controller_.ReachedHardThreshold(usage_);
   }
@@ -364,7 +396,12 @@ class PageSpace {
   void VisitObjectsImagePages(ObjectVisitor* visitor) const;
   void VisitObjectPointers(ObjectPointerVisitor* visitor) const;
 
-  void VisitRememberedCards(ObjectPointerVisitor* visitor) const;
+  // Appends all pages, including code and large pages, to [pages] after
+  // making them iterable, so their objects can be visited by several tasks.
+  void AddPagesTo(MallocGrowableArray<OldPage*>* pages) const;
+
+  // Returns the number of cards visited.
+  intptr_t VisitRememberedCards(ObjectPointerVisitor* visitor) const;
 
   ObjectPtr FindObject(FindObjectVisitor* visitor,
                        OldPage::PageType type) const;
@@ -397,6 +434,12 @@ class PageSpace {
   bool ShouldStartIdleMarkSweep(int64_t deadline);
   bool ShouldPerformIdleMarkCompact(int64_t deadline);
 
+  // Waits for concurrent marking to finish, but only for as long as there is
+  // still time to finalize it before [deadline]. Returns whether marking is
+  // awaiting finalization. Remains responsive to safepoint requests while
+  // waiting.
+  bool WaitForIdleMarking(Thread* thread, int64_t deadline);
+
   void AddGCTime(int64_t micros) { gc_time_micros_ += micros; }
 
   int64_t gc_time_micros() const { return gc_time_micros_; }
@@ -472,6 +515,8 @@ class PageSpace {
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
+  static const intptr_t kTLABSize = 32 * KB;
+
   // Return any bump allocation block to the freelist.
   void AbandonBumpAllocation();
   // Have threads release marking stack blocks, etc.
@@ -509,6 +554,9 @@ class PageSpace {
                             GrowthPolicy growth_policy,
                             bool is_protected,
                             bool is_locked);
+  uword TryAllocateFromNewTLAB(Thread* thread, intptr_t size);
+  void AbandonTLABLocked(Thread* thread, FreeList* freelist);
+
   uword TryAllocateInFreshPage(intptr_t size,
                                FreeList* freelist,
                                OldPage::PageType type,
@@ -535,17 +583,30 @@ class PageSpace {
 
   void TruncateLargePage(OldPage* page, intptr_t new_object_size_in_bytes);
   void FreePage(OldPage* page, OldPage* previous_page);
+  // Unlinks a dead large page. Its memory is returned to the OS later, in a
+  // batch, by ReleaseFreedLargePages.
   void FreeLargePage(OldPage* page, OldPage* previous_page);
   void FreePages(OldPage* pages);
+  // Deallocates all large pages freed since the last call. Safe to call from
+  // any thread.
+  void ReleaseFreedLargePages();
+  // Releases freed large pages on a helper thread if concurrent sweeping is
+  // enabled, otherwise right away.
+  void ScheduleReleaseFreedLargePages();
 
   void CollectGarbageHelper(bool compact,
                             bool finalize,
                             int64_t pre_wait_for_sweepers,
                             int64_t pre_safe_point);
   void SweepLarge();
-  void Sweep();
+  // Sweeps the data pages up to and including 'last', or all of them.
+  void Sweep(OldPage* last = nullptr);
   void ConcurrentSweep(IsolateGroup* isolate_group);
   void Compact(Thread* thread);
+  // Evacuates the most fragmented data pages and sweeps the rest, concurrently
+  // if --concurrent_sweep is set. Returns false without doing any work if
+  // there is nothing worth evacuating.
+  bool CompactIncrementally(Thread* thread);
 
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
 
@@ -579,6 +640,8 @@ class PageSpace {
   OldPage* large_pages_ = nullptr;
   OldPage* large_pages_tail_ = nullptr;
   OldPage* image_pages_ = nullptr;
+  // Dead large pages waiting to be deallocated.
+  OldPage* freed_large_pages_ = nullptr;
 
   // Various sizes being tracked for this generation.
   intptr_t max_capacity_in_words_;
@@ -614,6 +677,7 @@ class PageSpace {
   friend class HeapSnapshotWriter;
   friend class PageSpaceController;
   friend class ConcurrentSweeperTask;
+  friend class LargePageReleaseTask;
   friend class GCCompactor;
   friend class CompactorTask;
 
@@ -7,10 +7,27 @@
 #include "vm/heap/heap.h"
 #include "vm/thread.h"
 #include "vm/thread_registry.h"
+#include "vm/timeline.h"
+#include "vm/usdt.h"
 
 namespace dart {
 
 DEFINE_FLAG(bool, trace_safepoint, false, "Trace Safepoint logic.");
+DEFINE_FLAG(int,
+            safepoint_spin_count,
+            10000,
+            "Number of times to poll for threads to check in for a safepoint "
+            "before blocking.");
+
+// Finalizers queued by the collections of a safepoint operation run once the
+// outermost one is over.
+static void ScheduleFinalizersAfterSafepoint(Thread* T) {
+  IsolateGroup* IG = T->isolate_group();
+  Heap* heap = IG->heap();
+  if ((heap != nullptr) && !IG->safepoint_handler()->IsOwnedByTheThread(T)) {
+    heap->ScheduleFinalizers(T);
+  }
+}
 
 SafepointOperationScope::SafepointOperationScope(Thread* T)
     : ThreadStackResource(T) {
@@ -32,6 +49,8 @@ SafepointOperationScope::~SafepointOperationScope() {
   SafepointHandler* handler = T->isolate_group()->safepoint_handler();
   ASSERT(handler != NULL);
   handler->ResumeThreads(T);
+
+  ScheduleFinalizersAfterSafepoint(T);
 }
 
 ForceGrowthSafepointOperationScope::ForceGrowthSafepointOperationScope(
@@ -69,6 +88,8 @@ ForceGrowthSafepointOperationScope::~ForceGrowthSafepointOperationScope() {
   ASSERT(handler != NULL);
   handler->ResumeThreads(T);
 
+  ScheduleFinalizersAfterSafepoint(T);
+
   if (current_growth_controller_state_) {
     ASSERT(T->CanCollectGarbage());
     // Check if we passed the growth limit during the scope.
@@ -119,6 +140,7 @@ void SafepointHandler::SafepointThreads(Thread* T) {
 
     // Set safepoint in progress state by this thread.
     SetSafepointInProgress(T);
+    DART_USDT0(safepoint__begin);
 
     // Go over the active thread list and ensure that all threads active
     // in the isolate reach a safepoint.
@@ -137,7 +159,7 @@ void SafepointHandler::SafepointThreads(Thread* T) {
               current->ScheduleInterruptsLocked(Thread::kVMInterrupt);
             }
             MonitorLocker sl(&safepoint_lock_);
-            ++number_threads_not_at_safepoint_;
+            number_threads_not_at_safepoint_.fetch_add(1);
           }
         }
       }
@@ -146,9 +168,18 @@ void SafepointHandler::SafepointThreads(Thread* T) {
   }
   // Now wait for all threads that are not already at a safepoint to check-in.
   {
+    TIMELINE_FUNCTION_GC_DURATION(T, "WaitForSafepoint");
+    // Threads running Dart code usually check in within a few microseconds,
+    // so poll for a while before paying for a wait on the monitor.
+    for (intptr_t i = 0; i < FLAG_safepoint_spin_count; i++) {
+      if (number_threads_not_at_safepoint_.load(std::memory_order_acquire) ==
+          0) {
+        break;
+      }
+    }
     MonitorLocker sl(&safepoint_lock_);
     intptr_t num_attempts = 0;
-    while (number_threads_not_at_safepoint_ > 0) {
+    while (number_threads_not_at_safepoint_.load() > 0) {
       Monitor::WaitResult retval = sl.Wait(1000);
       if (retval == Monitor::kTimedOut) {
         num_attempts += 1;
@@ -201,6 +232,7 @@ void SafepointHandler::ResumeThreads(Thread* T) {
   // that are waiting to enter the isolate or waiting to start another
   // safepoint operation.
   ResetSafepointInProgress(T);
+  DART_USDT0(safepoint__end);
   sl.NotifyAll();
 }
 
@@ -209,8 +241,8 @@ void SafepointHandler::EnterSafepointUsingLock(Thread* T) {
   T->SetAtSafepoint(true);
   if (T->IsSafepointRequested()) {
     MonitorLocker sl(&safepoint_lock_);
-    ASSERT(number_threads_not_at_safepoint_ > 0);
-    number_threads_not_at_safepoint_ -= 1;
+    ASSERT(number_threads_not_at_safepoint_.load() > 0);
+    number_threads_not_at_safepoint_.fetch_sub(1, std::memory_order_release);
     sl.Notify();
   }
 }
@@ -233,8 +265,8 @@ void SafepointHandler::BlockForSafepoint(Thread* T) {
     T->SetAtSafepoint(true);
     {
       MonitorLocker sl(&safepoint_lock_);
-      ASSERT(number_threads_not_at_safepoint_ > 0);
-      number_threads_not_at_safepoint_ -= 1;
+      ASSERT(number_threads_not_at_safepoint_.load() > 0);
+      number_threads_not_at_safepoint_.fetch_sub(1, std::memory_order_release);
       sl.Notify();
     }
     while (T->IsSafepointRequested()) {
@@ -96,8 +96,10 @@ class SafepointHandler {
 
   // Monitor used by thread initiating a safepoint operation to track threads
   // not at a safepoint and wait for these threads to reach a safepoint.
+  // The count is only modified with the lock held, but the initiating thread
+  // may poll it without the lock before it starts waiting.
   Monitor safepoint_lock_;
-  int32_t number_threads_not_at_safepoint_;
+  RelaxedAtomic<int32_t> number_threads_not_at_safepoint_;
 
   // Count that indicates if a safepoint operation is currently in progress
   // and also tracks the number of recursive safepoint operations on the
@@ -8,7 +8,9 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/flag_list.h"
+#include "vm/growable_array.h"
 #include "vm/heap/become.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/pointer_block.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/verifier.h"
@@ -37,6 +39,27 @@ DEFINE_FLAG(int,
             90,
             "Grow new gen when less than this percentage is garbage.");
 DEFINE_FLAG(int, new_gen_growth_factor, 2, "Grow new gen by this factor.");
+DEFINE_FLAG(int,
+            new_gen_target_pause_micros,
+            0,
+            "When positive, shrink new gen when scavenges take longer than "
+            "this, and only grow it while scavenges are predicted to stay "
+            "below it.");
+DEFINE_FLAG(int,
+            new_gen_target_time_ratio,
+            0,
+            "When positive, grow new gen when more than this percentage of "
+            "time is spent scavenging.");
+DEFINE_FLAG(bool,
+            card_mark_large_arrays,
+            true,
+            "Remember large old-space arrays by card instead of as a whole "
+            "object when they start referencing new objects.");
+DEFINE_FLAG(int,
+            allocation_sample_interval,
+            0,
+            "When positive, record the stack and size of a new-space "
+            "allocation on average every this many bytes. Needs --profiler.");
 
 // Scavenger uses the kCardRememberedBit to distinguish forwarded and
 // non-forwarded objects. We must choose a bit that is clear for all new-space
@@ -175,6 +198,9 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   }
 
   intptr_t bytes_promoted() const { return bytes_promoted_; }
+  intptr_t card_remembered_arrays() const {
+    return card_remembered_arrays_.length();
+  }
 
   void ProcessRoots() {
     thread_ = Thread::Current();
@@ -230,6 +256,10 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
   void Finalize() {
     if (scavenger_->abort_) {
       promoted_list_.AbandonWork();
+      // Keep them remembered as whole objects.
+      for (intptr_t i = 0; i < card_remembered_arrays_.length(); i++) {
+        thread_->StoreBufferAddObjectGC(card_remembered_arrays_[i]);
+      }
     } else {
       ASSERT(!HasWork());
 
@@ -241,6 +271,12 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
       promoted_list_.Finalize();
 
       MournWeakProperties();
+
+      // All slots are forwarded now, so the cards can be computed.
+      for (intptr_t i = 0; i < card_remembered_arrays_.length(); i++) {
+        ObjectPtr raw_obj = card_remembered_arrays_[i];
+        OldPage::Of(raw_obj)->SwitchToCardRemembering();
+      }
     }
     page_space_->ReleaseLock(freelist_);
     thread_ = nullptr;
@@ -257,7 +293,15 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
       return;
     }
     visiting_old_object_->ptr()->SetRememberedBit();
-    thread_->StoreBufferAddObjectGC(visiting_old_object_);
+    if (FLAG_card_mark_large_arrays &&
+        OldPage::CanUseCardRemembering(visiting_old_object_)) {
+      // Rescanning the whole array on every scavenge is costly. Switch it to
+      // card remembering once this scavenge is done; until then, the
+      // remembered bit deduplicates it.
+      card_remembered_arrays_.Add(visiting_old_object_);
+    } else {
+      thread_->StoreBufferAddObjectGC(visiting_old_object_);
+    }
   }
 
   DART_FORCE_INLINE
@@ -426,6 +470,7 @@ class ScavengerVisitorBase : public ObjectPointerVisitor {
 
   PromotionWorkList promoted_list_;
   WeakPropertyPtr delayed_weak_properties_ = nullptr;
+  MallocGrowableArray<ObjectPtr> card_remembered_arrays_;
 
   NewPage* head_ = nullptr;
   NewPage* tail_ = nullptr;  // Allocating from here.
@@ -449,6 +494,9 @@ class ScavengerWeakVisitor : public HandleVisitor {
   void VisitHandle(uword addr) {
     FinalizablePersistentHandle* handle =
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
+    if (handle->finalization_pending()) {
+      return;
+    }
     ObjectPtr* p = handle->raw_addr();
     if (scavenger_->IsUnreachable(p)) {
       handle->UpdateUnreachable(thread()->isolate_group());
@@ -561,6 +609,33 @@ class ParallelScavengerTask : public ThreadPool::Task {
   DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
 };
 
+// Returns the pages of a from-space to the page cache (or the OS) while the
+// mutators run. By the time this task is started no object in the isolate
+// group refers into the from-space, so nothing here needs a safepoint.
+class ReleaseFromSpaceTask : public ThreadPool::Task {
+ public:
+  ReleaseFromSpaceTask(Scavenger* scavenger, SemiSpace* from)
+      : scavenger_(scavenger), from_(from) {}
+
+  virtual void Run() {
+    {
+      TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "ReleaseFromSpace");
+      delete from_;
+    }
+
+    MonitorLocker ml(&scavenger_->release_tasks_lock_);
+    scavenger_->release_tasks_--;
+    ASSERT(scavenger_->release_tasks_ >= 0);
+    ml.NotifyAll();
+  }
+
+ private:
+  Scavenger* scavenger_;
+  SemiSpace* from_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReleaseFromSpaceTask);
+};
+
 SemiSpace::SemiSpace(intptr_t max_capacity_in_words)
     : max_capacity_in_words_(max_capacity_in_words), head_(nullptr) {}
 
@@ -742,7 +817,8 @@ Scavenger::Scavenger(Heap* heap, intptr_t max_semi_capacity_in_words)
       idle_scavenge_threshold_in_words_(0),
       external_size_(0),
       failed_to_promote_(false),
-      abort_(false) {
+      abort_(false),
+      concurrent_release_(FLAG_concurrent_release_from_space) {
   // Verify assumptions about the first word in objects which the scavenger is
   // going to use for forwarding pointers.
   ASSERT(Object::tags_offset() == 0);
@@ -760,20 +836,90 @@ Scavenger::Scavenger(Heap* heap, intptr_t max_semi_capacity_in_words)
 
 Scavenger::~Scavenger() {
   ASSERT(!scavenging_);
+  WaitForReleaseTasks();
   delete to_;
 }
 
+void Scavenger::WaitForReleaseTasks() {
+  MonitorLocker ml(&release_tasks_lock_);
+  while (release_tasks_ > 0) {
+    ml.Wait();
+  }
+}
+
+void Scavenger::ReleaseFromSpace(SemiSpace* from) {
+  if (concurrent_release_) {
+    {
+      MonitorLocker ml(&release_tasks_lock_);
+      release_tasks_++;
+    }
+    if (Dart::thread_pool()->Run<ReleaseFromSpaceTask>(this, from)) {
+      return;
+    }
+    MonitorLocker ml(&release_tasks_lock_);
+    release_tasks_--;
+  }
+  // Serial mode, or the thread pool is shutting down.
+  delete from;
+}
+
 intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   if (stats_history_.Size() == 0) {
     return old_size_in_words;
   }
+  intptr_t new_size_in_words = old_size_in_words;
   double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
-  if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
-    return Utils::Minimum(max_semi_capacity_in_words_,
-                          old_size_in_words * FLAG_new_gen_growth_factor);
-  } else {
-    return old_size_in_words;
+  if ((garbage < (FLAG_new_gen_garbage_threshold / 100.0)) ||
+      ((FLAG_new_gen_target_time_ratio > 0) &&
+       (ScavengeTimeFraction() > FLAG_new_gen_target_time_ratio))) {
+    new_size_in_words =
+        Utils::Minimum(max_semi_capacity_in_words_,
+                       old_size_in_words * FLAG_new_gen_growth_factor);
+  }
+  if (FLAG_new_gen_target_pause_micros > 0) {
+    new_size_in_words = ApplyPauseTarget(old_size_in_words, new_size_in_words);
+  }
+  return new_size_in_words;
+}
+
+intptr_t Scavenger::ApplyPauseTarget(intptr_t old_size_in_words,
+                                     intptr_t new_size_in_words) const {
+  const int64_t target = FLAG_new_gen_target_pause_micros;
+  const int64_t last_pause = stats_history_.Get(0).DurationMicros();
+  if (last_pause > target) {
+    // Less capacity means fewer survivors to copy per scavenge. Anything that
+    // no longer fits is promoted instead.
+    const intptr_t min_size_in_words =
+        Utils::Minimum(max_semi_capacity_in_words_,
+                       FLAG_new_gen_semi_initial_size * MBInWords);
+    return Utils::Maximum(min_size_in_words,
+                          old_size_in_words / FLAG_new_gen_growth_factor);
+  }
+  if (new_size_in_words > old_size_in_words) {
+    // Conservatively assume the pause grows with the capacity.
+    const double growth =
+        new_size_in_words / static_cast<double>(old_size_in_words);
+    if ((last_pause * growth) > target) {
+      return old_size_in_words;
+    }
   }
+  return new_size_in_words;
+}
+
+int Scavenger::ScavengeTimeFraction() const {
+  int64_t gc_time = 0;
+  int64_t total_time = 0;
+  for (intptr_t i = 0; i < stats_history_.Size() - 1; i++) {
+    const ScavengeStats& current = stats_history_.Get(i);
+    const ScavengeStats& previous = stats_history_.Get(i + 1);
+    gc_time += current.DurationMicros();
+    total_time += current.end_micros() - previous.end_micros();
+  }
+  if (total_time == 0) {
+    return 0;
+  }
+  ASSERT(total_time >= gc_time);
+  return static_cast<int>((static_cast<double>(gc_time) / total_time) * 100);
 }
 
 class CollectStoreBufferVisitor : public ObjectPointerVisitor {
@@ -972,7 +1118,7 @@ void Scavenger::Epilogue(SemiSpace* from) {
     OS::PrintErr(" done.\n");
   }
 
-  delete from;
+  ReleaseFromSpace(from);
   UpdateMaxHeapUsage();
   if (heap_ != NULL) {
     heap_->UpdateGlobalMaxUsed();
@@ -1011,13 +1157,17 @@ bool Scavenger::ShouldPerformIdleScavenge(int64_t deadline) {
 
 void Scavenger::IterateIsolateRoots(ObjectPointerVisitor* visitor) {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "IterateIsolateRoots");
+  int64_t start = OS::GetCurrentMonotonicMicros();
   heap_->isolate_group()->VisitObjectPointers(
       visitor, ValidationPolicy::kDontValidateFrames);
+  heap_->RecordTime(kVisitIsolateRoots,
+                    OS::GetCurrentMonotonicMicros() - start);
 }
 
 template <bool parallel>
 void Scavenger::IterateStoreBuffers(ScavengerVisitorBase<parallel>* visitor) {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "IterateStoreBuffers");
+  int64_t start = OS::GetCurrentMonotonicMicros();
 
   // Iterating through the store buffers.
   // Grab the deduplication sets out of the isolate's consolidated store buffer.
@@ -1050,16 +1200,18 @@ void Scavenger::IterateStoreBuffers(ScavengerVisitorBase<parallel>* visitor) {
   visitor->VisitingOldObject(NULL);
 
   heap_->RecordData(kStoreBufferEntries, total_count);
-  heap_->RecordData(kDataUnused1, 0);
-  heap_->RecordData(kDataUnused2, 0);
+  heap_->RecordTime(kIterateStoreBuffers,
+                    OS::GetCurrentMonotonicMicros() - start);
 }
 
 template <bool parallel>
 void Scavenger::IterateRememberedCards(
     ScavengerVisitorBase<parallel>* visitor) {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "IterateRememberedCards");
-  heap_->old_space()->VisitRememberedCards(visitor);
+  intptr_t cards = heap_->old_space()->VisitRememberedCards(visitor);
   visitor->VisitingOldObject(NULL);
+
+  heap_->RecordData(kRememberedCards, cards);
 }
 
 void Scavenger::IterateObjectIdTable(ObjectPointerVisitor* visitor) {
@@ -1272,8 +1424,9 @@ intptr_t ScavengerVisitorBase<parallel>::ProcessCopied(ObjectPtr raw_obj) {
 void Scavenger::MournWeakTables() {
   TIMELINE_FUNCTION_GC_DURATION(Thread::Current(), "MournWeakTables");
 
-  auto rehash_weak_table = [](WeakTable* table, WeakTable* replacement_new,
-                              WeakTable* replacement_old) {
+  // Survivors that stay in new-space are forwarded in place, and rehashed on
+  // the first lookup after this scavenge rather than during the pause.
+  auto mourn_weak_table = [](WeakTable* table, WeakTable* table_old) {
     intptr_t size = table->size();
     for (intptr_t i = 0; i < size; i++) {
       if (table->IsValidEntryAtExclusive(i)) {
@@ -1281,31 +1434,27 @@ void Scavenger::MournWeakTables() {
         ASSERT(raw_obj->IsHeapObject());
         uword raw_addr = ObjectLayout::ToAddr(raw_obj);
         uword header = *reinterpret_cast<uword*>(raw_addr);
-        if (IsForwarding(header)) {
-          // The object has survived.  Preserve its record.
-          raw_obj = ForwardedObj(header);
-          auto replacement =
-              raw_obj->IsNewObject() ? replacement_new : replacement_old;
-          replacement->SetValueExclusive(raw_obj, table->ValueAtExclusive(i));
+        if (!IsForwarding(header)) {
+          // The object has died.
+          table->InvalidateAtExclusive(i);
+          continue;
+        }
+        // The object has survived.  Preserve its record.
+        raw_obj = ForwardedObj(header);
+        if (raw_obj->IsNewObject()) {
+          table->ForwardKeyAtExclusive(i, raw_obj);
+        } else {
+          table_old->SetValueExclusive(raw_obj, table->ValueAtExclusive(i));
+          table->InvalidateAtExclusive(i);
         }
       }
     }
   };
 
-  // Rehash the weak tables now that we know which objects survive this cycle.
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
     const auto selector = static_cast<Heap::WeakSelector>(sel);
-    auto table = heap_->GetWeakTable(Heap::kNew, selector);
-    auto table_old = heap_->GetWeakTable(Heap::kOld, selector);
-
-    // Create a new weak table for the new-space.
-    auto table_new = WeakTable::NewFrom(table);
-    rehash_weak_table(table, table_new, table_old);
-    heap_->SetWeakTable(Heap::kNew, selector, table_new);
-
-    // Remove the old table as it has been replaced with the newly allocated
-    // table above.
-    delete table;
+    mourn_weak_table(heap_->GetWeakTable(Heap::kNew, selector),
+                     heap_->GetWeakTable(Heap::kOld, selector));
   }
 
   // Each isolate might have a weak table used for fast snapshot writing (i.e.
@@ -1314,9 +1463,7 @@ void Scavenger::MournWeakTables() {
       [&](Isolate* isolate) {
         auto table = isolate->forward_table_new();
         if (table != nullptr) {
-          auto replacement = WeakTable::NewFrom(table);
-          rehash_weak_table(table, replacement, isolate->forward_table_old());
-          isolate->set_forward_table_new(replacement);
+          mourn_weak_table(table, isolate->forward_table_old());
         }
       },
       /*at_safepoint=*/true);
@@ -1397,6 +1544,22 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
   ASSERT(heap_ != Dart::vm_isolate()->heap());
   ASSERT(!scavenging_);
 
+#if !defined(PRODUCT)
+  if (UNLIKELY(FLAG_allocation_sample_interval > 0) && (thread->top() != 0)) {
+    NewPage* page = NewPage::Of(thread->top() - 1);
+    if (thread->end() < page->allocation_end()) {
+      // The allocation crossed a sampling point rather than the end of the
+      // TLAB. The object is recorded by Object::Allocate.
+      thread->set_allocation_sample_pending(true);
+      thread->set_end(page->allocation_end());
+      if ((thread->end() - thread->top()) >= static_cast<uword>(min_size)) {
+        SetNextAllocationSamplePoint(thread, min_size);
+        return;
+      }
+    }
+  }
+#endif  // !defined(PRODUCT)
+
   AbandonRemainingTLAB(thread);
 
   MutexLocker ml(&space_lock_);
@@ -1405,6 +1568,7 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
     intptr_t available = page->end() - page->object_end();
     if (available >= min_size) {
       page->Acquire(thread);
+      SetNextAllocationSamplePoint(thread, 0);
       return;
     }
   }
@@ -1414,6 +1578,35 @@ void Scavenger::TryAllocateNewTLAB(Thread* thread, intptr_t min_size) {
     return;
   }
   page->Acquire(thread);
+  SetNextAllocationSamplePoint(thread, 0);
+}
+
+void Scavenger::SetNextAllocationSamplePoint(Thread* thread,
+                                             intptr_t pending_size) {
+#if !defined(PRODUCT)
+  if (LIKELY(FLAG_allocation_sample_interval <= 0)) {
+    return;
+  }
+  // Exponentially distributed distances between sampling points make the
+  // sampling a Poisson process over the allocated bytes: every byte is equally
+  // likely to be sampled, so large objects are sampled in proportion to their
+  // size. Lowering the end of the TLAB to the sampling point sends the inline
+  // allocation fast paths of stubs and generated code to the runtime there,
+  // without any check of their own.
+  const double uniform =
+      static_cast<double>(thread->GetRandomUInt64() >> 11) / (1LL << 53);
+  const double distance =
+      -log(1.0 - uniform) * FLAG_allocation_sample_interval;
+  if (distance >= kNewPageSize) {
+    return;
+  }
+  const uword limit =
+      thread->top() + pending_size +
+      Utils::RoundUp(static_cast<intptr_t>(distance), kObjectAlignment);
+  if (limit < thread->end()) {
+    thread->set_end(limit);
+  }
+#endif  // !defined(PRODUCT)
 }
 
 void Scavenger::AbandonRemainingTLABForDebugging(Thread* thread) {
@@ -1502,6 +1695,9 @@ void Scavenger::Scavenge() {
   }
   SemiSpace* from = Prologue();
 
+  // The to-space time includes the roots and store buffers, which the tasks
+  // process interleaved with copying.
+  int64_t copy_start = OS::GetCurrentMonotonicMicros();
   intptr_t bytes_promoted;
   if (FLAG_scavenger_tasks == 0) {
     bytes_promoted = SerialScavenge(from);
@@ -1513,8 +1709,12 @@ void Scavenger::Scavenge() {
     bytes_promoted = 0;
   }
   ASSERT(promotion_stack_.IsEmpty());
+  int64_t weak_start = OS::GetCurrentMonotonicMicros();
+  heap_->RecordTime(kProcessToSpace, weak_start - copy_start);
   MournWeakHandles();
   MournWeakTables();
+  heap_->RecordTime(kIterateWeaks,
+                    OS::GetCurrentMonotonicMicros() - weak_start);
 
   // Restore write-barrier assumptions.
   heap_->isolate_group()->RememberLiveTemporaries();
@@ -1550,6 +1750,7 @@ intptr_t Scavenger::SerialScavenge(SemiSpace* from) {
   visitor.Finalize();
 
   to_->AddList(visitor.head(), visitor.tail());
+  heap_->RecordData(kCardRememberedArrays, visitor.card_remembered_arrays());
   return visitor.bytes_promoted();
 }
 
@@ -1581,11 +1782,14 @@ intptr_t Scavenger::ParallelScavenge(SemiSpace* from) {
     }
   }
 
+  intptr_t card_remembered_arrays = 0;
   for (intptr_t i = 0; i < num_tasks; i++) {
     to_->AddList(visitors[i]->head(), visitors[i]->tail());
     bytes_promoted += visitors[i]->bytes_promoted();
+    card_remembered_arrays += visitors[i]->card_remembered_arrays();
     delete visitors[i];
   }
+  heap_->RecordData(kCardRememberedArrays, card_remembered_arrays);
 
   delete[] visitors;
   return bytes_promoted;
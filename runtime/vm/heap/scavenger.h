@@ -49,6 +49,9 @@ class NewPage {
   NewPage* next() const { return next_; }
   void set_next(NewPage* next) { next_ = next; }
 
+  // The end of the allocation buffer the page provides to its owner.
+  uword allocation_end() const { return end_; }
+
   Thread* owner() const { return owner_; }
 
   uword object_start() const { return start() + ObjectStartOffset(); }
@@ -106,6 +109,7 @@ class NewPage {
   void Release(Thread* thread) {
     ASSERT(owner_ == thread);
     owner_ = nullptr;
+    thread->AccountAllocatedBytes(thread->top() - top_);
     top_ = thread->top();
     thread->set_top(0);
     thread->set_end(0);
@@ -237,6 +241,7 @@ class ScavengeStats {
   intptr_t UsedBeforeInWords() const { return before_.used_in_words; }
 
   int64_t DurationMicros() const { return end_micros_ - start_micros_; }
+  int64_t end_micros() const { return end_micros_; }
 
  private:
   int64_t start_micros_;
@@ -344,6 +349,9 @@ class Scavenger {
 
   bool scavenging() const { return scavenging_; }
 
+  // Blocks until all pending from-space release tasks have finished.
+  void WaitForReleaseTasks();
+
   // The maximum number of Dart mutator threads we allow to execute at the same
   // time.
   static intptr_t MaxMutatorThreadCount() {
@@ -369,8 +377,8 @@ class Scavenger {
     kIterateWeaks = 5,
     // Data
     kStoreBufferEntries = 0,
-    kDataUnused1 = 1,
-    kDataUnused2 = 2,
+    kRememberedCards = 1,
+    kCardRememberedArrays = 2,
     kToKBAfterStoreBuffer = 3
   };
 
@@ -390,6 +398,7 @@ class Scavenger {
     return result;
   }
   void TryAllocateNewTLAB(Thread* thread, intptr_t size);
+  void SetNextAllocationSamplePoint(Thread* thread, intptr_t pending_size);
 
   SemiSpace* Prologue();
   intptr_t ParallelScavenge(SemiSpace* from);
@@ -405,6 +414,7 @@ class Scavenger {
   void IterateRoots(ScavengerVisitorBase<parallel>* visitor);
   void MournWeakHandles();
   void Epilogue(SemiSpace* from);
+  void ReleaseFromSpace(SemiSpace* from);
 
   bool IsUnreachable(ObjectPtr* p);
 
@@ -416,6 +426,11 @@ class Scavenger {
   void MournWeakTables();
 
   intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
+  intptr_t ApplyPauseTarget(intptr_t old_size_in_words,
+                            intptr_t new_size_in_words) const;
+
+  // Percentage of time spent scavenging over the recorded history.
+  int ScavengeTimeFraction() const;
 
   Heap* heap_;
 
@@ -450,9 +465,14 @@ class Scavenger {
   // Protects new space during the allocation of new TLABs
   mutable Mutex space_lock_;
 
+  const bool concurrent_release_;
+  Monitor release_tasks_lock_;
+  intptr_t release_tasks_ = 0;
+
   template <bool>
   friend class ScavengerVisitorBase;
   friend class ScavengerWeakVisitor;
+  friend class ReleaseFromSpaceTask;
 
   DISALLOW_COPY_AND_ASSIGN(Scavenger);
 };
@@ -163,6 +163,7 @@ class ConcurrentSweeperTask : public ThreadPool::Task {
         old_space_->set_phase(PageSpace::kSweepingRegular);
         ml.NotifyAll();
       }
+      old_space_->ReleaseFreedLargePages();
 
       intptr_t shard = 0;
       const intptr_t num_shards = Utils::Maximum(FLAG_scavenger_tasks, 1);
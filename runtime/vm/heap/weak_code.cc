@@ -7,12 +7,22 @@
 #include "platform/assert.h"
 
 #include "vm/code_patcher.h"
+#include "vm/hash_map.h"
 #include "vm/object.h"
 #include "vm/runtime_entry.h"
 #include "vm/stack_frame.h"
 
 namespace dart {
 
+// Objects are aligned, so the low bits of their addresses don't tell them
+// apart.
+class CodeSetKeyValueTrait : public IdentitySetKeyValueTrait<CodeLayout*> {
+ public:
+  static inline intptr_t Hashcode(Key key) {
+    return reinterpret_cast<uword>(key) >> kObjectAlignmentLog2;
+  }
+};
+
 bool WeakCodeReferences::HasCodes() const {
   return !array_.IsNull() && (array_.Length() > 0);
 }
@@ -42,21 +52,6 @@ void WeakCodeReferences::Register(const Code& value) {
   UpdateArrayTo(new_array);
 }
 
-bool WeakCodeReferences::IsOptimizedCode(const Array& dependent_code,
-                                         const Code& code) {
-  if (!code.is_optimized()) {
-    return false;
-  }
-  WeakProperty& weak_property = WeakProperty::Handle();
-  for (intptr_t i = 0; i < dependent_code.Length(); i++) {
-    weak_property ^= dependent_code.At(i);
-    if (code.raw() == weak_property.key()) {
-      return true;
-    }
-  }
-  return false;
-}
-
 void WeakCodeReferences::DisableCode() {
   Thread* thread = Thread::Current();
   const Array& code_objects = Array::Handle(thread->zone(), array_.raw());
@@ -69,23 +64,53 @@ void WeakCodeReferences::DisableCode() {
   }
 
   UpdateArrayTo(Object::null_array());
-  // Disable all code on stack.
+  // Disable all code on stack. The frames running dependent code are found
+  // with a set of the dependent code first, so that invalidating a lot of
+  // code under a deep stack doesn't compare every frame with every code
+  // object. DeoptimizeAt may allocate, so the frames are remembered by their
+  // frame pointers until the set of raw code pointers is gone.
   Code& code = Code::Handle();
+  GrowableArray<uword> frames_to_deoptimize;
   {
-    DartFrameIterator iterator(thread,
-                               StackFrameIterator::kNoCrossThreadIteration);
-    StackFrame* frame = iterator.NextFrame();
-    while (frame != NULL) {
-      if (!frame->is_interpreted()) {
+    NoSafepointScope no_safepoint;
+    DirectChainedHashMap<CodeSetKeyValueTrait> dependent_code;
+    WeakProperty& weak_property = WeakProperty::Handle();
+    for (intptr_t i = 0; i < code_objects.Length(); i++) {
+      weak_property ^= code_objects.At(i);
+      code ^= weak_property.key();
+      if (!code.IsNull() && code.is_optimized()) {
+        dependent_code.Insert(code.raw()->ptr());
+      }
+    }
+    if (!dependent_code.IsEmpty()) {
+      DartFrameIterator iterator(thread,
+                                 StackFrameIterator::kNoCrossThreadIteration);
+      for (StackFrame* frame = iterator.NextFrame(); frame != NULL;
+           frame = iterator.NextFrame()) {
+        if (frame->is_interpreted()) continue;
         code = frame->LookupDartCode();
-        if (IsOptimizedCode(code_objects, code)) {
-          ReportDeoptimization(code);
-          DeoptimizeAt(code, frame);
+        if (dependent_code.HasKey(code.raw()->ptr())) {
+          frames_to_deoptimize.Add(frame->fp());
         }
       }
-      frame = iterator.NextFrame();
     }
   }
+  if (!frames_to_deoptimize.is_empty()) {
+    // The second walk visits the frames in the same order.
+    intptr_t next = 0;
+    DartFrameIterator iterator(thread,
+                               StackFrameIterator::kNoCrossThreadIteration);
+    for (StackFrame* frame = iterator.NextFrame();
+         (frame != NULL) && (next < frames_to_deoptimize.length());
+         frame = iterator.NextFrame()) {
+      if (frame->fp() != frames_to_deoptimize[next]) continue;
+      next++;
+      code = frame->LookupDartCode();
+      ReportDeoptimization(code);
+      DeoptimizeAt(code, frame);
+    }
+    ASSERT(next == frames_to_deoptimize.length());
+  }
 
   // Switch functions that use dependent code to unoptimized code.
   WeakProperty& weak_property = WeakProperty::Handle();
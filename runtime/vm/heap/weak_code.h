@@ -26,8 +26,6 @@ class WeakCodeReferences : public ValueObject {
   virtual void ReportDeoptimization(const Code& code) = 0;
   virtual void ReportSwitchingCode(const Code& code) = 0;
 
-  static bool IsOptimizedCode(const Array& dependent_code, const Code& code);
-
   void DisableCode();
 
   bool HasCodes() const;
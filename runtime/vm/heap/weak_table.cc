@@ -30,6 +30,7 @@ intptr_t WeakTable::SizeFor(intptr_t count, intptr_t size) {
 }
 
 void WeakTable::SetValueExclusive(ObjectPtr key, intptr_t val) {
+  RehashIfNeeded();
   intptr_t mask = size() - 1;
   intptr_t idx = Hash(key) & mask;
   intptr_t empty_idx = -1;
@@ -79,6 +80,7 @@ void WeakTable::Reset() {
   used_ = 0;
   count_ = 0;
   size_ = kMinSize;
+  needs_rehash_ = false;
   free(old_data);
   data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
 }
@@ -92,7 +94,8 @@ void WeakTable::Forward(ObjectPointerVisitor* visitor) {
     }
   }
 
-  Rehash();
+  // Defer rehashing to the first lookup after the GC.
+  needs_rehash_ = true;
 }
 
 void WeakTable::Rehash() {
@@ -129,6 +132,7 @@ void WeakTable::Rehash() {
   // Switch to using the newly allocated backing store.
   size_ = new_size;
   data_ = new_data;
+  needs_rehash_ = false;
   free(old_data);
 }
 
@@ -17,11 +17,12 @@ class WeakTable {
  public:
   static constexpr intptr_t kNoValue = 0;
 
-  WeakTable() : size_(kMinSize), used_(0), count_(0) {
+  WeakTable() : size_(kMinSize), used_(0), count_(0), needs_rehash_(false) {
     ASSERT(Utils::IsPowerOfTwo(size_));
     data_ = reinterpret_cast<intptr_t*>(calloc(size_, kEntrySize * kWordSize));
   }
-  explicit WeakTable(intptr_t size) : used_(0), count_(0) {
+  explicit WeakTable(intptr_t size)
+      : used_(0), count_(0), needs_rehash_(false) {
     ASSERT(size >= 0);
     ASSERT(Utils::IsPowerOfTwo(kMinSize));
     if (size < kMinSize) {
@@ -41,10 +42,6 @@ class WeakTable {
 
   ~WeakTable() { free(data_); }
 
-  static WeakTable* NewFrom(WeakTable* original) {
-    return new WeakTable(SizeFor(original->count(), original->size()));
-  }
-
   intptr_t size() const { return size_; }
   intptr_t used() const { return used_; }
   intptr_t count() const { return count_; }
@@ -61,6 +58,19 @@ class WeakTable {
     return SetValueExclusive(key, val);
   }
 
+  // Associates |val| with |key| unless |key| has a value already, and returns
+  // the value of |key| afterwards. |val| must not be 0.
+  intptr_t SetValueIfNonExistent(ObjectPtr key, intptr_t val) {
+    ASSERT(val != kNoValue);
+    MutexLocker ml(&mutex_);
+    const intptr_t old_value = GetValueExclusive(key);
+    if (old_value != kNoValue) {
+      return old_value;
+    }
+    SetValueExclusive(key, val);
+    return val;
+  }
+
   // The following "exclusive" methods must only be called from call sites
   // which are known to have exclusive access to the weak table.
   //
@@ -92,9 +102,19 @@ class WeakTable {
     return data_[ValueIndex(i)];
   }
 
+  // Replaces the key of entry |i| after its object has moved. Keys are hashed
+  // by address, so the table is rehashed lazily before its next lookup. This
+  // keeps the rehashing out of the GC pause.
+  void ForwardKeyAtExclusive(intptr_t i, ObjectPtr key) {
+    ASSERT(IsValidEntryAtExclusive(i));
+    SetObjectAt(i, key);
+    needs_rehash_ = true;
+  }
+
   void SetValueExclusive(ObjectPtr key, intptr_t val);
 
-  intptr_t GetValueExclusive(ObjectPtr key) const {
+  intptr_t GetValueExclusive(ObjectPtr key) {
+    RehashIfNeeded();
     intptr_t mask = size() - 1;
     intptr_t idx = Hash(key) & mask;
     ObjectPtr obj = ObjectAtExclusive(idx);
@@ -112,6 +132,7 @@ class WeakTable {
   // Removes and returns the value associated with |key|. Returns 0 if there is
   // no value associated with |key|.
   intptr_t RemoveValueExclusive(ObjectPtr key) {
+    RehashIfNeeded();
     intptr_t mask = size() - 1;
     intptr_t idx = Hash(key) & mask;
     ObjectPtr obj = ObjectAtExclusive(idx);
@@ -192,6 +213,11 @@ class WeakTable {
   }
 
   void Rehash();
+  void RehashIfNeeded() {
+    if (needs_rehash_) {
+      Rehash();
+    }
+  }
 
   static intptr_t Hash(ObjectPtr key) {
     return static_cast<uintptr_t>(key) * 92821;
@@ -207,6 +233,9 @@ class WeakTable {
   intptr_t size_;
   intptr_t used_;
   intptr_t count_;
+  // Set when keys have been forwarded in place and no longer sit in the slot
+  // their hash points to.
+  bool needs_rehash_;
 
   DISALLOW_COPY_AND_ASSIGN(WeakTable);
 };
@@ -0,0 +1,95 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_WORK_STEALING_DEQUE_H_
+#define RUNTIME_VM_HEAP_WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+
+#include "platform/assert.h"
+#include "platform/utils.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// A bounded Chase-Lev work-stealing deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models", PPoPP 2013).
+//
+// Only the owning thread may call Push and Pop, which work at the bottom of
+// the deque without taking locks. Any thread may call Steal, which takes from
+// the top. The deque does not grow; Push fails when it is full and the owner
+// is expected to put the value somewhere else.
+template <typename T, intptr_t Capacity>
+class WorkStealingDeque {
+ public:
+  WorkStealingDeque() : top_(0), bottom_(0) {}
+
+  // Owner only. Returns false if the deque is full.
+  bool Push(T value) {
+    const intptr_t bottom = bottom_.load(std::memory_order_relaxed);
+    const intptr_t top = top_.load(std::memory_order_acquire);
+    if ((bottom - top) >= Capacity) {
+      return false;
+    }
+    buffer_[bottom & kMask].store(value, std::memory_order_relaxed);
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Owner only. Returns false if the deque is empty, or if its last value was
+  // stolen concurrently.
+  bool Pop(T* value) {
+    const intptr_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    intptr_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    *value = buffer_[bottom & kMask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // Last value: race against thieves for it.
+      const bool won = top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // Any thread. Returns false if the deque is empty, or if another thread
+  // took the value first.
+  bool Steal(T* value) {
+    intptr_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const intptr_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    *value = buffer_[top & kMask].load(std::memory_order_relaxed);
+    return top_.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+  }
+
+  // Any thread. Only a hint when other threads are pushing or popping.
+  bool IsEmpty() const {
+    return top_.load(std::memory_order_acquire) >=
+           bottom_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static const intptr_t kMask = Capacity - 1;
+  COMPILE_ASSERT((Capacity & kMask) == 0);
+
+  std::atomic<intptr_t> top_;
+  std::atomic<intptr_t> bottom_;
+  std::atomic<T> buffer_[Capacity];
+
+  DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_WORK_STEALING_DEQUE_H_
@@ -221,6 +221,8 @@ intptr_t ImageWriter::SizeInSnapshot(ObjectPtr raw_object) {
       PcDescriptorsPtr raw_desc = static_cast<PcDescriptorsPtr>(raw_object);
       return PcDescriptorsSizeInSnapshot(raw_desc->ptr()->length_);
     }
+    case kDoubleCid:
+      return compiler::target::Double::InstanceSize();
     case kInstructionsCid: {
       InstructionsPtr raw_insns = static_cast<InstructionsPtr>(raw_object);
       return InstructionsSizeInSnapshot(raw_insns);
@@ -519,6 +521,18 @@ void ImageWriter::WriteROData(WriteStream* stream) {
       stream->WriteTargetWord(desc.Length());
       stream->WriteBytes(desc.raw()->ptr()->data(), desc.Length());
       stream->Align(compiler::target::ObjectAlignment::kObjectAlignment);
+    } else if (obj.IsDouble()) {
+      auto const object_start = stream->Position();
+      marked_tags = UpdateObjectSizeForTarget(
+          compiler::target::Double::InstanceSize(), marked_tags);
+
+      stream->WriteTargetWord(marked_tags);
+      while (stream->Position() - object_start <
+             compiler::target::Double::value_offset()) {
+        stream->WriteTargetWord(0);
+      }
+      stream->WriteFixed<double>(Double::Cast(obj).value());
+      stream->Align(compiler::target::ObjectAlignment::kObjectAlignment);
     } else {
       const Class& clazz = Class::Handle(obj.clazz());
       FATAL1("Unsupported class %s in rodata section.\n", clazz.ToCString());
@@ -356,12 +356,29 @@ void LookupCache::Insert(intptr_t receiver_cid,
   entries_[probe1].target = target;
 }
 
+void CallSiteCache::Clear() {
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    entries_[i].return_pc = nullptr;
+  }
+}
+
+void CallSiteCache::Insert(const KBCInstr* return_pc,
+                           intptr_t receiver_cid,
+                           FunctionPtr target) {
+  ASSERT(target->IsOldObject());
+  Entry& entry = entries_[IndexOf(return_pc)];
+  entry.return_pc = return_pc;
+  entry.receiver_cid = receiver_cid;
+  entry.target = target;
+}
+
 Interpreter::Interpreter()
     : stack_(NULL),
       fp_(NULL),
       pp_(nullptr),
       argdesc_(nullptr),
-      lookup_cache_() {
+      lookup_cache_(),
+      call_site_cache_() {
   // Setup interpreter support first. Some of this information is needed to
   // setup the architecture state.
   // We allocate the stack here, the size is computed as the sum of
@@ -755,6 +772,12 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
       InterpreterHelpers::GetClassId(call_base[receiver_idx]);
 
   FunctionPtr target;
+  // The return address identifies the call site.
+  const KBCInstr* return_pc = *pc;
+  if (LIKELY(call_site_cache_.Lookup(return_pc, receiver_cid, &target))) {
+    top[0] = target;
+    return Invoke(thread, call_base, top, pc, FP, SP);
+  }
   if (UNLIKELY(!lookup_cache_.Lookup(receiver_cid, target_name, argdesc_,
                                      &target))) {
     // Table lookup miss.
@@ -779,6 +802,7 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
 
   if (target != Function::null()) {
     lookup_cache_.Insert(receiver_cid, target_name, argdesc_, target);
+    call_site_cache_.Insert(return_pc, receiver_cid, target);
     top[0] = target;
     return Invoke(thread, call_base, top, pc, FP, SP);
   }
@@ -870,6 +894,16 @@ DART_FORCE_INLINE bool Interpreter::InstanceCall(Thread* thread,
 // Fetch next operation from PC and dispatch.
 #define DISPATCH() DISPATCH_OP(*pc)
 
+// Continue with the handler of the next operation directly if it is the
+// given common successor of the current one. The compare and branch of each
+// use is predicted separately, unlike the shared indirect jump of DISPATCH.
+#define DISPATCH_IF_NEXT(Name)                                                 \
+  if (*pc == KernelBytecode::k##Name) {                                        \
+    op = *pc;                                                                  \
+    TRACE_INSTRUCTION                                                          \
+    goto bc##Name;                                                             \
+  }
+
 // Load target of a jump instruction into PC.
 #define LOAD_JUMP_TARGET() pc = rT
 
@@ -1932,6 +1966,9 @@ SwitchDispatch:
   {
     BYTECODE(Push, X);
     *++SP = FP[rX];
+    // Receivers and arguments are mostly pushed right before a call.
+    DISPATCH_IF_NEXT(Push);
+    DISPATCH_IF_NEXT(InterfaceCall);
     DISPATCH();
   }
 
@@ -2549,6 +2586,7 @@ SwitchDispatch:
         static_cast<uword>(Smi::Value(RAW_CAST(Smi, LOAD_CONSTANT(rD))));
     InstancePtr instance = static_cast<InstancePtr>(SP[0]);
     SP[0] = reinterpret_cast<ObjectPtr*>(instance->ptr())[offset_in_words];
+    DISPATCH_IF_NEXT(ReturnTOS);
     DISPATCH();
   }
 
@@ -53,6 +53,53 @@ class LookupCache : public ValueObject {
   Entry entries_[kNumEntries];
 };
 
+// Monomorphic inline caches of the instance call sites in bytecode, keyed by
+// the return address of the call. The target name and arguments descriptor
+// of a call site are constants in its object pool, so the receiver class
+// alone selects the target. Checked before the LookupCache.
+class CallSiteCache : public ValueObject {
+ public:
+  CallSiteCache() {
+    ASSERT(Utils::IsPowerOfTwo(sizeof(Entry)));
+    Clear();
+  }
+
+  void Clear();
+  bool Lookup(const KBCInstr* return_pc,
+              intptr_t receiver_cid,
+              FunctionPtr* target) const {
+    const Entry& entry = entries_[IndexOf(return_pc)];
+    if ((entry.return_pc == return_pc) &&
+        (entry.receiver_cid == receiver_cid)) {
+      *target = entry.target;
+      return true;
+    }
+    return false;
+  }
+  // The last receiver class seen at a call site replaces the one before.
+  void Insert(const KBCInstr* return_pc,
+              intptr_t receiver_cid,
+              FunctionPtr target);
+
+ private:
+  struct Entry {
+    const KBCInstr* return_pc;
+    intptr_t receiver_cid;
+    FunctionPtr target;
+    intptr_t padding;
+  };
+
+  static const intptr_t kNumEntries = 1024;
+  static const intptr_t kTableMask = kNumEntries - 1;
+
+  static intptr_t IndexOf(const KBCInstr* return_pc) {
+    const uword value = reinterpret_cast<uword>(return_pc);
+    return (value ^ (value >> 10)) & kTableMask;
+  }
+
+  Entry entries_[kNumEntries];
+};
+
 // Interpreter intrinsic handler. It is invoked on entry to the intrinsified
 // function via Intrinsic bytecode before the frame is setup.
 // If the handler returns true then Intrinsic bytecode works as a return
@@ -114,7 +161,10 @@ class Interpreter {
   void Unexit(Thread* thread);
 
   void VisitObjectPointers(ObjectPointerVisitor* visitor);
-  void ClearLookupCache() { lookup_cache_.Clear(); }
+  void ClearLookupCache() {
+    lookup_cache_.Clear();
+    call_site_cache_.Clear();
+  }
 
 #ifndef PRODUCT
   void set_is_debugging(bool value) { is_debugging_ = value; }
@@ -139,6 +189,7 @@ class Interpreter {
   ObjectPtr special_[KernelBytecode::kSpecialIndexCount];
 
   LookupCache lookup_cache_;
+  CallSiteCache call_site_cache_;
 
   void Exit(Thread* thread,
             ObjectPtr* base,
@@ -20,6 +20,7 @@
 #include "vm/debugger.h"
 #include "vm/deopt_instructions.h"
 #include "vm/dispatch_table.h"
+#include "vm/ffi_async_callbacks.h"
 #include "vm/flags.h"
 #include "vm/heap/heap.h"
 #include "vm/heap/pointer_block.h"
@@ -38,6 +39,7 @@
 #include "vm/os_thread.h"
 #include "vm/port.h"
 #include "vm/profiler.h"
+#include "vm/profiler_pprof.h"
 #include "vm/reusable_handles.h"
 #include "vm/reverse_pc_lookup_cache.h"
 #include "vm/service.h"
@@ -284,6 +286,9 @@ class FinalizeWeakPersistentHandlesVisitor : public HandleVisitor {
 
   void VisitHandle(uword addr) {
     auto handle = reinterpret_cast<FinalizablePersistentHandle*>(addr);
+    if (!handle->raw()->IsHeapObject() || handle->finalization_pending()) {
+      return;  // Free handle, or already queued by a GC.
+    }
     handle->UpdateUnreachable(isolate_group_);
   }
 
@@ -402,6 +407,7 @@ IsolateGroup::~IsolateGroup() {
   // Finalize any weak persistent handles with a non-null referent.
   FinalizeWeakPersistentHandlesVisitor visitor(this);
   api_state()->VisitWeakHandlesUnlocked(&visitor);
+  api_state()->RunPendingFinalizers(this);
 
   // Ensure we destroy the heap before the other members.
   heap_ = nullptr;
@@ -483,6 +489,9 @@ void IsolateGroup::Shutdown() {
     old_space->AbandonMarkingForShutdown();
   }
 
+  // Finalizers get the embedder data, which the cleanup callback may free.
+  api_state()->WaitForFinalizerTask();
+
   UnregisterIsolateGroup(this);
 
   // If the creation of the isolate group (or the first isolate within the
@@ -580,6 +589,7 @@ void IsolateGroup::UnscheduleThreadLocked(MonitorLocker* ml,
                                           bool is_mutator,
                                           bool bypass_safepoint) {
   thread->heap()->new_space()->AbandonRemainingTLAB(thread);
+  thread->heap()->old_space()->AbandonTLAB(thread);
 
   // Clear since GC will not visit the thread once it is unscheduled. Do this
   // under the thread lock to prevent races with the GC visiting thread roots.
@@ -1889,6 +1899,9 @@ ObjectPtr Isolate::CallDeferredLoadHandler(intptr_t id) {
 
 void Isolate::SetupImagePage(const uint8_t* image_buffer, bool is_executable) {
   Image image(image_buffer);
+  if (is_executable) {
+    VirtualMemory::RemapToHugePages(image.object_start(), image.object_size());
+  }
   heap()->SetupImagePage(image.object_start(), image.object_size(),
                          is_executable);
 }
@@ -2509,6 +2522,7 @@ void Isolate::LowLevelShutdown() {
 
   // Close all the ports owned by this isolate.
   PortMap::ClosePorts(message_handler());
+  FfiAsyncCallbacks::DeleteAll(this);
 
   // Fail fast if anybody tries to post any more messages to this isolate.
   delete message_handler();
@@ -2604,6 +2618,7 @@ void Isolate::Shutdown() {
     KernelIsolate::NotifyAboutIsolateShutdown(this);
 #if !defined(PRODUCT)
     debugger()->Shutdown();
+    PprofProfiler::SymbolizeIsolate(this);
 #endif
   }
 
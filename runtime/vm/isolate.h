@@ -31,6 +31,7 @@
 #include "vm/metrics.h"
 #include "vm/os_thread.h"
 #include "vm/random.h"
+#include "vm/reverse_pc_lookup_cache.h"
 #include "vm/tags.h"
 #include "vm/thread.h"
 #include "vm/thread_pool.h"
@@ -411,6 +412,9 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   Mutex* unlinked_call_map_mutex() { return &unlinked_call_map_mutex_; }
+  ReversePcLookupCache* reverse_pc_lookup_cache() {
+    return &reverse_pc_lookup_cache_;
+  }
 #endif
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -701,6 +705,7 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   Mutex unlinked_call_map_mutex_;
+  ReversePcLookupCache reverse_pc_lookup_cache_;
 #endif
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -1086,6 +1091,28 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   void PrintMemoryUsageJSON(JSONStream* stream);
 #endif
 
+  // CPU time of the mutator, see --isolate-cpu-accounting. Written by the
+  // mutator and readable from any thread.
+  enum CpuCategory {
+    kCpuDart,
+    kCpuVM,
+    kCpuGC,
+    kCpuNative,
+    kNumCpuCategories,
+  };
+  void AddCpuMicros(CpuCategory category, int64_t micros) {
+    cpu_micros_[category].fetch_add(micros);
+  }
+  int64_t cpu_micros(CpuCategory category) const {
+    return cpu_micros_[category].load();
+  }
+
+  // Bytes allocated by the mutator. New-space allocations are counted when
+  // their allocation buffer is retired, so the count lags by at most one
+  // buffer.
+  void AddAllocatedBytes(intptr_t bytes) { allocated_bytes_.fetch_add(bytes); }
+  int64_t allocated_bytes() const { return allocated_bytes_.load(); }
+
 #if !defined(PRODUCT)
   VMTagCounters* vm_tag_counters() { return &vm_tag_counters_; }
 
@@ -1502,6 +1529,9 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   // Optimized background compilation.
   BackgroundCompiler* optimizing_background_compiler_ = nullptr;
 
+  RelaxedAtomic<int64_t> cpu_micros_[kNumCpuCategories];
+  RelaxedAtomic<int64_t> allocated_bytes_ = 0;
+
 // Fields that aren't needed in a product build go here with boolean flags at
 // the top.
 #if !defined(PRODUCT)
@@ -1635,10 +1665,11 @@ class Isolate : public BaseIsolate, public IntrusiveDListEntry<Isolate> {
   friend class GCCompactor;  // VisitObjectPointers
   friend class GCMarker;     // VisitObjectPointers
   friend class SafepointHandler;
-  friend class ObjectGraph;         // VisitObjectPointers
-  friend class HeapSnapshotWriter;  // VisitObjectPointers
-  friend class Scavenger;           // VisitObjectPointers
-  friend class HeapIterationScope;  // VisitObjectPointers
+  friend class ObjectGraph;            // VisitObjectPointers
+  friend class HeapSnapshotWriter;     // VisitObjectPointers
+  friend class HeapDominatorAnalysis;  // VisitObjectPointers
+  friend class Scavenger;              // VisitObjectPointers
+  friend class HeapIterationScope;     // VisitObjectPointers
   friend class ServiceIsolate;
   friend class Thread;
   friend class Timeline;
@@ -1585,6 +1585,7 @@ void IsolateReloadContext::CommitBeforeInstanceMorphing() {
         new_lib.set_native_entry_resolver(lib.native_entry_resolver());
         new_lib.set_native_entry_symbol_resolver(
             lib.native_entry_symbol_resolver());
+        new_lib.set_ffi_native_resolver(lib.ffi_native_resolver());
       }
     }
 
@@ -2036,6 +2037,11 @@ void IsolateReloadContext::RunInvalidationVisitors() {
     }
   }
 
+  // Cached OSR code may have inlined the old bodies of reloaded functions, and
+  // InvalidateFunctions resets the deoptimization counters it is checked
+  // against.
+  I->isolate_object_store()->set_osr_code_cache(Object::null_array());
+
   GrowableArray<const Function*> functions(4 * KB);
   GrowableArray<const KernelProgramInfo*> kernel_infos(KB);
   GrowableArray<const Field*> fields(4 * KB);
@@ -2147,6 +2153,7 @@ void IsolateReloadContext::InvalidateFunctions(
     func.set_deoptimization_counter(0);
     func.set_optimized_instruction_count(0);
     func.set_optimized_call_site_count(0);
+    func.set_non_escaping_parameters(0);
   }
 }
 
@@ -10,6 +10,7 @@
 #include "vm/isolate.h"
 #include "vm/kernel_loader.h"
 #include "vm/lockers.h"
+#include "vm/object_store.h"
 #include "vm/thread_barrier.h"
 #include "vm/thread_pool.h"
 #include "vm/unit_test.h"
@@ -4762,6 +4763,49 @@ TEST_CASE(IsolateReload_SuperGetterReboundToMethod) {
                SimpleInvokeStr(lib, "main"));
 }
 
+TEST_CASE(IsolateReload_DropsOsrCode) {
+  // The OSR threshold is compiled into the unoptimized code of the loop.
+  SetFlagScope<int> sfs(&FLAG_optimization_counter_threshold, 100);
+  const char* kScript =
+      "int add(int i) => i + 1;\n"
+      "main() {\n"
+      "  var sum = 0;\n"
+      "  for (var i = 0; i < 10000; i++) {\n"
+      "    sum += add(i);\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_EQ(50005000, SimpleInvoke(lib, "main"));
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(thread->isolate()->isolate_object_store()->osr_code_cache() !=
+           Array::null());
+  }
+
+  // The cached OSR code of main may have inlined the old body of add.
+  const char* kReloadScript =
+      "int add(int i) => i + 2;\n"
+      "main() {\n"
+      "  var sum = 0;\n"
+      "  for (var i = 0; i < 10000; i++) {\n"
+      "    sum += add(i);\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n";
+
+  lib = TestCase::ReloadTestScript(kReloadScript);
+  EXPECT_VALID(lib);
+  {
+    TransitionNativeToVM transition(thread);
+    EXPECT(thread->isolate()->isolate_object_store()->osr_code_cache() ==
+           Array::null());
+  }
+  EXPECT_EQ(50015000, SimpleInvoke(lib, "main"));
+}
+
 #endif  // !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
 }  // namespace dart
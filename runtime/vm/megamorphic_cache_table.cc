@@ -5,6 +5,7 @@
 #include "vm/megamorphic_cache_table.h"
 
 #include <stdlib.h>
+#include "platform/atomic.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -13,6 +14,9 @@
 
 namespace dart {
 
+static RelaxedAtomic<intptr_t> miss_count_ = 0;
+static RelaxedAtomic<intptr_t> no_target_miss_count_ = 0;
+
 MegamorphicCachePtr MegamorphicCacheTable::Lookup(Thread* thread,
                                                   const String& name,
                                                   const Array& descriptor) {
@@ -44,6 +48,13 @@ MegamorphicCachePtr MegamorphicCacheTable::Lookup(Thread* thread,
   return cache.raw();
 }
 
+void MegamorphicCacheTable::RecordMiss(bool has_target) {
+  miss_count_.fetch_add(1);
+  if (!has_target) {
+    no_target_miss_count_.fetch_add(1);
+  }
+}
+
 void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
   StackZone zone(Thread::Current());
   intptr_t size = 0;
@@ -53,6 +64,8 @@ void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
       isolate->object_store()->megamorphic_cache_table());
   if (table.IsNull()) return;
   intptr_t max_size = 0;
+  intptr_t total_capacity = 0;
+  intptr_t total_filled = 0;
   for (intptr_t i = 0; i < table.Length(); i++) {
     cache ^= table.At(i);
     buckets = cache.buckets();
@@ -61,9 +74,23 @@ void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
     if (buckets.Length() > max_size) {
       max_size = buckets.Length();
     }
+    total_capacity += cache.mask() + 1;
+    total_filled += cache.filled_entry_count();
   }
   OS::PrintErr("%" Pd " megamorphic caches using %" Pd "KB.\n", table.Length(),
                size / 1024);
+  if (total_capacity > 0) {
+    OS::PrintErr("Megamorphic entries: %" Pd " of %" Pd " (%lf filled)\n",
+                 total_filled, total_capacity,
+                 static_cast<double>(total_filled) /
+                     static_cast<double>(total_capacity));
+  }
+  // Misses beyond the number of filled entries are calls the stub could
+  // have served from the cache, or calls going to noSuchMethod.
+  const intptr_t misses = miss_count_.load();
+  const intptr_t no_target_misses = no_target_miss_count_.load();
+  OS::PrintErr("Megamorphic misses: %" Pd " (%" Pd " without a target)\n",
+               misses, no_target_misses);
 
   intptr_t* probe_counts = new intptr_t[max_size];
   intptr_t entry_count = 0;
@@ -102,13 +129,20 @@ void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
     }
   }
   intptr_t cumulative_entries = 0;
+  intptr_t total_probes = 0;
   for (intptr_t i = 0; i <= max_probe_count; i++) {
     cumulative_entries += probe_counts[i];
+    total_probes += i * probe_counts[i];
     OS::PrintErr("Megamorphic probe %" Pd ": %" Pd " (%lf)\n", i,
                  probe_counts[i],
                  static_cast<double>(cumulative_entries) /
                      static_cast<double>(entry_count));
   }
+  if (entry_count > 0) {
+    OS::PrintErr("Megamorphic average probes per hit: %lf\n",
+                 static_cast<double>(total_probes) /
+                     static_cast<double>(entry_count));
+  }
   delete[] probe_counts;
 }
 
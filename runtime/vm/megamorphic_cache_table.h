@@ -21,6 +21,11 @@ class MegamorphicCacheTable : public AllStatic {
                                     const String& name,
                                     const Array& descriptor);
 
+  // Counts calls to the miss handler of the megamorphic call stub when
+  // --dump_megamorphic_stats is set. Misses which resolve to no target go to
+  // noSuchMethod and are never cached, so they recur on every call.
+  static void RecordMiss(bool has_target);
+
   static void PrintSizes(Isolate* isolate);
 };
 
@@ -15,6 +15,7 @@
 #include "vm/os.h"
 #include "vm/port.h"
 #include "vm/thread_interrupter.h"
+#include "vm/usdt.h"
 
 namespace dart {
 
@@ -228,10 +229,13 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
     Message::Priority saved_priority = message->priority();
     Dart_Port saved_dest_port = message->dest_port();
     MessageStatus status = kOK;
+    DART_USDT2(message__start, saved_dest_port,
+               static_cast<int>(saved_priority));
     {
       DisableIdleTimerScope disable_idle_timer(idle_time_handler);
       status = HandleMessage(std::move(message));
     }
+    DART_USDT2(message__end, saved_dest_port, static_cast<int>(status));
     if (status > max_status) {
       max_status = status;
     }
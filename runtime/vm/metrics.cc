@@ -4,12 +4,15 @@
 
 #include "vm/metrics.h"
 
+#include "vm/heap/scavenger.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/log.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
+#include "vm/profiler.h"
 #include "vm/runtime_entry.h"
+#include "vm/timeline.h"
 
 namespace dart {
 
@@ -189,6 +192,47 @@ int64_t MetricCurrentRSS::Value() const {
 int64_t MetricPeakRSS::Value() const {
   return Service::MaxRSS();
 }
+
+int64_t MetricZoneMemory::Value() const {
+  return Zone::Size();
+}
+
+int64_t MetricTimelineMemory::Value() const {
+#if defined(SUPPORT_TIMELINE)
+  TimelineEventRecorder* recorder = Timeline::recorder();
+  return (recorder != nullptr) ? recorder->Size() : 0;
+#else
+  return 0;
+#endif
+}
+
+int64_t MetricProfilerMemory::Value() const {
+  return Profiler::Size();
+}
+
+int64_t MetricSemiSpaceCacheMemory::Value() const {
+  return SemiSpace::CachedSize();
+}
+
+int64_t MetricIsolateCpuDart::Value() const {
+  return isolate()->cpu_micros(Isolate::kCpuDart);
+}
+
+int64_t MetricIsolateCpuVM::Value() const {
+  return isolate()->cpu_micros(Isolate::kCpuVM);
+}
+
+int64_t MetricIsolateCpuGC::Value() const {
+  return isolate()->cpu_micros(Isolate::kCpuGC);
+}
+
+int64_t MetricIsolateCpuNative::Value() const {
+  return isolate()->cpu_micros(Isolate::kCpuNative);
+}
+
+int64_t MetricIsolateAllocated::Value() const {
+  return isolate()->allocated_bytes();
+}
 #endif  // !defined(PRODUCT)
 
 #if !defined(PRODUCT)
@@ -241,4 +285,101 @@ void MinMetric::SetValue(int64_t new_value) {
   }
 }
 
+HistogramMetric::HistogramMetric() : Metric(), sum_(0), max_(0) {
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    counts_[i] = 0;
+  }
+}
+
+void HistogramMetric::Add(int64_t sample) {
+  if (sample < 0) {
+    sample = 0;
+  }
+  counts_[BucketFor(sample)]++;
+  increment();
+  sum_ += sample;
+  if (sample > max_) {
+    max_ = sample;
+  }
+}
+
+intptr_t HistogramMetric::BucketFor(int64_t sample) {
+  ASSERT(sample >= 0);
+  if (sample < kSubBuckets) {
+    return sample;
+  }
+  // The leading bit selects the power of two, the next kSubBucketsLog2 bits
+  // the linear bucket within it.
+  const intptr_t shift = Utils::HighestBit(sample) - kSubBucketsLog2;
+  const intptr_t sub_bucket = (sample >> shift) - kSubBuckets;
+  return (shift + 1) * kSubBuckets + sub_bucket;
+}
+
+int64_t HistogramMetric::BucketStart(intptr_t bucket) {
+  ASSERT((bucket >= 0) && (bucket < kNumBuckets));
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const intptr_t shift = (bucket / kSubBuckets) - 1;
+  const intptr_t sub_bucket = bucket % kSubBuckets;
+  return static_cast<int64_t>(kSubBuckets + sub_bucket) << shift;
+}
+
+int64_t HistogramMetric::BucketLast(intptr_t bucket) {
+  ASSERT((bucket >= 0) && (bucket < kNumBuckets));
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const intptr_t shift = (bucket / kSubBuckets) - 1;
+  return BucketStart(bucket) + ((static_cast<int64_t>(1) << shift) - 1);
+}
+
+int64_t HistogramMetric::Percentile(double fraction) const {
+  const int64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  // The rank of the sample we are looking for, rounded up.
+  const double exact_rank = fraction * total;
+  int64_t rank = static_cast<int64_t>(exact_rank);
+  if (rank < exact_rank) {
+    rank++;
+  }
+  rank = Utils::Minimum(Utils::Maximum<int64_t>(rank, 1), total);
+  int64_t seen = 0;
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    seen += counts_[i];
+    if (seen >= rank) {
+      return Utils::Minimum(BucketLast(i), max_);
+    }
+  }
+  UNREACHABLE();
+  return max_;
+}
+
+#if !defined(PRODUCT)
+void HistogramMetric::PrintHistogramJSON(JSONObject* jsobj,
+                                         const char* name) const {
+  JSONObject histogram(jsobj, name);
+  histogram.AddProperty("unit", UnitString(unit()));
+  histogram.AddProperty64("count", count());
+  histogram.AddProperty64("total", sum());
+  histogram.AddProperty64("max", max());
+  histogram.AddProperty64("p50", Percentile(0.5));
+  histogram.AddProperty64("p90", Percentile(0.9));
+  histogram.AddProperty64("p99", Percentile(0.99));
+  histogram.AddProperty64("p999", Percentile(0.999));
+  // Only non-empty buckets, as [first, last, count] triples.
+  JSONArray buckets(&histogram, "buckets");
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    if (counts_[i] != 0) {
+      JSONArray bucket(&buckets);
+      bucket.AddValue64(BucketStart(i));
+      bucket.AddValue64(BucketLast(i));
+      bucket.AddValue64(counts_[i]);
+    }
+  }
+}
+#endif  // !defined(PRODUCT)
+
 }  // namespace dart
@@ -11,6 +11,7 @@ namespace dart {
 
 class Isolate;
 class IsolateGroup;
+class JSONObject;
 class JSONStream;
 
 // Metrics for each isolate group.
@@ -26,17 +27,30 @@ class JSONStream;
   V(MaxMetric, HeapNewCapacityMax, "heap.new.capacity.max", kByte)             \
   V(MetricHeapNewExternal, HeapNewExternal, "heap.new.external", kByte)        \
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
-  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)
+  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
+  V(HistogramMetric, HeapNewPause, "heap.new.pause", kMicrosecond)             \
+  V(HistogramMetric, HeapOldPause, "heap.old.pause", kMicrosecond)             \
+  V(Metric, HeapCodeCollected, "heap.code.collected", kByte)
 
 // Metrics for each isolate.
 #define ISOLATE_METRIC_LIST(V)                                                 \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
-  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
+  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)                  \
+  V(MetricIsolateCpuDart, CpuDart, "isolate.cpu.dart", kMicrosecond)           \
+  V(MetricIsolateCpuVM, CpuVM, "isolate.cpu.vm", kMicrosecond)                 \
+  V(MetricIsolateCpuGC, CpuGC, "isolate.cpu.gc", kMicrosecond)                 \
+  V(MetricIsolateCpuNative, CpuNative, "isolate.cpu.native", kMicrosecond)     \
+  V(MetricIsolateAllocated, Allocated, "isolate.allocated", kByte)
 
 #define VM_METRIC_LIST(V)                                                      \
   V(MetricIsolateCount, IsolateCount, "vm.isolate.count", kCounter)            \
   V(MetricCurrentRSS, CurrentRSS, "vm.memory.current", kByte)                  \
-  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)
+  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)                            \
+  V(MetricZoneMemory, ZoneMemory, "vm.memory.zone", kByte)                     \
+  V(MetricTimelineMemory, TimelineMemory, "vm.memory.timeline", kByte)         \
+  V(MetricProfilerMemory, ProfilerMemory, "vm.memory.profiler", kByte)         \
+  V(MetricSemiSpaceCacheMemory, SemiSpaceCacheMemory,                          \
+    "vm.memory.semispace_cache", kByte)
 
 class Metric {
  public:
@@ -131,6 +145,49 @@ class MinMetric : public Metric {
   void SetValue(int64_t new_value);
 };
 
+// A Metric class that records the distribution of the values observed, in the
+// style of an HDR histogram: each power of two is split into kSubBuckets
+// linear buckets, so every sample is known to within 1/kSubBuckets of its
+// magnitude. The metric's value is the number of samples.
+class HistogramMetric : public Metric {
+ public:
+  static const intptr_t kSubBucketsLog2 = 3;
+  static const intptr_t kSubBuckets = 1 << kSubBucketsLog2;
+  static const intptr_t kNumBuckets =
+      (kBitsPerInt64 - kSubBucketsLog2) * kSubBuckets;
+
+  HistogramMetric();
+
+  // Negative samples are recorded as 0.
+  void Add(int64_t sample);
+
+  int64_t count() const { return value(); }
+  int64_t sum() const { return sum_; }
+  int64_t max() const { return max_; }
+  int64_t CountAt(intptr_t bucket) const { return counts_[bucket]; }
+
+  // Returns an upper bound for |fraction| of the samples, e.g. 0.99 for the
+  // 99th percentile. Returns 0 if there are no samples.
+  int64_t Percentile(double fraction) const;
+
+  static intptr_t BucketFor(int64_t sample);
+  // The smallest and largest sample that fall into |bucket|.
+  static int64_t BucketStart(intptr_t bucket);
+  static int64_t BucketLast(intptr_t bucket);
+
+#ifndef PRODUCT
+  // Adds the histogram as a property |name| of |jsobj|.
+  void PrintHistogramJSON(JSONObject* jsobj, const char* name) const;
+#endif  // !PRODUCT
+
+ private:
+  int64_t sum_;
+  int64_t max_;
+  int64_t counts_[kNumBuckets];
+
+  DISALLOW_COPY_AND_ASSIGN(HistogramMetric);
+};
+
 class MetricHeapOldUsed : public Metric {
  public:
   virtual int64_t Value() const;
@@ -176,6 +233,55 @@ class MetricPeakRSS : public Metric {
  public:
   virtual int64_t Value() const;
 };
+
+// Native memory in use by Zone segments.
+class MetricZoneMemory : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+// Native memory held by the timeline recorder.
+class MetricTimelineMemory : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+// Native memory held by the profiler's sample buffers.
+class MetricProfilerMemory : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+// Memory of new-space regions cached for reuse across isolate groups.
+class MetricSemiSpaceCacheMemory : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricIsolateCpuDart : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricIsolateCpuVM : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricIsolateCpuGC : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricIsolateCpuNative : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
+
+class MetricIsolateAllocated : public Metric {
+ public:
+  virtual int64_t Value() const;
+};
 #endif  // !defined(PRODUCT)
 
 class MetricHeapUsed : public Metric {
@@ -75,6 +75,59 @@ VM_UNIT_TEST_CASE(Metric_OnDemand) {
   }
   Dart_ShutdownIsolate();
 }
+
+VM_UNIT_TEST_CASE(Metric_Histogram) {
+  TestCase::CreateTestIsolate();
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HistogramMetric metric;
+    metric.InitInstance(Isolate::Current(), "a.b.c", "foobar",
+                        Metric::kMicrosecond);
+    EXPECT_EQ(0, metric.Percentile(0.5));
+
+    // Buckets are exact below kSubBuckets and then cover consecutive ranges.
+    for (intptr_t i = 0; i < HistogramMetric::kSubBuckets; i++) {
+      EXPECT_EQ(i, HistogramMetric::BucketFor(i));
+      EXPECT_EQ(i, HistogramMetric::BucketStart(i));
+      EXPECT_EQ(i, HistogramMetric::BucketLast(i));
+    }
+    for (intptr_t i = 1; i < HistogramMetric::kNumBuckets; i++) {
+      EXPECT_EQ(HistogramMetric::BucketLast(i - 1) + 1,
+                HistogramMetric::BucketStart(i));
+      EXPECT_EQ(i,
+                HistogramMetric::BucketFor(HistogramMetric::BucketStart(i)));
+      EXPECT_EQ(i, HistogramMetric::BucketFor(HistogramMetric::BucketLast(i)));
+    }
+    EXPECT_EQ(kMaxInt64,
+              HistogramMetric::BucketLast(HistogramMetric::kNumBuckets - 1));
+
+    for (intptr_t i = 1; i <= 100; i++) {
+      metric.Add(i * 1000);
+    }
+    EXPECT_EQ(100, metric.count());
+    EXPECT_EQ(5050000, metric.sum());
+    EXPECT_EQ(100000, metric.max());
+    // Percentiles are upper bounds within 1/kSubBuckets of the exact value.
+    const int64_t p50 = metric.Percentile(0.5);
+    EXPECT_LE(50000, p50);
+    EXPECT_LE(p50, 50000 + 50000 / HistogramMetric::kSubBuckets);
+    const int64_t p99 = metric.Percentile(0.99);
+    EXPECT_LE(99000, p99);
+    EXPECT_LE(p99, 100000);
+    EXPECT_EQ(100000, metric.Percentile(1.0));
+
+    JSONStream js;
+    {
+      JSONObject obj(&js);
+      metric.PrintHistogramJSON(&obj, "pauses");
+    }
+    EXPECT_SUBSTRING("\"pauses\":{\"unit\":\"us\",\"count\":100,",
+                     js.ToCString());
+  }
+  Dart_ShutdownIsolate();
+}
 #endif  // !defined(PRODUCT)
 
 ISOLATE_UNIT_TEST_CASE(Metric_EmbedderAPI) {
@@ -166,4 +219,31 @@ ISOLATE_UNIT_TEST_CASE(Metric_SetGCEventCallback) {
   EXPECT_STREQ("low memory", last_gcevent_reason);
 }
 
+ISOLATE_UNIT_TEST_CASE(Metric_IsolateAllocated) {
+  Isolate* isolate = Isolate::Current();
+  Dart_IsolateUsage before;
+  Dart_GetIsolateUsage(Api::CastIsolate(isolate), &before);
+
+  const intptr_t kLength = 1000;
+  Array::Handle(Array::New(kLength, Heap::kOld));
+  Dart_IsolateUsage after_old;
+  Dart_GetIsolateUsage(Api::CastIsolate(isolate), &after_old);
+  EXPECT_GE(after_old.allocated_bytes - before.allocated_bytes,
+            Array::InstanceSize(kLength));
+
+  // New-space allocations are counted once their buffer is retired.
+  Array::Handle(Array::New(kLength, Heap::kNew));
+  thread->heap()->new_space()->AbandonRemainingTLAB(thread);
+  Dart_IsolateUsage after_new;
+  Dart_GetIsolateUsage(Api::CastIsolate(isolate), &after_new);
+  EXPECT_GE(after_new.allocated_bytes - after_old.allocated_bytes,
+            Array::InstanceSize(kLength));
+
+  // CPU accounting is off by default.
+  EXPECT_EQ(0, after_new.dart_cpu_micros);
+  EXPECT_EQ(0, after_new.vm_cpu_micros);
+  EXPECT_EQ(0, after_new.gc_cpu_micros);
+  EXPECT_EQ(0, after_new.native_cpu_micros);
+}
+
 }  // namespace dart
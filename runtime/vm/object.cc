@@ -2663,14 +2663,21 @@ ObjectPtr Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
   }
 #ifndef PRODUCT
   auto class_table = thread->isolate_group()->shared_class_table();
-  if (class_table->TraceAllocationFor(cls_id)) {
-    Profiler::SampleAllocation(thread, cls_id);
+  if (UNLIKELY(thread->allocation_sample_pending())) {
+    thread->set_allocation_sample_pending(false);
+    Profiler::SampleAllocation(thread, cls_id, size);
+  } else if (class_table->TraceAllocationFor(cls_id)) {
+    Profiler::SampleAllocation(thread, cls_id, size);
   }
 #endif  // !PRODUCT
   NoSafepointScope no_safepoint;
   InitializeObject(address, cls_id, size);
   ObjectPtr raw_obj = static_cast<ObjectPtr>(address + kHeapObjectTag);
   ASSERT(cls_id == ObjectLayout::ClassIdTag::decode(raw_obj->ptr()->tags_));
+  if (raw_obj->IsOldObject()) {
+    // New-space allocations are counted by their allocation buffer.
+    thread->AccountAllocatedBytes(size);
+  }
   if (raw_obj->IsOldObject() && UNLIKELY(thread->is_marking())) {
     // Black allocation. Prevents a data race between the mutator and concurrent
     // marker on ARM and ARM64 (the marker may observe a publishing store of
@@ -3724,6 +3731,7 @@ FunctionPtr Function::CreateDynamicInvocationForwarder(
   forwarder.set_optimized_instruction_count(0);
   forwarder.set_inlining_depth(0);
   forwarder.set_optimized_call_site_count(0);
+  forwarder.set_non_escaping_parameters(0);
 
   forwarder.InheritBinaryDeclarationFrom(*this);
 
@@ -3893,6 +3901,11 @@ void Class::DisableCHAOptimizedCode(const Class& subclass) {
       THR_Print("Deopt for CHA (new subclass %s)\n", subclass.ToCString());
     }
   }
+  if (!subclass.IsNull() && a.HasCodes()) {
+    // Remember that this class gets extended late, so that the compiler
+    // guards calls on it with class id checks instead of using CHA again.
+    set_is_cha_deoptimized(true);
+  }
   a.DisableCode();
 }
 
@@ -4907,6 +4920,10 @@ void Class::set_is_allocated(bool value) const {
   set_state_bits(IsAllocatedBit::update(value, raw_ptr()->state_bits_));
 }
 
+void Class::set_is_cha_deoptimized(bool value) const {
+  set_state_bits(IsCHADeoptimizedBit::update(value, raw_ptr()->state_bits_));
+}
+
 void Class::set_is_loaded(bool value) const {
   set_state_bits(IsLoadedBit::update(value, raw_ptr()->state_bits_));
 }
@@ -7119,6 +7136,34 @@ void Function::SetFfiCallbackId(int32_t value) const {
   FfiTrampolineData::Cast(obj).set_callback_id(value);
 }
 
+bool Function::FfiIsLeaf() const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data_);
+  ASSERT(!obj.IsNull());
+  return FfiTrampolineData::Cast(obj).is_leaf();
+}
+
+void Function::SetFfiIsLeaf(bool is_leaf) const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data_);
+  ASSERT(!obj.IsNull());
+  FfiTrampolineData::Cast(obj).set_is_leaf(is_leaf);
+}
+
+bool Function::FfiIsLazy() const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data_);
+  ASSERT(!obj.IsNull());
+  return FfiTrampolineData::Cast(obj).is_lazy();
+}
+
+void Function::SetFfiIsLazy(bool is_lazy) const {
+  ASSERT(IsFfiTrampoline());
+  const Object& obj = Object::Handle(raw_ptr()->data_);
+  ASSERT(!obj.IsNull());
+  FfiTrampolineData::Cast(obj).set_is_lazy(is_lazy);
+}
+
 FunctionPtr Function::FfiCallbackTarget() const {
   ASSERT(IsFfiTrampoline());
   const Object& obj = Object::Handle(raw_ptr()->data_);
@@ -8702,6 +8747,7 @@ FunctionPtr Function::New(const String& name,
   NOT_IN_PRECOMPILED(result.set_optimized_instruction_count(0));
   NOT_IN_PRECOMPILED(result.set_optimized_call_site_count(0));
   NOT_IN_PRECOMPILED(result.set_inlining_depth(0));
+  NOT_IN_PRECOMPILED(result.set_non_escaping_parameters(0));
   NOT_IN_PRECOMPILED(result.set_is_declared_in_bytecode(false));
   NOT_IN_PRECOMPILED(result.set_binary_declaration_offset(0));
   result.set_is_optimizable(is_native ? false : true);
@@ -9945,6 +9991,14 @@ void FfiTrampolineData::set_callback_id(int32_t callback_id) const {
   StoreNonPointer(&raw_ptr()->callback_id_, callback_id);
 }
 
+void FfiTrampolineData::set_is_leaf(bool is_leaf) const {
+  StoreNonPointer(&raw_ptr()->is_leaf_, is_leaf);
+}
+
+void FfiTrampolineData::set_is_lazy(bool is_lazy) const {
+  StoreNonPointer(&raw_ptr()->is_lazy_, is_lazy);
+}
+
 void FfiTrampolineData::set_callback_exceptional_return(
     const Instance& value) const {
   StorePointer(&raw_ptr()->callback_exceptional_return_, value.raw());
@@ -9957,6 +10011,8 @@ FfiTrampolineDataPtr FfiTrampolineData::New() {
                        FfiTrampolineData::InstanceSize(), Heap::kOld);
   FfiTrampolineDataPtr data = static_cast<FfiTrampolineDataPtr>(raw);
   data->ptr()->callback_id_ = 0;
+  data->ptr()->is_leaf_ = false;
+  data->ptr()->is_lazy_ = false;
   return data;
 }
 
@@ -12773,6 +12829,7 @@ LibraryPtr Library::NewLibraryHelper(const String& url, bool import_core_lib) {
   result.StorePointer(&result.raw_ptr()->loaded_scripts_, Array::null());
   result.set_native_entry_resolver(NULL);
   result.set_native_entry_symbol_resolver(NULL);
+  result.set_ffi_native_resolver(NULL);
   result.set_flags(0);
   result.set_is_in_fullsnapshot(false);
   result.set_is_nnbd(false);
@@ -16649,6 +16706,67 @@ CodePtr Code::FinalizeCode(FlowGraphCompiler* compiler,
   return code.raw();
 }
 
+#if !defined(PRODUCT)
+// Resolves the innermost source position of every range of pcs in |code|
+// up front, since observers may look each of them up more than once.
+class CodeSourcePositionsWrapper final : public CodeSourcePositions {
+ public:
+  CodeSourcePositionsWrapper(const Code& code, const CodeSourceMap& map) {
+    Zone* zone = Thread::Current()->zone();
+    const auto& id_map = Array::Handle(zone, code.inlined_id_to_function());
+    const auto& root = Function::Handle(zone, code.function());
+    CodeSourceMapReader reader(map, id_map, root);
+    GrowableArray<intptr_t> pc_offsets;
+    GrowableArray<const Function*> functions;
+    GrowableArray<TokenPosition> positions;
+    reader.GetSourcePositions(&pc_offsets, &functions, &positions);
+
+    auto& script = Script::Handle(zone);
+    auto& url = String::Handle(zone);
+    for (intptr_t i = 0; i < pc_offsets.length(); i++) {
+      if (!positions[i].IsReal()) {
+        continue;
+      }
+      script = functions[i]->script();
+      if (script.IsNull()) {
+        continue;
+      }
+      intptr_t line = -1;
+      intptr_t column = -1;
+      script.GetTokenLocation(positions[i], &line, &column);
+      if (line <= 0) {
+        continue;
+      }
+      url = script.url();
+      Entry entry = {pc_offsets[i], url.ToCString(), line, column};
+      entries_.Add(entry);
+    }
+  }
+
+  intptr_t Length() const override { return entries_.length(); }
+
+  intptr_t PCOffsetAt(intptr_t i) const override {
+    return entries_[i].pc_offset;
+  }
+
+  const char* FileAt(intptr_t i) const override { return entries_[i].file; }
+
+  intptr_t LineAt(intptr_t i) const override { return entries_[i].line; }
+
+  intptr_t ColumnAt(intptr_t i) const override { return entries_[i].column; }
+
+ private:
+  struct Entry {
+    intptr_t pc_offset;
+    const char* file;
+    intptr_t line;
+    intptr_t column;
+  };
+
+  GrowableArray<Entry> entries_;
+};
+#endif  // !defined(PRODUCT)
+
 void Code::NotifyCodeObservers(const Code& code, bool optimized) {
 #if !defined(PRODUCT)
   ASSERT(!Thread::Current()->IsAtSafepoint());
@@ -16689,9 +16807,18 @@ void Code::NotifyCodeObservers(const char* name,
   if (CodeObservers::AreActive()) {
     const auto& instrs = Instructions::Handle(code.instructions());
     CodeCommentsWrapper comments_wrapper(code.comments());
+    const auto& map = CodeSourceMap::Handle(code.code_source_map());
+    if (map.IsNull() || !code.IsFunctionCode()) {
+      CodeObservers::NotifyAll(name, instrs.PayloadStart(),
+                               code.GetPrologueOffset(), instrs.Size(),
+                               optimized, &comments_wrapper,
+                               /*positions=*/nullptr);
+      return;
+    }
+    CodeSourcePositionsWrapper positions_wrapper(code, map);
     CodeObservers::NotifyAll(name, instrs.PayloadStart(),
                              code.GetPrologueOffset(), instrs.Size(), optimized,
-                             &comments_wrapper);
+                             &comments_wrapper, &positions_wrapper);
   }
 #endif
 }
@@ -17512,22 +17639,40 @@ void MegamorphicCache::EnsureCapacityLocked() const {
     for (intptr_t i = 0; i < new_capacity; ++i) {
       SetEntry(new_buckets, i, smi_illegal_cid(), target);
     }
-    set_buckets(new_buckets);
-    set_mask(new_capacity - 1);
-    set_filled_entry_count(0);
 
-    // Rehash the valid entries.
+    // Rehash the valid entries before publishing the new buckets, so that
+    // the lookup stub, which doesn't take the lock, never sees a partially
+    // filled table. The buckets are published before the larger mask, so a
+    // concurrent probe stays within bounds and at worst misses.
     Smi& class_id = Smi::Handle();
     for (intptr_t i = 0; i < old_capacity; ++i) {
       class_id ^= GetClassId(old_buckets, i);
       if (class_id.Value() != kIllegalCid) {
         target = GetTargetFunction(old_buckets, i);
-        InsertLocked(class_id, target);
+        InsertEntry(new_buckets, new_capacity - 1, class_id, target);
       }
     }
+    set_buckets(new_buckets);
+    set_mask(new_capacity - 1);
   }
 }
 
+void MegamorphicCache::InsertEntry(const Array& buckets,
+                                   intptr_t mask,
+                                   const Smi& class_id,
+                                   const Object& target) {
+  intptr_t index = (class_id.Value() * kSpreadFactor) & mask;
+  intptr_t i = index;
+  do {
+    if (Smi::Value(Smi::RawCast(GetClassId(buckets, i))) == kIllegalCid) {
+      SetEntry(buckets, i, class_id, target);
+      return;
+    }
+    i = (i + 1) & mask;
+  } while (i != index);
+  UNREACHABLE();
+}
+
 void MegamorphicCache::InsertLocked(const Smi& class_id,
                                     const Object& target) const {
   ASSERT(Isolate::Current()->megamorphic_mutex()->IsOwnedByCurrentThread());
@@ -17535,18 +17680,8 @@ void MegamorphicCache::InsertLocked(const Smi& class_id,
   ASSERT(static_cast<double>(filled_entry_count() + 1) <=
          (kLoadFactor * static_cast<double>(mask() + 1)));
   const Array& backing_array = Array::Handle(buckets());
-  intptr_t id_mask = mask();
-  intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
-  intptr_t i = index;
-  do {
-    if (Smi::Value(Smi::RawCast(GetClassId(backing_array, i))) == kIllegalCid) {
-      SetEntry(backing_array, i, class_id, target);
-      set_filled_entry_count(filled_entry_count() + 1);
-      return;
-    }
-    i = (i + 1) & id_mask;
-  } while (i != index);
-  UNREACHABLE();
+  InsertEntry(backing_array, mask(), class_id, target);
+  set_filled_entry_count(filled_entry_count() + 1);
 }
 
 const char* MegamorphicCache::ToCString() const {
@@ -22034,6 +22169,55 @@ bool String::EndsWith(const String& other) const {
   return true;
 }
 
+intptr_t String::IndexOf(const String& pattern, intptr_t start) const {
+  const intptr_t len = Length();
+  const intptr_t pattern_len = pattern.Length();
+  ASSERT((start >= 0) && (start <= len));
+  if (pattern_len == 0) {
+    return start;
+  }
+  const intptr_t last = len - pattern_len;
+  if (last < start) {
+    return -1;
+  }
+  if ((IsOneByteString() || IsExternalOneByteString()) &&
+      pattern.IsOneByteString()) {
+    // Find candidates with memchr, which libc vectorizes.
+    NoSafepointScope no_safepoint;
+    const uint8_t* data = IsOneByteString()
+                              ? OneByteString::DataStart(*this)
+                              : ExternalOneByteString::DataStart(*this);
+    const uint8_t* pattern_data = OneByteString::DataStart(pattern);
+    intptr_t i = start;
+    while (i <= last) {
+      const void* found = memchr(data + i, pattern_data[0], last - i + 1);
+      if (found == NULL) {
+        return -1;
+      }
+      i = reinterpret_cast<const uint8_t*>(found) - data;
+      if (memcmp(data + i + 1, pattern_data + 1, pattern_len - 1) == 0) {
+        return i;
+      }
+      i++;
+    }
+    return -1;
+  }
+  const int32_t first = pattern.CharAt(0);
+  for (intptr_t i = start; i <= last; i++) {
+    if (CharAt(i) != first) {
+      continue;
+    }
+    intptr_t j = 1;
+    while ((j < pattern_len) && (CharAt(i + j) == pattern.CharAt(j))) {
+      j++;
+    }
+    if (j == pattern_len) {
+      return i;
+    }
+  }
+  return -1;
+}
+
 InstancePtr String::CheckAndCanonicalize(Thread* thread,
                                          const char** error_str) const {
   if (IsCanonical()) {
@@ -23329,6 +23513,20 @@ ArrayPtr Array::New(intptr_t class_id, intptr_t len, Heap::Space space) {
   }
 }
 
+void Array::CopyRange(intptr_t start,
+                      const Array& source,
+                      intptr_t source_start,
+                      intptr_t count) const {
+  ASSERT(Utils::RangeCheck(start, count, Length()));
+  ASSERT(Utils::RangeCheck(source_start, count, source.Length()));
+  if (count == 0) {
+    return;
+  }
+  NoSafepointScope no_safepoint;
+  StoreArrayPointers(ObjectAddr(start), source.ObjectAddr(source_start),
+                     count);
+}
+
 ArrayPtr Array::Slice(intptr_t start,
                       intptr_t count,
                       bool with_type_argument) const {
@@ -23434,6 +23632,45 @@ void Array::Truncate(intptr_t new_len) const {
   array.SetLengthIgnoreRace(new_len);
 }
 
+bool Array::TryGrowInPlace(intptr_t new_length) const {
+  ASSERT(new_length > Length());
+  if (!raw()->IsNewObject()) {
+    // Free space after an old array can't be claimed without finding it in
+    // the free lists.
+    return false;
+  }
+  const intptr_t old_size = Array::InstanceSize(Length());
+  const intptr_t new_size = Array::InstanceSize(new_length);
+  if (new_size > Heap::kNewAllocatableSize) {
+    return false;
+  }
+  Thread* thread = Thread::Current();
+  const uword end = ObjectLayout::ToAddr(raw()) + old_size;
+  if ((thread->top() != end) ||
+      (static_cast<intptr_t>(thread->end() - end) < new_size - old_size)) {
+    return false;
+  }
+
+  NoSafepointScope no_safepoint;
+  thread->set_top(end + (new_size - old_size));
+  // Initialize the new elements and the alignment padding like Allocate.
+  const uword new_end = ObjectLayout::ToAddr(raw()) + new_size;
+  for (uword slot = reinterpret_cast<uword>(raw_ptr()->data() + Length());
+       slot < new_end; slot += kWordSize) {
+    *reinterpret_cast<ObjectPtr*>(slot) = Object::null();
+  }
+
+  uint32_t tags = raw_ptr()->tags_;
+  uint32_t old_tags;
+  do {
+    old_tags = tags;
+    uint32_t new_tags = ObjectLayout::SizeTag::update(new_size, old_tags);
+    tags = CompareAndSwapTags(old_tags, new_tags);
+  } while (tags != old_tags);
+  SetLength(new_length);
+  return true;
+}
+
 ArrayPtr Array::MakeFixedLength(const GrowableObjectArray& growable_array,
                                 bool unique) {
   ASSERT(!growable_array.IsNull());
@@ -24742,6 +24979,14 @@ void RegExp::set_capture_name_map(const Array& array) const {
   StorePointer(&raw_ptr()->capture_name_map_, array.raw());
 }
 
+void RegExp::set_required_literal(const String& literal) const {
+  StorePointer(&raw_ptr()->required_literal_, literal.raw());
+}
+
+void RegExp::set_linear_program(const TypedData& program) const {
+  StorePointer(&raw_ptr()->linear_program_, program.raw());
+}
+
 RegExpPtr RegExp::New(Heap::Space space) {
   RegExp& result = RegExp::Handle();
   {
@@ -398,6 +398,18 @@ class Object {
   static void SetCachedHash(ObjectPtr obj, uint32_t hash) {
     obj->ptr()->hash_ = hash;
   }
+
+  // Sets the hash of |obj| unless another thread has set it already, and
+  // returns the hash |obj| has afterwards.
+  static uint32_t SetCachedHashIfNotSet(ObjectPtr obj, uint32_t hash) {
+    uint32_t expected = 0;
+    if (reinterpret_cast<std::atomic<uint32_t>*>(&obj->ptr()->hash_)
+            ->compare_exchange_strong(expected, hash,
+                                      std::memory_order_relaxed)) {
+      return hash;
+    }
+    return expected;
+  }
 #endif
 
   // The list below enumerates read-only handles for singleton
@@ -1416,6 +1428,13 @@ class Class : public Object {
   }
   void set_is_allocated(bool value) const;
 
+  // Whether optimized code relying on CHA for this class was deoptimized
+  // because the class was extended or implemented by a class loaded later.
+  bool is_cha_deoptimized() const {
+    return IsCHADeoptimizedBit::decode(raw_ptr()->state_bits_);
+  }
+  void set_is_cha_deoptimized(bool value) const;
+
   bool is_loaded() const { return IsLoadedBit::decode(raw_ptr()->state_bits_); }
   void set_is_loaded(bool value) const;
 
@@ -1685,6 +1704,7 @@ class Class : public Object {
     kIsAllocatedBit,
     kIsLoadedBit,
     kHasPragmaBit,
+    kIsCHADeoptimizedBit,
   };
   class ConstBit : public BitField<uint32_t, bool, kConstBit, 1> {};
   class ImplementedBit : public BitField<uint32_t, bool, kImplementedBit, 1> {};
@@ -1707,6 +1727,8 @@ class Class : public Object {
   class IsAllocatedBit : public BitField<uint32_t, bool, kIsAllocatedBit, 1> {};
   class IsLoadedBit : public BitField<uint32_t, bool, kIsLoadedBit, 1> {};
   class HasPragmaBit : public BitField<uint32_t, bool, kHasPragmaBit, 1> {};
+  class IsCHADeoptimizedBit
+      : public BitField<uint32_t, bool, kIsCHADeoptimizedBit, 1> {};
 
   void set_name(const String& value) const;
   void set_user_name(const String& value) const;
@@ -2518,6 +2540,20 @@ class Function : public Object {
   // Can only be called on FFI trampolines.
   void SetFfiCallbackId(int32_t value) const;
 
+  // Can only be called on FFI trampolines.
+  // True for Dart -> native calls which skip the safepoint transition.
+  bool FfiIsLeaf() const;
+
+  // Can only be called on FFI trampolines.
+  void SetFfiIsLeaf(bool is_leaf) const;
+
+  // Can only be called on FFI trampolines.
+  // True for Dart -> native calls which look up their target on the first call.
+  bool FfiIsLazy() const;
+
+  // Can only be called on FFI trampolines.
+  void SetFfiIsLazy(bool is_lazy) const;
+
   // Can only be called on FFI trampolines.
   // Null for Dart -> native calls.
   FunctionPtr FfiCallbackTarget() const;
@@ -3971,6 +4007,12 @@ class FfiTrampolineData : public Object {
   int32_t callback_id() const { return raw_ptr()->callback_id_; }
   void set_callback_id(int32_t value) const;
 
+  bool is_leaf() const { return raw_ptr()->is_leaf_; }
+  void set_is_leaf(bool value) const;
+
+  bool is_lazy() const { return raw_ptr()->is_lazy_; }
+  void set_is_lazy(bool value) const;
+
   static FfiTrampolineDataPtr New();
 
   FINAL_HEAP_OBJECT_IMPLEMENTATION(FfiTrampolineData, Object);
@@ -4890,6 +4932,16 @@ class Library : public Object {
                     std::memory_order_relaxed>(
         &raw_ptr()->native_entry_symbol_resolver_, native_symbol_resolver);
   }
+  // Resolving functions annotated with @FfiNative.
+  Dart_FfiNativeResolver ffi_native_resolver() const {
+    return LoadNonPointer<Dart_FfiNativeResolver, std::memory_order_relaxed>(
+        &raw_ptr()->ffi_native_resolver_);
+  }
+  void set_ffi_native_resolver(Dart_FfiNativeResolver value) const {
+    StoreNonPointer<Dart_FfiNativeResolver, Dart_FfiNativeResolver,
+                    std::memory_order_relaxed>(&raw_ptr()->ffi_native_resolver_,
+                                               value);
+  }
 
   bool is_in_fullsnapshot() const {
     return LibraryLayout::InFullSnapshotBit::decode(raw_ptr()->flags_);
@@ -5694,10 +5746,12 @@ class PcDescriptors : public Object {
           cur_yield_index_(PcDescriptorsLayout::kInvalidYieldIndex) {}
 
     bool MoveNext() {
+      NoSafepointScope no_safepoint;
+      const uint8_t* data = descriptors_.raw_ptr()->data();
+      const intptr_t length = descriptors_.Length();
       // Moves to record that matches kind_mask_.
-      while (byte_index_ < descriptors_.Length()) {
-        const int32_t kind_and_metadata =
-            descriptors_.DecodeInteger(&byte_index_);
+      while (byte_index_ < length) {
+        const int32_t kind_and_metadata = DecodeInteger(data, length);
         cur_kind_ =
             PcDescriptorsLayout::KindAndMetadata::DecodeKind(kind_and_metadata);
         cur_try_index_ = PcDescriptorsLayout::KindAndMetadata::DecodeTryIndex(
@@ -5706,11 +5760,11 @@ class PcDescriptors : public Object {
             PcDescriptorsLayout::KindAndMetadata::DecodeYieldIndex(
                 kind_and_metadata);
 
-        cur_pc_offset_ += descriptors_.DecodeInteger(&byte_index_);
+        cur_pc_offset_ += DecodeInteger(data, length);
 
         if (!FLAG_precompiled_mode) {
-          cur_deopt_id_ += descriptors_.DecodeInteger(&byte_index_);
-          cur_token_pos_ += descriptors_.DecodeInteger(&byte_index_);
+          cur_deopt_id_ += DecodeInteger(data, length);
+          cur_token_pos_ += DecodeInteger(data, length);
         }
 
         if ((cur_kind_ & kind_mask_) != 0) {
@@ -5732,6 +5786,18 @@ class PcDescriptors : public Object {
    private:
     friend class PcDescriptors;
 
+    // Most deltas fit in a single byte, so decode those without going
+    // through the general SLEB128 loop.
+    DART_FORCE_INLINE intptr_t DecodeInteger(const uint8_t* data,
+                                             intptr_t length) {
+      const uint8_t part = data[byte_index_];
+      if ((part & 0x80) == 0) {
+        byte_index_++;
+        return static_cast<intptr_t>(part) - ((part & 0x40) << 1);
+      }
+      return Utils::DecodeSLEB128<intptr_t>(data, length, &byte_index_);
+    }
+
     // For nested iterations, starting at element after.
     explicit Iterator(const Iterator& iter)
         : ValueObject(),
@@ -7039,6 +7105,10 @@ class MegamorphicCache : public CallSiteData {
   // The caller must hold Isolate::megamorphic_mutex().
   void EnsureCapacityLocked() const;
   void InsertLocked(const Smi& class_id, const Object& target) const;
+  static void InsertEntry(const Array& buckets,
+                          intptr_t mask,
+                          const Smi& class_id,
+                          const Object& target);
 
   static inline void SetEntry(const Array& array,
                               intptr_t index,
@@ -8857,6 +8927,9 @@ class String : public Instance {
   }
   static bool StartsWith(StringPtr str, StringPtr prefix);
   bool EndsWith(const String& other) const;
+  // Returns the index of the first occurrence of |pattern| at or after
+  // |start|, or -1 if there is none.
+  intptr_t IndexOf(const String& pattern, intptr_t start) const;
 
   // Strings are canonicalized using the symbol table.
   virtual InstancePtr CheckAndCanonicalize(Thread* thread,
@@ -9205,6 +9278,7 @@ class OneByteString : public AllStatic {
   friend class ExternalOneByteString;
   friend class SnapshotReader;
   friend class StringHasher;
+  friend class JsonParser;
   friend class Utf8;
 };
 
@@ -9329,6 +9403,7 @@ class TwoByteString : public AllStatic {
   friend class String;
   friend class SnapshotReader;
   friend class Symbols;
+  friend class Utf8;
 };
 
 class ExternalOneByteString : public AllStatic {
@@ -9520,6 +9595,7 @@ class ExternalTwoByteString : public AllStatic {
   friend class String;
   friend class SnapshotReader;
   friend class Symbols;
+  friend class Utf8;
 };
 
 // Class Bool implements Dart core class bool.
@@ -9563,6 +9639,11 @@ class Array : public Instance {
   // architecture.
   static const intptr_t kHashBits = 30;
 
+  // Arrays of at most this length are added to the remembered set by
+  // Thread::RememberLiveTemporaries, so write barrier elimination may treat
+  // them like other allocations across instructions which can trigger GC.
+  static constexpr intptr_t kMaxLengthForWriteBarrierElimination = 16;
+
   // Returns `true` if we use card marking for arrays of length [array_length].
   static bool UseCardMarkingForAllocation(const intptr_t array_length) {
     return Array::InstanceSize(array_length) > Heap::kNewAllocatableSize;
@@ -9608,6 +9689,13 @@ class Array : public Instance {
     StoreArrayPointer<ObjectPtr, order>(ObjectAddr(index), value.raw());
   }
 
+  // Copies |count| elements of |source| from |source_start| on into this array
+  // from |start| on, like SetAt but without handles. The ranges may overlap.
+  void CopyRange(intptr_t start,
+                 const Array& source,
+                 intptr_t source_start,
+                 intptr_t count) const;
+
   // Access to the array with acquire release semantics.
   ObjectPtr AtAcquire(intptr_t index) const {
     return At<std::memory_order_acquire>(index);
@@ -9691,6 +9779,12 @@ class Array : public Instance {
   // during garbage collection.
   void Truncate(intptr_t new_length) const;
 
+  // Extends the array to 'new_length' null-initialized elements without moving
+  // it, which is only possible if it is the last object allocated in the
+  // new-space buffer of the current thread and the buffer has room. Returns
+  // whether it was extended.
+  bool TryGrowInPlace(intptr_t new_length) const;
+
   // Return an Array object that contains all the elements currently present
   // in the specified Growable Object Array. This is done by first truncating
   // the Growable Object Array's backing array to the currently used size and
@@ -9729,16 +9823,27 @@ class Array : public Instance {
   }
 
   // Store a range of pointers [from, from + count) into [to, to + count).
+  // The ranges may overlap.
   // TODO(koda): Use this to fix Object::Clone's broken store buffer logic.
   void StoreArrayPointers(ObjectPtr const* to,
                           ObjectPtr const* from,
-                          intptr_t count) {
+                          intptr_t count) const {
     ASSERT(Contains(reinterpret_cast<uword>(to)));
-    if (raw()->IsNewObject()) {
+    Thread* thread = Thread::Current();
+    // Stores into new arrays never need a barrier. Neither do stores into
+    // old arrays which are already in the store buffer while not marking.
+    if (raw()->IsNewObject() ||
+        ((thread->write_barrier_mask() ==
+          ObjectLayout::kGenerationalBarrierMask) &&
+         raw()->ptr()->IsRemembered())) {
       memmove(const_cast<ObjectPtr*>(to), from, count * kWordSize);
-    } else {
+    } else if (to <= from) {
       for (intptr_t i = 0; i < count; ++i) {
-        StoreArrayPointer(&to[i], from[i]);
+        raw()->ptr()->StoreArrayPointer(&to[i], from[i], thread);
+      }
+    } else {
+      for (intptr_t i = count - 1; i >= 0; --i) {
+        raw()->ptr()->StoreArrayPointer(&to[i], from[i], thread);
       }
     }
   }
@@ -10595,6 +10700,7 @@ class LinkedHashMap : public Instance {
   static LinkedHashMapPtr NewUninitialized(Heap::Space space = Heap::kNew);
 
   friend class Class;
+  friend class JsonParser;
   friend class LinkedHashMapDeserializationCluster;
 };
 
@@ -10922,6 +11028,14 @@ class RegExp : public Instance {
     return raw_ptr()->num_bracket_expressions_;
   }
   ArrayPtr capture_name_map() const { return raw_ptr()->capture_name_map_; }
+  StringPtr required_literal() const { return raw_ptr()->required_literal_; }
+  static intptr_t required_literal_offset() {
+    return OFFSET_OF(RegExpLayout, required_literal_);
+  }
+  TypedDataPtr linear_program() const { return raw_ptr()->linear_program_; }
+  static intptr_t linear_program_offset() {
+    return OFFSET_OF(RegExpLayout, linear_program_);
+  }
 
   TypedDataPtr bytecode(bool is_one_byte, bool sticky) const {
     if (sticky) {
@@ -10979,6 +11093,8 @@ class RegExp : public Instance {
 
   void set_num_bracket_expressions(intptr_t value) const;
   void set_capture_name_map(const Array& array) const;
+  void set_required_literal(const String& literal) const;
+  void set_linear_program(const TypedData& program) const;
   void set_is_global() const {
     RegExpFlags f = flags();
     f.SetGlobal();
@@ -606,6 +606,10 @@ void HeapSnapshotWriter::EnsureAvailable(intptr_t needed) {
 
   if (buffer_ != nullptr) {
     Flush();
+    if (capacity_ - size_ >= needed) {
+      // The streaming writer reuses its buffer.
+      return;
+    }
   }
   ASSERT(buffer_ == nullptr);
 
@@ -623,6 +627,23 @@ void HeapSnapshotWriter::Flush(bool last) {
     return;
   }
 
+  if (callback_ != nullptr) {
+    if (size_ > kMetadataReservation) {
+      callback_(callback_data_, &buffer_[kMetadataReservation],
+                size_ - kMetadataReservation);
+    }
+    if (!last && (capacity_ == kPreferredChunkSize)) {
+      size_ = kMetadataReservation;
+      return;
+    }
+    // Oversized chunks are not kept around.
+    free(buffer_);
+    buffer_ = nullptr;
+    size_ = 0;
+    capacity_ = 0;
+    return;
+  }
+
   JSONStream js;
   {
     JSONObject jsobj(&js);
@@ -935,6 +956,8 @@ class Pass2Visitor : public ObjectVisitor,
   void ScrubAndWriteUtf8(StringPtr str) {
     if (str == String::null()) {
       writer_->WriteUtf8("null");
+    } else if (WriteAsciiPrefix(str)) {
+      // Written without a copy.
     } else {
       String handle;
       handle = str;
@@ -944,6 +967,28 @@ class Pass2Visitor : public ObjectVisitor,
     }
   }
 
+  // Most names are ASCII. Writes the part of |str| before the first '@' in
+  // place, the same result as ScrubAndWriteUtf8 on its C string, and returns
+  // false if |str| needs converting instead.
+  bool WriteAsciiPrefix(StringPtr str) {
+    if (str->GetClassId() != kOneByteStringCid) {
+      return false;
+    }
+    OneByteStringPtr one_byte = static_cast<OneByteStringPtr>(str);
+    const uint8_t* data = &one_byte->ptr()->data()[0];
+    const intptr_t len = Smi::Value(one_byte->ptr()->length_);
+    intptr_t prefix = 0;
+    while ((prefix < len) && (data[prefix] != '@')) {
+      if ((data[prefix] == 0) || (data[prefix] >= 0x80)) {
+        return false;
+      }
+      prefix++;
+    }
+    writer_->WriteUnsigned(prefix);
+    writer_->WriteBytes(data, prefix);
+    return true;
+  }
+
   void set_discount_sizes(bool value) { discount_sizes_ = value; }
 
   void DoCount() {
@@ -1175,6 +1220,348 @@ void HeapSnapshotWriter::Write() {
   Flush(true);
 }
 
+// Numbers the heap objects in iteration order, starting at 1 since the root
+// is node 0, and counts the references between them.
+class DominatorCountVisitor : public ObjectVisitor,
+                              public ObjectPointerVisitor {
+ public:
+  explicit DominatorCountVisitor(Thread* thread)
+      : ObjectVisitor(),
+        ObjectPointerVisitor(thread->isolate_group()),
+        heap_(thread->heap()),
+        isolate_(thread->isolate()) {}
+
+  void VisitObject(ObjectPtr obj) {
+    if (obj->IsPseudoObject()) return;
+    heap_->SetObjectId(obj, ++node_count_);
+    obj->ptr()->VisitPointersPrecise(isolate_, this);
+  }
+
+  void VisitPointers(ObjectPtr* from, ObjectPtr* to) {
+    edge_count_ += to - from + 1;
+  }
+
+  intptr_t node_count() const { return node_count_; }
+  intptr_t edge_count() const { return edge_count_; }
+
+ private:
+  Heap* heap_;
+  Isolate* isolate_;
+  intptr_t node_count_ = 0;
+  intptr_t edge_count_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(DominatorCountVisitor);
+};
+
+// Records the references of each node, in the same order as the
+// DominatorCountVisitor numbered them, as compressed adjacency arrays.
+class DominatorEdgeVisitor : public ObjectVisitor, public ObjectPointerVisitor {
+ public:
+  DominatorEdgeVisitor(Thread* thread,
+                       intptr_t* offsets,
+                       uint32_t* edges,
+                       intptr_t* sizes,
+                       uint32_t* cids)
+      : ObjectVisitor(),
+        ObjectPointerVisitor(thread->isolate_group()),
+        heap_(thread->heap()),
+        isolate_(thread->isolate()),
+        offsets_(offsets),
+        edges_(edges),
+        sizes_(sizes),
+        cids_(cids) {
+    // The root.
+    offsets_[0] = 0;
+    sizes_[0] = 0;
+    cids_[0] = kIllegalCid;
+  }
+
+  void VisitObject(ObjectPtr obj) {
+    if (obj->IsPseudoObject()) return;
+    const intptr_t node = ++node_;
+    ASSERT(heap_->GetObjectId(obj) == node);
+    offsets_[node] = cursor_;
+    sizes_[node] = obj->ptr()->HeapSize();
+    cids_[node] = obj->GetClassId();
+    obj->ptr()->VisitPointersPrecise(isolate_, this);
+  }
+
+  void VisitPointers(ObjectPtr* from, ObjectPtr* to) {
+    for (ObjectPtr* ptr = from; ptr <= to; ptr++) {
+      ObjectPtr target = *ptr;
+      if (!target->IsHeapObject()) {
+        continue;
+      }
+      const intptr_t id = heap_->GetObjectId(target);
+      if (id == 0) {
+        // Not numbered, e.g. an alias of write-protected instructions.
+        continue;
+      }
+      edges_[cursor_++] = static_cast<uint32_t>(id);
+    }
+  }
+
+  void Finish() { offsets_[node_ + 1] = cursor_; }
+
+ private:
+  Heap* heap_;
+  Isolate* isolate_;
+  intptr_t* offsets_;
+  uint32_t* edges_;
+  intptr_t* sizes_;
+  uint32_t* cids_;
+  intptr_t node_ = 0;
+  intptr_t cursor_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(DominatorEdgeVisitor);
+};
+
+// The semi-NCA path compression of Lengauer-Tarjan, without recursion so deep
+// object graphs don't overflow the stack. Nodes are DFS numbers.
+static uint32_t DominatorEval(uint32_t v,
+                              uint32_t* ancestor,
+                              uint32_t* label,
+                              const uint32_t* semi,
+                              MallocGrowableArray<uint32_t>* path) {
+  if (ancestor[v] == 0) {
+    return v;
+  }
+  path->Clear();
+  path->Add(v);
+  while (ancestor[ancestor[path->Last()]] != 0) {
+    path->Add(ancestor[path->Last()]);
+  }
+  // The topmost node of the path is already compressed.
+  path->RemoveLast();
+  while (!path->is_empty()) {
+    const uint32_t x = path->RemoveLast();
+    const uint32_t a = ancestor[x];
+    if (semi[label[a]] < semi[label[x]]) {
+      label[x] = label[a];
+    }
+    ancestor[x] = ancestor[a];
+  }
+  return label[v];
+}
+
+static int CompareClassRetainedSize(
+    const HeapDominatorAnalysis::ClassRetainedSize* a,
+    const HeapDominatorAnalysis::ClassRetainedSize* b) {
+  if (a->retained_size != b->retained_size) {
+    return a->retained_size > b->retained_size ? -1 : 1;
+  }
+  return a->cid < b->cid ? -1 : (a->cid > b->cid ? 1 : 0);
+}
+
+void HeapDominatorAnalysis::TopRetainersByClass(
+    intptr_t limit,
+    MallocGrowableArray<ClassRetainedSize>* result) {
+  ASSERT(limit >= 0);
+  result->Clear();
+  const intptr_t num_cids = isolate_group()->shared_class_table()->NumCids();
+
+  // Capture the graph, with node 0 standing for the roots. This is the only
+  // part that needs the heap to stand still.
+  intptr_t node_count;
+  std::unique_ptr<intptr_t[]> offsets;
+  std::unique_ptr<uint32_t[]> edges;
+  std::unique_ptr<intptr_t[]> sizes;
+  std::unique_ptr<uint32_t[]> cids;
+  {
+    HeapIterationScope iteration(thread());
+    DominatorCountVisitor counter(thread());
+    isolate()->VisitObjectPointers(&counter,
+                                   ValidationPolicy::kDontValidateFrames);
+    iteration.IterateVMIsolateObjects(&counter);
+    iteration.IterateObjects(&counter);
+    node_count = counter.node_count() + 1;
+    RELEASE_ASSERT(node_count < kMaxUint32);
+
+    offsets.reset(new intptr_t[node_count + 1]);
+    edges.reset(new uint32_t[counter.edge_count()]);
+    sizes.reset(new intptr_t[node_count]);
+    cids.reset(new uint32_t[node_count]);
+    DominatorEdgeVisitor recorder(thread(), offsets.get(), edges.get(),
+                                  sizes.get(), cids.get());
+    isolate()->VisitObjectPointers(&recorder,
+                                   ValidationPolicy::kDontValidateFrames);
+    iteration.IterateVMIsolateObjects(&recorder);
+    iteration.IterateObjects(&recorder);
+    recorder.Finish();
+    thread()->heap()->ResetObjectIdTable();
+  }
+
+  // Depth-first numbering from the root, 1-based so 0 can mean "none".
+  std::unique_ptr<uint32_t[]> number(new uint32_t[node_count]());
+  std::unique_ptr<uint32_t[]> vertex(new uint32_t[node_count + 1]);
+  std::unique_ptr<uint32_t[]> parent(new uint32_t[node_count + 1]);
+  intptr_t n = 0;
+  {
+    MallocGrowableArray<uint32_t> stack_nodes;
+    MallocGrowableArray<intptr_t> stack_edges;
+    number[0] = ++n;
+    vertex[n] = 0;
+    parent[n] = 0;
+    stack_nodes.Add(0);
+    stack_edges.Add(offsets[0]);
+    while (!stack_nodes.is_empty()) {
+      const uint32_t node = stack_nodes.Last();
+      const intptr_t edge = stack_edges.Last();
+      if (edge == offsets[node + 1]) {
+        stack_nodes.RemoveLast();
+        stack_edges.RemoveLast();
+        continue;
+      }
+      stack_edges.Last() = edge + 1;
+      const uint32_t target = edges[edge];
+      if (number[target] == 0) {
+        number[target] = ++n;
+        vertex[n] = target;
+        parent[n] = number[node];
+        stack_nodes.Add(target);
+        stack_edges.Add(offsets[target]);
+      }
+    }
+  }
+
+  // Predecessors of the reachable nodes, by DFS number.
+  std::unique_ptr<intptr_t[]> pred_offsets(new intptr_t[n + 2]());
+  for (intptr_t v = 1; v <= n; v++) {
+    const uint32_t node = vertex[v];
+    for (intptr_t e = offsets[node]; e < offsets[node + 1]; e++) {
+      pred_offsets[number[edges[e]]]++;
+    }
+  }
+  for (intptr_t w = 1; w <= n + 1; w++) {
+    pred_offsets[w] += pred_offsets[w - 1];
+  }
+  std::unique_ptr<uint32_t[]> preds(new uint32_t[pred_offsets[n + 1]]);
+  for (intptr_t v = 1; v <= n; v++) {
+    const uint32_t node = vertex[v];
+    for (intptr_t e = offsets[node]; e < offsets[node + 1]; e++) {
+      preds[--pred_offsets[number[edges[e]]]] = v;
+    }
+  }
+  edges.reset();
+  offsets.reset();
+  number.reset();
+
+  // Lengauer-Tarjan. Every node but the root is processed in reverse DFS
+  // order, computing its semi-dominator and, through the buckets, the
+  // immediate dominators of the nodes it semi-dominates.
+  std::unique_ptr<uint32_t[]> semi(new uint32_t[n + 1]);
+  std::unique_ptr<uint32_t[]> label(new uint32_t[n + 1]);
+  std::unique_ptr<uint32_t[]> ancestor(new uint32_t[n + 1]());
+  std::unique_ptr<uint32_t[]> idom(new uint32_t[n + 1]());
+  std::unique_ptr<uint32_t[]> bucket_head(new uint32_t[n + 1]());
+  std::unique_ptr<uint32_t[]> bucket_next(new uint32_t[n + 1]());
+  for (intptr_t v = 1; v <= n; v++) {
+    semi[v] = v;
+    label[v] = v;
+  }
+  {
+    MallocGrowableArray<uint32_t> path;
+    for (intptr_t w = n; w >= 2; w--) {
+      for (intptr_t e = pred_offsets[w]; e < pred_offsets[w + 1]; e++) {
+        const uint32_t u = DominatorEval(preds[e], ancestor.get(),
+                                         label.get(), semi.get(), &path);
+        if (semi[u] < semi[w]) {
+          semi[w] = semi[u];
+        }
+      }
+      bucket_next[w] = bucket_head[semi[w]];
+      bucket_head[semi[w]] = w;
+      const uint32_t p = parent[w];
+      ancestor[w] = p;
+      for (uint32_t v = bucket_head[p]; v != 0; v = bucket_next[v]) {
+        const uint32_t u = DominatorEval(v, ancestor.get(), label.get(),
+                                         semi.get(), &path);
+        idom[v] = semi[u] < semi[v] ? u : p;
+      }
+      bucket_head[p] = 0;
+    }
+  }
+  for (intptr_t w = 2; w <= n; w++) {
+    if (idom[w] != semi[w]) {
+      idom[w] = idom[idom[w]];
+    }
+  }
+  preds.reset();
+  pred_offsets.reset();
+  semi.reset();
+  label.reset();
+  ancestor.reset();
+  bucket_head.reset();
+  bucket_next.reset();
+
+  // A node's dominator always has a smaller DFS number.
+  std::unique_ptr<intptr_t[]> retained(new intptr_t[n + 1]);
+  for (intptr_t v = 1; v <= n; v++) {
+    retained[v] = sizes[vertex[v]];
+  }
+  for (intptr_t v = n; v >= 2; v--) {
+    retained[idom[v]] += retained[v];
+  }
+
+  // Walk the dominator tree, counting an instance towards its class unless an
+  // instance of the same class dominates it.
+  std::unique_ptr<intptr_t[]> child_offsets(new intptr_t[n + 2]());
+  for (intptr_t v = 2; v <= n; v++) {
+    child_offsets[idom[v]]++;
+  }
+  for (intptr_t v = 1; v <= n + 1; v++) {
+    child_offsets[v] += child_offsets[v - 1];
+  }
+  std::unique_ptr<uint32_t[]> children(new uint32_t[n]);
+  for (intptr_t v = n; v >= 2; v--) {
+    children[--child_offsets[idom[v]]] = v;
+  }
+
+  std::unique_ptr<intptr_t[]> on_path(new intptr_t[num_cids]());
+  std::unique_ptr<intptr_t[]> class_count(new intptr_t[num_cids]());
+  std::unique_ptr<intptr_t[]> class_retained(new intptr_t[num_cids]());
+  {
+    MallocGrowableArray<uint32_t> stack_nodes;
+    MallocGrowableArray<intptr_t> stack_children;
+    stack_nodes.Add(1);
+    stack_children.Add(child_offsets[1]);
+    while (!stack_nodes.is_empty()) {
+      const uint32_t v = stack_nodes.Last();
+      const intptr_t child = stack_children.Last();
+      if (child == child_offsets[v + 1]) {
+        stack_nodes.RemoveLast();
+        stack_children.RemoveLast();
+        if (v != 1) {
+          on_path[cids[vertex[v]]]--;
+        }
+        continue;
+      }
+      stack_children.Last() = child + 1;
+      const uint32_t w = children[child];
+      const uint32_t cid = cids[vertex[w]];
+      ASSERT(cid < num_cids);
+      class_count[cid]++;
+      if (on_path[cid] == 0) {
+        class_retained[cid] += retained[w];
+      }
+      on_path[cid]++;
+      stack_nodes.Add(w);
+      stack_children.Add(child_offsets[w]);
+    }
+  }
+
+  for (intptr_t cid = 1; cid < num_cids; cid++) {
+    if (class_count[cid] != 0) {
+      ClassRetainedSize entry = {cid, class_count[cid], class_retained[cid]};
+      result->Add(entry);
+    }
+  }
+  result->Sort(CompareClassRetainedSize);
+  if (result->length() > limit) {
+    result->TruncateTo(limit);
+  }
+}
+
 CountObjectsVisitor::CountObjectsVisitor(Thread* thread, intptr_t class_count)
     : ObjectVisitor(),
       HandleVisitor(thread),
@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "include/dart_api.h"
 #include "vm/allocation.h"
 #include "vm/dart_api_state.h"
 #include "vm/thread_stack_resource.h"
@@ -117,12 +118,54 @@ class ObjectGraph : public ThreadStackResource {
   DISALLOW_IMPLICIT_CONSTRUCTORS(ObjectGraph);
 };
 
+// Computes the dominator tree of the heap with the Lengauer-Tarjan algorithm,
+// and from it the memory retained by each object.
+//
+// Unlike ObjectGraph::SizeRetainedBy*, which mark the heap once per root, one
+// analysis answers the question for every object at once. The heap is only
+// iterated to copy the graph into native memory as compressed adjacency
+// arrays; the analysis itself runs on the copy. Peak use is about 8 bytes per
+// reference plus 64 bytes per object, all freed before returning.
+class HeapDominatorAnalysis : public ThreadStackResource {
+ public:
+  struct ClassRetainedSize {
+    intptr_t cid;
+    intptr_t instance_count;
+    intptr_t retained_size;
+  };
+
+  explicit HeapDominatorAnalysis(Thread* thread)
+      : ThreadStackResource(thread) {}
+
+  // Fills |result| with at most |limit| classes, ordered by the memory their
+  // instances retain, largest first. An instance dominated by another
+  // instance of its class is not counted again, so the sums never include
+  // the same object twice.
+  void TopRetainersByClass(intptr_t limit,
+                           MallocGrowableArray<ClassRetainedSize>* result);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(HeapDominatorAnalysis);
+};
+
 // Generates a dump of the heap, whose format is described in
 // runtime/vm/service/heap_snapshot.md.
 class HeapSnapshotWriter : public ThreadStackResource {
  public:
+  // Sends the snapshot as HeapSnapshot service events.
   explicit HeapSnapshotWriter(Thread* thread) : ThreadStackResource(thread) {}
 
+  // Hands the snapshot to |callback| one chunk at a time, reusing the same
+  // buffer, so native memory use stays at one chunk regardless of heap size.
+  // The callback runs while the heap is being iterated and must not call into
+  // the VM.
+  HeapSnapshotWriter(Thread* thread,
+                     Dart_StreamingWriteCallback callback,
+                     void* callback_data)
+      : ThreadStackResource(thread),
+        callback_(callback),
+        callback_data_(callback_data) {}
+
   void WriteSigned(int64_t value) {
     EnsureAvailable((sizeof(value) * kBitsPerByte) / 7 + 1);
 
@@ -197,6 +240,9 @@ class HeapSnapshotWriter : public ThreadStackResource {
   void EnsureAvailable(intptr_t needed);
   void Flush(bool last = false);
 
+  Dart_StreamingWriteCallback callback_ = nullptr;
+  void* callback_data_ = nullptr;
+
   uint8_t* buffer_ = nullptr;
   intptr_t size_ = 0;
   intptr_t capacity_ = 0;
@@ -275,7 +275,8 @@ class ObjectPointerVisitor;
   RW(Array, dart_args_2)                                                       \
   R_(GrowableObjectArray, resume_capabilities)                                 \
   R_(GrowableObjectArray, exit_listeners)                                      \
-  R_(GrowableObjectArray, error_listeners)
+  R_(GrowableObjectArray, error_listeners)                                     \
+  RW(Array, osr_code_cache)
 // Please remember the last entry must be referred in the 'to' function below.
 
 class IsolateObjectStore {
@@ -332,7 +333,7 @@ class IsolateObjectStore {
   ISOLATE_OBJECT_STORE_FIELD_LIST(DECLARE_OBJECT_STORE_FIELD,
                                   DECLARE_OBJECT_STORE_FIELD)
 #undef DECLARE_OBJECT_STORE_FIELD
-  ObjectPtr* to() { return reinterpret_cast<ObjectPtr*>(&error_listeners_); }
+  ObjectPtr* to() { return reinterpret_cast<ObjectPtr*>(&osr_code_cache_); }
 
   ObjectStore* object_store_;
 
@@ -15,6 +15,7 @@
 #include "vm/code_descriptors.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/compiler_state.h"
+#include "vm/compiler/jit/compiler.h"
 #include "vm/dart_api_impl.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
@@ -4052,6 +4053,160 @@ TEST_CASE(FunctionWithBreakpointNotInlined) {
   }
 }
 
+TEST_CASE(BreakpointKeepsUnrelatedOptimizedCode) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  a() => 1;\n"  // This is line 2.
+      "  b() => a();\n"
+      "  c() => 3;\n"
+      "}\n"
+      "test() {\n"
+      "  final x = new A();\n"
+      "  x.b();\n"
+      "  x.c();\n"
+      "}";
+  const int kBreakpointLine = 2;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+
+  bool b_inlines_a = false;
+  {
+    TransitionNativeToVM transition(thread);
+    const String& name = String::Handle(String::New(TestCase::url()));
+    const Library& vmlib =
+        Library::Handle(Library::LookupLibrary(thread, name));
+    const Class& class_a = Class::Handle(
+        vmlib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+    const Function& func_a = Function::Handle(GetFunction(class_a, "a"));
+    const Function& func_b = Function::Handle(GetFunction(class_a, "b"));
+    const Function& func_c = Function::Handle(GetFunction(class_a, "c"));
+    EXPECT(Object::Handle(Compiler::CompileOptimizedFunction(thread, func_b))
+               .IsCode());
+    EXPECT(Object::Handle(Compiler::CompileOptimizedFunction(thread, func_c))
+               .IsCode());
+    EXPECT(func_b.HasOptimizedCode());
+    EXPECT(func_c.HasOptimizedCode());
+    const Array& inlined = Array::Handle(
+        Code::Handle(func_b.CurrentCode()).inlined_id_to_function());
+    for (intptr_t i = 0; !inlined.IsNull() && (i < inlined.Length()); i++) {
+      b_inlines_a = b_inlines_a || (inlined.At(i) == func_a.raw());
+    }
+  }
+
+  result = Dart_SetBreakpoint(NewString(TestCase::url()), kBreakpointLine);
+  EXPECT_VALID(result);
+
+  // Only the code into which A.a was inlined is deoptimized.
+  {
+    TransitionNativeToVM transition(thread);
+    const String& name = String::Handle(String::New(TestCase::url()));
+    const Library& vmlib =
+        Library::Handle(Library::LookupLibrary(thread, name));
+    const Class& class_a = Class::Handle(
+        vmlib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+    const Function& func_b = Function::Handle(GetFunction(class_a, "b"));
+    const Function& func_c = Function::Handle(GetFunction(class_a, "c"));
+    EXPECT(func_b.HasOptimizedCode() != b_inlines_a);
+    EXPECT(func_c.HasOptimizedCode());
+  }
+}
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+static const char* kOsrScriptChars =
+    "class A {\n"
+    "  static int add(int i) {\n"
+    "    return i + 1;\n"  // This is line 3.
+    "  }\n"
+    "  static int loop(int n) {\n"
+    "    var sum = 0;\n"
+    "    for (var i = 0; i < n; i++) {\n"
+    "      sum += add(i);\n"
+    "    }\n"
+    "    return sum;\n"
+    "  }\n"
+    "}\n"
+    "test() => A.loop(10000);\n";
+
+// Returns the OSR code of [function] in the isolate's OSR code cache, or null.
+static CodePtr CachedOsrCode(const Function& function) {
+  const Array& cache = Array::Handle(
+      Isolate::Current()->isolate_object_store()->osr_code_cache());
+  Object& entry = Object::Handle();
+  for (intptr_t i = 0; !cache.IsNull() && (i < cache.Length()); i++) {
+    entry = cache.At(i);
+    if (entry.IsCode() && Code::Cast(entry).is_optimized() &&
+        (Code::Cast(entry).function() == function.raw())) {
+      return Code::Cast(entry).raw();
+    }
+  }
+  return Code::null();
+}
+
+static FunctionPtr GetOsrLoopFunction(Thread* thread) {
+  const String& name = String::Handle(String::New(TestCase::url()));
+  const Library& vmlib = Library::Handle(Library::LookupLibrary(thread, name));
+  EXPECT(!vmlib.IsNull());
+  const Class& class_a = Class::Handle(
+      vmlib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  return GetStaticFunction(class_a, "loop");
+}
+
+TEST_CASE(OsrCodeIsReused) {
+  // The OSR threshold is compiled into the unoptimized code of the loop.
+  SetFlagScope<int> sfs(&FLAG_optimization_counter_threshold, 100);
+  Dart_Handle lib = TestCase::LoadTestScript(kOsrScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+
+  Dart_Handle osr_code;
+  {
+    TransitionNativeToVM transition(thread);
+    const Function& loop = Function::Handle(GetOsrLoopFunction(thread));
+    EXPECT(CachedOsrCode(loop) != Code::null());
+    osr_code = Api::NewHandle(thread, CachedOsrCode(loop));
+    EXPECT(!loop.HasOptimizedCode());
+    // Keep the next call from optimizing the whole function on entry, so it
+    // enters the loop in unoptimized code and requests OSR again.
+    loop.SetUsageCounter(0);
+  }
+
+  result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+  {
+    TransitionNativeToVM transition(thread);
+    const Function& loop = Function::Handle(GetOsrLoopFunction(thread));
+    EXPECT(Api::UnwrapHandle(osr_code) == CachedOsrCode(loop));
+  }
+}
+
+TEST_CASE(OsrCodeIsDroppedForBreakpoint) {
+  SetFlagScope<int> sfs(&FLAG_optimization_counter_threshold, 100);
+  const int kBreakpointLine = 3;
+  Dart_Handle lib = TestCase::LoadTestScript(kOsrScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle result = Dart_Invoke(lib, NewString("test"), 0, NULL);
+  EXPECT_VALID(result);
+  {
+    TransitionNativeToVM transition(thread);
+    const Function& loop = Function::Handle(GetOsrLoopFunction(thread));
+    EXPECT(CachedOsrCode(loop) != Code::null());
+  }
+
+  // A.add may be inlined into the cached OSR code, which would then miss the
+  // breakpoint.
+  result = Dart_SetBreakpoint(NewString(TestCase::url()), kBreakpointLine);
+  EXPECT_VALID(result);
+  {
+    TransitionNativeToVM transition(thread);
+    const Function& loop = Function::Handle(GetOsrLoopFunction(thread));
+    EXPECT(CachedOsrCode(loop) == Code::null());
+  }
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 ISOLATE_UNIT_TEST_CASE(SpecialClassesHaveEmptyArrays) {
   ObjectStore* object_store = Isolate::Current()->object_store();
   Class& cls = Class::Handle();
@@ -72,9 +72,20 @@ class OS {
   // the platform doesn't care. Guaranteed to be a power of two.
   static intptr_t ActivationFrameAlignment();
 
-  // Returns number of available processor cores.
+  // Returns number of available processor cores. On Linux this honors a CPU
+  // quota imposed by the cgroup the process runs in.
   static int NumberOfAvailableProcessors();
 
+  // Returns the memory limit imposed on the process by its container (a
+  // cgroup on Linux) in bytes, or 0 if there is no such limit.
+  static uintptr_t ContainerMemoryLimit();
+
+#if defined(HOST_OS_LINUX)
+  // Reads the cgroup control files from [root] instead of "/sys/fs/cgroup".
+  // Passing nullptr restores the default.
+  static void SetCgroupRootForTesting(const char* root);
+#endif
+
   // Sleep the currently executing thread for millis ms.
   static void Sleep(int64_t millis);
 
@@ -90,7 +90,8 @@ class PerfCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeSourcePositions* positions) {
     Dart_FileWriteCallback file_write = Dart::file_write_callback();
     if ((file_write == NULL) || (out_file_ == NULL)) {
       return;
@@ -121,6 +122,11 @@ class PerfCodeObserver : public CodeObserver {
 //   $ perf inject -j -i perf.data -o perf.data.jitted
 //   $ perf report -i perf.data.jitted
 //
+// Debug info records map the code to Dart source lines, attributing inlined
+// code to the inlined function. Code objects never move, and the load records
+// are timestamped, so perf also attributes samples correctly when collected
+// code is replaced by new code at the same address.
+//
 // [1] see linux/tools/perf/Documentation/jitdump-specification.txt for
 //     JITDUMP binary format.
 class JitDumpCodeObserver : public CodeObserver {
@@ -196,14 +202,19 @@ class JitDumpCodeObserver : public CodeObserver {
                       uword prologue_offset,
                       uword size,
                       bool optimized,
-                      const CodeComments* comments) {
+                      const CodeComments* comments,
+                      const CodeSourcePositions* positions) {
     MutexLocker ml(CodeObservers::mutex());
 
     const char* marker = optimized ? "*" : "";
     char* buffer = OS::SCreate(Thread::Current()->zone(), "%s%s", marker, name);
     const size_t name_length = strlen(buffer);
 
-    WriteDebugInfo(base, comments);
+    if ((positions != nullptr) && (positions->Length() > 0)) {
+      WriteSourcePositions(base, positions);
+    } else {
+      WriteDebugInfo(base, comments);
+    }
 
     CodeLoadEvent ev;
     ev.event = BaseEvent::kLoad;
@@ -219,6 +230,10 @@ class JitDumpCodeObserver : public CodeObserver {
     WriteFully(&ev, sizeof(ev));
     WriteFully(buffer, name_length + 1);
     WriteFully(reinterpret_cast<void*>(base), size);
+
+    // Make the record visible right away, perf-inject may run while a
+    // long-running process is still compiling code.
+    fflush(out_file_);
   }
 
  private:
@@ -359,6 +374,47 @@ class JitDumpCodeObserver : public CodeObserver {
     free(comments_file_name);
   }
 
+  // Maps each range of pcs to the source of the innermost inlined function,
+  // so that perf-annotate and perf-report --sort srcline can show Dart code.
+  void WriteSourcePositions(uword base, const CodeSourcePositions* positions) {
+    const char kFileScheme[] = "file://";
+    const intptr_t kFileSchemeLength = sizeof(kFileScheme) - 1;
+    const intptr_t entry_count = positions->Length();
+
+    DebugInfoEvent info;
+    info.event = BaseEvent::kDebugInfo;
+    info.time_stamp = OS::GetCurrentMonotonicTicks();
+    info.address = base;
+    info.entry_count = entry_count;
+    info.size = sizeof(info);
+    for (intptr_t i = 0; i < entry_count; i++) {
+      const char* file = positions->FileAt(i);
+      if (strncmp(file, kFileScheme, kFileSchemeLength) == 0) {
+        file += kFileSchemeLength;
+      }
+      info.size += sizeof(DebugInfoEntry) + strlen(file) + 1;
+    }
+    const int32_t padding = Utils::RoundUp(info.size, 8) - info.size;
+    info.size += padding;
+
+    WriteFully(&info, sizeof(info));
+    for (intptr_t i = 0; i < entry_count; i++) {
+      const char* file = positions->FileAt(i);
+      if (strncmp(file, kFileScheme, kFileSchemeLength) == 0) {
+        file += kFileSchemeLength;
+      }
+      DebugInfoEntry entry;
+      entry.address = base + positions->PCOffsetAt(i) + kElfHeaderSize;
+      entry.line_number = positions->LineAt(i);
+      entry.column = positions->ColumnAt(i);
+      WriteFully(&entry, sizeof(entry));
+      WriteFully(file, strlen(file) + 1);
+    }
+
+    const char padding_bytes[8] = {0};
+    WriteFully(padding_bytes, padding);
+  }
+
   void WriteHeader() {
     Header header;
     header.elf_mach_target = GetElfMachineArchitecture();
@@ -516,8 +572,94 @@ intptr_t OS::ActivationFrameAlignment() {
   return alignment;
 }
 
+static const char* kDefaultCgroupRoot = "/sys/fs/cgroup";
+static const char* cgroup_root = kDefaultCgroupRoot;
+
+void OS::SetCgroupRootForTesting(const char* root) {
+  cgroup_root = (root != nullptr) ? root : kDefaultCgroupRoot;
+}
+
+// Reads up to [max_values] whitespace-separated integers from the first line
+// of the cgroup control file [path], relative to the cgroup root, into
+// [values]. The keyword "max" reads as -1. Returns the number of values read.
+static intptr_t ReadCgroupValues(const char* path,
+                                 int64_t* values,
+                                 intptr_t max_values) {
+  char full_path[PATH_MAX];
+  Utils::SNPrint(full_path, sizeof(full_path), "%s/%s", cgroup_root, path);
+  FILE* file = fopen(full_path, "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  char buffer[128];
+  char* line = fgets(buffer, sizeof(buffer), file);
+  fclose(file);
+  if (line == nullptr) {
+    return 0;
+  }
+  intptr_t count = 0;
+  char* token = line;
+  while (count < max_values) {
+    while (*token == ' ') {
+      token++;
+    }
+    if (strncmp(token, "max", 3) == 0) {
+      values[count++] = -1;
+      token += 3;
+      continue;
+    }
+    char* end = nullptr;
+    const int64_t value = strtoll(token, &end, 10);
+    if (end == token) {
+      break;
+    }
+    values[count++] = value;
+    token = end;
+  }
+  return count;
+}
+
 int OS::NumberOfAvailableProcessors() {
-  return sysconf(_SC_NPROCESSORS_ONLN);
+  const int online = sysconf(_SC_NPROCESSORS_ONLN);
+  int64_t quota = -1;
+  int64_t period = -1;
+  int64_t values[2];
+  if (ReadCgroupValues("cpu.max", values, 2) == 2) {
+    // cgroup v2: "<quota> <period>", where the quota may be "max".
+    quota = values[0];
+    period = values[1];
+  } else if ((ReadCgroupValues("cpu/cpu.cfs_quota_us", &quota,
+                               1) == 1) &&
+             (ReadCgroupValues("cpu/cpu.cfs_period_us",
+                               &period, 1) == 1)) {
+    // cgroup v1: a quota of -1 means there is no limit.
+  }
+  if ((quota > 0) && (period > 0)) {
+    const int64_t limit = (quota + period - 1) / period;
+    if (limit < online) {
+      return static_cast<int>(limit);
+    }
+  }
+  return online;
+}
+
+uintptr_t OS::ContainerMemoryLimit() {
+  int64_t limit = -1;
+  if ((ReadCgroupValues("memory.max", &limit, 1) != 1) &&
+      (ReadCgroupValues("memory/memory.limit_in_bytes", &limit,
+                        1) != 1)) {
+    return 0;
+  }
+  if (limit <= 0) {
+    return 0;
+  }
+  // cgroup v1 reports a huge value rather than "max" when there is no limit.
+  const int64_t physical =
+      static_cast<int64_t>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGESIZE);
+  if ((physical > 0) && (limit >= physical)) {
+    return 0;
+  }
+  return static_cast<uintptr_t>(limit);
 }
 
 void OS::Sleep(int64_t millis) {
@@ -5,9 +5,18 @@
 #include "vm/os.h"
 #include "platform/assert.h"
 #include "platform/utils.h"
+#include "vm/dart.h"
+#include "vm/flags.h"
 #include "vm/globals.h"
 #include "vm/unit_test.h"
 
+#if defined(HOST_OS_LINUX)
+#include <stdio.h>     // NOLINT
+#include <stdlib.h>    // NOLINT
+#include <sys/stat.h>  // NOLINT
+#include <unistd.h>    // NOLINT
+#endif
+
 namespace dart {
 
 VM_UNIT_TEST_CASE(SNPrint) {
@@ -32,4 +41,110 @@ VM_UNIT_TEST_CASE(OsFuncs) {
   EXPECT_LE(1, procs);
 }
 
+#if defined(HOST_OS_LINUX)
+
+// A temporary directory laid out like /sys/fs/cgroup, which the cgroup limits
+// are read from for the lifetime of the scope.
+class CgroupScope : public ValueObject {
+ public:
+  CgroupScope() : file_count_(0) {
+    Utils::SNPrint(root_, sizeof(root_), "/tmp/cgroup_test_XXXXXX");
+    EXPECT(mkdtemp(root_) != nullptr);
+    Utils::SNPrint(cpu_dir_, sizeof(cpu_dir_), "%s/cpu", root_);
+    Utils::SNPrint(memory_dir_, sizeof(memory_dir_), "%s/memory", root_);
+    mkdir(cpu_dir_, 0700);
+    mkdir(memory_dir_, 0700);
+    OS::SetCgroupRootForTesting(root_);
+  }
+
+  ~CgroupScope() {
+    OS::SetCgroupRootForTesting(nullptr);
+    for (intptr_t i = 0; i < file_count_; i++) {
+      unlink(files_[i]);
+    }
+    rmdir(cpu_dir_);
+    rmdir(memory_dir_);
+    rmdir(root_);
+  }
+
+  void Write(const char* path, const char* contents) {
+    ASSERT(file_count_ < kMaxFiles);
+    char* file_path = files_[file_count_++];
+    Utils::SNPrint(file_path, kPathLength, "%s/%s", root_, path);
+    FILE* file = fopen(file_path, "w");
+    EXPECT(file != nullptr);
+    fputs(contents, file);
+    fclose(file);
+  }
+
+ private:
+  static const intptr_t kMaxFiles = 4;
+  static const intptr_t kPathLength = 256;
+
+  char root_[kPathLength];
+  char cpu_dir_[kPathLength];
+  char memory_dir_[kPathLength];
+  char files_[kMaxFiles][kPathLength];
+  intptr_t file_count_;
+};
+
+VM_UNIT_TEST_CASE(OsCgroupV2Limits) {
+  const int online = sysconf(_SC_NPROCESSORS_ONLN);
+  {
+    CgroupScope cgroup;
+    cgroup.Write("cpu.max", "150000 100000\n");
+    cgroup.Write("memory.max", "268435456\n");
+    EXPECT_EQ(Utils::Minimum(2, online), OS::NumberOfAvailableProcessors());
+    EXPECT_EQ(static_cast<uintptr_t>(256 * MB), OS::ContainerMemoryLimit());
+  }
+  {
+    CgroupScope cgroup;
+    cgroup.Write("cpu.max", "max 100000\n");
+    cgroup.Write("memory.max", "max\n");
+    EXPECT_EQ(online, OS::NumberOfAvailableProcessors());
+    EXPECT_EQ(static_cast<uintptr_t>(0), OS::ContainerMemoryLimit());
+  }
+}
+
+VM_UNIT_TEST_CASE(OsCgroupV1Limits) {
+  const int online = sysconf(_SC_NPROCESSORS_ONLN);
+  {
+    CgroupScope cgroup;
+    cgroup.Write("cpu/cpu.cfs_quota_us", "50000\n");
+    cgroup.Write("cpu/cpu.cfs_period_us", "100000\n");
+    cgroup.Write("memory/memory.limit_in_bytes", "536870912\n");
+    EXPECT_EQ(1, OS::NumberOfAvailableProcessors());
+    EXPECT_EQ(static_cast<uintptr_t>(512 * MB), OS::ContainerMemoryLimit());
+  }
+  {
+    // Without a limit, v1 reports a quota of -1 and a huge memory limit.
+    CgroupScope cgroup;
+    cgroup.Write("cpu/cpu.cfs_quota_us", "-1\n");
+    cgroup.Write("cpu/cpu.cfs_period_us", "100000\n");
+    cgroup.Write("memory/memory.limit_in_bytes", "9223372036854771712\n");
+    EXPECT_EQ(online, OS::NumberOfAvailableProcessors());
+    EXPECT_EQ(static_cast<uintptr_t>(0), OS::ContainerMemoryLimit());
+  }
+}
+
+VM_UNIT_TEST_CASE(OsAdjustFlagsForContainerLimits) {
+  SetFlagScope<int> old_gen(&FLAG_old_gen_heap_size,
+                            static_cast<int>(kDefaultMaxOldGenHeapSize));
+  SetFlagScope<int> marker(&FLAG_marker_tasks, 4);
+  SetFlagScope<int> scavenger(&FLAG_scavenger_tasks, 4);
+  SetFlagScope<int> compactor(&FLAG_compactor_tasks, 4);
+  {
+    CgroupScope cgroup;
+    cgroup.Write("cpu.max", "100000 100000\n");
+    cgroup.Write("memory.max", "1073741824\n");
+    Dart::AdjustFlagsForContainerLimits();
+  }
+  EXPECT_EQ(768, FLAG_old_gen_heap_size);
+  EXPECT_EQ(1, FLAG_marker_tasks);
+  EXPECT_EQ(1, FLAG_scavenger_tasks);
+  EXPECT_EQ(1, FLAG_compactor_tasks);
+}
+
+#endif  // defined(HOST_OS_LINUX)
+
 }  // namespace dart
@@ -198,6 +198,10 @@ int OS::NumberOfAvailableProcessors() {
   return info.dwNumberOfProcessors;
 }
 
+uintptr_t OS::ContainerMemoryLimit() {
+  return 0;
+}
+
 void OS::Sleep(int64_t millis) {
   ::Sleep(millis);
 }
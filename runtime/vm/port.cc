@@ -228,7 +228,9 @@ bool PortMap::IsReceiverInThisIsolateGroup(Dart_Port receiver,
   MutexLocker ml(mutex_);
   auto it = ports_->TryLookup(receiver);
   if (it == ports_->end()) return false;
-  return (*it).handler->isolate()->group() == group;
+  // Native ports have no isolate.
+  Isolate* isolate = (*it).handler->isolate();
+  return (isolate != nullptr) && (isolate->group() == group);
 }
 
 void PortMap::Init() {
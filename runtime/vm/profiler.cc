@@ -19,6 +19,7 @@
 #include "vm/object.h"
 #include "vm/os.h"
 #include "vm/profiler.h"
+#include "vm/profiler_pprof.h"
 #include "vm/reusable_handles.h"
 #include "vm/signal_handler.h"
 #include "vm/simulator.h"
@@ -70,6 +71,7 @@ void Profiler::Init() {
   // Place some sane restrictions on user controlled flags.
   SetSampleDepth(FLAG_max_profile_depth);
   Sample::Init();
+  PprofProfiler::Init();
   if (!FLAG_profiler) {
     return;
   }
@@ -84,6 +86,7 @@ void Profiler::Init() {
   }
   ThreadInterrupter::Init();
   ThreadInterrupter::Startup();
+  PprofProfiler::Startup();
   initialized_ = true;
 }
 
@@ -99,6 +102,7 @@ void Profiler::Cleanup() {
     return;
   }
   ASSERT(initialized_);
+  PprofProfiler::Cleanup();
   ThreadInterrupter::Cleanup();
   delete sample_buffer_;
   sample_buffer_ = NULL;
@@ -171,8 +175,12 @@ uword* Sample::GetPCArray() const {
                                   sizeof(*this));
 }
 
-SampleBuffer::SampleBuffer(intptr_t capacity) {
+SampleBuffer::SampleBuffer(intptr_t capacity)
+    : SampleBuffer(capacity, /*is_snapshot=*/false) {}
+
+SampleBuffer::SampleBuffer(intptr_t capacity, bool is_snapshot) {
   ASSERT(Sample::instance_size() > 0);
+  ASSERT(capacity > 0);
 
   const intptr_t size = Utils::RoundUp(capacity * Sample::instance_size(),
                                        VirtualMemory::PageSize());
@@ -186,6 +194,9 @@ SampleBuffer::SampleBuffer(intptr_t capacity) {
   capacity_ = capacity;
   cursor_ = 0;
 
+  if (is_snapshot) {
+    return;
+  }
   if (FLAG_trace_profiler) {
     OS::PrintErr("Profiler holds %" Pd " samples\n", capacity);
     OS::PrintErr("Profiler sample is %" Pd " bytes\n", Sample::instance_size());
@@ -1182,7 +1193,7 @@ void Profiler::DumpStackTrace(uword sp, uword fp, uword pc, bool for_crash) {
   }
 }
 
-void Profiler::SampleAllocation(Thread* thread, intptr_t cid) {
+void Profiler::SampleAllocation(Thread* thread, intptr_t cid, intptr_t size) {
   ASSERT(thread != NULL);
   OSThread* os_thread = thread->os_thread();
   ASSERT(os_thread != NULL);
@@ -1219,7 +1230,7 @@ void Profiler::SampleAllocation(Thread* thread, intptr_t cid) {
   }
 
   Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id());
-  sample->SetAllocationCid(cid);
+  sample->SetAllocation(cid, size);
 
   if (FLAG_profile_vm_allocation) {
     ProfilerNativeStackWalker native_stack_walker(
@@ -1234,7 +1245,7 @@ void Profiler::SampleAllocation(Thread* thread, intptr_t cid) {
     // Fall back.
     uintptr_t pc = OS::GetProgramCounter();
     Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id());
-    sample->SetAllocationCid(cid);
+    sample->SetAllocation(cid, size);
     sample->SetAt(0, pc);
   }
 }
@@ -1541,6 +1552,44 @@ const CodeDescriptor* CodeLookupTable::FindCode(uword pc) const {
   return NULL;
 }
 
+bool SampleBuffer::IsFilteredHeadSample(Sample* sample, SampleFilter* filter) {
+  if (sample->ignore_sample()) {
+    // Bad sample.
+    return false;
+  }
+  if (!sample->head_sample()) {
+    // An inner sample in a chain of samples.
+    return false;
+  }
+  // If we're requesting all the native allocation samples, we don't care
+  // whether or not we're in the same isolate as the sample.
+  if (sample->port() != filter->port()) {
+    // Another isolate.
+    return false;
+  }
+  if (sample->timestamp() == 0) {
+    // Empty.
+    return false;
+  }
+  if (sample->At(0) == 0) {
+    // No frames.
+    return false;
+  }
+  if (!filter->TimeFilterSample(sample)) {
+    // Did not pass time filter.
+    return false;
+  }
+  if (!filter->TaskFilterSample(sample)) {
+    // Did not pass task filter.
+    return false;
+  }
+  if (!filter->FilterSample(sample)) {
+    // Did not pass filter.
+    return false;
+  }
+  return true;
+}
+
 ProcessedSampleBuffer* SampleBuffer::BuildProcessedSampleBuffer(
     SampleFilter* filter) {
   ASSERT(filter != NULL);
@@ -1552,43 +1601,62 @@ ProcessedSampleBuffer* SampleBuffer::BuildProcessedSampleBuffer(
   const intptr_t length = capacity();
   for (intptr_t i = 0; i < length; i++) {
     Sample* sample = At(i);
-    if (sample->ignore_sample()) {
-      // Bad sample.
+    if (!IsFilteredHeadSample(sample, filter)) {
       continue;
     }
-    if (!sample->head_sample()) {
-      // An inner sample in a chain of samples.
-      continue;
-    }
-    // If we're requesting all the native allocation samples, we don't care
-    // whether or not we're in the same isolate as the sample.
-    if (sample->port() != filter->port()) {
-      // Another isolate.
-      continue;
-    }
-    if (sample->timestamp() == 0) {
-      // Empty.
-      continue;
-    }
-    if (sample->At(0) == 0) {
-      // No frames.
+    buffer->Add(BuildProcessedSample(sample, buffer->code_lookup_table()));
+  }
+  return buffer;
+}
+
+SampleBuffer* SampleBuffer::Snapshot(SampleFilter* filter) {
+  ASSERT(filter != NULL);
+  const intptr_t length = capacity();
+
+  // Size the copy first so only the selected chains are duplicated.
+  intptr_t count = 0;
+  for (intptr_t i = 0; i < length; i++) {
+    Sample* sample = At(i);
+    if (!IsFilteredHeadSample(sample, filter)) {
       continue;
     }
-    if (!filter->TimeFilterSample(sample)) {
-      // Did not pass time filter.
-      continue;
+    for (; sample != NULL; sample = Next(sample)) {
+      count++;
     }
-    if (!filter->TaskFilterSample(sample)) {
-      // Did not pass task filter.
+  }
+
+  SampleBuffer* snapshot =
+      new SampleBuffer(count > 0 ? count : 1, /*is_snapshot=*/true);
+  if (count == 0) {
+    snapshot->At(0)->Init(ILLEGAL_PORT, 0, OSThread::kInvalidThreadId);
+    return snapshot;
+  }
+
+  intptr_t cursor = 0;
+  for (intptr_t i = 0; i < length; i++) {
+    Sample* sample = At(i);
+    if (!IsFilteredHeadSample(sample, filter)) {
       continue;
     }
-    if (!filter->FilterSample(sample)) {
-      // Did not pass filter.
-      continue;
+    Sample* previous = NULL;
+    for (; sample != NULL; sample = Next(sample)) {
+      Sample* copy = snapshot->At(cursor);
+      memmove(copy, sample, Sample::instance_size());
+      // Chains are laid out contiguously in the copy. A continuation bit
+      // without a valid successor in the original ends the chain here.
+      copy->state_ = Sample::ContinuationSampleBit::update(false, copy->state_);
+      copy->continuation_index_ = -1;
+      copy->next_free_ = NULL;
+      if (previous != NULL) {
+        previous->SetContinuationIndex(cursor);
+      }
+      previous = copy;
+      cursor++;
     }
-    buffer->Add(BuildProcessedSample(sample, buffer->code_lookup_table()));
   }
-  return buffer;
+  ASSERT(cursor == count);
+  snapshot->cursor_ = count;
+  return snapshot;
 }
 
 ProcessedSample* SampleBuffer::BuildProcessedSample(
@@ -1608,6 +1676,7 @@ ProcessedSample* SampleBuffer::BuildProcessedSample(
   processed_sample->set_user_tag(sample->user_tag());
   if (sample->is_allocation_sample()) {
     processed_sample->set_allocation_cid(sample->allocation_cid());
+    processed_sample->set_allocation_size(sample->allocation_size());
   }
   processed_sample->set_first_frame_executing(!sample->exit_frame_sample());
 
@@ -1659,6 +1728,7 @@ ProcessedSample::ProcessedSample()
       vm_tag_(0),
       user_tag_(0),
       allocation_cid_(-1),
+      allocation_size_(0),
       truncated_(false),
       timeline_code_trie_(nullptr),
       timeline_function_trie_(nullptr) {}
@@ -77,7 +77,7 @@ class Profiler : public AllStatic {
   static void DumpStackTrace(void* context);
   static void DumpStackTrace(bool for_crash = true);
 
-  static void SampleAllocation(Thread* thread, intptr_t cid);
+  static void SampleAllocation(Thread* thread, intptr_t cid, intptr_t size);
   static Sample* SampleNativeAllocation(intptr_t skip_count,
                                         uword address,
                                         uintptr_t allocation_size);
@@ -209,6 +209,7 @@ class Sample {
     user_tag_ = UserTags::kDefaultUserTag;
     lr_ = 0;
     metadata_ = 0;
+    allocation_size_ = 0;
     state_ = 0;
     native_allocation_address_ = 0;
     native_allocation_size_bytes_ = 0;
@@ -360,6 +361,11 @@ class Sample {
     return metadata_;
   }
 
+  intptr_t allocation_size() const {
+    ASSERT(is_allocation_sample());
+    return allocation_size_;
+  }
+
   void set_head_sample(bool head_sample) {
     state_ = HeadSampleBit::update(head_sample, state_);
   }
@@ -368,9 +374,10 @@ class Sample {
 
   void set_metadata(intptr_t metadata) { metadata_ = metadata; }
 
-  void SetAllocationCid(intptr_t cid) {
+  void SetAllocation(intptr_t cid, intptr_t size) {
     set_is_allocation_sample(true);
     set_metadata(cid);
+    allocation_size_ = size;
   }
 
   static void Init();
@@ -421,6 +428,7 @@ class Sample {
   uword vm_tag_;
   uword user_tag_;
   uword metadata_;
+  intptr_t allocation_size_;
   uword lr_;
   uword state_;
   uword native_allocation_address_;
@@ -430,6 +438,9 @@ class Sample {
 
   /* There are a variable number of words that follow, the words hold the
    * sampled pc values. Access via GetPCArray() */
+
+  friend class PprofProfiler;
+  friend class SampleBuffer;
   DISALLOW_COPY_AND_ASSIGN(Sample);
 };
 
@@ -676,6 +687,13 @@ class SampleBuffer {
 
   ProcessedSampleBuffer* BuildProcessedSampleBuffer(SampleFilter* filter);
 
+  // Copies the head samples that pass |filter|, together with their
+  // continuations, into a new buffer owned by the caller. Must be called
+  // inside a ThreadInterrupter::SampleBufferReaderScope. The copy is private
+  // to the caller, so it can be processed after the scope is released without
+  // holding up the sampler or being overwritten as the ring buffer wraps.
+  SampleBuffer* Snapshot(SampleFilter* filter);
+
   intptr_t Size() { return memory_->size(); }
 
  protected:
@@ -689,6 +707,11 @@ class SampleBuffer {
   RelaxedAtomic<uintptr_t> cursor_;
 
  private:
+  SampleBuffer(intptr_t capacity, bool is_snapshot);
+
+  bool IsFilteredHeadSample(Sample* sample, SampleFilter* filter);
+
+  friend class PprofProfiler;
   DISALLOW_COPY_AND_ASSIGN(SampleBuffer);
 };
 
@@ -764,6 +787,10 @@ class ProcessedSample : public ZoneAllocated {
 
   bool IsAllocationSample() const { return allocation_cid_ > 0; }
 
+  // The size of the allocated object if this is an allocation profile sample.
+  intptr_t allocation_size() const { return allocation_size_; }
+  void set_allocation_size(intptr_t size) { allocation_size_ = size; }
+
   bool is_native_allocation_sample() const {
     return native_allocation_size_bytes_ != 0;
   }
@@ -815,6 +842,7 @@ class ProcessedSample : public ZoneAllocated {
   uword vm_tag_;
   uword user_tag_;
   intptr_t allocation_cid_;
+  intptr_t allocation_size_;
   bool truncated_;
   bool first_frame_executing_;
   uword native_allocation_address_;
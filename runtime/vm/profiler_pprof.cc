@@ -0,0 +1,631 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/profiler_pprof.h"
+
+#include "platform/text_buffer.h"
+#include "vm/dart.h"
+#include "vm/flags.h"
+#include "vm/growable_array.h"
+#include "vm/hash.h"
+#include "vm/hash_map.h"
+#include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/native_symbol.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+#include "vm/profiler.h"
+#include "vm/protobuf_writer.h"
+#include "vm/reverse_pc_lookup_cache.h"
+#include "vm/thread_interrupter.h"
+
+namespace dart {
+
+DECLARE_FLAG(int, profile_period);
+
+DEFINE_FLAG(charp,
+            pprof_dir,
+            NULL,
+            "Continuously collect CPU samples of all isolates at a low sample "
+            "rate and write them as a pprof profile into the specified "
+            "directory when the VM shuts down.");
+DEFINE_FLAG(int,
+            pprof_period,
+            10000,
+            "Time between profiler samples in microseconds when --pprof-dir "
+            "is given.");
+
+#ifndef PRODUCT
+
+// Samples are moved out of the ring buffer at this interval. At the default
+// --pprof-period the buffer holds several minutes of samples.
+static const int64_t kDrainIntervalMicros = 1000000;
+
+static const intptr_t kMaxStackDepth = 256;
+
+// A distinct stack and the number of times it was sampled. Until the stack is
+// symbolized |pcs| holds program counters, afterwards it holds pprof location
+// ids and |port| is ILLEGAL_PORT.
+struct PprofStack {
+  Dart_Port port;
+  intptr_t hash;
+  intptr_t length;
+  uword* pcs;
+  int64_t count;
+};
+
+class PprofStackTrait {
+ public:
+  typedef PprofStack* Key;
+  typedef PprofStack* Value;
+  typedef PprofStack* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+  static Value ValueOf(Pair kv) { return kv; }
+  static intptr_t Hashcode(Key key) { return key->hash; }
+  static bool IsKeyEqual(Pair kv, Key key) {
+    return (kv->port == key->port) && (kv->length == key->length) &&
+           (memcmp(kv->pcs, key->pcs, key->length * sizeof(uword)) == 0);
+  }
+};
+
+struct PprofLocation {
+  uword address;
+  intptr_t function_id;  // 0 if the address could not be symbolized.
+};
+
+typedef IntKeyRawPointerValueTrait<intptr_t> LocationTrait;
+typedef IntKeyRawPointerValueTrait<const char*> NameTrait;
+typedef CStringKeyValueTrait<intptr_t> FunctionTrait;
+
+typedef MallocDirectChainedHashMap<PprofStackTrait> StackMap;
+typedef MallocDirectChainedHashMap<LocationTrait> LocationMap;
+typedef MallocDirectChainedHashMap<NameTrait> NameMap;
+typedef MallocDirectChainedHashMap<FunctionTrait> FunctionMap;
+
+// The number of samples in which the function |caller| was calling |callee|.
+struct PprofCallEdge {
+  intptr_t caller;
+  intptr_t callee;
+  int64_t count;
+};
+
+class PprofCallEdgeTrait {
+ public:
+  typedef PprofCallEdge Key;
+  typedef int64_t Value;
+  typedef PprofCallEdge Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+  static Value ValueOf(Pair kv) { return kv.count; }
+  static intptr_t Hashcode(Key key) {
+    const uint32_t hash = CombineHashes(static_cast<uint32_t>(key.caller),
+                                        static_cast<uint32_t>(key.callee));
+    return FinalizeHash(hash, kBitsPerWord - 1);
+  }
+  static bool IsKeyEqual(Pair kv, Key key) {
+    return (kv.caller == key.caller) && (kv.callee == key.callee);
+  }
+};
+
+typedef MallocDirectChainedHashMap<PprofCallEdgeTrait> CallEdgeMap;
+
+static Monitor* monitor_ = NULL;
+static bool shutdown_ = false;
+static ThreadJoinId thread_id_ = OSThread::kInvalidThreadJoinId;
+static int64_t start_time_micros_ = 0;
+static int64_t last_timestamp_ = 0;
+
+// All guarded by |monitor_|.
+static StackMap* raw_stacks_ = NULL;
+static MallocGrowableArray<PprofStack*>* symbolized_stacks_ = NULL;
+static MallocGrowableArray<PprofLocation>* locations_ = NULL;
+static MallocGrowableArray<char*>* function_names_ = NULL;
+static FunctionMap* function_ids_ = NULL;
+
+static intptr_t HashStack(Dart_Port port, const uword* pcs, intptr_t length) {
+  uint32_t hash = static_cast<uint32_t>(port);
+  for (intptr_t i = 0; i < length; i++) {
+    hash = CombineHashes(hash, static_cast<uint32_t>(pcs[i]));
+  }
+  return FinalizeHash(hash, kBitsPerWord - 1);
+}
+
+// Adds |count| samples of the stack |pcs| taken on the isolate |port|. Must be
+// called with |monitor_| held.
+static void CountStack(Dart_Port port,
+                       const uword* pcs,
+                       intptr_t length,
+                       int64_t count) {
+  PprofStack key = {port, HashStack(port, pcs, length), length,
+                    const_cast<uword*>(pcs), 0};
+  PprofStack* stack = raw_stacks_->LookupValue(&key);
+  if (stack == NULL) {
+    stack = new PprofStack(key);
+    stack->pcs = reinterpret_cast<uword*>(malloc(length * sizeof(uword)));
+    memmove(stack->pcs, pcs, length * sizeof(uword));
+    raw_stacks_->Insert(stack);
+  }
+  stack->count += count;
+}
+
+static void FreeStack(PprofStack* stack) {
+  free(stack->pcs);
+  delete stack;
+}
+
+static intptr_t InternFunction(const char* name) {
+  FunctionTrait::Pair* pair = function_ids_->Lookup(name);
+  if (pair != NULL) {
+    return pair->value;
+  }
+  char* copy = Utils::StrDup(name);
+  function_names_->Add(copy);
+  const intptr_t id = function_names_->length();
+  function_ids_->Insert(FunctionTrait::Pair(copy, id));
+  return id;
+}
+
+// Replaces the program counters of |stack| by location ids. Program counters
+// without a name in |names| (or all of them if |names| is NULL) get locations
+// that only carry their address.
+static void AssignLocations(PprofStack* stack,
+                            LocationMap* location_ids,
+                            NameMap* names) {
+  for (intptr_t i = 0; i < stack->length; i++) {
+    const uword pc = stack->pcs[i];
+    LocationTrait::Pair* pair = location_ids->Lookup(pc);
+    if (pair != NULL) {
+      stack->pcs[i] = pair->value;
+      continue;
+    }
+    PprofLocation location = {pc, 0};
+    if (names != NULL) {
+      NameTrait::Pair* name = names->Lookup(pc);
+      if ((name != NULL) && (name->value != NULL)) {
+        location.function_id = InternFunction(name->value);
+      }
+    }
+    locations_->Add(location);
+    const intptr_t id = locations_->length();
+    location_ids->Insert(LocationTrait::Pair(pc, id));
+    stack->pcs[i] = id;
+  }
+  stack->port = ILLEGAL_PORT;
+  symbolized_stacks_->Add(stack);
+}
+
+// Returns the name of the Dart function |function_id| without the prefix
+// naming its kind of code, or NULL if it names a stub or native code.
+static const char* DartFunctionName(intptr_t function_id) {
+  static const char* const kCodePrefixes[] = {
+      "[Optimized] ",
+      "[Unoptimized] ",
+      "[Bytecode] ",
+  };
+  const char* name = function_names_->At(function_id - 1);
+  for (intptr_t i = 0; i < ARRAY_SIZE(kCodePrefixes); i++) {
+    const intptr_t length = strlen(kCodePrefixes[i]);
+    if (strncmp(name, kCodePrefixes[i], length) == 0) {
+      return name + length;
+    }
+  }
+  return NULL;
+}
+
+static const char* SymbolizePC(Zone* zone,
+                               Isolate* isolate,
+                               const CodeLookupTable* table,
+                               uword pc,
+                               bool is_return_address) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  Code& code = Code::Handle(
+      zone, ReversePc::Lookup(isolate->group(), pc, is_return_address));
+  if (code.IsNull()) {
+    code = ReversePc::Lookup(Dart::vm_isolate()->group(), pc,
+                             is_return_address);
+  }
+  if (!code.IsNull()) {
+    return code.QualifiedName(NameFormattingParams(Object::kUserVisibleName));
+  }
+#else
+  const CodeDescriptor* descriptor = table->FindCode(pc);
+  if (descriptor != NULL) {
+    return descriptor->code().QualifiedName();
+  }
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+  uword start = 0;
+  char* native_name = NativeSymbolResolver::LookupSymbolName(pc, &start);
+  if (native_name == NULL) {
+    return NULL;
+  }
+  const char* name = zone->MakeCopyOfString(native_name);
+  NativeSymbolResolver::FreeSymbolName(native_name);
+  return name;
+}
+
+bool PprofProfiler::IsEnabled() {
+  return FLAG_pprof_dir != NULL;
+}
+
+void PprofProfiler::Init() {
+  if (!IsEnabled()) {
+    return;
+  }
+  // Continuous profiling always samples at its own, low rate.
+  FLAG_profiler = true;
+  FLAG_profile_period = FLAG_pprof_period;
+}
+
+void PprofProfiler::Startup() {
+  if (!IsEnabled()) {
+    return;
+  }
+  if (monitor_ == NULL) {
+    monitor_ = new Monitor();
+  }
+  ASSERT(thread_id_ == OSThread::kInvalidThreadJoinId);
+  {
+    MonitorLocker ml(monitor_);
+    shutdown_ = false;
+    start_time_micros_ = OS::GetCurrentTimeMicros();
+    last_timestamp_ = 0;
+    raw_stacks_ = new StackMap();
+    symbolized_stacks_ = new MallocGrowableArray<PprofStack*>();
+    locations_ = new MallocGrowableArray<PprofLocation>();
+    function_names_ = new MallocGrowableArray<char*>();
+    function_ids_ = new FunctionMap();
+    OSThread::Start("Dart Profiler pprof", ThreadMain, 0);
+    while (thread_id_ == OSThread::kInvalidThreadJoinId) {
+      ml.Wait();
+    }
+  }
+}
+
+void PprofProfiler::Cleanup() {
+  if (!IsEnabled() || (thread_id_ == OSThread::kInvalidThreadJoinId)) {
+    return;
+  }
+  {
+    MonitorLocker ml(monitor_);
+    shutdown_ = true;
+    ml.Notify();
+  }
+  OSThread::Join(thread_id_);
+  thread_id_ = OSThread::kInvalidThreadJoinId;
+
+  DrainSamples();
+  WriteProfile(FLAG_pprof_dir);
+  WriteCallProfile(FLAG_pprof_dir);
+
+  MonitorLocker ml(monitor_);
+  auto it = raw_stacks_->GetIterator();
+  for (PprofStack** stack = it.Next(); stack != NULL; stack = it.Next()) {
+    FreeStack(*stack);
+  }
+  delete raw_stacks_;
+  raw_stacks_ = NULL;
+  for (intptr_t i = 0; i < symbolized_stacks_->length(); i++) {
+    FreeStack(symbolized_stacks_->At(i));
+  }
+  delete symbolized_stacks_;
+  symbolized_stacks_ = NULL;
+  delete locations_;
+  locations_ = NULL;
+  for (intptr_t i = 0; i < function_names_->length(); i++) {
+    free(function_names_->At(i));
+  }
+  delete function_names_;
+  function_names_ = NULL;
+  delete function_ids_;
+  function_ids_ = NULL;
+}
+
+void PprofProfiler::ThreadMain(uword parameters) {
+  {
+    MonitorLocker ml(monitor_);
+    thread_id_ = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+    ml.Notify();
+  }
+  while (true) {
+    {
+      MonitorLocker ml(monitor_);
+      if (!shutdown_) {
+        ml.WaitMicros(kDrainIntervalMicros);
+      }
+      if (shutdown_) {
+        return;
+      }
+    }
+    DrainSamples();
+  }
+}
+
+// Counts the mutator stacks sampled since the last call.
+void PprofProfiler::DrainSamples() {
+  SampleBuffer* buffer = Profiler::sample_buffer();
+  if (buffer == NULL) {
+    return;
+  }
+  uword pcs[kMaxStackDepth];
+
+  ThreadInterrupter::SampleBufferReaderScope scope;
+  MonitorLocker ml(monitor_);
+  int64_t newest_timestamp = last_timestamp_;
+  const intptr_t capacity = buffer->capacity();
+  for (intptr_t i = 0; i < capacity; i++) {
+    Sample* sample = buffer->At(i);
+    if (!sample->head_sample() || sample->ignore_sample() ||
+        sample->is_allocation_sample() || (sample->port() == ILLEGAL_PORT) ||
+        (sample->thread_task() != Thread::kMutatorTask) ||
+        (sample->timestamp() <= last_timestamp_) || (sample->At(0) == 0)) {
+      continue;
+    }
+    newest_timestamp = Utils::Maximum(newest_timestamp, sample->timestamp());
+
+    intptr_t length = 0;
+    for (Sample* current = sample; current != NULL;
+         current = buffer->Next(current)) {
+      for (intptr_t j = 0; j < Sample::pcs_length_; j++) {
+        const uword pc = current->At(j);
+        if ((pc == 0) || (length == kMaxStackDepth)) {
+          break;
+        }
+        pcs[length++] = pc;
+      }
+    }
+    CountStack(sample->port(), pcs, length, 1);
+  }
+  last_timestamp_ = newest_timestamp;
+}
+
+void PprofProfiler::AddStack(Dart_Port port,
+                             const uword* pcs,
+                             intptr_t length,
+                             int64_t count) {
+  MonitorLocker ml(monitor_);
+  CountStack(port, pcs, length, count);
+}
+
+void PprofProfiler::SymbolizeIsolate(Isolate* isolate) {
+  if (!IsEnabled() || (thread_id_ == OSThread::kInvalidThreadJoinId)) {
+    return;
+  }
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  {
+    DisableThreadInterruptsScope dtis(thread);
+    DrainSamples();
+  }
+
+  const Dart_Port port = isolate->main_port();
+  GrowableArray<PprofStack*> stacks;
+  {
+    MonitorLocker ml(monitor_);
+    auto it = raw_stacks_->GetIterator();
+    for (PprofStack** stack = it.Next(); stack != NULL; stack = it.Next()) {
+      if ((*stack)->port == port) {
+        stacks.Add(*stack);
+      }
+    }
+    for (intptr_t i = 0; i < stacks.length(); i++) {
+      raw_stacks_->Remove(stacks[i]);
+    }
+  }
+  if (stacks.is_empty()) {
+    return;
+  }
+
+  // Resolving names allocates, so it is done without holding the lock.
+  const CodeLookupTable* table = NULL;
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  table = new (zone) CodeLookupTable(thread);
+#endif
+  NameMap names;
+  for (intptr_t i = 0; i < stacks.length(); i++) {
+    PprofStack* stack = stacks[i];
+    for (intptr_t j = 0; j < stack->length; j++) {
+      const uword pc = stack->pcs[j];
+      if (names.Lookup(pc) == NULL) {
+        const char* name = SymbolizePC(zone, isolate, table, pc, j > 0);
+        names.Insert(NameTrait::Pair(pc, name));
+      }
+    }
+  }
+
+  MonitorLocker ml(monitor_);
+  LocationMap location_ids;
+  for (intptr_t i = 0; i < stacks.length(); i++) {
+    AssignLocations(stacks[i], &location_ids, &names);
+  }
+}
+
+// Field numbers from
+// https://github.com/google/pprof/blob/master/proto/profile.proto.
+enum {
+  kProfileSampleType = 1,
+  kProfileSample = 2,
+  kProfileLocation = 4,
+  kProfileFunction = 5,
+  kProfileStringTable = 6,
+  kProfileTimeNanos = 9,
+  kProfileDurationNanos = 10,
+  kProfilePeriodType = 11,
+  kProfilePeriod = 12,
+  kValueTypeType = 1,
+  kValueTypeUnit = 2,
+  kSampleLocationId = 1,
+  kSampleValue = 2,
+  kLocationId = 1,
+  kLocationAddress = 3,
+  kLocationLine = 4,
+  kLineFunctionId = 1,
+  kFunctionId = 1,
+  kFunctionName = 2,
+  kFunctionSystemName = 3,
+};
+
+// Fixed entries at the start of the string table. Function names follow.
+enum {
+  kEmptyString = 0,
+  kSamplesString,
+  kCountString,
+  kCpuString,
+  kNanosecondsString,
+  kFirstFunctionString,
+};
+
+static void WriteValueType(ProtobufWriter* profile,
+                           intptr_t field,
+                           intptr_t type,
+                           intptr_t unit) {
+  ProtobufWriter value_type;
+  value_type.WriteInt64(kValueTypeType, type);
+  value_type.WriteInt64(kValueTypeUnit, unit);
+  profile->WriteMessage(field, value_type);
+}
+
+void PprofProfiler::WriteProfile(const char* directory) {
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  if ((file_open == NULL) || (file_write == NULL) || (file_close == NULL)) {
+    return;
+  }
+
+  MonitorLocker ml(monitor_);
+
+  // Isolates that are still alive can no longer be symbolized.
+  {
+    LocationMap location_ids;
+    auto it = raw_stacks_->GetIterator();
+    for (PprofStack** stack = it.Next(); stack != NULL; stack = it.Next()) {
+      AssignLocations(*stack, &location_ids, NULL);
+    }
+    raw_stacks_->Clear();
+  }
+
+  const int64_t period_nanos = static_cast<int64_t>(FLAG_profile_period) * 1000;
+  ProtobufWriter profile;
+  WriteValueType(&profile, kProfileSampleType, kSamplesString, kCountString);
+  WriteValueType(&profile, kProfileSampleType, kCpuString, kNanosecondsString);
+  for (intptr_t i = 0; i < symbolized_stacks_->length(); i++) {
+    const PprofStack* stack = symbolized_stacks_->At(i);
+    ProtobufWriter location_ids;
+    for (intptr_t j = 0; j < stack->length; j++) {
+      location_ids.WriteVarint(stack->pcs[j]);
+    }
+    ProtobufWriter values;
+    values.WriteVarint(stack->count);
+    values.WriteVarint(stack->count * period_nanos);
+    ProtobufWriter sample;
+    sample.WriteMessage(kSampleLocationId, location_ids);
+    sample.WriteMessage(kSampleValue, values);
+    profile.WriteMessage(kProfileSample, sample);
+  }
+  for (intptr_t i = 0; i < locations_->length(); i++) {
+    const PprofLocation& location = locations_->At(i);
+    ProtobufWriter message;
+    message.WriteInt64(kLocationId, i + 1);
+    message.WriteInt64(kLocationAddress, location.address);
+    if (location.function_id != 0) {
+      ProtobufWriter line;
+      line.WriteInt64(kLineFunctionId, location.function_id);
+      message.WriteMessage(kLocationLine, line);
+    }
+    profile.WriteMessage(kProfileLocation, message);
+  }
+  for (intptr_t i = 0; i < function_names_->length(); i++) {
+    ProtobufWriter function;
+    function.WriteInt64(kFunctionId, i + 1);
+    function.WriteInt64(kFunctionName, kFirstFunctionString + i);
+    function.WriteInt64(kFunctionSystemName, kFirstFunctionString + i);
+    profile.WriteMessage(kProfileFunction, function);
+  }
+  profile.WriteString(kProfileStringTable, "");
+  profile.WriteString(kProfileStringTable, "samples");
+  profile.WriteString(kProfileStringTable, "count");
+  profile.WriteString(kProfileStringTable, "cpu");
+  profile.WriteString(kProfileStringTable, "nanoseconds");
+  for (intptr_t i = 0; i < function_names_->length(); i++) {
+    profile.WriteString(kProfileStringTable, function_names_->At(i));
+  }
+  profile.WriteInt64(kProfileTimeNanos, start_time_micros_ * 1000);
+  profile.WriteInt64(kProfileDurationNanos,
+                     (OS::GetCurrentTimeMicros() - start_time_micros_) * 1000);
+  WriteValueType(&profile, kProfilePeriodType, kCpuString, kNanosecondsString);
+  profile.WriteInt64(kProfilePeriod, period_nanos);
+
+  intptr_t pid = OS::ProcessId();
+  char* filename =
+      OS::SCreate(NULL, "%s/dart-cpu-%" Pd ".pb", directory, pid);
+  void* file = (*file_open)(filename, true);
+  if (file == NULL) {
+    OS::PrintErr("Failed to write pprof profile: %s\n", filename);
+    free(filename);
+    return;
+  }
+  free(filename);
+  (*file_write)(profile.data(), profile.length(), file);
+  (*file_close)(file);
+}
+
+void PprofProfiler::WriteCallProfile(const char* directory) {
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  if ((file_open == NULL) || (file_write == NULL) || (file_close == NULL)) {
+    return;
+  }
+
+  // WriteProfile has symbolized all stacks. Samples are ordered from the
+  // innermost frame outwards, so each frame is called by the next one.
+  MonitorLocker ml(monitor_);
+  CallEdgeMap edges;
+  for (intptr_t i = 0; i < symbolized_stacks_->length(); i++) {
+    const PprofStack* stack = symbolized_stacks_->At(i);
+    for (intptr_t j = 0; j + 1 < stack->length; j++) {
+      PprofCallEdge edge = {locations_->At(stack->pcs[j + 1] - 1).function_id,
+                            locations_->At(stack->pcs[j] - 1).function_id,
+                            stack->count};
+      if ((edge.caller == 0) || (edge.callee == 0)) {
+        continue;
+      }
+      PprofCallEdge* pair = edges.Lookup(edge);
+      if (pair != NULL) {
+        pair->count += edge.count;
+      } else {
+        edges.Insert(edge);
+      }
+    }
+  }
+
+  TextBuffer buffer(1024);
+  auto it = edges.GetIterator();
+  for (PprofCallEdge* edge = it.Next(); edge != NULL; edge = it.Next()) {
+    const char* caller = DartFunctionName(edge->caller);
+    const char* callee = DartFunctionName(edge->callee);
+    if ((caller != NULL) && (callee != NULL)) {
+      buffer.Printf("%" Pd64 "\t%s\t%s\n", edge->count, caller, callee);
+    }
+  }
+
+  intptr_t pid = OS::ProcessId();
+  char* filename =
+      OS::SCreate(NULL, "%s/dart-calls-%" Pd ".txt", directory, pid);
+  void* file = (*file_open)(filename, true);
+  if (file == NULL) {
+    OS::PrintErr("Failed to write call profile: %s\n", filename);
+    free(filename);
+    return;
+  }
+  free(filename);
+  (*file_write)(buffer.buffer(), buffer.length(), file);
+  (*file_close)(file);
+}
+
+#endif  // !PRODUCT
+
+}  // namespace dart
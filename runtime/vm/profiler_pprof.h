@@ -0,0 +1,62 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_PROFILER_PPROF_H_
+#define RUNTIME_VM_PROFILER_PPROF_H_
+
+#include "include/dart_api.h"
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+class Isolate;
+
+// Continuous CPU profiling for production use, enabled with --pprof-dir.
+//
+// A background thread drains the profiler's sample buffer once a second and
+// counts identical mutator stacks by their raw program counters, so the ring
+// buffer never wraps and memory use is bounded by the number of distinct
+// stacks rather than by the run time. Symbolization is deferred until the
+// isolate that owns the samples shuts down. The aggregated profile of all
+// isolates is written in pprof's protobuf format to
+// <dir>/dart-cpu-<pid>.pb when the VM shuts down.
+//
+// The number of samples in which each Dart function was calling another one
+// is written to <dir>/dart-calls-<pid>.txt, one "<samples>\t<caller>\t<callee>"
+// line per pair of functions. gen_snapshot's --inlining_profile reads it.
+class PprofProfiler : public AllStatic {
+ public:
+  static bool IsEnabled();
+
+  // Enables the profiler at the --pprof-period sample rate if requested.
+  static void Init();
+
+  // Called by the profiler after the sample buffer has been created.
+  static void Startup();
+
+  // Called by the profiler before the sample buffer is freed. Writes out the
+  // profile.
+  static void Cleanup();
+
+  // Resolves the program counters of the stacks sampled on |isolate|. Must
+  // be called on the isolate's mutator before its code can be freed.
+  static void SymbolizeIsolate(Isolate* isolate);
+
+ private:
+  static void ThreadMain(uword parameters);
+  static void DrainSamples();
+  static void AddStack(Dart_Port port,
+                       const uword* pcs,
+                       intptr_t length,
+                       int64_t count);
+  static void WriteProfile(const char* directory);
+  static void WriteCallProfile(const char* directory);
+
+  friend class PprofProfilerTestHelper;
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_PROFILER_PPROF_H_
@@ -995,8 +995,7 @@ class ProfileBuilder : public ValueObject {
         inlined_functions_cache_(new ProfileCodeInlinedFunctionsCache()),
         samples_(NULL),
         info_kind_(kNone) {
-    ASSERT((sample_buffer_ == Profiler::sample_buffer()) ||
-           (sample_buffer_ == Profiler::allocation_sample_buffer()));
+    ASSERT(sample_buffer_ != NULL);
     ASSERT(profile_ != NULL);
   }
 
@@ -1536,12 +1535,25 @@ Profile::Profile(Isolate* isolate)
 void Profile::Build(Thread* thread,
                     SampleFilter* filter,
                     SampleBuffer* sample_buffer) {
-  // Disable thread interrupts while processing the buffer.
-  DisableThreadInterruptsScope dtis(thread);
-  ThreadInterrupter::SampleBufferReaderScope scope;
+  ASSERT((sample_buffer == Profiler::sample_buffer()) ||
+         (sample_buffer == Profiler::allocation_sample_buffer()));
+  // Only copying the selected samples holds up the sampler. Code lookup and
+  // trie building then work on the private copy while sampling continues.
+  SampleBuffer* snapshot = NULL;
+  {
+    // Disable thread interrupts while reading the buffer.
+    DisableThreadInterruptsScope dtis(thread);
+    ThreadInterrupter::SampleBufferReaderScope scope;
+    snapshot = sample_buffer->Snapshot(filter);
+  }
 
-  ProfileBuilder builder(thread, filter, sample_buffer, this);
+  // Every sample in the snapshot already passed |filter|. Filters may match
+  // on the address of the original sample, so don't apply them again.
+  SampleFilter snapshot_filter(filter->port(), SampleFilter::kNoTaskFilter,
+                               -1, -1);
+  ProfileBuilder builder(thread, &snapshot_filter, snapshot, this);
   builder.Build();
+  delete snapshot;
 }
 
 ProcessedSample* Profile::SampleAt(intptr_t index) {
@@ -1764,6 +1776,10 @@ void Profile::PrintSamplesJSON(JSONObject* obj, bool code_samples) {
       sample_obj.AddProperty64("_nativeAllocationSizeBytes",
                                sample->native_allocation_size_bytes());
     }
+    if (sample->allocation_size() > 0) {
+      sample_obj.AddProperty64("_allocationSizeBytes",
+                               sample->allocation_size());
+    }
     {
       JSONArray stack(&sample_obj, "stack");
       // Walk the sampled PCs.
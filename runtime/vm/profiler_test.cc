@@ -8,6 +8,7 @@
 #include "vm/dart_api_state.h"
 #include "vm/globals.h"
 #include "vm/profiler.h"
+#include "vm/profiler_pprof.h"
 #include "vm/profiler_service.h"
 #include "vm/source_report.h"
 #include "vm/symbols.h"
@@ -17,10 +18,12 @@ namespace dart {
 
 #ifndef PRODUCT
 
+DECLARE_FLAG(int, allocation_sample_interval);
 DECLARE_FLAG(bool, profile_vm);
 DECLARE_FLAG(bool, profile_vm_allocation);
 DECLARE_FLAG(int, max_profile_depth);
 DECLARE_FLAG(int, optimization_counter_threshold);
+DECLARE_FLAG(charp, pprof_dir);
 
 // Some tests are written assuming native stack trace profiling is disabled.
 class DisableNativeProfileScope : public ValueObject {
@@ -144,6 +147,45 @@ TEST_CASE(Profiler_SampleBufferIterateTest) {
   delete sample_buffer;
 }
 
+TEST_CASE(Profiler_SampleBufferSnapshotTest) {
+  SampleBuffer* sample_buffer = new SampleBuffer(5);
+  Dart_Port i = 123;
+  Dart_Port j = 456;
+  Sample* s;
+  s = sample_buffer->ReserveSample();
+  s->Init(i, 1, 0);
+  s->SetAt(0, 2);
+  s = sample_buffer->ReserveSample();
+  s->Init(j, 1, 0);
+  s->SetAt(0, 4);
+  s = sample_buffer->ReserveSampleAndLink(s);
+  s->SetAt(0, 6);
+  s = sample_buffer->ReserveSample();
+  s->Init(i, 1, 0);
+  s->SetAt(0, 8);
+  s = sample_buffer->ReserveSampleAndLink(s);
+  s->SetAt(0, 10);
+
+  // Only the chains of port |i| are copied, continuations included.
+  SampleFilter filter(i, SampleFilter::kNoTaskFilter, -1, -1);
+  SampleBuffer* snapshot = sample_buffer->Snapshot(&filter);
+  EXPECT_EQ(3, snapshot->capacity());
+  EXPECT_EQ(3, ProfileSampleBufferTestHelper::IterateCount(i, *snapshot));
+  EXPECT_EQ(20, ProfileSampleBufferTestHelper::IterateSumPC(i, *snapshot));
+  EXPECT(!snapshot->At(0)->is_continuation_sample());
+  EXPECT(snapshot->At(1)->is_continuation_sample());
+  EXPECT_EQ(2, snapshot->At(1)->continuation_index());
+  EXPECT(!snapshot->At(2)->head_sample());
+
+  // Writes to the original no longer affect the snapshot.
+  s = sample_buffer->ReserveSample();
+  s->Init(i, 1, 0);
+  s->SetAt(0, 12);
+  EXPECT_EQ(20, ProfileSampleBufferTestHelper::IterateSumPC(i, *snapshot));
+  delete snapshot;
+  delete sample_buffer;
+}
+
 TEST_CASE(Profiler_AllocationSampleTest) {
   Isolate* isolate = Isolate::Current();
   SampleBuffer* sample_buffer = new SampleBuffer(3);
@@ -493,6 +535,54 @@ ISOLATE_UNIT_TEST_CASE(Profiler_TrivialRecordAllocation) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Profiler_SampledAllocation) {
+  EnableProfiler();
+  DisableNativeProfileScope dnps;
+  DisableBackgroundCompilationScope dbcs;
+  SetFlagScope<int> sfs(&FLAG_allocation_sample_interval, 4 * KB);
+  const char* kScript =
+      "class A {\n"
+      "  var a;\n"
+      "  var b;\n"
+      "}\n"
+      "main() {\n"
+      "  var list = [];\n"
+      "  for (var i = 0; i < 100000; i++) {\n"
+      "    list.add(new A());\n"
+      "    if (list.length == 100) list = [];\n"
+      "  }\n"
+      "}\n";
+
+  const Library& root_library = Library::Handle(LoadTestScript(kScript));
+  const Class& class_a = Class::Handle(GetClass(root_library, "A"));
+  EXPECT(!class_a.IsNull());
+
+  const int64_t before_allocations_micros = Dart_TimelineGetMicros();
+  Invoke(root_library, "main");
+  const int64_t allocation_extent_micros =
+      Dart_TimelineGetMicros() - before_allocations_micros;
+
+  {
+    Thread* thread = Thread::Current();
+    Isolate* isolate = thread->isolate();
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    Profile profile(isolate);
+    AllocationFilter filter(isolate->main_port(), class_a.id(),
+                            before_allocations_micros,
+                            allocation_extent_micros);
+    profile.Build(thread, &filter, Profiler::sample_buffer());
+    // Some of the allocations are sampled without tracing the class, but far
+    // from all of them.
+    EXPECT_LT(0, profile.sample_count());
+    EXPECT_GT(100000, profile.sample_count());
+    if (profile.sample_count() > 0) {
+      EXPECT_EQ(class_a.host_instance_size(),
+                profile.SampleAt(0)->allocation_size());
+    }
+  }
+}
+
 #if defined(DART_USE_TCMALLOC) && defined(HOST_OS_LINUX) && defined(DEBUG) &&  \
     defined(HOST_ARCH_X64)
 
@@ -2661,6 +2751,219 @@ ISOLATE_UNIT_TEST_CASE(Profiler_ProfileCodeTableTest) {
   EXPECT_EQ(table->FindCodeForPC(50), code1);
 }
 
+class PprofProfilerTestHelper : public AllStatic {
+ public:
+  static void AddStack(Dart_Port port,
+                       const uword* pcs,
+                       intptr_t length,
+                       int64_t count) {
+    PprofProfiler::AddStack(port, pcs, length, count);
+  }
+};
+
+static MallocGrowableArray<uint8_t>* pprof_output = nullptr;
+static MallocGrowableArray<uint8_t>* pprof_calls_output = nullptr;
+
+static void* PprofFileOpen(const char* name, bool write) {
+  EXPECT(write);
+  if (strstr(name, "pprof-test/dart-cpu-") != nullptr) {
+    return pprof_output;
+  }
+  EXPECT(strstr(name, "pprof-test/dart-calls-") != nullptr);
+  return pprof_calls_output;
+}
+
+static void PprofFileWrite(const void* data, intptr_t length, void* file) {
+  auto output = reinterpret_cast<MallocGrowableArray<uint8_t>*>(file);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (intptr_t i = 0; i < length; i++) {
+    output->Add(bytes[i]);
+  }
+}
+
+static void PprofFileClose(void* file) {}
+
+// Decodes the fields of a protobuf message.
+class ProtobufReader {
+ public:
+  ProtobufReader(const uint8_t* data, intptr_t length)
+      : data_(data), end_(data + length) {}
+
+  bool HasMore() const { return data_ < end_; }
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (intptr_t shift = 0; data_ < end_; shift += 7) {
+      const uint8_t byte = *data_++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) break;
+    }
+    return value;
+  }
+
+  // Reads the next field, which is either a varint or length-delimited.
+  intptr_t ReadField(uint64_t* value, ProtobufReader* bytes) {
+    const uint64_t tag = ReadVarint();
+    if ((tag & 7) == 0) {
+      *value = ReadVarint();
+    } else {
+      EXPECT_EQ(2, static_cast<intptr_t>(tag & 7));
+      const intptr_t length = ReadVarint();
+      if (bytes != nullptr) {
+        *bytes = ProtobufReader(data_, length);
+      }
+      data_ += length;
+    }
+    return tag >> 3;
+  }
+
+  const char* ToCString(Zone* zone) const {
+    return zone->MakeCopyOfStringN(reinterpret_cast<const char*>(data_),
+                                   end_ - data_);
+  }
+
+ private:
+  const uint8_t* data_;
+  const uint8_t* end_;
+};
+
+ISOLATE_UNIT_TEST_CASE(Profiler_PprofOutput) {
+  const char* kScript =
+      "pprofCallee() => 42;\n"
+      "pprofCaller() => pprofCallee();\n"
+      "main() => pprofCaller();\n";
+  const Library& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+  const Function& callee =
+      Function::Handle(GetFunction(root_library, "pprofCallee"));
+  const Function& caller =
+      Function::Handle(GetFunction(root_library, "pprofCaller"));
+  EXPECT(callee.HasCode());
+  EXPECT(caller.HasCode());
+
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileReadCallback file_read = Dart::file_read_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  MallocGrowableArray<uint8_t> output;
+  MallocGrowableArray<uint8_t> calls_output;
+  pprof_output = &output;
+  pprof_calls_output = &calls_output;
+  Dart::SetFileCallbacks(PprofFileOpen, file_read, PprofFileWrite,
+                         PprofFileClose);
+  {
+    SetFlagScope<charp> sfs(&FLAG_pprof_dir, "pprof-test");
+    PprofProfiler::Startup();
+    // Three samples of the callee running, called by the caller.
+    const uword pcs[] = {Code::Handle(callee.CurrentCode()).PayloadStart(),
+                         Code::Handle(caller.CurrentCode()).PayloadStart()};
+    PprofProfilerTestHelper::AddStack(thread->isolate()->main_port(), pcs,
+                                      ARRAY_SIZE(pcs), 3);
+    PprofProfiler::SymbolizeIsolate(thread->isolate());
+    PprofProfiler::Cleanup();
+  }
+  Dart::SetFileCallbacks(file_open, file_read, file_write, file_close);
+  pprof_output = nullptr;
+  pprof_calls_output = nullptr;
+
+  // The location ids of each sample start at its entry in |sample_starts|.
+  GrowableArray<intptr_t> sample_starts;
+  GrowableArray<intptr_t> sample_locations;
+  GrowableArray<intptr_t> sample_counts;
+  GrowableArray<intptr_t> location_functions;
+  GrowableArray<intptr_t> function_names;
+  GrowableArray<const char*> strings;
+  ProtobufReader profile(output.data(), output.length());
+  while (profile.HasMore()) {
+    uint64_t value = 0;
+    ProtobufReader message(nullptr, 0);
+    switch (profile.ReadField(&value, &message)) {
+      case 2: {  // Sample.
+        sample_starts.Add(sample_locations.length());
+        while (message.HasMore()) {
+          ProtobufReader packed(nullptr, 0);
+          const intptr_t field = message.ReadField(&value, &packed);
+          if (field == 1) {
+            while (packed.HasMore()) {
+              sample_locations.Add(packed.ReadVarint());
+            }
+          } else if (field == 2) {
+            sample_counts.Add(packed.ReadVarint());
+          }
+        }
+        break;
+      }
+      case 4: {  // Location.
+        intptr_t id = 0;
+        intptr_t function_id = 0;
+        while (message.HasMore()) {
+          ProtobufReader line(nullptr, 0);
+          const intptr_t field = message.ReadField(&value, &line);
+          if (field == 1) {
+            id = value;
+          } else if (field == 4) {
+            while (line.HasMore()) {
+              if (line.ReadField(&value, nullptr) == 1) {
+                function_id = value;
+              }
+            }
+          }
+        }
+        EXPECT_EQ(location_functions.length() + 1, id);
+        location_functions.Add(function_id);
+        break;
+      }
+      case 5: {  // Function.
+        intptr_t id = 0;
+        intptr_t name = 0;
+        while (message.HasMore()) {
+          const intptr_t field = message.ReadField(&value, nullptr);
+          if (field == 1) {
+            id = value;
+          } else if (field == 2) {
+            name = value;
+          }
+        }
+        EXPECT_EQ(function_names.length() + 1, id);
+        function_names.Add(name);
+        break;
+      }
+      case 6:  // String table.
+        strings.Add(message.ToCString(thread->zone()));
+        break;
+    }
+  }
+
+  // Finds the sample of the stack added above, innermost frame first.
+  EXPECT_EQ(sample_starts.length(), sample_counts.length());
+  sample_starts.Add(sample_locations.length());
+  intptr_t found = 0;
+  for (intptr_t i = 0; i < sample_counts.length(); i++) {
+    const intptr_t start = sample_starts[i];
+    if (sample_starts[i + 1] - start != 2) continue;
+    const char* names[2];
+    for (intptr_t j = 0; j < 2; j++) {
+      const intptr_t location = sample_locations[start + j];
+      const intptr_t function_id = location_functions[location - 1];
+      names[j] = (function_id == 0)
+                     ? ""
+                     : strings[function_names[function_id - 1]];
+    }
+    if ((strstr(names[0], "pprofCallee") != nullptr) &&
+        (strstr(names[1], "pprofCaller") != nullptr)) {
+      EXPECT_EQ(3, sample_counts[i]);
+      found++;
+    }
+  }
+  EXPECT_EQ(1, found);
+  EXPECT_STREQ("", strings[0]);
+  EXPECT_STREQ("samples", strings[1]);
+
+  calls_output.Add('\0');
+  const char* calls = reinterpret_cast<const char*>(calls_output.data());
+  EXPECT_SUBSTRING("3\tpprofCaller\tpprofCallee\n", calls);
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
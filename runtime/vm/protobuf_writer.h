@@ -0,0 +1,83 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_PROTOBUF_WRITER_H_
+#define RUNTIME_VM_PROTOBUF_WRITER_H_
+
+#include <string.h>
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+
+namespace dart {
+
+// Minimal encoder for the protobuf wire format.
+class ProtobufWriter : public ValueObject {
+ public:
+  ProtobufWriter() : bytes_() {}
+
+  const uint8_t* data() const { return bytes_.data(); }
+  intptr_t length() const { return bytes_.length(); }
+
+  void Clear() { bytes_.Clear(); }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes_.Add(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    bytes_.Add(static_cast<uint8_t>(value));
+  }
+
+  void WriteInt64(intptr_t field, int64_t value) {
+    WriteTag(field, kVarint);
+    WriteVarint(static_cast<uint64_t>(value));
+  }
+
+  void WriteFixed64(intptr_t field, uint64_t value) {
+    WriteTag(field, kFixed64);
+    for (intptr_t i = 0; i < 8; i++) {
+      bytes_.Add(static_cast<uint8_t>(value >> (8 * i)));
+    }
+  }
+
+  void WriteDouble(intptr_t field, double value) {
+    uint64_t bits;
+    memmove(&bits, &value, sizeof(bits));
+    WriteFixed64(field, bits);
+  }
+
+  void WriteBytes(intptr_t field, const uint8_t* data, intptr_t length) {
+    WriteTag(field, kLengthDelimited);
+    WriteVarint(length);
+    for (intptr_t i = 0; i < length; i++) {
+      bytes_.Add(data[i]);
+    }
+  }
+
+  void WriteString(intptr_t field, const char* value) {
+    WriteBytes(field, reinterpret_cast<const uint8_t*>(value), strlen(value));
+  }
+
+  void WriteMessage(intptr_t field, const ProtobufWriter& message) {
+    WriteBytes(field, message.data(), message.length());
+  }
+
+ private:
+  static const intptr_t kVarint = 0;
+  static const intptr_t kFixed64 = 1;
+  static const intptr_t kLengthDelimited = 2;
+
+  void WriteTag(intptr_t field, intptr_t wire_type) {
+    WriteVarint((field << 3) | wire_type);
+  }
+
+  MallocGrowableArray<uint8_t> bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtobufWriter);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_PROTOBUF_WRITER_H_
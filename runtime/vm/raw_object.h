@@ -345,6 +345,11 @@ class ObjectLayout {
     ASSERT(!IsCardRemembered());
     tags_.UpdateUnsynchronized<CardRememberedBit>(true);
   }
+  void SetCardRememberedBit() {
+    ASSERT(!IsRemembered());
+    ASSERT(!IsCardRemembered());
+    tags_.UpdateBool<CardRememberedBit>(true);
+  }
 
   intptr_t GetClassId() const { return tags_.Read<ClassIdTag>(); }
 
@@ -997,6 +1002,8 @@ class FunctionLayout : public ObjectLayout {
   friend class UnitDeserializationRoots;
 
   RAW_HEAP_OBJECT_IMPLEMENTATION(Function);
+  template <bool>
+  friend class MarkingVisitorBase;
 
   uword entry_point_;            // Accessed from generated code.
   uword unchecked_entry_point_;  // Accessed from generated code.
@@ -1076,7 +1083,8 @@ class FunctionLayout : public ObjectLayout {
   F(intptr_t, uint16_t, optimized_call_site_count)                             \
   F(int8_t, int8_t, deoptimization_counter)                                    \
   F(intptr_t, int8_t, state_bits)                                              \
-  F(int, int8_t, inlining_depth)
+  F(int, int8_t, inlining_depth)                                               \
+  F(intptr_t, uint8_t, non_escaping_parameters)
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   typedef BitField<uint32_t, bool, 0, 1> IsDeclaredInBytecode;
@@ -1158,6 +1166,14 @@ class FfiTrampolineDataLayout : public ObjectLayout {
   // Will be 0 for non-callbacks. Check 'callback_target_' to determine if this
   // is a callback or not.
   uint32_t callback_id_;
+
+  // Whether a Dart -> native call skips the transition to native code. Only
+  // used by calls to natives which don't call back into Dart or block.
+  bool is_leaf_;
+
+  // Whether a Dart -> native call resolves the native function on its first
+  // call, instead of being passed a Pointer to it.
+  bool is_lazy_;
 };
 
 class FieldLayout : public ObjectLayout {
@@ -1349,6 +1365,7 @@ class LibraryLayout : public ObjectLayout {
 
   Dart_NativeEntryResolver native_entry_resolver_;  // Resolves natives.
   Dart_NativeEntrySymbol native_entry_symbol_resolver_;
+  Dart_FfiNativeResolver ffi_native_resolver_;  // Resolves @FfiNative.
   classid_t index_;       // Library id number.
   uint16_t num_imports_;  // Number of entries in imports_.
   int8_t load_state_;     // Of type LibraryState.
@@ -2596,6 +2613,8 @@ class ArrayLayout : public InstanceLayout {
   friend class ICData;            // For high performance access.
   friend class SubtypeTestCache;  // For high performance access.
   friend class ReversePc;
+  template <bool>
+  friend class MarkingVisitorBase;
 
   friend class OldPage;
 };
@@ -2802,7 +2821,9 @@ class RegExpLayout : public InstanceLayout {
   } two_byte_sticky_;
   FunctionPtr external_one_byte_sticky_function_;
   FunctionPtr external_two_byte_sticky_function_;
-  VISIT_TO(ObjectPtr, external_two_byte_sticky_function_)
+  StringPtr required_literal_;  // Contained in every match, or null.
+  TypedDataPtr linear_program_;  // See RegExpLinearMatcher, or null.
+  VISIT_TO(ObjectPtr, linear_program_)
   ObjectPtr* to_snapshot(Snapshot::Kind kind) { return to(); }
 
   // The same pattern may use different amount of registers if compiled
@@ -1750,6 +1750,10 @@ RegExpPtr RegExp::ReadFrom(SnapshotReader* reader,
   regex.set_capture_name_map(*reader->ArrayHandle());
   *reader->StringHandle() ^= reader->ReadObjectImpl(kAsInlinedObject);
   regex.set_pattern(*reader->StringHandle());
+  *reader->StringHandle() ^= reader->ReadObjectImpl(kAsInlinedObject);
+  regex.set_required_literal(*reader->StringHandle());
+  *reader->TypedDataHandle() ^= reader->ReadObjectImpl(kAsInlinedObject);
+  regex.set_linear_program(*reader->TypedDataHandle());
 
   regex.StoreNonPointer(&regex.raw_ptr()->num_one_byte_registers_,
                         reader->Read<int32_t>());
@@ -1782,7 +1786,10 @@ void RegExpLayout::WriteTo(SnapshotWriter* writer,
 
   // Write out all the other fields.
   writer->Write<ObjectPtr>(num_bracket_expressions_);
+  writer->WriteObjectImpl(capture_name_map_, kAsInlinedObject);
   writer->WriteObjectImpl(pattern_, kAsInlinedObject);
+  writer->WriteObjectImpl(required_literal_, kAsInlinedObject);
+  writer->WriteObjectImpl(linear_program_, kAsInlinedObject);
   writer->Write<int32_t>(num_one_byte_registers_);
   writer->Write<int32_t>(num_two_byte_registers_);
   writer->Write<int8_t>(type_flags_);
@@ -5583,4 +5583,63 @@ RegExpPtr RegExpEngine::CreateRegExp(Thread* thread,
   return regexp.raw();
 }
 
+// Shorter literals are too likely to be found to be worth the search.
+static const intptr_t kMinRequiredLiteralLength = 3;
+
+static const ZoneGrowableArray<uint16_t>* LongerAtom(
+    const ZoneGrowableArray<uint16_t>* a,
+    const ZoneGrowableArray<uint16_t>* b) {
+  if (a == NULL) return b;
+  if (b == NULL) return a;
+  return (b->length() > a->length()) ? b : a;
+}
+
+static const ZoneGrowableArray<uint16_t>* RequiredAtom(RegExpTree* tree) {
+  if (tree == NULL) {
+    return NULL;
+  }
+  if (tree->IsAtom()) {
+    RegExpAtom* atom = tree->AsAtom();
+    return atom->ignore_case() ? NULL : atom->data();
+  }
+  if (tree->IsText()) {
+    const ZoneGrowableArray<uint16_t>* result = NULL;
+    GrowableArray<TextElement>* elements = tree->AsText()->elements();
+    for (intptr_t i = 0; i < elements->length(); i++) {
+      const TextElement& element = elements->At(i);
+      if ((element.text_type() == TextElement::ATOM) &&
+          !element.atom()->ignore_case()) {
+        result = LongerAtom(result, element.atom()->data());
+      }
+    }
+    return result;
+  }
+  if (tree->IsAlternative()) {
+    const ZoneGrowableArray<uint16_t>* result = NULL;
+    ZoneGrowableArray<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+    for (intptr_t i = 0; i < nodes->length(); i++) {
+      result = LongerAtom(result, RequiredAtom(nodes->At(i)));
+    }
+    return result;
+  }
+  if (tree->IsCapture()) {
+    return RequiredAtom(tree->AsCapture()->body());
+  }
+  if (tree->IsQuantifier()) {
+    RegExpQuantifier* quantifier = tree->AsQuantifier();
+    return (quantifier->min() > 0) ? RequiredAtom(quantifier->body()) : NULL;
+  }
+  // Alternatives may not share a literal, and the contents of lookarounds
+  // aren't part of the match.
+  return NULL;
+}
+
+StringPtr RegExpEngine::RequiredLiteral(RegExpTree* tree) {
+  const ZoneGrowableArray<uint16_t>* atom = RequiredAtom(tree);
+  if ((atom == NULL) || (atom->length() < kMinRequiredLiteralLength)) {
+    return String::null();
+  }
+  return Symbols::FromUTF16(Thread::Current(), atom->data(), atom->length());
+}
+
 }  // namespace dart
@@ -1514,6 +1514,11 @@ class RegExpEngine : public AllStatic {
                                 const String& pattern,
                                 RegExpFlags flags);
 
+  // Returns a case sensitive literal which every match of |tree| contains, or
+  // null if there is no long enough one. Subjects which don't contain it are
+  // rejected without running the matcher.
+  static StringPtr RequiredLiteral(RegExpTree* tree);
+
   static void DotPrint(const char* label, RegExpNode* node, bool ignore_case);
 };
 
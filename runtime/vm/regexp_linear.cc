@@ -0,0 +1,577 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/regexp_linear.h"
+
+#include "vm/regexp.h"
+#include "vm/regexp_ast.h"
+
+namespace dart {
+
+// A program is an Int32 array starting with a header, followed by the
+// instructions. Each instruction is an opcode and its operands, targets are
+// indices into the program.
+enum LinearOpcode {
+  kLinearMatch,
+  kLinearChar,    // Code unit.
+  kLinearClass,   // Number of ranges, then their first and last code unit.
+  kLinearSplit,   // Preferred target, other target.
+  kLinearJump,    // Target.
+  kLinearSave,    // Register.
+  kLinearClear,   // First and last register.
+  kLinearAssert,  // RegExpAssertion::AssertionType.
+};
+
+// Number of capture registers.
+static const intptr_t kRegisterCountIndex = 0;
+// Upper bound of the number of threads waiting at the same position, the
+// number of instructions which consume a code unit or match.
+static const intptr_t kThreadCountIndex = 1;
+static const intptr_t kHeaderSize = 2;
+
+// Bound the memory used by a match. Patterns with larger programs, usually
+// large counted repetitions, are left to the backtracking engine.
+static const intptr_t kMaxProgramLength = 16 * KB;
+static const intptr_t kMaxThreadRegisters = 256 * KB;
+
+// Whether an unbounded quantifier contains another one. Backtracking tries
+// every way of splitting the input between the loops when such a pattern
+// fails to match, e.g. /(a+)+b/ on a string of a's.
+static bool HasNestedUnboundedQuantifiers(RegExpTree* tree, bool in_loop) {
+  if (tree->IsDisjunction()) {
+    ZoneGrowableArray<RegExpTree*>* alternatives =
+        tree->AsDisjunction()->alternatives();
+    for (intptr_t i = 0; i < alternatives->length(); i++) {
+      if (HasNestedUnboundedQuantifiers(alternatives->At(i), in_loop)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (tree->IsAlternative()) {
+    ZoneGrowableArray<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+    for (intptr_t i = 0; i < nodes->length(); i++) {
+      if (HasNestedUnboundedQuantifiers(nodes->At(i), in_loop)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  if (tree->IsCapture()) {
+    return HasNestedUnboundedQuantifiers(tree->AsCapture()->body(), in_loop);
+  }
+  if (tree->IsQuantifier()) {
+    RegExpQuantifier* quantifier = tree->AsQuantifier();
+    const bool unbounded = quantifier->max() == RegExpTree::kInfinity;
+    if (unbounded && in_loop) {
+      return true;
+    }
+    return HasNestedUnboundedQuantifiers(quantifier->body(),
+                                         in_loop || unbounded);
+  }
+  return false;
+}
+
+class LinearProgramBuilder : public ValueObject {
+ public:
+  explicit LinearProgramBuilder(Zone* zone)
+      : zone_(zone), code_(zone, 64), thread_count_(0), supported_(true) {}
+
+  bool supported() const { return supported_; }
+  intptr_t thread_count() const { return thread_count_; }
+
+  TypedDataPtr Finish(intptr_t register_count) {
+    ASSERT(supported_);
+    code_[kRegisterCountIndex] = register_count;
+    code_[kThreadCountIndex] = thread_count_;
+    const intptr_t length = code_.length();
+    const TypedData& program = TypedData::Handle(
+        zone_, TypedData::New(kTypedDataInt32ArrayCid, length, Heap::kOld));
+    for (intptr_t i = 0; i < length; i++) {
+      program.SetInt32(i * sizeof(int32_t), code_[i]);
+    }
+    return program.raw();
+  }
+
+  void EmitHeader() {
+    for (intptr_t i = 0; i < kHeaderSize; i++) {
+      Emit(0);
+    }
+  }
+
+  void EmitMatch() {
+    Emit(kLinearMatch);
+    thread_count_++;
+  }
+
+  void EmitSave(intptr_t reg) {
+    Emit(kLinearSave);
+    Emit(reg);
+  }
+
+  void Compile(RegExpTree* tree) {
+    if (!supported_) {
+      return;
+    }
+    if (tree->IsDisjunction()) {
+      CompileDisjunction(tree->AsDisjunction());
+    } else if (tree->IsAlternative()) {
+      ZoneGrowableArray<RegExpTree*>* nodes = tree->AsAlternative()->nodes();
+      for (intptr_t i = 0; i < nodes->length(); i++) {
+        Compile(nodes->At(i));
+      }
+    } else if (tree->IsAtom()) {
+      CompileAtom(tree->AsAtom());
+    } else if (tree->IsText()) {
+      GrowableArray<TextElement>* elements = tree->AsText()->elements();
+      for (intptr_t i = 0; i < elements->length(); i++) {
+        const TextElement& element = elements->At(i);
+        if (element.text_type() == TextElement::ATOM) {
+          CompileAtom(element.atom());
+        } else {
+          CompileClass(element.char_class());
+        }
+      }
+    } else if (tree->IsCharacterClass()) {
+      CompileClass(tree->AsCharacterClass());
+    } else if (tree->IsAssertion()) {
+      Emit(kLinearAssert);
+      Emit(tree->AsAssertion()->assertion_type());
+    } else if (tree->IsCapture()) {
+      RegExpCapture* capture = tree->AsCapture();
+      EmitSave(RegExpCapture::StartRegister(capture->index()));
+      Compile(capture->body());
+      EmitSave(RegExpCapture::EndRegister(capture->index()));
+    } else if (tree->IsQuantifier()) {
+      CompileQuantifier(tree->AsQuantifier());
+    } else if (!tree->IsEmpty()) {
+      // Backreferences and lookarounds.
+      supported_ = false;
+    }
+  }
+
+ private:
+  void Emit(int32_t value) {
+    code_.Add(value);
+    if (code_.length() > kMaxProgramLength) {
+      supported_ = false;
+    }
+  }
+
+  intptr_t pc() const { return code_.length(); }
+
+  // Emits a split to the following instruction and to a target which is
+  // patched later, returns the index of the latter.
+  intptr_t EmitSplit(bool prefer_next) {
+    const intptr_t next = pc() + 3;
+    Emit(kLinearSplit);
+    Emit(prefer_next ? next : 0);
+    Emit(prefer_next ? 0 : next);
+    return prefer_next ? next - 1 : next - 2;
+  }
+
+  void EmitJump(intptr_t target) {
+    Emit(kLinearJump);
+    Emit(target);
+  }
+
+  void EmitClass(ZoneGrowableArray<CharacterRange>* ranges) {
+    Emit(kLinearClass);
+    Emit(ranges->length());
+    for (intptr_t i = 0; i < ranges->length(); i++) {
+      Emit(ranges->At(i).from());
+      Emit(ranges->At(i).to());
+    }
+    thread_count_++;
+  }
+
+  void CompileDisjunction(RegExpDisjunction* disjunction) {
+    ZoneGrowableArray<RegExpTree*>* alternatives = disjunction->alternatives();
+    GrowableArray<intptr_t> exits(zone_, alternatives->length());
+    const intptr_t last = alternatives->length() - 1;
+    for (intptr_t i = 0; i < last; i++) {
+      const intptr_t next = EmitSplit(/*prefer_next=*/true);
+      Compile(alternatives->At(i));
+      EmitJump(0);
+      exits.Add(pc() - 1);
+      code_[next] = pc();
+    }
+    Compile(alternatives->At(last));
+    for (intptr_t i = 0; i < exits.length(); i++) {
+      code_[exits[i]] = pc();
+    }
+  }
+
+  void CompileAtom(RegExpAtom* atom) {
+    ZoneGrowableArray<uint16_t>* data = atom->data();
+    for (intptr_t i = 0; i < data->length(); i++) {
+      const uint16_t c = data->At(i);
+      if (atom->ignore_case()) {
+        ZoneGrowableArray<CharacterRange>* ranges =
+            CharacterRange::List(zone_, CharacterRange::Singleton(c));
+        CharacterRange::AddCaseEquivalents(ranges, /*is_one_byte=*/false,
+                                           zone_);
+        CharacterRange::Canonicalize(ranges);
+        // Case equivalents may merge into a single range, e.g. U+0100-U+0101.
+        if ((ranges->length() > 1) ||
+            (ranges->At(0).from() != ranges->At(0).to())) {
+          EmitClass(ranges);
+          continue;
+        }
+      }
+      Emit(kLinearChar);
+      Emit(c);
+      thread_count_++;
+    }
+  }
+
+  void CompileClass(RegExpCharacterClass* cc) {
+    ZoneGrowableArray<CharacterRange>* original = cc->ranges();
+    ZoneGrowableArray<CharacterRange>* ranges =
+        new (zone_) ZoneGrowableArray<CharacterRange>(original->length());
+    for (intptr_t i = 0; i < original->length(); i++) {
+      ranges->Add(original->At(i));
+    }
+    if (cc->flags().IgnoreCase()) {
+      CharacterRange::AddCaseEquivalents(ranges, /*is_one_byte=*/false, zone_);
+    }
+    CharacterRange::Canonicalize(ranges);
+    if (cc->is_negated()) {
+      ZoneGrowableArray<CharacterRange>* negated =
+          new (zone_) ZoneGrowableArray<CharacterRange>(ranges->length() + 1);
+      CharacterRange::Negate(ranges, negated);
+      ranges = negated;
+    }
+    EmitClass(ranges);
+  }
+
+  // Like the backtracking engine, captures in the body are reset at the start
+  // of every iteration.
+  void CompileIteration(RegExpTree* body, Interval captures) {
+    if (!captures.is_empty()) {
+      Emit(kLinearClear);
+      Emit(captures.from());
+      Emit(captures.to());
+    }
+    Compile(body);
+  }
+
+  void CompileQuantifier(RegExpQuantifier* quantifier) {
+    RegExpTree* body = quantifier->body();
+    const intptr_t min = quantifier->min();
+    const intptr_t max = quantifier->max();
+    const bool greedy = !quantifier->is_non_greedy();
+    const Interval captures = body->CaptureRegisters();
+    // Optional iterations which match the empty string are rejected, which
+    // is only observable through captures. Unbounded loops get it right by
+    // never entering the same instruction twice at one position.
+    if (quantifier->is_possessive() ||
+        ((max != RegExpTree::kInfinity) && (max > min) &&
+         (body->min_match() == 0) && !captures.is_empty())) {
+      supported_ = false;
+      return;
+    }
+    for (intptr_t i = 0; supported_ && (i < min); i++) {
+      CompileIteration(body, captures);
+    }
+    if (max == RegExpTree::kInfinity) {
+      const intptr_t loop = pc();
+      const intptr_t exit = EmitSplit(greedy);
+      CompileIteration(body, captures);
+      EmitJump(loop);
+      code_[exit] = pc();
+      return;
+    }
+    GrowableArray<intptr_t> exits(zone_, 4);
+    for (intptr_t i = min; supported_ && (i < max); i++) {
+      exits.Add(EmitSplit(greedy));
+      CompileIteration(body, captures);
+    }
+    for (intptr_t i = 0; i < exits.length(); i++) {
+      code_[exits[i]] = pc();
+    }
+  }
+
+  Zone* zone_;
+  GrowableArray<int32_t> code_;
+  intptr_t thread_count_;
+  bool supported_;
+
+  DISALLOW_COPY_AND_ASSIGN(LinearProgramBuilder);
+};
+
+TypedDataPtr RegExpLinearMatcher::Compile(RegExpTree* tree,
+                                          RegExpFlags flags,
+                                          intptr_t capture_count,
+                                          bool force) {
+  if (flags.IsUnicode() ||
+      (!force && !HasNestedUnboundedQuantifiers(tree, /*in_loop=*/false))) {
+    return TypedData::null();
+  }
+  LinearProgramBuilder builder(Thread::Current()->zone());
+  builder.EmitHeader();
+  builder.EmitSave(RegExpCapture::StartRegister(0));
+  builder.Compile(tree);
+  builder.EmitSave(RegExpCapture::EndRegister(0));
+  builder.EmitMatch();
+  const intptr_t register_count = RegExpCapture::EndRegister(capture_count) + 1;
+  if (!builder.supported() ||
+      (builder.thread_count() * register_count > kMaxThreadRegisters)) {
+    return TypedData::null();
+  }
+  return builder.Finish(register_count);
+}
+
+static bool IsLineTerminator(int32_t c) {
+  return (c == '\n') || (c == '\r') || (c == 0x2028) || (c == 0x2029);
+}
+
+static bool IsWordCharacter(int32_t c) {
+  return ((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+         ((c >= '0') && (c <= '9')) || (c == '_');
+}
+
+// The threads waiting at instructions which consume a code unit or match, in
+// the order of their priority.
+class LinearThreadList : public ValueObject {
+ public:
+  LinearThreadList(Zone* zone, intptr_t capacity, intptr_t register_count)
+      : register_count_(register_count),
+        length_(0),
+        pcs_(zone->Alloc<intptr_t>(capacity)),
+        registers_(zone->Alloc<int32_t>(capacity * register_count)) {}
+
+  intptr_t length() const { return length_; }
+  intptr_t pc(intptr_t i) const { return pcs_[i]; }
+  int32_t* registers(intptr_t i) const {
+    return &registers_[i * register_count_];
+  }
+
+  void Add(intptr_t pc, const int32_t* registers) {
+    pcs_[length_] = pc;
+    memmove(this->registers(length_), registers,
+            register_count_ * sizeof(int32_t));
+    length_++;
+  }
+
+  void Clear() { length_ = 0; }
+
+ private:
+  const intptr_t register_count_;
+  intptr_t length_;
+  intptr_t* pcs_;
+  int32_t* registers_;
+
+  DISALLOW_COPY_AND_ASSIGN(LinearThreadList);
+};
+
+class LinearMatcher : public ValueObject {
+ public:
+  LinearMatcher(Zone* zone,
+                const int32_t* code,
+                intptr_t code_length,
+                const String& subject)
+      : code_(code),
+        subject_(subject),
+        length_(subject.Length()),
+        register_count_(code[kRegisterCountIndex]),
+        visited_(zone->Alloc<intptr_t>(code_length)),
+        stack_(zone, 16),
+        list_a_(zone, code[kThreadCountIndex], register_count_),
+        list_b_(zone, code[kThreadCountIndex], register_count_),
+        initial_registers_(zone->Alloc<int32_t>(register_count_)),
+        match_(zone->Alloc<int32_t>(register_count_)) {
+    for (intptr_t i = 0; i < code_length; i++) {
+      visited_[i] = -1;
+    }
+    for (intptr_t i = 0; i < register_count_; i++) {
+      initial_registers_[i] = -1;
+    }
+  }
+
+  intptr_t register_count() const { return register_count_; }
+  const int32_t* match() const { return match_; }
+
+  bool Run(intptr_t start_index, bool sticky) {
+    LinearThreadList* current = &list_a_;
+    LinearThreadList* next = &list_b_;
+    bool matched = false;
+    for (intptr_t pos = start_index; pos <= length_; pos++) {
+      if (!matched && (!sticky || (pos == start_index))) {
+        // Starting here has lower priority than any earlier start.
+        AddThread(current, kHeaderSize, pos, initial_registers_);
+      }
+      if ((current->length() == 0) && (matched || sticky)) {
+        break;
+      }
+      next->Clear();
+      const int32_t c = (pos < length_) ? subject_.CharAt(pos) : -1;
+      for (intptr_t i = 0; i < current->length(); i++) {
+        const intptr_t pc = current->pc(i);
+        int32_t* registers = current->registers(i);
+        switch (code_[pc]) {
+          case kLinearMatch:
+            memmove(match_, registers, register_count_ * sizeof(int32_t));
+            matched = true;
+            // Drop the threads of lower priority.
+            i = current->length();
+            break;
+          case kLinearChar:
+            if (code_[pc + 1] == c) {
+              AddThread(next, pc + 2, pos + 1, registers);
+            }
+            break;
+          case kLinearClass: {
+            const intptr_t count = code_[pc + 1];
+            const int32_t* ranges = &code_[pc + 2];
+            for (intptr_t j = 0; j < count; j++) {
+              if ((ranges[2 * j] <= c) && (c <= ranges[2 * j + 1])) {
+                AddThread(next, pc + 2 + 2 * count, pos + 1, registers);
+                break;
+              }
+            }
+            break;
+          }
+          default:
+            UNREACHABLE();
+        }
+      }
+      LinearThreadList* swap = current;
+      current = next;
+      next = swap;
+    }
+    return matched;
+  }
+
+ private:
+  // An instruction to explore, or a register to restore once the threads
+  // which were explored after it was changed are all added.
+  struct StackEntry {
+    intptr_t pc;
+    intptr_t reg;
+    int32_t value;
+  };
+
+  bool IsWordAt(intptr_t pos) const {
+    return (pos >= 0) && (pos < length_) &&
+           IsWordCharacter(subject_.CharAt(pos));
+  }
+
+  bool CheckAssertion(intptr_t type, intptr_t pos) const {
+    switch (type) {
+      case RegExpAssertion::START_OF_INPUT:
+        return pos == 0;
+      case RegExpAssertion::END_OF_INPUT:
+        return pos == length_;
+      case RegExpAssertion::START_OF_LINE:
+        return (pos == 0) || IsLineTerminator(subject_.CharAt(pos - 1));
+      case RegExpAssertion::END_OF_LINE:
+        return (pos == length_) || IsLineTerminator(subject_.CharAt(pos));
+      case RegExpAssertion::BOUNDARY:
+        return IsWordAt(pos - 1) != IsWordAt(pos);
+      case RegExpAssertion::NON_BOUNDARY:
+        return IsWordAt(pos - 1) == IsWordAt(pos);
+    }
+    UNREACHABLE();
+    return false;
+  }
+
+  void PushRestore(intptr_t reg, int32_t* registers) {
+    StackEntry entry = {-1, reg, registers[reg]};
+    stack_.Add(entry);
+  }
+
+  // Adds the threads reachable from |pc| without consuming a code unit to
+  // |list|, in priority order. |registers| is restored before returning.
+  void AddThread(LinearThreadList* list,
+                 intptr_t pc,
+                 intptr_t pos,
+                 int32_t* registers) {
+    ASSERT(stack_.is_empty());
+    StackEntry start = {pc, -1, 0};
+    stack_.Add(start);
+    while (!stack_.is_empty()) {
+      const StackEntry entry = stack_.RemoveLast();
+      if (entry.pc < 0) {
+        registers[entry.reg] = entry.value;
+        continue;
+      }
+      pc = entry.pc;
+      // Threads of higher priority got here first at this position.
+      while (visited_[pc] != pos) {
+        visited_[pc] = pos;
+        const int32_t opcode = code_[pc];
+        if (opcode == kLinearJump) {
+          pc = code_[pc + 1];
+        } else if (opcode == kLinearSplit) {
+          StackEntry other = {code_[pc + 2], -1, 0};
+          stack_.Add(other);
+          pc = code_[pc + 1];
+        } else if (opcode == kLinearSave) {
+          PushRestore(code_[pc + 1], registers);
+          registers[code_[pc + 1]] = pos;
+          pc += 2;
+        } else if (opcode == kLinearClear) {
+          for (intptr_t reg = code_[pc + 1]; reg <= code_[pc + 2]; reg++) {
+            PushRestore(reg, registers);
+            registers[reg] = -1;
+          }
+          pc += 3;
+        } else if (opcode == kLinearAssert) {
+          if (!CheckAssertion(code_[pc + 1], pos)) {
+            break;
+          }
+          pc += 2;
+        } else {
+          list->Add(pc, registers);
+          break;
+        }
+      }
+    }
+  }
+
+  const int32_t* code_;
+  const String& subject_;
+  const intptr_t length_;
+  const intptr_t register_count_;
+  // The last position at which each instruction was explored.
+  intptr_t* visited_;
+  GrowableArray<StackEntry> stack_;
+  LinearThreadList list_a_;
+  LinearThreadList list_b_;
+  int32_t* initial_registers_;
+  int32_t* match_;
+
+  DISALLOW_COPY_AND_ASSIGN(LinearMatcher);
+};
+
+TypedDataPtr RegExpLinearMatcher::Match(const TypedData& program,
+                                        const String& subject,
+                                        intptr_t start_index,
+                                        bool sticky,
+                                        Zone* zone) {
+  ASSERT((start_index >= 0) && (start_index <= subject.Length()));
+  const int32_t* registers;
+  intptr_t register_count;
+  {
+    NoSafepointScope no_safepoint;
+    LinearMatcher matcher(zone,
+                          reinterpret_cast<const int32_t*>(program.DataAddr(0)),
+                          program.Length(), subject);
+    if (!matcher.Run(start_index, sticky)) {
+      return TypedData::null();
+    }
+    registers = matcher.match();
+    register_count = matcher.register_count();
+  }
+  // The registers live in the zone, so they survive the allocation.
+  const TypedData& result = TypedData::Handle(
+      zone, TypedData::New(kTypedDataInt32ArrayCid, register_count));
+  for (intptr_t i = 0; i < register_count; i++) {
+    result.SetInt32(i * sizeof(int32_t), registers[i]);
+  }
+  return result.raw();
+}
+
+}  // namespace dart
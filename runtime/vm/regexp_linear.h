@@ -0,0 +1,44 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_REGEXP_LINEAR_H_
+#define RUNTIME_VM_REGEXP_LINEAR_H_
+
+#include "vm/allocation.h"
+#include "vm/object.h"
+
+namespace dart {
+
+class RegExpTree;
+
+// Matches regular expressions in time linear in the length of the subject by
+// running all paths through a Thompson NFA in lockstep (Pike's VM).
+//
+// Only patterns without backreferences and lookarounds are supported, and no
+// unicode patterns. The threads of the NFA are kept in the order in which the
+// backtracking engine would try them, so the match and its captures are the
+// ones it would have found.
+class RegExpLinearMatcher : public AllStatic {
+ public:
+  // Returns the program for |tree|, or null if the pattern isn't supported.
+  // Unless |force| is set, only patterns with nested unbounded quantifiers,
+  // on which backtracking may take exponential time, are compiled.
+  static TypedDataPtr Compile(RegExpTree* tree,
+                              RegExpFlags flags,
+                              intptr_t capture_count,
+                              bool force);
+
+  // Returns the capture registers of the first match of |program| in
+  // |subject| at or after |start_index|, or null if there is none. Sticky
+  // matches must start at |start_index|.
+  static TypedDataPtr Match(const TypedData& program,
+                            const String& subject,
+                            intptr_t start_index,
+                            bool sticky,
+                            Zone* zone);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_REGEXP_LINEAR_H_
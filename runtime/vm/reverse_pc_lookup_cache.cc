@@ -10,6 +10,35 @@
 
 namespace dart {
 
+CodePtr ReversePcLookupCache::Lookup(uword pc) const {
+  const Entry& entry = entries_[IndexOf(pc)];
+  if (entry.pc.load() != pc) {
+    return Code::null();
+  }
+  const CodePtr code = static_cast<CodePtr>(entry.code.load());
+  if (code == Code::null()) {
+    return Code::null();
+  }
+  const uword start = Code::PayloadStartOf(code);
+  if ((pc < start) || (pc >= (start + Code::PayloadSizeOf(code)))) {
+    return Code::null();
+  }
+  return code;
+}
+
+void ReversePcLookupCache::Insert(uword pc, CodePtr code) {
+  Entry* entry = &entries_[IndexOf(pc)];
+  entry->code.store(static_cast<uword>(code));
+  entry->pc.store(pc);
+}
+
+void ReversePcLookupCache::Clear() {
+  for (intptr_t i = 0; i < kNumEntries; i++) {
+    entries_[i].pc.store(0);
+    entries_[i].code.store(static_cast<uword>(Code::null()));
+  }
+}
+
 CodePtr ReversePc::Lookup(IsolateGroup* group,
                           uword pc,
                           bool is_return_address) {
@@ -21,6 +50,12 @@ CodePtr ReversePc::Lookup(IsolateGroup* group,
     pc--;
   }
 
+  ReversePcLookupCache* cache = group->reverse_pc_lookup_cache();
+  CodePtr cached = cache->Lookup(pc);
+  if (cached != Code::null()) {
+    return cached;
+  }
+
   // This expected number of tables is low, so we go through them linearly. If
   // this changes, would could sort the table list during deserialization and
   // binary search for the table.
@@ -58,6 +93,7 @@ CodePtr ReversePc::Lookup(IsolateGroup* group,
       } else if (pc >= code_end) {
         lo = mid + 1;
       } else {
+        cache->Insert(pc, code);
         return code;
       }
     }
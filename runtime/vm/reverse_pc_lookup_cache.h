@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_REVERSE_PC_LOOKUP_CACHE_H_
 #define RUNTIME_VM_REVERSE_PC_LOOKUP_CACHE_H_
 
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 #include "vm/globals.h"
 #include "vm/tagged_pointer.h"
@@ -13,6 +14,39 @@ namespace dart {
 
 class IsolateGroup;
 
+// A direct-mapped cache from return addresses to the Code containing them,
+// used by ReversePc::Lookup to avoid repeating the binary search over the
+// code order tables for every frame of every stack walk.
+//
+// Entries may be read and written concurrently by the mutators of an isolate
+// group, so a pair might be torn. A hit is only reported if the pc lies within
+// the payload of the cached Code, which makes a torn entry a plain miss.
+// The cache must be cleared whenever Code objects move (see GCCompactor).
+class ReversePcLookupCache {
+ public:
+  ReversePcLookupCache() { Clear(); }
+
+  CodePtr Lookup(uword pc) const;
+  void Insert(uword pc, CodePtr code);
+  void Clear();
+
+ private:
+  static const intptr_t kNumEntries = 1024;
+
+  static intptr_t IndexOf(uword pc) {
+    // Return addresses are at least instruction aligned, ignore the low bits.
+    return (pc >> 2) & (kNumEntries - 1);
+  }
+
+  struct Entry {
+    RelaxedAtomic<uword> pc;
+    RelaxedAtomic<uword> code;
+  };
+  Entry entries_[kNumEntries];
+
+  DISALLOW_COPY_AND_ASSIGN(ReversePcLookupCache);
+};
+
 class ReversePc : public AllStatic {
  public:
   static CodePtr Lookup(IsolateGroup* group,
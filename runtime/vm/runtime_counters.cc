@@ -0,0 +1,281 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/runtime_counters.h"
+
+#include "platform/atomic.h"
+#include "vm/flags.h"
+#include "vm/growable_array.h"
+#include "vm/hash.h"
+#include "vm/hash_map.h"
+#include "vm/json_stream.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+#include "vm/runtime_entry.h"
+
+namespace dart {
+
+enum SiteKind {
+  kICMissSite,
+  kMegamorphicSite,
+  kDeoptimizationSite,
+  kNumSiteKinds,
+};
+
+// The number of times something happened in one function. |detail| is the
+// selector of a call site or the reason of a deoptimization.
+struct SiteCount {
+  intptr_t hash;
+  char* function;
+  char* detail;
+  int64_t count;
+};
+
+class SiteCountTrait {
+ public:
+  typedef SiteCount* Key;
+  typedef SiteCount* Value;
+  typedef SiteCount* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+  static Value ValueOf(Pair kv) { return kv; }
+  static intptr_t Hashcode(Key key) { return key->hash; }
+  static bool IsKeyEqual(Pair kv, Key key) {
+    return (kv->hash == key->hash) &&
+           (strcmp(kv->function, key->function) == 0) &&
+           (strcmp(kv->detail, key->detail) == 0);
+  }
+};
+
+typedef MallocDirectChainedHashMap<SiteCountTrait> SiteMap;
+
+static Mutex* lock_ = NULL;
+// Guarded by |lock_|.
+static SiteMap* sites_[kNumSiteKinds] = {};
+
+static RelaxedAtomic<int64_t> ic_misses_ = 0;
+static RelaxedAtomic<int64_t> megamorphic_transitions_ = 0;
+static RelaxedAtomic<int64_t> deoptimizations_[ICData::kDeoptNumReasons];
+
+void RuntimeCounters::Init() {
+  ASSERT(lock_ == NULL);
+  lock_ = new Mutex();
+  for (intptr_t i = 0; i < kNumSiteKinds; i++) {
+    sites_[i] = new SiteMap();
+  }
+}
+
+void RuntimeCounters::Cleanup() {
+  if (FLAG_print_runtime_counters) {
+    Print();
+  }
+  for (intptr_t i = 0; i < kNumSiteKinds; i++) {
+    auto it = sites_[i]->GetIterator();
+    for (SiteCount** site = it.Next(); site != NULL; site = it.Next()) {
+      free((*site)->function);
+      free((*site)->detail);
+      delete *site;
+    }
+    delete sites_[i];
+    sites_[i] = NULL;
+  }
+  delete lock_;
+  lock_ = NULL;
+}
+
+static void RecordSite(SiteKind kind,
+                       const Function& function,
+                       const char* detail) {
+  const char* function_name = function.IsNull()
+                                  ? "<unknown>"
+                                  : function.ToFullyQualifiedCString();
+  uint32_t hash = HashBytes(reinterpret_cast<const uint8_t*>(function_name),
+                            strlen(function_name));
+  hash = CombineHashes(hash, HashBytes(reinterpret_cast<const uint8_t*>(detail),
+                                       strlen(detail)));
+  SiteCount key = {FinalizeHash(hash, kBitsPerWord - 1),
+                   const_cast<char*>(function_name), const_cast<char*>(detail),
+                   0};
+
+  MutexLocker ml(lock_);
+  SiteCount* site = sites_[kind]->LookupValue(&key);
+  if (site == NULL) {
+    site = new SiteCount(key);
+    site->function = Utils::StrDup(function_name);
+    site->detail = Utils::StrDup(detail);
+    sites_[kind]->Insert(site);
+  }
+  site->count++;
+}
+
+void RuntimeCounters::RecordICMiss(const Function& caller,
+                                   const String& selector) {
+  const int64_t misses = ic_misses_.fetch_add(1);
+  if ((FLAG_runtime_counters_sample_period > 1) &&
+      ((misses % FLAG_runtime_counters_sample_period) != 0)) {
+    return;
+  }
+  RecordSite(kICMissSite, caller, selector.ToCString());
+}
+
+void RuntimeCounters::RecordMegamorphicTransition(const Function& caller,
+                                                  const String& selector) {
+  megamorphic_transitions_.fetch_add(1);
+  RecordSite(kMegamorphicSite, caller, selector.ToCString());
+}
+
+void RuntimeCounters::RecordDeoptimization(const Function& function,
+                                           intptr_t reason) {
+  ASSERT((reason >= 0) && (reason < ICData::kDeoptNumReasons));
+  deoptimizations_[reason].fetch_add(1);
+  RecordSite(kDeoptimizationSite, function,
+             DeoptReasonToCString(static_cast<ICData::DeoptReasonId>(reason)));
+}
+
+// A row of the output.
+struct NamedCount {
+  const char* name;
+  const char* detail;
+  int64_t count;
+};
+
+static int CompareNamedCounts(const NamedCount* a, const NamedCount* b) {
+  if (a->count != b->count) {
+    return (a->count > b->count) ? -1 : 1;
+  }
+  const int result = strcmp(a->name, b->name);
+  return (result != 0) ? result : strcmp(a->detail, b->detail);
+}
+
+static void CollectRuntimeCalls(MallocGrowableArray<NamedCount>* result) {
+#define COLLECT_RUNTIME_CALL(id)                                               \
+  if (k##id##RuntimeEntry.call_count() != 0) {                                 \
+    NamedCount entry = {k##id##RuntimeEntry.name(), "",                        \
+                        k##id##RuntimeEntry.call_count()};                     \
+    result->Add(entry);                                                        \
+  }
+  RUNTIME_ENTRY_LIST(COLLECT_RUNTIME_CALL)
+#undef COLLECT_RUNTIME_CALL
+  result->Sort(CompareNamedCounts);
+}
+
+static int64_t CollectDeoptimizationReasons(
+    MallocGrowableArray<NamedCount>* result) {
+  int64_t total = 0;
+  for (intptr_t i = 0; i < ICData::kDeoptNumReasons; i++) {
+    const int64_t count = deoptimizations_[i].load();
+    if (count != 0) {
+      NamedCount entry = {
+          DeoptReasonToCString(static_cast<ICData::DeoptReasonId>(i)), "",
+          count};
+      result->Add(entry);
+      total += count;
+    }
+  }
+  result->Sort(CompareNamedCounts);
+  return total;
+}
+
+// The strings stay valid until Cleanup, sites are never removed.
+static void CollectSites(SiteKind kind,
+                         MallocGrowableArray<NamedCount>* result) {
+  {
+    MutexLocker ml(lock_);
+    auto it = sites_[kind]->GetIterator();
+    for (SiteCount** site = it.Next(); site != NULL; site = it.Next()) {
+      NamedCount entry = {(*site)->function, (*site)->detail, (*site)->count};
+      result->Add(entry);
+    }
+  }
+  result->Sort(CompareNamedCounts);
+}
+
+static void PrintCounts(const char* title,
+                        const MallocGrowableArray<NamedCount>& counts) {
+  if (counts.is_empty()) {
+    return;
+  }
+  OS::PrintErr("%s:\n", title);
+  for (intptr_t i = 0; i < counts.length(); i++) {
+    OS::PrintErr("  %12" Pd64 "  %s%s%s\n", counts[i].count, counts[i].name,
+                 (counts[i].detail[0] != '\0') ? "  " : "", counts[i].detail);
+  }
+}
+
+void RuntimeCounters::Print() {
+  MallocGrowableArray<NamedCount> runtime_calls;
+  MallocGrowableArray<NamedCount> reasons;
+  MallocGrowableArray<NamedCount> ic_miss_sites;
+  MallocGrowableArray<NamedCount> megamorphic_sites;
+  MallocGrowableArray<NamedCount> deoptimization_sites;
+  CollectRuntimeCalls(&runtime_calls);
+  const int64_t deoptimizations = CollectDeoptimizationReasons(&reasons);
+  CollectSites(kICMissSite, &ic_miss_sites);
+  CollectSites(kMegamorphicSite, &megamorphic_sites);
+  CollectSites(kDeoptimizationSite, &deoptimization_sites);
+
+  OS::PrintErr("Runtime counters:\n");
+  OS::PrintErr("  %12" Pd64 "  IC misses\n", ic_misses_.load());
+  OS::PrintErr("  %12" Pd64 "  megamorphic transitions\n",
+               megamorphic_transitions_.load());
+  OS::PrintErr("  %12" Pd64 "  deoptimizations\n", deoptimizations);
+  PrintCounts("Runtime calls", runtime_calls);
+  PrintCounts("Deoptimizations by reason", reasons);
+  char title[64];
+  Utils::SNPrint(title, sizeof(title), "IC misses by call site, 1 in %d",
+                 FLAG_runtime_counters_sample_period);
+  PrintCounts(title, ic_miss_sites);
+  PrintCounts("Megamorphic transitions by call site", megamorphic_sites);
+  PrintCounts("Deoptimizations by function", deoptimization_sites);
+}
+
+#if !defined(PRODUCT)
+static void AddCounts(JSONObject* jsobj,
+                      const char* property,
+                      const char* detail_property,
+                      const MallocGrowableArray<NamedCount>& counts) {
+  JSONArray array(jsobj, property);
+  for (intptr_t i = 0; i < counts.length(); i++) {
+    JSONObject entry(&array);
+    entry.AddProperty(detail_property == NULL ? "name" : "function",
+                      counts[i].name);
+    if (detail_property != NULL) {
+      entry.AddProperty(detail_property, counts[i].detail);
+    }
+    entry.AddProperty64("count", counts[i].count);
+  }
+}
+
+void RuntimeCounters::PrintJSON(JSONStream* js) {
+  MallocGrowableArray<NamedCount> runtime_calls;
+  MallocGrowableArray<NamedCount> reasons;
+  MallocGrowableArray<NamedCount> ic_miss_sites;
+  MallocGrowableArray<NamedCount> megamorphic_sites;
+  MallocGrowableArray<NamedCount> deoptimization_sites;
+  CollectRuntimeCalls(&runtime_calls);
+  const int64_t deoptimizations = CollectDeoptimizationReasons(&reasons);
+  CollectSites(kICMissSite, &ic_miss_sites);
+  CollectSites(kMegamorphicSite, &megamorphic_sites);
+  CollectSites(kDeoptimizationSite, &deoptimization_sites);
+
+  JSONObject jsobj(js);
+  jsobj.AddProperty("type", "_RuntimeCounters");
+  jsobj.AddProperty("enabled", FLAG_runtime_counters);
+  jsobj.AddProperty("samplePeriod",
+                    static_cast<intptr_t>(FLAG_runtime_counters_sample_period));
+  jsobj.AddProperty64("icMisses", ic_misses_.load());
+  jsobj.AddProperty64("megamorphicTransitions",
+                      megamorphic_transitions_.load());
+  jsobj.AddProperty64("deoptimizations", deoptimizations);
+  AddCounts(&jsobj, "runtimeCalls", NULL, runtime_calls);
+  AddCounts(&jsobj, "deoptimizationReasons", NULL, reasons);
+  AddCounts(&jsobj, "icMissSamples", "selector", ic_miss_sites);
+  AddCounts(&jsobj, "megamorphicCallSites", "selector", megamorphic_sites);
+  AddCounts(&jsobj, "deoptimizationSites", "reason", deoptimization_sites);
+}
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
@@ -0,0 +1,52 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_RUNTIME_COUNTERS_H_
+#define RUNTIME_VM_RUNTIME_COUNTERS_H_
+
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+class Function;
+class JSONStream;
+class String;
+
+// Counters for the slow paths behind polymorphism and deoptimization
+// regressions, enabled with --runtime-counters in all build modes.
+//
+// Every non-leaf runtime call is counted by its RuntimeEntry, and every
+// deoptimization by its reason. Megamorphic transitions and deoptimizations
+// are also attributed to the function they happen in. IC misses are far more
+// frequent, so only one in --runtime-counters-sample-period of them is
+// attributed to its call site. The counters only grow in slow paths that
+// already call into the runtime, never in inline cache hits.
+//
+// The counters are returned by the _getRuntimeCounters service RPC, and
+// printed at shutdown with --print-runtime-counters.
+class RuntimeCounters : public AllStatic {
+ public:
+  static void Init();
+  static void Cleanup();
+
+  // |caller| is the function containing the call site and |selector| the
+  // name being called.
+  static void RecordICMiss(const Function& caller, const String& selector);
+  static void RecordMegamorphicTransition(const Function& caller,
+                                          const String& selector);
+  // |reason| is an ICData::DeoptReasonId.
+  static void RecordDeoptimization(const Function& function, intptr_t reason);
+
+  // Prints all non-zero counters, largest first.
+  static void Print();
+
+#if !defined(PRODUCT)
+  static void PrintJSON(JSONStream* js);
+#endif  // !defined(PRODUCT)
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_RUNTIME_COUNTERS_H_
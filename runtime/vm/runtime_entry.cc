@@ -24,12 +24,14 @@
 #include "vm/object_store.h"
 #include "vm/parser.h"
 #include "vm/resolver.h"
+#include "vm/runtime_counters.h"
 #include "vm/service_isolate.h"
 #include "vm/stack_frame.h"
 #include "vm/symbols.h"
 #include "vm/thread.h"
 #include "vm/thread_registry.h"
 #include "vm/type_testing_stubs.h"
+#include "vm/usdt.h"
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #include "vm/deopt_instructions.h"
@@ -68,6 +70,11 @@ DECLARE_FLAG(bool, trace_optimizing_compiler);
 DECLARE_FLAG(int, max_polymorphic_checks);
 
 DEFINE_FLAG(bool, trace_osr, false, "Trace attempts at on-stack replacement.");
+DEFINE_FLAG(int,
+            osr_code_cache_size,
+            16,
+            "Number of OSR code objects kept per isolate for reuse at the same "
+            "loop header (0 disables reuse).");
 
 DEFINE_FLAG(int, gc_every, 0, "Run major GC on every N stack overflow checks");
 DEFINE_FLAG(int,
@@ -1269,6 +1276,9 @@ static void TrySwitchInstanceCall(const ICData& ic_data,
     ic_data.set_is_megamorphic(true);
     CodePatcher::PatchInstanceCallAt(caller_frame->pc(), caller_code, cache,
                                      StubCode::MegamorphicCall());
+    if (UNLIKELY(FLAG_runtime_counters)) {
+      RuntimeCounters::RecordMegamorphicTransition(caller_function, name);
+    }
     if (FLAG_trace_ic) {
       OS::PrintErr("Instance call at %" Px
                    " switching to megamorphic dispatch, %s\n",
@@ -1371,6 +1381,10 @@ static FunctionPtr InlineCacheMissHandler(
       Array::Handle(zone, ic_data.arguments_descriptor()));
   String& function_name = String::Handle(zone, ic_data.target_name());
   ASSERT(function_name.IsSymbol());
+  if (UNLIKELY(FLAG_runtime_counters)) {
+    RuntimeCounters::RecordICMiss(Function::Handle(zone, ic_data.Owner()),
+                                  function_name);
+  }
 
   const Class& receiver_class = Class::Handle(zone, receiver.clazz());
   Function& target_function = Function::Handle(zone);
@@ -1962,6 +1976,9 @@ void SwitchableCallHandler::DoICDataMiss(const ICData& ic_data,
 
       CodePatcher::PatchSwitchableCallAtWithMutatorsStopped(
           thread_, caller_frame_->pc(), caller_code_, cache, stub);
+      if (UNLIKELY(FLAG_runtime_counters)) {
+        RuntimeCounters::RecordMegamorphicTransition(caller_function_, name);
+      }
       arguments_.SetArgAt(0, stub);
       arguments_.SetReturn(cache);
     } else {
@@ -1983,6 +2000,9 @@ void SwitchableCallHandler::DoMegamorphicMiss(const MegamorphicCache& data,
     OS::PrintErr("Megamorphic miss, class=%s, function<%" Pd ">=%s\n",
                  cls.ToCString(), args_desc.TypeArgsLen(), name.ToCString());
   }
+  if (FLAG_dump_megamorphic_stats) {
+    MegamorphicCacheTable::RecordMiss(!target_function.IsNull());
+  }
   if (target_function.IsNull()) {
     arguments_.SetArgAt(0, StubCode::NoSuchMethodDispatcher());
     arguments_.SetReturn(data);
@@ -2057,6 +2077,9 @@ FunctionPtr SwitchableCallHandler::ResolveTargetFunction(const Object& data) {
     default:
       UNREACHABLE();
   }
+  if (UNLIKELY(FLAG_runtime_counters)) {
+    RuntimeCounters::RecordICMiss(caller_function_, name_);
+  }
   const Class& cls = Class::Handle(zone_, receiver_.clazz());
   return Resolve(thread_, zone_, cls, name_, args_descriptor_);
 }
@@ -2601,6 +2624,94 @@ static void HandleStackOverflowTestCases(Thread* thread) {
 #endif  // !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
+// The OSR code cache is an array of entries, most recently compiled first.
+// Each entry records the OSR code compiled for a loop header of a function's
+// unoptimized code, and the function's deoptimization counter at that time.
+enum OsrCodeCacheEntry {
+  kOsrCacheUnoptimizedCode = 0,
+  kOsrCacheOsrId,
+  kOsrCacheDeoptimizationCounter,
+  kOsrCacheCode,
+  kOsrCacheEntrySize,
+};
+
+static intptr_t FindOsrCodeCacheEntry(const Array& cache,
+                                      const Code& unoptimized_code,
+                                      intptr_t osr_id) {
+  for (intptr_t i = 0; i < cache.Length(); i += kOsrCacheEntrySize) {
+    if ((cache.At(i + kOsrCacheUnoptimizedCode) == unoptimized_code.raw()) &&
+        (Smi::Value(Smi::RawCast(cache.At(i + kOsrCacheOsrId))) == osr_id)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Returns OSR code compiled earlier for the same loop header, or null.
+// Cached code is not reused once it was invalidated through its dependencies
+// or deoptimized at a lazy deoptimization point, nor after any optimized
+// code of the function deoptimized: the type feedback it was compiled with
+// is then known to be wrong.
+static CodePtr LookupOsrCode(Thread* thread,
+                             const Function& function,
+                             const Code& unoptimized_code,
+                             intptr_t osr_id) {
+  Zone* zone = thread->zone();
+  const Array& cache = Array::Handle(
+      zone, thread->isolate()->isolate_object_store()->osr_code_cache());
+  if (cache.IsNull()) {
+    return Code::null();
+  }
+  const intptr_t index = FindOsrCodeCacheEntry(cache, unoptimized_code, osr_id);
+  if (index < 0) {
+    return Code::null();
+  }
+  const Code& code =
+      Code::Handle(zone, Code::RawCast(cache.At(index + kOsrCacheCode)));
+  const intptr_t deoptimization_counter = Smi::Value(
+      Smi::RawCast(cache.At(index + kOsrCacheDeoptimizationCounter)));
+  if (!code.is_alive() || code.IsDisabled() ||
+      (deoptimization_counter != function.deoptimization_counter())) {
+    return Code::null();
+  }
+  return code.raw();
+}
+
+static void AddOsrCode(Thread* thread,
+                       const Function& function,
+                       const Code& unoptimized_code,
+                       intptr_t osr_id,
+                       const Code& osr_code) {
+  if (FLAG_osr_code_cache_size <= 0) {
+    return;
+  }
+  Zone* zone = thread->zone();
+  IsolateObjectStore* store = thread->isolate()->isolate_object_store();
+  Array& cache = Array::Handle(zone, store->osr_code_cache());
+  const intptr_t length = FLAG_osr_code_cache_size * kOsrCacheEntrySize;
+  if (cache.IsNull() || (cache.Length() != length)) {
+    cache = Array::New(length, Heap::kOld);
+    store->set_osr_code_cache(cache);
+  }
+  // Replace the stale entry for the same loop header, if any, and the least
+  // recently compiled entry otherwise.
+  intptr_t index = FindOsrCodeCacheEntry(cache, unoptimized_code, osr_id);
+  if (index < 0) {
+    index = length - kOsrCacheEntrySize;
+  }
+  Object& value = Object::Handle(zone);
+  for (intptr_t i = index + kOsrCacheEntrySize - 1; i >= kOsrCacheEntrySize;
+       i--) {
+    value = cache.At(i - kOsrCacheEntrySize);
+    cache.SetAt(i, value);
+  }
+  cache.SetAt(kOsrCacheUnoptimizedCode, unoptimized_code);
+  cache.SetAt(kOsrCacheOsrId, Smi::Handle(zone, Smi::New(osr_id)));
+  cache.SetAt(kOsrCacheDeoptimizationCounter,
+              Smi::Handle(zone, Smi::New(function.deoptimization_counter())));
+  cache.SetAt(kOsrCacheCode, osr_code);
+}
+
 static void HandleOSRRequest(Thread* thread) {
   Isolate* isolate = thread->isolate();
   ASSERT(isolate->use_osr());
@@ -2642,18 +2753,26 @@ static void HandleOSRRequest(Thread* thread) {
                  function.usage_counter());
   }
 
-  // Since the code is referenced from the frame and the ZoneHandle,
-  // it cannot have been removed from the function.
-  const Object& result = Object::Handle(
-      Compiler::CompileOptimizedFunction(thread, function, osr_id));
-  ThrowIfError(result);
-
-  if (!result.IsNull()) {
-    const Code& code = Code::Cast(result);
-    uword optimized_entry = code.EntryPoint();
-    frame->set_pc(optimized_entry);
-    frame->set_pc_marker(code.raw());
+  Code& osr_code = Code::Handle(LookupOsrCode(thread, function, code, osr_id));
+  if (osr_code.IsNull()) {
+    // Since the code is referenced from the frame and the ZoneHandle,
+    // it cannot have been removed from the function.
+    const Object& result = Object::Handle(
+        Compiler::CompileOptimizedFunction(thread, function, osr_id));
+    ThrowIfError(result);
+    if (result.IsNull()) {
+      return;
+    }
+    osr_code ^= result.raw();
+    AddOsrCode(thread, function, code, osr_id, osr_code);
+  } else if (FLAG_trace_osr) {
+    OS::PrintErr("Reusing OSR code for %s at id=%" Pd "\n",
+                 function.ToFullyQualifiedCString(), osr_id);
   }
+
+  uword optimized_entry = osr_code.EntryPoint();
+  frame->set_pc(optimized_entry);
+  frame->set_pc_marker(osr_code.raw());
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
@@ -3157,6 +3276,7 @@ DEFINE_LEAF_RUNTIME_ENTRY(intptr_t,
   const Function& top_function =
       Function::Handle(thread->zone(), optimized_code.function());
   const bool deoptimizing_code = top_function.HasOptimizedCode();
+  DART_USDT1(deopt, static_cast<int>(is_lazy_deopt != 0u));
   if (FLAG_trace_deoptimization) {
     const Function& function = Function::Handle(optimized_code.function());
     THR_Print("== Deoptimizing code for '%s', %s, %s\n",
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_RUNTIME_ENTRY_H_
 #define RUNTIME_VM_RUNTIME_ENTRY_H_
 
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #include "vm/compiler/runtime_api.h"
@@ -53,6 +54,11 @@ class RuntimeEntry : public BaseRuntimeEntry {
   bool is_float() const { return is_float_; }
   uword GetEntryPoint() const;
 
+  // Number of calls since startup, counted with --runtime-counters. Leaf
+  // entries are not counted.
+  int64_t call_count() const { return call_count_.load(); }
+  void IncrementCallCount() const { call_count_.fetch_add(1); }
+
   // Generate code to call the runtime entry.
   NOT_IN_PRECOMPILED(void Call(compiler::Assembler* assembler,
                                intptr_t argument_count) const);
@@ -70,6 +76,7 @@ class RuntimeEntry : public BaseRuntimeEntry {
   const intptr_t argument_count_;
   const bool is_leaf_;
   const bool is_float_;
+  mutable RelaxedAtomic<int64_t> call_count_ = 0;
 
   DISALLOW_COPY_AND_ASSIGN(RuntimeEntry);
 };
@@ -108,6 +115,9 @@ class RuntimeEntry : public BaseRuntimeEntry {
     MSAN_UNPOISON(&arguments, sizeof(arguments));                              \
     ASSERT(arguments.ArgCount() == argument_count);                            \
     TRACE_RUNTIME_CALL("%s", "" #name);                                        \
+    if (UNLIKELY(FLAG_runtime_counters)) {                                     \
+      k##name##RuntimeEntry.IncrementCallCount();                              \
+    }                                                                          \
     {                                                                          \
       Thread* thread = arguments.thread();                                     \
       ASSERT(thread == Thread::Current());                                     \
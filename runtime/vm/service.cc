@@ -39,6 +39,8 @@
 #include "vm/profiler.h"
 #include "vm/profiler_service.h"
 #include "vm/reusable_handles.h"
+#include "vm/runtime_counters.h"
+#include "vm/service_binary.h"
 #include "vm/service_event.h"
 #include "vm/service_isolate.h"
 #include "vm/source_report.h"
@@ -162,6 +164,7 @@ void Service::CancelStream(const char* stream_id) {
   for (intptr_t i = 0; i < num_streams; i++) {
     if (strcmp(stream_id, streams_[i]->id()) == 0) {
       streams_[i]->set_enabled(false);
+      streams_[i]->set_binary(false);
       return;
     }
   }
@@ -979,25 +982,10 @@ static void Finalizer(void* isolate_callback_data,
   free(buffer);
 }
 
-void Service::SendEvent(const char* stream_id,
-                        const char* event_type,
-                        uint8_t* bytes,
-                        intptr_t bytes_length) {
-  Thread* thread = Thread::Current();
-  Isolate* isolate = thread->isolate();
-  ASSERT(isolate != NULL);
-  ASSERT(!Isolate::IsSystemIsolate(isolate));
-
-  if (FLAG_trace_service) {
-    OS::PrintErr(
-        "vm-service: Pushing ServiceEvent(isolate='%s', "
-        "isolateId='" ISOLATE_SERVICE_ID_FORMAT_STRING
-        "', kind='%s',"
-        " len=%" Pd ") to stream %s\n",
-        isolate->name(), static_cast<int64_t>(isolate->main_port()), event_type,
-        bytes_length, stream_id);
-  }
-
+// Takes ownership of 'bytes'.
+static void PostEventData(const char* stream_id,
+                          uint8_t* bytes,
+                          intptr_t bytes_length) {
   bool result;
   {
     Dart_CObject cbytes;
@@ -1035,13 +1023,32 @@ void Service::SendEvent(const char* stream_id,
   }
 }
 
-void Service::SendEventWithData(const char* stream_id,
-                                const char* event_type,
-                                intptr_t reservation,
-                                const char* metadata,
-                                intptr_t metadata_size,
-                                uint8_t* data,
-                                intptr_t data_size) {
+void Service::SendEvent(const char* stream_id,
+                        const char* event_type,
+                        uint8_t* bytes,
+                        intptr_t bytes_length) {
+  Thread* thread = Thread::Current();
+  Isolate* isolate = thread->isolate();
+  ASSERT(isolate != NULL);
+  ASSERT(!Isolate::IsSystemIsolate(isolate));
+
+  if (FLAG_trace_service) {
+    OS::PrintErr(
+        "vm-service: Pushing ServiceEvent(isolate='%s', "
+        "isolateId='" ISOLATE_SERVICE_ID_FORMAT_STRING
+        "', kind='%s',"
+        " len=%" Pd ") to stream %s\n",
+        isolate->name(), static_cast<int64_t>(isolate->main_port()), event_type,
+        bytes_length, stream_id);
+  }
+
+  PostEventData(stream_id, bytes, bytes_length);
+}
+
+static void WriteEventMetadata(intptr_t reservation,
+                               const char* metadata,
+                               intptr_t metadata_size,
+                               uint8_t* data) {
   ASSERT(kInt32Size + metadata_size <= reservation);
   // Using a SPACE creates valid JSON. Our goal here is to prevent the memory
   // overhead of copying to concatenate metadata and payload together by
@@ -1050,9 +1057,58 @@ void Service::SendEventWithData(const char* stream_id,
   memset(data, ' ', reservation);
   reinterpret_cast<uint32_t*>(data)[0] = reservation;
   memmove(&(reinterpret_cast<uint32_t*>(data)[1]), metadata, metadata_size);
+}
+
+void Service::SendEventWithData(const char* stream_id,
+                                const char* event_type,
+                                intptr_t reservation,
+                                const char* metadata,
+                                intptr_t metadata_size,
+                                uint8_t* data,
+                                intptr_t data_size) {
+  WriteEventMetadata(reservation, metadata, metadata_size, data);
   Service::SendEvent(stream_id, event_type, data, data_size);
 }
 
+void Service::SendBinaryTimelineEvents(const TimelineEventBlock* block) {
+  if (!ServiceIsolate::IsRunning()) {
+    return;
+  }
+  JSONStream js;
+  {
+    JSONObject jsobj(&js);
+    jsobj.AddProperty("jsonrpc", "2.0");
+    jsobj.AddProperty("method", "streamNotify");
+    {
+      JSONObject params(&jsobj, "params");
+      params.AddProperty("streamId", timeline_stream.id());
+      {
+        JSONObject event(&params, "event");
+        event.AddProperty("type", "Event");
+        event.AddProperty("kind", "TimelineEvents");
+        event.AddProperty("_encoding", "binary");
+        event.AddPropertyTimeMillis("timestamp", OS::GetCurrentTimeMillis());
+      }
+    }
+  }
+
+  const intptr_t reservation = js.buffer()->length() + sizeof(int32_t);
+  ServiceBinaryWriter writer(reservation);
+  block->PrintBinary(&writer);
+  const intptr_t length = writer.length();
+  uint8_t* data = writer.Steal();
+  WriteEventMetadata(reservation, js.buffer()->buffer(), js.buffer()->length(),
+                     data);
+
+  if (FLAG_trace_service) {
+    OS::PrintErr(
+        "vm-service: Pushing ServiceEvent(kind='TimelineEvents', len=%" Pd
+        ") to stream %s\n",
+        length, timeline_stream.id());
+  }
+  PostEventData(timeline_stream.id(), data, length);
+}
+
 static void ReportPauseOnConsole(ServiceEvent* event) {
   const char* name = event->isolate()->name();
   const int64_t main_port = static_cast<int64_t>(event->isolate()->main_port());
@@ -2396,6 +2452,44 @@ static bool GetReachableSize(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_top_retainers_by_class_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetTopRetainersByClass(Thread* thread, JSONStream* js) {
+  intptr_t limit = 10;
+  const char* limit_cstr = js->LookupParam("limit");
+  if (limit_cstr != NULL) {
+    if (!GetIntegerId(limit_cstr, &limit) || limit < 0) {
+      PrintInvalidParamError(js, "limit");
+      return true;
+    }
+  }
+
+  MallocGrowableArray<HeapDominatorAnalysis::ClassRetainedSize> retainers;
+  {
+    HeapDominatorAnalysis analysis(thread);
+    analysis.TopRetainersByClass(limit, &retainers);
+  }
+
+  Isolate* isolate = thread->isolate();
+  JSONObject jsobj(js);
+  jsobj.AddProperty("type", "_TopRetainersByClass");
+  JSONArray members(&jsobj, "members");
+  Class& cls = Class::Handle(thread->zone());
+  for (intptr_t i = 0; i < retainers.length(); i++) {
+    const HeapDominatorAnalysis::ClassRetainedSize& entry = retainers[i];
+    cls = GetClassForId(isolate, entry.cid);
+    JSONObject member(&members);
+    member.AddProperty("type", "_ClassRetainedSize");
+    member.AddProperty("class", cls);
+    member.AddProperty64("instanceCount", entry.instance_count);
+    member.AddProperty64("retainedBytes", entry.retained_size);
+  }
+  return true;
+}
+
 static const MethodParameter* invoke_params[] = {
     RUNNABLE_ISOLATE_PARAMETER,
     NULL,
@@ -3716,6 +3810,40 @@ static bool SetVMTimelineFlags(Thread* thread, JSONStream* js) {
 #endif
 }
 
+static const char* const stream_encoding_names[] = {
+    "json",
+    "binary",
+    NULL,
+};
+
+static const MethodParameter* set_stream_encoding_params[] = {
+    NO_ISOLATE_PARAMETER,
+    new MethodParameter("streamId", true),
+    new EnumParameter("encoding", true, stream_encoding_names),
+    NULL,
+};
+
+// Only the high-volume Timeline stream has a binary encoding so far.
+static bool SetStreamEncoding(Thread* thread, JSONStream* js) {
+  const char* stream_id = js->LookupParam("streamId");
+  const char* encoding = js->LookupParam("encoding");
+  const bool binary = strcmp(encoding, "binary") == 0;
+  if (binary && (strcmp(stream_id, Service::timeline_stream.id()) != 0)) {
+    PrintInvalidParamError(js, "encoding");
+    return true;
+  }
+  const intptr_t num_streams = sizeof(streams_) / sizeof(streams_[0]);
+  for (intptr_t i = 0; i < num_streams; i++) {
+    if (strcmp(stream_id, streams_[i]->id()) == 0) {
+      streams_[i]->set_binary(binary);
+      PrintSuccess(js);
+      return true;
+    }
+  }
+  PrintInvalidParamError(js, "streamId");
+  return true;
+}
+
 static const MethodParameter* get_vm_timeline_flags_params[] = {
     NO_ISOLATE_PARAMETER,
     NULL,
@@ -4238,6 +4366,16 @@ static bool GetProcessMemoryUsage(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_runtime_counters_params[] = {
+    NO_ISOLATE_PARAMETER,
+    NULL,
+};
+
+static bool GetRuntimeCounters(Thread* thread, JSONStream* js) {
+  RuntimeCounters::PrintJSON(js);
+  return true;
+}
+
 void Service::SendInspectEvent(Isolate* isolate, const Object& inspectee) {
   if (!Service::debug_stream.enabled()) {
     return;
@@ -5086,6 +5224,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_retained_size_params },
   { "getRetainingPath", GetRetainingPath,
     get_retaining_path_params },
+  { "_getRuntimeCounters", GetRuntimeCounters,
+    get_runtime_counters_params },
   { "getScripts", GetScripts,
     get_scripts_params },
   { "getSourceReport", GetSourceReport,
@@ -5094,6 +5234,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_stack_params },
   { "_getTagProfile", GetTagProfile,
     get_tag_profile_params },
+  { "_getTopRetainersByClass", GetTopRetainersByClass,
+    get_top_retainers_by_class_params },
   { "_getTypeArgumentsList", GetTypeArgumentsList,
     get_type_arguments_list_params },
   { "getVersion", GetVersion,
@@ -5134,6 +5276,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     set_library_debuggable_params },
   { "setName", SetName,
     set_name_params },
+  { "_setStreamEncoding", SetStreamEncoding,
+    set_stream_encoding_params },
   { "_setTraceClassAllocation", SetTraceClassAllocation,
     set_trace_class_allocation_params },
   { "setVMName", SetVMName,
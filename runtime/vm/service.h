@@ -30,6 +30,7 @@ class JSONObject;
 class Object;
 class ServiceEvent;
 class String;
+class TimelineEventBlock;
 
 class ServiceIdZone {
  public:
@@ -68,13 +69,19 @@ class RingServiceIdZone : public ServiceIdZone {
 
 class StreamInfo {
  public:
-  explicit StreamInfo(const char* id) : id_(id), enabled_(false) {}
+  explicit StreamInfo(const char* id)
+      : id_(id), enabled_(false), binary_(false) {}
 
   const char* id() const { return id_; }
 
   void set_enabled(bool value) { enabled_ = value; }
   bool enabled() const { return enabled_; }
 
+  // Whether the events of this stream are sent in the binary encoding
+  // negotiated with _setStreamEncoding instead of JSON.
+  void set_binary(bool value) { binary_ = value; }
+  bool binary() const { return binary_; }
+
   void set_consumer(Dart_NativeStreamConsumer consumer) {
     callback_ = consumer;
   }
@@ -83,6 +90,7 @@ class StreamInfo {
  private:
   const char* id_;
   bool enabled_;
+  bool binary_;
   Dart_NativeStreamConsumer callback_;
 };
 
@@ -145,6 +153,10 @@ class Service : public AllStatic {
                                  const String& event_kind,
                                  const String& event_data);
 
+  // Sends the events of |block| to the Timeline stream in the binary encoding
+  // described in service_binary.h.
+  static void SendBinaryTimelineEvents(const TimelineEventBlock* block);
+
   // Takes ownership of 'data'.
   static void SendEventWithData(const char* stream_id,
                                 const char* event_type,
@@ -0,0 +1,74 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/service_binary.h"
+
+namespace dart {
+
+static const intptr_t kInitialSize = 16 * KB;
+
+static uint8_t* malloc_allocator(uint8_t* ptr,
+                                 intptr_t old_size,
+                                 intptr_t new_size) {
+  void* new_ptr = realloc(reinterpret_cast<void*>(ptr), new_size);
+  return reinterpret_cast<uint8_t*>(new_ptr);
+}
+
+ServiceBinaryWriter::ServiceBinaryWriter(intptr_t reservation)
+    : reservation_(reservation),
+      buffer_(NULL),
+      stream_(&buffer_, malloc_allocator, kInitialSize + reservation),
+      strings_(),
+      next_string_id_(1) {
+  stream_.SetPosition(reservation);
+}
+
+ServiceBinaryWriter::~ServiceBinaryWriter() {
+  free(buffer_);
+}
+
+void ServiceBinaryWriter::WriteUnsigned(uint64_t value) {
+  while (value >= 0x80) {
+    WriteByte(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  WriteByte(static_cast<uint8_t>(value));
+}
+
+void ServiceBinaryWriter::WriteSigned(int64_t value) {
+  const uint64_t bits = static_cast<uint64_t>(value);
+  WriteUnsigned((bits << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void ServiceBinaryWriter::WriteString(const char* value) {
+  if (value == NULL) {
+    WriteUnsigned(0);
+    return;
+  }
+  const intptr_t length = strlen(value);
+  WriteUnsigned(length);
+  stream_.WriteBytes(value, length);
+}
+
+void ServiceBinaryWriter::WriteInternedString(const char* value) {
+  if (value == NULL) {
+    value = "";
+  }
+  StringTrait::Pair* pair = strings_.Lookup(value);
+  if (pair != NULL) {
+    WriteUnsigned(pair->value);
+    return;
+  }
+  strings_.Insert(StringTrait::Pair(value, next_string_id_++));
+  WriteUnsigned(0);
+  WriteString(value);
+}
+
+uint8_t* ServiceBinaryWriter::Steal() {
+  uint8_t* result = buffer_;
+  buffer_ = NULL;
+  return result;
+}
+
+}  // namespace dart
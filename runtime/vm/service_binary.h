@@ -0,0 +1,62 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_SERVICE_BINARY_H_
+#define RUNTIME_VM_SERVICE_BINARY_H_
+
+#include "vm/allocation.h"
+#include "vm/datastream.h"
+#include "vm/globals.h"
+#include "vm/hash_map.h"
+
+namespace dart {
+
+// Writes the payload of a binary service event.
+//
+// Binary events share the layout of the other events with data (e.g.
+// HeapSnapshot): a little endian uint32 offset of the payload, the JSON
+// streamNotify message padded with spaces up to that offset, then the
+// payload. Integers in the payload are LEB128 encoded, signed ones after a
+// zigzag transform. Interned strings are written as a reference: zero is
+// followed by the length and UTF-8 bytes of a string seen for the first time
+// in this payload, which takes the next free id starting at one, and any
+// other value is the id of an earlier string. Plain strings are always
+// written as length and bytes. Payloads don't depend on each other, so a
+// client can start decoding at any event.
+class ServiceBinaryWriter : public ValueObject {
+ public:
+  // Payloads start after |reservation| bytes left for the metadata.
+  explicit ServiceBinaryWriter(intptr_t reservation);
+  ~ServiceBinaryWriter();
+
+  void WriteByte(uint8_t value) { stream_.WriteFixed<uint8_t>(value); }
+  void WriteUnsigned(uint64_t value);
+  void WriteSigned(int64_t value);
+  // A NULL |value| is written as the empty string.
+  void WriteString(const char* value);
+  void WriteInternedString(const char* value);
+
+  intptr_t reservation() const { return reservation_; }
+  intptr_t length() const { return stream_.bytes_written(); }
+
+  // Transfers ownership of the malloc'd buffer, including the reservation, to
+  // the caller.
+  uint8_t* Steal();
+
+ private:
+  typedef CStringKeyValueTrait<intptr_t> StringTrait;
+  typedef MallocDirectChainedHashMap<StringTrait> StringMap;
+
+  const intptr_t reservation_;
+  uint8_t* buffer_;
+  WriteStream stream_;
+  StringMap strings_;
+  intptr_t next_string_id_;
+
+  DISALLOW_COPY_AND_ASSIGN(ServiceBinaryWriter);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_SERVICE_BINARY_H_
@@ -18,6 +18,7 @@
 #include "vm/os.h"
 #include "vm/port.h"
 #include "vm/profiler.h"
+#include "vm/runtime_counters.h"
 #include "vm/service.h"
 #include "vm/unit_test.h"
 
@@ -726,6 +727,18 @@ ISOLATE_UNIT_TEST_CASE(Service_Profile) {
 
 #endif  // !defined(TARGET_ARCH_ARM64)
 
+ISOLATE_UNIT_TEST_CASE(Service_RuntimeCounters) {
+  const Function& function = Function::Handle();
+  const String& selector = String::Handle(String::New("runtimeCountersTest"));
+  RuntimeCounters::RecordMegamorphicTransition(function, selector);
+
+  JSONStream js;
+  RuntimeCounters::PrintJSON(&js);
+  EXPECT_SUBSTRING("\"type\":\"_RuntimeCounters\"", js.ToCString());
+  EXPECT_SUBSTRING("\"selector\":\"runtimeCountersTest\"", js.ToCString());
+  EXPECT_NOTSUBSTRING("\"megamorphicTransitions\":0,", js.ToCString());
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
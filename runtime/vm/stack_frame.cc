@@ -513,6 +513,55 @@ bool StackFrame::FindExceptionHandler(Thread* thread,
   return true;
 }
 
+bool StackFrame::ExceptionHandlerCatches(Thread* thread,
+                                         const Instance& exception) const {
+  Zone* zone = thread->zone();
+  ExceptionHandlers& handlers = ExceptionHandlers::Handle(zone);
+  intptr_t try_index = -1;
+  if (is_interpreted()) {
+    const Bytecode& bytecode = Bytecode::Handle(zone, LookupDartBytecode());
+    ASSERT(!bytecode.IsNull());
+    handlers = bytecode.exception_handlers();
+    try_index = bytecode.GetTryIndexAtPc(pc());
+  } else {
+    const Code& code = Code::Handle(zone, LookupDartCode());
+    if (code.IsNull()) {
+      return false;
+    }
+    handlers = code.exception_handlers();
+    const PcDescriptors& descriptors =
+        PcDescriptors::Handle(zone, code.pc_descriptors());
+    const uword pc_offset = pc() - code.PayloadStart();
+    PcDescriptors::Iterator iter(descriptors, PcDescriptorsLayout::kAnyKind);
+    while (iter.MoveNext()) {
+      if ((iter.PcOffset() == pc_offset) && (iter.TryIndex() != -1)) {
+        try_index = iter.TryIndex();
+        break;
+      }
+    }
+  }
+  if ((try_index == -1) || (try_index >= handlers.num_entries())) {
+    return false;
+  }
+  const Array& handled_types =
+      Array::Handle(zone, handlers.GetHandledTypes(try_index));
+  if (handled_types.IsNull()) {
+    return false;
+  }
+  AbstractType& type = AbstractType::Handle(zone);
+  for (intptr_t i = 0; i < handled_types.Length(); i++) {
+    type ^= handled_types.At(i);
+    if (type.IsNull() || !type.IsInstantiated()) {
+      continue;
+    }
+    if (exception.IsInstanceOf(type, Object::null_type_arguments(),
+                               Object::null_type_arguments())) {
+      return true;
+    }
+  }
+  return false;
+}
+
 TokenPosition StackFrame::GetTokenPos() const {
   if (is_interpreted()) {
     const Bytecode& bytecode = Bytecode::Handle(LookupDartBytecode());
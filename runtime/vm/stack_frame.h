@@ -120,6 +120,11 @@ class StackFrame : public ValueObject {
                             bool* needs_stacktrace,
                             bool* is_catch_all,
                             bool* is_optimized) const;
+  // Returns true if the innermost exception handler around pc() is known to
+  // catch [exception], because [exception] is an instance of one of the
+  // instantiated types the handler guards on.
+  bool ExceptionHandlerCatches(Thread* thread,
+                               const Instance& exception) const;
   // Returns token_pos of the pc(), or -1 if none exists.
   TokenPosition GetTokenPos() const;
 
@@ -652,16 +652,30 @@ StringPtr Symbols::NewSymbol(Thread* thread, const StringType& str) {
         };
 
         SafepointWriteRwLocker sl(thread, group->symbols_lock());
-        if (FLAG_enable_isolate_groups || !USING_PRODUCT) {
-          // NOTE: Strictly speaking we should use a safepoint operation scope
-          // here to ensure the lock-free usage inside safepoint operations (see
-          // above) is safe. Though this would really kill the performance.
-          // TODO(https://dartbug.com/41943): Get rid of the symbol table
-          // accesses within safepoint operation scope.
-          group->RunWithStoppedMutators(insert_or_get,
-                                        /*force_heap_growth=*/true);
-        } else {
-          insert_or_get();
+
+        // Another thread may have inserted the symbol between us dropping the
+        // read lock and acquiring the write lock. Holding the write lock keeps
+        // out all other readers and writers, so re-check before paying for a
+        // stopped-mutators operation.
+        {
+          data = object_store->symbol_table();
+          SymbolTable table(&key, &value, &data);
+          symbol ^= table.GetOrNull(str);
+          table.Release();
+        }
+        if (symbol.IsNull()) {
+          if (FLAG_enable_isolate_groups || !USING_PRODUCT) {
+            // NOTE: Strictly speaking we should use a safepoint operation
+            // scope here to ensure the lock-free usage inside safepoint
+            // operations (see above) is safe. Though this would really kill
+            // the performance.
+            // TODO(https://dartbug.com/41943): Get rid of the symbol table
+            // accesses within safepoint operation scope.
+            group->RunWithStoppedMutators(insert_or_get,
+                                          /*force_heap_growth=*/true);
+          } else {
+            insert_or_get();
+          }
         }
       }
     }
@@ -26,6 +26,9 @@ class ObjectPointerVisitor;
   V(ArgDescVar, ":arg_desc")                                                   \
   V(ArgumentError, "ArgumentError")                                            \
   V(AsFunctionInternal, "_asFunctionInternal")                                 \
+  V(AsLazyFunctionInternal, "_asLazyFunctionInternal")                         \
+  V(AsLazyLeafFunctionInternal, "_asLazyLeafFunctionInternal")                 \
+  V(AsLeafFunctionInternal, "_asLeafFunctionInternal")                         \
   V(AssertionError, "_AssertionError")                                         \
   V(AssignIndexToken, "[]=")                                                   \
   V(AsyncCompleter, ":async_completer")                                        \
@@ -246,6 +249,7 @@ class ObjectPointerVisitor;
   V(RangeError, "RangeError")                                                  \
   V(RedirectionData, "RedirectionData")                                        \
   V(RegExp, "RegExp")                                                          \
+  V(ResolveLazyFunction, "_resolveLazyFunction")                               \
   V(RightShiftOperator, ">>")                                                  \
   V(SavedTryContextVar, ":saved_try_context_var")                              \
   V(Script, "Script")                                                          \
@@ -278,6 +282,7 @@ class ObjectPointerVisitor;
   V(ThrowNew, "_throwNew")                                                     \
   V(ThrowNewInvocation, "_throwNewInvocation")                                 \
   V(ThrowNewNullAssertion, "_throwNewNullAssertion")                           \
+  V(ThrowUnsupportedTypedData, "_throwUnsupportedTypedData")                   \
   V(TopLevel, "::")                                                            \
   V(TransferableTypedData, "TransferableTypedData")                            \
   V(TruncDivOperator, "~/")                                                    \
@@ -502,6 +507,7 @@ class ObjectPointerVisitor;
   V(vm_exact_result_type, "vm:exact-result-type")                              \
   V(vm_inferred_type_metadata, "vm.inferred-type.metadata")                    \
   V(vm_never_inline, "vm:never-inline")                                        \
+  V(vm_minimize_spills, "vm:minimize-spills")                                  \
   V(vm_non_nullable_result_type, "vm:non-nullable-result-type")                \
   V(vm_trace_entrypoints, "vm:testing.unsafe.trace-entrypoints-fn")            \
   V(vm_procedure_attributes_metadata, "vm.procedure-attributes.metadata")
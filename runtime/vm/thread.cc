@@ -35,6 +35,12 @@ DECLARE_FLAG(bool, trace_service);
 DECLARE_FLAG(bool, trace_service_verbose);
 #endif  // !defined(PRODUCT)
 
+DEFINE_FLAG(bool,
+            isolate_cpu_accounting,
+            false,
+            "Account the CPU time of each isolate's mutator to Dart code, the "
+            "VM runtime, GC and natives.");
+
 Thread::~Thread() {
   // We should cleanly exit any isolate before destruction.
   ASSERT(isolate_ == NULL);
@@ -739,10 +745,14 @@ class RestoreWriteBarrierInvariantVisitor : public ObjectPointerVisitor {
       // Stores into new-space objects don't need a write barrier.
       if (obj->IsSmiOrNewObject()) continue;
 
-      // To avoid adding too much work into the remembered set, skip
+      // To avoid adding too much work into the remembered set, skip large
       // arrays. Write barrier elimination will not remove the barrier
-      // if we can trigger GC between array allocation and store.
-      if (obj->GetClassId() == kArrayCid) continue;
+      // if we can trigger GC between such an array allocation and store.
+      if ((obj->GetClassId() == kArrayCid) &&
+          (Array::LengthOf(static_cast<ArrayPtr>(obj)) >
+           Array::kMaxLengthForWriteBarrierElimination)) {
+        continue;
+      }
 
       // Dart code won't store into VM-internal objects except Contexts and
       // UnhandledExceptions. This assumption is checked by an assertion in
@@ -1052,13 +1062,27 @@ void Thread::FinishEntering(TaskKind kind) {
   } else {
     store_buffer_block_ = isolate_group()->store_buffer()->PopEmptyBlock();
   }
+
+  if (FLAG_isolate_cpu_accounting && (kind == kMutatorTask)) {
+    ASSERT(cpu_accounting_isolate_ == nullptr);
+    cpu_accounting_start_micros_ = OS::GetCurrentThreadCPUMicros();
+    gc_cpu_accounting_depth_ = 0;
+    cpu_accounting_isolate_ = isolate();
+  }
 }
 
 void Thread::PrepareLeaving() {
   ASSERT(store_buffer_block_ != nullptr);
   ASSERT(execution_state() == Thread::kThreadInVM);
 
+  if (cpu_accounting_isolate_ != nullptr) {
+    AccountCpuTime();
+    cpu_accounting_isolate_ = nullptr;
+  }
+
   task_kind_ = kUnknownTask;
+  // Don't hold on to zone segments while the thread is not in use.
+  zone_segment_cache_.Flush();
   if (is_marking()) {
     MarkingStackRelease();
     DeferredMarkingStackRelease();
@@ -1066,6 +1090,37 @@ void Thread::PrepareLeaving() {
   StoreBufferRelease();
 }
 
+void Thread::AccountAllocatedBytes(intptr_t bytes) {
+  // The isolate is hidden while this thread performs a GC, so allocation
+  // buffers it retires there are not counted.
+  if (is_mutator_thread_ && (isolate_ != nullptr)) {
+    isolate_->AddAllocatedBytes(bytes);
+  }
+}
+
+void Thread::AccountCpuTime() {
+  ASSERT(this == Thread::Current());
+  const int64_t now = OS::GetCurrentThreadCPUMicros();
+  const int64_t elapsed = now - cpu_accounting_start_micros_;
+  cpu_accounting_start_micros_ = now;
+  switch (execution_state()) {
+    case kThreadInGenerated:
+      cpu_accounting_isolate_->AddCpuMicros(Isolate::kCpuDart, elapsed);
+      break;
+    case kThreadInVM:
+      cpu_accounting_isolate_->AddCpuMicros(
+          gc_cpu_accounting_depth_ > 0 ? Isolate::kCpuGC : Isolate::kCpuVM,
+          elapsed);
+      break;
+    case kThreadInNative:
+      cpu_accounting_isolate_->AddCpuMicros(Isolate::kCpuNative, elapsed);
+      break;
+    case kThreadInBlockedState:
+      // A blocked thread uses next to no CPU time.
+      break;
+  }
+}
+
 DisableThreadInterruptsScope::DisableThreadInterruptsScope(Thread* thread)
     : StackResource(thread) {
   if (thread != NULL) {
@@ -24,6 +24,7 @@
 #include "vm/runtime_entry_list.h"
 #include "vm/thread_stack_resource.h"
 #include "vm/thread_state.h"
+#include "vm/zone.h"
 namespace dart {
 
 class AbstractType;
@@ -402,6 +403,9 @@ class Thread : public ThreadState {
     api_reusable_scope_ = value;
   }
 
+  // Zone segments kept by this thread for reuse, see Zone::Segment::New.
+  ZoneSegmentCache* zone_segment_cache() { return &zone_segment_cache_; }
+
   // The api local scope for this thread, this where all local handles
   // are allocated.
   ApiLocalScope* api_top_scope() const { return api_top_scope_; }
@@ -525,6 +529,39 @@ class Thread : public ThreadState {
   static intptr_t top_offset() { return OFFSET_OF(Thread, top_); }
   static intptr_t end_offset() { return OFFSET_OF(Thread, end_); }
 
+  // Old-space allocation buffer, carved from the data freelist. Not accessed
+  // from generated code.
+  uword old_top() const { return old_top_; }
+  uword old_end() const { return old_end_; }
+  void set_old_top(uword old_top) { old_top_ = old_top; }
+  void set_old_end(uword old_end) { old_end_ = old_end; }
+
+  // Set when a new-space allocation crossed a sampling point of
+  // --allocation-sample-interval. Cleared when the allocation is recorded.
+  bool allocation_sample_pending() const { return allocation_sample_pending_; }
+  void set_allocation_sample_pending(bool value) {
+    allocation_sample_pending_ = value;
+  }
+
+  // Charges |bytes| to the isolate of a mutator thread.
+  void AccountAllocatedBytes(intptr_t bytes);
+
+  // With --isolate-cpu-accounting, the CPU time of a mutator thread is
+  // charged to its isolate at every change of execution state, by the state
+  // it is leaving. The time spent inside a GC counts as GC rather than VM.
+  void EnterGCCpuAccounting() {
+    if (UNLIKELY(cpu_accounting_isolate_ != nullptr)) {
+      AccountCpuTime();
+      gc_cpu_accounting_depth_++;
+    }
+  }
+  void ExitGCCpuAccounting() {
+    if (UNLIKELY(cpu_accounting_isolate_ != nullptr)) {
+      AccountCpuTime();
+      gc_cpu_accounting_depth_--;
+    }
+  }
+
   int32_t no_safepoint_scope_depth() const {
 #if defined(DEBUG)
     return no_safepoint_scope_depth_;
@@ -784,6 +821,9 @@ class Thread : public ThreadState {
     return static_cast<ExecutionState>(execution_state_);
   }
   void set_execution_state(ExecutionState state) {
+    if (UNLIKELY(cpu_accounting_isolate_ != nullptr)) {
+      AccountCpuTime();
+    }
     execution_state_ = static_cast<uword>(state);
   }
   static intptr_t execution_state_offset() {
@@ -1034,8 +1074,24 @@ class Thread : public ThreadState {
   Thread* next_;  // Used to chain the thread structures in an isolate.
   bool is_mutator_thread_ = false;
 
+  uword old_top_ = 0;
+  uword old_end_ = 0;
+
+  bool allocation_sample_pending_ = false;
+
+  // The isolate charged for this thread's CPU time, or null when CPU
+  // accounting is off. Kept separately from isolate_, which is cleared
+  // during GC.
+  Isolate* cpu_accounting_isolate_ = nullptr;
+  int64_t cpu_accounting_start_micros_ = 0;
+  int32_t gc_cpu_accounting_depth_ = 0;
+
+  ZoneSegmentCache zone_segment_cache_;
+
   explicit Thread(bool is_vm_isolate);
 
+  void AccountCpuTime();
+
   void StoreBufferRelease(
       StoreBuffer::ThresholdPolicy policy = StoreBuffer::kCheckThreshold);
   void StoreBufferAcquire();
@@ -143,6 +143,21 @@ void ThreadPool::MarkCurrentWorkerAsUnBlocked() {
   }
 }
 
+uint64_t ThreadPool::tasks_started() {
+  MonitorLocker ml(&pool_monitor_);
+  return tasks_started_;
+}
+
+int64_t ThreadPool::total_task_wait_micros() {
+  MonitorLocker ml(&pool_monitor_);
+  return total_task_wait_micros_;
+}
+
+int64_t ThreadPool::max_task_wait_micros() {
+  MonitorLocker ml(&pool_monitor_);
+  return max_task_wait_micros_;
+}
+
 void ThreadPool::WorkerLoop(Worker* worker) {
   WorkerList dead_workers_to_join;
 
@@ -154,6 +169,11 @@ void ThreadPool::WorkerLoop(Worker* worker) {
       while (!tasks_.IsEmpty()) {
         std::unique_ptr<Task> task(tasks_.RemoveFirst());
         pending_tasks_--;
+        const int64_t waited =
+            OS::GetCurrentMonotonicMicros() - task->enqueued_micros_;
+        tasks_started_++;
+        total_task_wait_micros_ += waited;
+        max_task_wait_micros_ = Utils::Maximum(max_task_wait_micros_, waited);
         MonitorLeaveScope mls(&ml);
         task->Run();
         ASSERT(Isolate::Current() == nullptr);
@@ -262,6 +282,7 @@ void ThreadPool::JoinDeadWorkersLocked(WorkerList* dead_workers_to_join) {
 ThreadPool::Worker* ThreadPool::ScheduleTaskLocked(MonitorLocker* ml,
                                                    std::unique_ptr<Task> task) {
   // Enqueue the new task.
+  task->enqueued_micros_ = OS::GetCurrentMonotonicMicros();
   tasks_.Append(task.release());
   pending_tasks_++;
   ASSERT(pending_tasks_ >= 1);
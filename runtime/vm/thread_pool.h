@@ -31,6 +31,11 @@ class ThreadPool {
     virtual void Run() = 0;
 
    private:
+    friend class ThreadPool;
+
+    // When the task was added to the pool's queue.
+    int64_t enqueued_micros_ = 0;
+
     DISALLOW_COPY_AND_ASSIGN(Task);
   };
 
@@ -66,6 +71,12 @@ class ThreadPool {
   // Exposed for unit test in thread_pool_test.cc
   uint64_t workers_stopped() const { return count_dead_; }
 
+  // Queue latency statistics: the number of tasks taken off the queue, and
+  // the total and the longest time tasks waited in the queue for a worker.
+  uint64_t tasks_started();
+  int64_t total_task_wait_micros();
+  int64_t max_task_wait_micros();
+
  private:
   class Worker : public IntrusiveDListEntry<Worker> {
    public:
@@ -129,6 +140,9 @@ class ThreadPool {
   WorkerList dead_workers_;
   uint64_t pending_tasks_ = 0;
   TaskList tasks_;
+  uint64_t tasks_started_ = 0;
+  int64_t total_task_wait_micros_ = 0;
+  int64_t max_task_wait_micros_ = 0;
 
   Monitor exit_monitor_;
   std::atomic<bool> all_workers_dead_;
@@ -75,6 +75,12 @@ THREAD_POOL_UNIT_TEST_CASE(ThreadPool_RunOne) {
   // Do a sanity test on the worker stats.
   EXPECT_EQ(1U, thread_pool.workers_started());
   EXPECT_EQ(0U, thread_pool.workers_stopped());
+
+  // And on the queue latency stats.
+  EXPECT_EQ(1U, thread_pool.tasks_started());
+  EXPECT_LE(0, thread_pool.max_task_wait_micros());
+  EXPECT_EQ(thread_pool.max_task_wait_micros(),
+            thread_pool.total_task_wait_micros());
 }
 
 THREAD_POOL_UNIT_TEST_CASE(ThreadPool_RunMany) {
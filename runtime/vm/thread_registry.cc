@@ -4,6 +4,7 @@
 
 #include "vm/thread_registry.h"
 
+#include "vm/heap/pages.h"
 #include "vm/json_stream.h"
 #include "vm/lockers.h"
 
@@ -70,6 +71,15 @@ void ThreadRegistry::ReleaseStoreBuffers() {
   }
 }
 
+void ThreadRegistry::AbandonOldSpaceTLABs(PageSpace* old_space) {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    old_space->AbandonTLAB(thread);
+    thread = thread->next_;
+  }
+}
+
 void ThreadRegistry::AcquireMarkingStacks() {
   MonitorLocker ml(threads_lock());
   Thread* thread = active_list_;
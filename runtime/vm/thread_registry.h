@@ -32,6 +32,7 @@ class ThreadRegistry {
   void ReleaseStoreBuffers();
   void AcquireMarkingStacks();
   void ReleaseMarkingStacks();
+  void AbandonOldSpaceTLABs(PageSpace* old_space);
 
 #ifndef PRODUCT
   void PrintJSON(JSONStream* stream) const;
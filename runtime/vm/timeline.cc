@@ -19,6 +19,7 @@
 #include "vm/log.h"
 #include "vm/object.h"
 #include "vm/service.h"
+#include "vm/service_binary.h"
 #include "vm/service_event.h"
 #include "vm/thread.h"
 
@@ -55,7 +56,7 @@ DEFINE_FLAG(charp,
             timeline_recorder,
             "ring",
             "Select the timeline recorder used. "
-            "Valid values: ring, endless, startup, and systrace.")
+            "Valid values: ring, endless, startup, systrace, and perfetto.")
 
 // Implementation notes:
 //
@@ -100,6 +101,16 @@ DEFINE_FLAG(charp,
 //
 
 static TimelineEventRecorder* CreateTimelineRecorder() {
+  // The Perfetto recorder streams to --timeline_dir itself.
+  if ((FLAG_timeline_recorder != NULL) &&
+      (strcmp("perfetto", FLAG_timeline_recorder) == 0)) {
+    if (FLAG_trace_timeline) {
+      THR_Print("Using the Perfetto timeline recorder.\n");
+    }
+    return new TimelineEventPerfettoRecorder(
+        FLAG_timeline_dir != NULL ? FLAG_timeline_dir : ".");
+  }
+
   // Some flags require that we use the endless recorder.
   const bool use_endless_recorder =
       (FLAG_timeline_dir != NULL) || FLAG_timing || FLAG_complete_timeline;
@@ -708,6 +719,82 @@ void TimelineEvent::PrintJSON(JSONStream* stream) const {
     }
   }
 }
+
+// Optional fields of a binary event.
+enum BinaryEventFlags {
+  kBinaryThreadTime = 1 << 0,
+  kBinaryDuration = 1 << 1,
+  kBinaryAsyncId = 1 << 2,
+  kBinarySerializedArgs = 1 << 3,
+  kBinaryIsolateId = 1 << 4,
+  kBinaryIsolateGroupId = 1 << 5,
+};
+
+// The phases are those of the JSON encoding, indexed by EventType.
+static const char kBinaryPhases[] = "?BEXibneCstfM";
+
+void TimelineEvent::PrintBinary(ServiceBinaryWriter* writer,
+                                int64_t base_micros) const {
+  COMPILE_ASSERT(sizeof(kBinaryPhases) == kNumEventTypes + 1);
+  const EventType type = event_type();
+  ASSERT((type > kNone) && (type < kNumEventTypes));
+  uint8_t flags = 0;
+  if (HasThreadCPUTime()) {
+    flags |= kBinaryThreadTime;
+  }
+  if (type == kDuration) {
+    flags |= kBinaryDuration;
+  }
+  if ((type == kAsyncBegin) || (type == kAsyncInstant) || (type == kAsyncEnd) ||
+      (type == kFlowBegin) || (type == kFlowStep) || (type == kFlowEnd)) {
+    flags |= kBinaryAsyncId;
+  }
+  if (pre_serialized_args()) {
+    flags |= kBinarySerializedArgs;
+  }
+  if (isolate_id_ != ILLEGAL_PORT) {
+    flags |= kBinaryIsolateId;
+  }
+  if (isolate_group_id_ != 0) {
+    flags |= kBinaryIsolateGroupId;
+  }
+
+  writer->WriteByte(kBinaryPhases[type]);
+  writer->WriteByte(flags);
+  writer->WriteInternedString(label_);
+  writer->WriteInternedString(stream_ != NULL ? stream_->name() : NULL);
+  writer->WriteSigned(OSThread::ThreadIdToIntPtr(thread_));
+  writer->WriteSigned(TimeOrigin() - base_micros);
+  if ((flags & kBinaryThreadTime) != 0) {
+    writer->WriteSigned(ThreadCPUTimeOrigin());
+  }
+  if ((flags & kBinaryDuration) != 0) {
+    writer->WriteSigned(TimeDuration());
+    if ((flags & kBinaryThreadTime) != 0) {
+      writer->WriteSigned(ThreadCPUTimeDuration());
+    }
+  }
+  if ((flags & kBinaryAsyncId) != 0) {
+    writer->WriteUnsigned(AsyncId());
+  }
+  if ((flags & kBinaryIsolateId) != 0) {
+    writer->WriteSigned(isolate_id_);
+  }
+  if ((flags & kBinaryIsolateGroupId) != 0) {
+    writer->WriteUnsigned(isolate_group_id_);
+  }
+  if ((flags & kBinarySerializedArgs) != 0) {
+    ASSERT(arguments_.length() == 1);
+    writer->WriteString(arguments_[0].value);
+  } else {
+    writer->WriteUnsigned(arguments_.length());
+    for (intptr_t i = 0; i < arguments_.length(); i++) {
+      const TimelineEventArgument& arg = arguments_[i];
+      writer->WriteInternedString(arg.name);
+      writer->WriteString(arg.value);
+    }
+  }
+}
 #endif
 
 int64_t TimelineEvent::TimeOrigin() const {
@@ -980,7 +1067,7 @@ TimelineEvent* TimelineEventRecorder::ThreadBlockStartEvent() {
     MutexLocker ml(&lock_);
     // Thread has a block and it is full:
     // 1) Mark it as finished.
-    thread_block->Finish();
+    FinishBlockLocked(thread_block);
     // 2) Allocate a new block.
     thread_block = GetNewBlockLocked();
     thread->set_timeline_block(thread_block);
@@ -1106,7 +1193,7 @@ void TimelineEventRecorder::FinishBlock(TimelineEventBlock* block) {
     return;
   }
   MutexLocker ml(&lock_);
-  block->Finish();
+  FinishBlockLocked(block);
 }
 
 TimelineEventBlock* TimelineEventRecorder::GetNewBlock() {
@@ -1456,6 +1543,22 @@ void TimelineEventBlock::PrintJSON(JSONStream* js) const {
     events.AddValue(event);
   }
 }
+
+// The payload starts with a version, the process id and the number of
+// events. Each event's timestamp is relative to the previous one.
+void TimelineEventBlock::PrintBinary(ServiceBinaryWriter* writer) const {
+  ASSERT(!in_use());
+  const intptr_t kBinaryVersion = 1;
+  writer->WriteByte(kBinaryVersion);
+  writer->WriteUnsigned(OS::ProcessId());
+  writer->WriteUnsigned(length());
+  int64_t base_micros = 0;
+  for (intptr_t i = 0; i < length(); i++) {
+    const TimelineEvent* event = At(i);
+    event->PrintBinary(writer, base_micros);
+    base_micros = event->TimeOrigin();
+  }
+}
 #endif
 
 TimelineEvent* TimelineEventBlock::StartEvent() {
@@ -1524,9 +1627,13 @@ void TimelineEventBlock::Finish() {
   in_use_ = false;
 #ifndef PRODUCT
   if (Service::timeline_stream.enabled()) {
-    ServiceEvent service_event(NULL, ServiceEvent::kTimelineEvents);
-    service_event.set_timeline_event_block(this);
-    Service::HandleEvent(&service_event);
+    if (Service::timeline_stream.binary()) {
+      Service::SendBinaryTimelineEvents(this);
+    } else {
+      ServiceEvent service_event(NULL, ServiceEvent::kTimelineEvents);
+      service_event.set_timeline_event_block(this);
+      Service::HandleEvent(&service_event);
+    }
   }
 #endif
 }
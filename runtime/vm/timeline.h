@@ -14,6 +14,7 @@
 #include "vm/growable_array.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
+#include "vm/protobuf_writer.h"
 
 #if defined(FUCHSIA_SDK) || defined (HOST_OS_FUCHSIA)
 #include <lib/trace-engine/context.h>
@@ -39,10 +40,12 @@ class JSONStream;
 class Object;
 class ObjectPointerVisitor;
 class Isolate;
+class ServiceBinaryWriter;
 class Thread;
 class TimelineEvent;
 class TimelineEventBlock;
 class TimelineEventRecorder;
+class TimelinePerfettoTracks;
 class TimelineStream;
 class VirtualMemory;
 class Zone;
@@ -51,6 +54,7 @@ class Zone;
 #define ENDLESS_RECORDER_NAME "Endless"
 #define FUCHSIA_RECORDER_NAME "Fuchsia"
 #define MACOS_RECORDER_NAME "Macos"
+#define PERFETTO_RECORDER_NAME "Perfetto"
 #define RING_RECORDER_NAME "Ring"
 #define STARTUP_RECORDER_NAME "Startup"
 #define SYSTRACE_RECORDER_NAME "Systrace"
@@ -346,6 +350,8 @@ class TimelineEvent {
 
 #ifndef PRODUCT
   void PrintJSON(JSONStream* stream) const;
+  // Writes the event with its timestamp relative to |base_micros|.
+  void PrintBinary(ServiceBinaryWriter* writer, int64_t base_micros) const;
 #endif
 
   ThreadId thread() const { return thread_; }
@@ -481,6 +487,7 @@ class TimelineEvent {
   friend class TimelineEventPlatformRecorder;
   friend class TimelineEventFuchsiaRecorder;
   friend class TimelineEventMacosRecorder;
+  friend class TimelineEventPerfettoRecorder;
   friend class TimelineStream;
   friend class TimelineTestHelper;
   DISALLOW_COPY_AND_ASSIGN(TimelineEvent);
@@ -624,6 +631,8 @@ class TimelineEventBlock {
  protected:
 #ifndef PRODUCT
   void PrintJSON(JSONStream* stream) const;
+  // Writes the events in the binary encoding of the Timeline stream.
+  void PrintBinary(ServiceBinaryWriter* writer) const;
 #endif
 
   TimelineEvent* StartEvent();
@@ -646,8 +655,10 @@ class TimelineEventBlock {
   friend class TimelineEventRingRecorder;
   friend class TimelineEventStartupRecorder;
   friend class TimelineEventPlatformRecorder;
+  friend class TimelineEventPerfettoRecorder;
   friend class TimelineTestHelper;
   friend class JSONStream;
+  friend class Service;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(TimelineEventBlock);
@@ -728,7 +739,7 @@ class TimelineEventRecorder {
 
  protected:
 #ifndef PRODUCT
-  void WriteTo(const char* directory);
+  virtual void WriteTo(const char* directory);
 #endif
 
   // Interface method(s) which must be implemented.
@@ -738,6 +749,11 @@ class TimelineEventRecorder {
   virtual TimelineEventBlock* GetNewBlockLocked() = 0;
   virtual void Clear() = 0;
 
+  // Called with |lock_| held when a thread is done with |block|.
+  virtual void FinishBlockLocked(TimelineEventBlock* block) {
+    block->Finish();
+  }
+
   // Utility method(s).
 #ifndef PRODUCT
   void PrintJSONMeta(JSONArray* array) const;
@@ -886,6 +902,79 @@ class TimelineEventEndlessRecorder : public TimelineEventRecorder {
   friend class TimelineTestHelper;
 };
 
+// A recorder that streams events to a file in Perfetto's protobuf trace format
+// (https://perfetto.dev/docs/reference/trace-packet-proto).
+//
+// Threads fill their cached blocks without synchronizing with each other, as
+// with the other block based recorders. Finished blocks are handed to a writer
+// thread, which encodes them, appends them to the file and recycles them, so
+// memory use is bounded by |kMaxBlocks|. Events are dropped rather than making
+// a thread wait when the writer falls behind.
+class TimelineEventPerfettoRecorder : public TimelineEventRecorder {
+ public:
+  static const intptr_t kMaxBlocks = 256;
+
+  explicit TimelineEventPerfettoRecorder(const char* directory);
+  virtual ~TimelineEventPerfettoRecorder();
+
+#ifndef PRODUCT
+  void PrintJSON(JSONStream* js, TimelineEventFilter* filter);
+  void PrintTraceEvent(JSONStream* js, TimelineEventFilter* filter);
+#endif
+
+  const char* name() const { return PERFETTO_RECORDER_NAME; }
+  intptr_t Size() { return num_blocks_ * sizeof(TimelineEventBlock); }
+
+ protected:
+#ifndef PRODUCT
+  void WriteTo(const char* directory);
+#endif
+
+  TimelineEvent* StartEvent();
+  void CompleteEvent(TimelineEvent* event);
+  TimelineEventBlock* GetNewBlockLocked();
+  TimelineEventBlock* GetHeadBlockLocked() { return NULL; }
+  void FinishBlockLocked(TimelineEventBlock* block);
+  void Clear() {}
+
+ private:
+  static void ThreadMain(uword parameters);
+
+  // Encodes and writes all finished blocks and recycles them.
+  void Drain();
+  void WriteBlock(TimelineEventBlock* block);
+  void WriteEvent(TimelineEvent* event);
+  static void WriteEventDetails(ProtobufWriter* track_event,
+                                TimelineEvent* event);
+  void WriteThreadTrack(intptr_t tid);
+  uint64_t AsyncTrack(TimelineEvent* event);
+  uint64_t CounterTrack(TimelineEvent* event, const char* name);
+  void WritePacket(int64_t timestamp_micros, const ProtobufWriter& body);
+  void Flush();
+
+  bool shutdown_;
+  ThreadJoinId writer_id_;
+  Monitor monitor_;
+
+  // Serializes Drain between the writer thread and WriteTo.
+  Mutex write_lock_;
+
+  // Guarded by |lock_|.
+  TimelineEventBlock* free_blocks_;
+  TimelineEventBlock* finished_head_;
+  TimelineEventBlock* finished_tail_;
+  intptr_t num_blocks_;
+  intptr_t num_finished_;
+
+  // Guarded by |write_lock_|.
+  char* path_;
+  void* file_;
+  ProtobufWriter buffer_;
+  TimelinePerfettoTracks* tracks_;
+
+  DISALLOW_COPY_AND_ASSIGN(TimelineEventPerfettoRecorder);
+};
+
 // An iterator for blocks.
 class TimelineEventBlockIterator {
  public:
@@ -0,0 +1,526 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/globals.h"
+#if defined(SUPPORT_TIMELINE)
+
+#include <cstdlib>
+
+#include "vm/dart.h"
+#include "vm/hash.h"
+#include "vm/hash_map.h"
+#include "vm/json_stream.h"
+#include "vm/lockers.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+#include "vm/timeline.h"
+
+namespace dart {
+
+DECLARE_FLAG(bool, trace_timeline);
+
+// Finished blocks are written at least this often.
+static const int64_t kDrainIntervalMicros = 1 * kMicrosecondsPerSecond;
+
+// Field numbers from the protos in
+// https://github.com/google/perfetto/tree/master/protos/perfetto/trace.
+enum {
+  kTracePacket = 1,
+  kPacketTimestamp = 8,
+  kPacketTrustedSequenceId = 10,
+  kPacketTrackEvent = 11,
+  kPacketSequenceFlags = 13,
+  kPacketTimestampClockId = 58,
+  kPacketTrackDescriptor = 60,
+  kTrackEventDebugAnnotation = 4,
+  kTrackEventType = 9,
+  kTrackEventTrackUuid = 11,
+  kTrackEventCategory = 22,
+  kTrackEventName = 23,
+  kTrackEventDoubleCounterValue = 44,
+  kTrackEventFlowId = 47,
+  kTrackEventTerminatingFlowId = 48,
+  kTrackDescriptorUuid = 1,
+  kTrackDescriptorName = 2,
+  kTrackDescriptorProcess = 3,
+  kTrackDescriptorThread = 4,
+  kTrackDescriptorParentUuid = 5,
+  kTrackDescriptorCounter = 8,
+  kProcessDescriptorPid = 1,
+  kThreadDescriptorPid = 1,
+  kThreadDescriptorTid = 2,
+  kThreadDescriptorName = 5,
+  kDebugAnnotationStringValue = 6,
+  kDebugAnnotationName = 10,
+};
+
+// TrackEvent.Type.
+enum {
+  kSliceBegin = 1,
+  kSliceEnd = 2,
+  kInstant = 3,
+  kCounter = 4,
+};
+
+// All timeline timestamps come from OS::GetCurrentMonotonicMicros, which is
+// also what Dart_TimelineGetMicros hands to the embedder.
+static const intptr_t kBuiltinClockMonotonic = 3;
+static const intptr_t kSequenceIncrementalStateCleared = 1;
+static const intptr_t kSequenceId = 1;
+
+// The low bits of a track's uuid say what kind of track it is, so that thread
+// ids, the process id and async ids cannot collide.
+enum {
+  kThreadTrack = 0,
+  kProcessTrack = 1,
+  kAsyncTrack = 2,
+  kCounterTrack = 3,
+  kTrackKindBits = 2,
+};
+
+static uint64_t TrackUuid(uint64_t id, intptr_t kind) {
+  return (id << kTrackKindBits) | kind;
+}
+
+static uint64_t ProcessTrackUuid() {
+  return TrackUuid(OS::ProcessId(), kProcessTrack);
+}
+
+// The set of tracks whose descriptor has been written.
+class TimelinePerfettoTrackTrait {
+ public:
+  typedef uint64_t Key;
+  typedef uint64_t Value;
+  typedef uint64_t Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+  static Value ValueOf(Pair kv) { return kv; }
+  static intptr_t Hashcode(Key key) {
+    return static_cast<intptr_t>(key ^ (key >> 32));
+  }
+  static bool IsKeyEqual(Pair kv, Key key) { return kv == key; }
+};
+
+class TimelinePerfettoTracks
+    : public MallocDirectChainedHashMap<TimelinePerfettoTrackTrait> {
+ public:
+  // Returns true the first time |uuid| is seen.
+  bool Add(uint64_t uuid) {
+    if (HasKey(uuid)) {
+      return false;
+    }
+    Insert(uuid);
+    return true;
+  }
+};
+
+TimelineEventPerfettoRecorder::TimelineEventPerfettoRecorder(
+    const char* directory)
+    : shutdown_(false),
+      writer_id_(OSThread::kInvalidThreadJoinId),
+      monitor_(),
+      write_lock_(),
+      free_blocks_(NULL),
+      finished_head_(NULL),
+      finished_tail_(NULL),
+      num_blocks_(0),
+      num_finished_(0),
+      path_(OS::SCreate(NULL,
+                        "%s/dart-timeline-%" Pd ".pftrace",
+                        directory,
+                        OS::ProcessId())),
+      file_(NULL),
+      buffer_(),
+      tracks_(new TimelinePerfettoTracks()) {
+  MonitorLocker ml(&monitor_);
+  OSThread::Start("Dart Timeline Writer", ThreadMain,
+                  reinterpret_cast<uword>(this));
+  while (writer_id_ == OSThread::kInvalidThreadJoinId) {
+    ml.Wait();
+  }
+}
+
+TimelineEventPerfettoRecorder::~TimelineEventPerfettoRecorder() {
+  {
+    MonitorLocker ml(&monitor_);
+    shutdown_ = true;
+    ml.Notify();
+  }
+  OSThread::Join(writer_id_);
+  writer_id_ = OSThread::kInvalidThreadJoinId;
+
+  Timeline::ReclaimCachedBlocksFromThreads();
+  Drain();
+  if (file_ != NULL) {
+    Dart_FileCloseCallback file_close = Dart::file_close_callback();
+    (*file_close)(file_);
+    file_ = NULL;
+  }
+
+  TimelineEventBlock* current = free_blocks_;
+  while (current != NULL) {
+    TimelineEventBlock* next = current->next();
+    delete current;
+    current = next;
+  }
+  free_blocks_ = NULL;
+  delete tracks_;
+  free(path_);
+}
+
+#ifndef PRODUCT
+void TimelineEventPerfettoRecorder::PrintJSON(JSONStream* js,
+                                              TimelineEventFilter* filter) {
+  // Events only live in the trace file.
+  JSONObject topLevel(js);
+  topLevel.AddProperty("type", "Timeline");
+  {
+    JSONArray events(&topLevel, "traceEvents");
+    PrintJSONMeta(&events);
+  }
+  topLevel.AddPropertyTimeMicros("timeOriginMicros", TimeOriginMicros());
+  topLevel.AddPropertyTimeMicros("timeExtentMicros", TimeExtentMicros());
+}
+
+void TimelineEventPerfettoRecorder::PrintTraceEvent(
+    JSONStream* js,
+    TimelineEventFilter* filter) {
+  JSONArray events(js);
+}
+
+void TimelineEventPerfettoRecorder::WriteTo(const char* directory) {
+  // Everything recorded so far goes to the file the recorder streams to. The
+  // writer thread may be draining at the same time.
+  Timeline::ReclaimCachedBlocksFromThreads();
+  Drain();
+}
+#endif
+
+TimelineEvent* TimelineEventPerfettoRecorder::StartEvent() {
+  return ThreadBlockStartEvent();
+}
+
+void TimelineEventPerfettoRecorder::CompleteEvent(TimelineEvent* event) {
+  if (event == NULL) {
+    return;
+  }
+  ThreadBlockCompleteEvent(event);
+}
+
+TimelineEventBlock* TimelineEventPerfettoRecorder::GetNewBlockLocked() {
+  TimelineEventBlock* block = free_blocks_;
+  if (block != NULL) {
+    free_blocks_ = block->next();
+    block->set_next(NULL);
+  } else if (num_blocks_ < kMaxBlocks) {
+    block = new TimelineEventBlock(num_blocks_++);
+    if (FLAG_trace_timeline) {
+      OS::PrintErr("Created new block %p\n", block);
+    }
+  } else {
+    // The writer is behind. Drop events until it recycles some blocks.
+    return NULL;
+  }
+  block->Open();
+  return block;
+}
+
+void TimelineEventPerfettoRecorder::FinishBlockLocked(
+    TimelineEventBlock* block) {
+  block->Finish();
+  block->set_next(NULL);
+  if (finished_tail_ == NULL) {
+    finished_head_ = finished_tail_ = block;
+  } else {
+    finished_tail_->set_next(block);
+    finished_tail_ = block;
+  }
+  num_finished_++;
+  if (num_finished_ == kMaxBlocks / 2) {
+    // Wake the writer early so threads don't run out of blocks.
+    MonitorLocker ml(&monitor_);
+    ml.Notify();
+  }
+}
+
+void TimelineEventPerfettoRecorder::ThreadMain(uword parameters) {
+  TimelineEventPerfettoRecorder* recorder =
+      reinterpret_cast<TimelineEventPerfettoRecorder*>(parameters);
+  {
+    MonitorLocker ml(&recorder->monitor_);
+    recorder->writer_id_ =
+        OSThread::GetCurrentThreadJoinId(OSThread::Current());
+    ml.Notify();
+  }
+  while (true) {
+    bool timed_out = false;
+    {
+      MonitorLocker ml(&recorder->monitor_);
+      if (!recorder->shutdown_) {
+        timed_out = ml.WaitMicros(kDrainIntervalMicros) == Monitor::kTimedOut;
+      }
+      if (recorder->shutdown_) {
+        return;
+      }
+    }
+    if (timed_out) {
+      // Pick up the partially filled blocks of quiet threads as well.
+      Timeline::ReclaimCachedBlocksFromThreads();
+    }
+    recorder->Drain();
+  }
+}
+
+void TimelineEventPerfettoRecorder::Drain() {
+  MutexLocker wl(&write_lock_);
+  TimelineEventBlock* head;
+  {
+    MutexLocker ml(&lock_);
+    head = finished_head_;
+    finished_head_ = finished_tail_ = NULL;
+    num_finished_ = 0;
+  }
+  if (head == NULL) {
+    return;
+  }
+  TimelineEventBlock* tail = NULL;
+  for (TimelineEventBlock* block = head; block != NULL;
+       block = block->next()) {
+    WriteBlock(block);
+    block->Reset();
+    tail = block;
+  }
+  Flush();
+  MutexLocker ml(&lock_);
+  tail->set_next(free_blocks_);
+  free_blocks_ = head;
+}
+
+void TimelineEventPerfettoRecorder::WriteBlock(TimelineEventBlock* block) {
+  for (intptr_t i = 0; i < block->length(); i++) {
+    TimelineEvent* event = block->At(i);
+    if (event->IsValid()) {
+      WriteEvent(event);
+    }
+  }
+}
+
+void TimelineEventPerfettoRecorder::WriteEventDetails(
+    ProtobufWriter* track_event,
+    TimelineEvent* event) {
+  if (event->stream_ != NULL) {
+    track_event->WriteString(kTrackEventCategory, event->stream_->name());
+  }
+  track_event->WriteString(kTrackEventName, event->label());
+  for (intptr_t i = 0; i < event->arguments_length(); i++) {
+    const TimelineEventArgument& argument = event->arguments()[i];
+    ProtobufWriter annotation;
+    // Pre-serialized arguments are a single JSON object.
+    annotation.WriteString(kDebugAnnotationName,
+                           event->pre_serialized_args() ? "args"
+                                                        : argument.name);
+    annotation.WriteString(kDebugAnnotationStringValue, argument.value);
+    track_event->WriteMessage(kTrackEventDebugAnnotation, annotation);
+  }
+}
+
+void TimelineEventPerfettoRecorder::WriteEvent(TimelineEvent* event) {
+  const intptr_t tid = OSThread::ThreadIdToIntPtr(event->thread());
+  const uint64_t thread_track = TrackUuid(tid, kThreadTrack);
+  WriteThreadTrack(tid);
+
+  ProtobufWriter track_event;
+  switch (event->event_type()) {
+    case TimelineEvent::kBegin:
+    case TimelineEvent::kDuration:
+      track_event.WriteInt64(kTrackEventType, kSliceBegin);
+      track_event.WriteInt64(kTrackEventTrackUuid, thread_track);
+      WriteEventDetails(&track_event, event);
+      WritePacket(event->TimeOrigin(), track_event);
+      if (event->IsFinishedDuration()) {
+        ProtobufWriter end;
+        end.WriteInt64(kTrackEventType, kSliceEnd);
+        end.WriteInt64(kTrackEventTrackUuid, thread_track);
+        WritePacket(event->TimeEnd(), end);
+      }
+      break;
+    case TimelineEvent::kEnd:
+      track_event.WriteInt64(kTrackEventType, kSliceEnd);
+      track_event.WriteInt64(kTrackEventTrackUuid, thread_track);
+      WritePacket(event->TimeOrigin(), track_event);
+      break;
+    case TimelineEvent::kInstant:
+      track_event.WriteInt64(kTrackEventType, kInstant);
+      track_event.WriteInt64(kTrackEventTrackUuid, thread_track);
+      WriteEventDetails(&track_event, event);
+      WritePacket(event->TimeOrigin(), track_event);
+      break;
+    case TimelineEvent::kAsyncBegin:
+      track_event.WriteInt64(kTrackEventType, kSliceBegin);
+      track_event.WriteInt64(kTrackEventTrackUuid, AsyncTrack(event));
+      WriteEventDetails(&track_event, event);
+      WritePacket(event->TimeOrigin(), track_event);
+      break;
+    case TimelineEvent::kAsyncEnd:
+      track_event.WriteInt64(kTrackEventType, kSliceEnd);
+      track_event.WriteInt64(kTrackEventTrackUuid, AsyncTrack(event));
+      WritePacket(event->TimeOrigin(), track_event);
+      break;
+    case TimelineEvent::kAsyncInstant:
+      track_event.WriteInt64(kTrackEventType, kInstant);
+      track_event.WriteInt64(kTrackEventTrackUuid, AsyncTrack(event));
+      WriteEventDetails(&track_event, event);
+      WritePacket(event->TimeOrigin(), track_event);
+      break;
+    case TimelineEvent::kCounter:
+      // Each argument is the value of a separate counter.
+      for (intptr_t i = 0; i < event->arguments_length(); i++) {
+        const TimelineEventArgument& argument = event->arguments()[i];
+        ProtobufWriter counter;
+        counter.WriteInt64(kTrackEventType, kCounter);
+        counter.WriteInt64(kTrackEventTrackUuid,
+                           CounterTrack(event, argument.name));
+        counter.WriteDouble(kTrackEventDoubleCounterValue,
+                            strtod(argument.value, NULL));
+        WritePacket(event->TimeOrigin(), counter);
+      }
+      break;
+    case TimelineEvent::kFlowBegin:
+    case TimelineEvent::kFlowStep:
+    case TimelineEvent::kFlowEnd:
+      track_event.WriteInt64(kTrackEventType, kInstant);
+      track_event.WriteInt64(kTrackEventTrackUuid, thread_track);
+      WriteEventDetails(&track_event, event);
+      track_event.WriteFixed64(event->event_type() == TimelineEvent::kFlowEnd
+                                   ? kTrackEventTerminatingFlowId
+                                   : kTrackEventFlowId,
+                               event->AsyncId());
+      WritePacket(event->TimeOrigin(), track_event);
+      break;
+    default:
+      // Metadata has no equivalent.
+      break;
+  }
+}
+
+void TimelineEventPerfettoRecorder::WriteThreadTrack(intptr_t tid) {
+  if (tracks_->Add(ProcessTrackUuid())) {
+    ProtobufWriter process;
+    process.WriteInt64(kProcessDescriptorPid, OS::ProcessId());
+    ProtobufWriter descriptor;
+    descriptor.WriteInt64(kTrackDescriptorUuid, ProcessTrackUuid());
+    descriptor.WriteMessage(kTrackDescriptorProcess, process);
+    ProtobufWriter packet;
+    packet.WriteMessage(kPacketTrackDescriptor, descriptor);
+    packet.WriteInt64(kPacketTrustedSequenceId, kSequenceId);
+    packet.WriteInt64(kPacketSequenceFlags, kSequenceIncrementalStateCleared);
+    buffer_.WriteMessage(kTracePacket, packet);
+  }
+  const uint64_t uuid = TrackUuid(tid, kThreadTrack);
+  if (!tracks_->Add(uuid)) {
+    return;
+  }
+  ProtobufWriter thread;
+  thread.WriteInt64(kThreadDescriptorPid, OS::ProcessId());
+  thread.WriteInt64(kThreadDescriptorTid, tid);
+  {
+    OSThreadIterator it;
+    while (it.HasNext()) {
+      OSThread* os_thread = it.Next();
+      if ((OSThread::ThreadIdToIntPtr(os_thread->trace_id()) == tid) &&
+          (os_thread->name() != NULL)) {
+        thread.WriteString(kThreadDescriptorName, os_thread->name());
+        break;
+      }
+    }
+  }
+  ProtobufWriter descriptor;
+  descriptor.WriteInt64(kTrackDescriptorUuid, uuid);
+  descriptor.WriteInt64(kTrackDescriptorParentUuid, ProcessTrackUuid());
+  descriptor.WriteMessage(kTrackDescriptorThread, thread);
+  ProtobufWriter packet;
+  packet.WriteMessage(kPacketTrackDescriptor, descriptor);
+  packet.WriteInt64(kPacketTrustedSequenceId, kSequenceId);
+  buffer_.WriteMessage(kTracePacket, packet);
+}
+
+uint64_t TimelineEventPerfettoRecorder::AsyncTrack(TimelineEvent* event) {
+  const uint64_t uuid = TrackUuid(event->AsyncId(), kAsyncTrack);
+  if (tracks_->Add(uuid)) {
+    ProtobufWriter descriptor;
+    descriptor.WriteInt64(kTrackDescriptorUuid, uuid);
+    descriptor.WriteInt64(kTrackDescriptorParentUuid, ProcessTrackUuid());
+    descriptor.WriteString(kTrackDescriptorName, event->label());
+    ProtobufWriter packet;
+    packet.WriteMessage(kPacketTrackDescriptor, descriptor);
+    packet.WriteInt64(kPacketTrustedSequenceId, kSequenceId);
+    buffer_.WriteMessage(kTracePacket, packet);
+  }
+  return uuid;
+}
+
+uint64_t TimelineEventPerfettoRecorder::CounterTrack(TimelineEvent* event,
+                                                     const char* name) {
+  const uint32_t hash = CombineHashes(
+      HashBytes(reinterpret_cast<const uint8_t*>(event->label()),
+                strlen(event->label())),
+      HashBytes(reinterpret_cast<const uint8_t*>(name), strlen(name)));
+  const uint64_t uuid = TrackUuid(hash, kCounterTrack);
+  if (tracks_->Add(uuid)) {
+    char* track_name = OS::SCreate(NULL, "%s.%s", event->label(), name);
+    ProtobufWriter counter;
+    ProtobufWriter descriptor;
+    descriptor.WriteInt64(kTrackDescriptorUuid, uuid);
+    descriptor.WriteInt64(kTrackDescriptorParentUuid, ProcessTrackUuid());
+    descriptor.WriteString(kTrackDescriptorName, track_name);
+    descriptor.WriteMessage(kTrackDescriptorCounter, counter);
+    free(track_name);
+    ProtobufWriter packet;
+    packet.WriteMessage(kPacketTrackDescriptor, descriptor);
+    packet.WriteInt64(kPacketTrustedSequenceId, kSequenceId);
+    buffer_.WriteMessage(kTracePacket, packet);
+  }
+  return uuid;
+}
+
+void TimelineEventPerfettoRecorder::WritePacket(int64_t timestamp_micros,
+                                                const ProtobufWriter& body) {
+  ProtobufWriter packet;
+  packet.WriteInt64(kPacketTimestamp,
+                    timestamp_micros * kNanosecondsPerMicrosecond);
+  packet.WriteInt64(kPacketTimestampClockId, kBuiltinClockMonotonic);
+  packet.WriteMessage(kPacketTrackEvent, body);
+  packet.WriteInt64(kPacketTrustedSequenceId, kSequenceId);
+  buffer_.WriteMessage(kTracePacket, packet);
+}
+
+void TimelineEventPerfettoRecorder::Flush() {
+  if (buffer_.length() == 0) {
+    return;
+  }
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  if ((file_open == NULL) || (file_write == NULL) ||
+      (Dart::file_close_callback() == NULL)) {
+    buffer_.Clear();
+    return;
+  }
+  if ((file_ == NULL) && (path_ != NULL)) {
+    file_ = (*file_open)(path_, true);
+    if (file_ == NULL) {
+      OS::PrintErr("Failed to write timeline file: %s\n", path_);
+      // Don't try again for every batch.
+      free(path_);
+      path_ = NULL;
+    }
+  }
+  if (file_ != NULL) {
+    (*file_write)(buffer_.data(), buffer_.length(), file_);
+  }
+  buffer_.Clear();
+}
+
+}  // namespace dart
+
+#endif  // defined(SUPPORT_TIMELINE)
@@ -9,6 +9,7 @@
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_state.h"
 #include "vm/globals.h"
+#include "vm/service_binary.h"
 #include "vm/timeline.h"
 #include "vm/timeline_analysis.h"
 #include "vm/unit_test.h"
@@ -96,6 +97,10 @@ class TimelineTestHelper : public AllStatic {
   }
 
   static void FinishBlock(TimelineEventBlock* block) { block->Finish(); }
+
+  static void WriteTo(TimelineEventRecorder* recorder, const char* directory) {
+    recorder->WriteTo(directory);
+  }
 };
 
 TEST_CASE(TimelineEventIsValid) {
@@ -158,6 +163,39 @@ TEST_CASE(TimelineEventDurationPrintJSON) {
   event.DurationEnd();
 }
 
+TEST_CASE(TimelineEventPrintBinary) {
+  // Create a test stream.
+  TimelineStream stream("testStream", "testStream", true);
+
+  // Create a test event.
+  TimelineEvent event;
+  TimelineTestHelper::SetStream(&event, &stream);
+  event.Instant("apple");
+
+  const intptr_t kReservation = 8;
+  ServiceBinaryWriter writer(kReservation);
+  event.PrintBinary(&writer, event.TimeOrigin());
+  const intptr_t first_length = writer.length();
+  event.PrintBinary(&writer, event.TimeOrigin());
+  uint8_t* buffer = writer.Steal();
+  const uint8_t* first = &buffer[kReservation];
+  // Check phase.
+  EXPECT_EQ('i', first[0]);
+  // Check that the name and category are written out the first time.
+  EXPECT_EQ(0, first[2]);
+  EXPECT_EQ(5, first[3]);
+  EXPECT(strncmp(reinterpret_cast<const char*>(&first[4]), "apple", 5) == 0);
+  EXPECT_EQ(0, first[9]);
+  EXPECT_EQ(10, first[10]);
+  // Check that they are referenced by id the second time.
+  const uint8_t* second = &buffer[first_length];
+  EXPECT_EQ('i', second[0]);
+  EXPECT_EQ(first[1], second[1]);
+  EXPECT_EQ(1, second[2]);
+  EXPECT_EQ(2, second[3]);
+  free(buffer);
+}
+
 #if defined(HOST_OS_ANDROID) || defined(HOST_OS_LINUX)
 TEST_CASE(TimelineEventPrintSystrace) {
   const intptr_t kBufferLength = 1024;
@@ -499,6 +537,79 @@ TEST_CASE(TimelineRingRecorderJSONOrder) {
   delete recorder;
 }
 
+static MallocGrowableArray<uint8_t>* perfetto_output = nullptr;
+static intptr_t perfetto_open_count = 0;
+
+static void* PerfettoFileOpen(const char* name, bool write) {
+  EXPECT(write);
+  EXPECT(strstr(name, "dart-timeline-") != nullptr);
+  perfetto_open_count++;
+  return perfetto_output;
+}
+
+static void PerfettoFileWrite(const void* data, intptr_t length, void* file) {
+  EXPECT(file == perfetto_output);
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (intptr_t i = 0; i < length; i++) {
+    perfetto_output->Add(bytes[i]);
+  }
+}
+
+static void PerfettoFileClose(void* file) {
+  EXPECT(file == perfetto_output);
+}
+
+static intptr_t CountOccurrences(const MallocGrowableArray<uint8_t>& haystack,
+                                 const char* needle) {
+  const intptr_t length = strlen(needle);
+  intptr_t count = 0;
+  for (intptr_t i = 0; i + length <= haystack.length(); i++) {
+    if (memcmp(&haystack[i], needle, length) == 0) {
+      count++;
+    }
+  }
+  return count;
+}
+
+TEST_CASE(TimelinePerfettoRecorderWritesFile) {
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileReadCallback file_read = Dart::file_read_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  MallocGrowableArray<uint8_t> output;
+  perfetto_output = &output;
+  perfetto_open_count = 0;
+  Dart::SetFileCallbacks(PerfettoFileOpen, file_read, PerfettoFileWrite,
+                         PerfettoFileClose);
+
+  // Return the blocks threads cached for the current recorder to it.
+  Timeline::ReclaimCachedBlocksFromThreads();
+  {
+    TimelineEventPerfettoRecorder* recorder =
+        new TimelineEventPerfettoRecorder("timeline-test");
+    TimelineRecorderOverride override(recorder);
+    // Each WriteTo drains while the writer thread may be draining too.
+    const intptr_t kRounds = 8;
+    for (intptr_t i = 0; i < kRounds; i++) {
+      TimelineTestHelper::FakeDuration(recorder, "PerfettoAlpha", 2 * i,
+                                       2 * i + 1);
+      TimelineTestHelper::FakeDuration(recorder, "PerfettoBeta", 2 * i + 1,
+                                       2 * i + 2);
+      TimelineTestHelper::WriteTo(recorder, "timeline-test");
+    }
+    EXPECT_EQ(1, perfetto_open_count);
+    EXPECT_EQ(kRounds, CountOccurrences(output, "PerfettoAlpha"));
+    EXPECT_EQ(kRounds, CountOccurrences(output, "PerfettoBeta"));
+    delete recorder;
+  }
+
+  // The file is a sequence of TracePacket fields (field 1, length-delimited).
+  EXPECT(output.length() > 0);
+  EXPECT_EQ(0x0a, output[0]);
+  Dart::SetFileCallbacks(file_open, file_read, file_write, file_close);
+  perfetto_output = nullptr;
+}
+
 TEST_CASE(TimelinePauses_Basic) {
   TimelineEventEndlessRecorder* recorder = new TimelineEventEndlessRecorder();
   ASSERT(recorder != NULL);
@@ -14,7 +14,9 @@ namespace dart {
 class CanonicalTypeKey {
  public:
   explicit CanonicalTypeKey(const Type& key) : key_(key) {}
-  bool Matches(const Type& arg) const { return key_.Equals(arg); }
+  bool Matches(const Type& arg) const {
+    return (key_.Hash() == arg.Hash()) && key_.Equals(arg);
+  }
   uword Hash() const { return key_.Hash(); }
   const Type& key_;
 
@@ -23,6 +25,10 @@ class CanonicalTypeKey {
 };
 
 // Traits for looking up Canonical Type based on its hash.
+//
+// The hash is cached in each type, so the traits below compare hashes before
+// falling back to the structural comparison. Probe collisions in these
+// tables thus rarely pay for a deep equality check.
 class CanonicalTypeTraits {
  public:
   static const char* Name() { return "CanonicalTypeTraits"; }
@@ -33,7 +39,7 @@ class CanonicalTypeTraits {
     ASSERT(a.IsType() && b.IsType());
     const Type& arg1 = Type::Cast(a);
     const Type& arg2 = Type::Cast(b);
-    return arg1.Equals(arg2) && (arg1.Hash() == arg2.Hash());
+    return (arg1.Hash() == arg2.Hash()) && arg1.Equals(arg2);
   }
   static bool IsMatch(const CanonicalTypeKey& a, const Object& b) {
     ASSERT(b.IsType());
@@ -53,7 +59,9 @@ typedef UnorderedHashSet<CanonicalTypeTraits> CanonicalTypeSet;
 class CanonicalTypeParameterKey {
  public:
   explicit CanonicalTypeParameterKey(const TypeParameter& key) : key_(key) {}
-  bool Matches(const TypeParameter& arg) const { return key_.Equals(arg); }
+  bool Matches(const TypeParameter& arg) const {
+    return (key_.Hash() == arg.Hash()) && key_.Equals(arg);
+  }
   uword Hash() const { return key_.Hash(); }
   const TypeParameter& key_;
 
@@ -72,7 +80,7 @@ class CanonicalTypeParameterTraits {
     ASSERT(a.IsTypeParameter() && b.IsTypeParameter());
     const TypeParameter& arg1 = TypeParameter::Cast(a);
     const TypeParameter& arg2 = TypeParameter::Cast(b);
-    return arg1.Equals(arg2) && (arg1.Hash() == arg2.Hash());
+    return (arg1.Hash() == arg2.Hash()) && arg1.Equals(arg2);
   }
   static bool IsMatch(const CanonicalTypeParameterKey& a, const Object& b) {
     ASSERT(b.IsTypeParameter());
@@ -94,7 +102,7 @@ class CanonicalTypeArgumentsKey {
  public:
   explicit CanonicalTypeArgumentsKey(const TypeArguments& key) : key_(key) {}
   bool Matches(const TypeArguments& arg) const {
-    return key_.Equals(arg) && (key_.Hash() == arg.Hash());
+    return (key_.Hash() == arg.Hash()) && key_.Equals(arg);
   }
   uword Hash() const { return key_.Hash(); }
   const TypeArguments& key_;
@@ -114,7 +122,7 @@ class CanonicalTypeArgumentsTraits {
     ASSERT(a.IsTypeArguments() && b.IsTypeArguments());
     const TypeArguments& arg1 = TypeArguments::Cast(a);
     const TypeArguments& arg2 = TypeArguments::Cast(b);
-    return arg1.Equals(arg2) && (arg1.Hash() == arg2.Hash());
+    return (arg1.Hash() == arg2.Hash()) && arg1.Equals(arg2);
   }
   static bool IsMatch(const CanonicalTypeArgumentsKey& a, const Object& b) {
     ASSERT(b.IsTypeArguments());
@@ -360,19 +360,31 @@ void TypeTestingStubGenerator::
         const Class& type_class,
         const TypeArguments& tp,
         const TypeArguments& ta) {
-  // a) First we make a quick sub*class* cid-range check.
+  // a) First we make a quick sub*class* cid-range check, or a check against
+  // the implementors which store the type arguments of [type_class] the same
+  // way if it is implemented.
   compiler::Label check_failed;
-  ASSERT(!type_class.is_implemented());
-  const CidRangeVector& ranges = hi->SubclassRangesForClass(type_class);
-  BuildOptimizedSubclassRangeCheck(assembler, ranges, &check_failed);
+  intptr_t type_arguments_field_offset;
+  if (type_class.is_implemented()) {
+    type_arguments_field_offset = BuildOptimizedImplementorRangeCheck(
+        assembler, hi, type, type_class, &check_failed);
+    if (type_arguments_field_offset ==
+        compiler::target::Class::kNoTypeArguments) {
+      __ Bind(&check_failed);
+      return;
+    }
+  } else {
+    const CidRangeVector& ranges = hi->SubclassRangesForClass(type_class);
+    BuildOptimizedSubclassRangeCheck(assembler, ranges, &check_failed);
+    type_arguments_field_offset =
+        compiler::target::Class::TypeArgumentsFieldOffset(type_class);
+  }
   // fall through to continue
 
   // b) Then we'll load the values for the type parameters.
-  __ LoadField(
-      TTSInternalRegs::kInstanceTypeArgumentsReg,
-      compiler::FieldAddress(
-          TypeTestABI::kInstanceReg,
-          compiler::target::Class::TypeArgumentsFieldOffset(type_class)));
+  __ LoadField(TTSInternalRegs::kInstanceTypeArgumentsReg,
+               compiler::FieldAddress(TypeTestABI::kInstanceReg,
+                                      type_arguments_field_offset));
 
   // The kernel frontend should fill in any non-assigned type parameters on
   // construction with dynamic/Object, so we should never get the null type
@@ -415,6 +427,196 @@ void TypeTestingStubGenerator::
   __ Bind(&check_failed);
 }
 
+// Finds the type arguments of [target] for an instance of [cls], which are
+// given by [args] in terms of the type arguments vector of the instance, or
+// are the vector itself if [args_are_identity].
+static bool FindSupertypeArguments(Zone* zone,
+                                   const Class& cls,
+                                   const Class& target,
+                                   bool args_are_identity,
+                                   const TypeArguments& args,
+                                   bool* is_identity,
+                                   TypeArguments* result) {
+  Class& this_class = Class::Handle(zone, cls.raw());
+  Array& interfaces = Array::Handle(zone);
+  AbstractType& interface = AbstractType::Handle(zone);
+  Class& interface_class = Class::Handle(zone);
+  TypeArguments& interface_args = TypeArguments::Handle(zone);
+  // Super classes share the type arguments vector of their subclasses, so
+  // only the type arguments of interfaces need to be instantiated.
+  while (!this_class.IsNull()) {
+    if (!this_class.is_type_finalized()) return false;
+    if (this_class.raw() == target.raw()) {
+      *is_identity = args_are_identity;
+      *result = args.raw();
+      return true;
+    }
+    interfaces = this_class.interfaces();
+    for (intptr_t i = 0; i < interfaces.Length(); i++) {
+      interface ^= interfaces.At(i);
+      interface_class = interface.type_class();
+      interface_args = interface.arguments();
+      if (!args_are_identity && !interface_args.IsNull() &&
+          !interface_args.IsInstantiated()) {
+        interface_args = interface_args.InstantiateFrom(
+            args, Object::null_type_arguments(), kNoneFree, Heap::kOld);
+      }
+      if (FindSupertypeArguments(zone, interface_class, target,
+                                 /*args_are_identity=*/false, interface_args,
+                                 is_identity, result)) {
+        return true;
+      }
+    }
+    this_class = this_class.SuperClass();
+  }
+  return false;
+}
+
+enum class ImplementorKind {
+  // Instances are subtypes, whatever their type arguments.
+  kSubtype,
+  // The type arguments of the implemented class are the ones of the instance
+  // at the same indices, so they can be checked like for subclasses.
+  kSameTypeArguments,
+  // Instances are checked by the slow path.
+  kOther,
+};
+
+static ImplementorKind ClassifyImplementor(Zone* zone,
+                                           const Class& cls,
+                                           const Type& type,
+                                           const Class& type_class) {
+  if (!cls.is_type_finalized()) {
+    return ImplementorKind::kOther;
+  }
+  if (cls.NumTypeArguments() == 0) {
+    if (!type.IsInstantiated()) {
+      return ImplementorKind::kOther;
+    }
+    const auto& rare_type = AbstractType::Handle(zone, cls.RareType());
+    return rare_type.IsSubtypeOf(type, Heap::kOld) ? ImplementorKind::kSubtype
+                                                   : ImplementorKind::kOther;
+  }
+
+  bool is_identity = false;
+  auto& args = TypeArguments::Handle(zone);
+  if (!FindSupertypeArguments(zone, cls, type_class,
+                              /*args_are_identity=*/true,
+                              Object::null_type_arguments(), &is_identity,
+                              &args)) {
+    return ImplementorKind::kOther;
+  }
+  if (is_identity) {
+    return ImplementorKind::kSameTypeArguments;
+  }
+
+  const intptr_t num_type_parameters = type_class.NumTypeParameters();
+  const intptr_t from_index =
+      type_class.NumTypeArguments() - num_type_parameters;
+  if (args.IsNull() || args.Length() < from_index + num_type_parameters) {
+    return ImplementorKind::kOther;
+  }
+  auto& type_arg = AbstractType::Handle(zone);
+  for (intptr_t i = from_index; i < from_index + num_type_parameters; ++i) {
+    type_arg = args.TypeAt(i);
+    if (!type_arg.IsTypeParameter()) {
+      return ImplementorKind::kOther;
+    }
+    const auto& param = TypeParameter::Cast(type_arg);
+    // Nullable type parameters would need the nullability of the instance's
+    // type argument to be adjusted.
+    if (!param.IsClassTypeParameter() || param.index() != i ||
+        param.IsNullable()) {
+      return ImplementorKind::kOther;
+    }
+  }
+  return ImplementorKind::kSameTypeArguments;
+}
+
+intptr_t TypeTestingStubGenerator::BuildOptimizedImplementorRangeCheck(
+    compiler::Assembler* assembler,
+    HierarchyInfo* hi,
+    const Type& type,
+    const Class& type_class,
+    compiler::Label* check_failed) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  ClassTable* class_table = thread->isolate()->class_table();
+  const CidRangeVector& subtype_ranges =
+      hi->SubtypeRangesForClass(type_class, /*include_abstract=*/false,
+                                /*exclude_null=*/true);
+
+  // Split the concrete subtypes into the ones which are always accepted and
+  // the ones whose type arguments are checked. Classes without instances
+  // don't break up the ranges.
+  CidRangeVector subtype_cids;
+  CidRangeVector same_type_arguments_cids;
+  intptr_t type_arguments_field_offset =
+      compiler::target::Class::kNoTypeArguments;
+  auto& cls = Class::Handle(zone);
+  for (intptr_t i = 0; i < subtype_ranges.length(); i++) {
+    const CidRangeValue& range = subtype_ranges[i];
+    if (range.IsIllegalRange()) continue;
+    ImplementorKind last_kind = ImplementorKind::kOther;
+    for (intptr_t cid = range.cid_start; cid <= range.cid_end; cid++) {
+      if (!class_table->HasValidClassAt(cid)) continue;
+      if (cid == kTypeArgumentsCid || cid == kVoidCid || cid == kDynamicCid ||
+          cid == kNeverCid) {
+        continue;
+      }
+      cls = class_table->At(cid);
+      if (cls.is_abstract() || cls.IsTopLevel()) continue;
+
+      ImplementorKind kind = ClassifyImplementor(zone, cls, type, type_class);
+      if (kind == ImplementorKind::kSameTypeArguments) {
+        const intptr_t offset =
+            compiler::target::Class::TypeArgumentsFieldOffset(cls);
+        if (type_arguments_field_offset ==
+            compiler::target::Class::kNoTypeArguments) {
+          type_arguments_field_offset = offset;
+        } else if (offset != type_arguments_field_offset) {
+          kind = ImplementorKind::kOther;
+        }
+      }
+      CidRangeVector* cids = nullptr;
+      if (kind == ImplementorKind::kSubtype) {
+        cids = &subtype_cids;
+      } else if (kind == ImplementorKind::kSameTypeArguments) {
+        cids = &same_type_arguments_cids;
+      }
+      if (cids != nullptr) {
+        if (kind == last_kind) {
+          cids->Last().cid_end = cid;
+        } else {
+          cids->Add(CidRangeValue(cid, cid));
+        }
+      }
+      last_kind = kind;
+    }
+  }
+
+  // The checks below clobber the class id register, so it is reloaded for
+  // each of them.
+  if (subtype_cids.length() > 0) {
+    compiler::Label is_subtype, not_subtype;
+    __ LoadClassIdMayBeSmi(TTSInternalRegs::kScratchReg,
+                           TypeTestABI::kInstanceReg);
+    FlowGraphCompiler::GenerateCidRangesCheck(
+        assembler, TTSInternalRegs::kScratchReg, subtype_cids, &is_subtype,
+        &not_subtype, true);
+    __ Bind(&is_subtype);
+    __ Ret();
+    __ Bind(&not_subtype);
+  }
+  if (same_type_arguments_cids.length() == 0) {
+    __ Jump(check_failed);
+    return compiler::target::Class::kNoTypeArguments;
+  }
+  BuildOptimizedSubclassRangeCheck(assembler, same_type_arguments_cids,
+                                   check_failed);
+  return type_arguments_field_offset;
+}
+
 void TypeTestingStubGenerator::BuildOptimizedSubclassRangeCheck(
     compiler::Assembler* assembler,
     const CidRangeVector& ranges,
@@ -98,6 +98,17 @@ class TypeTestingStubGenerator {
                                                const CidRangeVector& ranges,
                                                compiler::Label* check_failed);
 
+  // Returns from the stub for implementors of [type_class] which are subtypes
+  // of [type] whatever their type arguments, and falls through for the ones
+  // which store the type arguments of [type_class] in their own vector at the
+  // returned offset. Jumps to [check_failed] for all other instances.
+  static intptr_t BuildOptimizedImplementorRangeCheck(
+      compiler::Assembler* assembler,
+      HierarchyInfo* hi,
+      const Type& type,
+      const Class& type_class,
+      compiler::Label* check_failed);
+
   static void BuildOptimizedTypeArgumentValueCheck(
       compiler::Assembler* assembler,
       HierarchyInfo* hi,
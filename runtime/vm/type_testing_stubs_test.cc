@@ -563,15 +563,11 @@ ISOLATE_UNIT_TEST_CASE(TTS_GenericSubtypeRangeCheck) {
   RunTTSTest(obj_i2, type_base_b, tav_null, tav_null, ExpectLazilyFailedViaTTS,
              ExpectFailedViaTTS);
 
-  // We do not generate TTS for uninstantiated types if we would need to use
-  // subtype range checks for the class of the interface type.
-  //
-  //   obj as I<dynamic, String>       // I is generic & implemented.
-  //   obj as Base<A2<T>>              // A2<T> is not instantiated.
-  //   obj as Base<A2<A1>>             // A2<A1> is not a rare type.
+  // For implemented classes we only check the type arguments of the
+  // implementors which pass their own type arguments to the class.
   //
-
-  //   <...> as I<dynamic, String>
+  //   obj as I<dynamic, String>       // I is generic & implemented, A2 and
+  //                                   // B2 pass other type arguments to I.
   RELEASE_ASSERT(class_i.is_implemented());
   auto& type_i_dynamic_string = Type::Handle(
       Type::New(class_i, tav_dynamic_string, TokenPosition::kNoSource));
@@ -579,10 +575,19 @@ ISOLATE_UNIT_TEST_CASE(TTS_GenericSubtypeRangeCheck) {
       Nullability::kNonNullable, Heap::kNew);
   FinalizeAndCanonicalize(class_null, &type_i_dynamic_string);
   RunTTSTest(obj_i, type_i_dynamic_string, tav_null, tav_null,
+             ExpectLazilyHandledViaTTS, ExpectHandledViaTTS);
+  RunTTSTest(obj_b2, type_i_dynamic_string, tav_null, tav_null,
              ExpectLazilyHandledViaSTC, ExpectHandledViaSTC);
   RunTTSTest(obj_baseint, type_i_dynamic_string, tav_null, tav_null,
              ExpectLazilyFailedViaSTC, ExpectFailedViaSTC);
 
+  // We do not generate TTS for uninstantiated types if we would need to use
+  // subtype range checks for the class of the interface type.
+  //
+  //   obj as Base<A2<T>>              // A2<T> is not instantiated.
+  //   obj as Base<A2<A1>>             // A2<A1> is not a rare type.
+  //
+
   //   <...> as Base<A2<T>>
   const auto& tav_t = TypeArguments::Handle(TypeArguments::New(1));
   tav_t.SetTypeAt(
@@ -623,6 +628,69 @@ ISOLATE_UNIT_TEST_CASE(TTS_GenericSubtypeRangeCheck) {
              ExpectLazilyFailedViaSTC, ExpectFailedViaSTC);
 }
 
+ISOLATE_UNIT_TEST_CASE(TTS_ImplementedGenericSubtypeRangeCheck) {
+  const char* kScript =
+      R"(
+          class I<T> {}
+          class J<T> implements I<T> {}
+          class K<T> implements I<List<T>> {}
+          class L implements I<int> {}
+          class M<T> implements I<int> {}
+
+          createIInt() => I<int>();
+          createJInt() => J<int>();
+          createJString() => J<String>();
+          createKInt() => K<int>();
+          createL() => L();
+          createMString() => M<String>();
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  const auto& class_i = Class::Handle(GetClass(root_library, "I"));
+  const auto& class_null = Class::Handle(Class::null());
+
+  const auto& obj_iint = Object::Handle(Invoke(root_library, "createIInt"));
+  const auto& obj_jint = Object::Handle(Invoke(root_library, "createJInt"));
+  const auto& obj_jstring =
+      Object::Handle(Invoke(root_library, "createJString"));
+  const auto& obj_kint = Object::Handle(Invoke(root_library, "createKInt"));
+  const auto& obj_l = Object::Handle(Invoke(root_library, "createL"));
+  const auto& obj_mstring =
+      Object::Handle(Invoke(root_library, "createMString"));
+
+  auto& type_int = Type::Handle(Type::IntType());
+  if (!TestCase::IsNNBD()) {
+    type_int = type_int.ToNullability(Nullability::kLegacy, Heap::kNew);
+  }
+  auto& tav_int = TypeArguments::Handle(TypeArguments::New(1));
+  tav_int.SetTypeAt(0, type_int);
+  CanonicalizeTAV(&tav_int);
+  const auto& tav_null = TypeArguments::Handle(TypeArguments::null());
+
+  // <...> as I<int>
+  RELEASE_ASSERT(class_i.is_implemented());
+  auto& type_i_int =
+      Type::Handle(Type::New(class_i, tav_int, TokenPosition::kNoSource));
+  type_i_int = type_i_int.ToNullability(Nullability::kNonNullable, Heap::kNew);
+  FinalizeAndCanonicalize(class_null, &type_i_int);
+
+  // I and J store the type argument of I in the same way.
+  RunTTSTest(obj_iint, type_i_int, tav_null, tav_null,
+             ExpectLazilyHandledViaTTS, ExpectHandledViaTTS);
+  RunTTSTest(obj_jint, type_i_int, tav_null, tav_null,
+             ExpectLazilyHandledViaTTS, ExpectHandledViaTTS);
+  RunTTSTest(obj_jstring, type_i_int, tav_null, tav_null,
+             ExpectLazilyFailedViaTTS, ExpectFailedViaTTS);
+  // L is not generic, so it is always a subtype.
+  RunTTSTest(obj_l, type_i_int, tav_null, tav_null, ExpectLazilyHandledViaTTS,
+             ExpectHandledViaTTS);
+  // K and M pass other type arguments to I and are left to the slow path.
+  RunTTSTest(obj_kint, type_i_int, tav_null, tav_null,
+             ExpectLazilyFailedViaSTC, ExpectFailedViaSTC);
+  RunTTSTest(obj_mstring, type_i_int, tav_null, tav_null,
+             ExpectLazilyHandledViaSTC, ExpectHandledViaSTC);
+}
+
 ISOLATE_UNIT_TEST_CASE(TTS_Regress40964) {
   const char* kScript =
       R"(
@@ -18,6 +18,22 @@ static const uintptr_t kAsciiWordMask = DART_UINT64_C(0x8080808080808080);
 static const uintptr_t kAsciiWordMask = 0x80808080u;
 #endif
 
+// The same for a word of UTF-16 code units.
+#if defined(ARCH_IS_64_BIT)
+static const uintptr_t kAsciiTwoByteWordMask =
+    DART_UINT64_C(0xFF80FF80FF80FF80);
+#else
+static const uintptr_t kAsciiTwoByteWordMask = 0xFF80FF80u;
+#endif
+static const intptr_t kTwoByteCharsPerWord =
+    sizeof(uintptr_t) / sizeof(uint16_t);
+
+// Returns true if the |kTwoByteCharsPerWord| code units at |data| are ASCII.
+static bool IsAsciiTwoByteWord(const uint16_t* data) {
+  return (LoadUnaligned(reinterpret_cast<const uintptr_t*>(data)) &
+          kAsciiTwoByteWordMask) == 0;
+}
+
 intptr_t Utf8::Length(const String& str) {
   if (str.IsOneByteString() || str.IsExternalOneByteString()) {
     // For 1-byte strings, all code points < 0x80 have single-byte UTF-8
@@ -56,13 +72,25 @@ intptr_t Utf8::Length(const String& str) {
     return length;
   }
 
-  // Slow case for 2-byte strings that handles surrogate pairs and longer UTF-8
-  // encodings.
+  // For 2-byte strings, skip runs of ASCII a word at a time and handle
+  // surrogate pairs and longer UTF-8 encodings one code point at a time.
+  // Unpaired surrogates are encoded as replacement characters of the same
+  // length.
+  const intptr_t char_length = str.Length();
   intptr_t length = 0;
-  String::CodePointIterator it(str);
-  while (it.Next()) {
-    int32_t ch = it.Current();
-    length += Utf8::Length(ch);
+  NoSafepointScope no_safepoint;
+  const uint16_t* data = str.IsTwoByteString()
+                             ? TwoByteString::DataStart(str)
+                             : ExternalTwoByteString::DataStart(str);
+  intptr_t i = 0;
+  while (i < char_length) {
+    if (((i + kTwoByteCharsPerWord) <= char_length) &&
+        IsAsciiTwoByteWord(&data[i])) {
+      length += kTwoByteCharsPerWord;
+      i += kTwoByteCharsPerWord;
+      continue;
+    }
+    length += Utf8::Length(Utf16::Next(data, &i, char_length));
   }
   return length;
 }
@@ -115,10 +143,26 @@ intptr_t Utf8::Encode(const String& src, char* dst, intptr_t len) {
     }
   } else {
     // For two-byte strings, which can contain 3 and 4-byte UTF-8 encodings,
-    // which can result in surrogate pairs, use the more general code.
-    String::CodePointIterator it(src);
-    while (it.Next()) {
-      int32_t ch = it.Current();
+    // which can result in surrogate pairs, narrow runs of ASCII a word at a
+    // time and use the more general code for everything else.
+    const intptr_t char_length = src.Length();
+    NoSafepointScope no_safepoint;
+    const uint16_t* data = src.IsTwoByteString()
+                               ? TwoByteString::DataStart(src)
+                               : ExternalTwoByteString::DataStart(src);
+    intptr_t i = 0;
+    while (i < char_length) {
+      if (((i + kTwoByteCharsPerWord) <= char_length) &&
+          ((pos + kTwoByteCharsPerWord) <= len) &&
+          IsAsciiTwoByteWord(&data[i])) {
+        for (intptr_t j = 0; j < kTwoByteCharsPerWord; j++) {
+          dst[pos + j] = static_cast<char>(data[i + j]);
+        }
+        pos += kTwoByteCharsPerWord;
+        i += kTwoByteCharsPerWord;
+        continue;
+      }
+      int32_t ch = Utf16::Next(data, &i, char_length);
       ASSERT(!Utf::IsOutOfRange(ch));
       if (Utf16::IsSurrogate(ch)) {
         // Encode unpaired surrogates as replacement characters to ensure the
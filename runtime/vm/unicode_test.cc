@@ -27,6 +27,28 @@ ISOLATE_UNIT_TEST_CASE(Utf8Encode) {
   }
 }
 
+// Two-byte strings with ASCII runs, which are narrowed a word at a time, in
+// front of multi-byte sequences, surrogate pairs and unpaired surrogates.
+ISOLATE_UNIT_TEST_CASE(Utf8EncodeTwoByte) {
+  const uint16_t kInput[] = {'a',    'b',    'c',    'd',    'e',
+                             0x2603, 'f',    0xD83D, 0xDE00, 'g',
+                             0xD800, 'h',    'i',    'j',    'k',
+                             'l',    'm',    'n',    0xDC00};
+  const String& input =
+      String::Handle(String::FromUTF16(kInput, ARRAY_SIZE(kInput)));
+  EXPECT(input.IsTwoByteString());
+  const char kExpected[] =
+      "abcde\xE2\x98\x83" "f\xF0\x9F\x98\x80" "g\xEF\xBF\xBD" "hijklmn"
+      "\xEF\xBF\xBD";
+  const intptr_t expected_length = strlen(kExpected);
+  EXPECT_EQ(expected_length, Utf8::Length(input));
+  char buffer[64];
+  memset(buffer, 42, sizeof(buffer));
+  EXPECT_EQ(expected_length, Utf8::Encode(input, buffer, sizeof(buffer)));
+  EXPECT(memcmp(kExpected, buffer, expected_length) == 0);
+  EXPECT_EQ(42, buffer[expected_length]);
+}
+
 ISOLATE_UNIT_TEST_CASE(Utf8InvalidByte) {
   {
     uint8_t array[] = {0x41, 0xF0, 0x92};
@@ -1090,4 +1112,40 @@ ISOLATE_UNIT_TEST_CASE(Utf8Decode) {
   }
 }
 
+// The ASCII runs are long enough to be checked a word at a time and are
+// followed by multi-byte sequences at every offset within a word.
+ISOLATE_UNIT_TEST_CASE(Utf8DecodeAsciiRuns) {
+  for (intptr_t prefix = 0; prefix < 20; prefix++) {
+    uint8_t src[32];
+    memset(src, 'a', prefix);
+    src[prefix] = 0xC3;  // U+00F1
+    src[prefix + 1] = 0xB1;
+    src[prefix + 2] = 'b';
+    const intptr_t src_len = prefix + 3;
+
+    EXPECT(Utf8::IsValid(src, src_len));
+    Utf8::Type type;
+    EXPECT_EQ(prefix + 2, Utf8::CodeUnitCount(src, src_len, &type));
+    EXPECT_EQ(Utf8::kLatin1, type);
+
+    uint8_t latin1[32];
+    EXPECT(Utf8::DecodeToLatin1(src, src_len, latin1, prefix + 2));
+    uint16_t utf16[32];
+    EXPECT(Utf8::DecodeToUTF16(src, src_len, utf16, prefix + 2));
+    for (intptr_t i = 0; i < prefix; i++) {
+      EXPECT_EQ('a', latin1[i]);
+      EXPECT_EQ('a', utf16[i]);
+    }
+    EXPECT_EQ(0xF1, latin1[prefix]);
+    EXPECT_EQ(0xF1, utf16[prefix]);
+    EXPECT_EQ('b', latin1[prefix + 1]);
+    EXPECT_EQ('b', utf16[prefix + 1]);
+    // The output is one code unit too short.
+    EXPECT(!Utf8::DecodeToLatin1(src, src_len, latin1, prefix + 1));
+
+    // A truncated sequence after the ASCII run.
+    EXPECT(!Utf8::IsValid(src, prefix + 1));
+  }
+}
+
 }  // namespace dart
@@ -0,0 +1,49 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_USDT_H_
+#define RUNTIME_VM_USDT_H_
+
+#include "platform/globals.h"
+
+// Statically defined tracepoints (USDT probes) for external tracers such as
+// bpftrace, perf and SystemTap, e.g.
+//
+//   bpftrace -e 'usdt:./dart:dartvm:gc__end { @[arg0] = hist(arg1); }'
+//
+// Probes are only emitted on Linux when the VM is built with
+// 'dart_use_usdt = true'. Each probe site then compiles to a single nop plus
+// an ELF note describing its location and arguments, so arguments should be
+// values that are already at hand. In all other builds the macros expand to
+// nothing.
+//
+// Probes of the 'dartvm' provider:
+//
+//   gc__start(type, reason)            Heap::RecordBeforeGC
+//   gc__end(type, micros)              Heap::RecordAfterGC
+//   concurrent__mark__start()          Heap::StartConcurrentMarking
+//   compile__start(osr_id, background) Compiler::CompileOptimizedFunction
+//   compile__end(osr_id, background)   Compiler::CompileOptimizedFunction
+//   deopt(is_lazy)                     DeoptimizeCopyFrame
+//   message__start(port, priority)     MessageHandler::HandleMessages
+//   message__end(port, status)         MessageHandler::HandleMessages
+//   safepoint__begin()                 SafepointHandler::SafepointThreads
+//   safepoint__end()                   SafepointHandler::ResumeThreads
+#if defined(DART_USE_USDT) && defined(HOST_OS_LINUX)
+
+#include <sys/sdt.h>
+
+#define DART_USDT0(name) DTRACE_PROBE(dartvm, name)
+#define DART_USDT1(name, a) DTRACE_PROBE1(dartvm, name, a)
+#define DART_USDT2(name, a, b) DTRACE_PROBE2(dartvm, name, a, b)
+
+#else
+
+#define DART_USDT0(name)
+#define DART_USDT1(name, a)
+#define DART_USDT2(name, a, b)
+
+#endif  // defined(DART_USE_USDT) && defined(HOST_OS_LINUX)
+
+#endif  // RUNTIME_VM_USDT_H_
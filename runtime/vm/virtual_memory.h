@@ -65,6 +65,12 @@ class VirtualMemory {
 
   static bool InSamePage(uword address0, uword address1);
 
+  // Moves the part of the executable memory [address, address + size) which
+  // covers whole huge pages onto anonymous memory backed by transparent huge
+  // pages, if enabled with --transparent_huge_pages. Is only done once for
+  // each address, which must not run concurrently.
+  static void RemapToHugePages(void* address, intptr_t size);
+
   // Truncate this virtual memory segment.
   void Truncate(intptr_t new_size);
 
@@ -174,6 +174,8 @@ VirtualMemory::~VirtualMemory() {
   }
 }
 
+void VirtualMemory::RemapToHugePages(void* address, intptr_t size) {}
+
 void VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   const uword start = reinterpret_cast<uword>(address);
   Unmap(zx_vmar_root_self(), start, start + size);
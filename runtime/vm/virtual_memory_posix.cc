@@ -17,6 +17,7 @@
 #include "platform/assert.h"
 #include "platform/utils.h"
 #include "vm/isolate.h"
+#include "vm/os_thread.h"
 
 // #define VIRTUAL_MEMORY_LOGGING 1
 #if defined(VIRTUAL_MEMORY_LOGGING)
@@ -35,6 +36,12 @@ namespace dart {
 DECLARE_FLAG(bool, dual_map_code);
 DECLARE_FLAG(bool, write_protect_code);
 
+DEFINE_FLAG(bool,
+            transparent_huge_pages,
+            false,
+            "Back the Dart heap and the instructions of snapshots by "
+            "transparent huge pages where the OS supports them.");
+
 #if defined(TARGET_OS_LINUX)
 DECLARE_FLAG(bool, generate_perf_events_symbols);
 DECLARE_FLAG(bool, generate_perf_jitdump);
@@ -42,6 +49,31 @@ DECLARE_FLAG(bool, generate_perf_jitdump);
 
 uword VirtualMemory::page_size_ = 0;
 
+#if defined(MADV_HUGEPAGE)
+static constexpr intptr_t kHugePageSize = 2 * MB;
+
+// Heap pages are smaller than a huge page. With --transparent_huge_pages,
+// those of the same size are carved out of huge page aligned chunks, so the
+// kernel can back a chunk by a single huge page.
+struct HugePageChunk {
+  uword start;
+  intptr_t slot_size;
+  uint32_t used_slots;
+  HugePageChunk* next;
+};
+
+static Mutex* huge_pages_mutex = nullptr;
+static HugePageChunk* huge_page_chunks = nullptr;
+static MallocGrowableArray<uword>* huge_page_images = nullptr;
+
+static bool UseHugePageChunk(intptr_t size,
+                             intptr_t alignment,
+                             bool is_executable) {
+  return FLAG_transparent_huge_pages && !is_executable && (size == alignment) &&
+         (size >= kHugePageSize / kBitsPerInt32) && (size < kHugePageSize);
+}
+#endif  // defined(MADV_HUGEPAGE)
+
 intptr_t VirtualMemory::CalculatePageSize() {
   const intptr_t page_size = getpagesize();
   ASSERT(page_size != 0);
@@ -57,6 +89,11 @@ void VirtualMemory::Init() {
 
   page_size_ = CalculatePageSize();
 
+#if defined(MADV_HUGEPAGE)
+  huge_pages_mutex = new Mutex();
+  huge_page_images = new MallocGrowableArray<uword>();
+#endif  // defined(MADV_HUGEPAGE)
+
 #if defined(DUAL_MAPPING_SUPPORTED)
 // Perf is Linux-specific and the flags aren't defined in Product.
 #if defined(TARGET_OS_LINUX) && !defined(PRODUCT)
@@ -165,6 +202,133 @@ static void* MapAligned(int fd,
 }
 #endif  // defined(DUAL_MAPPING_SUPPORTED)
 
+#if defined(MADV_HUGEPAGE)
+static void* AllocateHugePageSlot(intptr_t size) {
+  MutexLocker ml(huge_pages_mutex);
+  const intptr_t slots = kHugePageSize / size;
+  const uint32_t all_slots =
+      (slots == kBitsPerInt32) ? ~0u : ((1u << slots) - 1);
+  for (HugePageChunk* chunk = huge_page_chunks; chunk != nullptr;
+       chunk = chunk->next) {
+    if ((chunk->slot_size == size) && (chunk->used_slots != all_slots)) {
+      const intptr_t slot = Utils::CountTrailingZeros32(~chunk->used_slots);
+      chunk->used_slots |= 1u << slot;
+      return reinterpret_cast<void*>(chunk->start + slot * size);
+    }
+  }
+
+  const intptr_t allocated_size = 2 * kHugePageSize;
+  void* address = mmap(NULL, allocated_size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (address == MAP_FAILED) {
+    return nullptr;
+  }
+  const uword base = reinterpret_cast<uword>(address);
+  const uword aligned_base = Utils::RoundUp(base, kHugePageSize);
+  unmap(base, aligned_base);
+  unmap(aligned_base + kHugePageSize, base + allocated_size);
+  // Only a hint, the kernel may not be configured to use huge pages.
+  madvise(reinterpret_cast<void*>(aligned_base), kHugePageSize,
+          MADV_HUGEPAGE);
+
+  HugePageChunk* chunk = new HugePageChunk();
+  chunk->start = aligned_base;
+  chunk->slot_size = size;
+  chunk->used_slots = 1;
+  chunk->next = huge_page_chunks;
+  huge_page_chunks = chunk;
+  return reinterpret_cast<void*>(aligned_base);
+}
+
+// Returns false if [start] was not allocated by AllocateHugePageSlot.
+static bool FreeHugePageSlot(uword start) {
+  MutexLocker ml(huge_pages_mutex);
+  HugePageChunk* previous = nullptr;
+  for (HugePageChunk* chunk = huge_page_chunks; chunk != nullptr;
+       previous = chunk, chunk = chunk->next) {
+    if ((start < chunk->start) || (start >= chunk->start + kHugePageSize)) {
+      continue;
+    }
+    const intptr_t slot = (start - chunk->start) / chunk->slot_size;
+    ASSERT((chunk->used_slots & (1u << slot)) != 0);
+    chunk->used_slots &= ~(1u << slot);
+    if (chunk->used_slots != 0) {
+      // Like unmapped memory, the slot reads as zeros when it is reused.
+      madvise(reinterpret_cast<void*>(start), chunk->slot_size,
+              MADV_DONTNEED);
+      return true;
+    }
+    unmap(chunk->start, chunk->start + kHugePageSize);
+    if (previous == nullptr) {
+      huge_page_chunks = chunk->next;
+    } else {
+      previous->next = chunk->next;
+    }
+    delete chunk;
+    return true;
+  }
+  return false;
+}
+
+static bool InHugePageChunk(uword address) {
+  MutexLocker ml(huge_pages_mutex);
+  for (HugePageChunk* chunk = huge_page_chunks; chunk != nullptr;
+       chunk = chunk->next) {
+    if ((address >= chunk->start) &&
+        (address < chunk->start + kHugePageSize)) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif  // defined(MADV_HUGEPAGE)
+
+void VirtualMemory::RemapToHugePages(void* address, intptr_t size) {
+#if defined(MADV_HUGEPAGE)
+  if (!FLAG_transparent_huge_pages) {
+    return;
+  }
+  // Only the part of the image which covers whole huge pages can be moved.
+  const uword start =
+      Utils::RoundUp(reinterpret_cast<uword>(address), kHugePageSize);
+  const uword end =
+      Utils::RoundDown(reinterpret_cast<uword>(address) + size, kHugePageSize);
+  if (start >= end) {
+    return;
+  }
+  MutexLocker ml(huge_pages_mutex);
+  for (intptr_t i = 0; i < huge_page_images->length(); i++) {
+    if (huge_page_images->At(i) == start) {
+      return;  // Already remapped, and possibly running.
+    }
+  }
+  huge_page_images->Add(start);
+
+  // The image is mapped from a file. Its contents are copied aside, and back
+  // into anonymous memory mapped in its place.
+  const intptr_t length = end - start;
+  void* copy = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (copy == MAP_FAILED) {
+    return;
+  }
+  void* image = reinterpret_cast<void*>(start);
+  memmove(copy, image, length);
+  void* result = mmap(image, length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+  if (result != image) {
+    FATAL1("Failed to remap instructions to huge pages: %d", errno);
+  }
+  madvise(image, length, MADV_HUGEPAGE);
+  memmove(image, copy, length);
+  unmap(reinterpret_cast<uword>(copy), reinterpret_cast<uword>(copy) + length);
+  if (mprotect(image, length, PROT_READ | PROT_EXEC) != 0) {
+    FATAL1("Failed to protect instructions remapped to huge pages: %d", errno);
+  }
+  LOG_INFO("remapped 0x%" Px "-0x%" Px " to huge pages\n", start, end);
+#endif  // defined(MADV_HUGEPAGE)
+}
+
 VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
                                               intptr_t alignment,
                                               bool is_executable,
@@ -179,6 +343,21 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   ASSERT(Utils::IsPowerOfTwo(alignment));
   ASSERT(Utils::IsAligned(alignment, PageSize()));
   ASSERT(name != nullptr);
+#if defined(MADV_HUGEPAGE)
+  if (UseHugePageChunk(size, alignment, is_executable)) {
+    void* address = AllocateHugePageSlot(size);
+    if (address == nullptr) {
+      return NULL;
+    }
+    MemoryRegion region(address, size);
+    return new VirtualMemory(region, region);
+  }
+  const bool huge_pages = FLAG_transparent_huge_pages && !is_executable &&
+                          (size >= kHugePageSize);
+  if (huge_pages) {
+    alignment = Utils::Maximum(alignment, kHugePageSize);
+  }
+#endif  // defined(MADV_HUGEPAGE)
   const intptr_t allocated_size = size + alignment - PageSize();
 #if defined(DUAL_MAPPING_SUPPORTED)
   const bool dual_mapping =
@@ -227,7 +406,9 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   // Try to use memfd for single-mapped regions too, so they will have an
   // associated name for memory attribution. Skip if FLAG_dual_map_code is
   // false, which happens if we detected memfd wasn't working in Init above.
-  if (FLAG_dual_map_code) {
+  // Memfd memory is shared, transparent huge pages only apply to private
+  // memory.
+  if (FLAG_dual_map_code && !(FLAG_transparent_huge_pages && !is_executable)) {
     int fd = memfd_create(name, MFD_CLOEXEC);
     if (fd == -1) {
       return NULL;
@@ -264,12 +445,23 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
 
   unmap(base, aligned_base);
   unmap(aligned_base + size, base + allocated_size);
+#if defined(MADV_HUGEPAGE)
+  if (huge_pages) {
+    madvise(reinterpret_cast<void*>(aligned_base), size, MADV_HUGEPAGE);
+  }
+#endif  // defined(MADV_HUGEPAGE)
 
   MemoryRegion region(reinterpret_cast<void*>(aligned_base), size);
   return new VirtualMemory(region, region);
 }
 
 VirtualMemory::~VirtualMemory() {
+#if defined(MADV_HUGEPAGE)
+  if (vm_owns_region() && FLAG_transparent_huge_pages &&
+      FreeHugePageSlot(reserved_.start())) {
+    return;
+  }
+#endif  // defined(MADV_HUGEPAGE)
   if (vm_owns_region()) {
     unmap(reserved_.start(), reserved_.end());
     const intptr_t alias_offset = AliasOffset();
@@ -282,6 +474,14 @@ VirtualMemory::~VirtualMemory() {
 void VirtualMemory::FreeSubSegment(void* address,
                                    intptr_t size) {
   const uword start = reinterpret_cast<uword>(address);
+#if defined(MADV_HUGEPAGE)
+  // A truncated huge page slot keeps its mapping: unmapping its tail would
+  // leave a hole in the chunk for the next owner of the slot.
+  if (InHugePageChunk(start)) {
+    madvise(address, size, MADV_DONTNEED);
+    return;
+  }
+#endif  // defined(MADV_HUGEPAGE)
   unmap(start, start + size);
 }
 
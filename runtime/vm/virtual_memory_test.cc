@@ -9,6 +9,10 @@
 
 namespace dart {
 
+#if defined(HOST_OS_LINUX)
+DECLARE_FLAG(bool, transparent_huge_pages);
+#endif
+
 bool IsZero(char* begin, char* end) {
   for (char* current = begin; current < end; ++current) {
     if (*current != 0) {
@@ -88,4 +92,66 @@ VM_UNIT_TEST_CASE(FreeVirtualMemory) {
   }
 }
 
+#if defined(HOST_OS_LINUX)
+VM_UNIT_TEST_CASE(AllocateVirtualMemoryOnHugePages) {
+  SetFlagScope<bool> sfs(&FLAG_transparent_huge_pages, true);
+  const intptr_t kHeapPageSize = kOldPageSize;
+  VirtualMemory* first = VirtualMemory::AllocateAligned(
+      kHeapPageSize, kHeapPageSize, false, "test");
+  VirtualMemory* second = VirtualMemory::AllocateAligned(
+      kHeapPageSize, kHeapPageSize, false, "test");
+  EXPECT(Utils::IsAligned(first->start(), kHeapPageSize));
+  EXPECT(Utils::IsAligned(second->start(), kHeapPageSize));
+  EXPECT(first->start() != second->start());
+
+  // A freed page reads as zeros when it is handed out again.
+  char* buf = reinterpret_cast<char*>(first->address());
+  buf[0] = 'a';
+  buf[kHeapPageSize - 1] = 'b';
+  const uword start = first->start();
+  delete first;
+  first = VirtualMemory::AllocateAligned(kHeapPageSize, kHeapPageSize, false,
+                                         "test");
+  EXPECT_EQ(start, first->start());
+  buf = reinterpret_cast<char*>(first->address());
+  EXPECT(IsZero(buf, buf + first->size()));
+  delete first;
+  delete second;
+
+  const intptr_t kLargeSize = 3 * MB;
+  VirtualMemory* large =
+      VirtualMemory::AllocateAligned(kLargeSize, kHeapPageSize, false, "test");
+  EXPECT(Utils::IsAligned(large->start(), 2 * MB));
+  EXPECT_EQ(kLargeSize, large->size());
+  delete large;
+}
+
+VM_UNIT_TEST_CASE(TruncateVirtualMemoryOnHugePages) {
+  SetFlagScope<bool> sfs(&FLAG_transparent_huge_pages, true);
+  // A large page of exactly this size also gets a slot, and is truncated
+  // after its objects are allocated.
+  const intptr_t kHeapPageSize = kOldPageSize;
+  VirtualMemory* first = VirtualMemory::AllocateAligned(
+      kHeapPageSize, kHeapPageSize, false, "test");
+  VirtualMemory* second = VirtualMemory::AllocateAligned(
+      kHeapPageSize, kHeapPageSize, false, "test");
+  const uword start = first->start();
+  char* buf = reinterpret_cast<char*>(first->address());
+  buf[kHeapPageSize - 1] = 'a';
+  first->Truncate(kHeapPageSize / 2);
+  EXPECT_EQ(kHeapPageSize / 2, first->size());
+  delete first;
+
+  // The whole slot is still mapped, and reads as zeros, when it is reused.
+  first = VirtualMemory::AllocateAligned(kHeapPageSize, kHeapPageSize, false,
+                                         "test");
+  EXPECT_EQ(start, first->start());
+  buf = reinterpret_cast<char*>(first->address());
+  EXPECT(IsZero(buf, buf + first->size()));
+  buf[kHeapPageSize - 1] = 'b';
+  delete first;
+  delete second;
+}
+#endif  // defined(HOST_OS_LINUX)
+
 }  // namespace dart
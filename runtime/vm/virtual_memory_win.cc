@@ -80,6 +80,8 @@ VirtualMemory::~VirtualMemory() {
   }
 }
 
+void VirtualMemory::RemapToHugePages(void* address, intptr_t size) {}
+
 void VirtualMemory::FreeSubSegment(void* address,
                                    intptr_t size) {
   if (VirtualFree(address, size, MEM_DECOMMIT) == 0) {
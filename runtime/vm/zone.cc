@@ -12,6 +12,7 @@
 #include "vm/handles_impl.h"
 #include "vm/heap/heap.h"
 #include "vm/os.h"
+#include "vm/thread.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -33,6 +34,7 @@ class Zone::Segment {
   // Allocate or delete individual segments.
   static Segment* New(intptr_t size, Segment* next);
   static void DeleteSegmentList(Segment* segment);
+  static void CacheSegment(VirtualMemory* memory);
   static void IncrementMemoryCapacity(uintptr_t size);
   static void DecrementMemoryCapacity(uintptr_t size);
 
@@ -51,7 +53,9 @@ class Zone::Segment {
 // tcmalloc and jemalloc have both been observed to hold onto lots of free'd
 // zone segments (jemalloc to the point of causing OOM), so instead of using
 // malloc to allocate segments, we allocate directly from mmap/zx_vmo_create/
-// VirtualAlloc, and cache a small number of the normal sized segments.
+// VirtualAlloc, and cache a small number of the normal sized segments. Each
+// VM thread additionally keeps a few segments in its ZoneSegmentCache, which
+// is consulted first.
 static constexpr intptr_t kSegmentCacheCapacity = 16;  // 1 MB of Segments
 static Mutex* segment_cache_mutex = nullptr;
 static VirtualMemory* segment_cache[kSegmentCacheCapacity] = {nullptr};
@@ -75,10 +79,40 @@ void Zone::Cleanup() {
   segment_cache_mutex = nullptr;
 }
 
+void ZoneSegmentCache::Flush() {
+  while (size_ > 0) {
+    Zone::Segment::CacheSegment(segments_[--size_]);
+    segments_[size_] = nullptr;
+  }
+}
+
+void Zone::Segment::CacheSegment(VirtualMemory* memory) {
+  ASSERT(memory->size() == kSegmentSize);
+  if (segment_cache_mutex != nullptr) {
+    MutexLocker ml(segment_cache_mutex);
+    ASSERT(segment_cache_size >= 0);
+    ASSERT(segment_cache_size <= kSegmentCacheCapacity);
+    if (segment_cache_size < kSegmentCacheCapacity) {
+      segment_cache[segment_cache_size++] = memory;
+      return;
+    }
+  }
+  total_size_.fetch_sub(kSegmentSize);
+  delete memory;
+}
+
 Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
   size = Utils::RoundUp(size, VirtualMemory::PageSize());
   VirtualMemory* memory = nullptr;
-  if (size == kSegmentSize) {
+  Thread* thread = Thread::Current();
+  if ((size == kSegmentSize) && (thread != nullptr)) {
+    ZoneSegmentCache* cache = thread->zone_segment_cache();
+    if (cache->size_ > 0) {
+      memory = cache->segments_[--cache->size_];
+      cache->segments_[cache->size_] = nullptr;
+    }
+  }
+  if ((size == kSegmentSize) && (memory == nullptr)) {
     MutexLocker ml(segment_cache_mutex);
     ASSERT(segment_cache_size >= 0);
     ASSERT(segment_cache_size <= kSegmentCacheCapacity);
@@ -110,6 +144,9 @@ Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
 }
 
 void Zone::Segment::DeleteSegmentList(Segment* head) {
+  Thread* thread = Thread::Current();
+  ZoneSegmentCache* cache =
+      (thread != nullptr) ? thread->zone_segment_cache() : nullptr;
   Segment* current = head;
   while (current != NULL) {
     intptr_t size = current->size();
@@ -123,15 +160,13 @@ void Zone::Segment::DeleteSegmentList(Segment* head) {
     LSAN_UNREGISTER_ROOT_REGION(current, sizeof(*current));
 
     if (size == kSegmentSize) {
-      MutexLocker ml(segment_cache_mutex);
-      ASSERT(segment_cache_size >= 0);
-      ASSERT(segment_cache_size <= kSegmentCacheCapacity);
-      if (segment_cache_size < kSegmentCacheCapacity) {
-        segment_cache[segment_cache_size++] = memory;
-        memory = nullptr;
+      if ((cache != nullptr) &&
+          (cache->size_ < ZoneSegmentCache::kCapacity)) {
+        cache->segments_[cache->size_++] = memory;
+      } else {
+        CacheSegment(memory);
       }
-    }
-    if (memory != nullptr) {
+    } else {
       total_size_.fetch_sub(size);
       delete memory;
     }
@@ -13,6 +13,8 @@
 
 namespace dart {
 
+class VirtualMemory;
+
 // Zones support very fast allocation of small chunks of memory. The
 // chunks cannot be deallocated individually, but instead zones
 // support deallocating all chunks in one fast operation.
@@ -177,6 +179,7 @@ class Zone {
 
   friend class StackZone;
   friend class ApiZone;
+  friend class ZoneSegmentCache;
   template <typename T, typename B, typename Allocator>
   friend class BaseGrowableArray;
   template <typename T, typename B, typename Allocator>
@@ -212,6 +215,27 @@ class StackZone : public StackResource {
   DISALLOW_IMPLICIT_CONSTRUCTORS(StackZone);
 };
 
+// A few normal sized zone segments kept by a single thread. Zones that are
+// repeatedly created and deleted on the same thread (e.g. one per
+// compilation) reuse these without taking the global segment cache lock.
+class ZoneSegmentCache {
+ public:
+  ZoneSegmentCache() {}
+  ~ZoneSegmentCache() { Flush(); }
+
+  // Returns all cached segments to the global segment cache.
+  void Flush();
+
+ private:
+  static constexpr intptr_t kCapacity = 4;
+
+  VirtualMemory* segments_[kCapacity] = {nullptr};
+  intptr_t size_ = 0;
+
+  friend class Zone;
+  DISALLOW_COPY_AND_ASSIGN(ZoneSegmentCache);
+};
+
 inline uword Zone::AllocUnsafe(intptr_t size) {
   ASSERT(size >= 0);
   // Round up the requested size to fit the alignment.
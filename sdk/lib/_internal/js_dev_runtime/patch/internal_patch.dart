@@ -53,6 +53,12 @@ List<T> makeFixedListUnmodifiable<T>(List<T> fixedLengthList) {
   return fixedLengthList;
 }
 
+@patch
+void reserveListCapacity(List growableList, int capacity) {}
+
+@patch
+void shrinkListToFit(List growableList) {}
+
 @patch
 Object? extractTypeArguments<T>(T instance, Function extract) =>
     dart.extractTypeArguments<T>(instance, extract);
@@ -10,6 +10,7 @@ import 'dart:_interceptors' show JSArray, JSExtendableArray;
 import 'dart:_internal' show MappedIterable, ListIterable;
 import 'dart:collection' show LinkedHashMap, MapBase;
 import 'dart:_native_typed_data' show NativeUint8List;
+import 'dart:typed_data' show Uint8List;
 
 /// Parses [json] and builds the corresponding parsed JSON value.
 ///
@@ -383,6 +384,22 @@ class _JsonDecoderSink extends _StringSinkConversionSink<StringBuffer> {
   }
 }
 
+@patch
+class JsonUtf8Encoder {
+  @patch
+  static List<int>? _convertIntercepted(Object? object) {
+    return null; // This call was not intercepted.
+  }
+}
+
+@patch
+class Utf8Encoder {
+  @patch
+  static Uint8List? _convertIntercepted(String string) {
+    return null; // This call was not intercepted.
+  }
+}
+
 @patch
 class Utf8Decoder {
   // Always fall back to the Dart implementation for strings shorter than this
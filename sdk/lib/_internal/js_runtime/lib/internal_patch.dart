@@ -55,6 +55,12 @@ List<T> makeFixedListUnmodifiable<T>(List<T> fixedLengthList) {
   return JSArray.markUnmodifiableList(fixedLengthList);
 }
 
+@patch
+void reserveListCapacity(List growableList, int capacity) {}
+
+@patch
+void shrinkListToFit(List growableList) {}
+
 @patch
 @pragma('dart2js:noInline')
 Object? extractTypeArguments<T>(T instance, Function extract) {
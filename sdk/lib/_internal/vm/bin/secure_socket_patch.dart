@@ -85,6 +85,7 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
 
   void connect(
       String hostName,
+      int port,
       SecurityContext context,
       bool isServer,
       bool requestClientCertificate,
@@ -126,6 +127,12 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
   List<_ExternalBuffer>? buffers;
 }
 
+// Process-wide counts of client handshakes that resumed a cached session and
+// of those that went through a full handshake. Used by tests.
+int _resumedHandshakes() native "SecureSocket_ResumedHandshakes";
+
+int _fullHandshakes() native "SecureSocket_FullHandshakes";
+
 @patch
 class SecurityContext {
   @patch
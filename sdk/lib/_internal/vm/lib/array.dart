@@ -62,6 +62,22 @@ class _List<E> extends FixedLengthListBase<E> {
   _List _sliceInternal(int start, int count, bool needsTypeArgument)
       native "List_slice";
 
+  // Copies 'count' elements between [_List]s, [_ImmutableList]s and
+  // [_GrowableList]s, which may be the same list, without an element by element
+  // write barrier.
+  static void _copyRange(
+          Object dst, int dstStart, Object src, int srcStart, int count)
+      native "List_copyRange";
+
+  // Whether [_copyRange] can copy from [iterable] and pays off for 'count'.
+  static bool _canCopyRange(Iterable iterable, int count) {
+    if (count <= 64) return false;
+    final cid = ClassID.getID(iterable);
+    return (cid == ClassID.cidArray) ||
+        (cid == ClassID.cidImmutableArray) ||
+        (cid == ClassID.cidGrowableObjectArray);
+  }
+
   // List interface.
   void setRange(int start, int end, Iterable<E> iterable, [int skipCount = 0]) {
     if (start < 0 || start > this.length) {
@@ -72,6 +88,12 @@ class _List<E> extends FixedLengthListBase<E> {
     }
     int length = end - start;
     if (length == 0) return;
+    if (_canCopyRange(iterable, length) &&
+        skipCount >= 0 &&
+        skipCount + length <= iterable.length) {
+      _copyRange(this, start, iterable, skipCount, length);
+      return;
+    }
     if (identical(this, iterable)) {
       Lists.copy(this, skipCount, this, start, length);
     } else if (ClassID.getID(iterable) == ClassID.cidArray) {
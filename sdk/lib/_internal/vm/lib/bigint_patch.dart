@@ -173,6 +173,11 @@ class _BigIntImpl implements BigInt {
     return result;
   }
 
+  /// Literals with more decimal digits than this are parsed by combining
+  /// halves, so that the multiplications are large enough for
+  /// [_absKaratsubaMul].
+  static const int _parseDivideAndConquerLength = 1000;
+
   /// Parses a decimal bigint literal.
   ///
   /// The [source] must not contain leading or trailing whitespace.
@@ -181,6 +186,9 @@ class _BigIntImpl implements BigInt {
 
     int part = 0;
     _BigIntImpl result = zero;
+    final bool divideAndConquer =
+        source.length > _parseDivideAndConquerLength;
+    final parts = <_BigIntImpl>[];
     // Read in the source 9 digits at a time.
     // The first part may have a few leading virtual '0's to make the remaining
     // parts all have exactly 9 digits.
@@ -189,11 +197,33 @@ class _BigIntImpl implements BigInt {
     for (int i = 0; i < source.length; i++) {
       part = part * 10 + source.codeUnitAt(i) - _0;
       if (++digitInPartCount == 9) {
-        result = result * _oneBillion + new _BigIntImpl._fromInt(part);
+        if (divideAndConquer) {
+          parts.add(new _BigIntImpl._fromInt(part));
+        } else {
+          result = result * _oneBillion + new _BigIntImpl._fromInt(part);
+        }
         part = 0;
         digitInPartCount = 0;
       }
     }
+    if (divideAndConquer) {
+      // Combine pairs of adjacent parts until one is left. Every part but the
+      // first, most significant one has as many decimal digits as [power] has
+      // zeros.
+      var level = parts;
+      var power = _oneBillion;
+      while (level.length > 1) {
+        final combined = <_BigIntImpl>[];
+        final first = level.length & 1;
+        if (first == 1) combined.add(level[0]);
+        for (int i = first; i < level.length; i += 2) {
+          combined.add(level[i] * power + level[i + 1]);
+        }
+        level = combined;
+        if (level.length > 1) power = power * power;
+      }
+      result = level[0];
+    }
     if (isNegative) return -result;
     return result;
   }
@@ -1209,6 +1239,42 @@ class _BigIntImpl implements BigInt {
     return _isIntrinsified ? 2 : 1;
   }
 
+  /// Operands with at least this many digits are multiplied with Karatsuba's
+  /// method. Below, the schoolbook method on top of [_mulAdd] is faster.
+  static const int _karatsubaThreshold = 80;
+
+  /// Returns the non-negative number formed by the digits of `abs(this)` in
+  /// the range [from] to [to]-1.
+  _BigIntImpl _absDigitRange(int from, int to) {
+    to = _min(to, _used);
+    if (from >= to) return zero;
+    var resultDigits = _cloneDigits(_digits, from, to, to - from);
+    return new _BigIntImpl._(false, to - from, resultDigits);
+  }
+
+  /// Returns `abs(this) * abs(other)`, splitting both at [k] digits.
+  ///
+  /// With x = x1*B^k + x0 and y = y1*B^k + y0, x*y is computed from the three
+  /// products x0*y0, x1*y1 and (x0+x1)*(y0+y1), which are multiplied in the
+  /// same way if they are large enough.
+  _BigIntImpl _absKaratsubaMul(_BigIntImpl other) {
+    assert(_used >= other._used);
+    final k = (_used + 1) >> 1;
+    final x0 = _absDigitRange(0, k);
+    final x1 = _absDigitRange(k, _used);
+    final y = other._isNegative ? -other : other;
+    if (other._used <= k) {
+      // Unbalanced operands, only this is split.
+      return x0 * y + (x1 * y)._dlShift(k);
+    }
+    final y0 = other._absDigitRange(0, k);
+    final y1 = other._absDigitRange(k, other._used);
+    final z0 = x0 * y0;
+    final z2 = x1 * y1;
+    final z1 = (x0 + x1) * (y0 + y1) - z0 - z2;
+    return z0 + z1._dlShift(k) + z2._dlShift(2 * k);
+  }
+
   /// Multiplication operator.
   _BigIntImpl operator *(BigInt bigInt) {
     final other = _ensureSystemBigInt(bigInt, 'bigInt');
@@ -1217,6 +1283,12 @@ class _BigIntImpl implements BigInt {
     if (used == 0 || otherUsed == 0) {
       return zero;
     }
+    if (used >= _karatsubaThreshold && otherUsed >= _karatsubaThreshold) {
+      final product = used >= otherUsed
+          ? _absKaratsubaMul(other)
+          : other._absKaratsubaMul(this);
+      return _isNegative != other._isNegative ? -product : product;
+    }
     var resultUsed = used + otherUsed;
     var digits = _digits;
     var otherDigits = other._digits;
@@ -137,7 +137,12 @@ abstract class _HashBase implements _HashVMBase {
 
 class _OperatorEqualsAndHashCode {
   int _hashCode(e) => e.hashCode;
-  bool _equals(e1, e2) => e1 == e2;
+  // Most lookups which find their key find the very same String or int, for
+  // which operator == is known to agree with identical, so those hits don't
+  // need the call. Other identical keys still go through operator ==, which
+  // e.g. isn't reflexive for NaN.
+  bool _equals(e1, e2) =>
+      (identical(e1, e2) && (e1 is String || e1 is int)) || e1 == e2;
 }
 
 class _IdenticalAndIdentityHashCode {
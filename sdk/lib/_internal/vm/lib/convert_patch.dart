@@ -28,6 +28,10 @@ import "dart:typed_data" show Uint8List, Uint16List;
 @patch
 dynamic _parseJson(
     String source, Object? Function(Object? key, Object? value)? reviver) {
+  if (reviver == null && ClassID.getID(source) == ClassID.cidOneByteString) {
+    final result = _parseJsonNative(source);
+    if (!identical(result, source)) return result;
+  }
   _BuildJsonListener listener;
   if (reviver == null) {
     listener = new _BuildJsonListener();
@@ -42,6 +46,29 @@ dynamic _parseJson(
   return listener.result;
 }
 
+// Parses [source], a one-byte string or a Uint8List of UTF-8, in the VM into
+// the same objects as [_BuildJsonListener]. Returns [source] itself for
+// anything left to the Dart parser, including all invalid input.
+Object? _parseJsonNative(Object source) native "Json_parse";
+
+@patch
+class JsonUtf8Encoder {
+  // Encodes [object] in the VM if it consists of null, bools, numbers,
+  // strings, lists and maps with string keys only.
+  @patch
+  static List<int>? _convertIntercepted(Object? object)
+      native "Json_encodeUtf8";
+}
+
+@patch
+class Utf8Encoder {
+  // Encodes all of [string] in the VM, which replaces unpaired surrogates
+  // like [_Utf8Encoder] does.
+  @patch
+  static Uint8List? _convertIntercepted(String string)
+      native "Utf8Encoder_convert";
+}
+
 @patch
 class Utf8Decoder {
   @patch
@@ -70,6 +97,10 @@ class _JsonUtf8Decoder extends Converter<List<int>, Object> {
   _JsonUtf8Decoder(this._reviver, this._allowMalformed);
 
   Object convert(List<int> input) {
+    if (_reviver == null && input is Uint8List) {
+      final dynamic result = _parseJsonNative(input);
+      if (!identical(result, input)) return result;
+    }
     var parser = _JsonUtf8DecoderSink._createParser(_reviver, _allowMalformed);
     parser.chunk = input;
     parser.chunkEnd = input.length;
@@ -1568,6 +1599,11 @@ class _JsonUtf8Parser extends _ChunkedJsonParser<List<int>> {
   }
 
   double parseDouble(int start, int end) {
+    final chunk = this.chunk;
+    if (chunk is Uint8List) {
+      final result = _parseDoubleBytes(chunk, start, end);
+      if (result != null) return result;
+    }
     String string = getString(start, end, 0x7f);
     return _parseDouble(string, 0, string.length);
   }
@@ -1575,6 +1611,9 @@ class _JsonUtf8Parser extends _ChunkedJsonParser<List<int>> {
 
 double _parseDouble(String source, int start, int end) native "Double_parse";
 
+double? _parseDoubleBytes(Uint8List source, int start, int end)
+    native "Double_parseBytes";
+
 /**
  * Implements the chunked conversion from a UTF-8 encoding of JSON
  * to its corresponding object.
@@ -48,9 +48,39 @@ Pointer<T> _fromAddress<T extends NativeType>(int ptr) native "Ffi_fromAddress";
 DS _asFunctionInternal<DS extends Function, NS extends Function>(
     Pointer<NativeFunction<NS>> ptr) native "Ffi_asFunctionInternal";
 
+// Like _asFunctionInternal, for `asFunction(isLeaf: true)`.
+DS _asLeafFunctionInternal<DS extends Function, NS extends Function>(
+    Pointer<NativeFunction<NS>> ptr) native "Ffi_asLeafFunctionInternal";
+
+// Like _asFunctionInternal, for `lookupFunction(isLazy: true)`. The returned
+// function looks up [symbolName] in [library] on its first call. For
+// functions annotated with `@FfiNative`, [library] is the URI of the library
+// declaring them and its resolver looks up [symbolName].
+DS _asLazyFunctionInternal<DS extends Function, NS extends Function>(
+        Object library, String symbolName)
+    native "Ffi_asLazyFunctionInternal";
+
+// Like _asLazyFunctionInternal, for `lookupFunction(isLeaf: true,
+// isLazy: true)`.
+DS _asLazyLeafFunctionInternal<DS extends Function, NS extends Function>(
+        Object library, String symbolName)
+    native "Ffi_asLazyLeafFunctionInternal";
+
+// Called by the trampoline of a lazily bound function before its first call.
+@pragma("vm:entry-point")
+void _resolveLazyFunction(Function function) native "Ffi_resolveLazyFunction";
+
 dynamic _asExternalTypedData(Pointer ptr, int count)
     native "Ffi_asExternalTypedData";
 
+// Called by leaf call trampolines for TypedData arguments which are not VM
+// typed data, such as user implementations of TypedData or unmodifiable views.
+@pragma("vm:entry-point")
+void _throwUnsupportedTypedData(Object data) {
+  throw ArgumentError.value(
+      data, null, "Only typed data created by dart:typed_data can be passed");
+}
+
 // Returns a Function object for a native callback.
 //
 // Calls to [Pointer.fromFunction] are re-written by the FE into calls to this
@@ -227,7 +257,7 @@ Pointer<Pointer<S>> _elementAtPointer<S extends NativeType>(
 extension NativeFunctionPointer<NF extends Function>
     on Pointer<NativeFunction<NF>> {
   @patch
-  DF asFunction<DF extends Function>() =>
+  DF asFunction<DF extends Function>({bool isLeaf: false}) =>
       throw UnsupportedError("The body is inlined in the frontend.");
 }
 
@@ -454,6 +484,141 @@ extension NativePort on SendPort {
   int get nativePort native "SendPortImpl_get_id";
 }
 
+int _asyncCallbackCreate<NS extends Function>(SendPort port)
+    native "Ffi_asyncCallbackCreate";
+
+// The port tells the callback [id] apart from earlier ones with the same id.
+int _asyncCallbackAddress(int id, SendPort port)
+    native "Ffi_asyncCallbackAddress";
+
+List? _asyncCallbackDequeue<NS extends Function>(int id, SendPort port)
+    native "Ffi_asyncCallbackDequeue";
+
+void _asyncCallbackDelete(int id, SendPort port)
+    native "Ffi_asyncCallbackDelete";
+
+@patch
+abstract class Arena {
+  @patch
+  factory Arena() => _Arena();
+
+  @patch
+  static R using<R>(R Function(Arena arena) computation) {
+    final arena = _Arena();
+    try {
+      return computation(arena);
+    } finally {
+      arena.releaseAll();
+    }
+  }
+}
+
+// Allocates like Zone in the VM: small allocations bump a position in the
+// current segment, larger ones get a segment of their own. Segments are
+// malloc'ed and link to the previous segment in their first word, so releasing
+// an arena takes one native call per list.
+class _Arena implements Arena {
+  static const int _segmentSize = 64 * 1024;
+  static const int _segmentHeaderSize = 16;
+  static const int _maxAlignment = 16;
+
+  // The newest segment of each list, or 0.
+  int _segments = 0;
+  int _largeSegments = 0;
+
+  // The free part of the newest segment in _segments.
+  int _position = 0;
+  int _limit = 0;
+
+  Pointer<T> allocate<T extends NativeType>(int byteCount, {int alignment: 8}) {
+    if (byteCount < 0) {
+      throw ArgumentError.value(byteCount, "byteCount", "must not be negative");
+    }
+    if (alignment <= 0 ||
+        alignment > _maxAlignment ||
+        (alignment & (alignment - 1)) != 0) {
+      throw ArgumentError.value(
+          alignment, "alignment", "must be a power of two up to 16");
+    }
+    int address = (_position + alignment - 1) & -alignment;
+    if (address + byteCount >= _limit) {
+      if (byteCount > _segmentSize - _segmentHeaderSize - _maxAlignment) {
+        _largeSegments = _arenaNewSegment(
+            _largeSegments, _segmentHeaderSize + byteCount);
+        return Pointer.fromAddress(_largeSegments + _segmentHeaderSize);
+      }
+      _segments = _arenaNewSegment(_segments, _segmentSize);
+      _position = _segments + _segmentHeaderSize;
+      _limit = _segments + _segmentSize;
+      address = (_position + alignment - 1) & -alignment;
+    }
+    _position = address + byteCount;
+    return Pointer.fromAddress(address);
+  }
+
+  void releaseAll() {
+    _arenaDeleteSegments(_segments);
+    _arenaDeleteSegments(_largeSegments);
+    _segments = 0;
+    _largeSegments = 0;
+    _position = 0;
+    _limit = 0;
+  }
+}
+
+// Returns the address of a new segment of [size] bytes linked to [previous].
+int _arenaNewSegment(int previous, int size) native "Ffi_arenaNewSegment";
+
+// Frees [segment] and all segments it links to.
+void _arenaDeleteSegments(int segment) native "Ffi_arenaDeleteSegments";
+
+@patch
+abstract class AsyncCallback<T extends Function> {
+  @patch
+  factory AsyncCallback(Function callback) => _AsyncCallback<T>(callback);
+}
+
+class _AsyncCallback<T extends Function> implements AsyncCallback<T> {
+  final Function _callback;
+  final RawReceivePort _port = RawReceivePort();
+  late final int _id;
+  late final Pointer<NativeFunction<T>> pointer;
+  bool _closed = false;
+
+  _AsyncCallback(this._callback) {
+    try {
+      _id = _asyncCallbackCreate<T>(_port.sendPort);
+    } catch (_) {
+      _port.close();
+      rethrow;
+    }
+    pointer = Pointer.fromAddress(_asyncCallbackAddress(_id, _port.sendPort));
+    _port.handler = _handleWakeup;
+  }
+
+  void _handleWakeup(Object? _) {
+    try {
+      final port = _port.sendPort;
+      List? arguments;
+      while (!_closed &&
+          (arguments = _asyncCallbackDequeue<T>(_id, port)) != null) {
+        Function.apply(_callback, arguments);
+      }
+    } catch (_) {
+      // Handle the remaining calls in a later turn of the event loop.
+      if (!_closed) _port.sendPort.send(null);
+      rethrow;
+    }
+  }
+
+  void close() {
+    if (_closed) return;
+    _closed = true;
+    _asyncCallbackDelete(_id, _port.sendPort);
+    _port.close();
+  }
+}
+
 int _nativeApiFunctionPointer(String symbol)
     native "DartNativeApiFunctionPointer";
 
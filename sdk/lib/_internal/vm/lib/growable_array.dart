@@ -15,7 +15,7 @@ class _GrowableList<T> extends ListBase<T> {
     if (index == oldLength) {
       return;
     }
-    Lists.copy(this, index, this, index + 1, oldLength - index);
+    _copyWithin(index, index + 1, oldLength - index);
     this[index] = element;
   }
 
@@ -23,7 +23,7 @@ class _GrowableList<T> extends ListBase<T> {
     var result = this[index];
     int newLength = this.length - 1;
     if (index < newLength) {
-      Lists.copy(this, index + 1, this, index, newLength - index);
+      _copyWithin(index + 1, index, newLength - index);
     }
     this.length = newLength;
     return result;
@@ -76,10 +76,31 @@ class _GrowableList<T> extends ListBase<T> {
 
   void removeRange(int start, int end) {
     RangeError.checkValidRange(start, end, this.length);
-    Lists.copy(this, end, this, start, this.length - end);
+    _copyWithin(end, start, this.length - end);
     this.length = this.length - (end - start);
   }
 
+  void setRange(int start, int end, Iterable<T> iterable, [int skipCount = 0]) {
+    RangeError.checkValidRange(start, end, this.length);
+    final length = end - start;
+    if (_List._canCopyRange(iterable, length) &&
+        skipCount >= 0 &&
+        skipCount + length <= iterable.length) {
+      _List._copyRange(this, start, iterable, skipCount, length);
+      return;
+    }
+    super.setRange(start, end, iterable, skipCount);
+  }
+
+  // Like Lists.copy within this list.
+  void _copyWithin(int srcStart, int dstStart, int count) {
+    if (count > 64) {
+      _List._copyRange(this, dstStart, this, srcStart, count);
+    } else {
+      Lists.copy(this, srcStart, this, dstStart, count);
+    }
+  }
+
   List<T> sublist(int start, [int? end]) {
     final int actualEnd = RangeError.checkValidRange(start, end, this.length);
     int length = actualEnd - start;
@@ -277,8 +298,19 @@ class _GrowableList<T> extends ListBase<T> {
   // Grow from 0 to 3, and then double + 1.
   int _nextCapacity(int old_capacity) => (old_capacity * 2) | 3;
 
+  // Extends the backing array without copying if it was the last allocation.
+  bool _tryGrowInPlace(int new_capacity)
+      native "GrowableList_tryGrowInPlace";
+
   void _grow(int new_capacity) {
+    // Capacities are odd, see _allocateData.
+    if (_capacity > 0 && _tryGrowInPlace(new_capacity | 1)) return;
     var newData = _allocateData(new_capacity);
+    if (length > 64) {
+      _List._copyRange(newData, 0, this, 0, length);
+      _setData(newData);
+      return;
+    }
     // This is a work-around for dartbug.com/30090: array-bound-check
     // generalization causes excessive deoptimizations because it
     // hoists CheckArrayBound(i, ...) out of the loop below and turns it
@@ -295,6 +327,11 @@ class _GrowableList<T> extends ListBase<T> {
 
   void _shrink(int new_capacity, int new_length) {
     var newData = _allocateData(new_capacity);
+    if (new_length > 64) {
+      _List._copyRange(newData, 0, this, 0, new_length);
+      _setData(newData);
+      return;
+    }
     // This is a work-around for dartbug.com/30090. See the comment in _grow.
     if (new_length > 0) {
       for (int i = 0; i < new_length; i++) {
@@ -31,6 +31,13 @@ List<T> makeListFixedLength<T>(List<T> growableList)
 List<T> makeFixedListUnmodifiable<T>(List<T> fixedLengthList)
     native "Internal_makeFixedListUnmodifiable";
 
+@patch
+void reserveListCapacity(List growableList, int capacity)
+    native "Internal_reserveListCapacity";
+
+@patch
+void shrinkListToFit(List growableList) native "Internal_shrinkListToFit";
+
 @patch
 Object? extractTypeArguments<T>(T instance, Function extract)
     native "Internal_extractTypeArguments";
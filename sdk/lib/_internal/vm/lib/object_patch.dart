@@ -26,11 +26,13 @@ class Object {
     var result = _getHash(obj);
     if (result == 0) {
       // We want the hash to be a Smi value greater than 0.
-      result = _hashCodeRnd.nextInt(0x40000000);
       do {
         result = _hashCodeRnd.nextInt(0x40000000);
       } while (result == 0);
       _setHash(obj, result);
+      // Another isolate of the group may have hashed the object meanwhile,
+      // its hash wins then.
+      result = _getHash(obj);
     }
     return result;
   }
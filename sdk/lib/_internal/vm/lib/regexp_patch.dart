@@ -350,6 +350,24 @@ class _RegExp implements RegExp {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
   ];
 
+  /// The index to look for the match after one from [start] to [end] at.
+  ///
+  /// Zero-width matches advance by one more, unless the regexp is in unicode
+  /// mode and that would put us within a surrogate pair. In that case, they
+  /// advance past the code point as a whole.
+  int _nextSearchIndex(String string, int start, int end) {
+    if (end != start) return end;
+    if (isUnicode &&
+        end + 1 < string.length &&
+        _AllMatchesIterator._isLeadSurrogate(string.codeUnitAt(end)) &&
+        _AllMatchesIterator._isTrailSurrogate(string.codeUnitAt(end + 1))) {
+      end++;
+    }
+    return end + 1;
+  }
+
+  // Returns the start and end of the match and its groups, used directly by
+  // String.replaceAll and String.split to avoid creating match objects.
   List<int>? _ExecuteMatch(String str, int start_index)
       native "RegExp_ExecuteMatch";
 
@@ -394,19 +412,7 @@ class _AllMatchesIterator implements Iterator<RegExpMatch> {
       if (match != null) {
         var current = new _RegExpMatch._(re, _str, match);
         _current = current;
-        _nextIndex = current.end;
-        if (_nextIndex == current.start) {
-          // Zero-width match. Advance by one more, unless the regexp
-          // is in unicode mode and it would put us within a surrogate
-          // pair. In that case, advance past the code point as a whole.
-          if (re.isUnicode &&
-              _nextIndex + 1 < _str.length &&
-              _isLeadSurrogate(_str.codeUnitAt(_nextIndex)) &&
-              _isTrailSurrogate(_str.codeUnitAt(_nextIndex + 1))) {
-            _nextIndex++;
-          }
-          _nextIndex++;
-        }
+        _nextIndex = re._nextSearchIndex(_str, current.start, current.end);
         return true;
       }
     }
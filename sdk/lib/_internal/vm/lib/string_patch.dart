@@ -642,7 +642,23 @@ abstract class _StringBase implements String {
     int length = 0; // Length of all fragments.
     int replacementLength = replacement.length;
 
-    if (replacementLength == 0) {
+    if (pattern is _RegExp) {
+      // Only the bounds of the matches are needed.
+      int searchIndex = 0;
+      while (searchIndex <= this.length) {
+        final match = pattern._ExecuteMatch(this, searchIndex);
+        if (match == null) break;
+        final int matchStart = match[0];
+        final int matchEnd = match[1];
+        length += _addReplaceSlice(matches, startIndex, matchStart);
+        if (replacementLength != 0) {
+          matches.add(replacement);
+          length += replacementLength;
+        }
+        startIndex = matchEnd;
+        searchIndex = pattern._nextSearchIndex(this, matchStart, matchEnd);
+      }
+    } else if (replacementLength == 0) {
       for (Match match in pattern.allMatches(this)) {
         length += _addReplaceSlice(matches, startIndex, match.start);
         startIndex = match.end;
@@ -895,6 +911,9 @@ abstract class _StringBase implements String {
           new List<String>.generate(this.length, (int i) => this[i]);
       return result;
     }
+    if (pattern is _RegExp) {
+      return _splitWithRegExp(pattern);
+    }
     int length = this.length;
     Iterator iterator = pattern.allMatches(this).iterator;
     if (length == 0 && iterator.moveNext()) {
@@ -927,6 +946,44 @@ abstract class _StringBase implements String {
     return result;
   }
 
+  // As [split], but reading the bounds of the matches without creating match
+  // objects.
+  List<String> _splitWithRegExp(_RegExp pattern) {
+    int length = this.length;
+    if (length == 0) {
+      // A matched empty string input returns the empty list.
+      return (pattern._ExecuteMatch(this, 0) != null) ? <String>[] : [""];
+    }
+    List<String> result = <String>[];
+    int startIndex = 0;
+    int previousIndex = 0;
+    int searchIndex = 0;
+    while (true) {
+      List<int>? match;
+      if (startIndex != length && searchIndex <= length) {
+        match = pattern._ExecuteMatch(this, searchIndex);
+      }
+      if (match == null) {
+        result.add(this._substringUnchecked(previousIndex, length));
+        break;
+      }
+      final int matchStart = match[0];
+      final int matchEnd = match[1];
+      searchIndex = pattern._nextSearchIndex(this, matchStart, matchEnd);
+      if (matchStart == length) {
+        result.add(this._substringUnchecked(previousIndex, length));
+        break;
+      }
+      if (startIndex == matchEnd && matchEnd == previousIndex) {
+        ++startIndex; // empty match, advance and restart
+        continue;
+      }
+      result.add(this._substringUnchecked(previousIndex, matchStart));
+      startIndex = previousIndex = matchEnd;
+    }
+    return result;
+  }
+
   List<int> get codeUnits => new CodeUnits(this);
 
   Runes get runes => new Runes(this);
@@ -109,6 +109,16 @@ abstract class _TypedListBase {
   // Element size of toCid and fromCid must match (test at caller).
   bool _setRange(int startInBytes, int lengthInBytes, _TypedListBase from,
       int startFromInBytes, int toCid, int fromCid) native "TypedData_setRange";
+
+  // Copies the element at 'startInBytes' over the rest of the range.
+  void _fillRange(int startInBytes, int lengthInBytes, int elementSizeInBytes)
+      native "TypedData_fillRange";
+
+  // Returns the index, relative to 'startInBytes', of the first (or last) of
+  // the 'length' elements there which equals the integer 'element', or -1.
+  // 'cid' is the one of the list, which may be a view.
+  int _indexOf(int startInBytes, int length, Object? element, int cid,
+      bool isLast) native "TypedData_indexOf";
 }
 
 mixin _IntListMixin implements List<int> {
@@ -325,6 +335,16 @@ mixin _IntListMixin implements List<int> {
     } else if (start < 0) {
       start = 0;
     }
+    final count = this.length - start;
+    if (count >= 10) {
+      final index = this.buffer._data._indexOf(
+          start * elementSizeInBytes + this.offsetInBytes,
+          count,
+          element,
+          ClassID.getID(this),
+          false);
+      return index < 0 ? -1 : start + index;
+    }
     for (int i = start; i < this.length; i++) {
       if (this[i] == element) return i;
     }
@@ -334,6 +354,10 @@ mixin _IntListMixin implements List<int> {
   int lastIndexOf(int element, [int? start]) {
     int startIndex =
         (start == null || start >= this.length) ? this.length - 1 : start;
+    if (startIndex >= 10) {
+      return this.buffer._data._indexOf(this.offsetInBytes, startIndex + 1,
+          element, ClassID.getID(this), true);
+    }
     for (int i = startIndex; i >= 0; i--) {
       if (this[i] == element) return i;
     }
@@ -383,6 +407,15 @@ mixin _IntListMixin implements List<int> {
     if (fillValue == null) {
       throw ArgumentError.notNull("fillValue");
     }
+    if (end - start >= 10) {
+      // Store the first element to convert the value, then copy its bytes.
+      this[start] = fillValue;
+      this.buffer._data._fillRange(
+          start * elementSizeInBytes + this.offsetInBytes,
+          (end - start) * elementSizeInBytes,
+          elementSizeInBytes);
+      return;
+    }
     for (var i = start; i < end; ++i) {
       this[i] = fillValue;
     }
@@ -742,6 +775,15 @@ mixin _DoubleListMixin implements List<double> {
     if (fillValue == null) {
       throw ArgumentError.notNull("fillValue");
     }
+    if (end - start >= 10) {
+      // Store the first element to convert the value, then copy its bytes.
+      this[start] = fillValue;
+      this.buffer._data._fillRange(
+          start * elementSizeInBytes + this.offsetInBytes,
+          (end - start) * elementSizeInBytes,
+          elementSizeInBytes);
+      return;
+    }
     for (var i = start; i < end; ++i) {
       this[i] = fillValue;
     }
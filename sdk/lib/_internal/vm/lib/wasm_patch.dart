@@ -32,6 +32,11 @@ class WasmModule {
   factory WasmModule(Uint8List data) {
     return _NativeWasmModule(data);
   }
+
+  @patch
+  factory WasmModule.deserialize(Uint8List serialized) {
+    return _NativeWasmModule.deserialize(serialized);
+  }
 }
 
 @patch
@@ -55,12 +60,18 @@ class _NativeWasmModule extends NativeFieldWrapperClass1 implements WasmModule {
     _init(data);
   }
 
+  _NativeWasmModule.deserialize(Uint8List serialized) {
+    _deserialize(serialized);
+  }
+
   WasmInstance instantiate(covariant _NativeWasmImports imports) {
     return _NativeWasmInstance(this, imports);
   }
 
   void _init(Uint8List data) native 'Wasm_initModule';
+  void _deserialize(Uint8List serialized) native 'Wasm_deserializeModule';
   String describe() native 'Wasm_describeModule';
+  Uint8List serialize() native 'Wasm_serializeModule';
 }
 
 class _NativeWasmImports extends NativeFieldWrapperClass1
@@ -120,6 +131,7 @@ class _NativeWasmMemory extends NativeFieldWrapperClass1 implements WasmMemory {
 
   int get lengthInPages => _pages;
   int get lengthInBytes => _buffer.lengthInBytes;
+  Uint8List get view => _buffer;
   int operator [](int index) => _buffer[index];
   void operator []=(int index, int value) {
     _buffer[index] = value;
@@ -171,6 +183,19 @@ class _NativeWasmFunction<T extends Function> extends NativeFieldWrapperClass1
   }
 
   num call(List<num> args) {
+    // Short argument lists are passed directly, without copying them.
+    switch (args.length) {
+      case 0:
+        return _call0();
+      case 1:
+        return _call1(args[0]);
+      case 2:
+        return _call2(args[0], args[1]);
+      case 3:
+        return _call3(args[0], args[1], args[2]);
+      case 4:
+        return _call4(args[0], args[1], args[2], args[3]);
+    }
     var arg_copy = List<num>.from(args, growable: false);
     return _call(arg_copy);
   }
@@ -178,4 +203,9 @@ class _NativeWasmFunction<T extends Function> extends NativeFieldWrapperClass1
   void _init(_NativeWasmInstance inst, String name, Type fnType)
       native 'Wasm_initFunction';
   num _call(List<num> args) native 'Wasm_callFunction';
+  num _call0() native 'Wasm_callFunction0';
+  num _call1(num a) native 'Wasm_callFunction1';
+  num _call2(num a, num b) native 'Wasm_callFunction2';
+  num _call3(num a, num b, num c) native 'Wasm_callFunction3';
+  num _call4(num a, num b, num c, num d) native 'Wasm_callFunction4';
 }
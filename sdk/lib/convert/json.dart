@@ -358,6 +358,12 @@ class JsonUtf8Encoder extends Converter<Object?, List<int>> {
 
   /// Convert [object] into UTF-8 encoded JSON.
   List<int> convert(Object? object) {
+    // Allow the implementation to intercept and specialize the conversion.
+    if (_indent == null) {
+      var result = _convertIntercepted(object);
+      if (result != null) return result;
+    }
+
     var bytes = <List<int>>[];
     // The `stringify` function always converts into chunks.
     // Collect the chunks into the `bytes` list, then combine them afterwards.
@@ -407,6 +413,8 @@ class JsonUtf8Encoder extends Converter<Object?, List<int>> {
   Stream<List<int>> bind(Stream<Object?> stream) {
     return super.bind(stream);
   }
+
+  external static List<int>? _convertIntercepted(Object? object);
 }
 
 /// Implements the chunked conversion from object to its JSON representation.
@@ -93,6 +93,11 @@ class Utf8Encoder extends Converter<String, List<int>> {
     }
     var length = end - start;
     if (length == 0) return Uint8List(0);
+    // Allow the implementation to intercept and specialize the conversion.
+    if (length == stringLength) {
+      var result = _convertIntercepted(string);
+      if (result != null) return result;
+    }
     // Create a new encoder with a length that is guaranteed to be big enough.
     // A single code unit uses at most 3 bytes, a surrogate pair at most 4.
     var encoder = _Utf8Encoder.withBufferSize(length * 3);
@@ -121,6 +126,8 @@ class Utf8Encoder extends Converter<String, List<int>> {
 
   // Override the base-classes bind, to provide a better type.
   Stream<List<int>> bind(Stream<String> stream) => super.bind(stream);
+
+  external static Uint8List? _convertIntercepted(String string);
 }
 
 /// This class encodes Strings to UTF-8 code units (unsigned 8 bit integers).
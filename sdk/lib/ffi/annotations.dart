@@ -34,3 +34,25 @@ class Unsized {
 /// Unsized NativeTypes do not support [sizeOf] because their size is unknown.
 /// Consequently, [Pointer.elementAt] is not available.
 const unsized = const Unsized();
+
+/// Binds an external static function to a native function of the embedder.
+///
+/// The embedder resolves [nativeName] on the first call of the function with
+/// the resolver set by `Dart_SetFfiNativeResolver` for the library which
+/// declares it. Arguments and results are passed like for
+/// [NativeFunctionPointer.asFunction] with signature [T], so integers and
+/// doubles arrive unboxed and no handles or API scope are involved. With
+/// [isLeaf], [TypedData] arguments are passed as pointers to their elements,
+/// see [NativeFunctionPointer.asFunction].
+///
+/// Example:
+///
+/// ```dart
+/// @FfiNative<Int64 Function(Int64, Int64)>('Sum')
+/// external int sum(int a, int b);
+/// ```
+class FfiNative<T> {
+  final String nativeName;
+  final bool isLeaf;
+  const FfiNative(this.nativeName, {this.isLeaf: false});
+}
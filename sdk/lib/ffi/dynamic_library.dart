@@ -45,6 +45,15 @@ class DynamicLibrary {
 /// Methods which cannot be invoked dynamically.
 extension DynamicLibraryExtension on DynamicLibrary {
   /// Helper that combines lookup and cast to a Dart function.
+  ///
+  /// See [NativeFunctionPointer.asFunction] for [isLeaf].
+  ///
+  /// With [isLazy] the symbol is only looked up when the returned function is
+  /// first called, which then throws the [ArgumentError] if the lookup fails.
+  /// This keeps large bindings from resolving all their symbols at startup.
+  /// [isLazy] must be a constant.
   external F lookupFunction<T extends Function, F extends Function>(
-      String symbolName);
+      String symbolName,
+      {bool isLeaf: false,
+      bool isLazy: false});
 }
@@ -84,7 +84,18 @@ extension NativeFunctionPointer<NF extends Function>
     on Pointer<NativeFunction<NF>> {
   /// Convert to Dart function, automatically marshalling the arguments
   /// and return value.
-  external DF asFunction<@DartRepresentationOf("NF") DF extends Function>();
+  ///
+  /// [isLeaf] must be a constant. If true, the call does not transition out
+  /// of generated code: it is cheaper, but the native function must not call
+  /// back into Dart, use the Dart API or block, because the isolate cannot
+  /// reach a safepoint, e.g. for garbage collection, until it returns. Leaf
+  /// calls cannot take or return [Handle]s.
+  ///
+  /// A leaf call can take a [TypedData] created by `dart:typed_data` where
+  /// the native function takes a [Pointer]. The native function gets a
+  /// pointer to the contents, which is only valid during the call.
+  external DF asFunction<@DartRepresentationOf("NF") DF extends Function>(
+      {bool isLeaf: false});
 }
 
 //
@@ -557,6 +568,65 @@ extension NativePort on SendPort {
   external int get nativePort;
 }
 
+/// A native function pointer which can be called from any thread, and calls a
+/// Dart function asynchronously on the isolate which created it.
+///
+/// Unlike [Pointer.fromFunction], calling [pointer] doesn't enter the isolate.
+/// The arguments are copied into a queue and the call returns immediately.
+/// The isolate then calls the Dart function with them from its event loop, in
+/// the order the calls were made, while the [AsyncCallback] is not closed.
+///
+/// Only signatures returning [Void] and taking integer, [Pointer], [Float] and
+/// [Double] arguments are supported, and all arguments must be passed in
+/// registers by the native calling convention: 6 integer and 8 floating point
+/// arguments on x64, 8 of each on arm64, and 4 integer ones on Windows x64.
+/// When the queue of a callback is full, calls block until the isolate has
+/// handled some pending calls.
+abstract class AsyncCallback<T extends Function> {
+  /// Creates a native function pointer which calls [callback].
+  ///
+  /// [callback] is called with the Dart representation of the arguments of
+  /// the [T] signature.
+  external factory AsyncCallback(@DartRepresentationOf("T") Function callback);
+
+  /// The native function pointer.
+  ///
+  /// Native code must not call [pointer] after [close].
+  Pointer<NativeFunction<T>> get pointer;
+
+  /// Stops handling calls and releases the native function pointer.
+  ///
+  /// Calls which have not been handled yet are dropped. Callbacks which are
+  /// not closed are released when the isolate shuts down.
+  void close();
+}
+
+/// Native memory for temporary values, which is released all at once.
+///
+/// Allocations take the next bytes of a segment obtained from the system
+/// allocator, so they are much cheaper than individual `malloc` calls, and
+/// can't be freed individually. Use an arena for the arguments of native
+/// calls, e.g. strings and arrays of structs, and release it after the calls.
+abstract class Arena {
+  /// Creates an empty arena.
+  external factory Arena();
+
+  /// Runs [computation] with a new arena, which is released when it returns
+  /// or throws.
+  external static R using<R>(R Function(Arena arena) computation);
+
+  /// Allocates [byteCount] bytes, which are not initialized.
+  ///
+  /// The address is a multiple of [alignment], which must be a power of two
+  /// no larger than 16.
+  Pointer<T> allocate<T extends NativeType>(int byteCount, {int alignment: 8});
+
+  /// Releases all memory allocated in this arena.
+  ///
+  /// The arena can be used for new allocations afterwards.
+  void releaseAll();
+}
+
 /// Opaque, not exposing it's members.
 class Dart_CObject extends Struct {}
 
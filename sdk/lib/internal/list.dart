@@ -324,6 +324,23 @@ abstract class NonGrowableListError {
  */
 external List<T> makeListFixedLength<T>(List<T> growableList);
 
+/**
+ * Makes room for at least [capacity] elements in [growableList], so adding
+ * elements up to that length doesn't grow its storage again.
+ *
+ * For internal use only.
+ * Does nothing for lists which are not core growable lists.
+ */
+external void reserveListCapacity(List growableList, int capacity);
+
+/**
+ * Releases the storage of [growableList] beyond its current length.
+ *
+ * For internal use only.
+ * Does nothing for lists which are not core growable lists.
+ */
+external void shrinkListToFit(List growableList);
+
 /**
  * Converts a fixed-length list to an unmodifiable list.
  *
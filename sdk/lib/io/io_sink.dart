@@ -290,24 +290,15 @@ class _IOSinkImpl extends _StreamSinkImpl<List<int>> implements IOSink {
   }
 
   void writeAll(Iterable objects, [String separator = ""]) {
-    Iterator iterator = objects.iterator;
-    if (!iterator.moveNext()) return;
-    if (separator.isEmpty) {
-      do {
-        write(iterator.current);
-      } while (iterator.moveNext());
-    } else {
-      write(iterator.current);
-      while (iterator.moveNext()) {
-        write(separator);
-        write(iterator.current);
-      }
-    }
+    // Join the strings first so that they are added, and written to the
+    // target, as a single chunk.
+    write((new StringBuffer()..writeAll(objects, separator)).toString());
   }
 
   void writeln([Object? object = ""]) {
-    write(object);
-    write("\n");
+    // A single chunk, so that e.g. a line written to stdout is a single
+    // write rather than one for the text and one for the newline.
+    write("$object\n");
   }
 
   void writeCharCode(int charCode) {
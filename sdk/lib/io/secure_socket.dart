@@ -558,6 +558,7 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
           SecurityContext._protocolsToLengthEncoding(supportedProtocols);
       secureFilter.connect(
           address.host,
+          isServer ? 0 : _socket.remotePort,
           context,
           isServer,
           requestClientCertificate || requireClientCertificate,
@@ -1229,6 +1230,7 @@ abstract class _SecureFilter {
 
   void connect(
       String hostName,
+      int port,
       SecurityContext context,
       bool isServer,
       bool requestClientCertificate,
@@ -25,14 +25,23 @@ class Void {}
 
 // WasmModule is a compiled module that can be instantiated.
 abstract class WasmModule {
-  // Compile a module.
+  // Compile a module. With --wasm_module_cache=<dir> the VM reuses the
+  // compiled code of modules with the same bytes across runs.
   external factory WasmModule(Uint8List data);
 
+  // Load a module from the result of [serialize], skipping the compilation.
+  // The data can be embedded in an application, but is only valid for the same
+  // version of the runtime on the same kind of CPU.
+  external factory WasmModule.deserialize(Uint8List serialized);
+
   // Instantiate the module with the given imports.
   WasmInstance instantiate(WasmImports imports);
 
   // Describes the imports and exports that the module expects, for debugging.
   String describe();
+
+  // Returns the compiled code of the module, see [WasmModule.deserialize].
+  Uint8List serialize();
 }
 
 // WasmImports holds all the imports for a WasmInstance.
@@ -66,6 +75,11 @@ abstract class WasmMemory {
   // Returns the length of the memory in bytes.
   int get lengthInBytes;
 
+  // Returns a view of the memory, without copying it. The view must not be
+  // used after calling [grow], which can move the memory. Get the view again
+  // instead.
+  Uint8List get view;
+
   // Returns the byte at the given index.
   int operator [](int index);
 
@@ -0,0 +1,77 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests copies between fixed-length, growable and constant lists which are
+// long enough to be done in bulk.
+
+import "package:expect/expect.dart";
+
+List<Object> numbers(int length, [int offset = 0]) =>
+    new List<Object>.generate(length, (i) => "${i + offset}");
+
+void expectRange(List list, int start, int end, int offset) {
+  for (var i = start; i < end; i++) {
+    Expect.equals("${i + offset}", list[i], "$i");
+  }
+}
+
+void testSetRange(List<Object> target) {
+  final sources = <List<Object>>[
+    numbers(300, 1000),
+    numbers(300, 1000).toList(growable: true),
+    new List<Object>.unmodifiable(numbers(300, 1000)),
+  ];
+  for (final source in sources) {
+    target.setRange(0, target.length, numbers(target.length));
+    target.setRange(50, 250, source, 20);
+    expectRange(target, 0, 50, 0);
+    expectRange(target, 50, 250, 1000 - 30);
+    expectRange(target, 250, target.length, 0);
+  }
+  Expect.throws(() => target.setRange(0, 200, numbers(300), 150));
+
+  // Overlapping copies within the same list, forwards and backwards.
+  target.setRange(0, target.length, numbers(target.length));
+  target.setRange(10, 210, target, 0);
+  expectRange(target, 10, 210, -10);
+  target.setRange(0, target.length, numbers(target.length));
+  target.setRange(0, 200, target, 10);
+  expectRange(target, 0, 200, 10);
+}
+
+void testGrowable() {
+  final list = <Object>[];
+  for (var i = 0; i < 1000; i++) {
+    list.add("$i");
+  }
+  expectRange(list, 0, 1000, 0);
+
+  list.insert(0, "x");
+  Expect.equals("x", list[0]);
+  expectRange(list, 1, 1001, -1);
+  Expect.equals("x", list.removeAt(0));
+  expectRange(list, 0, 1000, 0);
+
+  list.removeRange(100, 200);
+  Expect.equals(900, list.length);
+  expectRange(list, 0, 100, 0);
+  expectRange(list, 100, 900, 100);
+
+  list.insertAll(100, numbers(100, 100));
+  Expect.equals(1000, list.length);
+  expectRange(list, 0, 1000, 0);
+
+  list.length = 70;
+  expectRange(list, 0, 70, 0);
+  list.addAll(numbers(1000, 70));
+  expectRange(list, 0, 1070, 0);
+}
+
+main() {
+  testSetRange(new List<Object>.filled(300, ""));
+  testSetRange(numbers(300).toList(growable: true));
+  // Large enough to be allocated in old space.
+  testSetRange(new List<Object>.filled(100000, ""));
+  testGrowable();
+}
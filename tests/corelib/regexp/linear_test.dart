@@ -0,0 +1,83 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=
+// VMOptions=--linear_regexp
+
+// Tests that patterns matched in linear time by the VM find the same matches
+// and captures as backtracking.
+
+import 'package:expect/expect.dart';
+
+void check(String pattern, String input, List<String?>? expected,
+    {bool caseSensitive: true, bool multiLine: false, int start: 0}) {
+  var re = new RegExp(pattern,
+      caseSensitive: caseSensitive, multiLine: multiLine);
+  var matches = re.allMatches(input, start);
+  if (expected == null) {
+    Expect.isTrue(matches.isEmpty, '$re on "$input"');
+    return;
+  }
+  Expect.isFalse(matches.isEmpty, '$re on "$input"');
+  var match = matches.first;
+  var groups = [for (var i = 0; i <= match.groupCount; i++) match.group(i)];
+  Expect.listEquals(expected, groups, '$re on "$input"');
+}
+
+void main() {
+  // Nested unbounded quantifiers always use the linear engine.
+  var as = 'a' * 64;
+  check(r'^(a+)+$', as + 'b', null);
+  check(r'(a|aa)*c', as, null);
+  check(r'(\w+\s?)*$', 'an input which ends with a comma,', ['', null]);
+  check(r'^(a+)+$', as, [as, as]);
+
+  // Priorities of alternatives and quantifiers.
+  check(r'a|ab', 'ab', ['a']);
+  check(r'ab|a', 'ab', ['ab']);
+  check(r'(a*)(a*)', 'aaa', ['aaa', 'aaa', '']);
+  check(r'(a*?)(a*)', 'aaa', ['aaa', '', 'aaa']);
+  check(r'(a+?)(a*?)b', 'xaab', ['aab', 'a', 'a']);
+  check(r'a{2,3}', 'aaaa', ['aaa']);
+  check(r'a{2,3}?', 'aaaa', ['aa']);
+  check(r'(?:ab){2}', 'abababx', ['abab']);
+
+  // Captures are reset by each iteration, empty iterations are rejected.
+  check(r'(?:(a)|b)+', 'ab', ['ab', null]);
+  check(r'(z)((a+)?(b+)?(c))*', 'zaacbbbcac',
+      ['zaacbbbcac', 'z', 'ac', 'a', null, 'c']);
+  check(r'(a*)*', 'b', ['', null]);
+  check(r'(a*)+', 'b', ['', '']);
+  check(r'(?:a|)*b', 'aab', ['aab']);
+
+  // The leftmost match is found, at or after the start.
+  check(r'[0-9]+', 'ab123cd45', ['123']);
+  check(r'[0-9]+', 'ab123cd45', ['45'], start: 5);
+  check(r'[^a-c]+', 'abcxyzabc', ['xyz']);
+  check(r'x', 'abc', null);
+
+  // Assertions and flags.
+  check(r'^b', 'a\nb', null);
+  check(r'^b', 'a\nb', ['b'], multiLine: true);
+  check(r'a$', 'a\nb', ['a'], multiLine: true);
+  check(r'\bfoo\b', 'xfoo foo', ['foo']);
+  check(r'\Boo', 'oo foo', ['oo']);
+  check(r'FOO[a-c]+', 'xfooBCa', ['fooBCa'], caseSensitive: false);
+  check(r'.+', 'ab\ncd', ['ab']);
+  // Case equivalents forming a single range (U+0100-U+0101).
+  check('(\u0101+)+b', '\u0100b', ['\u0100b', '\u0100'],
+      caseSensitive: false);
+  check('\u0100\u0101', 'x\u0101\u0100', ['\u0101\u0100'],
+      caseSensitive: false);
+
+  // Sticky matches.
+  var re = new RegExp(r'(b+)+c');
+  Expect.isNull(re.matchAsPrefix('abbc'));
+  Expect.equals('bbc', re.matchAsPrefix('abbc', 1)!.group(0));
+  Expect.isNull(re.matchAsPrefix('abbc', 3));
+
+  // Patterns the linear engine doesn't support still work.
+  check(r'(a)\1', 'xaa', ['aa', 'a']);
+  check(r'a(?=b)', 'acab', ['a']);
+}
@@ -0,0 +1,34 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests patterns whose matches all contain a literal, which the VM uses to
+// reject subjects before running the regexp.
+
+import 'package:expect/expect.dart';
+
+void main() {
+  var re = new RegExp(r'[a-z]+foobar\d*');
+  Expect.isFalse(re.hasMatch('no literal here'));
+  Expect.isFalse(re.hasMatch('fooba foobr'));
+  Expect.equals('xfoobar12', re.firstMatch('  xfoobar12 ')!.group(0));
+  Expect.equals('xfoobar', re.firstMatch('\u{1F600}xfoobar')!.group(0));
+  Expect.isNull(re.firstMatch('\u{1F600}xfoobሴar'));
+
+  // The literal must follow the start index.
+  Expect.equals(1, re.allMatches('afoobar bfoobar', 9).length);
+  Expect.equals(0, re.allMatches('afoobar bfoobar', 10).length);
+  Expect.isNull(re.matchAsPrefix('afoobar', 1));
+  Expect.isNotNull(re.matchAsPrefix(' afoobar', 1));
+
+  // Only the longest literal of a sequence is required.
+  re = new RegExp(r'abc.*(defgh|defxy)+');
+  Expect.isTrue(re.hasMatch('abc--defxy'));
+  Expect.isFalse(re.hasMatch('abc--defx'));
+
+  // Optional and case-insensitive parts require nothing.
+  Expect.isTrue(new RegExp(r'(?:foobar)?x').hasMatch('x'));
+  Expect.isTrue(new RegExp(r'foobar|x').hasMatch('x'));
+  Expect.isTrue(new RegExp(r'foobar', caseSensitive: false).hasMatch('FOOBAR'));
+  Expect.isTrue(new RegExp(r'a(?:bcd){1,2}').hasMatch('abcd'));
+}
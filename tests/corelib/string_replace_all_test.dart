@@ -51,6 +51,13 @@ testReplaceAll() {
   Expect.equals(r"[$$$$]", "[..]".replaceAll(".", r"$$"));
   Expect.equals(r"[$]", "[..]".replaceAll("..", r"$"));
   Expect.equals(r"$$", r"\\".replaceAll(r"\", r"$"));
+
+  // Test with regexps, including zero-width matches.
+  Expect.equals("aXcaXdae", "abcabdae".replaceAll(new RegExp("b+"), "X"));
+  Expect.equals("acadae", "abcabbdae".replaceAll(new RegExp("b+"), ""));
+  Expect.equals("-a-b-", "ab".replaceAll(new RegExp(""), "-"));
+  Expect.equals("-\u{1F600}-a-",
+      "\u{1F600}a".replaceAll(new RegExp("", unicode: true), "-"));
 }
 
 testReplaceAllMapped() {
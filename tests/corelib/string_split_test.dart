@@ -58,6 +58,10 @@ void testSplitString() {
 /** RegExp patterns. */
 void testSplitRegExp() {
   testSplitWithRegExp((s) => new RegExp(s));
+
+  // Zero-width matches don't split surrogate pairs in unicode mode.
+  testSplit(["\u{1F600}", "a"], "\u{1F600}a", new RegExp(r"", unicode: true));
+  testSplit(["\ud83d", "\ude00", "a"], "\u{1F600}a", new RegExp(r""));
 }
 
 /** Non-String, non-RegExp patterns. */
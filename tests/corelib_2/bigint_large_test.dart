@@ -0,0 +1,72 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests multiplication and parsing of bigints large enough to be split into
+// halves by the VM.
+// VMOptions=--intrinsify
+// VMOptions=--no-intrinsify --enable-asserts
+
+import "package:expect/expect.dart";
+
+int seed = 1;
+
+// A bigint of [hexDigits] pseudo-random hex digits.
+BigInt random(int hexDigits) {
+  var buffer = new StringBuffer();
+  for (int i = 0; i < hexDigits; i++) {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    buffer.write(((seed >> 16) & 0xf).toRadixString(16));
+  }
+  return BigInt.parse(buffer.toString(), radix: 16);
+}
+
+// Multiplies 16 bits of [y] at a time, so only small products are used.
+BigInt slowMultiply(BigInt x, BigInt y) {
+  var mask = new BigInt.from(0xffff);
+  var result = BigInt.zero;
+  var shift = 0;
+  for (var rest = y.abs(); rest != BigInt.zero; rest >>= 16) {
+    result += (x * (rest & mask)) << shift;
+    shift += 16;
+  }
+  return y.isNegative ? -result : result;
+}
+
+void testMultiply(BigInt x, BigInt y) {
+  var product = x * y;
+  Expect.equals(slowMultiply(x, y), product, "$x * $y");
+  Expect.equals(product, y * x);
+  Expect.equals(-product, -x * y);
+  Expect.equals(product, -x * -y);
+  Expect.equals(x, product ~/ y);
+  Expect.equals(BigInt.zero, product % y);
+}
+
+void testParse(String digits) {
+  var value = BigInt.parse(digits);
+  Expect.equals(digits, value.toString());
+  Expect.equals(-value, BigInt.parse("-" + digits));
+  Expect.equals(value, BigInt.parse("000" + digits));
+}
+
+main() {
+  var x = random(2400);
+  var y = random(1600);
+  testMultiply(x, y);
+  testMultiply(y, x + BigInt.one);
+  testMultiply(x, random(720));
+  testMultiply(x, random(80));
+  testMultiply(x, x);
+  testMultiply(x << 4000, y << 3200);
+
+  for (var length in [1000, 1001, 1009, 4096, 10000]) {
+    var buffer = new StringBuffer("1");
+    for (int i = 1; i < length; i++) {
+      buffer.write((i * 7) % 10);
+    }
+    testParse(buffer.toString());
+  }
+  testParse("9" * 2000);
+  testParse("1" + "0" * 2000);
+}
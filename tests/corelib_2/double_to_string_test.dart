@@ -0,0 +1,41 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import "package:expect/expect.dart";
+
+void check(String expected, double value) {
+  Expect.equals(expected, value.toString());
+  Expect.identical(value, double.parse(expected));
+}
+
+main() {
+  // Integral values.
+  check("0.0", 0.0);
+  check("-0.0", -0.0);
+  check("1.0", 1.0);
+  check("-42.0", -42.0);
+  check("1000000.0", 1e6);
+  check("9007199254740991.0", 9007199254740991.0);
+  check("-9007199254740991.0", -9007199254740991.0);
+  check("9007199254740992.0", 9007199254740992.0);
+  check("18014398509481984.0", 18014398509481984.0);
+  check("100000000000000000000.0", 1e20);
+  check("1e+21", 1e21);
+  check("-1e+21", -1e21);
+
+  // Shortest digits which read back as the same value.
+  check("0.1", 0.1);
+  check("0.30000000000000004", 0.1 + 0.2);
+  check("1.5", 1.5);
+  check("123.456", 123.456);
+  check("0.000001", 1e-6);
+  check("1e-7", 1e-7);
+  check("5e-324", 5e-324);
+  check("1.7976931348623157e+308", 1.7976931348623157e308);
+  check("4503599627370495.5", 4503599627370495.5);
+
+  Expect.equals("NaN", double.nan.toString());
+  Expect.equals("Infinity", double.infinity.toString());
+  Expect.equals("-Infinity", double.negativeInfinity.toString());
+}
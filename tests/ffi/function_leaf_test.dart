@@ -0,0 +1,149 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi leaf calls.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// VMOptions=--use-slow-path
+// VMOptions=--use-slow-path --stacktrace-every=100
+// VMOptions=--write-protect-code --no-dual-map-code
+// SharedObjects=ffi_test_functions
+
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'dylib_utils.dart';
+
+import "package:ffi/ffi.dart";
+import "package:expect/expect.dart";
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testLeafFunctionFromLookup();
+    testLeafFunctionFromPointer();
+    testLeafFunctionDoubles();
+    testLeafFunctionFloats();
+    testLeafFunctionManyArguments();
+    testLeafFunctionPointer();
+    testLeafFunctionTypedData();
+  }
+}
+
+final ffiTestFunctions = dlopenPlatformSpecific("ffi_test_functions");
+
+typedef NativeBinaryOp = Int32 Function(Int32, Int32);
+typedef BinaryOp = int Function(int, int);
+
+BinaryOp sumPlus42Leaf = ffiTestFunctions
+    .lookupFunction<NativeBinaryOp, BinaryOp>("SumPlus42", isLeaf: true);
+
+typedef NativeQuadOpSigned = Int64 Function(Int8, Int16, Int32, Int64);
+typedef QuadOp = int Function(int, int, int, int);
+
+QuadOp intComputationLeaf = ffiTestFunctions
+    .lookupFunction<NativeQuadOpSigned, QuadOp>("IntComputation", isLeaf: true);
+
+void testLeafFunctionFromLookup() {
+  Expect.equals(49, sumPlus42Leaf(3, 4));
+
+  Expect.equals(625, intComputationLeaf(125, 250, 500, 1000));
+  Expect.equals(
+      0x7FFFFFFFFFFFFFFF, intComputationLeaf(0, 0, 0, 0x7FFFFFFFFFFFFFFF));
+  Expect.equals(
+      -0x8000000000000000, intComputationLeaf(0, 0, 0, -0x8000000000000000));
+}
+
+void testLeafFunctionFromPointer() {
+  final Pointer<NativeFunction<NativeBinaryOp>> pointer =
+      ffiTestFunctions.lookup("SumPlus42");
+  final BinaryOp leaf = pointer.asFunction(isLeaf: true);
+  final BinaryOp notLeaf = pointer.asFunction(isLeaf: false);
+  Expect.equals(42, leaf(0, 0));
+  Expect.equals(leaf(10, -3), notLeaf(10, -3));
+}
+
+typedef NativeDoubleUnaryOp = Double Function(Double);
+typedef NativeFloatUnaryOp = Float Function(Float);
+typedef DoubleUnaryOp = double Function(double);
+
+DoubleUnaryOp times1_337DoubleLeaf =
+    ffiTestFunctions.lookupFunction<NativeDoubleUnaryOp, DoubleUnaryOp>(
+        "Times1_337Double",
+        isLeaf: true);
+
+DoubleUnaryOp times1_337FloatLeaf =
+    ffiTestFunctions.lookupFunction<NativeFloatUnaryOp, DoubleUnaryOp>(
+        "Times1_337Float",
+        isLeaf: true);
+
+void testLeafFunctionDoubles() {
+  Expect.approxEquals(2.0 * 1.337, times1_337DoubleLeaf(2.0));
+}
+
+void testLeafFunctionFloats() {
+  Expect.approxEquals(1337.0, times1_337FloatLeaf(1000.0));
+}
+
+typedef NativeDecenaryOp = IntPtr Function(IntPtr, IntPtr, IntPtr, IntPtr,
+    IntPtr, IntPtr, IntPtr, IntPtr, IntPtr, IntPtr);
+typedef DecenaryOp = int Function(
+    int, int, int, int, int, int, int, int, int, int);
+
+// Passes some of the arguments on the stack.
+DecenaryOp sumManyIntsLeaf = ffiTestFunctions
+    .lookupFunction<NativeDecenaryOp, DecenaryOp>("SumManyInts", isLeaf: true);
+
+void testLeafFunctionManyArguments() {
+  Expect.equals(55, sumManyIntsLeaf(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+}
+
+typedef Int64PointerUnOp = Pointer<Int64> Function(Pointer<Int64>);
+
+Int64PointerUnOp assign1337IndexLeaf =
+    ffiTestFunctions.lookupFunction<Int64PointerUnOp, Int64PointerUnOp>(
+        "Assign1337Index1",
+        isLeaf: true);
+
+void testLeafFunctionPointer() {
+  final Pointer<Int64> p = allocate(count: 2);
+  p.value = 42;
+  p[1] = 1000;
+  final Pointer<Int64> result = assign1337IndexLeaf(p);
+  Expect.equals(1337, result.value);
+  Expect.equals(1337, p[1]);
+  Expect.equals(p.elementAt(1).address, result.address);
+  free(p);
+}
+
+typedef Int64ListUnOp = Pointer<Int64> Function(Int64List);
+
+Int64ListUnOp assign1337IndexTypedDataLeaf =
+    ffiTestFunctions.lookupFunction<Int64PointerUnOp, Int64ListUnOp>(
+        "Assign1337Index1",
+        isLeaf: true);
+
+void testLeafFunctionTypedData() {
+  final Int64List list = Int64List.fromList([42, 1000, 1001]);
+  assign1337IndexTypedDataLeaf(list);
+  Expect.listEquals([42, 1337, 1001], list);
+
+  // Views pass a pointer to their first element.
+  final Int64List view = Int64List.sublistView(list, 1);
+  assign1337IndexTypedDataLeaf(view);
+  Expect.listEquals([42, 1337, 1337], list);
+
+  // External typed data.
+  final Pointer<Int64> p = allocate(count: 2);
+  final Int64List external = p.asTypedList(2);
+  external[1] = 0;
+  final Pointer<Int64> result = assign1337IndexTypedDataLeaf(external);
+  Expect.equals(1337, p[1]);
+  Expect.equals(p.elementAt(1).address, result.address);
+  free(p);
+
+  // Typed data without a VM backing store can't be passed.
+  Expect.throwsArgumentError(
+      () => assign1337IndexTypedDataLeaf(UnmodifiableInt64ListView(list)));
+}
@@ -23,6 +23,7 @@ void main() {
     testBareStruct();
     testTypeTest();
     testUtf8();
+    testStructIndex();
   }
 }
 
@@ -118,6 +119,27 @@ void testBareStruct() {
   free(c1.addressOf);
 }
 
+T loadGeneric<T extends Struct>(Pointer<T> pointer, int index) {
+  return pointer[index];
+}
+
+void testStructIndex() {
+  final Pointer<Coordinate> coordinates = allocate<Coordinate>(count: 3);
+  for (int i = 0; i < 3; i++) {
+    coordinates[i]
+      ..x = i.toDouble()
+      ..y = -i.toDouble()
+      ..next = coordinates.elementAt(i);
+  }
+  for (int i = 0; i < 3; i++) {
+    Expect.equals(i.toDouble(), coordinates[i].x);
+    Expect.equals(-i.toDouble(), coordinates.elementAt(i).ref.y);
+    Expect.equals(coordinates.elementAt(i), coordinates[i].addressOf);
+    Expect.equals(coordinates[i].next, loadGeneric(coordinates, i).addressOf);
+  }
+  free(coordinates);
+}
+
 void testTypeTest() {
   Coordinate c = Coordinate.allocate(10, 10, nullptr);
   Expect.isTrue(c is Struct);
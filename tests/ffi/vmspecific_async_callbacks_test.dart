@@ -0,0 +1,75 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi callbacks called from other threads.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// SharedObjects=ffi_test_functions
+
+import 'dart:async';
+import 'dart:ffi';
+
+import 'dylib_utils.dart';
+
+import "package:expect/expect.dart";
+
+final ffiTestFunctions = dlopenPlatformSpecific("ffi_test_functions");
+
+typedef NativeCallback = Void Function(Int32, Int64, Double, Pointer<Uint8>);
+
+typedef CallFromThreadsNative = Void Function(
+    Pointer<NativeFunction<NativeCallback>>, IntPtr, IntPtr);
+typedef CallFromThreads = void Function(
+    Pointer<NativeFunction<NativeCallback>>, int, int);
+
+final callAsyncCallbackFromThreads =
+    ffiTestFunctions.lookupFunction<CallFromThreadsNative, CallFromThreads>(
+        "CallAsyncCallbackFromThreads");
+
+const int numThreads = 4;
+// More than fit in the queue of a callback, so some threads have to wait.
+const int callsPerThread = 1000;
+
+Future<void> testCallsFromThreads() async {
+  final done = Completer<void>();
+  final nextCall = List<int>.filled(numThreads, 0);
+  int numCalls = 0;
+  final callback = AsyncCallback<NativeCallback>(
+      (int thread, int call, double half, Pointer<Uint8> pointer) {
+    // The calls of each thread arrive in order.
+    Expect.equals(nextCall[thread]++, call);
+    Expect.equals(0.5 * call, half);
+    Expect.equals(call, pointer.address);
+    if (++numCalls == numThreads * callsPerThread) {
+      done.complete();
+    }
+  });
+  callAsyncCallbackFromThreads(callback.pointer, numThreads, callsPerThread);
+  await done.future;
+  callback.close();
+}
+
+void testUnsupportedSignatures() {
+  Expect.throwsArgumentError(
+      () => AsyncCallback<Int32 Function(Int32)>((int a) => a));
+  Expect.throwsArgumentError(() => AsyncCallback<
+          Void Function(Int64, Int64, Int64, Int64, Int64, Int64, Int64, Int64,
+              Int64)>(
+      (int a, int b, int c, int d, int e, int f, int g, int h, int i) {}));
+}
+
+void testCloseTwice() {
+  final callback = AsyncCallback<Void Function()>(() {});
+  callback.close();
+  callback.close();
+}
+
+void main() async {
+  for (int i = 0; i < 3; ++i) {
+    await testCallsFromThreads();
+  }
+  testUnsupportedSignatures();
+  testCloseTwice();
+}
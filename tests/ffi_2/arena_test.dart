@@ -0,0 +1,96 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi arenas.
+
+import 'dart:ffi';
+
+import "package:expect/expect.dart";
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testAllocate();
+    testAlignment();
+    testLargeAllocation();
+    testManySegments();
+    testUsing();
+    testInvalidArguments();
+  }
+}
+
+void testAllocate() {
+  final arena = Arena();
+  final Pointer<Int64> a = arena.allocate(8);
+  final Pointer<Int64> b = arena.allocate(8);
+  a.value = 1;
+  b.value = 2;
+  Expect.equals(1, a.value);
+  Expect.equals(2, b.value);
+  Expect.notEquals(a.address, b.address);
+  arena.releaseAll();
+
+  // Released arenas can be reused.
+  final Pointer<Int32> c = arena.allocate(4);
+  c.value = 3;
+  Expect.equals(3, c.value);
+  arena.releaseAll();
+}
+
+void testAlignment() {
+  final arena = Arena();
+  arena.allocate<Uint8>(1, alignment: 1);
+  for (final alignment in [1, 2, 4, 8, 16]) {
+    final Pointer<Uint8> p = arena.allocate(3, alignment: alignment);
+    Expect.equals(0, p.address % alignment);
+  }
+  arena.releaseAll();
+}
+
+void testLargeAllocation() {
+  final arena = Arena();
+  final Pointer<Uint8> small = arena.allocate(16);
+  final Pointer<Uint8> large = arena.allocate(1024 * 1024);
+  large.elementAt(1024 * 1024 - 1).value = 42;
+  Expect.equals(42, large.elementAt(1024 * 1024 - 1).value);
+  // Doesn't take the place of the current segment.
+  final Pointer<Uint8> next = arena.allocate(16);
+  Expect.equals(small.address + 16, next.address);
+  arena.releaseAll();
+}
+
+void testManySegments() {
+  final arena = Arena();
+  final pointers = <Pointer<Int64>>[];
+  for (int i = 0; i < 20000; i++) {
+    final Pointer<Int64> p = arena.allocate(8);
+    p.value = i;
+    pointers.add(p);
+  }
+  for (int i = 0; i < pointers.length; i++) {
+    Expect.equals(i, pointers[i].value);
+  }
+  arena.releaseAll();
+}
+
+void testUsing() {
+  final result = Arena.using((arena) {
+    final Pointer<Double> p = arena.allocate(8);
+    p.value = 1.5;
+    return p.value;
+  });
+  Expect.equals(1.5, result);
+
+  Expect.throws(() => Arena.using((arena) {
+        arena.allocate(8);
+        throw "error";
+      }));
+}
+
+void testInvalidArguments() {
+  final arena = Arena();
+  Expect.throwsArgumentError(() => arena.allocate(-1));
+  Expect.throwsArgumentError(() => arena.allocate(8, alignment: 3));
+  Expect.throwsArgumentError(() => arena.allocate(8, alignment: 32));
+  arena.releaseAll();
+}
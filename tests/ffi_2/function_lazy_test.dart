@@ -0,0 +1,71 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Dart test program for testing dart:ffi lazily bound functions.
+//
+// VMOptions=
+// VMOptions=--deterministic --optimization-counter-threshold=10
+// VMOptions=--use-slow-path
+// SharedObjects=ffi_test_functions
+
+import 'dart:ffi';
+
+import 'dylib_utils.dart';
+
+import "package:expect/expect.dart";
+
+void main() {
+  for (int i = 0; i < 100; ++i) {
+    testLazyFunction();
+    testLazyLeafFunction();
+    testLazyFunctionMissingSymbol();
+    testLookupIsStable();
+  }
+}
+
+final ffiTestFunctions = dlopenPlatformSpecific("ffi_test_functions");
+
+typedef NativeBinaryOp = Int32 Function(Int32, Int32);
+typedef BinaryOp = int Function(int, int);
+
+typedef NativeQuadOpSigned = Int64 Function(Int8, Int16, Int32, Int64);
+typedef QuadOp = int Function(int, int, int, int);
+
+BinaryOp sumPlus42Lazy = ffiTestFunctions
+    .lookupFunction<NativeBinaryOp, BinaryOp>("SumPlus42", isLazy: true);
+
+QuadOp intComputationLazyLeaf =
+    ffiTestFunctions.lookupFunction<NativeQuadOpSigned, QuadOp>(
+        "IntComputation",
+        isLeaf: true,
+        isLazy: true);
+
+void testLazyFunction() {
+  Expect.equals(49, sumPlus42Lazy(3, 4));
+  Expect.equals(42, sumPlus42Lazy(0, 0));
+}
+
+void testLazyLeafFunction() {
+  Expect.equals(625, intComputationLazyLeaf(125, 250, 500, 1000));
+  Expect.equals(
+      0x7FFFFFFFFFFFFFFF, intComputationLazyLeaf(0, 0, 0, 0x7FFFFFFFFFFFFFFF));
+}
+
+void testLazyFunctionMissingSymbol() {
+  // The lookup only fails when the function is called, and again on every
+  // call because a failed lookup isn't cached.
+  final BinaryOp missing = ffiTestFunctions
+      .lookupFunction<NativeBinaryOp, BinaryOp>("NoSuchSymbol", isLazy: true);
+  Expect.throwsArgumentError(() => missing(1, 2));
+  Expect.throwsArgumentError(() => missing(1, 2));
+}
+
+void testLookupIsStable() {
+  // Repeated lookups are answered from the symbol cache.
+  final Pointer<NativeFunction<NativeBinaryOp>> first =
+      ffiTestFunctions.lookup("SumPlus42");
+  final Pointer<NativeFunction<NativeBinaryOp>> second =
+      ffiTestFunctions.lookup("SumPlus42");
+  Expect.equals(first.address, second.address);
+}
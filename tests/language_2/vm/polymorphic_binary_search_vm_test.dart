@@ -0,0 +1,42 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// Test that a polymorphic call dispatched by a binary search over the class
+// ids of its targets deoptimizes for a class which is not among them.
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation --polymorphic-binary-search-threshold=2
+
+import 'package:expect/expect.dart';
+
+class A {
+  f() => 'A';
+}
+
+class B {
+  f() => 'B';
+}
+
+// Not seen before optimization, its class id is between those of B and C.
+class Unseen {
+  f() => 'Unseen';
+}
+
+class C {
+  f() => 'C';
+}
+
+class D {
+  f() => 'D';
+}
+
+call(x) => x.f();
+
+main() {
+  var receivers = [new A(), new B(), new C(), new D()];
+  for (var i = 0; i < 20; i++) {
+    for (var receiver in receivers) {
+      Expect.equals(receiver.f(), call(receiver));
+    }
+  }
+  Expect.equals('Unseen', call(new Unseen()));
+  Expect.equals('D', call(new D()));
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests inputs which implementations may decode or encode without the general
+// Dart parser and stringifier, and those at the edge of such fast paths.
+
+import "dart:convert";
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+Object? decodeUtf8(String source) =>
+    utf8.decoder.fuse(json.decoder).convert(utf8.encode(source));
+
+Object? decodeBoth(String source) {
+  final fromString = json.decode(source);
+  final fromBytes = decodeUtf8(source);
+  Expect.deepEquals(fromString, fromBytes);
+  return fromString;
+}
+
+void testMaps() {
+  final map = decodeBoth('{"a": 1, "b": [true, false, null], "c": {}}')
+      as Map<String, dynamic>;
+  Expect.equals(3, map.length);
+  Expect.listEquals(["a", "b", "c"], map.keys.toList());
+  Expect.equals(1, map["a"]);
+  Expect.isTrue(map.containsKey("c"));
+  Expect.isFalse(map.containsKey("d"));
+  // The maps are ordinary mutable maps.
+  map["d"] = 4;
+  map.remove("a");
+  Expect.listEquals(["b", "c", "d"], map.keys.toList());
+
+  // The last duplicate key wins.
+  final duplicates = decodeBoth('{"x": 1, "y": 2, "x": 3}') as Map;
+  Expect.equals(2, duplicates.length);
+  Expect.equals(3, duplicates["x"]);
+
+  // Maps larger than the initial capacity.
+  final entries = [for (var i = 0; i < 100; i++) '"k$i": $i'].join(",");
+  final large = decodeBoth("{$entries}") as Map;
+  Expect.equals(100, large.length);
+  for (var i = 0; i < 100; i++) {
+    Expect.equals(i, large["k$i"]);
+  }
+}
+
+void testValues() {
+  Expect.equals(0, decodeBoth("-0"));
+  Expect.isTrue((decodeBoth("-0.0") as double).isNegative);
+  Expect.equals(12345678901234, decodeBoth("12345678901234"));
+  Expect.equals(1234.5678e-3, decodeBoth("1234.5678e-3"));
+  Expect.equals(1.5e300, decodeBoth("1.5e300"));
+  Expect.equals(double.infinity, decodeBoth("1e999"));
+  Expect.equals("é€\u{1F600}", decodeBoth('"é€\u{1F600}"'));
+  Expect.equals("a\n\"\\/\ud800b", decodeBoth(r'"a\n\"\\\/\ud800b"'));
+  Expect.equals(null, decodeBoth(" null "));
+
+  final nested = "[" * 2000 + "]" * 2000;
+  var list = decodeBoth(nested);
+  for (var i = 0; i < 1999; i++) {
+    list = (list as List)[0];
+  }
+  Expect.listEquals([], list as List);
+}
+
+void testChunkedNumbers() {
+  // Chunked decoding of bytes parses the numbers of each chunk in place.
+  Object? decodeChunked(List<int> bytes) {
+    Object? result;
+    final sink = utf8.decoder.fuse(json.decoder).startChunkedConversion(
+        ChunkedConversionSink.withCallback((values) => result = values.single));
+    sink.add(bytes);
+    sink.close();
+    return result;
+  }
+
+  const source = '[0.1,-2.5e-3,1e22,1e23,123456789012345678.5,-0.0,'
+      '9007199254740993.0,4.9e-324,1.7976931348623157e308,17]';
+  final expected = json.decode(source);
+  Expect.listEquals(expected as List,
+      decodeChunked(Uint8List.fromList(utf8.encode(source))) as List);
+  Expect.listEquals(
+      expected, decodeChunked(utf8.encode(source).toList()) as List);
+  Expect.equals(1e23, expected[3]);
+  Expect.equals(9007199254740992.0, expected[6]);
+  Expect.isTrue((expected[5] as double).isNegative);
+}
+
+void testInvalid() {
+  for (final source in ['{"a" 1}', '[1,]', '01', '"\x01"', '[1] x', '']) {
+    Expect.throwsFormatException(() => json.decode(source), source);
+    Expect.throwsFormatException(() => decodeUtf8(source), source);
+  }
+  Expect.throwsFormatException(
+      () => utf8.decoder.fuse(json.decoder).convert([0x22, 0xC3, 0x22]));
+}
+
+class WithToJson {
+  toJson() => {"to": "json"};
+}
+
+void testEncode() {
+  String encode(Object? value) {
+    final bytes = JsonUtf8Encoder().convert(value);
+    Expect.type<Uint8List>(bytes);
+    final text = utf8.decode(bytes);
+    Expect.equals(json.encode(value), text);
+    return text;
+  }
+
+  Expect.equals('{"a":[1,2.5,true,null],"b":{}}',
+      encode({"a": [1, 2.5, true, null], "b": <String, int>{}}));
+  Expect.equals(r'"\"\\\n\u0001\ud800' '\u{1F600}"',
+      encode("\"\\\n\x01\ud800\u{1F600}"));
+  Expect.equals('[1e+21,-0.0]', encode([1e21, -0.0]));
+  Expect.equals('[1.0,-2.5,0.1,1e-7]',
+      encode(Float64List.fromList([1.0, -2.5, 0.1, 1e-7])));
+  Expect.equals('[0.5,0.10000000149011612]',
+      encode(Float32List.fromList([0.5, 0.1])));
+  Expect.equals('{"a":[]}', encode({"a": Float64List(0)}));
+  Expect.throws<JsonUnsupportedObjectError>(
+      () => encode(Float64List.fromList([1.0, double.infinity])));
+  Expect.equals('{"to":"json"}', encode(WithToJson()));
+  Expect.equals('[{"to":"json"}]', encode([WithToJson()]));
+  Expect.throws<JsonUnsupportedObjectError>(() => encode(double.nan));
+  Expect.throws<JsonUnsupportedObjectError>(() => encode({1: 2}));
+  final cyclic = [];
+  cyclic.add(cyclic);
+  Expect.throws<JsonCyclicError>(() => encode(cyclic));
+}
+
+main() {
+  testMaps();
+  testValues();
+  testChunkedNumbers();
+  testInvalid();
+  testEncode();
+}
@@ -18,6 +18,7 @@ void main() {
   }
 
   testEncodeSlice();
+  testUnpairedSurrogates();
 }
 
 void testEncodeSlice() {
@@ -53,3 +54,19 @@ void testEncodeSlice() {
   Expect.listEquals([0xc2, 0x82, 0xe1, 0x81, 0x81, 0xef, 0xbf, 0xbd],
       encoder.convert(unicode, 1, 4));
 }
+
+void testUnpairedSurrogates() {
+  var encoder = utf8.encoder;
+  Expect.listEquals([0xef, 0xbf, 0xbd], encoder.convert("\uD800"));
+  Expect.listEquals([0xef, 0xbf, 0xbd], encoder.convert("\uDC00"));
+  Expect.listEquals([0x41, 0xef, 0xbf, 0xbd, 0x42, 0xef, 0xbf, 0xbd],
+      encoder.convert("A\uDC00B\uD800"));
+  Expect.listEquals([0xef, 0xbf, 0xbd, 0xf0, 0x90, 0x84, 0x81],
+      encoder.convert("\uDC00\u{10101}"));
+  // Long enough for the word at a time paths.
+  var ascii = "0123456789abcdef" * 4;
+  Expect.listEquals([...ascii.codeUnits, 0xc3, 0xbf, ...ascii.codeUnits],
+      encoder.convert("$ascii\u00ff$ascii"));
+  Expect.listEquals([...ascii.codeUnits, 0xef, 0xbf, 0xbd, ...ascii.codeUnits],
+      encoder.convert("$ascii\uD800$ascii"));
+}
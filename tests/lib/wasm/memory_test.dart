@@ -21,6 +21,12 @@ void main() {
   Expect.equals(1100 * WasmMemory.kPageSizeInBytes, mem.lengthInBytes);
   Expect.equals(45, mem[123]);
 
+  var view = mem.view;
+  Expect.equals(mem.lengthInBytes, view.lengthInBytes);
+  Expect.equals(45, view[123]);
+  view[124] = 67;
+  Expect.equals(67, mem[124]);
+
   Expect.throwsArgumentError(() => WasmMemory(1000000000));
   Expect.throwsArgumentError(() => mem.grow(1000000000));
 }
@@ -0,0 +1,63 @@
+// Copyright (c) 2020, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Tests fillRange, indexOf and lastIndexOf of typed lists and views on ranges
+// long enough to be handled in bulk.
+
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+void testFill(List<num> list, num value, num expected) {
+  list.fillRange(3, 40, value);
+  for (var i = 0; i < list.length; i++) {
+    Expect.equals((i >= 3 && i < 40) ? expected : 0, list[i], "$i");
+  }
+}
+
+void testIndexOf(List<int> list, int element, List<int> outOfRange) {
+  list.fillRange(0, list.length, 0);
+  Expect.equals(-1, list.indexOf(element));
+  Expect.equals(-1, list.lastIndexOf(element));
+  list[5] = element;
+  list[30] = element;
+  Expect.equals(5, list.indexOf(element));
+  Expect.equals(30, list.indexOf(element, 6));
+  Expect.equals(-1, list.indexOf(element, 31));
+  Expect.equals(5, list.indexOf(element, -3));
+  Expect.equals(30, list.lastIndexOf(element));
+  Expect.equals(5, list.lastIndexOf(element, 29));
+  Expect.equals(-1, list.lastIndexOf(element, 4));
+  for (final value in outOfRange) {
+    Expect.equals(-1, list.indexOf(value));
+    Expect.equals(-1, list.lastIndexOf(value));
+  }
+}
+
+main() {
+  testFill(Int8List(50), 300, 44);
+  testFill(Uint8List(50), -1, 255);
+  testFill(Uint8ClampedList(50), 300, 255);
+  testFill(Int16List(50), 70000, 4464);
+  testFill(Uint16List(50), -2, 65534);
+  testFill(Int32List(50), -123456789, -123456789);
+  testFill(Uint32List(50), -1, 0xFFFFFFFF);
+  testFill(Int64List(50), 0x123456789ABCDEF, 0x123456789ABCDEF);
+  testFill(Float32List(50), 0.1, 0.10000000149011612);
+  testFill(Float64List(50), -2.5, -2.5);
+  testFill(Uint16List.view(Uint8List(120).buffer, 10, 50), 7, 7);
+  testFill(Float64List.view(Uint8List(416).buffer, 8, 50), 1.5, 1.5);
+
+  testIndexOf(Int8List(40), -1, [255, 128, -129]);
+  testIndexOf(Uint8List(40), 255, [-1, 256]);
+  testIndexOf(Uint8ClampedList(40), 200, [-56, 456]);
+  testIndexOf(Int16List(40), -30000, [35536, 1 << 16]);
+  testIndexOf(Uint16List(40), 65535, [-1, 1 << 17]);
+  testIndexOf(Int32List(40), -1, [0xFFFFFFFF]);
+  testIndexOf(Uint32List(40), 0xFFFFFFFF, [-1, 1 << 32]);
+  testIndexOf(Int64List(40), -0x123456789ABCDEF, []);
+  testIndexOf(Uint64List(40), -1, []);
+  testIndexOf(Int32List.view(Uint8List(200).buffer, 12, 40), 42, [1 << 40]);
+  testIndexOf(Int16List.sublistView(Int16List(60), 13, 53), 9, [1 << 16]);
+}
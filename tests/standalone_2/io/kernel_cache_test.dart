@@ -0,0 +1,79 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests the --kernel-cache option: a second run with the same flags reuses
+// the cached kernel, while changing a source or a -D define compiles the
+// script again.
+
+import "dart:io";
+
+import "package:expect/expect.dart";
+
+Directory tempDir;
+Directory cacheDir;
+File script;
+
+List<File> cachedKernels() => cacheDir
+    .listSync()
+    .whereType<File>()
+    .where((file) => file.path.endsWith(".dill"))
+    .toList();
+
+String run(List<String> defines) {
+  var result = Process.runSync(Platform.executable, [
+    "--disable-dart-dev",
+    "--kernel-cache=${cacheDir.path}",
+    ...defines,
+    script.path,
+  ]);
+  Expect.equals(0, result.exitCode, "${result.stdout}\n${result.stderr}");
+  return (result.stdout as String).trim();
+}
+
+void testHit() {
+  Expect.equals("hello 1", run(["-Dgreeting=hello"]));
+  var kernels = cachedKernels();
+  Expect.equals(1, kernels.length);
+  var modified = kernels.single.lastModifiedSync();
+
+  // A hit does not write the entry again.
+  Expect.equals("hello 1", run(["-Dgreeting=hello"]));
+  kernels = cachedKernels();
+  Expect.equals(1, kernels.length);
+  Expect.equals(modified, kernels.single.lastModifiedSync());
+}
+
+void testMissOnChangedSource() {
+  // Same key, the changed source invalidates the entry.
+  script.writeAsStringSync(
+      "main() => print(const String.fromEnvironment('greeting') + ' 2');\n");
+  Expect.equals("hello 2", run(["-Dgreeting=hello"]));
+  Expect.equals(1, cachedKernels().length);
+}
+
+void testMissOnChangedDefines() {
+  Expect.equals("bye 2", run(["-Dgreeting=bye"]));
+  Expect.equals(2, cachedKernels().length);
+
+  // The order of the defines does not matter.
+  Expect.equals("bye 2", run(["-Dother=1", "-Dgreeting=bye"]));
+  Expect.equals(3, cachedKernels().length);
+  Expect.equals("bye 2", run(["-Dgreeting=bye", "-Dother=1"]));
+  Expect.equals(3, cachedKernels().length);
+}
+
+void main() {
+  tempDir = Directory.systemTemp.createTempSync("kernel_cache_test");
+  try {
+    cacheDir = Directory("${tempDir.path}/cache")..createSync();
+    script = File("${tempDir.path}/script.dart")
+      ..writeAsStringSync("main() => "
+          "print(const String.fromEnvironment('greeting') + ' 1');\n");
+    testHit();
+    testMissOnChangedSource();
+    testMissOnChangedDefines();
+  } finally {
+    tempDir.deleteSync(recursive: true);
+  }
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2021, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Tests the client-side TLS session cache: a second connection to the same
+// host and port resumes the session of the first, while a session whose
+// certificate was only accepted by onBadCertificate is never cached, so the
+// next connection verifies the certificate and asks its own callback again.
+//
+// OtherResources=certificates/server_chain.pem
+// OtherResources=certificates/server_key.pem
+// OtherResources=certificates/trusted_certs.pem
+
+import "dart:async";
+import "dart:io";
+import "dart:mirrors";
+
+import "package:expect/expect.dart";
+import "package:async_helper/async_helper.dart";
+
+InternetAddress HOST;
+
+String localFile(path) => Platform.script.resolve(path).toFilePath();
+
+SecurityContext serverContext = new SecurityContext()
+  ..useCertificateChain(localFile('certificates/server_chain.pem'))
+  ..usePrivateKey(localFile('certificates/server_key.pem'),
+      password: 'dartdart');
+
+int handshakeCount(String name) {
+  LibraryMirror io = currentMirrorSystem().findLibrary(#dart.io);
+  return io.invoke(MirrorSystem.getSymbol(name, io), []).reflectee as int;
+}
+
+int get resumedHandshakes => handshakeCount('_resumedHandshakes');
+int get fullHandshakes => handshakeCount('_fullHandshakes');
+
+Future<SecureServerSocket> startServer() async {
+  var server = await SecureServerSocket.bind(HOST, 0, serverContext);
+  server.listen((SecureSocket client) {
+    client.write("Hello");
+    client.close();
+    client.drain();
+  });
+  return server;
+}
+
+Future<void> connect(SecureServerSocket server, SecurityContext context,
+    {bool onBadCertificate(X509Certificate certificate)}) async {
+  var socket = await SecureSocket.connect(HOST, server.port,
+      context: context, onBadCertificate: onBadCertificate);
+  // Reading until the server closes also processes any session ticket the
+  // server sends after the handshake.
+  var message = await socket.fold<List<int>>(
+      <int>[], (message, data) => message..addAll(data));
+  Expect.listEquals("Hello".codeUnits, message);
+  await socket.close();
+}
+
+Future<void> testResume() async {
+  var server = await startServer();
+  var context = new SecurityContext()
+    ..setTrustedCertificates(localFile('certificates/trusted_certs.pem'));
+  int resumed = resumedHandshakes;
+  int full = fullHandshakes;
+  await connect(server, context);
+  Expect.equals(resumed, resumedHandshakes);
+  Expect.equals(full + 1, fullHandshakes);
+  await connect(server, context);
+  Expect.equals(resumed + 1, resumedHandshakes);
+  Expect.equals(full + 1, fullHandshakes);
+  await server.close();
+}
+
+Future<void> testBadCertificateNotCached() async {
+  var server = await startServer();
+  // No trusted roots, so the server certificate fails verification and is
+  // only accepted by the callback.
+  var context = new SecurityContext();
+  int callbacks = 0;
+  bool accept(X509Certificate certificate) {
+    callbacks++;
+    return true;
+  }
+
+  int resumed = resumedHandshakes;
+  int full = fullHandshakes;
+  await connect(server, context, onBadCertificate: accept);
+  Expect.equals(1, callbacks);
+  await connect(server, context, onBadCertificate: accept);
+  Expect.equals(2, callbacks);
+  Expect.equals(resumed, resumedHandshakes);
+  Expect.equals(full + 2, fullHandshakes);
+
+  // A connection without a callback must fail rather than resume a session
+  // that an earlier callback accepted.
+  try {
+    await connect(server, context);
+    Expect.fail("Connection with an untrusted certificate succeeded");
+  } on HandshakeException {
+    // Expected.
+  }
+  Expect.equals(resumed, resumedHandshakes);
+  await server.close();
+}
+
+void main() async {
+  asyncStart();
+  HOST = (await InternetAddress.lookup("localhost")).first;
+  await testResume();
+  await testBadCertificateNotCached();
+  asyncEnd();
+}